@@ -0,0 +1,48 @@
+#include "CellIDRemap.h"
+
+using dd4hep::DDSegmentation::CellID;
+
+namespace {
+CellID lowMask(unsigned aWidth) { return aWidth >= 64 ? ~CellID(0) : (CellID(1) << aWidth) - 1; }
+}
+
+CellIDRemap::CellIDRemap(const dd4hep::DDSegmentation::BitFieldCoder& aOld,
+                         const dd4hep::DDSegmentation::BitFieldCoder& aNew, const std::vector<std::string>& aFields) {
+  for (const auto& name : aFields) {
+    const auto& oldField = aOld[name];
+    const auto& newField = aNew[name];
+    if (oldField.isSigned() != newField.isSigned() || newField.width() < oldField.width()) {
+      m_conversions.emplace_back(&oldField, &newField);
+      continue;
+    }
+    FieldCopy copy;
+    copy.srcOffset = oldField.offset();
+    copy.dstOffset = newField.offset();
+    copy.srcMask = lowMask(oldField.width());
+    if (oldField.isSigned()) {
+      copy.signBit = CellID(1) << (oldField.width() - 1);
+      copy.signExtension = lowMask(newField.width()) & ~copy.srcMask;
+    } else {
+      copy.signBit = 0;
+      copy.signExtension = 0;
+    }
+    m_copies.push_back(copy);
+  }
+  m_sameLayout = m_conversions.empty();
+  for (const auto& copy : m_copies) {
+    m_sameLayout &= copy.srcOffset == copy.dstOffset && copy.signExtension == 0;
+    m_mask |= copy.srcMask << copy.srcOffset;
+  }
+}
+
+void CellIDRemap::apply(CellID* aCellIds, size_t aSize) const {
+  for (size_t i = 0; i < aSize; ++i) {
+    aCellIds[i] = remap(aCellIds[i], 0);
+  }
+}
+
+void CellIDRemap::apply(const CellID* aOldIds, CellID* aNewIds, size_t aSize) const {
+  for (size_t i = 0; i < aSize; ++i) {
+    aNewIds[i] = remap(aOldIds[i], aNewIds[i]);
+  }
+}
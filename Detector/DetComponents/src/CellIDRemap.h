@@ -0,0 +1,84 @@
+#ifndef DETCOMPONENTS_CELLIDREMAP_H
+#define DETCOMPONENTS_CELLIDREMAP_H
+
+// DD4hep
+#include "DDSegmentation/BitFieldCoder.h"
+
+// STL
+#include <string>
+#include <vector>
+
+/** @class CellIDRemap Detector/DetComponents/src/CellIDRemap.h CellIDRemap.h
+ *
+ *  Copy of fields from one bitfield to another, compiled once into shift and mask operations.
+ *  Fields that fit in the new bitfield (same signedness, at least the same width) are copied with masks, with the sign
+ *  extended for wider signed fields. Other fields go through the bitfield elements, that check the range of values.
+ *  If all the fields keep their position and width, they are copied at once with a single mask.
+ */
+
+class CellIDRemap {
+public:
+  /**  Compile the copy of the fields.
+   *   @param[in] aOld bitfield of the input cellIDs
+   *   @param[in] aNew bitfield of the output cellIDs
+   *   @param[in] aFields names of the fields to copy (that must exist in both bitfields)
+   */
+  CellIDRemap(const dd4hep::DDSegmentation::BitFieldCoder& aOld, const dd4hep::DDSegmentation::BitFieldCoder& aNew,
+              const std::vector<std::string>& aFields);
+  CellIDRemap() = default;
+  /**  Rewrite the cellIDs in place.
+   *   @param[in, out] aCellIds cellIDs in the old bitfield, replaced by the ones in the new bitfield
+   *   @param[in] aSize number of cellIDs
+   */
+  void apply(dd4hep::DDSegmentation::CellID* aCellIds, size_t aSize) const;
+  /**  Copy the fields into cellIDs that already have other fields set (their copied fields must be empty).
+   *   @param[in] aOldIds cellIDs in the old bitfield
+   *   @param[in, out] aNewIds cellIDs in the new bitfield, to which the fields are added
+   *   @param[in] aSize number of cellIDs
+   */
+  void apply(const dd4hep::DDSegmentation::CellID* aOldIds, dd4hep::DDSegmentation::CellID* aNewIds,
+             size_t aSize) const;
+  /// Rewrite one cellID
+  dd4hep::DDSegmentation::CellID apply(dd4hep::DDSegmentation::CellID aCellId) const { return remap(aCellId, 0); }
+  /// Whether the fields are copied with a single mask
+  bool sameLayout() const { return m_sameLayout; }
+  /// Number of fields copied with masks
+  size_t numMasked() const { return m_copies.size(); }
+  /// Number of fields copied through the bitfield elements
+  size_t numConverted() const { return m_conversions.size(); }
+
+private:
+  /// Add the copied fields of aOldId to aNewId
+  dd4hep::DDSegmentation::CellID remap(dd4hep::DDSegmentation::CellID aOldId,
+                                       dd4hep::DDSegmentation::CellID aNewId) const {
+    if (m_sameLayout) {
+      return aNewId | (aOldId & m_mask);
+    }
+    for (const auto& copy : m_copies) {
+      dd4hep::DDSegmentation::CellID bits = (aOldId >> copy.srcOffset) & copy.srcMask;
+      bits |= (bits & copy.signBit) ? copy.signExtension : 0;
+      aNewId |= bits << copy.dstOffset;
+    }
+    for (const auto& conversion : m_conversions) {
+      conversion.second->set(aNewId, conversion.first->value(aOldId));
+    }
+    return aNewId;
+  }
+  struct FieldCopy {
+    unsigned srcOffset;
+    unsigned dstOffset;
+    dd4hep::DDSegmentation::CellID srcMask;
+    /// sign bit of the source field (0 for unsigned fields)
+    dd4hep::DDSegmentation::CellID signBit;
+    /// bits set above the source field, up to the width of the new field, if the sign bit is set
+    dd4hep::DDSegmentation::CellID signExtension;
+  };
+  std::vector<FieldCopy> m_copies;
+  /// Whether all the fields keep their position and width (and are then copied with m_mask)
+  bool m_sameLayout = false;
+  /// Mask of all the copied fields
+  dd4hep::DDSegmentation::CellID m_mask = 0;
+  std::vector<std::pair<const dd4hep::DDSegmentation::BitFieldElement*,
+                        const dd4hep::DDSegmentation::BitFieldElement*>> m_conversions;
+};
+#endif /* DETCOMPONENTS_CELLIDREMAP_H */
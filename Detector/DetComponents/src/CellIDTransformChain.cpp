@@ -0,0 +1,202 @@
+#include "CellIDTransformChain.h"
+#include "HitAggregator.h"
+
+// datamodel
+#include "edm4hep/CalorimeterHitCollection.h"
+#include "edm4hep/SimCalorimeterHitCollection.h"
+
+// DD4hep
+#include "DD4hep/Detector.h"
+#include "DDSegmentation/Segmentation.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+using dd4hep::DDSegmentation::CellID;
+
+namespace {
+/// Split the string at the separator (no element for an empty string)
+std::vector<std::string> split(const std::string& aString, char aSeparator) {
+  std::vector<std::string> parts;
+  std::stringstream stream(aString);
+  std::string part;
+  while (std::getline(stream, part, aSeparator)) {
+    parts.push_back(part);
+  }
+  return parts;
+}
+}
+
+void CellIDTransformChain::reset(dd4hep::DDSegmentation::BitFieldCoder* aDecoder) {
+  m_inDecoder = aDecoder;
+  m_steps.clear();
+}
+
+StatusCode CellIDTransformChain::add(const std::string& aSpec, const dd4hep::Detector& aDetector, MsgStream& aLog) {
+  dd4hep::DDSegmentation::BitFieldCoder* decoder = outputDecoder();
+  std::vector<std::string> args = split(aSpec, ':');
+  if (args.size() < 2 || args.size() > 3) {
+    aLog << MSG::ERROR << "Transformation <<" << aSpec << ">> should be given as type:argument[:list]" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  const std::string& type = args[0];
+  std::vector<std::string> list = args.size() > 2 ? split(args[2], ',') : std::vector<std::string>();
+  Step step;
+  if (type == "redoSegmentation" || type == "rewriteBitfield") {
+    if (aDetector.readouts().find(args[1]) == aDetector.readouts().end()) {
+      aLog << MSG::ERROR << "Readout <<" << args[1] << ">> does not exist." << endmsg;
+      return StatusCode::FAILURE;
+    }
+    auto readout = aDetector.readout(args[1]);
+    step.type = type == "redoSegmentation" ? Step::RedoSegmentation : Step::RewriteBitfield;
+    if (step.type == Step::RedoSegmentation) {
+      step.segmentation = std::make_shared<const SegmentationCopies>(readout.segmentation());
+      step.decoder = readout.segmentation().segmentation()->decoder();
+    } else {
+      step.decoder = readout.idSpec().decoder();
+    }
+    // detector identifiers (= all fields - replaced ones) are kept
+    std::vector<std::string> keptFields;
+    for (uint itField = 0; itField < decoder->size(); itField++) {
+      std::string field = (*decoder)[itField].name();
+      if (std::find(list.begin(), list.end(), field) != list.end()) continue;
+      bool found = false;
+      for (uint itNewField = 0; itNewField < step.decoder->size(); itNewField++) {
+        found |= (*step.decoder)[itNewField].name() == field;
+      }
+      if (!found) {
+        aLog << MSG::ERROR << "New readout does not contain field <<" << field << ">> that describes the detector ID." << endmsg;
+        return StatusCode::FAILURE;
+      }
+      keptFields.push_back(field);
+    }
+    step.remap = CellIDRemap(*decoder, *step.decoder, keptFields);
+  } else if (type == "mergeLayers" || type == "mergeCells") {
+    bool found = false;
+    for (uint itField = 0; itField < decoder->size(); itField++) {
+      found |= (*decoder)[itField].name() == args[1];
+    }
+    if (!found) {
+      aLog << MSG::ERROR << "Identifier <<" << args[1] << ">> does not exist in the bitfield " << decoder->fieldDescription()
+              << endmsg;
+      return StatusCode::FAILURE;
+    }
+    step.decoder = decoder;
+    step.field = &(*decoder)[args[1]];
+    try {
+      if (type == "mergeLayers") {
+        step.type = Step::MergeLayers;
+        for (unsigned int i = 0; i < list.size(); i++) {
+          step.newVolumeId.insert(step.newVolumeId.end(), std::stoul(list[i]), i);
+        }
+      } else {
+        step.type = Step::MergeCells;
+        step.numToMerge = list.size() == 1 ? std::stoi(list[0]) : 0;
+      }
+    } catch (const std::logic_error&) {
+      aLog << MSG::ERROR << "Transformation <<" << aSpec << ">> should list the numbers of cells to be merged" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    if (step.type == Step::MergeCells) {
+      if (step.numToMerge < 2 || step.numToMerge > std::pow(2, step.field->width())) {
+        aLog << MSG::ERROR << "Number of cells to be merged must be larger than 1 and not larger than the number of cells."
+                << endmsg;
+        return StatusCode::FAILURE;
+      }
+      if (step.field->isSigned() && (step.numToMerge % 2 == 0)) {
+        aLog << MSG::ERROR << "If field is signed, merge can only be done for an odd number of cells"
+                << "(to ensure that middle cell is centred at 0)." << endmsg;
+        return StatusCode::FAILURE;
+      }
+    }
+  } else {
+    aLog << MSG::ERROR << "Unknown transformation <<" << type << ">>, possible: redoSegmentation, mergeLayers, mergeCells and "
+            << "rewriteBitfield" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_steps.push_back(std::move(step));
+  return StatusCode::SUCCESS;
+}
+
+template <typename Hits>
+void CellIDTransformChain::transformHits(const Hits& aHits, std::vector<CellID>& aCellIds) const {
+  aCellIds.clear();
+  aCellIds.reserve(aHits.size());
+  for (const auto& hit : aHits) {
+    aCellIds.push_back(hit.getCellID());
+  }
+  // each transformation is applied to all the cellIDs before the next one
+  std::vector<CellID> newCellIds;
+  for (const auto& step : m_steps) {
+    switch (step.type) {
+    case Step::RedoSegmentation: {
+      newCellIds.resize(aCellIds.size());
+      const auto& segmentation = step.segmentation->local();
+      size_t iHit = 0;
+      for (const auto& hit : aHits) {
+        // factor 10 to convert mm to cm, as in RedoSegmentation
+        auto pos = hit.getPosition();
+        dd4hep::DDSegmentation::Vector3D position(pos.x / 10., pos.y / 10., pos.z / 10.);
+        newCellIds[iHit++] = segmentation.cellID(position, position, 0);
+      }
+      step.remap.apply(aCellIds.data(), newCellIds.data(), aCellIds.size());
+      aCellIds.swap(newCellIds);
+      break;
+    }
+    case Step::RewriteBitfield:
+      step.remap.apply(aCellIds.data(), aCellIds.size());
+      break;
+    case Step::MergeLayers:
+      for (auto& cellId : aCellIds) {
+        CellID value = step.field->value(cellId);
+        if (value < step.newVolumeId.size()) {
+          step.field->set(cellId, step.newVolumeId[value]);
+        }
+      }
+      break;
+    case Step::MergeCells:
+      for (auto& cellId : aCellIds) {
+        long value = step.field->value(cellId);
+        if (step.field->isSigned()) {
+          value += value < 0 ? -step.numToMerge / 2 : step.numToMerge / 2;
+        }
+        step.field->set(cellId, value / step.numToMerge);
+      }
+      break;
+    }
+  }
+}
+
+void CellIDTransformChain::transform(const edm4hep::CalorimeterHitCollection& aHits,
+                                     std::vector<CellID>& aCellIds) const {
+  transformHits(aHits, aCellIds);
+}
+
+void CellIDTransformChain::transform(const edm4hep::SimCalorimeterHitCollection& aHits,
+                                     std::vector<CellID>& aCellIds) const {
+  transformHits(aHits, aCellIds);
+}
+
+void CellIDTransformChain::fill(const edm4hep::CalorimeterHitCollection& aHits, const std::vector<CellID>& aCellIds,
+                                bool aAggregate, edm4hep::CalorimeterHitCollection& aOutHits) {
+  size_t iHit = 0;
+  HitAggregator aggregator;
+  for (const auto& hit : aHits) {
+    const CellID cellId = aCellIds[iHit++];
+    if (aAggregate) {
+      aggregator.add(hit, cellId);
+      continue;
+    }
+    edm4hep::CalorimeterHit newHit = aOutHits.create();
+    newHit.setEnergy(hit.getEnergy());
+    newHit.setEnergyError(hit.getEnergyError());
+    newHit.setPosition(hit.getPosition());
+    newHit.setType(hit.getType());
+    newHit.setTime(hit.getTime());
+    newHit.setCellID(cellId);
+  }
+  aggregator.fill(aOutHits);
+}
@@ -0,0 +1,106 @@
+#ifndef DETCOMPONENTS_CELLIDTRANSFORMCHAIN_H
+#define DETCOMPONENTS_CELLIDTRANSFORMCHAIN_H
+
+// Gaudi
+#include "GaudiKernel/MsgStream.h"
+#include "GaudiKernel/StatusCode.h"
+
+// FCCSW
+#include "CellIDRemap.h"
+#include "SegmentationCopies.h"
+
+// STL
+#include <memory>
+
+// DD4hep
+namespace dd4hep {
+class Detector;
+}
+
+// datamodel
+namespace edm4hep {
+class CalorimeterHitCollection;
+class SimCalorimeterHitCollection;
+}
+
+/** @class CellIDTransformChain Detector/DetComponents/src/CellIDTransformChain.h CellIDTransformChain.h
+ *
+ *  Chain of cellID transformations, compiled once and then applied to whole collections of hits.
+ *  Each transformation is given as a string of the type and its arguments separated by ':' (lists separated by ','):
+ *   - "redoSegmentation:<new readout>:<old segmentation ids>"  (as RedoSegmentation, needs the true positions),
+ *   - "mergeLayers:<identifier>:<numbers of volumes>"          (as MergeLayers),
+ *   - "mergeCells:<identifier>:<number of cells>"              (as MergeCells),
+ *   - "rewriteBitfield:<new readout>:<ids to remove>"           (as RewriteBitfield).
+ *  Once compiled, the chain is not modified, so it can be used by several threads at the same time.
+ *  Each thread computes the new cellIDs with its own copy of the new segmentation (see SegmentationCopies).
+ */
+
+class CellIDTransformChain {
+public:
+  /**  Set the bitfield of the input hits (and remove all transformations).
+   *   @param[in] aDecoder bitfield of the input hits
+   */
+  void reset(dd4hep::DDSegmentation::BitFieldCoder* aDecoder);
+  /**  Compile one transformation and add it at the end of the chain.
+   *   @param[in] aSpec transformation as configured
+   *   @param[in] aDetector detector description, with the readouts
+   *   @param[in] aLog message stream for the configuration errors
+   *   @return status code
+   */
+  StatusCode add(const std::string& aSpec, const dd4hep::Detector& aDetector, MsgStream& aLog);
+  /**  Transform the cellIDs of the hits.
+   *   @param[in] aHits input hits
+   *   @param[out] aCellIds cellIDs of the hits after all transformations
+   */
+  void transform(const edm4hep::CalorimeterHitCollection& aHits,
+                 std::vector<dd4hep::DDSegmentation::CellID>& aCellIds) const;
+  /**  Transform the cellIDs of the simulated hits.
+   *   @param[in] aHits input hits
+   *   @param[out] aCellIds cellIDs of the hits after all transformations
+   */
+  void transform(const edm4hep::SimCalorimeterHitCollection& aHits,
+                 std::vector<dd4hep::DDSegmentation::CellID>& aCellIds) const;
+  /**  Create the output hits, with the transformed cellIDs.
+   *   @param[in] aHits input hits
+   *   @param[in] aCellIds cellIDs of the hits after all transformations
+   *   @param[in] aAggregate sum the hits that share a cellID (see HitAggregator)
+   *   @param[out] aOutHits output hits
+   */
+  static void fill(const edm4hep::CalorimeterHitCollection& aHits,
+                   const std::vector<dd4hep::DDSegmentation::CellID>& aCellIds, bool aAggregate,
+                   edm4hep::CalorimeterHitCollection& aOutHits);
+  /// Bitfield of the input hits
+  dd4hep::DDSegmentation::BitFieldCoder* inputDecoder() const { return m_inDecoder; }
+  /// Bitfield of the output hits
+  dd4hep::DDSegmentation::BitFieldCoder* outputDecoder() const {
+    return m_steps.empty() ? m_inDecoder : m_steps.back().decoder;
+  }
+  /// Number of transformations
+  size_t size() const { return m_steps.size(); }
+
+private:
+  /// Transform the cellIDs of the hits of any type with a cellID and a position
+  template <typename Hits>
+  void transformHits(const Hits& aHits, std::vector<dd4hep::DDSegmentation::CellID>& aCellIds) const;
+  /// One compiled transformation
+  struct Step {
+    enum Type { RedoSegmentation, MergeLayers, MergeCells, RewriteBitfield } type;
+    /// bitfield after the step (the one of the new readout, or unchanged)
+    dd4hep::DDSegmentation::BitFieldCoder* decoder = nullptr;
+    /// copies of the new segmentation, one per thread (redoSegmentation)
+    std::shared_ptr<const SegmentationCopies> segmentation;
+    /// copy of the fields kept from the previous bitfield (redoSegmentation, rewriteBitfield)
+    CellIDRemap remap;
+    /// merged field (mergeLayers, mergeCells)
+    const dd4hep::DDSegmentation::BitFieldElement* field = nullptr;
+    /// new volume ID for each old one (mergeLayers)
+    std::vector<unsigned int> newVolumeId;
+    /// number of cells to be merged (mergeCells)
+    int numToMerge = 1;
+  };
+  /// Bitfield of the input hits
+  dd4hep::DDSegmentation::BitFieldCoder* m_inDecoder = nullptr;
+  /// Compiled transformations
+  std::vector<Step> m_steps;
+};
+#endif /* DETCOMPONENTS_CELLIDTRANSFORMCHAIN_H */
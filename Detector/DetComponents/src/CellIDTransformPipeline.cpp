@@ -0,0 +1,69 @@
+#include "CellIDTransformPipeline.h"
+
+// FCCSW
+#include "k4Interface/IGeoSvc.h"
+
+// datamodel
+#include "edm4hep/CalorimeterHitCollection.h"
+
+// DD4hep
+#include "DD4hep/Detector.h"
+
+// STL
+#include <algorithm>
+
+using dd4hep::DDSegmentation::CellID;
+
+DECLARE_COMPONENT(CellIDTransformPipeline)
+
+CellIDTransformPipeline::CellIDTransformPipeline(const std::string& aName, ISvcLocator* aSvcLoc)
+    : GaudiAlgorithm(aName, aSvcLoc), m_geoSvc("GeoSvc", aName) {
+  declareProperty("inhits", m_inHits, "Hit collection to transform (input)");
+  declareProperty("outhits", m_outHits, "Transformed hit collection (output)");
+}
+
+CellIDTransformPipeline::~CellIDTransformPipeline() {}
+
+StatusCode CellIDTransformPipeline::initialize() {
+  if (GaudiAlgorithm::initialize().isFailure()) return StatusCode::FAILURE;
+
+  if (!m_geoSvc) {
+    error() << "Unable to locate Geometry Service. "
+            << "Make sure you have GeoSvc and SimSvc in the right order in the configuration." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_geoSvc->lcdd()->readouts().find(m_readoutName) == m_geoSvc->lcdd()->readouts().end()) {
+    error() << "Readout <<" << m_readoutName << ">> does not exist." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_chain.reset(m_geoSvc->lcdd()->readout(m_readoutName).idSpec().decoder());
+  info() << "Input bitfield:\t" << m_chain.inputDecoder()->fieldDescription() << endmsg;
+  for (const auto& spec : m_transformations) {
+    if (m_chain.add(spec, *m_geoSvc->lcdd(), info()).isFailure()) {
+      return StatusCode::FAILURE;
+    }
+    info() << "Transformation " << m_chain.size() << ": " << spec << endmsg;
+  }
+  info() << "Output bitfield:\t" << m_chain.outputDecoder()->fieldDescription() << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CellIDTransformPipeline::execute() {
+  const auto inHits = m_inHits.get();
+  auto outHits = new edm4hep::CalorimeterHitCollection();
+
+  std::vector<CellID> cellIds;
+  m_chain.transform(*inHits, cellIds);
+  for (size_t iHit = 0; iHit < std::min<size_t>(m_debugPrint, cellIds.size()); ++iHit) {
+    debug() << "OLD: " << m_chain.inputDecoder()->valueString((*inHits)[iHit].getCellID()) << endmsg;
+    debug() << "NEW: " << m_chain.outputDecoder()->valueString(cellIds[iHit]) << endmsg;
+  }
+  CellIDTransformChain::fill(*inHits, cellIds, m_aggregate, *outHits);
+  if (m_aggregate) {
+    debug() << inHits->size() << " hits summed into " << outHits->size() << " cells" << endmsg;
+  }
+  m_outHits.put(outHits);
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CellIDTransformPipeline::finalize() { return GaudiAlgorithm::finalize(); }
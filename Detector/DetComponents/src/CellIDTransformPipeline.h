@@ -0,0 +1,63 @@
+#ifndef DETCOMPONENTS_CELLIDTRANSFORMPIPELINE_H
+#define DETCOMPONENTS_CELLIDTRANSFORMPIPELINE_H
+
+// GAUDI
+#include "GaudiAlg/GaudiAlgorithm.h"
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+class IGeoSvc;
+#include "CellIDTransformChain.h"
+
+// datamodel
+namespace edm4hep {
+class CalorimeterHitCollection;
+}
+
+/** @class CellIDTransformPipeline Detector/DetComponents/src/CellIDTransformPipeline.h CellIDTransformPipeline.h
+ *
+ *  Apply a chain of cellID transformations in a single pass over the hits, instead of running RedoSegmentation,
+ *  MergeLayers, MergeCells and RewriteBitfield one after the other (each one copying the whole collection).
+ *  The readout of the input hits is given in '\b readout'. The transformations are listed in '\b transformations',
+ *  in the order in which they are applied (see CellIDTransformChain for their syntax).
+ *  After the last transformation, the hits sharing a cellID are summed if '\b aggregate' is set (see HitAggregator).
+ *  Only the final collection is created.
+ */
+
+class CellIDTransformPipeline : public GaudiAlgorithm {
+public:
+  explicit CellIDTransformPipeline(const std::string&, ISvcLocator*);
+  virtual ~CellIDTransformPipeline();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Execute.
+   *   @return status code
+   */
+  virtual StatusCode execute() final;
+  /**  Finalize.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+
+private:
+  /// Pointer to the geometry service
+  ServiceHandle<IGeoSvc> m_geoSvc;
+  /// Handle for the EDM hits to be read
+  DataHandle<edm4hep::CalorimeterHitCollection> m_inHits{"hits/caloInHits", Gaudi::DataHandle::Reader, this};
+  /// Handle for the EDM hits to be written
+  DataHandle<edm4hep::CalorimeterHitCollection> m_outHits{"hits/caloOutHits", Gaudi::DataHandle::Writer, this};
+  /// Name of the detector readout of the input hits
+  Gaudi::Property<std::string> m_readoutName{this, "readout", "", "Name of the detector readout of the input hits"};
+  /// Transformations, in the order in which they are applied
+  Gaudi::Property<std::vector<std::string>> m_transformations{
+      this, "transformations", {}, "Transformations, in the order in which they are applied"};
+  /// Sum the hits that share a cellID after the transformations
+  Gaudi::Property<bool> m_aggregate{this, "aggregate", false, "Sum the hits that share a cellID after the transformations"};
+  /// Limit of debug printing
+  Gaudi::Property<uint> m_debugPrint{this, "debugPrint", 10, "Limit of debug printing"};
+  /// Compiled transformations
+  CellIDTransformChain m_chain;
+};
+#endif /* DETCOMPONENTS_CELLIDTRANSFORMPIPELINE_H */
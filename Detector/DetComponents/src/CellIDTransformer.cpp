@@ -0,0 +1,126 @@
+#include "CellIDTransformer.h"
+
+// FCCSW
+#include "k4Interface/IGeoSvc.h"
+
+// datamodel
+#include "edm4hep/CalorimeterHitCollection.h"
+
+// DD4hep
+#include "DD4hep/Detector.h"
+
+DECLARE_COMPONENT(MergeCellsTransformer)
+DECLARE_COMPONENT(MergeLayersTransformer)
+DECLARE_COMPONENT(RedoSegmentationTransformer)
+DECLARE_COMPONENT(RewriteBitfieldTransformer)
+
+namespace {
+/// List joined with ','
+template <typename T>
+std::string join(const std::vector<T>& aList) {
+  std::string joined;
+  for (const auto& item : aList) {
+    joined += (joined.empty() ? "" : ",") + std::to_string(item);
+  }
+  return joined;
+}
+std::string join(const std::vector<std::string>& aList) {
+  std::string joined;
+  for (const auto& item : aList) {
+    joined += (joined.empty() ? "" : ",") + item;
+  }
+  return joined;
+}
+}
+
+CellIDTransformer::CellIDTransformer(const std::string& aName, ISvcLocator* aSvcLoc)
+    : GaudiAlgorithm(aName, aSvcLoc), m_geoSvc("GeoSvc", aName) {
+  declareProperty("inhits", m_inHits, "Hit collection to transform (input)");
+  declareProperty("outhits", m_outHits, "Transformed hit collection (output)");
+}
+
+CellIDTransformer::~CellIDTransformer() {}
+
+StatusCode CellIDTransformer::initialize() {
+  if (GaudiAlgorithm::initialize().isFailure()) return StatusCode::FAILURE;
+
+  if (!m_geoSvc) {
+    error() << "Unable to locate Geometry Service. "
+            << "Make sure you have GeoSvc and SimSvc in the right order in the configuration." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  std::string readoutName;
+  std::vector<std::string> specs;
+  if (transformations(readoutName, specs).isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_geoSvc->lcdd()->readouts().find(readoutName) == m_geoSvc->lcdd()->readouts().end()) {
+    error() << "Readout <<" << readoutName << ">> does not exist." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_chain.reset(m_geoSvc->lcdd()->readout(readoutName).idSpec().decoder());
+  for (const auto& spec : specs) {
+    if (m_chain.add(spec, *m_geoSvc->lcdd(), info()).isFailure()) {
+      return StatusCode::FAILURE;
+    }
+    info() << "Transformation: " << spec << endmsg;
+  }
+  info() << "Old bitfield:\t" << m_chain.inputDecoder()->fieldDescription() << endmsg;
+  info() << "New bitfield:\t" << m_chain.outputDecoder()->fieldDescription() << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CellIDTransformer::execute() {
+  const auto inHits = m_inHits.get();
+  auto outHits = new edm4hep::CalorimeterHitCollection();
+  std::vector<dd4hep::DDSegmentation::CellID> cellIds;
+  m_chain.transform(*inHits, cellIds);
+  CellIDTransformChain::fill(*inHits, cellIds, m_aggregate, *outHits);
+  m_outHits.put(outHits);
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CellIDTransformer::finalize() { return GaudiAlgorithm::finalize(); }
+
+StatusCode MergeCellsTransformer::transformations(std::string& aReadoutName,
+                                                  std::vector<std::string>& aTransformations) const {
+  if (m_idToMerge.empty()) {
+    error() << "No identifier to merge specified." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  aReadoutName = m_readoutName;
+  aTransformations = {"mergeCells:" + m_idToMerge.value() + ":" + std::to_string(m_numToMerge.value())};
+  return StatusCode::SUCCESS;
+}
+
+StatusCode MergeLayersTransformer::transformations(std::string& aReadoutName,
+                                                   std::vector<std::string>& aTransformations) const {
+  if (m_idToMerge.empty()) {
+    error() << "No identifier to merge specified." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  info() << "Merging volumes named: " << m_volumeName << endmsg;
+  aReadoutName = m_readoutName;
+  aTransformations = {"mergeLayers:" + m_idToMerge.value() + ":" + join(m_listToMerge.value())};
+  return StatusCode::SUCCESS;
+}
+
+StatusCode RedoSegmentationTransformer::transformations(std::string& aReadoutName,
+                                                        std::vector<std::string>& aTransformations) const {
+  if (m_oldIdentifiers.empty()) {
+    warning() << "No previous segmentation identifiers. Volume ID may be recomputed incorrectly." << endmsg;
+  }
+  aReadoutName = m_oldReadoutName;
+  aTransformations = {"redoSegmentation:" + m_newReadoutName.value() + ":" + join(m_oldIdentifiers.value())};
+  return StatusCode::SUCCESS;
+}
+
+StatusCode RewriteBitfieldTransformer::transformations(std::string& aReadoutName,
+                                                       std::vector<std::string>& aTransformations) const {
+  if (m_oldIdentifiers.empty()) {
+    info() << "No identifiers to remove. Only rewritting the readout" << endmsg;
+  }
+  aReadoutName = m_oldReadoutName;
+  aTransformations = {"rewriteBitfield:" + m_newReadoutName.value() + ":" + join(m_oldIdentifiers.value())};
+  return StatusCode::SUCCESS;
+}
@@ -0,0 +1,158 @@
+#ifndef DETCOMPONENTS_CELLIDTRANSFORMER_H
+#define DETCOMPONENTS_CELLIDTRANSFORMER_H
+
+// GAUDI
+#include "GaudiAlg/GaudiAlgorithm.h"
+#include "GaudiKernel/ServiceHandle.h"
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+#include "CellIDTransformChain.h"
+class IGeoSvc;
+
+// datamodel
+namespace edm4hep {
+class CalorimeterHitCollection;
+}
+
+/** @class CellIDTransformer Detector/DetComponents/src/CellIDTransformer.h CellIDTransformer.h
+ *
+ *  Base of the versions of the cellID transformations MergeCells, MergeLayers, RedoSegmentation and RewriteBitfield
+ *  that use the CellIDTransformChain compiled at initialisation, as CellIDTransformPipeline does.
+ *  The algorithm is clonable: with the Hive scheduler, the clones (\b'Cardinality') transform the hits of different
+ *  events concurrently, each with the chain compiled in its own initialisation.
+ *  The input and output collections are given by '\b inhits' and '\b outhits', and the hits sharing a cellID after the
+ *  transformation are summed if '\b aggregate' is set.
+ */
+
+class CellIDTransformer : public GaudiAlgorithm {
+public:
+  CellIDTransformer(const std::string& aName, ISvcLocator* aSvcLoc);
+  virtual ~CellIDTransformer();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() override;
+  /**  Execute: transform the cellIDs of the hits.
+   *   @return status code
+   */
+  virtual StatusCode execute() override;
+  /**  Finalize.
+   *   @return status code
+   */
+  virtual StatusCode finalize() override;
+  /// Clones of the algorithm may process different events concurrently
+  virtual bool isClonable() const override { return true; }
+
+protected:
+  /**  Readout of the input hits and the transformations to apply (see CellIDTransformChain).
+   *   @param[out] aReadoutName name of the readout of the input hits
+   *   @param[out] aTransformations transformations, in the order in which they are applied
+   *   @return status code
+   */
+  virtual StatusCode transformations(std::string& aReadoutName, std::vector<std::string>& aTransformations) const = 0;
+
+private:
+  /// Pointer to the geometry service
+  ServiceHandle<IGeoSvc> m_geoSvc;
+  /// Handle for the EDM hits to be read
+  DataHandle<edm4hep::CalorimeterHitCollection> m_inHits{"hits/caloInHits", Gaudi::DataHandle::Reader, this};
+  /// Handle for the EDM hits to be written
+  DataHandle<edm4hep::CalorimeterHitCollection> m_outHits{"hits/caloOutHits", Gaudi::DataHandle::Writer, this};
+  /// Sum the hits that share a cellID after the transformation
+  Gaudi::Property<bool> m_aggregate{this, "aggregate", false, "Sum the hits that share a cellID after the transformation"};
+  /// Compiled transformations
+  CellIDTransformChain m_chain;
+};
+
+/** @class MergeCellsTransformer Detector/DetComponents/src/CellIDTransformer.h CellIDTransformer.h
+ *
+ *  Version of MergeCells using CellIDTransformChain, with the same properties.
+ */
+class MergeCellsTransformer : public CellIDTransformer {
+public:
+  using CellIDTransformer::CellIDTransformer;
+
+protected:
+  virtual StatusCode transformations(std::string& aReadoutName,
+                                     std::vector<std::string>& aTransformations) const override;
+
+private:
+  /// Name of the detector readout
+  Gaudi::Property<std::string> m_readoutName{this, "readout", "", "Name of the detector readout"};
+  /// Identifier to be merged
+  Gaudi::Property<std::string> m_idToMerge{this, "identifier", "", "Identifier to be merged"};
+  /// Number of adjacent cells to be merged
+  Gaudi::Property<uint> m_numToMerge{this, "merge", 0, "Number of adjacent cells to be merged"};
+};
+
+/** @class MergeLayersTransformer Detector/DetComponents/src/CellIDTransformer.h CellIDTransformer.h
+ *
+ *  Version of MergeLayers using CellIDTransformChain, with the same properties.
+ */
+class MergeLayersTransformer : public CellIDTransformer {
+public:
+  using CellIDTransformer::CellIDTransformer;
+
+protected:
+  virtual StatusCode transformations(std::string& aReadoutName,
+                                     std::vector<std::string>& aTransformations) const override;
+
+private:
+  /// Name of the detector readout
+  Gaudi::Property<std::string> m_readoutName{this, "readout", "", "Name of the detector readout"};
+  /// Identifier to be merged
+  Gaudi::Property<std::string> m_idToMerge{this, "identifier", "", "Identifier to be merged"};
+  /// Name (or its part) of the volume
+  Gaudi::Property<std::string> m_volumeName{this, "volumeName", "", "Name (or its part) of the volume"};
+  /// List with number of adjacent cells to be merged
+  Gaudi::Property<std::vector<uint>> m_listToMerge{
+      this, "merge", {}, "List with number of adjacent cells to be merged"};
+};
+
+/** @class RedoSegmentationTransformer Detector/DetComponents/src/CellIDTransformer.h CellIDTransformer.h
+ *
+ *  Version of RedoSegmentation using CellIDTransformChain, with the same properties.
+ */
+class RedoSegmentationTransformer : public CellIDTransformer {
+public:
+  using CellIDTransformer::CellIDTransformer;
+
+protected:
+  virtual StatusCode transformations(std::string& aReadoutName,
+                                     std::vector<std::string>& aTransformations) const override;
+
+private:
+  /// Name of the detector readout used in simulation
+  Gaudi::Property<std::string> m_oldReadoutName{this, "oldReadoutName", "",
+                                                "Name of the detector readout used in simulation"};
+  /// Name of the new detector readout
+  Gaudi::Property<std::string> m_newReadoutName{this, "newReadoutName", "", "Name of the new detector readout"};
+  /// Segmentation fields that are going to be replaced by the new segmentation
+  Gaudi::Property<std::vector<std::string>> m_oldIdentifiers{
+      this, "oldSegmentationIds", {}, "Segmentation fields that are going to be replaced by the new segmentation"};
+};
+
+/** @class RewriteBitfieldTransformer Detector/DetComponents/src/CellIDTransformer.h CellIDTransformer.h
+ *
+ *  Version of RewriteBitfield using CellIDTransformChain, with the same properties.
+ */
+class RewriteBitfieldTransformer : public CellIDTransformer {
+public:
+  using CellIDTransformer::CellIDTransformer;
+
+protected:
+  virtual StatusCode transformations(std::string& aReadoutName,
+                                     std::vector<std::string>& aTransformations) const override;
+
+private:
+  /// Name of the detector readout used in simulation
+  Gaudi::Property<std::string> m_oldReadoutName{this, "oldReadoutName", "",
+                                                "Name of the detector readout used in simulation"};
+  /// Name of the new detector readout
+  Gaudi::Property<std::string> m_newReadoutName{this, "newReadoutName", "", "Name of the new detector readout"};
+  /// Segmentation fields that are going to be removed from the readout
+  Gaudi::Property<std::vector<std::string>> m_oldIdentifiers{
+      this, "removeIds", {}, "Segmentation fields that are going to be removed"};
+};
+#endif /* DETCOMPONENTS_CELLIDTRANSFORMER_H */
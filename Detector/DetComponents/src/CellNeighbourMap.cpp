@@ -0,0 +1,102 @@
+#include "CellNeighbourMap.h"
+
+// STL
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+
+namespace det {
+static_assert(sizeof(CellNeighbourMap::Header) == 24, "Header of the neighbour map is written without padding");
+
+CellNeighbourMap::~CellNeighbourMap() { clear(); }
+
+void CellNeighbourMap::clear() {
+  m_file.reset();
+  m_numCells = 0;
+  m_cellIDs = m_offsets = m_neighbours = nullptr;
+  m_cellIDsInMemory.clear();
+  m_offsetsInMemory.clear();
+  m_neighboursInMemory.clear();
+}
+
+bool CellNeighbourMap::map(const std::string& aFileName) {
+  clear();
+  m_error.clear();
+  sim::MappedFile file(aFileName, sizeof(Header), "a neighbour map");
+  if (!file.isMapped()) {
+    m_error = file.error();
+    return false;
+  }
+  Header header;
+  std::memcpy(&header, file.data(), sizeof(Header));
+  if (std::strncmp(header.magic, kMagic, sizeof(header.magic)) != 0) {
+    m_error = aFileName + " is not a neighbour map (wrong magic string)";
+  } else if ((file.size() - sizeof(Header)) / sizeof(uint64_t) != 2 * header.numCells + 1 + header.numNeighbours) {
+    m_error = aFileName + " has an inconsistent size";
+  }
+  if (!m_error.empty()) {
+    return false;
+  }
+  m_file = std::move(file);
+  m_numCells = header.numCells;
+  m_cellIDs = m_file.at<uint64_t>(sizeof(Header));
+  m_offsets = m_cellIDs + m_numCells;
+  m_neighbours = m_offsets + m_numCells + 1;
+  if (m_offsets[m_numCells] != header.numNeighbours) {
+    m_error = aFileName + " has inconsistent offsets";
+    clear();
+    return false;
+  }
+  return true;
+}
+
+void CellNeighbourMap::assign(std::vector<uint64_t>&& aCellIDs, std::vector<uint64_t>&& aOffsets,
+                              std::vector<uint64_t>&& aNeighbours) {
+  clear();
+  m_cellIDsInMemory = std::move(aCellIDs);
+  m_offsetsInMemory = std::move(aOffsets);
+  m_neighboursInMemory = std::move(aNeighbours);
+  m_numCells = m_cellIDsInMemory.size();
+  m_cellIDs = m_cellIDsInMemory.data();
+  m_offsets = m_offsetsInMemory.data();
+  m_neighbours = m_neighboursInMemory.data();
+}
+
+bool CellNeighbourMap::write(const std::string& aFileName) const {
+  Header header;
+  std::memset(&header, 0, sizeof(header));
+  std::strncpy(header.magic, kMagic, sizeof(header.magic));
+  header.numCells = m_numCells;
+  header.numNeighbours = numNeighbours();
+  const std::string temporaryName = aFileName + ".tmp" + std::to_string(::getpid());
+  {
+    std::ofstream file(temporaryName, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (m_numCells > 0) {
+      file.write(reinterpret_cast<const char*>(m_cellIDs), m_numCells * sizeof(uint64_t));
+      file.write(reinterpret_cast<const char*>(m_offsets), (m_numCells + 1) * sizeof(uint64_t));
+      file.write(reinterpret_cast<const char*>(m_neighbours), header.numNeighbours * sizeof(uint64_t));
+    } else {
+      const uint64_t noNeighbours = 0;
+      file.write(reinterpret_cast<const char*>(&noNeighbours), sizeof(noNeighbours));
+    }
+    file.close();
+    if (!file) {
+      std::remove(temporaryName.c_str());
+      return false;
+    }
+  }
+  return std::rename(temporaryName.c_str(), aFileName.c_str()) == 0;
+}
+
+size_t CellNeighbourMap::neighbours(uint64_t aCellID, const uint64_t*& aNeighbours) const {
+  aNeighbours = nullptr;
+  const uint64_t* cell = std::lower_bound(m_cellIDs, m_cellIDs + m_numCells, aCellID);
+  if (cell == m_cellIDs + m_numCells || *cell != aCellID) return 0;
+  const size_t iCell = cell - m_cellIDs;
+  aNeighbours = m_neighbours + m_offsets[iCell];
+  return m_offsets[iCell + 1] - m_offsets[iCell];
+}
+}
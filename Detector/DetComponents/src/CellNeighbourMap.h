@@ -0,0 +1,91 @@
+#ifndef DETCOMPONENTS_CELLNEIGHBOURMAP_H
+#define DETCOMPONENTS_CELLNEIGHBOURMAP_H
+
+// FCCSW
+#include "SimG4Common/MappedFile.h"
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** @class det::CellNeighbourMap Detector/DetComponents/src/CellNeighbourMap.h CellNeighbourMap.h
+ *
+ *  Neighbours of the cells of a readout in the compressed sparse row format, used by CellNeighboursSvc.
+ *  The file starts with the header CellNeighbourMap::Header, followed by the sorted cellIDs of the cells, the offsets
+ *  of their neighbours (one more than the cells, the last one is the number of neighbours) and the cellIDs of the
+ *  neighbours (sorted for each cell), all uint64. The file is mapped in memory, so that its pages are shared by all
+ *  the processes on the node using the same map; a cell is found by binary search.
+ */
+
+namespace det {
+class CellNeighbourMap {
+public:
+  /// Header of the file of the map
+  struct Header {
+    /// "K4CNBR1" followed by the zero
+    char magic[8];
+    /// Number of cells
+    uint64_t numCells;
+    /// Number of neighbours of all the cells
+    uint64_t numNeighbours;
+  };
+  CellNeighbourMap() = default;
+  /// Destructor. Unmaps the file.
+  ~CellNeighbourMap();
+  CellNeighbourMap(const CellNeighbourMap&) = delete;
+  CellNeighbourMap& operator=(const CellNeighbourMap&) = delete;
+
+  /** Map the file of the map in memory.
+   *  @param[in] aFileName name of the file
+   *  @returns whether the file was mapped
+   */
+  bool map(const std::string& aFileName);
+  /** Use the map held in memory.
+   *  @param[in] aCellIDs sorted cellIDs of the cells
+   *  @param[in] aOffsets offsets of the neighbours of the cells
+   *  @param[in] aNeighbours neighbours of the cells
+   */
+  void assign(std::vector<uint64_t>&& aCellIDs, std::vector<uint64_t>&& aOffsets, std::vector<uint64_t>&& aNeighbours);
+  /** Write the map to a file (renamed once written, not to affect the processes mapping the previous file).
+   *  @param[in] aFileName name of the file
+   *  @returns whether the whole map was written
+   */
+  bool write(const std::string& aFileName) const;
+  /** Get the neighbours of a cell.
+   *  @param[in] aCellID cellID of the cell
+   *  @param[out] aNeighbours first of the neighbours
+   *  @returns number of neighbours (0 if the cell is not in the map)
+   */
+  size_t neighbours(uint64_t aCellID, const uint64_t*& aNeighbours) const;
+  /// Number of cells
+  size_t size() const { return m_numCells; }
+  /// Number of neighbours of all the cells
+  size_t numNeighbours() const { return m_numCells > 0 ? m_offsets[m_numCells] : 0; }
+  /// Reason why the file could not be mapped
+  const std::string& error() const { return m_error; }
+  /// Magic string of the file
+  static constexpr const char* kMagic = "K4CNBR1";
+
+private:
+  /// Unmap the file and release the map held in memory
+  void clear();
+  /// Number of cells
+  size_t m_numCells = 0;
+  /// Sorted cellIDs, offsets and neighbours (within the mapped file or the vectors)
+  const uint64_t* m_cellIDs = nullptr;
+  const uint64_t* m_offsets = nullptr;
+  const uint64_t* m_neighbours = nullptr;
+  /// Mapped file (not mapped if the map is held in memory)
+  sim::MappedFile m_file;
+  /// Map held in memory (if not mapped)
+  std::vector<uint64_t> m_cellIDsInMemory;
+  std::vector<uint64_t> m_offsetsInMemory;
+  std::vector<uint64_t> m_neighboursInMemory;
+  /// Reason why the file could not be mapped
+  std::string m_error;
+};
+}
+
+#endif /* DETCOMPONENTS_CELLNEIGHBOURMAP_H */
@@ -0,0 +1,214 @@
+#include "CellNeighboursSvc.h"
+
+// FCCSW
+#include "GeoSvc.h"
+
+// DD4hep
+#include "DD4hep/Detector.h"
+#include "DDSegmentation/BitFieldCoder.h"
+
+// STL
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+DECLARE_COMPONENT(CellNeighboursSvc)
+
+CellNeighboursSvc::CellNeighboursSvc(const std::string& aName, ISvcLocator* aSvcLoc)
+    : base_class(aName, aSvcLoc), m_geoSvc("GeoSvc", aName) {}
+
+CellNeighboursSvc::~CellNeighboursSvc() {}
+
+StatusCode CellNeighboursSvc::initialize() {
+  if (Service::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (!m_geoSvc) {
+    error() << "Unable to locate Geometry Service. "
+            << "Make sure you have GeoSvc and CellNeighboursSvc in the right order in the configuration." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_geoSvc->lcdd()->readouts().find(m_readoutName) == m_geoSvc->lcdd()->readouts().end()) {
+    error() << "Readout <<" << m_readoutName << ">> does not exist." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  const std::string fileName = mapFileName();
+  if (!fileName.empty() && m_map.map(fileName)) {
+    info() << "Neighbours of " << m_map.size() << " cells of " << m_readoutName.value() << " read from " << fileName
+           << endmsg;
+    return StatusCode::SUCCESS;
+  }
+  if (buildMap().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  info() << "Neighbours of " << m_map.size() << " cells of " << m_readoutName.value() << " built ("
+         << m_map.numNeighbours() << " neighbours)" << endmsg;
+  if (!fileName.empty()) {
+    // the saved map is used, so that its pages are shared with the other processes
+    if (!m_map.write(fileName)) {
+      warning() << "Unable to write the neighbour map to " << fileName << endmsg;
+    } else if (!m_map.map(fileName)) {
+      error() << "Unable to map the neighbour map written to " << fileName << ": " << m_map.error() << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CellNeighboursSvc::finalize() { return Service::finalize(); }
+
+size_t CellNeighboursSvc::neighbours(uint64_t aCellID, const uint64_t*& aNeighbours) const {
+  return m_map.neighbours(aCellID, aNeighbours);
+}
+
+std::string CellNeighboursSvc::mapFileName() {
+  if (m_mapDir.value().empty()) return "";
+  // the map is valid only for the geometry described by the same files
+  auto geoSvc = dynamic_cast<GeoSvc*>(m_geoSvc.get());
+  const std::string geometryHash = geoSvc != nullptr ? geoSvc->geometryHash() : "";
+  if (geometryHash.empty()) {
+    warning() << "No hash of the geometry, the neighbour map is not saved" << endmsg;
+    return "";
+  }
+  // FNV-1a hash of the bit field and of the configuration
+  std::stringstream configuration;
+  configuration << m_readoutName.value() << "|"
+                << m_geoSvc->lcdd()->readout(m_readoutName).idSpec().decoder()->fieldDescription() << "|";
+  for (const auto& range : m_fieldRanges.value()) {
+    configuration << range.first << ":";
+    for (long value : range.second) configuration << value << ",";
+  }
+  configuration << "|";
+  for (const auto& field : m_neighbourFields.value()) configuration << field << ",";
+  configuration << "|";
+  for (const auto& field : m_periodicFields.value()) configuration << field << ",";
+  configuration << "|" << m_diagonal.value();
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : configuration.str()) {
+    hash = (hash ^ c) * 1099511628211ull;
+  }
+  std::stringstream fileName;
+  fileName << m_mapDir.value() << "/neighbours_" << geometryHash << "_" << std::hex << std::setw(16)
+           << std::setfill('0') << hash << ".bin";
+  return fileName.str();
+}
+
+StatusCode CellNeighboursSvc::buildMap() {
+  const dd4hep::DDSegmentation::BitFieldCoder* decoder =
+      m_geoSvc->lcdd()->readout(m_readoutName).idSpec().decoder();
+  // ranges of the enumerated fields
+  struct FieldRange {
+    const dd4hep::DDSegmentation::BitFieldElement* field;
+    long min, max;
+    bool neighbour, periodic;
+  };
+  if (m_fieldRanges.value().empty()) {
+    error() << "No ranges of the fields of the cells given (fieldRanges)" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  std::vector<FieldRange> ranges;
+  unsigned long numCells = 1;
+  for (const auto& given : m_fieldRanges.value()) {
+    const dd4hep::DDSegmentation::BitFieldElement* field = nullptr;
+    try {
+      field = &(*decoder)[decoder->index(given.first)];
+    } catch (const std::exception& e) {
+      error() << "Readout " << m_readoutName.value() << " does not contain the field: " << e.what() << endmsg;
+      return StatusCode::FAILURE;
+    }
+    if (given.second.size() != 2 || given.second[0] > given.second[1] || given.second[0] < field->minValue() ||
+        given.second[1] > field->maxValue()) {
+      error() << "Range of the field " << given.first << " needs a minimum and a maximum within ["
+              << field->minValue() << ", " << field->maxValue() << "]" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    const auto& neighbourFields = m_neighbourFields.value();
+    const bool neighbour = neighbourFields.empty()
+                               ? given.second[1] > given.second[0]
+                               : std::find(neighbourFields.begin(), neighbourFields.end(), given.first) !=
+                                     neighbourFields.end();
+    const bool periodic =
+        std::find(m_periodicFields.begin(), m_periodicFields.end(), given.first) != m_periodicFields.end();
+    ranges.push_back({field, given.second[0], given.second[1], neighbour, periodic});
+    numCells *= given.second[1] - given.second[0] + 1;
+    if (numCells > m_maxCells) {
+      error() << "More than " << m_maxCells.value() << " cells in the ranges of the fields" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  for (const auto& field : m_neighbourFields.value()) {
+    if (m_fieldRanges.value().count(field) == 0) {
+      error() << "Neighbour field " << field << " has no range in fieldRanges" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  // all the combinations of the values of the fields
+  std::vector<uint64_t> cellIDs;
+  cellIDs.reserve(numCells);
+  std::vector<long> values;
+  for (const auto& range : ranges) values.push_back(range.min);
+  for (unsigned long iCell = 0; iCell < numCells; ++iCell) {
+    dd4hep::DDSegmentation::CellID cellID = 0;
+    for (size_t iRange = 0; iRange < ranges.size(); ++iRange) {
+      ranges[iRange].field->set(cellID, values[iRange]);
+    }
+    cellIDs.push_back(cellID);
+    for (size_t iRange = 0; iRange < ranges.size() && ++values[iRange] > ranges[iRange].max; ++iRange) {
+      values[iRange] = ranges[iRange].min;
+    }
+  }
+  std::sort(cellIDs.begin(), cellIDs.end());
+  // steps to the neighbours: one in one field (or in several, if diagonal)
+  std::vector<size_t> neighbourRanges;
+  for (size_t iRange = 0; iRange < ranges.size(); ++iRange) {
+    if (ranges[iRange].neighbour) neighbourRanges.push_back(iRange);
+  }
+  std::vector<std::vector<int>> steps;
+  if (m_diagonal) {
+    std::vector<int> step(neighbourRanges.size(), -1);
+    while (true) {
+      if (std::any_of(step.begin(), step.end(), [](int aStep) { return aStep != 0; })) steps.push_back(step);
+      size_t iStep = 0;
+      while (iStep < step.size() && ++step[iStep] > 1) {
+        step[iStep++] = -1;
+      }
+      if (iStep == step.size()) break;
+    }
+  } else {
+    for (size_t iStep = 0; iStep < neighbourRanges.size(); ++iStep) {
+      for (int direction : {-1, 1}) {
+        steps.emplace_back(neighbourRanges.size(), 0);
+        steps.back()[iStep] = direction;
+      }
+    }
+  }
+  std::vector<uint64_t> offsets{0};
+  offsets.reserve(cellIDs.size() + 1);
+  std::vector<uint64_t> neighbourIDs;
+  std::vector<uint64_t> cellNeighbours;
+  for (uint64_t cellID : cellIDs) {
+    cellNeighbours.clear();
+    for (const auto& step : steps) {
+      dd4hep::DDSegmentation::CellID neighbour = cellID;
+      bool inRange = true;
+      for (size_t iStep = 0; iStep < step.size() && inRange; ++iStep) {
+        if (step[iStep] == 0) continue;
+        const FieldRange& range = ranges[neighbourRanges[iStep]];
+        long value = range.field->value(cellID) + step[iStep];
+        if (value < range.min || value > range.max) {
+          inRange = range.periodic;
+          value = value < range.min ? range.max : range.min;
+        }
+        range.field->set(neighbour, value);
+      }
+      if (inRange && neighbour != cellID) cellNeighbours.push_back(neighbour);
+    }
+    // periodic fields of one or two values give the same neighbour twice
+    std::sort(cellNeighbours.begin(), cellNeighbours.end());
+    cellNeighbours.erase(std::unique(cellNeighbours.begin(), cellNeighbours.end()), cellNeighbours.end());
+    neighbourIDs.insert(neighbourIDs.end(), cellNeighbours.begin(), cellNeighbours.end());
+    offsets.push_back(neighbourIDs.size());
+  }
+  m_map.assign(std::move(cellIDs), std::move(offsets), std::move(neighbourIDs));
+  return StatusCode::SUCCESS;
+}
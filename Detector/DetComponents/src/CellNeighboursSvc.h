@@ -0,0 +1,79 @@
+#ifndef DETCOMPONENTS_CELLNEIGHBOURSSVC_H
+#define DETCOMPONENTS_CELLNEIGHBOURSSVC_H
+
+// Gaudi
+#include "GaudiKernel/Service.h"
+#include "GaudiKernel/ServiceHandle.h"
+
+// FCCSW
+#include "CellNeighbourMap.h"
+#include "SimG4Interface/ICellNeighboursSvc.h"
+class IGeoSvc;
+
+// STL
+#include <map>
+#include <string>
+#include <vector>
+
+/** @class CellNeighboursSvc Detector/DetComponents/src/CellNeighboursSvc.h CellNeighboursSvc.h
+ *
+ *  Service giving the neighbours of the cells of the readout \b'readout', from a map (det::CellNeighbourMap) built
+ *  once with the bit field decoder of the readout.
+ *  The cells are all the combinations of the values of the fields in \b'fieldRanges' (minimum and maximum of each
+ *  field, the fields not given are 0), at most \b'maxCells'. The neighbours of a cell differ by one in one of the
+ *  \b'neighbourFields' (by default the fields in \b'fieldRanges' with more than one value), or in several of them if
+ *  \b'diagonal' is set; the \b'periodicFields' (e.g. the azimuthal index) wrap around at the ends of their ranges.
+ *  If \b'mapDir' is set, the map is saved in this directory, in a file keyed by the hash of the geometry of GeoSvc
+ *  and of the configuration, and mapped in memory: the next jobs with the same geometry read it instead of building
+ *  it again, and the concurrent processes share its pages.
+ */
+
+class CellNeighboursSvc : public extends<Service, ICellNeighboursSvc> {
+public:
+  CellNeighboursSvc(const std::string& aName, ISvcLocator* aSvcLoc);
+  virtual ~CellNeighboursSvc();
+  /**  Initialize: read or build the map.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /**  Get the neighbours of a cell.
+   *   @param[in] aCellID cellID of the cell
+   *   @param[out] aNeighbours first of the cellIDs of the neighbours, sorted (valid as long as the service)
+   *   @return number of neighbours (0 if the cell is not in the map)
+   */
+  virtual size_t neighbours(uint64_t aCellID, const uint64_t*& aNeighbours) const final;
+
+private:
+  /// Build the map from the ranges of the fields
+  StatusCode buildMap();
+  /// Name of the file of the map (empty if it is not saved)
+  std::string mapFileName();
+  /// Pointer to the geometry service
+  ServiceHandle<IGeoSvc> m_geoSvc;
+  /// Name of the readout
+  Gaudi::Property<std::string> m_readoutName{this, "readout", "", "Name of the readout of the cells"};
+  /// Ranges of the fields of the cells
+  Gaudi::Property<std::map<std::string, std::vector<long>>> m_fieldRanges{
+      this, "fieldRanges", {}, "Minimum and maximum values of the fields of the cells (others are 0)"};
+  /// Fields along which the cells are neighbours
+  Gaudi::Property<std::vector<std::string>> m_neighbourFields{
+      this, "neighbourFields", {}, "Fields along which the cells are neighbours (default: fields with several values)"};
+  /// Fields wrapping around at the ends of their ranges
+  Gaudi::Property<std::vector<std::string>> m_periodicFields{
+      this, "periodicFields", {}, "Fields whose first and last values are neighbours (e.g. phi)"};
+  /// Flag whether the cells differing by one in several fields are neighbours
+  Gaudi::Property<bool> m_diagonal{this, "diagonal", false,
+                                   "Include the neighbours differing by one in several fields (diagonal)"};
+  /// Maximum number of cells
+  Gaudi::Property<unsigned long> m_maxCells{this, "maxCells", 100000000, "Maximum number of cells of the map"};
+  /// Directory of the file of the map (not saved if empty)
+  Gaudi::Property<std::string> m_mapDir{this, "mapDir", "", "Directory where the neighbour map is saved"};
+  /// Neighbours of the cells
+  det::CellNeighbourMap m_map;
+};
+
+#endif /* DETCOMPONENTS_CELLNEIGHBOURSSVC_H */
@@ -0,0 +1,71 @@
+#include "CellPositionSvc.h"
+
+// FCCSW
+#include "CellPositionTable.h"
+#include "GeoSvc.h"
+
+// DD4hep
+#include "DD4hep/Detector.h"
+
+DECLARE_COMPONENT(CellPositionSvc)
+
+CellPositionSvc::CellPositionSvc(const std::string& aName, ISvcLocator* aSvcLoc)
+    : base_class(aName, aSvcLoc), m_geoSvc("GeoSvc", aName) {}
+
+CellPositionSvc::~CellPositionSvc() {}
+
+StatusCode CellPositionSvc::initialize() {
+  if (Service::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (!m_geoSvc) {
+    error() << "Unable to locate Geometry Service. "
+            << "Make sure you have GeoSvc and CellPositionSvc in the right order in the configuration." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_tableDir.value().empty()) {
+    // the tables are valid only for the geometry described by the same files
+    auto geoSvc = dynamic_cast<GeoSvc*>(m_geoSvc.get());
+    m_geometryHash = geoSvc != nullptr ? geoSvc->geometryHash() : "";
+    if (m_geometryHash.empty()) {
+      warning() << "No hash of the geometry, the tables of the cell positions are not saved" << endmsg;
+    }
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode CellPositionSvc::finalize() {
+  for (const auto& table : m_tables) {
+    info() << "Positions of " << table.first << ": " << table.second->numMapped() << " cells read, "
+           << table.second->numComputed() << " cells computed" << endmsg;
+    if (!table.second->write()) {
+      warning() << "Unable to write the table of the cell positions of " << table.first << endmsg;
+    }
+  }
+  m_tables.clear();
+  return Service::finalize();
+}
+
+const ICellPositionSvc::Table* CellPositionSvc::table(const std::string& aReadoutName) {
+  std::lock_guard<std::mutex> lock(m_tablesMutex);
+  auto table = m_tables.find(aReadoutName);
+  if (table != m_tables.end()) {
+    return table->second.get();
+  }
+  dd4hep::Detector* lcdd = m_geoSvc->lcdd();
+  if (lcdd->readouts().find(aReadoutName) == lcdd->readouts().end()) {
+    error() << "Readout <<" << aReadoutName << ">> does not exist." << endmsg;
+    return nullptr;
+  }
+  const std::string fileName =
+      m_geometryHash.empty() ? ""
+                             : m_tableDir.value() + "/cellpositions_" + m_geometryHash + "_" + aReadoutName + ".bin";
+  auto newTable = std::make_unique<det::CellPositionTable>(lcdd->readout(aReadoutName).segmentation().segmentation(),
+                                                           lcdd->volumeManager(), fileName);
+  if (!newTable->error().empty()) {
+    warning() << newTable->error() << ", the positions of " << aReadoutName << " are computed again" << endmsg;
+  }
+  debug() << "Table of the positions of " << aReadoutName << " created with " << newTable->numMapped() << " cells"
+          << endmsg;
+  return m_tables.emplace(aReadoutName, std::move(newTable)).first->second.get();
+}
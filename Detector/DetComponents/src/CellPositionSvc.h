@@ -0,0 +1,62 @@
+#ifndef DETCOMPONENTS_CELLPOSITIONSVC_H
+#define DETCOMPONENTS_CELLPOSITIONSVC_H
+
+// Gaudi
+#include "GaudiKernel/Service.h"
+#include "GaudiKernel/ServiceHandle.h"
+
+// FCCSW
+#include "SimG4Interface/ICellPositionSvc.h"
+class IGeoSvc;
+namespace det {
+class CellPositionTable;
+}
+
+// STL
+#include <map>
+#include <memory>
+#include <mutex>
+
+/** @class CellPositionSvc Detector/DetComponents/src/CellPositionSvc.h CellPositionSvc.h
+ *
+ *  Service giving the positions of the centres of the cells from a table per readout (det::CellPositionTable),
+ *  created at the first request for the readout and shared by all the threads. Each cell is computed once by the
+ *  segmentation and the volume manager, and then looked up in the table.
+ *  If \b'tableDir' is set, the tables are saved at finalization in this directory, in files keyed by the hash of the
+ *  geometry of GeoSvc and by the readout name, and mapped in memory by the next jobs with the same geometry (also
+ *  by concurrent processes, which share the pages): the cells of the previous jobs are not computed again.
+ */
+
+class CellPositionSvc : public extends<Service, ICellPositionSvc> {
+public:
+  CellPositionSvc(const std::string& aName, ISvcLocator* aSvcLoc);
+  virtual ~CellPositionSvc();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize: write the tables.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /**  Get the table of a readout (created at the first call for this readout).
+   *   @param[in] aReadoutName name of the readout
+   *   @return table of the positions (owned by the service), nullptr if the readout does not exist
+   */
+  virtual const Table* table(const std::string& aReadoutName) final;
+
+private:
+  /// Pointer to the geometry service
+  ServiceHandle<IGeoSvc> m_geoSvc;
+  /// Directory of the files of the tables (not saved if empty)
+  Gaudi::Property<std::string> m_tableDir{this, "tableDir", "",
+                                          "Directory where the tables of the cell positions are saved"};
+  /// Hash of the geometry, part of the names of the files
+  std::string m_geometryHash;
+  /// Tables by readout name
+  std::map<std::string, std::unique_ptr<det::CellPositionTable>> m_tables;
+  /// Mutex protecting the creation of the tables
+  std::mutex m_tablesMutex;
+};
+
+#endif /* DETCOMPONENTS_CELLPOSITIONSVC_H */
@@ -0,0 +1,115 @@
+#include "CellPositionTable.h"
+
+// DD4hep
+#include "DD4hep/DD4hepUnits.h"
+#include "DDSegmentation/Segmentation.h"
+
+// STL
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+#include <vector>
+
+namespace det {
+static_assert(sizeof(CellPositionTable::Header) == 24, "Header of the cell positions is written without padding");
+static_assert(sizeof(CellPositionTable::Slot) == 24, "Slots of the cell positions are written without padding");
+
+CellPositionTable::CellPositionTable(dd4hep::DDSegmentation::Segmentation* aSegmentation,
+                                     dd4hep::VolumeManager aVolumeManager, const std::string& aFileName)
+    : m_segmentation(aSegmentation), m_volumeManager(aVolumeManager), m_fileName(aFileName) {
+  std::memset(&m_header, 0, sizeof(m_header));
+  if (m_fileName.empty()) return;
+  m_file = sim::MappedFile(m_fileName, sizeof(Header), "a table of cell positions");
+  if (!m_file.isOpened()) {
+    // no table yet, it is written at the end of the job
+    return;
+  }
+  if (!m_file.isMapped()) {
+    m_error = m_file.error();
+    return;
+  }
+  std::memcpy(&m_header, m_file.data(), sizeof(Header));
+  if (std::strncmp(m_header.magic, kMagic, sizeof(m_header.magic)) != 0) {
+    m_error = m_fileName + " is not a table of cell positions (wrong magic string)";
+  } else if (m_header.numSlots == 0 || (m_header.numSlots & (m_header.numSlots - 1)) != 0 ||
+             2 * m_header.numCells > m_header.numSlots ||
+             (m_file.size() - sizeof(Header)) / sizeof(Slot) != m_header.numSlots) {
+    m_error = m_fileName + " has an inconsistent size";
+  }
+  if (!m_error.empty()) {
+    m_file.reset();
+    std::memset(&m_header, 0, sizeof(m_header));
+    return;
+  }
+  m_slots = m_file.at<Slot>(sizeof(Header));
+}
+
+CellPositionTable::~CellPositionTable() {}
+
+ICellPositionSvc::Position CellPositionTable::position(uint64_t aCellID) const {
+  if (m_slots != nullptr) {
+    const uint64_t mask = m_header.numSlots - 1;
+    // the table is at most half full, the probing ends at an empty slot
+    for (uint64_t iSlot = hash(aCellID) & mask; m_slots[iSlot].used != 0; iSlot = (iSlot + 1) & mask) {
+      const Slot& slot = m_slots[iSlot];
+      if (slot.cellID == aCellID) return {slot.x, slot.y, slot.z};
+    }
+  }
+  auto computed = m_computed.find(aCellID);
+  if (computed != m_computed.end()) return computed->second;
+  // computed twice if two threads ask for the same new cell at once, only one is kept
+  const ICellPositionSvc::Position position = compute(aCellID);
+  m_computed.emplace(aCellID, position);
+  return position;
+}
+
+ICellPositionSvc::Position CellPositionTable::compute(uint64_t aCellID) const {
+  // centre of the cell in its volume, placed in the world
+  const dd4hep::DDSegmentation::Vector3D local = m_segmentation->position(aCellID);
+  const dd4hep::Position global = m_volumeManager.lookupContext(m_segmentation->volumeID(aCellID))
+                                      ->localToWorld(dd4hep::Position(local.X, local.Y, local.Z));
+  return {float(global.x() / dd4hep::mm), float(global.y() / dd4hep::mm), float(global.z() / dd4hep::mm)};
+}
+
+bool CellPositionTable::write() const {
+  if (m_fileName.empty() || m_computed.empty()) return true;
+  const uint64_t numCells = m_header.numCells + m_computed.size();
+  uint64_t numSlots = 16;
+  while (numSlots < 2 * numCells) {
+    numSlots *= 2;
+  }
+  std::vector<Slot> slots(numSlots, Slot{0, 0, 0, 0, 0});
+  auto insert = [&slots, numSlots](uint64_t aCellID, float aX, float aY, float aZ) {
+    uint64_t iSlot = hash(aCellID) & (numSlots - 1);
+    while (slots[iSlot].used != 0) {
+      iSlot = (iSlot + 1) & (numSlots - 1);
+    }
+    slots[iSlot] = {aCellID, aX, aY, aZ, 1};
+  };
+  for (uint64_t iSlot = 0; m_slots != nullptr && iSlot < m_header.numSlots; ++iSlot) {
+    if (m_slots[iSlot].used != 0) insert(m_slots[iSlot].cellID, m_slots[iSlot].x, m_slots[iSlot].y, m_slots[iSlot].z);
+  }
+  for (const auto& cell : m_computed) {
+    insert(cell.first, cell.second.x, cell.second.y, cell.second.z);
+  }
+  Header header;
+  std::memset(&header, 0, sizeof(header));
+  std::strncpy(header.magic, kMagic, sizeof(header.magic));
+  header.numSlots = numSlots;
+  header.numCells = numCells;
+  // written next to the table and renamed, so that the processes mapping the previous table are not affected
+  const std::string temporaryName = m_fileName + ".tmp" + std::to_string(::getpid());
+  {
+    std::ofstream file(temporaryName, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(Slot));
+    file.close();
+    if (!file) {
+      std::remove(temporaryName.c_str());
+      return false;
+    }
+  }
+  return std::rename(temporaryName.c_str(), m_fileName.c_str()) == 0;
+}
+}
@@ -0,0 +1,113 @@
+#ifndef DETCOMPONENTS_CELLPOSITIONTABLE_H
+#define DETCOMPONENTS_CELLPOSITIONTABLE_H
+
+// FCCSW
+#include "SimG4Common/MappedFile.h"
+#include "SimG4Interface/ICellPositionSvc.h"
+
+// DD4hep
+#include "DD4hep/VolumeManager.h"
+namespace dd4hep {
+namespace DDSegmentation {
+class Segmentation;
+}
+}
+
+// TBB
+#include "tbb/concurrent_unordered_map.h"
+
+// STL
+#include <string>
+
+/** @class det::CellPositionTable Detector/DetComponents/src/CellPositionTable.h CellPositionTable.h
+ *
+ *  Table of the positions of the cells of a readout, used by CellPositionSvc.
+ *  The cells of the previous jobs are read from a file mapped in memory (shared by the threads and the processes on
+ *  the node using the same geometry): an open-addressing hash table (linear probing, at most half full) of
+ *  CellPositionTable::Slot, after the header CellPositionTable::Header, so that a lookup reads one or a few slots.
+ *  The cells not in the file are computed once by the segmentation and the volume manager and kept in a concurrent
+ *  map; write() saves all the cells to a new file, that replaces the previous one.
+ */
+
+namespace det {
+class CellPositionTable : public ICellPositionSvc::Table {
+public:
+  /// Header of the file of the table
+  struct Header {
+    /// "K4CPOS1" followed by the zero
+    char magic[8];
+    /// Number of slots of the hash table (power of two)
+    uint64_t numSlots;
+    /// Number of cells
+    uint64_t numCells;
+  };
+  /// Slot of the hash table
+  struct Slot {
+    uint64_t cellID;
+    float x, y, z;
+    /// 0 for an empty slot
+    uint32_t used;
+  };
+  /** Constructor. Maps the file of the table, if it exists.
+   *  @param[in] aSegmentation segmentation of the readout
+   *  @param[in] aVolumeManager volume manager locating the volumes of the cells
+   *  @param[in] aFileName name of the file of the table (not used if empty)
+   */
+  CellPositionTable(dd4hep::DDSegmentation::Segmentation* aSegmentation, dd4hep::VolumeManager aVolumeManager,
+                    const std::string& aFileName);
+  /// Destructor. Unmaps the file.
+  virtual ~CellPositionTable();
+  CellPositionTable(const CellPositionTable&) = delete;
+  CellPositionTable& operator=(const CellPositionTable&) = delete;
+
+  /**  Get the position of a cell, computed if it is not in the table yet.
+   *   @param[in] aCellID cellID of the cell
+   *   @return position of the centre of the cell [mm]
+   */
+  virtual ICellPositionSvc::Position position(uint64_t aCellID) const final;
+  /** Write the table with all the cells to the file (if cells were computed).
+   *  @returns whether the file is up to date
+   */
+  bool write() const;
+  /// Number of the cells read from the file
+  size_t numMapped() const { return m_header.numCells; }
+  /// Number of the cells computed in this job
+  size_t numComputed() const { return m_computed.size(); }
+  /// Reason why the file could not be mapped (empty if it was mapped or does not exist)
+  const std::string& error() const { return m_error; }
+  /// Magic string of the file
+  static constexpr const char* kMagic = "K4CPOS1";
+
+private:
+  /// Hash of the cellID, giving its first slot in the table
+  static inline uint64_t hash(uint64_t aCellID) {
+    // cellIDs are bit fields, mixed (splitmix64 finalizer) not to fill the table in clusters
+    aCellID ^= aCellID >> 30;
+    aCellID *= 0xbf58476d1ce4e5b9ull;
+    aCellID ^= aCellID >> 27;
+    aCellID *= 0x94d049bb133111ebull;
+    aCellID ^= aCellID >> 31;
+    return aCellID;
+  }
+  /// Compute the position of the cell by the segmentation and the volume manager
+  ICellPositionSvc::Position compute(uint64_t aCellID) const;
+  /// Segmentation of the readout
+  dd4hep::DDSegmentation::Segmentation* m_segmentation;
+  /// Volume manager locating the volumes of the cells
+  dd4hep::VolumeManager m_volumeManager;
+  /// Name of the file of the table
+  std::string m_fileName;
+  /// Header of the mapped table
+  Header m_header;
+  /// Mapped file of the table
+  sim::MappedFile m_file;
+  /// Slots of the mapped table
+  const Slot* m_slots = nullptr;
+  /// Cells computed in this job
+  mutable tbb::concurrent_unordered_map<uint64_t, ICellPositionSvc::Position> m_computed;
+  /// Reason why the file could not be mapped
+  std::string m_error;
+};
+}
+
+#endif /* DETCOMPONENTS_CELLPOSITIONTABLE_H */
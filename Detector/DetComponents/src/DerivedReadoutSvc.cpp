@@ -0,0 +1,106 @@
+#include "DerivedReadoutSvc.h"
+
+// FCCSW
+#include "k4Interface/IGeoSvc.h"
+
+// Gaudi
+#include "GaudiKernel/ThreadLocalContext.h"
+
+// DD4hep
+#include "DD4hep/Detector.h"
+
+// datamodel
+#include "edm4hep/CalorimeterHitCollection.h"
+#include "edm4hep/SimCalorimeterHitCollection.h"
+
+DECLARE_COMPONENT(DerivedReadoutSvc)
+
+DerivedReadoutSvc::DerivedReadoutSvc(const std::string& aName, ISvcLocator* aSvcLoc)
+    : base_class(aName, aSvcLoc), m_geoSvc("GeoSvc", aName) {}
+
+DerivedReadoutSvc::~DerivedReadoutSvc() {}
+
+StatusCode DerivedReadoutSvc::initialize() {
+  if (Service::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (!m_geoSvc) {
+    error() << "Unable to locate Geometry Service. "
+            << "Make sure you have GeoSvc and DerivedReadoutSvc in the right order in the configuration." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  dd4hep::Detector* lcdd = m_geoSvc->lcdd();
+  if (lcdd->readouts().find(m_readoutName) == lcdd->readouts().end()) {
+    error() << "Readout <<" << m_readoutName.value() << ">> does not exist." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_cachedEvents == 0) {
+    error() << "Number of the cached events needs to be positive" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  for (const auto& derived : m_derivedReadouts.value()) {
+    CellIDTransformChain& chain = m_chains[derived.first];
+    chain.reset(lcdd->readout(m_readoutName).idSpec().decoder());
+    for (const auto& spec : derived.second) {
+      if (chain.add(spec, *lcdd, info()).isFailure()) {
+        error() << "Invalid transformation of the derived readout " << derived.first << endmsg;
+        return StatusCode::FAILURE;
+      }
+    }
+    info() << "Derived readout " << derived.first << ":\t" << chain.outputDecoder()->fieldDescription() << endmsg;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode DerivedReadoutSvc::finalize() {
+  info() << m_numRequests << " requests of derived cellIDs, " << m_numComputed << " collections computed" << endmsg;
+  m_cache.clear();
+  m_cachedEventNumbers.clear();
+  return Service::finalize();
+}
+
+std::shared_ptr<const std::vector<uint64_t>> DerivedReadoutSvc::cellIDs(
+    const std::string& aReadoutName, const edm4hep::CalorimeterHitCollection& aHits) {
+  return cached(aReadoutName, aHits);
+}
+
+std::shared_ptr<const std::vector<uint64_t>> DerivedReadoutSvc::cellIDs(
+    const std::string& aReadoutName, const edm4hep::SimCalorimeterHitCollection& aHits) {
+  return cached(aReadoutName, aHits);
+}
+
+const dd4hep::DDSegmentation::BitFieldCoder* DerivedReadoutSvc::decoder(const std::string& aReadoutName) const {
+  auto chain = m_chains.find(aReadoutName);
+  return chain != m_chains.end() ? chain->second.outputDecoder() : nullptr;
+}
+
+template <typename Hits>
+std::shared_ptr<const std::vector<uint64_t>> DerivedReadoutSvc::cached(const std::string& aReadoutName,
+                                                                      const Hits& aHits) {
+  auto chain = m_chains.find(aReadoutName);
+  if (chain == m_chains.end()) {
+    error() << "Readout " << aReadoutName << " is not derived from " << m_readoutName.value() << endmsg;
+    return nullptr;
+  }
+  ++m_numRequests;
+  const size_t event = Gaudi::Hive::currentContext().evt();
+  std::shared_ptr<Entry> entry;
+  {
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    auto& cachedEntry = m_cache[std::make_tuple(event, static_cast<const void*>(&aHits), aReadoutName)];
+    if (cachedEntry == nullptr) cachedEntry = std::make_shared<Entry>();
+    entry = cachedEntry;
+    // the oldest events are dropped, the cellIDs still used by the callers are kept by their pointers
+    if (m_cachedEventNumbers.insert(event).second && m_cachedEventNumbers.size() > m_cachedEvents) {
+      const size_t oldest = *m_cachedEventNumbers.begin();
+      m_cachedEventNumbers.erase(m_cachedEventNumbers.begin());
+      m_cache.erase(m_cache.begin(), m_cache.lower_bound(std::make_tuple(oldest + 1, nullptr, std::string())));
+    }
+  }
+  // computed outside of the lock, the other threads requesting the same collection wait for it
+  std::call_once(entry->computed, [&]() {
+    chain->second.transform(aHits, entry->cellIDs);
+    ++m_numComputed;
+  });
+  return std::shared_ptr<const std::vector<uint64_t>>(entry, &entry->cellIDs);
+}
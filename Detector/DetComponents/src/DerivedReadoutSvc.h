@@ -0,0 +1,97 @@
+#ifndef DETCOMPONENTS_DERIVEDREADOUTSVC_H
+#define DETCOMPONENTS_DERIVEDREADOUTSVC_H
+
+// Gaudi
+#include "GaudiKernel/Service.h"
+#include "GaudiKernel/ServiceHandle.h"
+
+// FCCSW
+#include "CellIDTransformChain.h"
+#include "SimG4Interface/IDerivedReadoutSvc.h"
+class IGeoSvc;
+
+// STL
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <set>
+#include <tuple>
+
+/** @class DerivedReadoutSvc Detector/DetComponents/src/DerivedReadoutSvc.h DerivedReadoutSvc.h
+ *
+ *  Service giving the cellIDs of the hits of the fine master readout \b'readout' in the derived readouts
+ *  \b'derivedReadouts' (name of each derived readout and its transformations, with the syntax of
+ *  CellIDTransformChain, e.g. "mergeCells:phi:2"), so that several granularities are studied from the hits saved
+ *  once, without the copies of RedoSegmentation, MergeCells, MergeLayers or RewriteBitfield.
+ *  The cellIDs of a derived readout are computed at the first request for a collection in the event, and shared by
+ *  the next requests for the same collection in the same event (by any thread). The cellIDs of the last
+ *  \b'cachedEvents' events are kept.
+ *  The names of the derived readouts only need to be readouts of the geometry if their transformations need them
+ *  (redoSegmentation, rewriteBitfield).
+ */
+
+class DerivedReadoutSvc : public extends<Service, IDerivedReadoutSvc> {
+public:
+  DerivedReadoutSvc(const std::string& aName, ISvcLocator* aSvcLoc);
+  virtual ~DerivedReadoutSvc();
+  /**  Initialize: compile the transformations.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /**  Get the cellIDs of the hits in a derived readout.
+   *   @param[in] aReadoutName name of the derived readout
+   *   @param[in] aHits hits of the master readout
+   *   @return cellIDs, one per hit in the order of the hits (nullptr if the readout is not derived)
+   */
+  virtual std::shared_ptr<const std::vector<uint64_t>> cellIDs(const std::string& aReadoutName,
+                                                               const edm4hep::CalorimeterHitCollection& aHits) final;
+  /**  Get the cellIDs of the simulated hits in a derived readout.
+   *   @param[in] aReadoutName name of the derived readout
+   *   @param[in] aHits hits of the master readout
+   *   @return cellIDs, one per hit in the order of the hits (nullptr if the readout is not derived)
+   */
+  virtual std::shared_ptr<const std::vector<uint64_t>> cellIDs(
+      const std::string& aReadoutName, const edm4hep::SimCalorimeterHitCollection& aHits) final;
+  /**  Get the bitfield of a derived readout.
+   *   @param[in] aReadoutName name of the derived readout
+   *   @return bitfield decoding the derived cellIDs (nullptr if the readout is not derived)
+   */
+  virtual const dd4hep::DDSegmentation::BitFieldCoder* decoder(const std::string& aReadoutName) const final;
+
+private:
+  /// CellIDs of a collection in a derived readout, computed once
+  struct Entry {
+    std::once_flag computed;
+    std::vector<uint64_t> cellIDs;
+  };
+  /// Get the cached cellIDs of the collection, computed by the chain of the derived readout at the first request
+  template <typename Hits>
+  std::shared_ptr<const std::vector<uint64_t>> cached(const std::string& aReadoutName, const Hits& aHits);
+  /// Pointer to the geometry service
+  ServiceHandle<IGeoSvc> m_geoSvc;
+  /// Name of the master readout
+  Gaudi::Property<std::string> m_readoutName{this, "readout", "", "Name of the fine master readout of the hits"};
+  /// Transformations of each derived readout
+  Gaudi::Property<std::map<std::string, std::vector<std::string>>> m_derivedReadouts{
+      this, "derivedReadouts", {}, "Transformations of the master readout into each derived readout"};
+  /// Number of the events whose cellIDs are kept
+  Gaudi::Property<unsigned int> m_cachedEvents{this, "cachedEvents", 8,
+                                               "Number of the events whose derived cellIDs are kept"};
+  /// Compiled transformations of the derived readouts
+  std::map<std::string, CellIDTransformChain> m_chains;
+  /// Cached cellIDs by event, collection and derived readout
+  std::map<std::tuple<size_t, const void*, std::string>, std::shared_ptr<Entry>> m_cache;
+  /// Events of the cached cellIDs
+  std::set<size_t> m_cachedEventNumbers;
+  /// Mutex protecting the cache
+  std::mutex m_cacheMutex;
+  /// Numbers of the requests and of the computed collections
+  std::atomic<unsigned long long> m_numRequests{0};
+  std::atomic<unsigned long long> m_numComputed{0};
+};
+
+#endif /* DETCOMPONENTS_DERIVEDREADOUTSVC_H */
@@ -0,0 +1,59 @@
+#include "ExpandCompactCalHits.h"
+
+// datamodel
+#include "edm4hep/SimCalorimeterHitCollection.h"
+
+// STL
+#include <cmath>
+
+DECLARE_COMPONENT(ExpandCompactCalHits)
+
+ExpandCompactCalHits::ExpandCompactCalHits(const std::string& aName, ISvcLocator* aSvcLoc)
+    : GaudiAlgorithm(aName, aSvcLoc), m_cellPositionSvc("CellPositionSvc", aName) {
+  declareProperty("cellIDs", m_cellIDs, "CellIDs of the cells in the compact format (input)");
+  declareProperty("energies", m_energies, "Quantised energies of the cells in the compact format (input)");
+  declareProperty("encoding", m_encoding, "Parameters of the encoding of the energy (input)");
+  declareProperty("hits", m_hits, "Simulated calorimeter hits (output)");
+}
+
+ExpandCompactCalHits::~ExpandCompactCalHits() {}
+
+StatusCode ExpandCompactCalHits::initialize() {
+  if (GaudiAlgorithm::initialize().isFailure()) return StatusCode::FAILURE;
+  if (!m_computePositions) {
+    return StatusCode::SUCCESS;
+  }
+  if (!m_cellPositionSvc) {
+    error() << "Unable to locate the service of the cell positions" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_positions = m_cellPositionSvc->table(m_readoutName);
+  return m_positions != nullptr ? StatusCode::SUCCESS : StatusCode::FAILURE;
+}
+
+StatusCode ExpandCompactCalHits::execute() {
+  const auto cellIDs = m_cellIDs.get();
+  const auto energies = m_energies.get();
+  const auto encoding = m_encoding.get();
+  auto hits = m_hits.createAndPut();
+  if (cellIDs->size() != energies->size() || encoding->size() < 2) {
+    error() << "Inconsistent collections of the compact format: " << cellIDs->size() << " cellIDs, "
+            << energies->size() << " energies, " << encoding->size() << " parameters of the encoding" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  const double minEnergy = (*encoding)[0];
+  const double logRatio = std::log((*encoding)[1]);
+  for (size_t iCell = 0; iCell < cellIDs->size(); ++iCell) {
+    const uint64_t cellID = (*cellIDs)[iCell];
+    auto hit = hits->create();
+    hit.setCellID(cellID);
+    hit.setEnergy(minEnergy * std::exp(logRatio * ((*energies)[iCell] - 1)));
+    if (m_positions != nullptr) {
+      const ICellPositionSvc::Position position = m_positions->position(cellID);
+      hit.setPosition({position.x, position.y, position.z});
+    }
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode ExpandCompactCalHits::finalize() { return GaudiAlgorithm::finalize(); }
@@ -0,0 +1,66 @@
+#ifndef DETCOMPONENTS_EXPANDCOMPACTCALHITS_H
+#define DETCOMPONENTS_EXPANDCOMPACTCALHITS_H
+
+// GAUDI
+#include "GaudiAlg/GaudiAlgorithm.h"
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+#include "SimG4Interface/ICellPositionSvc.h"
+
+// podio
+#include "podio/UserDataCollection.h"
+
+// datamodel
+namespace edm4hep {
+class SimCalorimeterHitCollection;
+}
+
+/** @class ExpandCompactCalHits Detector/DetComponents/src/ExpandCompactCalHits.h ExpandCompactCalHits.h
+ *
+ *  Expand the calorimeter cells saved in the compact format by SimG4SaveCompactCalHits (cellIDs, quantised energies
+ *  and parameters of their encoding) into simulated calorimeter hits.
+ *  If \b'computePositions' is set, the position of each hit is the centre of its cell, looked up by CellPositionSvc
+ *  in the table of the readout \b'readoutName' (all the cells of the input need to belong to this readout);
+ *  otherwise the hits keep no position.
+ */
+
+class ExpandCompactCalHits : public GaudiAlgorithm {
+public:
+  explicit ExpandCompactCalHits(const std::string&, ISvcLocator*);
+  virtual ~ExpandCompactCalHits();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Execute.
+   *   @return status code
+   */
+  virtual StatusCode execute() final;
+  /**  Finalize.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+
+private:
+  /// Pointer to the service of the cell positions
+  ServiceHandle<ICellPositionSvc> m_cellPositionSvc;
+  /// Handle for the cellIDs of the cells to be read
+  DataHandle<podio::UserDataCollection<uint64_t>> m_cellIDs{"CompactCaloHitCellIDs", Gaudi::DataHandle::Reader, this};
+  /// Handle for the quantised energies of the cells to be read
+  DataHandle<podio::UserDataCollection<uint16_t>> m_energies{"CompactCaloHitEnergies", Gaudi::DataHandle::Reader,
+                                                              this};
+  /// Handle for the parameters of the encoding of the energy to be read
+  DataHandle<podio::UserDataCollection<double>> m_encoding{"CompactCaloHitEncoding", Gaudi::DataHandle::Reader,
+                                                            this};
+  /// Handle for the EDM hits to be written
+  DataHandle<edm4hep::SimCalorimeterHitCollection> m_hits{"CaloHits", Gaudi::DataHandle::Writer, this};
+  /// Name of the readout of the cells
+  Gaudi::Property<std::string> m_readoutName{this, "readoutName", "", "Name of the readout of the cells"};
+  /// Flag whether the positions of the cells are computed
+  Gaudi::Property<bool> m_computePositions{this, "computePositions", true,
+                                           "Compute the positions of the cells from the segmentation"};
+  /// Table of the positions of the cells of the readout
+  const ICellPositionSvc::Table* m_positions = nullptr;
+};
+#endif /* DETCOMPONENTS_EXPANDCOMPACTCALHITS_H */
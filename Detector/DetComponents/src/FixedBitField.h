@@ -0,0 +1,115 @@
+#ifndef DETCOMPONENTS_FIXEDBITFIELD_H
+#define DETCOMPONENTS_FIXEDBITFIELD_H
+
+// DD4hep
+#include "DDSegmentation/BitFieldCoder.h"
+
+// STL
+#include <array>
+#include <cstring>
+#include <initializer_list>
+#include <tuple>
+#include <utility>
+
+/** @file FixedBitField.h Detector/DetComponents/src/FixedBitField.h FixedBitField.h
+ *
+ *  Bitfield layouts fixed at compile time, for the standard readouts, so that the extraction and insertion of a field
+ *  are inlined shifts and masks. A layout is selected at initialisation if it matches the bitfield of the readout
+ *  (names, offsets, widths and signedness of all the fields), otherwise the algorithms use dd4hep::BitFieldCoder.
+ *  Unlike dd4hep::BitFieldElement::set, the insertion does not check the range of the value: it is meant for
+ *  transformations that cannot make a value overflow its field (e.g. merging cells).
+ */
+
+/// Field of a fixed layout
+template <unsigned Offset, unsigned Width, bool Signed>
+struct FixedField {
+  static_assert(Width > 0 && Offset + Width <= 64, "field does not fit in the cellID");
+  static constexpr unsigned offset = Offset;
+  static constexpr unsigned width = Width;
+  static constexpr bool isSigned = Signed;
+  static constexpr dd4hep::DDSegmentation::CellID lowMask =
+      Width == 64 ? ~dd4hep::DDSegmentation::CellID(0) : (dd4hep::DDSegmentation::CellID(1) << Width) - 1;
+  static constexpr dd4hep::DDSegmentation::CellID mask = lowMask << Offset;
+  /// Value of the field (sign extended for signed fields)
+  static constexpr long long value(dd4hep::DDSegmentation::CellID aCellId) {
+    dd4hep::DDSegmentation::CellID bits = (aCellId >> Offset) & lowMask;
+    if (Signed && (bits >> (Width - 1)) & 1) {
+      bits |= ~lowMask;
+    }
+    return static_cast<long long>(bits);
+  }
+  /// Set the value of the field
+  static constexpr void set(dd4hep::DDSegmentation::CellID& aCellId, long long aValue) {
+    aCellId = (aCellId & ~mask) | ((static_cast<dd4hep::DDSegmentation::CellID>(aValue) & lowMask) << Offset);
+  }
+};
+
+/// Fixed layout of the fields, with their names given by Names::name(index)
+template <typename Names, typename... Fields>
+struct FixedBitField {
+  static constexpr size_t size = sizeof...(Fields);
+  template <size_t I>
+  using Field = std::tuple_element_t<I, std::tuple<Fields...>>;
+  /// Check that the bitfield of the readout has exactly this layout
+  static bool matches(const dd4hep::DDSegmentation::BitFieldCoder& aCoder) {
+    if (aCoder.size() != size) return false;
+    return matches(aCoder, std::index_sequence_for<Fields...>());
+  }
+  /**  Get the instantiation of a kernel for one field of the layout.
+   *   @tparam Kernel class template, parametrised with the field, with a static function run
+   *   @param[in] aIndex index of the field in the layout
+   */
+  template <template <typename> class Kernel>
+  static auto kernel(size_t aIndex) {
+    return kernel<Kernel>(aIndex, std::index_sequence_for<Fields...>());
+  }
+
+private:
+  template <size_t I>
+  static bool matches(const dd4hep::DDSegmentation::BitFieldElement& aField) {
+    return std::strcmp(aField.name().c_str(), Names::name(I)) == 0 && aField.offset() == Field<I>::offset &&
+           aField.width() == Field<I>::width && aField.isSigned() == Field<I>::isSigned;
+  }
+  template <size_t... I>
+  static bool matches(const dd4hep::DDSegmentation::BitFieldCoder& aCoder, std::index_sequence<I...>) {
+    bool match = true;
+    (void)std::initializer_list<int>{(match = match && matches<I>(aCoder[I]), 0)...};
+    return match;
+  }
+  template <template <typename> class Kernel, size_t... I>
+  static auto kernel(size_t aIndex, std::index_sequence<I...>) {
+    using Function = decltype(&Kernel<Field<0>>::run);
+    static constexpr std::array<Function, size> kernels = {&Kernel<Field<I>>::run...};
+    return kernels[aIndex];
+  }
+};
+
+namespace fixedbitfield {
+/// Names of the fields of the inclined ECal barrel readout ECalBarrelEta
+struct ECalBarrelEtaNames {
+  static const char* name(size_t aIndex) {
+    static const char* names[] = {"system", "cryo", "type", "subtype", "layer", "module", "eta"};
+    return names[aIndex];
+  }
+};
+/// Inclined ECal barrel readout ECalBarrelEta: system:4,cryo:1,type:3,subtype:3,layer:8,module:11,eta:9
+using ECalBarrelEta = FixedBitField<ECalBarrelEtaNames, FixedField<0, 4, false>, FixedField<4, 1, false>,
+                                    FixedField<5, 3, false>, FixedField<8, 3, false>, FixedField<11, 8, false>,
+                                    FixedField<19, 11, false>, FixedField<30, 9, false>>;
+
+/**  Get the kernel for the field of the first fixed layout that matches the bitfield.
+ *   @tparam Kernel class template, parametrised with the field, with a static function run
+ *   @param[in] aCoder bitfield of the readout
+ *   @param[in] aIndex index of the field
+ *   @return the kernel, or nullptr if no fixed layout matches
+ */
+template <template <typename> class Kernel>
+decltype(&Kernel<FixedField<0, 1, false>>::run) kernel(const dd4hep::DDSegmentation::BitFieldCoder& aCoder,
+                                                        size_t aIndex) {
+  if (ECalBarrelEta::matches(aCoder)) {
+    return ECalBarrelEta::kernel<Kernel>(aIndex);
+  }
+  return nullptr;
+}
+}
+#endif /* DETCOMPONENTS_FIXEDBITFIELD_H */
@@ -1,21 +1,179 @@
 #include "GeoConstruction.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <set>
 #include <stdexcept>
+#include <unistd.h>
 
 // DD4hep
+#include "DD4hep/DD4hepUnits.h"
 #include "DD4hep/Detector.h"
 #include "DD4hep/Plugins.h"
+#include "DD4hep/Printout.h"
 #include "DDG4/Geant4Converter.h"
+#include "TGeoBBox.h"
+#include "TGeoCompositeShape.h"
+#include "TGeoCone.h"
 #include "TGeoManager.h"
+#include "TGeoMaterial.h"
+#include "TGeoMatrix.h"
+#include "TGeoNode.h"
+#include "TGeoTrd1.h"
+#include "TGeoTrd2.h"
+#include "TGeoTube.h"
+#include "TGeoVolume.h"
 
 // Geant4
+#include "G4BooleanSolid.hh"
+#include "G4Box.hh"
+#include "G4Cons.hh"
+#include "G4GDMLParser.hh"
+#include "G4Material.hh"
 #include "G4PVPlacement.hh"
 #include "G4SDManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Trd.hh"
+#include "G4Tubs.hh"
 #include "G4VSensitiveDetector.hh"
 
 namespace det {
-  
-GeoConstruction::GeoConstruction(dd4hep::Detector& lcdd) : m_lcdd(lcdd) {}
+namespace {
+/// Name read from GDML without the suffix of the pointer (0x...) added when writing
+std::string stripName(const std::string& aName) { return aName.substr(0, aName.find("0x")); }
+
+/// Check if the values (Geant4 units) are the same, up to the precision of the values written to GDML
+bool sameValue(double aValue, double aG4Value) {
+  return std::abs(aValue - aG4Value) <= 1e-6 * std::max(std::abs(aValue), std::abs(aG4Value)) + 1e-9;
+}
+
+/// Length of DD4hep in Geant4 units
+double g4Length(double aLength) { return aLength / dd4hep::mm * CLHEP::mm; }
+
+/// Check if the material of the Geant4 volume (name and density) is the material of the DD4hep volume (whose density
+/// is in g/cm3, as in the DD4hep converter)
+bool sameMaterial(const TGeoVolume* aVolume, const G4LogicalVolume* aG4Volume) {
+  const TGeoMaterial* material = aVolume->GetMaterial();
+  const G4Material* g4material = aG4Volume->GetMaterial();
+  if (material == nullptr || g4material == nullptr) return material == nullptr && g4material == nullptr;
+  return stripName(g4material->GetName()) == material->GetName() &&
+         sameValue(material->GetDensity() * (CLHEP::g / CLHEP::cm3), g4material->GetDensity());
+}
+
+/// Check if the solid of the Geant4 volume has the dimensions of the shape of the DD4hep volume: all the parameters
+/// of boxes, tubes, cones and trapezoids, the extent along z of the other primitive solids (boolean solids are only
+/// checked to be boolean)
+bool sameSolid(const TGeoVolume* aVolume, const G4LogicalVolume* aG4Volume) {
+  const TGeoShape* shape = aVolume->GetShape();
+  const G4VSolid* solid = aG4Volume->GetSolid();
+  if (dynamic_cast<const G4BooleanSolid*>(solid) != nullptr) {
+    return dynamic_cast<const TGeoCompositeShape*>(shape) != nullptr;
+  }
+  if (auto box = dynamic_cast<const G4Box*>(solid)) {
+    auto geoBox = dynamic_cast<const TGeoBBox*>(shape);
+    return geoBox != nullptr && shape->IsA() == TGeoBBox::Class() &&
+           sameValue(g4Length(geoBox->GetDX()), box->GetXHalfLength()) &&
+           sameValue(g4Length(geoBox->GetDY()), box->GetYHalfLength()) &&
+           sameValue(g4Length(geoBox->GetDZ()), box->GetZHalfLength());
+  }
+  if (auto tube = dynamic_cast<const G4Tubs*>(solid)) {
+    auto geoTube = dynamic_cast<const TGeoTube*>(shape);
+    if (geoTube == nullptr || !sameValue(g4Length(geoTube->GetRmin()), tube->GetInnerRadius()) ||
+        !sameValue(g4Length(geoTube->GetRmax()), tube->GetOuterRadius()) ||
+        !sameValue(g4Length(geoTube->GetDz()), tube->GetZHalfLength())) {
+      return false;
+    }
+    auto geoSegment = dynamic_cast<const TGeoTubeSeg*>(shape);
+    return geoSegment == nullptr ||
+           sameValue((geoSegment->GetPhi2() - geoSegment->GetPhi1()) * CLHEP::deg, tube->GetDeltaPhiAngle());
+  }
+  if (auto cone = dynamic_cast<const G4Cons*>(solid)) {
+    auto geoCone = dynamic_cast<const TGeoCone*>(shape);
+    if (geoCone == nullptr || !sameValue(g4Length(geoCone->GetRmin1()), cone->GetInnerRadiusMinusZ()) ||
+        !sameValue(g4Length(geoCone->GetRmax1()), cone->GetOuterRadiusMinusZ()) ||
+        !sameValue(g4Length(geoCone->GetRmin2()), cone->GetInnerRadiusPlusZ()) ||
+        !sameValue(g4Length(geoCone->GetRmax2()), cone->GetOuterRadiusPlusZ()) ||
+        !sameValue(g4Length(geoCone->GetDz()), cone->GetZHalfLength())) {
+      return false;
+    }
+    auto geoSegment = dynamic_cast<const TGeoConeSeg*>(shape);
+    return geoSegment == nullptr ||
+           sameValue((geoSegment->GetPhi2() - geoSegment->GetPhi1()) * CLHEP::deg, cone->GetDeltaPhiAngle());
+  }
+  if (auto trd = dynamic_cast<const G4Trd*>(solid)) {
+    if (auto trd1 = dynamic_cast<const TGeoTrd1*>(shape)) {
+      return sameValue(g4Length(trd1->GetDx1()), trd->GetXHalfLength1()) &&
+             sameValue(g4Length(trd1->GetDx2()), trd->GetXHalfLength2()) &&
+             sameValue(g4Length(trd1->GetDy()), trd->GetYHalfLength1()) &&
+             sameValue(g4Length(trd1->GetDy()), trd->GetYHalfLength2()) &&
+             sameValue(g4Length(trd1->GetDz()), trd->GetZHalfLength());
+    }
+    auto trd2 = dynamic_cast<const TGeoTrd2*>(shape);
+    return trd2 != nullptr && sameValue(g4Length(trd2->GetDx1()), trd->GetXHalfLength1()) &&
+           sameValue(g4Length(trd2->GetDx2()), trd->GetXHalfLength2()) &&
+           sameValue(g4Length(trd2->GetDy1()), trd->GetYHalfLength1()) &&
+           sameValue(g4Length(trd2->GetDy2()), trd->GetYHalfLength2()) &&
+           sameValue(g4Length(trd2->GetDz()), trd->GetZHalfLength());
+  }
+  auto bounds = dynamic_cast<const TGeoBBox*>(shape);
+  if (bounds == nullptr) return false;
+  G4ThreeVector minimum, maximum;
+  solid->BoundingLimits(minimum, maximum);
+  return sameValue(g4Length(bounds->GetOrigin()[2] - bounds->GetDZ()), minimum.z()) &&
+         sameValue(g4Length(bounds->GetOrigin()[2] + bounds->GetDZ()), maximum.z());
+}
+
+/// Map the DD4hep volumes to the Geant4 volumes of the same tree
+/// @return false if the trees differ (names, daughters, materials or dimensions of the solids)
+bool mapVolumes(const TGeoVolume* aVolume, G4LogicalVolume* aG4Volume, dd4hep::sim::Geant4GeometryInfo& aInfo) {
+  // walk both volume trees, each (shared) volume is mapped once
+  std::vector<std::pair<const TGeoVolume*, G4LogicalVolume*>> volumes{{aVolume, aG4Volume}};
+  std::set<const TGeoVolume*> visited;
+  while (!volumes.empty()) {
+    const TGeoVolume* volume = volumes.back().first;
+    G4LogicalVolume* g4volume = volumes.back().second;
+    volumes.pop_back();
+    if (!visited.insert(volume).second) continue;
+    if (g4volume->GetName() != volume->GetName() ||
+        g4volume->GetNoDaughters() != static_cast<size_t>(volume->GetNdaughters()) ||
+        !sameMaterial(volume, g4volume) || !sameSolid(volume, g4volume)) {
+      return false;
+    }
+    aInfo.g4Volumes[volume] = g4volume;
+    dd4hep::SensitiveDetector sd = dd4hep::Volume(volume).sensitiveDetector();
+    if (sd.isValid()) {
+      aInfo.sensitives[sd].insert(volume);
+    }
+    std::map<std::string, G4VPhysicalVolume*> g4daughters;
+    for (size_t iDaughter = 0; iDaughter < g4volume->GetNoDaughters(); ++iDaughter) {
+      G4VPhysicalVolume* g4daughter = g4volume->GetDaughter(iDaughter);
+      g4daughters[g4daughter->GetName()] = g4daughter;
+    }
+    for (int iDaughter = 0; iDaughter < volume->GetNdaughters(); ++iDaughter) {
+      const TGeoNode* daughter = volume->GetNode(iDaughter);
+      auto g4daughter = g4daughters.find(daughter->GetName());
+      if (g4daughter == g4daughters.end()) {
+        return false;
+      }
+      aInfo.g4Placements[daughter] = g4daughter->second;
+      volumes.emplace_back(daughter->GetVolume(), g4daughter->second->GetLogicalVolume());
+    }
+  }
+  return true;
+}
+}
+
+GeoConstruction::GeoConstruction(dd4hep::Detector& lcdd, const std::string& aCacheFile,
+                                 const std::map<std::string, std::string>& aSensitiveTypes,
+                                 const SolidOptimisation& aSolidOptimisation,
+                                 const std::map<std::string, std::string>& aDetectorCacheFiles)
+    : m_lcdd(lcdd),
+      m_cacheFile(aCacheFile),
+      m_detectorCacheFiles(aDetectorCacheFiles),
+      m_sensitiveTypes(aSensitiveTypes),
+      m_solidOptimisation(aSolidOptimisation) {}
 
 GeoConstruction::~GeoConstruction() {}
 
@@ -30,51 +188,284 @@ void GeoConstruction::ConstructSDandField() {
   for (_SV::const_iterator iv = vols.begin(); iv != vols.end(); ++iv) {
     dd4hep::SensitiveDetector sd = (*iv).first;
     std::string typ = sd.type(), nam = sd.name();
-    // Sensitive detectors are deleted in ~G4SDManager
-    G4VSensitiveDetector* g4sd = dd4hep::PluginService::Create<G4VSensitiveDetector*>(typ, nam, &m_lcdd);
-    if (g4sd == nullptr) {
-      std::string tmp = typ;
-      tmp[0] = ::toupper(tmp[0]);
-      typ = "Geant4" + tmp;
-      g4sd = dd4hep::PluginService::Create<G4VSensitiveDetector*>(typ, nam, &m_lcdd);
-      if (g4sd == nullptr) {
-        dd4hep::PluginDebug dbg;
-        g4sd = dd4hep::PluginService::Create<G4VSensitiveDetector*>(typ, nam, &m_lcdd);
-        if (g4sd == nullptr) {
-          throw std::runtime_error("ConstructSDandField: FATAL Failed to "
-                                   "create Geant4 sensitive detector " +
-                                   nam + " of type " + typ + ".");
-        }
-      }
+    auto replaced = m_sensitiveTypes.find(typ);
+    if (replaced != m_sensitiveTypes.end()) {
+      typ = replaced->second;
     }
+    // Sensitive detectors are deleted in ~G4SDManager
+    G4VSensitiveDetector* g4sd = createSensitiveDetector(typ, nam);
     g4sd->Activate(true);
+    // registered once, before being attached to all its volumes
     G4SDManager::GetSDMpointer()->AddNewDetector(g4sd);
     const VolSet& sens_vols = (*iv).second;
     for (VolSet::const_iterator i = sens_vols.begin(); i != sens_vols.end(); ++i) {
       const TGeoVolume* vol = *i;
-      G4LogicalVolume* g4v = p->g4Volumes[vol];
-      if (g4v == nullptr) {
+      auto g4v = p->g4Volumes.find(vol);
+      if (g4v == p->g4Volumes.end() || g4v->second == nullptr) {
         throw std::runtime_error("ConstructSDandField: Failed to access G4LogicalVolume for SD " + nam + " of type " +
                                  typ + ".");
       }
-      G4SDManager::GetSDMpointer()->AddNewDetector(g4sd);
-      g4v->SetSensitiveDetector(g4sd);
+      g4v->second->SetSensitiveDetector(g4sd);
     }
   }
 }
 
+G4VSensitiveDetector* GeoConstruction::createSensitiveDetector(const std::string& aType, const std::string& aName) {
+  {
+    std::lock_guard<std::mutex> lock(m_sdFactoriesMutex);
+    auto factory = m_sdFactories.find(aType);
+    if (factory != m_sdFactories.end()) {
+      G4VSensitiveDetector* g4sd =
+          dd4hep::PluginService::Create<G4VSensitiveDetector*>(factory->second, aName, &m_lcdd);
+      if (g4sd == nullptr) {
+        throw std::runtime_error("ConstructSDandField: FATAL Failed to "
+                                 "create Geant4 sensitive detector " +
+                                 aName + " of type " + factory->second + ".");
+      }
+      return g4sd;
+    }
+  }
+  std::string typ = aType;
+  G4VSensitiveDetector* g4sd = dd4hep::PluginService::Create<G4VSensitiveDetector*>(typ, aName, &m_lcdd);
+  if (g4sd == nullptr) {
+    std::string tmp = typ;
+    tmp[0] = ::toupper(tmp[0]);
+    typ = "Geant4" + tmp;
+    g4sd = dd4hep::PluginService::Create<G4VSensitiveDetector*>(typ, aName, &m_lcdd);
+    if (g4sd == nullptr) {
+      dd4hep::PluginDebug dbg;
+      g4sd = dd4hep::PluginService::Create<G4VSensitiveDetector*>(typ, aName, &m_lcdd);
+      if (g4sd == nullptr) {
+        throw std::runtime_error("ConstructSDandField: FATAL Failed to "
+                                 "create Geant4 sensitive detector " +
+                                 aName + " of type " + typ + ".");
+      }
+    }
+  }
+  std::lock_guard<std::mutex> lock(m_sdFactoriesMutex);
+  m_sdFactories.emplace(aType, typ);
+  return g4sd;
+}
+
 // method borrowed from dd4hep::sim::Geant4DetectorConstruction::Construct()
 G4VPhysicalVolume* GeoConstruction::Construct() {
   dd4hep::sim::Geant4Mapping& g4map = dd4hep::sim::Geant4Mapping::instance();
-  dd4hep::DetElement world = m_lcdd.world();
-  dd4hep::sim::Geant4Converter conv(m_lcdd, dd4hep::DEBUG);
-  dd4hep::sim::Geant4GeometryInfo* geo_info = conv.create(world).detach();
-  g4map.attach(geo_info);
-  // All volumes are deleted in ~G4PhysicalVolumeStore()
-  G4VPhysicalVolume* m_world = geo_info->world();
+  const bool perDetector = !m_detectorCacheFiles.empty();
+  bool useCache = (!m_cacheFile.empty() || perDetector) && isCacheable();
+  G4VPhysicalVolume* m_world = nullptr;
+  if (useCache && perDetector) {
+    m_world = convertPerDetector();
+  } else if (useCache && std::ifstream(m_cacheFile).good()) {
+    dd4hep::printout(dd4hep::INFO, "GeoConstruction", "Reading Geant4 geometry from cache %s", m_cacheFile.c_str());
+    m_world = readCache();
+    if (m_world == nullptr) {
+      dd4hep::printout(dd4hep::WARNING, "GeoConstruction", "Cache %s does not match the geometry, converting it",
+                       m_cacheFile.c_str());
+      useCache = false;
+    }
+  }
+  if (m_world == nullptr) {
+    dd4hep::DetElement world = m_lcdd.world();
+    dd4hep::sim::Geant4Converter conv(m_lcdd, dd4hep::DEBUG);
+    dd4hep::sim::Geant4GeometryInfo* geo_info = conv.create(world).detach();
+    g4map.attach(geo_info);
+    // All volumes are deleted in ~G4PhysicalVolumeStore()
+    m_world = geo_info->world();
+    if (useCache) {
+      writeCache(m_cacheFile, m_world->GetLogicalVolume());
+    }
+  }
+  if (m_solidOptimisation.enabled) {
+    optimiseSolids(m_world, m_solidOptimisation);
+  }
   m_lcdd.apply("DD4hepVolumeManager", 0, 0);
   // Create Geant4 volume manager
   g4map.volumeManager();
   return m_world;
 }
+
+void GeoConstruction::releaseGeometry() {
+  dd4hep::sim::Geant4GeometryInfo* p = dd4hep::sim::Geant4Mapping::instance().ptr();
+  if (p != nullptr) {
+    // Geant4 objects are owned by their stores, only the maps are cleared; g4Paths are used by the sensitive detectors
+    p->g4Elements.clear();
+    p->g4Materials.clear();
+    p->g4Solids.clear();
+    p->g4Volumes.clear();
+    p->g4Placements.clear();
+    p->g4AssemblyVolumes.clear();
+    p->sensitives.clear();
+    p->regions.clear();
+    p->limits.clear();
+  }
+  // TGeo volumes stay, as they are referenced by the DD4hep detector elements
+  TGeoManager& manager = m_lcdd.manager();
+  manager.ClearNavigators();
+  TIter next(manager.GetListOfVolumes());
+  while (auto volume = dynamic_cast<TGeoVolume*>(next())) {
+    delete volume->GetVoxels();
+    volume->SetVoxelFinder(nullptr);
+  }
+  dd4hep::printout(dd4hep::INFO, "GeoConstruction", "Released the geometry used by the conversion to Geant4");
+}
+
+bool GeoConstruction::isCacheable() const {
+  if (!m_lcdd.regions().empty() || !m_lcdd.limits().empty()) {
+    dd4hep::printout(dd4hep::INFO, "GeoConstruction", "Geometry with regions or limits is not cached");
+    return false;
+  }
+  TIter next(m_lcdd.manager().GetListOfVolumes());
+  while (auto volume = dynamic_cast<TGeoVolume*>(next())) {
+    if (volume->IsAssembly()) {
+      dd4hep::printout(dd4hep::INFO, "GeoConstruction", "Geometry with assemblies is not cached");
+      return false;
+    }
+  }
+  return true;
+}
+
+G4VPhysicalVolume* GeoConstruction::readCache() {
+  G4GDMLParser parser;
+  // names are stripped of the pointer suffixes added when writing
+  parser.Read(m_cacheFile, false);
+  G4VPhysicalVolume* g4world = parser.GetWorldVolume();
+  const TGeoNode* world = m_lcdd.world().placement().ptr();
+  auto geo_info = new dd4hep::sim::Geant4GeometryInfo();
+  geo_info->g4Placements[world] = g4world;
+  if (!mapVolumes(world->GetVolume(), g4world->GetLogicalVolume(), *geo_info)) {
+    delete geo_info;
+    return nullptr;
+  }
+  geo_info->setWorld(world);
+  dd4hep::sim::Geant4Mapping::instance().attach(geo_info);
+  return g4world;
+}
+
+void GeoConstruction::writeCache(const std::string& aCacheFile, const G4LogicalVolume* aVolume) const {
+  // written aside and moved, so that concurrent jobs never read a partial file
+  std::string tmpFile = aCacheFile + ".tmp" + std::to_string(::getpid());
+  G4GDMLParser parser;
+  parser.Write(tmpFile, aVolume, true);
+  if (std::rename(tmpFile.c_str(), aCacheFile.c_str()) != 0) {
+    dd4hep::printout(dd4hep::WARNING, "GeoConstruction", "Unable to write the geometry cache %s", aCacheFile.c_str());
+    std::remove(tmpFile.c_str());
+  } else {
+    dd4hep::printout(dd4hep::INFO, "GeoConstruction", "Geant4 geometry written to cache %s", aCacheFile.c_str());
+  }
+}
+
+G4VPhysicalVolume* GeoConstruction::convertPerDetector() {
+  dd4hep::DetElement world = m_lcdd.world();
+  TGeoVolume* worldVolume = world.placement().ptr()->GetVolume();
+  // sub-detectors read from their cache with their top volume, and sub-detectors converted with their cache file
+  std::vector<std::pair<TGeoNode*, G4LogicalVolume*>> cached;
+  std::vector<std::pair<const TGeoNode*, std::string>> converted;
+  for (const auto& child : world.children()) {
+    auto cacheFile = m_detectorCacheFiles.find(child.first);
+    TGeoNode* node = child.second.placement().ptr();
+    // reflected placements are left to the converter
+    if (cacheFile == m_detectorCacheFiles.end() || node == nullptr || node->GetMotherVolume() != worldVolume ||
+        node->GetMatrix()->IsReflection()) {
+      continue;
+    }
+    G4LogicalVolume* volume = nullptr;
+    if (std::ifstream(cacheFile->second).good()) {
+      volume = readDetectorCache(cacheFile->second, node);
+      if (volume == nullptr) {
+        dd4hep::printout(dd4hep::WARNING, "GeoConstruction", "Cache %s does not match %s, converting it",
+                         cacheFile->second.c_str(), child.first.c_str());
+      }
+    }
+    if (volume != nullptr) {
+      cached.emplace_back(node, volume);
+    } else {
+      converted.emplace_back(node, cacheFile->second);
+    }
+  }
+  // the placements of the cached sub-detectors are removed from the world while the rest is converted, and restored
+  // in their original order
+  std::vector<TGeoNode*> daughters;
+  for (int iDaughter = 0; iDaughter < worldVolume->GetNdaughters(); ++iDaughter) {
+    daughters.push_back(worldVolume->GetNode(iDaughter));
+  }
+  for (const auto& detector : cached) {
+    worldVolume->RemoveNode(detector.first);
+  }
+  dd4hep::sim::Geant4Converter conv(m_lcdd, dd4hep::DEBUG);
+  dd4hep::sim::Geant4GeometryInfo* geo_info = conv.create(world).detach();
+  if (!cached.empty()) {
+    TObjArray* nodes = worldVolume->GetNodes();
+    nodes->Clear();
+    for (TGeoNode* daughter : daughters) {
+      nodes->Add(daughter);
+    }
+    worldVolume->Voxelize("");
+  }
+  // All volumes are deleted in ~G4PhysicalVolumeStore()
+  G4VPhysicalVolume* g4world = geo_info->world();
+  for (const auto& detector : cached) {
+    const TGeoMatrix* matrix = detector.first->GetMatrix();
+    const double* translation = matrix->GetTranslation();
+    G4Transform3D transform(CLHEP::HepRotation(CLHEP::HepRep3x3(matrix->GetRotationMatrix())),
+                            G4ThreeVector(translation[0], translation[1], translation[2]) * (CLHEP::mm / dd4hep::mm));
+    auto placement = new G4PVPlacement(transform, detector.second, detector.first->GetName(),
+                                       g4world->GetLogicalVolume(), false, detector.first->GetNumber());
+    geo_info->g4Placements[detector.first] = placement;
+    mapVolumes(detector.first->GetVolume(), detector.second, *geo_info);
+  }
+  for (const auto& detector : converted) {
+    auto placement = geo_info->g4Placements.find(detector.first);
+    if (placement != geo_info->g4Placements.end()) {
+      writeCache(detector.second, placement->second->GetLogicalVolume());
+    }
+  }
+  dd4hep::sim::Geant4Mapping::instance().attach(geo_info);
+  dd4hep::printout(dd4hep::INFO, "GeoConstruction", "%zu sub-detectors read from their cache, %zu converted",
+                   cached.size(), converted.size());
+  return g4world;
+}
+
+G4LogicalVolume* GeoConstruction::readDetectorCache(const std::string& aCacheFile, const TGeoNode* aPlacement) const {
+  G4GDMLParser parser;
+  // the names are stripped only in the volumes of this sub-detector, those of the rest of the geometry may be the same
+  parser.SetStripFlag(false);
+  parser.Read(aCacheFile, false);
+  G4VPhysicalVolume* top = parser.GetWorldVolume();
+  G4LogicalVolume* volume = top->GetLogicalVolume();
+  // the sub-detector is placed in the world by the caller
+  delete top;
+  std::vector<G4LogicalVolume*> toVisit{volume};
+  std::set<G4LogicalVolume*> visited;
+  while (!toVisit.empty()) {
+    G4LogicalVolume* current = toVisit.back();
+    toVisit.pop_back();
+    if (!visited.insert(current).second) continue;
+    current->SetName(stripName(current->GetName()));
+    current->GetSolid()->SetName(stripName(current->GetSolid()->GetName()));
+    // materials of the same name are shared with the rest of the geometry, so that their physics tables are built once
+    G4Material* material = current->GetMaterial();
+    const std::string materialName = stripName(material->GetName());
+    if (materialName != material->GetName()) {
+      G4Material* existing = G4Material::GetMaterial(materialName, false);
+      if (existing != nullptr) {
+        current->SetMaterial(existing);
+      } else {
+        material->SetName(materialName);
+      }
+    }
+    for (size_t iDaughter = 0; iDaughter < current->GetNoDaughters(); ++iDaughter) {
+      G4VPhysicalVolume* daughter = current->GetDaughter(iDaughter);
+      daughter->SetName(stripName(daughter->GetName()));
+      toVisit.push_back(daughter->GetLogicalVolume());
+    }
+  }
+  // checked against the DD4hep geometry, the mapping is filled once the sub-detector is placed
+  dd4hep::sim::Geant4GeometryInfo check;
+  if (!mapVolumes(aPlacement->GetVolume(), volume, check)) {
+    return nullptr;
+  }
+  dd4hep::printout(dd4hep::INFO, "GeoConstruction", "Geant4 geometry of %s read from cache %s", aPlacement->GetName(),
+                   aCacheFile.c_str());
+  return volume;
+}
 }
@@ -1,12 +1,22 @@
 #ifndef DETDESSERVICES_GEOCONSTRUCTION_H
 #define DETDESSERVICES_GEOCONSTRUCTION_H
 
+// FCCSW
+#include "SolidOptimisation.h"
+
 // DD4hep
 #include "DDG4/Geant4GeometryInfo.h"
 
 // Geant4
 #include "G4VUserDetectorConstruction.hh"
 
+// STL
+#include <map>
+#include <mutex>
+#include <string>
+
+class G4LogicalVolume;
+class TGeoNode;
 namespace dd4hep {
 class Detector;
 }
@@ -15,6 +25,19 @@ class Detector;
  *  Class to create Geant4 detector geometry from TGeo representation
  *  On demand (ie. when calling "Construct") the DD4hep geometry is converted
  *  to Geant4 with all volumes, assemblies, shapes, materials etc.
+ *  If a cache file is given, the converted geometry is read from it (GDML) if it exists, and the mapping between
+ *  DD4hep and Geant4 volumes is rebuilt from the volume trees, which need the same names, daughters, materials (name
+ *  and density) and dimensions of the solids. Otherwise the geometry is converted and written to the cache file, for
+ *  the next jobs. Geometries with assemblies, regions or limits are always converted.
+ *  If cache files are given per sub-detector (placements in the world) instead, the sub-detectors whose cache exists
+ *  are read from it and placed in the world, and only the others (with the rest of the world) are converted, and
+ *  written to their cache files.
+ *  Once the sensitive detectors of all threads are constructed, the memory used only by the conversion may be
+ *  released (releaseGeometry), after which the geometry cannot be converted or constructed again.
+ *  The sensitive detectors may be created with another type than that of the compact files (e.g. the buffered
+ *  sensitive detectors BufferedCalorimeterSD and BufferedTrackerSD).
+ *  The converted solids of selected sub-detectors may be replaced by implementations faster to navigate
+ *  (see SolidOptimisation), after the cache is written, so the cache always holds the plain conversion.
  *
  *  @author Markus Frank
  *  @author Anna Zaborowska
@@ -24,7 +47,14 @@ namespace det {
 class GeoConstruction : public G4VUserDetectorConstruction {
 public:
   /// Constructor
-  GeoConstruction(dd4hep::Detector& lcdd);
+  /// @param[in] aCacheFile GDML file caching the converted geometry (no caching if empty)
+  /// @param[in] aSensitiveTypes types of the sensitive detectors created instead of the types of the compact files
+  /// @param[in] aSolidOptimisation replacement of the solids by implementations faster to navigate
+  /// @param[in] aDetectorCacheFiles GDML files caching the converted sub-detectors, by name (instead of aCacheFile)
+  GeoConstruction(dd4hep::Detector& lcdd, const std::string& aCacheFile = "",
+                  const std::map<std::string, std::string>& aSensitiveTypes = {},
+                  const SolidOptimisation& aSolidOptimisation = SolidOptimisation(),
+                  const std::map<std::string, std::string>& aDetectorCacheFiles = {});
   /// Default destructor
   virtual ~GeoConstruction();
   /// Geometry construction callback: Invoke the conversion to Geant4
@@ -32,10 +62,43 @@ public:
   virtual G4VPhysicalVolume* Construct() final;
   /// Construct SD
   virtual void ConstructSDandField() final;
+  /// Release the conversion maps (the Geant4 volume manager is kept) and the navigation structures of TGeo
+  void releaseGeometry();
 
 private:
+  /// Check if the geometry may be cached: all its features are stored in GDML, and mapped back to DD4hep
+  bool isCacheable() const;
+  /// Read the geometry from the cache file, and fill the mapping between DD4hep and Geant4
+  /// @return world volume (nullptr if the cache does not match the DD4hep geometry)
+  G4VPhysicalVolume* readCache();
+  /// Write the converted geometry to a cache file
+  /// @param[in] aCacheFile GDML file
+  /// @param[in] aVolume top volume of the geometry written (world or sub-detector)
+  void writeCache(const std::string& aCacheFile, const G4LogicalVolume* aVolume) const;
+  /// Convert the geometry with the sub-detectors whose cache exists read from it, and fill the mapping
+  /// @return world volume
+  G4VPhysicalVolume* convertPerDetector();
+  /// Read a sub-detector from its cache file
+  /// @param[in] aCacheFile GDML file
+  /// @param[in] aPlacement placement of the sub-detector in the DD4hep world
+  /// @return top volume of the sub-detector (nullptr if the cache does not match the DD4hep geometry)
+  G4LogicalVolume* readDetectorCache(const std::string& aCacheFile, const TGeoNode* aPlacement) const;
+  /// Create the sensitive detector with the factory of its type, resolved once per type for all threads
+  G4VSensitiveDetector* createSensitiveDetector(const std::string& aType, const std::string& aName);
   /// Reference to geometry object
   dd4hep::Detector& m_lcdd;
+  /// GDML file caching the converted geometry
+  std::string m_cacheFile;
+  /// GDML files caching the converted sub-detectors, by name
+  std::map<std::string, std::string> m_detectorCacheFiles;
+  /// Types of the sensitive detectors created, by type in the compact files
+  std::map<std::string, std::string> m_sensitiveTypes;
+  /// Replacement of the solids
+  SolidOptimisation m_solidOptimisation;
+  /// Names of the factories by type of the sensitive detectors
+  std::map<std::string, std::string> m_sdFactories;
+  /// Sensitive detectors are constructed by each worker thread
+  std::mutex m_sdFactoriesMutex;
 };
 }
 #endif /* DETDESSERVICES_GEOCONSTRUCTION_H */
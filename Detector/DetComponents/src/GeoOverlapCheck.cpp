@@ -0,0 +1,273 @@
+#include "GeoOverlapCheck.h"
+
+#include "G4AffineTransform.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Navigator.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4TransportationManager.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4VUserDetectorConstruction.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <set>
+#include <thread>
+
+namespace {
+/// Placement of a daughter, with its bounding box in the frame of the mother
+struct Placement {
+  G4VPhysicalVolume* volume;
+  G4AffineTransform transform;
+  G4ThreeVector min;
+  G4ThreeVector max;
+};
+
+/// Daughters of a mother logical volume
+struct Mother {
+  G4LogicalVolume* volume;
+  std::vector<Placement> placements;
+  /// Indices of the placements that are checked
+  std::vector<size_t> checked;
+};
+
+/// Checked daughters of a mother (checked[first] to checked[last - 1])
+struct Task {
+  size_t mother;
+  size_t first;
+  size_t last;
+};
+
+/// Overlap found on the surface of a daughter, with the mother (protrusion) or a sister
+struct Overlap {
+  std::string mother;
+  std::string volume;
+  std::string other;
+  bool protrusion;
+  double depth;
+  unsigned points;
+};
+
+/// Placement of the daughter with its bounding box in the frame of the mother
+Placement placement(G4VPhysicalVolume* aVolume) {
+  Placement result{aVolume, G4AffineTransform(aVolume->GetRotation(), aVolume->GetTranslation()), {}, {}};
+  G4ThreeVector pMin, pMax;
+  aVolume->GetLogicalVolume()->GetSolid()->BoundingLimits(pMin, pMax);
+  const double big = std::numeric_limits<double>::max();
+  result.min.set(big, big, big);
+  result.max.set(-big, -big, -big);
+  for (int iCorner = 0; iCorner < 8; ++iCorner) {
+    const G4ThreeVector corner = result.transform.TransformPoint(G4ThreeVector(
+        iCorner & 1 ? pMax.x() : pMin.x(), iCorner & 2 ? pMax.y() : pMin.y(), iCorner & 4 ? pMax.z() : pMin.z()));
+    result.min.set(std::min(result.min.x(), corner.x()), std::min(result.min.y(), corner.y()),
+                   std::min(result.min.z(), corner.z()));
+    result.max.set(std::max(result.max.x(), corner.x()), std::max(result.max.y(), corner.y()),
+                   std::max(result.max.z(), corner.z()));
+  }
+  return result;
+}
+
+/// Check if the point is within the bounding box
+bool inBox(const Placement& aPlacement, const G4ThreeVector& aPoint) {
+  return aPoint.x() >= aPlacement.min.x() && aPoint.x() <= aPlacement.max.x() && aPoint.y() >= aPlacement.min.y() &&
+         aPoint.y() <= aPlacement.max.y() && aPoint.z() >= aPlacement.min.z() && aPoint.z() <= aPlacement.max.z();
+}
+
+/// Check if the bounding boxes intersect
+bool boxesIntersect(const Placement& aFirst, const Placement& aSecond) {
+  return aFirst.min.x() <= aSecond.max.x() && aSecond.min.x() <= aFirst.max.x() &&
+         aFirst.min.y() <= aSecond.max.y() && aSecond.min.y() <= aFirst.max.y() &&
+         aFirst.min.z() <= aSecond.max.z() && aSecond.min.z() <= aFirst.max.z();
+}
+
+/** Check the overlaps of the surface of a daughter with its mother and its sisters.
+ *  @param[out] aOverlaps overlaps found (one per mother or sister, with the largest depth)
+ */
+void checkDaughter(const Mother& aMother, size_t aDaughter, unsigned aResolution, double aTolerance,
+                   std::vector<Overlap>& aOverlaps) {
+  const Placement& daughter = aMother.placements[aDaughter];
+  const G4VSolid& solid = *daughter.volume->GetLogicalVolume()->GetSolid();
+  const G4VSolid& motherSolid = *aMother.volume->GetSolid();
+  std::vector<size_t> sisters;
+  for (size_t iSister = 0; iSister < aMother.placements.size(); ++iSister) {
+    if (iSister != aDaughter && boxesIntersect(daughter, aMother.placements[iSister])) sisters.push_back(iSister);
+  }
+  // depth and number of points per sister (the mother is the number of placements)
+  std::map<size_t, std::pair<double, unsigned>> found;
+  for (unsigned iPoint = 0; iPoint < aResolution; ++iPoint) {
+    const G4ThreeVector point = daughter.transform.TransformPoint(solid.GetPointOnSurface());
+    if (motherSolid.Inside(point) == kOutside) {
+      const double depth = motherSolid.DistanceToIn(point);
+      if (depth > aTolerance) {
+        auto& overlap = found[aMother.placements.size()];
+        overlap.first = std::max(overlap.first, depth);
+        ++overlap.second;
+      }
+    }
+    for (size_t iSister : sisters) {
+      const Placement& sister = aMother.placements[iSister];
+      if (!inBox(sister, point)) continue;
+      const G4ThreeVector sisterPoint = sister.transform.InverseTransformPoint(point);
+      const G4VSolid& sisterSolid = *sister.volume->GetLogicalVolume()->GetSolid();
+      if (sisterSolid.Inside(sisterPoint) != kInside) continue;
+      const double depth = sisterSolid.DistanceToOut(sisterPoint);
+      if (depth > aTolerance) {
+        auto& overlap = found[iSister];
+        overlap.first = std::max(overlap.first, depth);
+        ++overlap.second;
+      }
+    }
+  }
+  for (const auto& overlap : found) {
+    const bool protrusion = overlap.first == aMother.placements.size();
+    aOverlaps.push_back({aMother.volume->GetName(), daughter.volume->GetName(),
+                         protrusion ? aMother.volume->GetName() : aMother.placements[overlap.first].volume->GetName(),
+                         protrusion, overlap.second.first, overlap.second.second});
+  }
+}
+
+/// Collect the logical volumes of the tree
+void collectVolumes(G4LogicalVolume* aVolume, std::set<G4LogicalVolume*>& aVolumes) {
+  if (!aVolumes.insert(aVolume).second) return;
+  for (size_t iDaughter = 0; iDaughter < aVolume->GetNoDaughters(); ++iDaughter) {
+    collectVolumes(aVolume->GetDaughter(iDaughter)->GetLogicalVolume(), aVolumes);
+  }
+}
+}
+
+DECLARE_COMPONENT(GeoOverlapCheck)
+
+GeoOverlapCheck::GeoOverlapCheck(const std::string& name, ISvcLocator* svcLoc)
+    : Service(name, svcLoc), m_geoSvc("GeoSvc", name) {}
+
+StatusCode GeoOverlapCheck::initialize() {
+  if (Service::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (!m_geoSvc) {
+    error() << "Unable to find Geometry Service." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_resolution == 0 || m_chunkSize == 0) {
+    error() << "At least one point per volume and one volume per task need to be checked." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  // the geometry constructed by SimG4Svc, or converted here
+  G4VPhysicalVolume* world =
+      G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
+  if (world == nullptr) {
+    G4VUserDetectorConstruction* construction = m_geoSvc->getGeant4Geo();
+    if (construction == nullptr || (world = construction->Construct()) == nullptr) {
+      error() << "Unable to construct the Geant4 geometry." << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  const auto start = std::chrono::steady_clock::now();
+
+  // logical volumes of the selected sub-detectors, and the world for the placements of the sub-detectors
+  G4LogicalVolume* worldVolume = world->GetLogicalVolume();
+  std::set<G4LogicalVolume*> volumes;
+  volumes.insert(worldVolume);
+  std::set<G4VPhysicalVolume*> selected;
+  for (size_t iDaughter = 0; iDaughter < worldVolume->GetNoDaughters(); ++iDaughter) {
+    G4VPhysicalVolume* daughter = worldVolume->GetDaughter(iDaughter);
+    bool isSelected = m_detectors.empty();
+    for (const auto& name : m_detectors) {
+      isSelected |= daughter->GetName().find(name) != std::string::npos;
+    }
+    if (isSelected) {
+      selected.insert(daughter);
+      collectVolumes(daughter->GetLogicalVolume(), volumes);
+    }
+  }
+  // placements of the mothers and tasks, split so that the mothers of many daughters are shared by the threads
+  std::vector<Mother> mothers;
+  std::vector<Task> tasks;
+  std::set<G4VSolid*> solids;
+  unsigned numSkipped = 0;
+  for (G4LogicalVolume* volume : volumes) {
+    if (volume->GetNoDaughters() == 0) continue;
+    Mother mother{volume, {}, {}};
+    for (size_t iDaughter = 0; iDaughter < volume->GetNoDaughters(); ++iDaughter) {
+      G4VPhysicalVolume* daughter = volume->GetDaughter(iDaughter);
+      if (daughter->IsReplicated()) {
+        ++numSkipped;
+        continue;
+      }
+      if (volume != worldVolume || selected.count(daughter) > 0) {
+        mother.checked.push_back(mother.placements.size());
+        solids.insert(daughter->GetLogicalVolume()->GetSolid());
+      }
+      mother.placements.push_back(placement(daughter));
+    }
+    for (size_t first = 0; first < mother.checked.size(); first += m_chunkSize) {
+      tasks.push_back({mothers.size(), first, std::min<size_t>(first + m_chunkSize, mother.checked.size())});
+    }
+    mothers.push_back(std::move(mother));
+  }
+  // the solids compute their surface (e.g. its triangulation) at the first point, not by several threads at once
+  for (G4VSolid* solid : solids) {
+    solid->GetSurfaceArea();
+    solid->GetPointOnSurface();
+  }
+
+  unsigned numThreads = m_numThreads > 0 ? m_numThreads.value() : std::max(1u, std::thread::hardware_concurrency());
+  numThreads = std::max<size_t>(1, std::min<size_t>(numThreads, tasks.size()));
+  info() << "Checking the overlaps of " << solids.size() << " solids in " << mothers.size() << " mother volumes ("
+         << tasks.size() << " tasks) with " << numThreads << " threads" << endmsg;
+  std::vector<std::vector<Overlap>> overlaps(tasks.size());
+  std::atomic<size_t> nextTask{0};
+  auto check = [&]() {
+    for (size_t iTask = nextTask++; iTask < tasks.size(); iTask = nextTask++) {
+      const Task& task = tasks[iTask];
+      const Mother& mother = mothers[task.mother];
+      for (size_t iChecked = task.first; iChecked < task.last; ++iChecked) {
+        checkDaughter(mother, mother.checked[iChecked], m_resolution, m_tolerance, overlaps[iTask]);
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (unsigned iThread = 1; iThread < numThreads; ++iThread) {
+    threads.emplace_back(check);
+  }
+  check();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // report in the order of the tasks, independent of the number of threads
+  std::ofstream report;
+  if (!m_reportFile.empty()) {
+    report.open(m_reportFile);
+    report << "mother,volume,other,type,depth_mm,points\n";
+  }
+  unsigned numOverlaps = 0;
+  unsigned numProtrusions = 0;
+  for (const auto& taskOverlaps : overlaps) {
+    for (const auto& overlap : taskOverlaps) {
+      ++(overlap.protrusion ? numProtrusions : numOverlaps);
+      warning() << (overlap.protrusion ? "Protrusion of " : "Overlap of ") << overlap.volume << " with "
+                << overlap.other << " (in " << overlap.mother << "): depth " << overlap.depth / CLHEP::mm << " mm at "
+                << overlap.points << " of " << m_resolution.value() << " points" << endmsg;
+      if (report.is_open()) {
+        report << overlap.mother << "," << overlap.volume << "," << overlap.other << ","
+               << (overlap.protrusion ? "protrusion" : "overlap") << "," << overlap.depth / CLHEP::mm << ","
+               << overlap.points << "\n";
+      }
+    }
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  info() << "Found " << numOverlaps << " overlaps and " << numProtrusions << " protrusions in " << seconds << " s ("
+         << numSkipped << " replicated placements not checked)" << endmsg;
+  if (m_failOnOverlaps && numOverlaps + numProtrusions > 0) {
+    error() << "The geometry has overlaps." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode GeoOverlapCheck::finalize() { return Service::finalize(); }
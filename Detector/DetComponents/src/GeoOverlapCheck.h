@@ -0,0 +1,59 @@
+#ifndef DETCOMPONENTS_GEOOVERLAPCHECK_H
+#define DETCOMPONENTS_GEOOVERLAPCHECK_H
+
+#include "k4Interface/IGeoSvc.h"
+
+#include "GaudiKernel/Service.h"
+#include "GaudiKernel/ServiceHandle.h"
+
+#include <string>
+#include <vector>
+
+/** @class GeoOverlapCheck Detector/DetComponents/src/GeoOverlapCheck.h GeoOverlapCheck.h
+ *
+ *  Service that checks the overlaps of the Geant4 geometry on initialize, in parallel (\b'numThreads').
+ *  The Geant4 geometry is taken from Geant4 if it is already constructed, otherwise it is converted with GeoSvc
+ *  (the job does not need SimG4Svc). Each logical volume is checked once, whatever the number of its placements:
+ *  \b'resolution' random points on the surface of each of its daughters are tested against the mother (the daughter
+ *  protrudes if a point is outside of it) and against the sisters whose bounding boxes intersect (they overlap if a
+ *  point is inside one of them), as G4PVPlacement::CheckOverlaps does, with the depth reported above
+ *  \b'tolerance'. The daughters of the mothers are split into chunks, shared by the threads.
+ *  Replicas and parameterised placements are not checked. Only the sub-detectors \b'detectors' (placements in the
+ *  world whose names contain one of the names) are checked if given.
+ *  The overlaps are written to the CSV file \b'reportFile' (if set) and summarised in the output; if
+ *  \b'failOnOverlaps' is set, the initialisation fails if any overlap is found.
+ */
+
+class GeoOverlapCheck : public Service {
+public:
+  explicit GeoOverlapCheck(const std::string& name, ISvcLocator* svcLoc);
+
+  virtual StatusCode initialize();
+  virtual StatusCode finalize();
+  virtual ~GeoOverlapCheck(){};
+
+private:
+  /// Handle to the geometry service from which the detector is retrieved
+  ServiceHandle<IGeoSvc> m_geoSvc;
+  /// Number of threads checking the volumes (all available cores if 0)
+  Gaudi::Property<unsigned> m_numThreads{this, "numThreads", 0,
+                                         "number of threads checking the volumes (all available cores if 0)"};
+  /// Number of points on the surface of each daughter
+  Gaudi::Property<unsigned> m_resolution{this, "resolution", 1000,
+                                         "number of points on the surface of each daughter volume"};
+  /// Depth below which the overlaps are not reported
+  Gaudi::Property<double> m_tolerance{this, "tolerance", 0, "depth below which the overlaps are not reported"};
+  /// Names of the sub-detectors (placements in the world) checked (all if empty)
+  Gaudi::Property<std::vector<std::string>> m_detectors{
+      this, "detectors", {}, "names of the sub-detectors (placements in the world) checked (all if empty)"};
+  /// Maximum number of the daughters of a mother checked by one task
+  Gaudi::Property<unsigned> m_chunkSize{this, "chunkSize", 64,
+                                        "maximum number of the daughters of a mother checked by one task"};
+  /// Name of the CSV file of the overlaps (not written if empty)
+  Gaudi::Property<std::string> m_reportFile{this, "reportFile", "", "CSV file of the overlaps (not written if empty)"};
+  /// Flag whether the initialisation fails if overlaps are found
+  Gaudi::Property<bool> m_failOnOverlaps{this, "failOnOverlaps", false,
+                                         "Set to true for the initialisation to fail if overlaps are found"};
+};
+
+#endif /* DETCOMPONENTS_GEOOVERLAPCHECK_H */
@@ -3,11 +3,198 @@
 #include "GaudiKernel/Service.h"
 #include "GeoConstruction.h"
 #include "TGeoManager.h"
+#include "TGeoNode.h"
+#include "TGeoVolume.h"
 
 #include "DD4hep/Printout.h"
 
+#include "G4Version.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <vector>
+
 using namespace Gaudi;
 
+namespace {
+/// Add the data to the FNV-1a hash
+void addToHash(std::uint64_t& aHash, const std::string& aData) {
+  for (unsigned char c : aData) {
+    aHash = (aHash ^ c) * 1099511628211ull;
+  }
+}
+/// Read the content of an XML-file of the detector description, @returns false if it cannot be read
+bool readXmlFile(const std::string& aFileName, std::string& aContent) {
+  std::string path = aFileName.compare(0, 5, "file:") == 0 ? aFileName.substr(5) : aFileName;
+  std::ifstream file(path);
+  if (!file) return false;
+  std::stringstream content;
+  content << file.rdbuf();
+  aContent = content.str();
+  return true;
+}
+/// Text without the XML comments
+std::string stripXmlComments(const std::string& aContent) {
+  std::string stripped;
+  size_t position = 0;
+  while (true) {
+    size_t start = aContent.find("<!--", position);
+    stripped.append(aContent, position, start == std::string::npos ? std::string::npos : start - position);
+    if (start == std::string::npos) break;
+    size_t end = aContent.find("-->", start + 4);
+    if (end == std::string::npos) break;
+    position = end + 3;
+  }
+  return stripped;
+}
+/// Value of the attribute in the opening tag of an element (empty if not set)
+std::string xmlAttribute(const std::string& aTag, const std::string& aName) {
+  size_t position = 0;
+  while ((position = aTag.find(aName, position)) != std::string::npos) {
+    const bool delimited = position > 0 && std::isspace(static_cast<unsigned char>(aTag[position - 1]));
+    size_t next = aTag.find_first_not_of(" \t\r\n", position + aName.size());
+    position += aName.size();
+    if (!delimited || next == std::string::npos || aTag[next] != '=') continue;
+    size_t quote = aTag.find_first_not_of(" \t\r\n", next + 1);
+    if (quote == std::string::npos || (aTag[quote] != '"' && aTag[quote] != '\'')) continue;
+    size_t end = aTag.find(aTag[quote], quote + 1);
+    if (end == std::string::npos) return "";
+    return aTag.substr(quote + 1, end - quote - 1);
+  }
+  return "";
+}
+/// Position of the next opening tag of the element from the position (npos if none)
+size_t findXmlTag(const std::string& aContent, const std::string& aName, size_t aPosition) {
+  for (size_t start = aContent.find("<" + aName, aPosition); start != std::string::npos;
+       start = aContent.find("<" + aName, start + 1)) {
+    const size_t after = start + 1 + aName.size();
+    if (after < aContent.size() && (std::isspace(static_cast<unsigned char>(aContent[after])) ||
+                                    aContent[after] == '/' || aContent[after] == '>')) {
+      return start;
+    }
+  }
+  return std::string::npos;
+}
+/// Opening tags of the elements with one of the names, in the order of the text
+std::vector<std::string> xmlTags(const std::string& aContent, const std::vector<std::string>& aNames) {
+  std::vector<std::pair<size_t, std::string>> tags;
+  for (const auto& name : aNames) {
+    for (size_t start = findXmlTag(aContent, name, 0); start != std::string::npos;
+         start = findXmlTag(aContent, name, start + 1)) {
+      size_t end = aContent.find('>', start);
+      if (end == std::string::npos) break;
+      tags.emplace_back(start, aContent.substr(start, end - start + 1));
+    }
+  }
+  std::sort(tags.begin(), tags.end());
+  std::vector<std::string> sorted;
+  for (const auto& tag : tags) sorted.push_back(tag.second);
+  return sorted;
+}
+/** Split the text of an XML-file into the detector elements and the rest, which is shared by all sub-detectors.
+ *  @param[in] aContent text of the file (without comments)
+ *  @param[out] aDetectors text of the detector elements, by name of the sub-detector
+ *  @return text outside of the detector elements
+ */
+std::string splitDetectors(const std::string& aContent, std::map<std::string, std::string>& aDetectors) {
+  std::string rest;
+  size_t position = 0;
+  size_t start;
+  while ((start = findXmlTag(aContent, "detector", position)) != std::string::npos) {
+    size_t tagEnd = aContent.find('>', start);
+    if (tagEnd == std::string::npos) break;
+    const std::string tag = aContent.substr(start, tagEnd - start + 1);
+    size_t end = tagEnd + 1;
+    // nested detector elements belong to the enclosing one
+    int depth = aContent[tagEnd - 1] == '/' ? 0 : 1;
+    while (depth > 0) {
+      size_t close = aContent.find("</detector>", end);
+      size_t open = findXmlTag(aContent, "detector", end);
+      if (close == std::string::npos) {
+        end = aContent.size();
+        break;
+      }
+      if (open < close) {
+        size_t openEnd = aContent.find('>', open);
+        if (openEnd == std::string::npos) {
+          end = aContent.size();
+          break;
+        }
+        if (aContent[openEnd - 1] != '/') ++depth;
+        end = openEnd + 1;
+      } else {
+        --depth;
+        end = close + std::string("</detector>").size();
+      }
+    }
+    rest.append(aContent, position, start - position);
+    aDetectors[xmlAttribute(tag, "name")] = aContent.substr(start, end - start);
+    position = end;
+  }
+  return rest + aContent.substr(position);
+}
+/// Reference with the environment variables (${NAME}) replaced by their values (empty if not set)
+std::string expandVariables(const std::string& aReference) {
+  std::string expanded;
+  size_t position = 0;
+  size_t start;
+  while ((start = aReference.find("${", position)) != std::string::npos) {
+    size_t end = aReference.find('}', start + 2);
+    if (end == std::string::npos) break;
+    expanded.append(aReference, position, start - position);
+    const char* value = std::getenv(aReference.substr(start + 2, end - start - 2).c_str());
+    if (value != nullptr) expanded += value;
+    position = end + 1;
+  }
+  return expanded + aReference.substr(position);
+}
+/// Directory of a file, with its trailing separator (empty for the working directory)
+std::string directoryOf(const std::string& aFileName) {
+  size_t separator = aFileName.rfind('/');
+  return separator == std::string::npos ? "" : aFileName.substr(0, separator + 1);
+}
+/** Read an XML-file of the detector description and, recursively, the files it includes (include, gdmlFile and file
+ *  elements, with references relative to the including file or with environment variables), each file once.
+ *  @param[in] aFileName file to read
+ *  @param[out] aFiles paths and contents (without comments) of the files, in the order in which they are included
+ *  @param[out] aMissing first file that cannot be read
+ *  @return false if a file cannot be read
+ */
+bool readXmlTree(const std::string& aFileName, std::vector<std::pair<std::string, std::string>>& aFiles,
+                 std::string& aMissing) {
+  std::string path = aFileName.compare(0, 5, "file:") == 0 ? aFileName.substr(5) : aFileName;
+  for (const auto& file : aFiles) {
+    if (file.first == path) return true;
+  }
+  std::string content;
+  if (!readXmlFile(path, content)) {
+    aMissing = path;
+    return false;
+  }
+  aFiles.emplace_back(path, stripXmlComments(content));
+  const std::string included = aFiles.back().second;
+  for (const auto& tag : xmlTags(included, {"include", "gdmlFile", "file"})) {
+    std::string ref = expandVariables(xmlAttribute(tag, "ref"));
+    if (ref.empty()) continue;
+    if (ref.compare(0, 5, "file:") == 0) ref = ref.substr(5);
+    if (ref[0] != '/') ref = directoryOf(path) + ref;
+    if (!readXmlTree(ref, aFiles, aMissing)) return false;
+  }
+  return true;
+}
+std::string hashString(std::uint64_t aHash) {
+  std::stringstream hash;
+  hash << std::hex << std::setw(16) << std::setfill('0') << aHash;
+  return hash.str();
+}
+}
+
 DECLARE_COMPONENT(GeoSvc)
 
 GeoSvc::GeoSvc(const std::string& name, ISvcLocator* svc)
@@ -33,10 +220,17 @@ StatusCode GeoSvc::initialize() {
   else
     info() <<  "DD4Hep geometry SUCCESSFULLY built" << endmsg;
 
-  if (buildGeant4Geo().isFailure())
-    error() << "Could not build Geant4 geometry" << endmsg;
-  else
-    info() << "Geant4 geometry SUCCESSFULLY built" << endmsg;
+  // the Geant4 geometry is built when it is first requested (by the simulation), jobs using only the DD4hep
+  // geometry (e.g. material scans) do not pay for it
+  if (m_releaseGeometry) {
+    // fired by the simulation service once the geometry and sensitive detectors of all threads are constructed
+    SmartIF<IIncidentSvc> incidentSvc(service("IncidentSvc"));
+    if (!incidentSvc) {
+      error() << "Unable to locate IncidentSvc, the geometry is not released" << endmsg;
+    } else {
+      incidentSvc->addListener(this, "SimG4GeometryConstructed");
+    }
+  }
   // TODO: return failure
   return StatusCode::SUCCESS;
 }
@@ -53,18 +247,75 @@ StatusCode GeoSvc::buildDD4HepGeo() {
     info() << "loading geometry from file:  '" << filename << "'" << endmsg;
     m_dd4hepgeo->fromCompact(filename);
   }
+  if (selectDetectors().isFailure()) {
+    return StatusCode::FAILURE;
+  }
   m_dd4hepgeo->volumeManager();
   m_dd4hepgeo->apply("DD4hepVolumeManager", 0, 0);
 
   return StatusCode::SUCCESS;
 }
 
+StatusCode GeoSvc::selectDetectors() {
+  if (m_enabledDetectors.empty() && m_disabledDetectors.empty()) {
+    return StatusCode::SUCCESS;
+  }
+  dd4hep::DetElement world = m_dd4hepgeo->world();
+  for (const auto& names : {m_enabledDetectors.value(), m_disabledDetectors.value()}) {
+    for (const auto& name : names) {
+      if (world.children().find(name) == world.children().end()) {
+        error() << "Sub-detector " << name << " not found in the world" << endmsg;
+        return StatusCode::FAILURE;
+      }
+    }
+  }
+  std::vector<std::string> removed;
+  for (const auto& child : world.children()) {
+    const bool enabled = m_enabledDetectors.empty() || std::find(m_enabledDetectors.begin(), m_enabledDetectors.end(),
+                                                                 child.first) != m_enabledDetectors.end();
+    const bool disabled = std::find(m_disabledDetectors.begin(), m_disabledDetectors.end(), child.first) !=
+                          m_disabledDetectors.end();
+    if (enabled && !disabled) continue;
+    // the volumes of the sub-detector are neither in the volume manager nor converted to Geant4
+    TGeoNode* node = child.second.placement().ptr();
+    if (node != nullptr && node->GetMotherVolume() != nullptr) {
+      node->GetMotherVolume()->RemoveNode(node);
+    }
+    removed.push_back(child.first);
+  }
+  for (const auto& name : removed) {
+    info() << "Sub-detector " << name << " removed from the geometry" << endmsg;
+    world.ptr()->children.erase(name);
+  }
+  // navigation in the world needs to take the removed placements into account
+  if (world.volume()->GetNdaughters() > 0) {
+    world.volume()->Voxelize("");
+  }
+  return StatusCode::SUCCESS;
+}
+
 dd4hep::Detector* GeoSvc::lcdd() { return (m_dd4hepgeo); }
 
 dd4hep::DetElement GeoSvc::getDD4HepGeo() { return (lcdd()->world()); }
 
 StatusCode GeoSvc::buildGeant4Geo() {
-  std::shared_ptr<G4VUserDetectorConstruction> detector(new det::GeoConstruction(*lcdd()));
+  det::SolidOptimisation solidOptimisation;
+  solidOptimisation.enabled = m_optimiseSolids;
+  solidOptimisation.detectors = m_optimiseSolidsDetectors;
+  solidOptimisation.minUnionNodes = m_minUnionNodes;
+  solidOptimisation.timingPoints = m_solidTimingPoints;
+  solidOptimisation.timingFile = m_solidTimingFile;
+  std::map<std::string, std::string> cacheFiles;
+  if (m_cachePerDetector) {
+    if (m_cacheDir.value().empty()) {
+      warning() << "No directory of the geometry cache is given, the sub-detectors are not cached" << endmsg;
+    } else {
+      cacheFiles = detectorCacheFiles();
+    }
+  }
+  m_geoConstruction = new det::GeoConstruction(*lcdd(), m_cachePerDetector ? "" : geometryCacheFile(),
+                                               m_sensitiveTypes, solidOptimisation, cacheFiles);
+  std::shared_ptr<G4VUserDetectorConstruction> detector(m_geoConstruction);
   m_geant4geo = detector;
   if (m_geant4geo) {
     return StatusCode::SUCCESS;
@@ -72,5 +323,99 @@ StatusCode GeoSvc::buildGeant4Geo() {
     return StatusCode::FAILURE;
 }
 
-G4VUserDetectorConstruction* GeoSvc::getGeant4Geo() { return (m_geant4geo.get()); }
+std::string GeoSvc::geometryCacheFile() {
+  if (m_cacheDir.value().empty()) return "";
+  const std::string hash = geometryHash();
+  if (hash.empty()) {
+    warning() << "The Geant4 geometry is not cached" << endmsg;
+    return "";
+  }
+  std::string cacheFile = m_cacheDir.value() + "/geometry_" + hash + ".gdml";
+  debug() << "Geant4 geometry cache: " << cacheFile << endmsg;
+  return cacheFile;
+}
+
+std::map<std::string, std::string> GeoSvc::detectorCacheFiles() {
+  std::vector<std::pair<std::string, std::string>> files;
+  std::string missing;
+  for (auto& filename : m_xmlFileNames) {
+    if (!readXmlTree(filename, files, missing)) {
+      warning() << "Unable to read " << missing << ", the sub-detectors are not cached" << endmsg;
+      return {};
+    }
+  }
+  // each sub-detector is hashed with its detector element and all the text outside of the detector elements (e.g.
+  // the materials, the constants and the readouts) of all the included files
+  std::map<std::string, std::string> detectors;
+  std::uint64_t commonHash = 14695981039346656037ull;
+  addToHash(commonHash, std::to_string(G4VERSION_NUMBER));
+  for (const auto& file : files) {
+    addToHash(commonHash, file.first);
+    addToHash(commonHash, "|");
+    addToHash(commonHash, splitDetectors(file.second, detectors));
+  }
+  std::map<std::string, std::string> cacheFiles;
+  for (const auto& child : m_dd4hepgeo->world().children()) {
+    auto detector = detectors.find(child.first);
+    if (detector == detectors.end()) {
+      debug() << "No detector element of " << child.first << " found, it is not cached" << endmsg;
+      continue;
+    }
+    std::uint64_t hash = commonHash;
+    addToHash(hash, child.first);
+    // the plugin constructing the sub-detector
+    addToHash(hash, child.second.type());
+    addToHash(hash, "|");
+    addToHash(hash, detector->second);
+    cacheFiles[child.first] = m_cacheDir.value() + "/geometry_" + child.first + "_" + hashString(hash) + ".gdml";
+    debug() << "Geant4 geometry cache of " << child.first << ": " << cacheFiles[child.first] << endmsg;
+  }
+  return cacheFiles;
+}
+
+std::string GeoSvc::geometryHash() {
+  // FNV-1a hash of the Geant4 version and of the content of the XML-files and of the files they include
+  std::uint64_t hash = 14695981039346656037ull;
+  addToHash(hash, std::to_string(G4VERSION_NUMBER));
+  for (const auto& names : {m_enabledDetectors.value(), m_disabledDetectors.value()}) {
+    for (const auto& name : names) {
+      addToHash(hash, name);
+    }
+    addToHash(hash, "|");
+  }
+  // the files included by the compact files are hashed too, so that a change in any of them is a new geometry
+  std::vector<std::pair<std::string, std::string>> files;
+  std::string missing;
+  for (auto& filename : m_xmlFileNames) {
+    if (!readXmlTree(filename, files, missing)) {
+      warning() << "Unable to read " << missing << ", the geometry has no hash" << endmsg;
+      return "";
+    }
+  }
+  for (const auto& file : files) {
+    addToHash(hash, file.first);
+    addToHash(hash, "|");
+    addToHash(hash, file.second);
+  }
+  return hashString(hash);
+}
+
+G4VUserDetectorConstruction* GeoSvc::getGeant4Geo() {
+  std::lock_guard<std::mutex> lock(m_geant4geoMutex);
+  if (!m_geant4geo) {
+    if (buildGeant4Geo().isFailure()) {
+      error() << "Could not build Geant4 geometry" << endmsg;
+      return nullptr;
+    }
+    info() << "Geant4 geometry SUCCESSFULLY built" << endmsg;
+  }
+  return (m_geant4geo.get());
+}
+
+void GeoSvc::handle(const Incident& aIncident) {
+  if (aIncident.type() == "SimG4GeometryConstructed" && m_geoConstruction != nullptr) {
+    info() << "Releasing the geometry used by the conversion to Geant4" << endmsg;
+    m_geoConstruction->releaseGeometry();
+  }
+}
 
@@ -19,7 +19,15 @@
 #include "G4RunManager.hh"
 #include "G4VUserDetectorConstruction.hh"
 
-class GeoSvc : public extends<Service, IGeoSvc> {
+// STL
+#include <map>
+#include <mutex>
+
+namespace det {
+class GeoConstruction;
+}
+
+class GeoSvc : public extends<Service, IGeoSvc, IIncidentListener> {
 
 public:
   /// Default constructor
@@ -33,12 +41,22 @@ public:
   virtual StatusCode finalize() final;
   /// This function generates the DD4hep geometry
   StatusCode buildDD4HepGeo();
-  /// This function generates the Geant4 geometry
+  /// This function removes the disabled sub-detectors from the world
+  StatusCode selectDetectors();
+  /// This function generates the Geant4 geometry (called when it is first requested)
   StatusCode buildGeant4Geo();
+  /// Release the geometry used only by the conversion, once the sensitive detectors are constructed
+  virtual void handle(const Incident& aIncident) override;
+  /// Name of the geometry cache file, keyed by the content of the XML-files (empty if caching is disabled)
+  std::string geometryCacheFile();
+  /// Names of the geometry cache files by sub-detector, keyed by its detector element, its type and the rest of the XML
+  std::map<std::string, std::string> detectorCacheFiles();
+  /// Hash of the Geant4 version, selected sub-detectors and content of the XML-files (empty if unreadable)
+  std::string geometryHash();
   // receive DD4hep Geometry
   virtual dd4hep::DetElement getDD4HepGeo() override;
   virtual dd4hep::Detector* lcdd() override;
-  // receive Geant4 Geometry
+  // receive Geant4 Geometry, built at the first call
   virtual G4VUserDetectorConstruction* getGeant4Geo() override;
 
 private:
@@ -46,8 +64,47 @@ private:
   dd4hep::Detector* m_dd4hepgeo;
   /// Pointer to the detector construction of DDG4
   std::shared_ptr<G4VUserDetectorConstruction> m_geant4geo;
+  /// Guard of the construction of the Geant4 geometry at the first request
+  std::mutex m_geant4geoMutex;
+  /// Pointer to the detector construction converting the geometry
+  det::GeoConstruction* m_geoConstruction = nullptr;
   /// XML-files with the detector description
   Gaudi::Property<std::vector<std::string>> m_xmlFileNames{this, "detectors", {}, "Detector descriptions XML-files"};
+  /// Names of the sub-detectors to build (all if empty)
+  Gaudi::Property<std::vector<std::string>> m_enabledDetectors{
+      this, "enableDetectors", {}, "Names of the sub-detectors placed in the world (all if empty)"};
+  /// Names of the sub-detectors to remove from the world
+  Gaudi::Property<std::vector<std::string>> m_disabledDetectors{
+      this, "disableDetectors", {}, "Names of the sub-detectors removed from the world"};
+  /// Flag whether the geometry used only by the conversion should be released after the initialisation
+  Gaudi::Property<bool> m_releaseGeometry{
+      this, "releaseGeometry", false,
+      "Release the conversion maps and TGeo navigation structures once the sensitive detectors are constructed"};
+  /// Directory where the converted Geant4 geometry is cached (no caching if empty)
+  Gaudi::Property<std::string> m_cacheDir{this, "geometryCache", "",
+                                          "Directory where the converted Geant4 geometry is cached (GDML)"};
+  /// Flag whether each sub-detector is cached in its own file, converted again only if its description changes
+  Gaudi::Property<bool> m_cachePerDetector{
+      this, "geometryCachePerDetector", false,
+      "Cache the geometry of each sub-detector in its own file, converting only those whose description changed"};
+  /// Types of the sensitive detectors created instead of the types of the compact files
+  Gaudi::Property<std::map<std::string, std::string>> m_sensitiveTypes{
+      this, "sensitiveTypes", {},
+      "Types of the sensitive detectors created, by type in the compact files (e.g. buffered sensitive detectors)"};
+  /// Flag whether the converted solids are replaced by implementations faster to navigate
+  Gaudi::Property<bool> m_optimiseSolids{this, "optimiseSolids", false,
+                                         "Replace the converted solids by implementations faster to navigate"};
+  /// Names of the sub-detectors whose solids are replaced (all if empty)
+  Gaudi::Property<std::vector<std::string>> m_optimiseSolidsDetectors{
+      this, "optimiseSolidsDetectors", {}, "Names of the sub-detectors whose solids are replaced (all if empty)"};
+  /// Minimum number of solids of a union replaced by a G4MultiUnion
+  Gaudi::Property<unsigned int> m_minUnionNodes{this, "minUnionNodes", 3,
+                                                "Minimum number of solids of a union replaced by a G4MultiUnion"};
+  /// Number of points at which the navigation of the heavy solids is timed before and after the replacement
+  Gaudi::Property<unsigned int> m_solidTimingPoints{
+      this, "solidTimingPoints", 0, "Number of points at which the navigation of each heavy solid is timed (0: none)"};
+  /// CSV file of the timing of the solids
+  Gaudi::Property<std::string> m_solidTimingFile{this, "solidTimingFile", "", "CSV file of the timing of the solids"};
 };
 
 #endif  // GEOSVC_H
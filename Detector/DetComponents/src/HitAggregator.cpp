@@ -0,0 +1,50 @@
+#include "HitAggregator.h"
+
+// datamodel
+#include "edm4hep/CalorimeterHitCollection.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+
+void HitAggregator::add(const edm4hep::CalorimeterHit& aHit, dd4hep::DDSegmentation::CellID aCellId) {
+  const auto& position = aHit.getPosition();
+  const double energy = aHit.getEnergy();
+  auto inserted = m_index.emplace(aCellId, m_cells.size());
+  if (inserted.second) {
+    m_cells.push_back({aCellId,
+                       energy,
+                       double(aHit.getEnergyError()) * aHit.getEnergyError(),
+                       {energy * position.x, energy * position.y, energy * position.z},
+                       {position.x, position.y, position.z},
+                       aHit.getTime(),
+                       aHit.getType()});
+    return;
+  }
+  Cell& cell = m_cells[inserted.first->second];
+  cell.energy += energy;
+  cell.energyError2 += double(aHit.getEnergyError()) * aHit.getEnergyError();
+  cell.weightedPosition[0] += energy * position.x;
+  cell.weightedPosition[1] += energy * position.y;
+  cell.weightedPosition[2] += energy * position.z;
+  cell.time = std::min(cell.time, aHit.getTime());
+}
+
+void HitAggregator::fill(edm4hep::CalorimeterHitCollection& aHits) {
+  for (const auto& cell : m_cells) {
+    edm4hep::CalorimeterHit hit = aHits.create();
+    hit.setCellID(cell.cellId);
+    hit.setEnergy(cell.energy);
+    hit.setEnergyError(std::sqrt(cell.energyError2));
+    if (cell.energy != 0) {
+      hit.setPosition({float(cell.weightedPosition[0] / cell.energy), float(cell.weightedPosition[1] / cell.energy),
+                       float(cell.weightedPosition[2] / cell.energy)});
+    } else {
+      hit.setPosition({cell.firstPosition[0], cell.firstPosition[1], cell.firstPosition[2]});
+    }
+    hit.setTime(cell.time);
+    hit.setType(cell.type);
+  }
+  m_cells.clear();
+  m_index.clear();
+}
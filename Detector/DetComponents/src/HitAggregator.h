@@ -0,0 +1,54 @@
+#ifndef DETCOMPONENTS_HITAGGREGATOR_H
+#define DETCOMPONENTS_HITAGGREGATOR_H
+
+// DD4hep
+#include "DDSegmentation/Segmentation.h"
+
+// STL
+#include <unordered_map>
+#include <vector>
+
+// datamodel
+namespace edm4hep {
+class CalorimeterHit;
+class CalorimeterHitCollection;
+}
+
+/** @class HitAggregator Detector/DetComponents/src/HitAggregator.h HitAggregator.h
+ *
+ *  Sums the calorimeter hits that share a cellID (e.g. after merging cells or layers).
+ *  The energy is summed (its error in quadrature), the position is weighted by the energy and the time is the earliest
+ *  one. The hits are written in the order in which their cells were first seen.
+ */
+
+class HitAggregator {
+public:
+  /**  Add a hit to the cell.
+   *   @param[in] aHit hit to add
+   *   @param[in] aCellId cellID of the hit after the transformation
+   */
+  void add(const edm4hep::CalorimeterHit& aHit, dd4hep::DDSegmentation::CellID aCellId);
+  /**  Create the summed hits in the collection and clear the aggregator.
+   *   @param[out] aHits collection of the summed hits
+   */
+  void fill(edm4hep::CalorimeterHitCollection& aHits);
+  /// Number of distinct cells
+  size_t size() const { return m_cells.size(); }
+
+private:
+  struct Cell {
+    dd4hep::DDSegmentation::CellID cellId;
+    double energy;
+    double energyError2;
+    /// energy-weighted position, with the first position kept if the energy sums to zero
+    double weightedPosition[3];
+    float firstPosition[3];
+    float time;
+    int type;
+  };
+  /// Cells in the order in which they were seen
+  std::vector<Cell> m_cells;
+  /// Index of the cells in m_cells
+  std::unordered_map<dd4hep::DDSegmentation::CellID, size_t> m_index;
+};
+#endif /* DETCOMPONENTS_HITAGGREGATOR_H */
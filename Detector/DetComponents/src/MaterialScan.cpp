@@ -8,14 +8,44 @@
 
 #include "DD4hep/Detector.h"
 #include "DD4hep/Printout.h"
-#include "DDRec/MaterialManager.h"
-#include "DDRec/Vector3D.h"
 
 #include "TFile.h"
+#include "TH2D.h"
+#include "TH3D.h"
+#include "TVectorD.h"
+#include "TGeoManager.h"
+#include "TGeoNavigator.h"
 #include "TMath.h"
 #include "TTree.h"
 #include "TVector3.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace {
+/** Follow the ray from the start point up to the given distance along the direction.
+ *  Each thread uses its own navigator, the geometry itself is shared.
+ *  @param[in] aSegment called for each crossed segment with its medium, starting distance and length
+ */
+template <typename Segment>
+void walkRay(TGeoNavigator& aNavigator, const std::array<Double_t, 3>& aPos, const std::array<Double_t, 3>& aDir,
+             double aDistance, Segment&& aSegment) {
+  aNavigator.InitTrack(aPos.data(), aDir.data());
+  double travelled = 0;
+  while (aDistance - travelled > TGeoShape::Tolerance() && !aNavigator.IsOutside()) {
+    TGeoNode* node = aNavigator.GetCurrentNode();
+    aNavigator.FindNextBoundaryAndStep(aDistance - travelled);
+    double step = std::min(aNavigator.GetStep(), aDistance - travelled);
+    if (step <= 0) {
+      break;
+    }
+    aSegment(node->GetMedium(), travelled, step);
+    travelled += step;
+  }
+}
+}
+
 MaterialScan::MaterialScan(const std::string& name, ISvcLocator* svcLoc) : Service(name, svcLoc),
 m_geoSvc("GeoSvc", name) {}
 
@@ -31,23 +61,23 @@ StatusCode MaterialScan::initialize() {
 
   SmartIF<IRndmGenSvc> randSvc;
   randSvc = service("RndmGenSvc");
-  StatusCode sc = m_flatPhiDist.initialize(randSvc, Rndm::Flat(0., M_PI / 2.));
+  StatusCode sc = m_flatSeedDist.initialize(randSvc, Rndm::Flat(0., 4294967296.));
   if (sc == StatusCode::FAILURE) {
     error() << "Unable to initialize random number generator." << endmsg;
     return sc;
   }
-  sc = m_flatEtaDist.initialize(randSvc, Rndm::Flat(0., m_etaBinning));
-  if (sc == StatusCode::FAILURE) {
-    error() << "Unable to initialize random number generator." << endmsg;
-    return sc;
+
+  if (!m_mapFilename.empty() &&
+      (m_mapPhiBins < 1 || m_mapTrials < 1 || !std::is_sorted(m_mapRadii.value().begin(), m_mapRadii.value().end()))) {
+    error() << "The material map needs at least one phi bin and one ray per cell, and ascending layer radii."
+            << endmsg;
+    return StatusCode::FAILURE;
   }
 
   std::unique_ptr<TFile> rootFile(TFile::Open(m_filename.value().c_str(), "RECREATE"));
   // no smart pointers possible because TTree is owned by rootFile (root mem management FTW!)
   TTree* tree = new TTree("materials", "");
   double eta = 0;
-  double phi = 0;
-  double etaRndm = 0;
   unsigned nMaterials = 0;
   std::unique_ptr<std::vector<double>> nX0(new std::vector<double>);
   std::unique_ptr<std::vector<double>> nLambda(new std::vector<double>);
@@ -65,52 +95,191 @@ StatusCode MaterialScan::initialize() {
   tree->Branch("matDepth", &matDepthPtr);
   tree->Branch("material", &materialPtr);
 
+  // bins and the seeds of their random streams, in the order of the output
+  std::vector<double> etaBins;
+  std::vector<std::uint32_t> seeds;
+  for (eta = -m_etaMax; eta < m_etaMax; eta += m_etaBinning) {
+    etaBins.push_back(eta);
+    seeds.push_back(static_cast<std::uint32_t>(m_flatSeedDist()));
+  }
+  unsigned numThreads = m_numThreads > 0 ? m_numThreads.value() : std::max(1u, std::thread::hardware_concurrency());
+  numThreads = std::max<size_t>(1, std::min<size_t>(numThreads, etaBins.size()));
+
   auto lcdd = m_geoSvc->lcdd();
-  dd4hep::rec::MaterialManager matMgr(lcdd->detector(m_envelopeName).volume());
-  dd4hep::rec::Vector3D beginning(0, 0, 0);
+  TGeoManager& geoManager = lcdd->manager();
   auto boundaryVol = lcdd->detector(m_envelopeName).volume()->GetShape();
-  std::array<Double_t, 3> pos = {0, 0, 0};
-  std::array<Double_t, 3> dir = {0, 0, 0};
-  TVector3 vec(0, 0, 0);
-  for (eta = -m_etaMax; eta < m_etaMax; eta += m_etaBinning) {
+  if (numThreads > 1 && geoManager.GetMaxThreads() < static_cast<int>(numThreads)) {
+    geoManager.SetMaxThreads(numThreads);
+  }
+  // materials averaged over phi, per eta bin
+  std::vector<std::map<TGeoMedium*, double>> phiAveragedMaterials(etaBins.size());
+  // material budget per phi bin and radial layer (X0 and lambda), per eta bin
+  std::vector<std::vector<double>> maps(etaBins.size());
+  std::atomic<size_t> nextBin{0};
+  auto scan = [&](TGeoNavigator& aNavigator) {
+    for (size_t iBin = nextBin++; iBin < etaBins.size(); iBin = nextBin++) {
+      std::mt19937 engine(seeds[iBin]);
+      std::uniform_real_distribution<double> flatPhiDist(0., M_PI / 2.);
+      std::uniform_real_distribution<double> flatEtaDist(0., m_etaBinning);
+      TVector3 vec(0, 0, 0);
+      std::array<Double_t, 3> pos = {0, 0, 0};
+      for (int iPhi = 0; iPhi < m_nPhiTrials; ++iPhi) {
+        double phi = flatPhiDist(engine);
+        double etaRndm = etaBins[iBin] + flatEtaDist(engine);
+        vec.SetPtEtaPhi(1, etaRndm, phi);
+        auto n = vec.Unit();
+        std::array<Double_t, 3> dir = {n.X(), n.Y(), n.Z()};
+        // if the start point (beginning) is inside the material-scan envelope (e.g. if envelope is world volume)
+        double distance = boundaryVol->DistFromInside(pos.data(), dir.data());
+        // if the start point (beginning) is not inside the envelope
+        if (distance == 0) {
+          distance = boundaryVol->DistFromOutside(pos.data(), dir.data());
+        }
+        std::map<TGeoMedium*, double>& materials = phiAveragedMaterials[iBin];
+        walkRay(aNavigator, pos, dir, distance, [&](TGeoMedium* aMedium, double, double aStep) {
+          materials[aMedium] += aStep / static_cast<double>(m_nPhiTrials);
+        });
+      }
+      if (!m_mapFilename.empty()) {
+        scanMap(aNavigator, engine, etaBins[iBin], *boundaryVol, maps[iBin]);
+      }
+    }
+  };
+  if (numThreads == 1) {
+    scan(*geoManager.GetCurrentNavigator());
+  } else {
+    info() << "Scanning " << etaBins.size() << " eta bins with " << numThreads << " threads" << endmsg;
+    std::vector<std::thread> threads;
+    for (unsigned iThread = 0; iThread < numThreads; ++iThread) {
+      threads.emplace_back([&]() {
+        TGeoNavigator* navigator = geoManager.AddNavigator();
+        scan(*navigator);
+        geoManager.RemoveNavigator(navigator);
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  for (size_t iBin = 0; iBin < etaBins.size(); ++iBin) {
+    eta = etaBins[iBin];
     nX0->clear();
     nLambda->clear();
     matDepth->clear();
     material->clear();
-
-    std::map<dd4hep::Material, double> phiAveragedMaterialsBetween;
-    for (int iPhi = 0; iPhi < m_nPhiTrials; ++iPhi) {
-      phi = m_flatPhiDist();
-      etaRndm = eta + m_flatEtaDist();
-      vec.SetPtEtaPhi(1, etaRndm, phi);
-      auto n = vec.Unit();
-      dir = {n.X(), n.Y(), n.Z()};
-      // if the start point (beginning) is inside the material-scan envelope (e.g. if envelope is world volume)
-      double distance = boundaryVol->DistFromInside(pos.data(), dir.data());
-      // if the start point (beginning) is not inside the envelope
-      if (distance == 0) {
-        distance = boundaryVol->DistFromOutside(pos.data(), dir.data());
-      }
-      dd4hep::rec::Vector3D end(dir[0] * distance, dir[1] * distance, dir[2] * distance);
-      debug() << "Calculating material between 0 and (" << end.x() << ", " << end.y() << ", " << end.z()
-              << ") <=> eta = " << eta << ", phi =  " << phi << endmsg;
-      const dd4hep::rec::MaterialVec& materials = matMgr.materialsBetween(beginning, end);
-      for (unsigned i = 0, n_materials = materials.size(); i < n_materials; ++i) {
-        phiAveragedMaterialsBetween[materials[i].first] += materials[i].second / static_cast<double>(m_nPhiTrials);
-      }
-    }
-    nMaterials = phiAveragedMaterialsBetween.size();
-    for (auto matpair : phiAveragedMaterialsBetween) {
+    nMaterials = phiAveragedMaterials[iBin].size();
+    for (auto matpair : phiAveragedMaterials[iBin]) {
       TGeoMaterial* mat = matpair.first->GetMaterial();
       material->push_back(mat->GetName());
       matDepth->push_back(matpair.second);
       nX0->push_back(matpair.second / mat->GetRadLen());
       nLambda->push_back(matpair.second / mat->GetIntLen());
     }
+    debug() << "Material at eta = " << eta << ": " << nMaterials << " materials" << endmsg;
     tree->Fill();
   }
   tree->Write();
   rootFile->Close();
+  if (!m_mapFilename.empty()) {
+    return writeMap(etaBins, maps);
+  }
+  return StatusCode::SUCCESS;
+}
+
+void MaterialScan::scanMap(TGeoNavigator& aNavigator, std::mt19937& aEngine, double aEta, const TGeoShape& aBoundary,
+                           std::vector<double>& aMap) const {
+  const size_t numLayers = m_mapRadii.size() + 1;
+  aMap.assign(2 * m_mapPhiBins * numLayers, 0);
+  const double phiBinning = 2 * M_PI / m_mapPhiBins;
+  std::uniform_real_distribution<double> flatDist(0., 1.);
+  TVector3 vec(0, 0, 0);
+  std::array<Double_t, 3> pos = {0, 0, 0};
+  for (int iPhi = 0; iPhi < m_mapPhiBins; ++iPhi) {
+    double* x0 = &aMap[2 * iPhi * numLayers];
+    double* lambda = x0 + numLayers;
+    for (int iTrial = 0; iTrial < m_mapTrials; ++iTrial) {
+      double phi = -M_PI + (iPhi + flatDist(aEngine)) * phiBinning;
+      double etaRndm = aEta + flatDist(aEngine) * m_etaBinning;
+      vec.SetPtEtaPhi(1, etaRndm, phi);
+      auto n = vec.Unit();
+      std::array<Double_t, 3> dir = {n.X(), n.Y(), n.Z()};
+      double distance = aBoundary.DistFromInside(pos.data(), dir.data());
+      if (distance == 0) {
+        distance = aBoundary.DistFromOutside(pos.data(), dir.data());
+      }
+      // the layers are crossed at the distances corresponding to their radii along the ray
+      const double sinTheta = n.Perp();
+      walkRay(aNavigator, pos, dir, distance, [&](TGeoMedium* aMedium, double aStart, double aStep) {
+        const TGeoMaterial* mat = aMedium->GetMaterial();
+        double start = aStart;
+        const double end = aStart + aStep;
+        for (size_t iLayer = 0; iLayer < numLayers && start < end; ++iLayer) {
+          double layerEnd = end;
+          if (iLayer < m_mapRadii.size() && sinTheta > 0) {
+            layerEnd = std::min(end, m_mapRadii[iLayer] / sinTheta);
+          } else if (iLayer < m_mapRadii.size()) {
+            continue;
+          }
+          if (layerEnd <= start) {
+            continue;
+          }
+          x0[iLayer] += (layerEnd - start) / mat->GetRadLen() / m_mapTrials;
+          lambda[iLayer] += (layerEnd - start) / mat->GetIntLen() / m_mapTrials;
+          start = layerEnd;
+        }
+      });
+    }
+  }
+}
+
+StatusCode MaterialScan::writeMap(const std::vector<double>& aEtaBins,
+                                  const std::vector<std::vector<double>>& aMaps) const {
+  std::unique_ptr<TFile> mapFile(TFile::Open(m_mapFilename.value().c_str(), "RECREATE"));
+  if (mapFile == nullptr || mapFile->IsZombie()) {
+    error() << "Unable to open the material map file " << m_mapFilename.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  const int numEta = aEtaBins.size();
+  const int numLayers = m_mapRadii.size() + 1;
+  const double etaMin = -m_etaMax;
+  const double etaMax = etaMin + numEta * m_etaBinning;
+  // histograms are owned by the file
+  TH2D* x0 = new TH2D("nX0", "material budget in X0;#eta;#phi", numEta, etaMin, etaMax, m_mapPhiBins, -M_PI, M_PI);
+  TH2D* lambda = new TH2D("nLambda", "material budget in #lambda;#eta;#phi", numEta, etaMin, etaMax, m_mapPhiBins,
+                          -M_PI, M_PI);
+  TH3D* x0Layers = nullptr;
+  TH3D* lambdaLayers = nullptr;
+  if (numLayers > 1) {
+    x0Layers = new TH3D("nX0Layers", "material budget in X0;#eta;#phi;layer", numEta, etaMin, etaMax,
+                        m_mapPhiBins, -M_PI, M_PI, numLayers, 0, numLayers);
+    lambdaLayers = new TH3D("nLambdaLayers", "material budget in #lambda;#eta;#phi;layer", numEta, etaMin, etaMax,
+                            m_mapPhiBins, -M_PI, M_PI, numLayers, 0, numLayers);
+    TVectorD radii(m_mapRadii.size(), m_mapRadii.value().data());
+    radii.Write("layerRadii");
+  }
+  for (int iEta = 0; iEta < numEta; ++iEta) {
+    for (int iPhi = 0; iPhi < m_mapPhiBins; ++iPhi) {
+      const double* cellX0 = &aMaps[iEta][2 * iPhi * numLayers];
+      const double* cellLambda = cellX0 + numLayers;
+      double sumX0 = 0;
+      double sumLambda = 0;
+      for (int iLayer = 0; iLayer < numLayers; ++iLayer) {
+        sumX0 += cellX0[iLayer];
+        sumLambda += cellLambda[iLayer];
+        if (x0Layers != nullptr) {
+          x0Layers->SetBinContent(iEta + 1, iPhi + 1, iLayer + 1, cellX0[iLayer]);
+          lambdaLayers->SetBinContent(iEta + 1, iPhi + 1, iLayer + 1, cellLambda[iLayer]);
+        }
+      }
+      x0->SetBinContent(iEta + 1, iPhi + 1, sumX0);
+      lambda->SetBinContent(iEta + 1, iPhi + 1, sumLambda);
+    }
+  }
+  mapFile->Write();
+  mapFile->Close();
+  info() << "Material map of " << numEta << " x " << m_mapPhiBins.value() << " cells written to "
+         << m_mapFilename.value() << endmsg;
   return StatusCode::SUCCESS;
 }
 
@@ -3,11 +3,24 @@
 #include "GaudiKernel/RndmGenerators.h"
 #include "GaudiKernel/Service.h"
 
+#include <random>
+
+class TGeoNavigator;
+class TGeoShape;
+
 /** @class MaterialScan Detector/DetComponents/src/MaterialScan.h MaterialScan.h
  *
  *  Service that facilitates material scan on initialize
  *  This service outputs a ROOT file containing a TTree with radiation lengths and material thickness
  *  For an example on how to read the file, see Examples/scripts/material_plots.py
+ *  The eta bins can be scanned in parallel (\b'numThreads'), each thread navigating the geometry on its own.
+ *  Each bin draws its phi and eta values from its own random stream, seeded in the order of the bins, so that the
+ *  output does not depend on the number of threads.
+ *  Optionally (\b'mapFilename'), a map of the material budget in eta and phi is written as histograms of the
+ *  number of radiation lengths (nX0) and of interaction lengths (nLambda), so that the material can be looked up
+ *  without navigating the geometry. If the radii of layers are given (\b'mapRadii'), the budget of each layer
+ *  (up to the radius, cylindrical) is also written in histograms nX0Layers and nLambdaLayers, with the radii
+ *  stored as layerRadii. The eta binning is the same as for the scan.
  *
  *  @author J. Lingemann
  */
@@ -21,6 +34,13 @@ public:
   virtual ~MaterialScan(){};
 
 private:
+  /** Scan the material map of one eta bin.
+   *  @param[out] aMap X0 and lambda of the layers, per phi bin
+   */
+  void scanMap(TGeoNavigator& aNavigator, std::mt19937& aEngine, double aEta, const TGeoShape& aBoundary,
+               std::vector<double>& aMap) const;
+  /// Write the histograms of the material map
+  StatusCode writeMap(const std::vector<double>& aEtaBins, const std::vector<std::vector<double>>& aMaps) const;
   /// name of the output file
   Gaudi::Property<std::string> m_filename{this, "filename", "", "file name to save the tree to"};
   /// Handle to the geometry service from which the detector is retrieved
@@ -35,9 +55,19 @@ private:
   /// Name of the envelope within which the material is measured (by default: world volume)
   Gaudi::Property<std::string> m_envelopeName{this, "envelopeName", "world",
                                               "name of the envelope within which the material is measured"};
-  /// Flat random number generator
-  Rndm::Numbers m_flatPhiDist;
-  /// Flat random number generator
-  Rndm::Numbers m_flatEtaDist;
+  /// Number of threads scanning the eta bins (all available cores if 0)
+  Gaudi::Property<unsigned> m_numThreads{this, "numThreads", 1,
+                                         "number of threads scanning the eta bins (all available cores if 0)"};
+  /// Name of the file of the eta-phi material map (no map if empty)
+  Gaudi::Property<std::string> m_mapFilename{this, "mapFilename", "", "file name to save the eta-phi material map to"};
+  /// Number of phi bins of the material map
+  Gaudi::Property<int> m_mapPhiBins{this, "mapPhiBins", 64, "number of phi bins of the material map"};
+  /// Number of random rays per cell of the material map
+  Gaudi::Property<int> m_mapTrials{this, "mapTrials", 10, "number of random rays per cell of the material map"};
+  /// Outer radii of the layers of the material map (the last layer extends to the envelope)
+  Gaudi::Property<std::vector<double>> m_mapRadii{this, "mapRadii", {},
+                                                  "outer radii of the layers of the material map"};
+  /// Flat random number generator of the seeds of the eta bins
+  Rndm::Numbers m_flatSeedDist;
 
 };
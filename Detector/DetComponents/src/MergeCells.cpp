@@ -1,4 +1,6 @@
 #include "MergeCells.h"
+#include "FixedBitField.h"
+#include "HitAggregator.h"
 
 // FCCSW
 #include "k4Interface/IGeoSvc.h"
@@ -14,6 +16,22 @@ using dd4hep::DDSegmentation::CellID;
 
 DECLARE_COMPONENT(MergeCells)
 
+namespace {
+/// Merge the cells of the field, for a fixed bitfield layout
+template <typename Field>
+struct MergeKernel {
+  static void run(CellID* aCellIds, size_t aSize, int aNumToMerge) {
+    for (size_t i = 0; i < aSize; ++i) {
+      long long value = Field::value(aCellIds[i]);
+      if (Field::isSigned) {
+        value += value < 0 ? -(aNumToMerge / 2) : aNumToMerge / 2;
+      }
+      Field::set(aCellIds[i], value / aNumToMerge);
+    }
+  }
+};
+}
+
 MergeCells::MergeCells(const std::string& aName, ISvcLocator* aSvcLoc) : GaudiAlgorithm(aName, aSvcLoc), m_geoSvc("GeoSvc", aName) {
   declareProperty("inhits", m_inHits, "Hit collection to merge (input)");
   declareProperty("outhits", m_outHits, "Merged hit collection (output)");
@@ -66,9 +84,14 @@ StatusCode MergeCells::initialize() {
             << "(to ensure that middle cell is centred at 0)." << endmsg;
     return StatusCode::FAILURE;
   }
+  m_fixedMerge = fixedbitfield::kernel<MergeKernel>(*m_descriptor.decoder(), m_descriptor.fieldID(m_idToMerge));
+  debug() << "Fixed bitfield layout used: " << (m_fixedMerge != nullptr) << endmsg;
   info() << "Field description: " << m_descriptor.fieldDescription() << endmsg;
   info() << "Merging cells for identifier: " << m_idToMerge << endmsg;
   info() << "Number of adjacent cells to be merged: " << m_numToMerge << "\n" << endmsg;
+  if (m_aggregate) {
+    info() << "Hits sharing a merged cellID are summed" << endmsg;
+  }
   return StatusCode::SUCCESS;
 }
 
@@ -77,40 +100,55 @@ StatusCode MergeCells::execute() {
   auto outHits = new edm4hep::CalorimeterHitCollection();
 
   uint field_id = m_descriptor.fieldID(m_idToMerge);
-  auto decoder = m_descriptor.decoder();
-  dd4hep::DDSegmentation::CellID cellId = 0;
-  int value = 0;
+  const auto& field = (*m_descriptor.decoder())[field_id];
+  std::vector<CellID> cellIds;
+  cellIds.reserve(inHits->size());
+  for (const auto& hit : *inHits) {
+    cellIds.push_back(hit.getCellID());
+  }
+  if (m_fixedMerge != nullptr) {
+    m_fixedMerge(cellIds.data(), cellIds.size(), m_numToMerge);
+  } else {
+    for (auto& cellId : cellIds) {
+      int value = field.value(cellId);
+      if (field.isSigned()) {
+        if (value < 0) {
+          value -= m_numToMerge / 2;
+        } else {
+          value += m_numToMerge / 2;
+        }
+      }
+      value /= int(m_numToMerge);
+      field.set(cellId, value);
+    }
+  }
   uint debugIter = 0;
+  size_t iHit = 0;
+  HitAggregator aggregator;
 
   for (const auto& hit : *inHits) {
+    const CellID cellId = cellIds[iHit++];
+    if (debugIter < m_debugPrint) {
+      debug() << "old ID = " << field.value(hit.getCellID()) << endmsg;
+      debug() << "new ID = " << field.value(cellId) << endmsg;
+      debugIter++;
+    }
+    if (m_aggregate) {
+      aggregator.add(hit, cellId);
+      continue;
+    }
     edm4hep::CalorimeterHit newHit = outHits->create();
     newHit.setEnergy(hit.getEnergy());
     newHit.setEnergyError(hit.getEnergyError());
     newHit.setPosition(hit.getPosition());
     newHit.setType(hit.getType());
     newHit.setTime(hit.getTime());
-    cellId = hit.getCellID();
-    value = (*decoder)[field_id].value(cellId);
-    if (debugIter < m_debugPrint) {
-      debug() << "old ID = " << value << endmsg;
-    }
-    if ((*decoder)[field_id].isSigned()) { //??
-      if (value < 0) {
-        value -= m_numToMerge / 2;
-      } else {
-        value += m_numToMerge / 2;
-      }
-    }
-    value /= int(m_numToMerge);
-    if (debugIter < m_debugPrint) {
-      debug() << "new ID = " << value << endmsg;
-      debugIter++;
-    }
-    //decoder->set(cellId, field_id, value);
-    //newHit.cellId(cellId);
-    (*decoder)[field_id].set(cellId, value);
     newHit.setCellID(cellId);
   }
+  if (m_aggregate) {
+    debug() << inHits->size() << " hits merged into " << aggregator.size() << " cells" << endmsg;
+    aggregator.fill(*outHits);
+  }
   m_outHits.put(outHits);
 
   return StatusCode::SUCCESS;
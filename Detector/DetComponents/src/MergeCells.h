@@ -63,6 +63,10 @@ private:
   Gaudi::Property<std::string> m_idToMerge{this, "identifier", "", "Identifier to be merged"};
   /// Number of adjacent cells to be merged
   Gaudi::Property<uint> m_numToMerge{this, "merge", 0, "Number of adjacent cells to be merged"};
+  /// Sum the hits that share a merged cellID
+  Gaudi::Property<bool> m_aggregate{this, "aggregate", false, "Sum the hits that share a merged cellID"};
+  /// Merging of the cells for a fixed bitfield layout (nullptr if the readout does not have one)
+  void (*m_fixedMerge)(dd4hep::DDSegmentation::CellID*, size_t, int) = nullptr;
   /// Limit of debug printing
   Gaudi::Property<uint> m_debugPrint{this, "debugPrint", 10, "Limit of debug printing"};
 };
@@ -1,4 +1,6 @@
 #include "MergeLayers.h"
+#include "FixedBitField.h"
+#include "HitAggregator.h"
 
 // FCCSW
 #include "k4Interface/IGeoSvc.h"
@@ -17,6 +19,24 @@
 
 DECLARE_COMPONENT(MergeLayers)
 
+using dd4hep::DDSegmentation::CellID;
+
+namespace {
+/// Remap the volume IDs of the field, for a fixed bitfield layout
+template <typename Field>
+struct RemapKernel {
+  static void run(CellID* aCellIds, size_t aSize, const std::vector<unsigned int>& aNewVolumeId) {
+    for (size_t i = 0; i < aSize; ++i) {
+      unsigned int value = Field::value(aCellIds[i]);
+      // volumes beyond the merged ones keep their ID
+      if (value < aNewVolumeId.size()) {
+        Field::set(aCellIds[i], aNewVolumeId[value]);
+      }
+    }
+  }
+};
+}
+
 MergeLayers::MergeLayers(const std::string& aName, ISvcLocator* aSvcLoc) : GaudiAlgorithm(aName, aSvcLoc), m_geoSvc("GeoSvc", aName) {
   declareProperty("inhits", m_inHits, "Hit collection to merge (input)");
   declareProperty("outhits", m_outHits, "Merged hit collection (output)");
@@ -54,10 +74,21 @@ StatusCode MergeLayers::initialize() {
             << endmsg;
     return StatusCode::FAILURE;
   }
+  m_fieldId = m_descriptor.fieldID(m_idToMerge);
+  // lookup table from the old volume ID to the merged one
+  m_newVolumeId.clear();
+  for (unsigned int i = 0; i < m_listToMerge.size(); i++) {
+    m_newVolumeId.insert(m_newVolumeId.end(), m_listToMerge[i], i);
+  }
+  m_fixedRemap = fixedbitfield::kernel<RemapKernel>(*m_descriptor.decoder(), m_fieldId);
+  debug() << "Fixed bitfield layout used: " << (m_fixedRemap != nullptr) << endmsg;
   info() << "Field description: " << m_descriptor.fieldDescription() << endmsg;
   info() << "Merging volumes named: " << m_volumeName << endmsg;
   info() << "Merging volumes for identifier: " << m_idToMerge << endmsg;
   info() << "List of number of volumes to be merged: " << m_listToMerge << "\n" << endmsg;
+  if (m_aggregate) {
+    info() << "Hits sharing a merged cellID are summed" << endmsg;
+  }
   return StatusCode::SUCCESS;
 }
 
@@ -65,45 +96,50 @@ StatusCode MergeLayers::execute() {
   const auto inHits = m_inHits.get();
   auto outHits = new edm4hep::CalorimeterHitCollection();
 
-  // rewriting list of cell sizes to list of top boundaries to facilitate the loop over hits
-  std::vector<unsigned int> listToMergeBoundary(m_listToMerge.size());
-  unsigned int sumCells = 0;
-  for (unsigned int i = 0; i < m_listToMerge.size(); i++) {
-    sumCells += m_listToMerge[i];
-    listToMergeBoundary[i] = sumCells;
-  }
-
-  unsigned int field_id = m_descriptor.fieldID(m_idToMerge);
   auto decoder = m_descriptor.decoder();
-  dd4hep::DDSegmentation::CellID cellId = 0;
-  unsigned int value = 0;
+  std::vector<CellID> cellIds;
+  cellIds.reserve(inHits->size());
+  for (const auto& hit : *inHits) {
+    cellIds.push_back(hit.getCellID());
+  }
+  if (m_fixedRemap != nullptr) {
+    m_fixedRemap(cellIds.data(), cellIds.size(), m_newVolumeId);
+  } else {
+    for (auto& cellId : cellIds) {
+      unsigned int value = decoder->get(cellId, m_fieldId);
+      // volumes beyond the merged ones keep their ID
+      if (value < m_newVolumeId.size()) {
+        decoder->set(cellId, m_fieldId, m_newVolumeId[value]);
+      }
+    }
+  }
   unsigned int debugIter = 0;
+  size_t iHit = 0;
+  HitAggregator aggregator;
 
   for (const auto& hit : *inHits) {
+    const CellID cellId = cellIds[iHit++];
+    if (debugIter < m_debugPrint) {
+      debug() << "old ID = " << decoder->get(hit.getCellID(), m_fieldId) << endmsg;
+      debug() << "new ID = " << decoder->get(cellId, m_fieldId) << endmsg;
+      debugIter++;
+    }
+    if (m_aggregate) {
+      aggregator.add(hit, cellId);
+      continue;
+    }
     edm4hep::CalorimeterHit newHit = outHits->create();
     newHit.setEnergy(hit.getEnergy());
     newHit.setEnergyError(hit.getEnergyError());
     newHit.setPosition(hit.getPosition());
     newHit.setType(hit.getType());
     newHit.setTime(hit.getTime());
-    cellId = hit.getCellID();
-    value = decoder->get(cellId, field_id);
-    if (debugIter < m_debugPrint) {
-      debug() << "old ID = " << value << endmsg;
-    }
-    for (unsigned int i = 0; i < listToMergeBoundary.size(); i++) {
-      if (value < listToMergeBoundary[i]) {
-        value = i;
-        break;
-      }
-    }
-    if (debugIter < m_debugPrint) {
-      debug() << "new ID = " << value << endmsg;
-      debugIter++;
-    }
-    decoder->set(cellId, field_id, value);
     newHit.setCellID(cellId);
   }
+  if (m_aggregate) {
+    debug() << inHits->size() << " hits merged into " << aggregator.size() << " cells" << endmsg;
+    aggregator.fill(*outHits);
+  }
   m_outHits.put(outHits);
 
   return StatusCode::SUCCESS;
@@ -29,6 +29,9 @@ class CalorimeterHitCollection;
  *  and finally last 2 layers are merged into last cell (id=2).
  *  The sum of all sizes from the list should correspond to the total number of volumes named as indicated in '\b
  * volumeName'.
+ *  If property '\b aggregate' is set, the hits sharing a merged cellID are summed into one hit (energy-weighted
+ * position, earliest time).
+ *  For the standard readouts, the field is remapped with a layout fixed at compile time (see FixedBitField.h).
  *  For an example see Detector/DetComponents/tests/options/mergeLayers.py
  *
  *  @author Anna Zaborowska
@@ -70,6 +73,14 @@ private:
   /// List with number of adjacent cells to be merged
   Gaudi::Property<std::vector<uint>> m_listToMerge{
       this, "merge", {}, "List with number of adjacent cells to be merged"};
+  /// New volume ID for each old one (built from the list of volumes to be merged)
+  std::vector<unsigned int> m_newVolumeId;
+  /// Index of the identifier in the decoder
+  unsigned int m_fieldId = 0;
+  /// Remapping of the volumes for a fixed bitfield layout (nullptr if the readout does not have one)
+  void (*m_fixedRemap)(dd4hep::DDSegmentation::CellID*, size_t, const std::vector<unsigned int>&) = nullptr;
+  /// Sum the hits that share a merged cellID
+  Gaudi::Property<bool> m_aggregate{this, "aggregate", false, "Sum the hits that share a merged cellID"};
   /// Maximum number of lines in debug output
   Gaudi::Property<uint> m_debugPrint{this, "debugPrint", 10, "Maximum number of lines in debug output"};
 };
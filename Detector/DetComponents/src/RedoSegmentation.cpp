@@ -10,6 +10,10 @@
 #include "DD4hep/Detector.h"
 #include "DDSegmentation/Segmentation.h"
 
+// TBB
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 DECLARE_COMPONENT(RedoSegmentation)
 
 RedoSegmentation::RedoSegmentation(const std::string& aName, ISvcLocator* aSvcLoc) : GaudiAlgorithm(aName, aSvcLoc), m_geoSvc("GeoSvc", aName) {
@@ -53,6 +57,7 @@ StatusCode RedoSegmentation::initialize() {
   }
   // Take new segmentation from geometry service
   m_segmentation = m_geoSvc->lcdd()->readout(m_newReadoutName).segmentation().segmentation();
+  m_segmentations = std::make_unique<SegmentationCopies>(m_geoSvc->lcdd()->readout(m_newReadoutName).segmentation());
   // check if detector identifiers (old and new) agree
   std::vector<std::string> newFields;
   for (uint itField = 0; itField < m_segmentation->decoder()->size(); itField++) {
@@ -66,6 +71,8 @@ StatusCode RedoSegmentation::initialize() {
       return StatusCode::FAILURE;
     }
   }
+  m_remap = CellIDRemap(*m_oldDecoder, *m_segmentation->decoder(), m_detectorIdentifiers);
+  debug() << "Detector fields copied with a single mask: " << m_remap.sameLayout() << endmsg;
   info() << "Redoing the segmentation." << endmsg;
   info() << "Old bitfield:\t" << m_oldDecoder->fieldDescription() << endmsg;
   info() << "New bitfield:\t" << m_segmentation->decoder()->fieldDescription() << endmsg;
@@ -79,29 +86,42 @@ StatusCode RedoSegmentation::execute() {
   auto outHits = m_outHits.createAndPut();
   // loop over positioned hits to get the energy deposits: position and cellID
   // cellID contains the volumeID that needs to be copied to the new id
-  dd4hep::DDSegmentation::CellID oldid = 0;
+  const size_t numHits = inHits->size();
+  std::vector<dd4hep::DDSegmentation::CellID> cellIds(numHits);
+  auto computeCellIds = [this, &inHits, &cellIds](size_t aBegin, size_t aEnd) {
+    const auto& segmentation = m_segmentations->local();
+    for (size_t iHit = aBegin; iHit < aEnd; ++iHit) {
+      const auto& hit = (*inHits)[iHit];
+      // factor 10 to convert mm to cm // TODO: check
+      auto pos = hit.getPosition();
+      dd4hep::DDSegmentation::Vector3D position(pos.x / 10., pos.y / 10., pos.z / 10.);
+      // first calculate proper segmentation fields, then rewrite all other fields (detector ID)
+      const dd4hep::DDSegmentation::CellID cellId = hit.getCellID();
+      cellIds[iHit] = segmentation.cellID(position, position, 0);
+      m_remap.apply(&cellId, &cellIds[iHit], 1);
+    }
+  };
+  if (m_parallelThreshold > 0 && numHits >= m_parallelThreshold) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numHits),
+                      [&computeCellIds](const tbb::blocked_range<size_t>& aRange) {
+                        computeCellIds(aRange.begin(), aRange.end());
+                      });
+  } else {
+    computeCellIds(0, numHits);
+  }
   uint debugIter = 0;
-  for (const auto& hit : *inHits) {
+  for (size_t iHit = 0; iHit < numHits; ++iHit) {
+    const auto& hit = (*inHits)[iHit];
     edm4hep::CalorimeterHit newHit = outHits->create();
     newHit.setEnergy(hit.getEnergy());
+    newHit.setEnergyError(hit.getEnergyError());
+    newHit.setPosition(hit.getPosition());
+    newHit.setType(hit.getType());
     newHit.setTime(hit.getTime());
-    dd4hep::DDSegmentation::CellID cellId = hit.getCellID();
-    if (debugIter < m_debugPrint) {
-      debug() << "OLD: " << m_oldDecoder->valueString(cellId) << endmsg;
-    }
-    // factor 10 to convert mm to cm // TODO: check
-    auto pos = hit.getPosition();
-    dd4hep::DDSegmentation::Vector3D position(pos.x / 10., pos.y / 10., pos.z / 10.);
-    // first calculate proper segmentation fields
-    dd4hep::DDSegmentation::CellID newCellId = m_segmentation->cellID(position, position, 0);
-    // now rewrite all other fields (detector ID)
-    for (const auto& detectorField : m_detectorIdentifiers) {
-      oldid = m_oldDecoder->get(cellId, detectorField);
-      m_segmentation->decoder()->set(newCellId, detectorField, oldid);
-    }
-    newHit.setCellID(newCellId);
+    newHit.setCellID(cellIds[iHit]);
     if (debugIter < m_debugPrint) {
-      debug() << "NEW: " << m_segmentation->decoder()->valueString(newCellId) << endmsg;
+      debug() << "OLD: " << m_oldDecoder->valueString(hit.getCellID()) << endmsg;
+      debug() << "NEW: " << m_segmentation->decoder()->valueString(cellIds[iHit]) << endmsg;
       debugIter++;
     }
   }
@@ -110,6 +130,7 @@ StatusCode RedoSegmentation::execute() {
 
 StatusCode RedoSegmentation::finalize() {
   info() << "RedoSegmentation finalize! " << endmsg;
+  m_segmentations.reset();
    return GaudiAlgorithm::finalize(); }
 
 uint64_t RedoSegmentation::volumeID(uint64_t aCellId) const {
@@ -8,6 +8,8 @@
 // FCCSW
 #include "k4FWCore/DataHandle.h"
 class IGeoSvc;
+#include "CellIDRemap.h"
+#include "SegmentationCopies.h"
 
 // DD4hep
 #include "DD4hep/Readout.h"
@@ -17,6 +19,9 @@ class Segmentation;
 }
 }
 
+// STL
+#include <memory>
+
 // datamodel
 namespace edm4hep {
 class CalorimeterHitCollection;
@@ -30,6 +35,9 @@ class CalorimeterHitCollection;
  *  Cell IDs are rewritten from the old readout (`\b oldReadoutName`) to the new readout (`\b newReadoutName`).
  *  Names of the old segmentation fields need to be passed as a vector '\b oldSegmentationIds'.
  *  Those fields are replaced by the new segmentation.
+ *  The copy of the other (detector) fields is compiled at initialisation (see CellIDRemap).
+ *  Collections of at least '\b parallelThreshold' hits are processed in a parallel loop (not used if 0), in which
+ *  each thread computes the cellIDs with its own copy of the new segmentation (see SegmentationCopies).
  *
  *  For an example see Detector/DetComponents/tests/options/redoSegmentationXYZ.py
  *  and Detector/DetComponents/tests/options/redoSegmentationRPhi.py.
@@ -68,6 +76,8 @@ private:
   DataHandle<edm4hep::CalorimeterHitCollection> m_outHits{"hits/caloOutHits", Gaudi::DataHandle::Writer, this};
   /// New segmentation
   dd4hep::DDSegmentation::Segmentation* m_segmentation;
+  /// Copies of the new segmentation for the threads of the parallel loop
+  std::unique_ptr<SegmentationCopies> m_segmentations;
   /// Name of the detector readout used in simulation
   Gaudi::Property<std::string> m_oldReadoutName{this, "oldReadoutName", "",
                                                 "Name of the detector readout used in simulation"};
@@ -80,6 +90,11 @@ private:
       this, "oldSegmentationIds", {}, "Segmentation fields that are going to be replaced by the new segmentation"};
   /// Detector fields that are going to be rewritten
   std::vector<std::string> m_detectorIdentifiers;
+  /// Copy of the detector fields from the old to the new bitfield
+  CellIDRemap m_remap;
+  /// Minimum number of hits for the parallel loop
+  Gaudi::Property<size_t> m_parallelThreshold{this, "parallelThreshold", 0,
+                                              "Minimum number of hits for the parallel loop (not used if 0)"};
   /// Limit of debug printing
   Gaudi::Property<uint> m_debugPrint{this, "debugPrint", 10, "Limit of debug printing"};
 };
@@ -64,6 +64,9 @@ StatusCode RewriteBitfield::initialize() {
       return StatusCode::FAILURE;
     }
   }
+  m_remap = CellIDRemap(*m_oldDecoder, *m_newDecoder, m_detectorIdentifiers);
+  debug() << "Fields copied with masks: " << m_remap.numMasked() << ", with range check: " << m_remap.numConverted()
+          << endmsg;
   info() << "Rewritting the readout bitfield." << endmsg;
   info() << "Old bitfield:\t" << m_oldDecoder->fieldDescription() << endmsg;
   info() << "New bitfield:\t" << m_newDecoder->fieldDescription() << endmsg;
@@ -74,29 +77,27 @@ StatusCode RewriteBitfield::initialize() {
 StatusCode RewriteBitfield::execute() {
   const auto inHits = m_inHits.get();
   auto outHits = m_outHits.createAndPut();
-  // loop over positioned hits to get the energy deposits: position and cellID
   // cellID contains the volumeID that needs to be copied to the new id
-  uint64_t oldid = 0;
+  // all fields except for those to be removed are rewritten at once for the whole collection
+  std::vector<dd4hep::DDSegmentation::CellID> cellIds;
+  cellIds.reserve(inHits->size());
+  for (const auto& hit : *inHits) {
+    cellIds.push_back(hit.getCellID());
+  }
+  m_remap.apply(cellIds.data(), cellIds.size());
   uint debugIter = 0;
+  size_t iHit = 0;
   for (const auto& hit : *inHits) {
     edm4hep::CalorimeterHit newHit = outHits->create();
     newHit.setEnergy(hit.getEnergy());
     newHit.setTime(hit.getTime());
-    dd4hep::DDSegmentation::CellID cID = hit.getCellID();
-    if (debugIter < m_debugPrint) {
-      debug() << "OLD: " << m_oldDecoder->valueString(cID) << endmsg;
-    }
-    // now rewrite all fields except for those to be removed
-    dd4hep::DDSegmentation::CellID newID=0;
-    for (const auto& detectorField : m_detectorIdentifiers) {
-      oldid = m_oldDecoder->get(cID, detectorField);
-      m_newDecoder->set(newID, detectorField, oldid);
-    }
-    newHit.setCellID(newID);
+    newHit.setCellID(cellIds[iHit]);
     if (debugIter < m_debugPrint) {
-      debug() << "NEW: " << m_newDecoder->valueString(newID) << endmsg;
+      debug() << "OLD: " << m_oldDecoder->valueString(hit.getCellID()) << endmsg;
+      debug() << "NEW: " << m_newDecoder->valueString(cellIds[iHit]) << endmsg;
       debugIter++;
     }
+    ++iHit;
   }
   return StatusCode::SUCCESS;
 }
@@ -8,6 +8,7 @@
 // FCCSW
 #include "k4FWCore/DataHandle.h"
 class IGeoSvc;
+#include "CellIDRemap.h"
 
 // DD4hep
 #include "DD4hep/Readout.h"
@@ -30,6 +31,7 @@ class CalorimeterHitCollection;
  *  New readout bitfield has to be added to <readouts> tag in the detector description xml.
  *  Cell IDs are rewritten from the old readout (`\b oldReadoutName`) to the new readout (`\b newReadoutName`).
  *  Names of the fields to be removed (for verification) are passed as a vector '\b removeIds'.
+ *  The copy of the fields is compiled at initialisation into shifts and masks (see CellIDRemap).
  *
  *  For an example see Detector/DetComponents/tests/options/rewriteBitfield.py
  *
@@ -74,6 +76,8 @@ private:
       this, "removeIds", {}, "Segmentation fields that are going to be removed"};
   /// Detector fields that are going to be rewritten ( = old field - to be removed)
   std::vector<std::string> m_detectorIdentifiers;
+  /// Copy of the detector fields from the old to the new bitfield
+  CellIDRemap m_remap;
   /// Limit of debug printing
   Gaudi::Property<uint> m_debugPrint{this, "debugPrint", 10, "Limit of debug printing"};
 };
@@ -0,0 +1,23 @@
+#include "SegmentationCopies.h"
+
+// DD4hep
+#include "DDSegmentation/Segmentation.h"
+
+SegmentationCopies::SegmentationCopies(const dd4hep::Segmentation& aSegmentation) : m_original(aSegmentation) {}
+
+SegmentationCopies::~SegmentationCopies() {
+  for (auto& copy : m_copies) {
+    if (copy.isValid()) {
+      dd4hep::destroyHandle(copy);
+    }
+  }
+}
+
+const dd4hep::DDSegmentation::Segmentation& SegmentationCopies::local() const {
+  dd4hep::Segmentation& copy = m_copies.local();
+  if (!copy.isValid()) {
+    copy = dd4hep::Segmentation(m_original.type(), m_original.name(), m_original.decoder());
+    copy.segmentation()->setParameters(m_original.segmentation()->parameters());
+  }
+  return *copy.segmentation();
+}
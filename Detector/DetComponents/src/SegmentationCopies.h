@@ -0,0 +1,40 @@
+#ifndef DETCOMPONENTS_SEGMENTATIONCOPIES_H
+#define DETCOMPONENTS_SEGMENTATIONCOPIES_H
+
+// DD4hep
+#include "DD4hep/Segmentations.h"
+
+// TBB
+#include "tbb/enumerable_thread_specific.h"
+
+/** @class SegmentationCopies Detector/DetComponents/src/SegmentationCopies.h SegmentationCopies.h
+ *
+ *  Copies of a segmentation, one for each thread that uses it.
+ *  The cellID() of a segmentation is not guaranteed to be safe when called concurrently, so the hits processed in
+ *  parallel use the copy of their thread. Each copy is created at the first use, with the type, bitfield and
+ *  parameters of the segmentation of the readout, and deleted with this object.
+ */
+
+class SegmentationCopies {
+public:
+  /**  Constructor.
+   *   @param[in] aSegmentation segmentation to copy (owned by the detector description)
+   */
+  explicit SegmentationCopies(const dd4hep::Segmentation& aSegmentation);
+  ~SegmentationCopies();
+  SegmentationCopies(const SegmentationCopies&) = delete;
+  SegmentationCopies& operator=(const SegmentationCopies&) = delete;
+  /**  Get the copy of the calling thread.
+   *   @return segmentation of the current thread
+   */
+  const dd4hep::DDSegmentation::Segmentation& local() const;
+  /// Segmentation of the readout (not to be used concurrently)
+  const dd4hep::DDSegmentation::Segmentation& original() const { return *m_original.segmentation(); }
+
+private:
+  /// Segmentation of the readout
+  dd4hep::Segmentation m_original;
+  /// Copies of the segmentation, created at the first use by each thread
+  mutable tbb::enumerable_thread_specific<dd4hep::Segmentation> m_copies;
+};
+#endif /* DETCOMPONENTS_SEGMENTATIONCOPIES_H */
@@ -0,0 +1,231 @@
+#include "SolidOptimisation.h"
+
+// DD4hep
+#include "DD4hep/Printout.h"
+
+// Geant4
+#include "G4AffineTransform.hh"
+#include "G4DisplacedSolid.hh"
+#include "G4GeomConfig.hh"
+#include "G4IntersectionSolid.hh"
+#include "G4LogicalVolume.hh"
+#include "G4MultiUnion.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SubtractionSolid.hh"
+#include "G4UnionSolid.hh"
+#include "G4VPhysicalVolume.hh"
+
+// STL
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+
+namespace {
+/// Solids of a union with their placements in its frame
+using UnionNodes = std::vector<std::pair<G4VSolid*, G4Transform3D>>;
+
+/// Types of the solids that are timed if not replaced
+const std::set<std::string> heavyTypes{"G4Polycone", "G4GenericPolycone", "G4Polyhedra", "G4ExtrudedSolid",
+                                       "G4TessellatedSolid", "G4UnionSolid", "G4SubtractionSolid",
+                                       "G4IntersectionSolid"};
+
+/// Placement of the moved solid in the frame of the displaced solid
+G4Transform3D directTransform(const G4DisplacedSolid& aSolid) {
+  const G4AffineTransform direct = aSolid.GetDirectTransform();
+  return G4Transform3D(direct.NetRotation().inverse(), direct.NetTranslation());
+}
+
+/// Collect the solids of a tree of unions (and of the displaced solids in it)
+void collectUnion(G4VSolid* aSolid, const G4Transform3D& aTransform, UnionNodes& aNodes) {
+  if (auto unionSolid = dynamic_cast<G4UnionSolid*>(aSolid)) {
+    collectUnion(unionSolid->GetConstituentSolid(0), aTransform, aNodes);
+    collectUnion(unionSolid->GetConstituentSolid(1), aTransform, aNodes);
+  } else if (auto displaced = dynamic_cast<G4DisplacedSolid*>(aSolid)) {
+    collectUnion(displaced->GetConstituentMovedSolid(), aTransform * directTransform(*displaced), aNodes);
+  } else {
+    aNodes.emplace_back(aSolid, aTransform);
+  }
+}
+
+/// Replaces the solids, each solid once also if shared by several volumes
+class Optimiser {
+public:
+  explicit Optimiser(unsigned int aMinUnionNodes) : m_minUnionNodes(aMinUnionNodes) {}
+  /// Solid replacing the solid (the solid itself if it is not replaced)
+  G4VSolid* optimise(G4VSolid* aSolid) {
+    auto replaced = m_replaced.find(aSolid);
+    if (replaced != m_replaced.end()) {
+      return replaced->second;
+    }
+    G4VSolid* result = aSolid;
+    if (dynamic_cast<G4UnionSolid*>(aSolid) != nullptr) {
+      UnionNodes nodes;
+      collectUnion(aSolid, G4Transform3D(), nodes);
+      if (nodes.size() >= m_minUnionNodes) {
+        auto multiUnion = new G4MultiUnion(aSolid->GetName() + "_multiunion");
+        for (auto& node : nodes) {
+          multiUnion->AddNode(*optimise(node.first), node.second);
+        }
+        multiUnion->Voxelize();
+        result = multiUnion;
+        ++numUnions;
+        numUnionNodes += nodes.size();
+      }
+    } else if (auto boolean = dynamic_cast<G4BooleanSolid*>(aSolid)) {
+      // subtractions and intersections are kept, with their constituents replaced
+      G4VSolid* first = optimise(boolean->GetConstituentSolid(0));
+      G4VSolid* second = optimise(boolean->GetConstituentSolid(1));
+      if (first != boolean->GetConstituentSolid(0) || second != boolean->GetConstituentSolid(1)) {
+        if (dynamic_cast<G4SubtractionSolid*>(aSolid) != nullptr) {
+          result = new G4SubtractionSolid(aSolid->GetName(), first, second);
+        } else if (dynamic_cast<G4IntersectionSolid*>(aSolid) != nullptr) {
+          result = new G4IntersectionSolid(aSolid->GetName(), first, second);
+        }
+      }
+    } else if (auto displaced = dynamic_cast<G4DisplacedSolid*>(aSolid)) {
+      G4VSolid* moved = optimise(displaced->GetConstituentMovedSolid());
+      if (moved != displaced->GetConstituentMovedSolid()) {
+        result = new G4DisplacedSolid(aSolid->GetName(), moved, displaced->GetDirectTransform());
+      }
+    }
+    m_replaced.emplace(aSolid, result);
+    return result;
+  }
+  /// Number of unions replaced by a G4MultiUnion, and of their solids
+  unsigned int numUnions = 0;
+  unsigned int numUnionNodes = 0;
+
+private:
+  /// Minimum number of solids of a replaced union
+  unsigned int m_minUnionNodes;
+  /// Replacement of the visited solids
+  std::map<G4VSolid*, G4VSolid*> m_replaced;
+};
+
+/// Random points in the bounding box of a solid (enlarged by 10%), with random directions
+struct TimingPoints {
+  TimingPoints(const G4VSolid& aSolid, unsigned int aNumPoints, unsigned int aSeed) {
+    G4ThreeVector pMin, pMax;
+    aSolid.BoundingLimits(pMin, pMax);
+    const G4ThreeVector margin = 0.1 * (pMax - pMin);
+    pMin -= margin;
+    pMax += margin;
+    std::mt19937 generator(aSeed);
+    std::uniform_real_distribution<double> flat(0, 1);
+    for (unsigned int iPoint = 0; iPoint < aNumPoints; ++iPoint) {
+      positions.emplace_back(pMin.x() + flat(generator) * (pMax.x() - pMin.x()),
+                             pMin.y() + flat(generator) * (pMax.y() - pMin.y()),
+                             pMin.z() + flat(generator) * (pMax.z() - pMin.z()));
+      const double cosTheta = 2 * flat(generator) - 1;
+      const double phi = CLHEP::twopi * flat(generator);
+      const double sinTheta = std::sqrt(1 - cosTheta * cosTheta);
+      directions.emplace_back(sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta);
+    }
+  }
+  std::vector<G4ThreeVector> positions;
+  std::vector<G4ThreeVector> directions;
+};
+
+/// Time per point [ns] of Inside and of DistanceToIn or DistanceToOut (depending on the location of the point)
+double navigationTime(const G4VSolid& aSolid, const TimingPoints& aPoints) {
+  double distances = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t iPoint = 0; iPoint < aPoints.positions.size(); ++iPoint) {
+    const G4ThreeVector& position = aPoints.positions[iPoint];
+    const EInside inside = aSolid.Inside(position);
+    if (inside == kOutside) {
+      distances += aSolid.DistanceToIn(position, aPoints.directions[iPoint]);
+    } else if (inside == kInside) {
+      distances += aSolid.DistanceToOut(position, aPoints.directions[iPoint]);
+    }
+  }
+  const double time = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  // the distances are used, so that the calls are not optimised away
+  return distances >= 0 ? time / std::max<size_t>(aPoints.positions.size(), 1) : 0;
+}
+
+/// Collect the logical volumes of the tree
+void collectVolumes(G4LogicalVolume* aVolume, std::set<G4LogicalVolume*>& aVolumes) {
+  if (!aVolumes.insert(aVolume).second) return;
+  for (size_t iDaughter = 0; iDaughter < aVolume->GetNoDaughters(); ++iDaughter) {
+    collectVolumes(aVolume->GetDaughter(iDaughter)->GetLogicalVolume(), aVolumes);
+  }
+}
+}
+
+namespace det {
+void optimiseSolids(G4VPhysicalVolume* aWorld, const SolidOptimisation& aOptimisation) {
+#ifdef G4GEOM_USE_USOLIDS
+  dd4hep::printout(dd4hep::INFO, "SolidOptimisation", "Geant4 uses the VecGeom implementations of the solids");
+#else
+  dd4hep::printout(dd4hep::INFO, "SolidOptimisation",
+                   "Geant4 is built without VecGeom, the solids other than the unions keep their implementations");
+#endif
+  std::set<G4LogicalVolume*> volumes;
+  G4LogicalVolume* world = aWorld->GetLogicalVolume();
+  for (size_t iDaughter = 0; iDaughter < world->GetNoDaughters(); ++iDaughter) {
+    G4VPhysicalVolume* daughter = world->GetDaughter(iDaughter);
+    bool selected = aOptimisation.detectors.empty();
+    for (const auto& name : aOptimisation.detectors) {
+      selected |= daughter->GetName().find(name) != std::string::npos;
+    }
+    if (selected) {
+      collectVolumes(daughter->GetLogicalVolume(), volumes);
+    }
+  }
+  Optimiser optimiser(aOptimisation.minUnionNodes);
+  // timing per type of the solid before its replacement: number of solids, time before and after
+  struct Timing {
+    unsigned int numSolids = 0;
+    double before = 0;
+    double after = 0;
+  };
+  std::map<std::string, Timing> timings;
+  std::ofstream timingFile;
+  if (aOptimisation.timingPoints > 0 && !aOptimisation.timingFile.empty()) {
+    timingFile.open(aOptimisation.timingFile);
+    timingFile << "solid,type,replacement,ns_before,ns_after\n";
+  }
+  std::set<G4VSolid*> timed;
+  unsigned int numVolumes = 0;
+  for (G4LogicalVolume* volume : volumes) {
+    G4VSolid* solid = volume->GetSolid();
+    G4VSolid* replacement = optimiser.optimise(solid);
+    if (replacement != solid) {
+      volume->SetSolid(replacement);
+      ++numVolumes;
+    }
+    const std::string type = solid->GetEntityType();
+    if (aOptimisation.timingPoints == 0 || !timed.insert(solid).second ||
+        (replacement == solid && heavyTypes.count(type) == 0)) {
+      continue;
+    }
+    // same points in every job, whatever the order of the volumes
+    const TimingPoints points(*solid, aOptimisation.timingPoints, std::hash<std::string>()(solid->GetName()));
+    const double before = navigationTime(*solid, points);
+    const double after = replacement == solid ? before : navigationTime(*replacement, points);
+    Timing& timing = timings[type];
+    ++timing.numSolids;
+    timing.before += before;
+    timing.after += after;
+    if (timingFile.is_open()) {
+      timingFile << solid->GetName() << "," << type << "," << replacement->GetEntityType() << "," << before << ","
+                 << after << "\n";
+    }
+  }
+  dd4hep::printout(dd4hep::INFO, "SolidOptimisation",
+                   "Replaced %u unions of %u solids by G4MultiUnion, in %u of %zu logical volumes", optimiser.numUnions,
+                   optimiser.numUnionNodes, numVolumes, volumes.size());
+  for (const auto& timing : timings) {
+    dd4hep::printout(dd4hep::INFO, "SolidOptimisation", "%-20s %6u solids, mean navigation time %10.1f ns -> %10.1f ns",
+                     timing.first.c_str(), timing.second.numSolids, timing.second.before / timing.second.numSolids,
+                     timing.second.after / timing.second.numSolids);
+  }
+}
+}
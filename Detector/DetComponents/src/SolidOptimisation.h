@@ -0,0 +1,44 @@
+#ifndef DETCOMPONENTS_SOLIDOPTIMISATION_H
+#define DETCOMPONENTS_SOLIDOPTIMISATION_H
+
+// STL
+#include <string>
+#include <vector>
+
+class G4VPhysicalVolume;
+
+/** SolidOptimisation Detector/DetComponents/src/SolidOptimisation.h SolidOptimisation.h
+ *
+ *  Replacement of the converted Geant4 solids by implementations that are faster to navigate, applied to the
+ *  logical volumes of the selected sub-detectors once the geometry is converted (or read from the cache):
+ *  the trees of boolean unions of at least minUnionNodes solids (e.g. the absorbers of a calorimeter built from
+ *  many pieces) become one voxelised G4MultiUnion, also when they are constituents of subtractions or
+ *  intersections. Whether Geant4 uses the vectorised VecGeom implementations of the specific solids (polycones,
+ *  polyhedra, extruded solids...) is decided when Geant4 is built (G4GEOM_USE_USOLIDS), it is reported.
+ *  If timingPoints is set, the time of Inside, DistanceToIn and DistanceToOut of the heavy solids (the replaced
+ *  ones, polycones, polyhedra, extruded and boolean solids) is measured before and after the replacement on the same
+ *  random points of their bounding box, and reported per solid type (and written to timingFile, if set).
+ */
+
+namespace det {
+struct SolidOptimisation {
+  /// Flag whether the solids are replaced
+  bool enabled = false;
+  /// Names of the sub-detectors (placements in the world) whose solids are replaced (all if empty)
+  std::vector<std::string> detectors;
+  /// Minimum number of solids of a union replaced by a G4MultiUnion
+  unsigned int minUnionNodes = 3;
+  /// Number of points at which the navigation functions of each solid are timed (no timing if 0)
+  unsigned int timingPoints = 0;
+  /// CSV file of the timing (not written if empty)
+  std::string timingFile;
+};
+
+/** Replace the solids of the selected sub-detectors and report the navigation time.
+ *  @param[in] aWorld world volume of the Geant4 geometry
+ *  @param[in] aOptimisation configuration of the replacement
+ */
+void optimiseSolids(G4VPhysicalVolume* aWorld, const SolidOptimisation& aOptimisation);
+}
+
+#endif /* DETCOMPONENTS_SOLIDOPTIMISATION_H */
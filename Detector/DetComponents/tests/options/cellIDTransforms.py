@@ -0,0 +1,61 @@
+### Job of the test of the cellID transformations (tests/scripts/cellIDTransforms.py): the cells of the ECAL hits are
+### merged in layers and in eta by MergeCells run twice (one copy of the hits per transformation), by the single pass
+### of CellIDTransformPipeline (with and without the aggregation of the cells) and by MergeCellsTransformer, and the
+### results are compared event by event. The output file is given by TRANSFORMS_FILE.
+
+import os
+from Gaudi.Configuration import *
+
+from Configurables import GeoSvc
+geoservice = GeoSvc("GeoSvc", detectors=['file:Detector/DetFCChhBaseline1/compact/FCChh_DectEmptyMaster.xml',
+                                         'file:Detector/DetFCChhECalInclined/compact/FCChh_ECalBarrel_withCryostat.xml'])
+
+from Configurables import SimG4Svc
+geantservice = SimG4Svc("SimG4Svc", detector='SimG4DD4hepDetector', physicslist="SimG4FtfpBert",
+                        actions="SimG4FullSimActions")
+
+from Configurables import SimG4Alg, SimG4SaveCalHits, SimG4SingleParticleGeneratorTool
+pgun = SimG4SingleParticleGeneratorTool("SimG4SingleParticleGeneratorTool", particleName="e-",
+                                        energyMin=20000, energyMax=20000, etaMin=-0.5, etaMax=0.5)
+savecaltool = SimG4SaveCalHits("saveECalHits", readoutNames = ["ECalBarrelEta"])
+savecaltool.CaloHits.Path = "ECalSimHits"
+geantsim = SimG4Alg("SimG4Alg", outputs= ["SimG4SaveCalHits/saveECalHits"], eventProvider=pgun)
+
+# input of the transformations
+from Configurables import CopySimCaloHits
+copy = CopySimCaloHits("copyHits")
+copy.inhits.Path = "ECalSimHits"
+copy.outhits.Path = "ECalHits"
+
+# the same transformations as separate passes, in a single pass, and as functional algorithms
+transformations = [("layer", 2), ("eta", 3)]
+from Configurables import MergeCells, MergeCellsTransformer, CellIDTransformPipeline
+mergeAlgorithms = []
+for algorithmType, prefix in ((MergeCells, "Merged"), (MergeCellsTransformer, "Transformed")):
+    inputHits = "ECalHits"
+    for identifier, numCells in transformations:
+        merge = algorithmType("%s_%s" % (prefix, identifier), readout = "ECalBarrelEta", identifier = identifier,
+                              merge = numCells)
+        merge.inhits.Path = inputHits
+        inputHits = "%sECalHits_%s" % (prefix, identifier)
+        merge.outhits.Path = inputHits
+        mergeAlgorithms.append(merge)
+specs = ["mergeCells:%s:%d" % transformation for transformation in transformations]
+pipeline = CellIDTransformPipeline("pipeline", readout = "ECalBarrelEta", transformations = specs)
+pipeline.inhits.Path = "ECalHits"
+pipeline.outhits.Path = "PipelineECalHits"
+aggregatingPipeline = CellIDTransformPipeline("aggregatingPipeline", readout = "ECalBarrelEta",
+                                              transformations = specs, aggregate = True)
+aggregatingPipeline.inhits.Path = "ECalHits"
+aggregatingPipeline.outhits.Path = "PipelineECalCells"
+
+from Configurables import FCCDataSvc, PodioOutput
+podiosvc = FCCDataSvc("EventDataSvc")
+out = PodioOutput("out", filename = os.environ.get("TRANSFORMS_FILE", "test_cellIDTransforms.root"))
+out.outputCommands = ["keep *"]
+
+ApplicationMgr(EvtSel='NONE',
+               EvtMax=10,
+               TopAlg=[geantsim, copy] + mergeAlgorithms + [pipeline, aggregatingPipeline, out],
+               ExtSvc = [podiosvc, geoservice, geantservice],
+               OutputLevel=WARNING)
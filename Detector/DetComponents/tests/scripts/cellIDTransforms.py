@@ -0,0 +1,59 @@
+# Test of the cellID transformations: runs the job of tests/options/cellIDTransforms.py and checks, event by event,
+# that the cells merged by the separate passes of MergeCells, by CellIDTransformPipeline and by MergeCellsTransformer
+# are the same, and that the aggregated cells of the pipeline hold the summed energy of their hits (PyROOT needed).
+import argparse
+import math
+import os
+import subprocess
+import sys
+
+import ROOT
+
+
+def deposits(hits):
+    """Sorted cellIDs and energies of the hits"""
+    return sorted((hit.cellID, hit.energy) for hit in hits)
+
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--options", default="Detector/DetComponents/tests/options/cellIDTransforms.py")
+parser.add_argument("--output", default="test_cellIDTransforms.root")
+args = parser.parse_args()
+
+if subprocess.call(["k4run", args.options], env=dict(os.environ, TRANSFORMS_FILE=args.output)) != 0:
+    sys.exit("Job of the cellID transformations failed")
+ROOT.gSystem.Load("libedm4hepDict")
+
+rootFile = ROOT.TFile.Open(args.output)
+tree = rootFile.Get("events") if rootFile else None
+if not tree:
+    sys.exit("No events in %s" % args.output)
+numEvents = 0
+numHits = 0
+numChanged = 0
+for iEvent, event in enumerate(tree):
+    numEvents += 1
+    numHits += event.ECalHits.size()
+    # the transformations change the cellIDs only, hit by hit
+    assert [hit.energy for hit in event.PipelineECalHits] == [hit.energy for hit in event.ECalHits], \
+        "Hits of the pipeline of event %d are not the input hits" % iEvent
+    numChanged += sum(1 for hit, inputHit in zip(event.PipelineECalHits, event.ECalHits)
+                      if hit.cellID != inputHit.cellID)
+    merged = deposits(event.MergedECalHits_eta)
+    assert deposits(event.PipelineECalHits) == merged, \
+        "Cells of the pipeline of event %d differ from the cells of the separate passes" % iEvent
+    assert deposits(event.TransformedECalHits_eta) == merged, \
+        "Cells of the functional algorithms of event %d differ from the cells of the separate passes" % iEvent
+    cells = {}
+    for cellID, energy in merged:
+        cells[cellID] = cells.get(cellID, 0.) + energy
+    aggregated = deposits(event.PipelineECalCells)
+    assert [cellID for cellID, _ in aggregated] == sorted(cells), \
+        "Aggregated cells of event %d are not the merged cells" % iEvent
+    assert all(math.isclose(energy, cells[cellID], rel_tol=1e-5) for cellID, energy in aggregated), \
+        "Energies of the aggregated cells of event %d are not the sums of their hits" % iEvent
+
+print("Compared the transformed cellIDs of %d events (%d hits, %d cellIDs changed)" % (numEvents, numHits,
+                                                                                       numChanged))
+assert numEvents == 10, "Output has %d events instead of 10" % numEvents
+assert numChanged > 0, "Transformations did not change any cellID"
@@ -0,0 +1,26 @@
+#include "CopySimCaloHits.h"
+
+// datamodel
+#include "edm4hep/CalorimeterHitCollection.h"
+#include "edm4hep/SimCalorimeterHitCollection.h"
+
+DECLARE_COMPONENT(CopySimCaloHits)
+
+CopySimCaloHits::CopySimCaloHits(const std::string& aName, ISvcLocator* aSvcLoc) : GaudiAlgorithm(aName, aSvcLoc) {
+  declareProperty("inhits", m_inHits, "Simulated hit collection to copy (input)");
+  declareProperty("outhits", m_outHits, "Calorimeter hit collection (output)");
+}
+
+CopySimCaloHits::~CopySimCaloHits() {}
+
+StatusCode CopySimCaloHits::execute() {
+  const auto inHits = m_inHits.get();
+  auto outHits = m_outHits.createAndPut();
+  for (const auto& inHit : *inHits) {
+    auto outHit = outHits->create();
+    outHit.setCellID(inHit.getCellID());
+    outHit.setEnergy(inHit.getEnergy());
+    outHit.setPosition(inHit.getPosition());
+  }
+  return StatusCode::SUCCESS;
+}
@@ -0,0 +1,39 @@
+#ifndef DETCOMPONENTS_TESTS_COPYSIMCALOHITS_H
+#define DETCOMPONENTS_TESTS_COPYSIMCALOHITS_H
+
+// GAUDI
+#include "GaudiAlg/GaudiAlgorithm.h"
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+
+// datamodel
+namespace edm4hep {
+class CalorimeterHitCollection;
+class SimCalorimeterHitCollection;
+}
+
+/** @class CopySimCaloHits Detector/DetComponents/tests/src/CopySimCaloHits.h CopySimCaloHits.h
+ *
+ *  Copy the simulated calorimeter hits (cellID, energy and position) to calorimeter hits, the input of the cellID
+ *  transformations, in the tests of the transformations (the calorimeter hits are otherwise created by the
+ *  reconstruction, outside of the simulation).
+ *  For an example see Detector/DetComponents/tests/options/cellIDTransforms.py
+ */
+
+class CopySimCaloHits : public GaudiAlgorithm {
+public:
+  explicit CopySimCaloHits(const std::string&, ISvcLocator*);
+  virtual ~CopySimCaloHits();
+  /**  Execute.
+   *   @return status code
+   */
+  virtual StatusCode execute() final;
+
+private:
+  /// Handle for the simulated hits to be read
+  DataHandle<edm4hep::SimCalorimeterHitCollection> m_inHits{"hits/caloSimHits", Gaudi::DataHandle::Reader, this};
+  /// Handle for the calorimeter hits to be written
+  DataHandle<edm4hep::CalorimeterHitCollection> m_outHits{"hits/caloHits", Gaudi::DataHandle::Writer, this};
+};
+#endif /* DETCOMPONENTS_TESTS_COPYSIMCALOHITS_H */
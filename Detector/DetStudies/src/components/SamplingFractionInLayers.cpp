@@ -8,6 +8,7 @@
 
 #include "CLHEP/Vector/ThreeVector.h"
 #include "GaudiKernel/ITHistSvc.h"
+#include "GaudiKernel/ThreadLocalContext.h"
 #include "TH1F.h"
 #include "TVector2.h"
 
@@ -15,15 +16,15 @@
 #include "DD4hep/Detector.h"
 #include "DD4hep/Readout.h"
 
+// STL
+#include <algorithm>
+
 DECLARE_COMPONENT(SamplingFractionInLayers)
 
 SamplingFractionInLayers::SamplingFractionInLayers(const std::string& aName, ISvcLocator* aSvcLoc)
     : GaudiAlgorithm(aName, aSvcLoc),
       m_histSvc("THistSvc", "SamplingFractionInLayers"),
-      m_geoSvc("GeoSvc", "SamplingFractionInLayers"),
-      m_totalEnergy(nullptr),
-      m_totalActiveEnergy(nullptr),
-      m_sf(nullptr) {
+      m_geoSvc("GeoSvc", "SamplingFractionInLayers") {
   declareProperty("deposits", m_deposits, "Energy deposits in sampling calorimeter (input)");
 }
 SamplingFractionInLayers::~SamplingFractionInLayers() {}
@@ -37,89 +38,130 @@ StatusCode SamplingFractionInLayers::initialize() {
     error() << "Readout <<" << m_readoutName << ">> does not exist." << endmsg;
     return StatusCode::FAILURE;
   }
+  // decoder and fields are taken once, the readout does not change during the job
+  m_decoder = m_geoSvc->lcdd()->readout(m_readoutName).idSpec().decoder();
+  try {
+    m_layerField = m_decoder->index(m_layerFieldName);
+    m_activeField = m_decoder->index(m_activeFieldName);
+    if (!m_systemValues.empty()) {
+      m_systemField = m_decoder->index(m_systemFieldName);
+    }
+  } catch (const std::exception& e) {
+    error() << "Readout <<" << m_readoutName << ">> does not contain the field: " << e.what() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_numPoints == 0 || m_eventsPerPoint == 0) {
+    error() << "Number of points of the scan and of events per point need to be positive" << endmsg;
+    return StatusCode::FAILURE;
+  }
   // create histograms
-  for (uint i = 0; i < m_numLayers; i++) {
-    m_totalEnLayers.push_back(new TH1F(("ecal_totalEnergy_layer" + std::to_string(i)).c_str(),
-                                       ("Total deposited energy in layer " + std::to_string(i)).c_str(), 1000, 0,
-                                       1.2 * m_energy));
-    if (m_histSvc->regHist("/rec/ecal_total_layer" + std::to_string(i), m_totalEnLayers.back()).isFailure()) {
-      error() << "Couldn't register histogram" << endmsg;
-      return StatusCode::FAILURE;
+  m_numDetectors = std::max<size_t>(1, m_systemValues.size());
+  m_histograms.clear();
+  m_histograms.resize(m_numPoints * m_numDetectors);
+  for (uint iPoint = 0; iPoint < m_numPoints; ++iPoint) {
+    const std::string pointSuffix = m_numPoints > 1 ? "_point" + std::to_string(iPoint) : "";
+    for (size_t iSystem = 0; iSystem < m_numDetectors; ++iSystem) {
+      const std::string systemSuffix =
+          m_systemValues.empty() ? "" : "_system" + std::to_string(m_systemValues.value()[iSystem]);
+      if (bookHistograms(systemSuffix + pointSuffix, m_histograms[iPoint * m_numDetectors + iSystem]).isFailure()) {
+        return StatusCode::FAILURE;
+      }
     }
-    m_activeEnLayers.push_back(new TH1F(("ecal_activeEnergy_layer" + std::to_string(i)).c_str(),
-                                        ("Deposited energy in active material, in layer " + std::to_string(i)).c_str(),
-                                        1000, 0, 1.2 * m_energy));
-    if (m_histSvc->regHist("/rec/ecal_active_layer" + std::to_string(i), m_activeEnLayers.back()).isFailure()) {
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SamplingFractionInLayers::bookHistograms(const std::string& aSuffix, Histograms& aHistograms) {
+  auto book = [this, &aSuffix](const std::string& aName, const std::string& aTitle, double aMax,
+                               const std::string& aPath) -> TH1F* {
+    TH1F* hist = new TH1F((aName + aSuffix).c_str(), aTitle.c_str(), 1000, 0, aMax);
+    if (m_histSvc->regHist(aPath + aSuffix, hist).isFailure()) {
       error() << "Couldn't register histogram" << endmsg;
-      return StatusCode::FAILURE;
+      return nullptr;
     }
-    m_sfLayers.push_back(new TH1F(("ecal_sf_layer" + std::to_string(i)).c_str(),
-                                  ("SF for layer " + std::to_string(i)).c_str(), 1000, 0, 1));
-    if (m_histSvc->regHist("/rec/ecal_sf_layer" + std::to_string(i), m_sfLayers.back()).isFailure()) {
-      error() << "Couldn't register histogram" << endmsg;
+    return hist;
+  };
+  for (uint i = 0; i < m_numLayers; i++) {
+    aHistograms.totalEnLayers.push_back(book("ecal_totalEnergy_layer" + std::to_string(i),
+                                             "Total deposited energy in layer " + std::to_string(i), 1.2 * m_energy,
+                                             "/rec/ecal_total_layer" + std::to_string(i)));
+    aHistograms.activeEnLayers.push_back(book("ecal_activeEnergy_layer" + std::to_string(i),
+                                              "Deposited energy in active material, in layer " + std::to_string(i),
+                                              1.2 * m_energy, "/rec/ecal_active_layer" + std::to_string(i)));
+    aHistograms.sfLayers.push_back(book("ecal_sf_layer" + std::to_string(i), "SF for layer " + std::to_string(i), 1,
+                                        "/rec/ecal_sf_layer" + std::to_string(i)));
+    if (aHistograms.totalEnLayers.back() == nullptr || aHistograms.activeEnLayers.back() == nullptr ||
+        aHistograms.sfLayers.back() == nullptr) {
       return StatusCode::FAILURE;
     }
   }
-  m_totalEnergy = new TH1F("ecal_totalEnergy", "Total deposited energy", 1000, 0, 1.2 * m_energy);
-  if (m_histSvc->regHist("/rec/ecal_total", m_totalEnergy).isFailure()) {
-    error() << "Couldn't register histogram" << endmsg;
-    return StatusCode::FAILURE;
-  }
-  m_totalActiveEnergy = new TH1F("ecal_active", "Deposited energy in active material", 1000, 0, 1.2 * m_energy);
-  if (m_histSvc->regHist("/rec/ecal_active", m_totalActiveEnergy).isFailure()) {
-    error() << "Couldn't register histogram" << endmsg;
-    return StatusCode::FAILURE;
-  }
-  m_sf = new TH1F("ecal_sf", "Sampling fraction", 1000, 0, 1);
-  if (m_histSvc->regHist("/rec/ecal_sf", m_sf).isFailure()) {
-    error() << "Couldn't register histogram" << endmsg;
+  aHistograms.totalEnergy = book("ecal_totalEnergy", "Total deposited energy", 1.2 * m_energy, "/rec/ecal_total");
+  aHistograms.totalActiveEnergy =
+      book("ecal_active", "Deposited energy in active material", 1.2 * m_energy, "/rec/ecal_active");
+  aHistograms.sf = book("ecal_sf", "Sampling fraction", 1, "/rec/ecal_sf");
+  if (aHistograms.totalEnergy == nullptr || aHistograms.totalActiveEnergy == nullptr || aHistograms.sf == nullptr) {
     return StatusCode::FAILURE;
   }
   return StatusCode::SUCCESS;
 }
 
 StatusCode SamplingFractionInLayers::execute() {
-  auto decoder = m_geoSvc->lcdd()->readout(m_readoutName).idSpec().decoder();
-  double sumE = 0.;
-  std::vector<double> sumElayers;
-  double sumEactive = 0.;
-  std::vector<double> sumEactiveLayers;
-  sumElayers.assign(m_numLayers, 0);
-  sumEactiveLayers.assign(m_numLayers, 0);
+  const size_t numDetectors = m_numDetectors;
+  // histograms of the point of the scan of this event
+  const size_t point = (Gaudi::Hive::currentContext().evt() / m_eventsPerPoint) % m_numPoints;
+  Histograms* pointHistograms = &m_histograms[point * numDetectors];
+  std::vector<double> sumE(numDetectors, 0);
+  std::vector<double> sumElayers(numDetectors * m_numLayers, 0);
+  std::vector<double> sumEactive(numDetectors, 0);
+  std::vector<double> sumEactiveLayers(numDetectors * m_numLayers, 0);
+  const auto& layerField = (*m_decoder)[m_layerField];
+  const auto& activeField = (*m_decoder)[m_activeField];
+  const auto& systemField = (*m_decoder)[m_systemField];
 
   const auto deposits = m_deposits.get();
   for (const auto& hit : *deposits) {
     dd4hep::DDSegmentation::CellID cID = hit.getCellID();
-    auto id = decoder->get(cID, m_layerFieldName);
-    sumElayers[id] += hit.getEnergy();
+    size_t iDetector = 0;
+    if (!m_systemValues.empty()) {
+      auto itSystem = std::find(m_systemValues.value().begin(), m_systemValues.value().end(), systemField.value(cID));
+      if (itSystem == m_systemValues.end()) {
+        continue;
+      }
+      iDetector = itSystem - m_systemValues.value().begin();
+    }
+    uint id = layerField.value(cID);
+    sumElayers[iDetector * m_numLayers + id] += hit.getEnergy();
     // check if energy was deposited in the calorimeter (active/passive material)
     if (id >= m_firstLayerId) {
-      sumE += hit.getEnergy();
+      sumE[iDetector] += hit.getEnergy();
       // active material of calorimeter
-      auto activeField = decoder->get(cID, m_activeFieldName);
-      if (activeField == m_activeFieldValue) {
-        sumEactive += hit.getEnergy();
-        sumEactiveLayers[id] += hit.getEnergy();
+      if (activeField.value(cID) == m_activeFieldValue) {
+        sumEactive[iDetector] += hit.getEnergy();
+        sumEactiveLayers[iDetector * m_numLayers + id] += hit.getEnergy();
       }
     }
   }
   // Fill histograms
-  m_totalEnergy->Fill(sumE);
-  m_totalActiveEnergy->Fill(sumEactive);
-  if (sumE > 0) {
-    m_sf->Fill(sumEactive / sumE);
-  }
-  for (uint i = 0; i < m_numLayers; i++) {
-    m_totalEnLayers[i]->Fill(sumElayers[i]);
-    m_activeEnLayers[i]->Fill(sumEactiveLayers[i]);
-    if (i < m_firstLayerId) {
-      debug() << "total energy deposited outside the calorimeter detector = " << sumElayers[i] << endmsg;
-    } else {
-      debug() << "total energy in layer " << i << " = " << sumElayers[i] << " active = " << sumEactiveLayers[i]
-              << endmsg;
+  for (size_t iDetector = 0; iDetector < numDetectors; ++iDetector) {
+    Histograms& histograms = pointHistograms[iDetector];
+    histograms.totalEnergy->Fill(sumE[iDetector]);
+    histograms.totalActiveEnergy->Fill(sumEactive[iDetector]);
+    if (sumE[iDetector] > 0) {
+      histograms.sf->Fill(sumEactive[iDetector] / sumE[iDetector]);
     }
-    if (sumElayers[i] > 0) {
-      m_sfLayers[i]->Fill(sumEactiveLayers[i] / sumElayers[i]);
+    for (uint i = 0; i < m_numLayers; i++) {
+      const double total = sumElayers[iDetector * m_numLayers + i];
+      const double active = sumEactiveLayers[iDetector * m_numLayers + i];
+      histograms.totalEnLayers[i]->Fill(total);
+      histograms.activeEnLayers[i]->Fill(active);
+      if (i < m_firstLayerId) {
+        debug() << "total energy deposited outside the calorimeter detector = " << total << endmsg;
+      } else {
+        debug() << "total energy in layer " << i << " = " << total << " active = " << active << endmsg;
+      }
+      if (total > 0) {
+        histograms.sfLayers[i]->Fill(active / total);
+      }
     }
   }
   return StatusCode::SUCCESS;
@@ -9,6 +9,9 @@
 #include "k4FWCore/DataHandle.h"
 class IGeoSvc;
 
+// DD4hep
+#include "DDSegmentation/BitFieldCoder.h"
+
 // datamodel
 namespace edm4hep {
 class CalorimeterHitCollection;
@@ -22,6 +25,12 @@ class ITHistSvc;
  *  Passive material needs to be marked as sensitive. It needs to be divided into layers (cells) as active material.
  *  Sampling fraction is calculated for each layer as the ratio of energy deposited in active material to energy
  *  deposited in the layer (also in passive material).
+ *  Several detectors of the readout can be studied in a single pass over the deposits: if '\b systemValues' lists the
+ *  values of the field '\b systemFieldName', the histograms are filled for each of them (with the name suffixed by
+ *  "_system<value>").
+ *  In a scan of energies or eta points of SimG4SingleParticleGeneratorTool, '\b numPoints' and '\b eventsPerPoint'
+ *  give the scan of the generator, and the histograms are filled for each point (with the name suffixed by
+ *  "_point<index>", after the detector suffix).
  *
  *  @author Anna Zaborowska
  */
@@ -64,20 +73,49 @@ private:
   Gaudi::Property<std::string> m_readoutName{this, "readoutName", "", "Name of the detector readout"};
   // Maximum energy for the axis range
   Gaudi::Property<double> m_energy{this, "energyAxis", 500, "Maximum energy for axis range"};
-  // Histograms of total deposited energy within layer
-  // Layers are numbered starting at 1. Layer 0 includes total energy deposited in cryostat and bath (in front and
-  // behind calo)
-  std::vector<TH1F*> m_totalEnLayers;
-  // Histogram of total deposited energy in the calorimeter (in active and passive material, excluding cryostat and
-  // bath)
-  TH1F* m_totalEnergy;
-  // Histograms of energy deposited in the active material within layer
-  std::vector<TH1F*> m_activeEnLayers;
-  // Histogram of energy deposited in the active material of the calorimeter
-  TH1F* m_totalActiveEnergy;
-  // Histograms of sampling fraction (active/total energy) calculated within layer
-  std::vector<TH1F*> m_sfLayers;
-  // Histogram of sampling fraction (active/total energy) calculated for the calorimeter (excluding cryostat and bath)
-  TH1F* m_sf;
+  /// Name of the field of the detector (if several detectors are studied)
+  Gaudi::Property<std::string> m_systemFieldName{this, "systemFieldName", "system", "Identifier of the detector"};
+  /// Values of the field of the detectors to study (all deposits in one set of histograms if empty)
+  Gaudi::Property<std::vector<int>> m_systemValues{this, "systemValues", {}, "Values of identifier of the detectors"};
+  /// Number of points of the scan of the generator (one set of histograms for all events if 1)
+  Gaudi::Property<uint> m_numPoints{this, "numPoints", 1, "Number of points of the scan of the generator"};
+  /// Number of consecutive events generated at each point of the scan
+  Gaudi::Property<uint> m_eventsPerPoint{this, "eventsPerPoint", 1, "Number of events at each point of the scan"};
+  /// Histograms of one detector
+  struct Histograms {
+    // Histograms of total deposited energy within layer
+    // Layers are numbered starting at 1. Layer 0 includes total energy deposited in cryostat and bath (in front and
+    // behind calo)
+    std::vector<TH1F*> totalEnLayers;
+    // Histogram of total deposited energy in the calorimeter (in active and passive material, excluding cryostat and
+    // bath)
+    TH1F* totalEnergy = nullptr;
+    // Histograms of energy deposited in the active material within layer
+    std::vector<TH1F*> activeEnLayers;
+    // Histogram of energy deposited in the active material of the calorimeter
+    TH1F* totalActiveEnergy = nullptr;
+    // Histograms of sampling fraction (active/total energy) calculated within layer
+    std::vector<TH1F*> sfLayers;
+    // Histogram of sampling fraction (active/total energy) calculated for the calorimeter (excluding cryostat and bath)
+    TH1F* sf = nullptr;
+  };
+  /**  Create and register the histograms of one detector.
+   *   @param[in] aSuffix suffix of the names of the histograms
+   *   @param[out] aHistograms histograms
+   *   @return status code
+   */
+  StatusCode bookHistograms(const std::string& aSuffix, Histograms& aHistograms);
+  /// Histograms of each point of the scan and detector (in the order of m_systemValues)
+  std::vector<Histograms> m_histograms;
+  /// Number of detectors
+  size_t m_numDetectors = 1;
+  /// Decoder of the readout
+  dd4hep::DDSegmentation::BitFieldCoder* m_decoder = nullptr;
+  /// Index of the layer field
+  size_t m_layerField = 0;
+  /// Index of the active field
+  size_t m_activeField = 0;
+  /// Index of the detector field
+  size_t m_systemField = 0;
 };
 #endif /* DETSTUDIES_SAMPLINGFRACTIONINLAYERS_H */
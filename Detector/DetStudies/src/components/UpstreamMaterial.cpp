@@ -8,6 +8,7 @@
 
 #include "CLHEP/Vector/ThreeVector.h"
 #include "GaudiKernel/ITHistSvc.h"
+#include "GaudiKernel/ThreadLocalContext.h"
 #include "TH1F.h"
 #include "TH2F.h"
 #include "TVector2.h"
@@ -37,35 +38,58 @@ StatusCode UpstreamMaterial::initialize() {
     error() << "Readout <<" << m_readoutName << ">> does not exist." << endmsg;
     return StatusCode::FAILURE;
   }
+  // decoder and fields are taken once, the readout does not change during the job
+  m_decoder = m_geoSvc->lcdd()->readout(m_readoutName).idSpec().decoder();
+  try {
+    m_cryoField = m_decoder->index("cryo");
+    m_layerField = m_decoder->index(m_layerFieldName);
+  } catch (const std::exception& e) {
+    error() << "Readout <<" << m_readoutName << ">> does not contain the field: " << e.what() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_samplingFraction.size() < m_numLayers) {
+    error() << "Sampling fraction needs to be given for each of the " << m_numLayers << " layers" << endmsg;
+    return StatusCode::FAILURE;
+  }
   m_histSvc = service("THistSvc");
   if (!m_histSvc) {
     error() << "Unable to locate Histogram Service" << endmsg;
     return StatusCode::FAILURE;
   }
-  for (uint i = 0; i < m_numLayers; i++) {
-    m_cellEnergyPhi.push_back(new TH1F(("upstreamEnergy_phi" + std::to_string(i)).c_str(),
-                                       ("Energy deposited in layer " + std::to_string(i)).c_str(), 1000, -m_phi,
-                                       m_phi));
-    if (m_histSvc->regHist("/det/upstreamEnergy_phi" + std::to_string(i), m_cellEnergyPhi.back()).isFailure()) {
-      error() << "Couldn't register histogram" << endmsg;
-      return StatusCode::FAILURE;
-    }
-    m_upstreamEnergyCellEnergy.push_back(
-        new TH2F(("upstreamEnergy_presamplerEnergy" + std::to_string(i)).c_str(),
-                 ("Upstream energy vs energy deposited in layer " + std::to_string(i)).c_str(), 4000, 0, m_energy, 4000,
-                 0, m_energy));
-    if (m_histSvc
-            ->regHist("/det/upstreamEnergy_presamplerEnergy" + std::to_string(i), m_upstreamEnergyCellEnergy.back())
-            .isFailure()) {
-      error() << "Couldn't register hist" << endmsg;
-      return StatusCode::FAILURE;
+  if (m_numPoints == 0 || m_eventsPerPoint == 0) {
+    error() << "Number of points of the scan and of events per point need to be positive" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_cellEnergyPhi.clear();
+  m_upstreamEnergyCellEnergy.clear();
+  for (uint iPoint = 0; iPoint < m_numPoints; ++iPoint) {
+    const std::string pointSuffix = m_numPoints > 1 ? "_point" + std::to_string(iPoint) : "";
+    for (uint i = 0; i < m_numLayers; i++) {
+      const std::string suffix = std::to_string(i) + pointSuffix;
+      m_cellEnergyPhi.push_back(new TH1F(("upstreamEnergy_phi" + suffix).c_str(),
+                                         ("Energy deposited in layer " + std::to_string(i)).c_str(), 1000, -m_phi,
+                                         m_phi));
+      if (m_histSvc->regHist("/det/upstreamEnergy_phi" + suffix, m_cellEnergyPhi.back()).isFailure()) {
+        error() << "Couldn't register histogram" << endmsg;
+        return StatusCode::FAILURE;
+      }
+      m_upstreamEnergyCellEnergy.push_back(
+          new TH2F(("upstreamEnergy_presamplerEnergy" + suffix).c_str(),
+                   ("Upstream energy vs energy deposited in layer " + std::to_string(i)).c_str(), 4000, 0, m_energy,
+                   4000, 0, m_energy));
+      if (m_histSvc->regHist("/det/upstreamEnergy_presamplerEnergy" + suffix, m_upstreamEnergyCellEnergy.back())
+              .isFailure()) {
+        error() << "Couldn't register hist" << endmsg;
+        return StatusCode::FAILURE;
+      }
     }
   }
   return StatusCode::SUCCESS;
 }
 
 StatusCode UpstreamMaterial::execute() {
-  auto decoder = m_geoSvc->lcdd()->readout(m_readoutName).idSpec().decoder();
+  const auto& cryoField = (*m_decoder)[m_cryoField];
+  const auto& layerField = (*m_decoder)[m_layerField];
   double sumEupstream = 0.;
   std::vector<double> sumEcells;
   sumEcells.assign(m_numLayers, 0);
@@ -82,19 +106,22 @@ StatusCode UpstreamMaterial::execute() {
   const auto deposits = m_deposits.get();
   for (const auto& hit : *deposits) {
     dd4hep::DDSegmentation::CellID cID = hit.getCellID();
-    const auto& field = "cryo";
-    int id = decoder->get(cID, field);
-    if (id == 0) {
-      sumEcells[id - m_firstLayerId] += hit.getEnergy();
+    if (cryoField.value(cID) == 0) {
+      int id = layerField.value(cID) - m_firstLayerId;
+      if (id >= 0 && id < int(m_numLayers)) {
+        sumEcells[id] += hit.getEnergy();
+      }
     } else {
       sumEupstream += hit.getEnergy();
     }
   }
+  // histograms of the point of the scan of this event
+  const size_t first = (Gaudi::Hive::currentContext().evt() / m_eventsPerPoint) % m_numPoints * m_numLayers;
   for (uint i = 0; i < m_numLayers; i++) {
     // calibrate the energy in the detector
     sumEcells[i] /= m_samplingFraction[i];
-    m_cellEnergyPhi[i]->Fill(phi, sumEcells[i]);
-    m_upstreamEnergyCellEnergy[i]->Fill(sumEcells[i], sumEupstream);
+    m_cellEnergyPhi[first + i]->Fill(phi, sumEcells[i]);
+    m_upstreamEnergyCellEnergy[first + i]->Fill(sumEcells[i], sumEupstream);
     verbose() << "Energy deposited in layer " << i << " = " << sumEcells[i]
               << "\t energy deposited in the cryostat = " << sumEupstream << endmsg;
   }
@@ -8,6 +8,9 @@
 #include "k4FWCore/DataHandle.h"
 class IGeoSvc;
 
+// DD4hep
+#include "DDSegmentation/BitFieldCoder.h"
+
 // datamodel
 namespace edm4hep {
 class CalorimeterHitCollection;
@@ -26,6 +29,9 @@ class ITHistSvc;
  * plotted.
  *  Dependence of the energy deposited in the dead material on the azimuthal angle of the incoming particle (MC truth)
  * is plotted.
+ *  In a scan of energies or eta points of SimG4SingleParticleGeneratorTool, '\b numPoints' and '\b eventsPerPoint'
+ *  give the scan of the generator, and the histograms are filled for each point (with the name suffixed by
+ *  "_point<index>").
  *
  *  @author Anna Zaborowska
  */
@@ -60,8 +66,13 @@ private:
   SmartIF<ITHistSvc> m_histSvc;
   /// Pointer to the geometry service
   ServiceHandle<IGeoSvc> m_geoSvc;
+  /// Histograms of each layer, for each point of the scan (index: point * numLayers + layer)
   std::vector<TH2F*> m_upstreamEnergyCellEnergy;
   std::vector<TH1F*> m_cellEnergyPhi;
+  /// Number of points of the scan of the generator (one set of histograms for all events if 1)
+  Gaudi::Property<uint> m_numPoints{this, "numPoints", 1, "Number of points of the scan of the generator"};
+  /// Number of consecutive events generated at each point of the scan
+  Gaudi::Property<uint> m_eventsPerPoint{this, "eventsPerPoint", 1, "Number of events at each point of the scan"};
   /// Name of the active field
   Gaudi::Property<std::string> m_activeFieldName{this, "activeFieldName", "active", "Name of active field"};
   /// Name of the cells/layer field
@@ -75,5 +86,11 @@ private:
       this, "samplingFraction", {}, "Values of sampling fraction per layer"};
   /// Name of the detector readout
   Gaudi::Property<std::string> m_readoutName{this, "readoutName", "", "Name of the readout"};
+  /// Decoder of the readout
+  dd4hep::DDSegmentation::BitFieldCoder* m_decoder = nullptr;
+  /// Index of the cryostat field
+  size_t m_cryoField = 0;
+  /// Index of the layer field
+  size_t m_layerField = 0;
 };
 #endif /* DETSTUDIES_UPSTREAMMATERIAL_H */
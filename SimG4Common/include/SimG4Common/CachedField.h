@@ -0,0 +1,59 @@
+#ifndef SIMG4COMMON_CACHEDFIELD_H
+#define SIMG4COMMON_CACHEDFIELD_H
+
+// Geant 4
+#include "G4MagneticField.hh"
+
+// STL
+#include <vector>
+
+/** @class sim::CachedField SimG4Common/SimG4Common/CachedField.h CachedField.h
+ *
+ *  Magnetic field reusing the values of the wrapped field at the recently queried points (cells).
+ *  If the point is within the distance of one of the cells, the value of that cell is returned, otherwise the wrapped
+ *  field is evaluated and replaces the oldest cell. Static fields only (the time is ignored).
+ *  The cells are not synchronised, hence each thread has its own instance.
+ */
+
+namespace sim {
+class CachedField : public G4MagneticField {
+public:
+  /** Constructor.
+   *  @param[in] aField wrapped field (not owned)
+   *  @param[in] aDistance distance within which the value of a cell is reused
+   *  @param[in] aSize number of cells
+   */
+  CachedField(const G4MagneticField* aField, double aDistance, unsigned int aSize);
+  virtual ~CachedField() {}
+  /// Get the value of the field, from the cache if possible
+  virtual void GetFieldValue(const G4double point[4], double* bField) const final;
+  /// Wrapped field
+  const G4MagneticField* field() const { return m_field; }
+  /// Number of values from the cache
+  unsigned long hits() const { return m_hits; }
+  /// Number of evaluations of the wrapped field
+  unsigned long misses() const { return m_misses; }
+
+private:
+  /// Point and value of the field
+  struct Cell {
+    double point[3];
+    double value[3];
+  };
+  /// Wrapped field
+  const G4MagneticField* m_field;
+  /// Square of the distance within which the value of a cell is reused
+  double m_distance2;
+  /// Cells, the oldest at m_next
+  mutable std::vector<Cell> m_cells;
+  /// Number of filled cells
+  mutable unsigned int m_filled = 0;
+  /// Next cell to be replaced
+  mutable unsigned int m_next = 0;
+  /// Number of values from the cache
+  mutable unsigned long m_hits = 0;
+  /// Number of evaluations of the wrapped field
+  mutable unsigned long m_misses = 0;
+};
+}
+#endif /* SIMG4COMMON_CACHEDFIELD_H */
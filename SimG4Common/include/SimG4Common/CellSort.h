@@ -0,0 +1,42 @@
+#ifndef SIMG4COMMON_CELLSORT_H
+#define SIMG4COMMON_CELLSORT_H
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** @class sim::CellSort SimG4Common/SimG4Common/CellSort.h CellSort.h
+ *
+ *  Order of the hits of an event sorted by group (e.g. the readout and the value of a field of the cellID), then by
+ *  cellID, used by the saving tools to write the hits sorted.
+ *  The keys are sorted by a stable least-significant-digit radix sort, in passes of 16 bits: the passes over the
+ *  digits equal for all hits (e.g. the high bits of the groups, or unused bits of the cellIDs) are skipped, so that
+ *  the cost is linear in the number of hits. The hits with the same group and cellID keep their order.
+ *  The buffers are kept between events.
+ */
+
+namespace sim {
+class CellSort {
+public:
+  /** Sort the hits.
+   *  @param[in] aGroups group of each hit
+   *  @param[in] aCellIDs cellID of each hit
+   */
+  void sort(const std::vector<uint64_t>& aGroups, const std::vector<uint64_t>& aCellIDs);
+  /// Indices of the hits in the sorted order
+  inline const std::vector<uint32_t>& order() const { return m_order; }
+
+private:
+  /// Stable sort of m_order by the keys, over all the digits that differ between the keys
+  void sortBy(const std::vector<uint64_t>& aKeys);
+  /// Indices of the hits in the sorted order
+  std::vector<uint32_t> m_order;
+  /// Indices of the hits during a pass
+  std::vector<uint32_t> m_buffer;
+  /// Offsets of the digits during a pass
+  std::vector<uint32_t> m_offsets;
+};
+}
+
+#endif /* SIMG4COMMON_CELLSORT_H */
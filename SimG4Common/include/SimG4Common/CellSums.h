@@ -0,0 +1,71 @@
+#ifndef SIMG4COMMON_CELLSUMS_H
+#define SIMG4COMMON_CELLSUMS_H
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** @class sim::CellSums SimG4Common/SimG4Common/CellSums.h CellSums.h
+ *
+ *  Sums of the energy deposits per cell, accumulated during the tracking by the aggregating calorimeter sensitive
+ *  detector, so that the memory scales with the number of cells hit and not with the number of steps.
+ *  The cells are stored in the order of their first deposit, and found by an open-addressing hash table (linear
+ *  probing) of their indices, whose size is a power of two kept above twice the number of cells.
+ *  clear() keeps the memory of both, for the next event.
+ */
+
+namespace sim {
+class CellSums {
+public:
+  /// Sum of the deposits in a cell
+  struct Cell {
+    uint64_t cellID;
+    double energy;
+    /// energy-weighted sum of the positions, divided by the energy in normalise()
+    double x, y, z;
+    /// time of the earliest deposit
+    double time;
+    /// track ID and PDG code of the earliest deposit
+    int trackId;
+    int pdg;
+    /// sum of the energies times the weights of their tracks, divided by the energy in normalise() (effective weight)
+    double weight;
+  };
+  /// Constructor, with the number of cells expected
+  explicit CellSums(size_t aNumCells = 1024);
+  /// Add a deposit to its cell, with the weight of its track
+  void add(uint64_t aCellID, double aEnergy, double aX, double aY, double aZ, double aTime, int aTrackId, int aPdg,
+           double aWeight = 1);
+  /// Divide the energy-weighted positions and weights by the energies (the cells without energy are at 0, weight 1)
+  void normalise();
+  /// Remove all the cells, keeping the memory
+  void clear();
+  /// Cells in the order of their first deposit
+  inline const std::vector<Cell>& cells() const { return m_cells; }
+  /// Number of cells
+  inline size_t size() const { return m_cells.size(); }
+
+private:
+  /// Slot of the hash table for the cellID
+  inline size_t slot(uint64_t aCellID) const {
+    // cellIDs are bit fields, mixed (splitmix64 finalizer) not to fill the table in clusters
+    aCellID ^= aCellID >> 30;
+    aCellID *= 0xbf58476d1ce4e5b9ull;
+    aCellID ^= aCellID >> 27;
+    aCellID *= 0x94d049bb133111ebull;
+    aCellID ^= aCellID >> 31;
+    return aCellID & m_mask;
+  }
+  /// Double the size of the hash table
+  void grow();
+  /// Indices of the cells in m_cells (-1: empty slot)
+  std::vector<int32_t> m_table;
+  /// Size of the hash table minus one
+  size_t m_mask;
+  /// Cells in the order of their first deposit
+  std::vector<Cell> m_cells;
+};
+}
+
+#endif /* SIMG4COMMON_CELLSUMS_H */
@@ -38,6 +38,17 @@ public:
   /// Set the extend of the field in longitudinal direction
   void setMaxZ(double value) { m_zMax = value; }
 
+  /// Get the x component of the field
+  double bX() const { return m_bX; }
+  /// Get the y component of the field
+  double bY() const { return m_bY; }
+  /// Get the z component of the field
+  double bZ() const { return m_bZ; }
+  /// Get the extend of the field in radial direction
+  double maxR() const { return m_rMax; }
+  /// Get the extend of the field in longitudinal direction
+  double maxZ() const { return m_zMax; }
+
 private:
   /// Field component in x
   double m_bX;
@@ -3,8 +3,16 @@
 
 #include "G4VUserEventInformation.hh"
 
+// podio
+#include "podio/ObjectID.h"
+
+#include <cmath>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 class G4Track;
 namespace edm4hep {
@@ -15,33 +23,218 @@ class MCParticleCollection;
  *
  * Additional event information.
  *
- * Currently holds the particle history in form of edm particles and vertices
+ * Currently holds the particle history, the numbers of tracks and steps (if counted by the user actions), the
+ * region of interest of the event with the numbers of tracks killed outside of it (if simulated in that mode), the
+ * tracks stopped at the envelope of a staged simulation and the primaries smeared by the fast simulation of the
+ * tracker.
+ * During the tracking the particles are recorded in a compact form, they are converted to edm particles
+ * (linked to their parents and daughters) only once, when the collection is first requested, also if it is
+ * requested concurrently by several output tools.
+ * The particles can be found by their G4 track ID, and the track IDs of their parents are kept.
+ * Each event owns its information (G4Event deletes it), which owns the particle collection until it is released
+ * to the event store, so that events simulated concurrently share no state.
  *
  * @author J. Lingemann
  */
 
 namespace sim {
+/// Particle of the history as recorded during the tracking (Geant4 units)
+struct ParticleRecord {
+  int trackId;
+  int parentId;
+  int pdg;
+  double px, py, pz, energy;
+  double vx, vy, vz, time;
+};
+
+/// Track stopped when entering the envelope of a staged simulation, in its state at the boundary (Geant4 units)
+struct StagedTrack {
+  int trackId;
+  int pdg;
+  double mass;
+  double charge;
+  double px, py, pz;
+  double x, y, z, time;
+};
+
+/// Primary particle smeared by the fast simulation of the tracker, with its MC particle (Geant4 units)
+struct SmearedParticle {
+  /// Identifier of the EDM MC particle of the primary
+  podio::ObjectID mcParticleID;
+  int trackId;
+  double charge;
+  double mass;
+  double px, py, pz;
+  double vx, vy, vz;
+};
+
+/// Cone of the region of interest, around the direction of a primary particle (in pseudorapidity and azimuth)
+struct RegionOfInterestCone {
+  double eta;
+  double phi;
+  double deltaR;
+};
+
+/// Region of interest of the event and the tracks killed outside of it (Geant4 units)
+struct RegionOfInterest {
+  /// Flag whether the cones were already defined from the primaries of the event
+  bool defined = false;
+  /// Cones of the region of interest
+  std::vector<RegionOfInterestCone> cones;
+  /// Number of the secondary tracks killed at their creation outside of the cones
+  size_t killedAtCreation = 0;
+  /// Number of the tracks killed when leaving the cones
+  size_t killedLeaving = 0;
+  /// Kinetic energy of the killed tracks
+  double killedEnergy = 0;
+  /** Check if the direction is inside one of the cones.
+   * @param[in] aEta pseudorapidity of the direction
+   * @param[in] aPhi azimuth of the direction
+   * @returns true if the direction is inside a cone
+   */
+  bool contains(double aEta, double aPhi) const {
+    for (const auto& cone : cones) {
+      const double deltaEta = aEta - cone.eta;
+      const double deltaPhi = std::remainder(aPhi - cone.phi, 2 * M_PI);
+      if (deltaEta * deltaEta + deltaPhi * deltaPhi < cone.deltaR * cone.deltaR) return true;
+    }
+    return false;
+  }
+};
+
 class EventInformation : public G4VUserEventInformation {
 public:
-  /// Default constructor
-  EventInformation();
-  /// Destructor
-  virtual ~EventInformation() = default;
-  /** Set external pointers to point at the particle and vertex collections.
-   * @param[in] aGenVertexCollection  pointer to a collection that should take ownership of the particles saved here
-   * @param[in] aMCParticleCollection  pointer to a collection that should take ownership of the particles saved here
-   */
-  void setCollections( edm4hep::MCParticleCollection*& aMcParticleCollection);
-  /// Add a particle to be tracked in the EDM collections
-  void addParticle(const G4Track* aSecondary);
+  /** Constructor
+   * @param[in] aExpectedParticles number of particles for which the space is reserved (e.g. from the previous event)
+   */
+  explicit EventInformation(size_t aExpectedParticles = 0);
+  /// Destructor, deletes the particle collection if its ownership was not transferred
+  virtual ~EventInformation();
+  EventInformation(const EventInformation&) = delete;
+  EventInformation& operator=(const EventInformation&) = delete;
+  /** Release the ownership of the particle collection (e.g. to the event store).
+   * The recorded particles are converted if they were not yet.
+   * @returns the particle collection, nullptr if it was already released
+   */
+  std::unique_ptr<edm4hep::MCParticleCollection> releaseParticles();
+  /** Particles of the history, also after their ownership was transferred (then valid as long as the event store
+   * holds the collection). The recorded particles are converted at the first call.
+   * @returns pointer to the particle collection
+   */
+  const edm4hep::MCParticleCollection* particles();
+  /** Record a particle to be saved in the EDM collections.
+   * @param[in] aSecondary track of the particle
+   * @param[in] aWithAncestors flag whether the ancestors of the particle recorded as candidates should be saved too
+   */
+  void addParticle(const G4Track* aSecondary, bool aWithAncestors = false);
+  /** Record a particle that is saved only if one of its descendants is saved with its ancestors.
+   * @param[in] aTrack track of the particle
+   */
+  void addCandidate(const G4Track* aTrack);
+  /** Record the end of the tracking of a particle (also if it is suspended). The record of a candidate is dropped
+   * once its track ended and none of its daughters is left to be tracked, as no descendant can then need it.
+   * @param[in] aTrack track of the particle
+   * @param[in] aNumSecondaries number of the secondaries created by the track, to be tracked
+   * @param[in] aEnded flag whether the track ended (false if it is suspended and tracked again later)
+   */
+  void endTrack(const G4Track* aTrack, size_t aNumSecondaries, bool aEnded);
+  /** Record that a track was killed before its tracking (e.g. by a stacking action), so that its parent does not
+   * wait for it (or, for a suspended track, that it ended).
+   * @param[in] aTrack track of the killed particle
+   */
+  void discardTrack(const G4Track* aTrack);
+  /** Add the particles (with the weights and the staged tracks) of another event (e.g. of a sub-event), with shifted
+   * track IDs.
+   * @param[in] aOther event information with the particles to be copied
+   * @param[in] aTrackIdOffset offset added to the G4 track IDs of the copied particles
+   */
+  void addParticles(const EventInformation& aOther, int aTrackIdOffset);
+  /// Highest G4 track ID of the saved particles (0 if none)
+  int maxTrackId() const { return m_maxTrackId; }
+  /// Number of the saved particles
+  size_t numParticles() const { return m_records.size(); }
+  /** Index of the particle in the collection.
+   * @param[in] aTrackId G4 track ID of the particle
+   * @returns index of the particle, -1 if it was not saved
+   */
+  int particleIndex(int aTrackId) const {
+    auto index = m_trackIdToIndex.find(aTrackId);
+    return index != m_trackIdToIndex.end() ? index->second : -1;
+  }
+  /** G4 track ID of the parent of the particle.
+   * @param[in] aIndex index of the particle in the collection
+   * @returns track ID of the parent, 0 for the primaries
+   */
+  int parentTrackId(size_t aIndex) const { return m_records[aIndex].parentId; }
+  /** Count a step.
+   * @param[in] aFirstStep flag whether it is the first step of the track (the track is counted too)
+   */
+  void countStep(bool aFirstStep) {
+    ++m_numSteps;
+    if (aFirstStep) ++m_numTracks;
+  }
+  /// Number of counted tracks
+  size_t numTracks() const { return m_numTracks; }
+  /// Number of counted steps
+  size_t numSteps() const { return m_numSteps; }
+  /// Region of interest of the event (not defined if the event is not simulated in that mode)
+  RegionOfInterest& regionOfInterest() { return m_regionOfInterest; }
+  const RegionOfInterest& regionOfInterest() const { return m_regionOfInterest; }
+  /** Record a track stopped at the envelope of a staged simulation.
+   * @param[in] aTrack state of the track at the boundary
+   */
+  void addStagedTrack(const StagedTrack& aTrack) { m_stagedTracks.push_back(aTrack); }
+  /// Tracks stopped at the envelope of a staged simulation, in the order in which they were stopped
+  const std::vector<StagedTrack>& stagedTracks() const { return m_stagedTracks; }
+  /** Record a primary smeared by the fast simulation. A primary smeared again (e.g. in another tracker) replaces
+   * its previous record.
+   * @param[in] aParticle smeared primary
+   */
+  void addSmearedParticle(const SmearedParticle& aParticle);
+  /// Primaries smeared by the fast simulation, in the order in which they were first smeared
+  const std::vector<SmearedParticle>& smearedParticles() const { return m_smearedParticles; }
 
   void Print() const {};
 
 private:
-  /// Pointer to the particle collection, ownership is intended to be transfered to SaveTool
-  edm4hep::MCParticleCollection* m_mcParticles;
-  /// Map to get the edm end vertex id from a Geant4 unique particle ID
-  std::map<size_t, size_t> m_g4IdToEndVertexMap;
+  /// Convert the recorded particles to the particle collection
+  void convertParticles();
+  /// Add the record to the saved particles
+  void addRecord(const ParticleRecord& aRecord);
+  /// Count down the daughters left to be tracked of a candidate, and drop the candidates that no descendant may need
+  void releaseDaughter(int aParentId);
+  /// Particle not saved (yet), with the number of its daughters left to be tracked
+  struct Candidate {
+    ParticleRecord record;
+    size_t numDaughters = 0;
+    bool ended = false;
+  };
+  /// Particle collection, until its ownership is transferred (e.g. to the event store)
+  std::unique_ptr<edm4hep::MCParticleCollection> m_mcParticles;
+  /// Pointer to the particle collection, also after its ownership was transferred
+  const edm4hep::MCParticleCollection* m_savedParticles = nullptr;
+  /// Flag of the conversion of the recorded particles (once, also if requested by several threads)
+  std::once_flag m_converted;
+  /// Map to get the index of the particle in the collection from its G4 track ID
+  std::unordered_map<int, int> m_trackIdToIndex;
+  /// Recorded particles, in the order of the collection
+  std::vector<ParticleRecord> m_records;
+  /// Particles not saved (yet), that are saved if one of their descendants is, mapped by their G4 track ID
+  std::unordered_map<int, Candidate> m_candidates;
+  /// Highest G4 track ID of the saved particles
+  int m_maxTrackId = 0;
+  /// Number of counted tracks
+  size_t m_numTracks = 0;
+  /// Number of counted steps
+  size_t m_numSteps = 0;
+  /// Region of interest of the event
+  RegionOfInterest m_regionOfInterest;
+  /// Tracks stopped at the envelope of a staged simulation
+  std::vector<StagedTrack> m_stagedTracks;
+  /// Primaries smeared by the fast simulation
+  std::vector<SmearedParticle> m_smearedParticles;
+  /// Map to get the index of the smeared primary from its G4 track ID
+  std::unordered_map<int, size_t> m_smearedIndex;
 };
 }
 #endif /* define SIMG4COMMON_EVENTINFORMATION_H */
@@ -0,0 +1,97 @@
+#ifndef SIMG4COMMON_EVENTWATCHDOG_H
+#define SIMG4COMMON_EVENTWATCHDOG_H
+
+// Geant4
+#include "G4UserSteppingAction.hh"
+class G4Event;
+
+// Gaudi
+class MsgStream;
+
+// STL
+#include <atomic>
+#include <memory>
+
+/** @class EventWatchdog SimG4Common/SimG4Common/EventWatchdog.h EventWatchdog.h
+ *
+ *  Stepping action guarding the simulation against pathological events (e.g. particles looping in the magnetic
+ *  field). It wraps the user stepping action of the run manager (called first, for each step) and:
+ *  a) kills a track that exceeds the budget of steps per track;
+ *  b) aborts the event if it exceeds the budget of steps, or of CPU time of the thread (checked every few steps).
+ *  An aborted event keeps what was simulated until the abort, the run continues with the next event.
+ *  The run managers (sim::RunManager, sim::WorkerRunManager) install it and report the aborted events with the seeds
+ *  of the random engine at the beginning of the event and the primary particles, so that they can be reproduced.
+ */
+
+namespace sim {
+class EventWatchdog : public G4UserSteppingAction {
+public:
+  /// Budgets of the event (0: no limit)
+  struct Budget {
+    /// CPU time of the thread spent on the event [s]
+    double maxCpuTime = 0;
+    /// Number of steps of all the tracks of the event
+    unsigned long maxSteps = 0;
+    /// Number of steps of one track
+    unsigned long maxTrackSteps = 0;
+    /// Number of steps between two checks of the CPU time
+    unsigned int checkInterval = 1000;
+    /// Whether any budget is set
+    bool enabled() const { return maxCpuTime > 0 || maxSteps > 0 || maxTrackSteps > 0; }
+  };
+  /// Reason of the abort of the event
+  enum class Abort { kNone, kCpuTime, kSteps };
+  /** Constructor.
+   *  @param[in] aBudget budgets of the event
+   *  @param[in] aAction user stepping action called for each step (owned, may be null)
+   */
+  EventWatchdog(const Budget& aBudget, G4UserSteppingAction* aAction);
+  virtual ~EventWatchdog();
+  /// Reset the counters and record the seeds of the random engine, before the event is processed
+  void beginEvent();
+  /** Report the event after it is processed: a warning with the seeds and the primaries if it was aborted, and the
+   *  number of tracks killed for their steps.
+   *  @param[in] aEvent processed event
+   *  @param[in] aLog message stream of the run manager
+   */
+  void endEvent(const G4Event& aEvent, MsgStream& aLog) const;
+  /// Pass the pointer to the stepping manager to the wrapped action
+  virtual void SetSteppingManagerPointer(G4SteppingManager* aManager) final;
+  /// Call the wrapped action and check the budgets
+  virtual void UserSteppingAction(const G4Step* aStep) final;
+  /// Reason of the abort of the current event
+  Abort abortReason() const { return m_abort; }
+  /// CPU time of the calling thread [s]
+  static double threadCpuTime();
+  /// Number of tracks killed for their steps in all the threads since the start of the job
+  static unsigned long totalKilledTracks() { return s_totalKilledTracks; }
+  /// Number of events aborted in all the threads since the start of the job
+  static unsigned long totalAbortedEvents() { return s_totalAbortedEvents; }
+
+private:
+  /// Abort the current event
+  void abort(Abort aReason);
+  /// Budgets of the event
+  Budget m_budget;
+  /// Wrapped user stepping action
+  std::unique_ptr<G4UserSteppingAction> m_action;
+  /// CPU time of the thread at the beginning of the event [s]
+  double m_startCpuTime = 0;
+  /// CPU time spent on the event until the abort [s]
+  double m_cpuTime = 0;
+  /// Number of steps of the event
+  unsigned long m_steps = 0;
+  /// Number of tracks killed for exceeding the budget of steps per track, and their kinetic energy
+  unsigned long m_killedTracks = 0;
+  double m_killedEnergy = 0;
+  /// Seeds of the random engine at the beginning of the event
+  long m_seeds[2] = {0, 0};
+  /// Reason of the abort of the current event
+  Abort m_abort = Abort::kNone;
+  /// Totals of all the threads, for the metrics of the job
+  static std::atomic<unsigned long> s_totalKilledTracks;
+  static std::atomic<unsigned long> s_totalAbortedEvents;
+};
+}
+
+#endif /* SIMG4COMMON_EVENTWATCHDOG_H */
@@ -0,0 +1,90 @@
+#ifndef SIMG4COMMON_FIELDCOUNTERS_H
+#define SIMG4COMMON_FIELDCOUNTERS_H
+
+// Geant 4
+#include "G4MagIntegratorStepper.hh"
+#include "G4MagneticField.hh"
+
+// STL
+#include <memory>
+
+/** @class sim::FieldCounters SimG4Common/SimG4Common/FieldCounters.h FieldCounters.h
+ *
+ *  Cost of the propagation in the magnetic field: field evaluations, integration steps of the stepper (including the
+ *  rejected ones), trial chords of the chord finder and steps rejected by the error control of the driver.
+ *  Counted by one thread (CountingField, CountingStepper), the counters are not synchronised.
+ */
+
+/** @class sim::CountingField SimG4Common/SimG4Common/FieldCounters.h FieldCounters.h
+ *
+ *  Magnetic field counting the evaluations of the wrapped field.
+ *  The counters are not synchronised, hence each thread has its own instance.
+ */
+
+/** @class sim::CountingStepper SimG4Common/SimG4Common/FieldCounters.h FieldCounters.h
+ *
+ *  Stepper counting the integration steps of the wrapped stepper into the counters of the CountingField of the thread.
+ *  The chord finder evaluates the distance of the chord after each trial step, while the driver repeats the step from
+ *  the same point when its error is too large: a step starting where the previous one started, without the distance of
+ *  the chord evaluated in between, is counted as rejected.
+ */
+
+namespace sim {
+struct FieldCounters {
+  unsigned long fieldCalls = 0;
+  unsigned long integratorSteps = 0;
+  unsigned long chordTrials = 0;
+  unsigned long rejectedSteps = 0;
+  FieldCounters& operator+=(const FieldCounters& aOther);
+  FieldCounters operator-(const FieldCounters& aOther) const;
+};
+
+class CountingField : public G4MagneticField {
+public:
+  /// Constructor, the wrapped field is not owned
+  explicit CountingField(const G4MagneticField* aField) : m_field(aField) {}
+  virtual ~CountingField() {}
+  /// Get the value of the wrapped field and count the evaluation
+  virtual void GetFieldValue(const G4double point[4], double* bField) const final {
+    ++m_counters.fieldCalls;
+    m_field->GetFieldValue(point, bField);
+  }
+  /// Wrapped field
+  const G4MagneticField* field() const { return m_field; }
+  /// Number of evaluations of the field
+  unsigned long calls() const { return m_counters.fieldCalls; }
+  /// Counters of the thread
+  FieldCounters& counters() const { return m_counters; }
+
+private:
+  /// Wrapped field
+  const G4MagneticField* m_field;
+  /// Counters of the thread
+  mutable FieldCounters m_counters;
+};
+
+class CountingStepper : public G4MagIntegratorStepper {
+public:
+  /** Constructor.
+   *  @param[in] aStepper stepper (owned), on the equation of aField
+   *  @param[in] aField counting field of the thread (not owned)
+   */
+  CountingStepper(G4MagIntegratorStepper* aStepper, const CountingField& aField);
+  virtual ~CountingStepper() {}
+  virtual void Stepper(const G4double y[], const G4double dydx[], G4double h, G4double yout[],
+                       G4double yerr[]) final;
+  virtual G4double DistChord() const final;
+  virtual G4int IntegratorOrder() const final { return m_stepper->IntegratorOrder(); }
+
+private:
+  /// Wrapped stepper
+  std::unique_ptr<G4MagIntegratorStepper> m_stepper;
+  /// Counters of the thread
+  FieldCounters& m_counters;
+  /// Start of the previous step
+  G4double m_lastStart[6] = {0, 0, 0, 0, 0, 0};
+  /// Whether the distance of the chord was evaluated since the previous step
+  mutable bool m_chordEvaluated = true;
+};
+}
+#endif /* SIMG4COMMON_FIELDCOUNTERS_H */
@@ -0,0 +1,106 @@
+#ifndef SIMG4COMMON_FIELDMAP_H
+#define SIMG4COMMON_FIELDMAP_H
+
+// FCCSW
+#include "SimG4Common/MappedFile.h"
+
+// Geant 4
+#include "G4MagneticField.hh"
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/** @class sim::FieldMap SimG4Common/SimG4Common/FieldMap.h FieldMap.h
+ *
+ *  Magnetic field interpolated from a map on a regular grid, read from a binary file mapped in memory.
+ *  The pages of the file are shared by all the threads and by all the processes on the node that map the same file,
+ *  and they are only read from the disk when first used.
+ *  The file starts with the header FieldMap::Header, followed by the three components of the field (float, in tesla)
+ *  at each point of the grid, the last coordinate being the fastest, i.e. the components at (i0, i1, i2) start at the
+ *  float 3 * ((i0 * n1 + i1) * n2 + i2).
+ *  a) Cartesian grid: coordinates (x, y, z) [mm], components (Bx, By, Bz);
+ *  b) cylindrical grid: coordinates (r, phi, z) [mm, rad], components (Br, Bphi, Bz). With one point in phi the field
+ *     is axially symmetric, otherwise the phi axis covers 2 pi periodically, with the points at min[1] + i * 2 pi / n1
+ *     (max[1] is not used).
+ *  The field is interpolated linearly between the points of the grid (in each coordinate), it is zero outside.
+ *  A map may be replicated in memory of its own (replicate()), placed on the NUMA domain of the thread copying it.
+ *  If the huge pages are used (SimG4Common/HugePages.h), the map and its replicas are advised to be backed by them.
+ */
+
+namespace sim {
+class FieldMap : public G4MagneticField {
+public:
+  /// Coordinates of the grid
+  enum Coordinates : uint32_t { kCartesian = 0, kCylindrical = 1 };
+  /// Header of the file of the map
+  struct Header {
+    /// "K4FMAP1" followed by the zero
+    char magic[8];
+    /// Coordinates of the grid
+    uint32_t coordinates;
+    /// Number of points in each coordinate
+    uint32_t n[3];
+    /// Lowest and highest points of the grid in each coordinate [mm or rad]
+    double min[3];
+    double max[3];
+  };
+  /** Constructor. Maps the file in memory.
+   *  @param[in] aFileName name of the file of the map
+   *  @param[in] aScale scale factor of the field (e.g. -1 for the opposite polarity)
+   */
+  explicit FieldMap(const std::string& aFileName, double aScale = 1);
+  /// Destructor. Unmaps the file.
+  virtual ~FieldMap();
+  FieldMap(const FieldMap&) = delete;
+  FieldMap& operator=(const FieldMap&) = delete;
+
+  /// Get the value of the magnetic field value at position
+  /// @param[in] point the position where the field is to be returned
+  /// @param[out] bField the return value
+  virtual void GetFieldValue(const G4double point[4], double* bField) const final;
+
+  /// Whether the file was mapped successfully (otherwise the field is zero)
+  bool isValid() const { return m_values != nullptr; }
+  /// Reason why the file could not be mapped
+  const std::string& error() const { return m_error; }
+  /// Header of the map
+  const Header& header() const { return m_header; }
+  /** Copy the map to anonymous memory, written by the calling thread: its pages are allocated on the NUMA domain of
+   *  the thread (first touch), instead of the pages of the file in the page cache shared by all the domains.
+   *  @returns the copy of the map (not valid if the memory cannot be allocated)
+   */
+  std::unique_ptr<FieldMap> replicate() const;
+  /// Magic string of the file
+  static constexpr const char* kMagic = "K4FMAP1";
+
+private:
+  /// Constructor of the replicas
+  explicit FieldMap(double aScale) : m_scale(aScale) {}
+  /** Interpolate the field on the grid.
+   *  @param[in] aCoordinates coordinates of the point in the grid
+   *  @param[out] aField components of the field (in the coordinates of the grid)
+   *  @returns whether the point is within the grid
+   */
+  bool interpolate(const double aCoordinates[3], double aField[3]) const;
+  /// Header of the map
+  Header m_header;
+  /// Mapped file (or its replica)
+  MappedFile m_file;
+  /// Values of the field (within the mapped file)
+  const float* m_values = nullptr;
+  /// Inverse of the spacing of the grid in each coordinate
+  double m_invSpacing[3] = {0, 0, 0};
+  /// Strides of the grid (in floats) in each coordinate
+  size_t m_stride[3] = {0, 0, 0};
+  /// Flag whether the phi axis is periodic
+  bool m_periodicPhi = false;
+  /// Scale of the field (including the conversion from tesla)
+  double m_scale;
+  /// Reason why the file could not be mapped
+  std::string m_error;
+};
+}
+#endif /* SIMG4COMMON_FIELDMAP_H */
@@ -0,0 +1,204 @@
+#ifndef SIMG4COMMON_FIELDSETUP_H
+#define SIMG4COMMON_FIELDSETUP_H
+
+// Gaudi
+#include "GaudiKernel/IMessageSvc.h"
+#include "GaudiKernel/MsgStream.h"
+#include "GaudiKernel/ServiceHandle.h"
+#include "GaudiKernel/StatusCode.h"
+
+// FCCSW
+#include "SimG4Common/CachedField.h"
+#include "SimG4Common/UniformFieldStepper.h"
+
+// Geant 4
+class G4ChordFinder;
+class G4FieldManager;
+class G4Mag_EqRhs;
+class G4MagIntegratorStepper;
+class G4MagneticField;
+class G4ParticleDefinition;
+class G4VProcess;
+
+// STL
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/** @class sim::FieldSetup SimG4Common/SimG4Common/FieldSetup.h FieldSetup.h
+ *
+ *  Configuration of the propagation in the magnetic field, shared by the magnetic field tools.
+ *  The field, its stepper, chord finder and accuracy are set in the global field manager of the calling thread.
+ *  Additionally, field managers may be set for the volumes (daughters of the world whose names contain the given
+ *  names, with all their daughters):
+ *  a) field-free volumes, in which the charged particles are transported along straight lines;
+ *  b) volumes with their own accuracy (e.g. looser in the calorimeters than in the tracker), with their own chord
+ *     finder.
+ *  Field managers of the volumes are thread-local in Geant4, hence they are created for each thread (and owned here).
+ *  The stepper "auto" of a field uniform inside a cylinder (sim::ConstantField) follows the exact helix inside of the
+ *  cylinder and the Runge-Kutta NystromRK4 at its boundary (sim::UniformFieldStepper).
+ *  If the cache is enabled, the stepper of each thread queries the field through its own sim::CachedField.
+ *  If the counting is enabled, the field evaluations and the integration steps of each thread are counted
+ *  (sim::FieldCounters), to be attributed to the regions and the events by the user actions (threadCounters).
+ *  The thresholds of the transportation killing the particles looping in the field may be set per particle. They are
+ *  set to the transportation process of each particle; if a physics list shares one process between particles with
+ *  different thresholds (e.g. the general transportation), they are switched at the start of each track (startTrack).
+ */
+
+namespace sim {
+/// Accuracy of the propagation in the field (0: default of Geant4)
+struct FieldAccuracy {
+  double deltaChord = 0;
+  double deltaOneStep = 0;
+  double minEpsilon = 0;
+  double maxEpsilon = 0;
+};
+
+/// Thresholds of the transportation killing the looping particles (negative: default of Geant4)
+struct LooperThresholds {
+  /// Energy below which the loopers are killed without warning
+  double warningEnergy = -1;
+  /// Energy above which the loopers survive numberOfTrials steps before being killed
+  double importantEnergy = -1;
+  /// Number of looping steps of an important particle before it is killed
+  int numberOfTrials = -1;
+  bool operator==(const LooperThresholds& aOther) const {
+    return warningEnergy == aOther.warningEnergy && importantEnergy == aOther.importantEnergy &&
+           numberOfTrials == aOther.numberOfTrials;
+  }
+};
+
+class FieldSetup {
+public:
+  /** Constructor.
+   *  @param[in] aStepper name of the integration stepper
+   *  @param[in] aMinStep minimum step of the chord finder
+   *  @param[in] aMaxStep largest acceptable step of the propagator
+   *  @param[in] aAccuracy accuracy of the global field manager
+   */
+  FieldSetup(const std::string& aStepper, double aMinStep, double aMaxStep, const FieldAccuracy& aAccuracy);
+  ~FieldSetup();
+  /// Set the volumes without field
+  void setFieldFreeVolumes(const std::vector<std::string>& aNames) { m_fieldFreeVolumes = aNames; }
+  /// Set the volumes with their own accuracy
+  void addVolumes(const std::vector<std::string>& aNames, const FieldAccuracy& aAccuracy);
+  /** Set the extent of the uniform field used by the stepper "auto".
+   *  @param[in] aRMax radius of the cylinder of the field
+   *  @param[in] aZMax half-length of the cylinder of the field
+   */
+  void setUniformField(double aRMax, double aZMax);
+  /** Enable the cache of the field values (one per thread).
+   *  @param[in] aDistance distance within which the value of a cell is reused (0: no cache)
+   *  @param[in] aSize number of cells of the cache
+   */
+  void setCache(double aDistance, unsigned int aSize);
+  /// Values from the caches of all the threads and evaluations of the field by the caches
+  std::pair<unsigned long, unsigned long> cacheCounters() const;
+  /// Enable the counting of the field evaluations and of the integration steps
+  void setCounting(bool aCounting) { m_counting = aCounting; }
+  /// Counters of the calling thread (nullptr if not counted)
+  static const FieldCounters* threadCounters();
+  /** Set the thresholds of the looping particles, by particle name ("default" for the other particles).
+   *  @param[in] aWarningEnergies energies below which the loopers are killed without warning
+   *  @param[in] aImportantEnergies energies above which the loopers survive several looping steps
+   *  @param[in] aNumberOfTrials numbers of looping steps of the important loopers before they are killed
+   */
+  void setLooperThresholds(const std::map<std::string, double>& aWarningEnergies,
+                           const std::map<std::string, double>& aImportantEnergies,
+                           const std::map<std::string, int>& aNumberOfTrials);
+  /** Switch the thresholds of a transportation shared between particles with different thresholds to those of the
+   *  particle of the track starting in the calling thread (to be called by a tracking action).
+   *  @param[in] aParticle particle of the track
+   */
+  static void startTrack(const G4ParticleDefinition& aParticle);
+  /// Steps and field evaluations of the steppers "auto" of all the threads
+  UniformFieldStepper::Counters uniformFieldCounters() const;
+  /** Attach the field to the field managers of the calling thread.
+   *  The field managers of the volumes are only set if the geometry is already constructed, hence on the master
+   *  thread this is called again after the initialisation of the run manager.
+   *  @param[in] aField magnetic field (not owned)
+   *  @returns status code (failure if a volume is not found)
+   */
+  StatusCode attachToThread(G4MagneticField* aField);
+  /** Create the stepper of the field.
+   *  @param[in] aName name of the stepper
+   *  @param[in] aEquation equation of motion (not owned)
+   *  @returns stepper (ownership is transferred to the caller), nullptr if the name is unknown
+   */
+  static G4MagIntegratorStepper* stepper(const std::string& aName, G4Mag_EqRhs* aEquation);
+  /// Whether the name of the stepper is known (apart from "auto")
+  static bool isKnownStepper(const std::string& aName);
+
+private:
+  /// Set the accuracy of the field manager
+  static void setAccuracy(G4FieldManager& aFieldManager, const FieldAccuracy& aAccuracy);
+  /// Thresholds of the particles of a thread whose transportation is shared with different thresholds
+  struct ThreadLoopers {
+    std::unordered_map<const G4ParticleDefinition*, std::pair<G4VProcess*, LooperThresholds>> particles;
+    /// Thresholds currently set to each shared transportation
+    std::unordered_map<const G4VProcess*, LooperThresholds> applied;
+  };
+  /// Thresholds of the calling thread switched at the start of the tracks (nullptr: none)
+  static thread_local ThreadLoopers* t_threadLoopers;
+  /** Set the thresholds of the looping particles to the transportation processes of the calling thread.
+   *  @returns status code (failure if a particle is not known)
+   */
+  StatusCode applyLooperThresholds();
+  /// Set the thresholds to the transportation process, returns false if it is not a transportation of Geant4
+  static bool setLooperThresholds(G4VProcess& aTransportation, const LooperThresholds& aThresholds);
+  /// Get the thresholds of the transportation process
+  static LooperThresholds looperThresholds(const G4VProcess& aTransportation);
+  /// Get the cached field of the calling thread, created if needed (owned)
+  CachedField* cachedField(G4MagneticField* aField);
+  /// Get the counting field of the calling thread, created if needed (owned)
+  CountingField* countingField(G4MagneticField* aField);
+  /// Create the chord finder of the field, with its equation and stepper (owned)
+  G4ChordFinder* chordFinder(G4MagneticField* aField);
+  /** Set the field manager to the daughters of the world matching the name (and to their daughters).
+   *  @returns whether any volume matches
+   */
+  bool attachToVolumes(const std::string& aName, G4FieldManager* aFieldManager);
+  /// Message Service
+  ServiceHandle<IMessageSvc> m_msgSvc;
+  /// Message Stream
+  MsgStream m_log;
+  /// Name of the stepper
+  std::string m_stepper;
+  /// Minimum step of the chord finder
+  double m_minStep;
+  /// Largest acceptable step of the propagator
+  double m_maxStep;
+  /// Accuracy of the global field manager
+  FieldAccuracy m_accuracy;
+  /// Volumes without the field
+  std::vector<std::string> m_fieldFreeVolumes;
+  /// Volumes with their own accuracy
+  std::vector<std::pair<std::vector<std::string>, FieldAccuracy>> m_volumeAccuracies;
+  /// Extent of the uniform field of the stepper "auto" (0: not uniform)
+  double m_uniformRMax = 0;
+  double m_uniformZMax = 0;
+  /// Distance within which the value of a cell of the cache is reused (0: no cache) and number of cells
+  double m_cacheDistance = 0;
+  unsigned int m_cacheSize = 1;
+  /// Whether the field evaluations and the integration steps are counted
+  bool m_counting = false;
+  /// Thresholds of the looping particles by particle name ("default" for the other particles)
+  std::map<std::string, LooperThresholds> m_looperThresholds;
+  /// Objects created for the threads (the chord finders do not own their stepper and equation)
+  std::vector<std::unique_ptr<CachedField>> m_cachedFields;
+  std::vector<std::unique_ptr<CountingField>> m_countingFields;
+  std::vector<std::unique_ptr<G4Mag_EqRhs>> m_equations;
+  std::vector<std::unique_ptr<G4MagIntegratorStepper>> m_steppers;
+  std::vector<const UniformFieldStepper*> m_uniformSteppers;
+  std::vector<std::unique_ptr<G4FieldManager>> m_fieldManagers;
+  std::vector<std::unique_ptr<G4ChordFinder>> m_chordFinders;
+  std::vector<std::unique_ptr<ThreadLoopers>> m_threadLoopers;
+  /// Mutex guarding the objects created for the threads
+  mutable std::mutex m_mutex;
+};
+}
+#endif /* SIMG4COMMON_FIELDSETUP_H */
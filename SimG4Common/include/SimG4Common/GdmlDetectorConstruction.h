@@ -1,6 +1,9 @@
 #ifndef SIMG4COMMON_GDMLDETECTORCONSTRUCTION_H
 #define SIMG4COMMON_GDMLDETECTORCONSTRUCTION_H
 
+// FCCSW
+#include "SimG4Common/GeometryCache.h"
+
 // Geant
 #include "G4GDMLParser.hh"
 #include "G4VUserDetectorConstruction.hh"
@@ -22,8 +25,10 @@ class GdmlDetectorConstruction : public G4VUserDetectorConstruction {
 public:
   /**  Constructor.
    *   @param[in] aFileName Name of the GDML file with the detector description.
+   *   @param[in] aCacheDir Directory of the binary geometry cache (no cache if empty).
    */
-  explicit GdmlDetectorConstruction(const std::string& aFileName, bool validate=false);
+  explicit GdmlDetectorConstruction(const std::string& aFileName, bool validate=false,
+                                    const std::string& aCacheDir="");
   virtual ~GdmlDetectorConstruction();
   /**  Create volumes using the GDML parser.
    *   @return World wolume.
@@ -44,6 +49,10 @@ private:
   G4GDMLParser m_parser;
   /// name of the GDML file
   std::string m_fileName;
+  /// World volume, read from the cache or from the GDML file
+  G4VPhysicalVolume* m_world = nullptr;
+  /// Auxiliary information of the volumes
+  GeometryAuxMap m_auxMap;
 };
 }
 
@@ -8,6 +8,9 @@
 // CLHEP
 #include "CLHEP/Vector/ThreeVector.h"
 
+// FCCSW
+#include "SimG4Common/HitPools.h"
+
 namespace k4 {
 
 /** @class  Geant4CaloHit
@@ -55,13 +58,29 @@ public:
 // types and functions for G4 memory allocation, inspired by the G4VHit classes in Geant4 examples
 
 extern G4ThreadLocal G4Allocator<Geant4CaloHit>* Geant4CaloHitAllocator;
+/// Number of the hits of the calling thread not yet deleted (the pool may only be released without hits)
+extern G4ThreadLocal size_t Geant4CaloHitsInUse;
 
 inline void* Geant4CaloHit::operator new(size_t) {
-  if (!Geant4CaloHitAllocator) Geant4CaloHitAllocator = new G4Allocator<Geant4CaloHit>;
-  return (void*)Geant4CaloHitAllocator->MallocSingle();
+  if (!Geant4CaloHitAllocator) {
+    Geant4CaloHitAllocator = new G4Allocator<Geant4CaloHit>;
+    const unsigned int pageFactor = sim::hitPoolPageFactor(Geant4CaloHitAllocator->GetPageSize());
+    if (pageFactor > 1) Geant4CaloHitAllocator->IncreasePageSize(pageFactor);
+  }
+  ++Geant4CaloHitsInUse;
+  const size_t numPages = Geant4CaloHitAllocator->GetNoPages();
+  void* hit = Geant4CaloHitAllocator->MallocSingle();
+  // the first hit after the pool grew is at the start of the new page
+  if (Geant4CaloHitAllocator->GetNoPages() != numPages) {
+    sim::adviseHitPoolPage(hit, Geant4CaloHitAllocator->GetPageSize());
+  }
+  return hit;
 }
 
-inline void Geant4CaloHit::operator delete(void* hit) { Geant4CaloHitAllocator->FreeSingle((Geant4CaloHit*)hit); }
+inline void Geant4CaloHit::operator delete(void* hit) {
+  --Geant4CaloHitsInUse;
+  Geant4CaloHitAllocator->FreeSingle((Geant4CaloHit*)hit);
+}
 
 }  // namespace k4 
 
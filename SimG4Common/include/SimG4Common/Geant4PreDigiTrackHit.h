@@ -8,6 +8,9 @@
 // CLHEP
 #include "CLHEP/Vector/ThreeVector.h"
 
+// FCCSW
+#include "SimG4Common/HitPools.h"
+
 namespace k4 {
 
 /** @class  Geant4PreDigiTrackHit 
@@ -66,13 +69,27 @@ public:
 typedef G4THitsCollection<Geant4PreDigiTrackHit> Geant4PreDigiTrackHitsCollection;
 
 extern G4ThreadLocal G4Allocator<Geant4PreDigiTrackHit>* Geant4PreDigiTrackHitAllocator;
+/// Number of the hits of the calling thread not yet deleted (the pool may only be released without hits)
+extern G4ThreadLocal size_t Geant4PreDigiTrackHitsInUse;
 
 inline void* Geant4PreDigiTrackHit::operator new(size_t) {
-  if (!Geant4PreDigiTrackHitAllocator) Geant4PreDigiTrackHitAllocator = new G4Allocator<Geant4PreDigiTrackHit>;
-  return (void*)Geant4PreDigiTrackHitAllocator->MallocSingle();
+  if (!Geant4PreDigiTrackHitAllocator) {
+    Geant4PreDigiTrackHitAllocator = new G4Allocator<Geant4PreDigiTrackHit>;
+    const unsigned int pageFactor = sim::hitPoolPageFactor(Geant4PreDigiTrackHitAllocator->GetPageSize());
+    if (pageFactor > 1) Geant4PreDigiTrackHitAllocator->IncreasePageSize(pageFactor);
+  }
+  ++Geant4PreDigiTrackHitsInUse;
+  const size_t numPages = Geant4PreDigiTrackHitAllocator->GetNoPages();
+  void* hit = Geant4PreDigiTrackHitAllocator->MallocSingle();
+  // the first hit after the pool grew is at the start of the new page
+  if (Geant4PreDigiTrackHitAllocator->GetNoPages() != numPages) {
+    sim::adviseHitPoolPage(hit, Geant4PreDigiTrackHitAllocator->GetPageSize());
+  }
+  return hit;
 }
 
 inline void Geant4PreDigiTrackHit::operator delete(void* hit) {
+  --Geant4PreDigiTrackHitsInUse;
   Geant4PreDigiTrackHitAllocator->FreeSingle((Geant4PreDigiTrackHit*)hit);
 }
 
@@ -0,0 +1,52 @@
+#ifndef SIMG4COMMON_GEOMETRYCACHE_H
+#define SIMG4COMMON_GEOMETRYCACHE_H
+
+// Geant
+#include "G4GDMLAuxStructType.hh"
+
+// STL
+#include <cstdint>
+#include <map>
+#include <string>
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+
+/** SimG4Common/SimG4Common/GeometryCache.h GeometryCache.h
+ *
+ *  Binary cache of a Geant4 geometry read from GDML, so that the following jobs do not need to parse the XML.
+ *  The cache holds the isotopes, elements, materials, solids, logical volumes and placements, and the auxiliary
+ *  information of the volumes. Only the simple placements and the CSG solids without booleans (box, tube, cone,
+ *  trapezoid, sphere, orb, torus, polycone, polyhedra) are supported; optical properties and surfaces are not.
+ *  The cache is written for a key (hash of the GDML file and of the Geant4 version) and not read for another one.
+ */
+
+namespace sim {
+/// Auxiliary information of the logical volumes (as in G4GDMLParser::GetAuxMap)
+typedef std::map<G4LogicalVolume*, G4GDMLAuxListType> GeometryAuxMap;
+/** Key of the cache of a geometry file.
+ *  @param[in] aFileName name of the GDML file
+ *  @returns hash of the content of the file and of the Geant4 version (0 if the file cannot be read)
+ */
+std::uint64_t geometryCacheKey(const std::string& aFileName);
+/** Write the geometry to the cache.
+ *  @param[in] aFileName name of the cache file
+ *  @param[in] aKey key of the geometry
+ *  @param[in] aWorld world volume
+ *  @param[in] aAuxMap auxiliary information of the volumes
+ *  @param[out] aError reason for which the geometry was not written
+ *  @returns false if the geometry is not supported or the file cannot be written (nothing is written then)
+ */
+bool writeGeometryCache(const std::string& aFileName, std::uint64_t aKey, const G4VPhysicalVolume& aWorld,
+                        const GeometryAuxMap& aAuxMap, std::string& aError);
+/** Read the geometry from the cache.
+ *  @param[in] aFileName name of the cache file
+ *  @param[in] aKey key of the geometry
+ *  @param[out] aAuxMap auxiliary information of the volumes
+ *  @returns world volume, nullptr if the file does not exist, was written for another key or is corrupted (the file
+ *  is checked before any Geant4 object is created)
+ */
+G4VPhysicalVolume* readGeometryCache(const std::string& aFileName, std::uint64_t aKey, GeometryAuxMap& aAuxMap);
+}
+
+#endif /* SIMG4COMMON_GEOMETRYCACHE_H */
@@ -0,0 +1,113 @@
+#ifndef SIMG4COMMON_HITBUFFER_H
+#define SIMG4COMMON_HITBUFFER_H
+
+// Geant4
+#include "G4VHitsCollection.hh"
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** @class sim::HitBuffer SimG4Common/SimG4Common/HitBuffer.h HitBuffer.h
+ *
+ *  Hits collection storing the energy deposits of a readout as a structure of arrays (one array per member), filled
+ *  directly by the buffered sensitive detectors (BufferedCalorimeterSD, BufferedTrackerSD) instead of one G4VHit
+ *  allocated per step. The save tools (SimG4SaveCalHits, SimG4SaveTrackerHits) convert the arrays in bulk.
+ *  There are no hit objects: GetHit() returns nullptr, so the tools reading the hits (also SimG4StreamCalHits,
+ *  SimG4SaveSamplingFraction, SimG4SaveShowerLibrary and InspectHitsCollectionsTool) read the arrays of a buffer.
+ *  Positions are those of the pre-step point, in the Geant4 units. The post-step position (postX, postY, postZ) is
+ *  only filled for the trackers. Buffers without positions (e.g. of BufferedEnergyCalorimeterSD) leave x, y and z
+ *  empty. The weights of the deposits (the weight of the track at the deposit, changed by the biasing) are only
+ *  stored from the first deposit with a weight other than 1: the deposits after the end of the array have weight 1.
+ */
+
+namespace sim {
+class HitBuffer : public G4VHitsCollection {
+public:
+  /** Constructor.
+   *  @param[in] aDetectorName name of the sensitive detector
+   *  @param[in] aCollectionName name of the collection (readout)
+   *  @param[in] aPostStep flag whether the post-step positions are stored
+   *  @param[in] aCapacity number of deposits for which the arrays are allocated (e.g. the size of the previous event)
+   *  @param[in] aPositions flag whether the pre-step positions are stored
+   */
+  HitBuffer(const G4String& aDetectorName, const G4String& aCollectionName, bool aPostStep, size_t aCapacity = 0,
+            bool aPositions = true);
+  virtual ~HitBuffer();
+  /// Append a deposit
+  inline void add(uint64_t aCellID, double aEnergy, double aX, double aY, double aZ, double aTime, int aTrackId,
+                  int aPdg) {
+    cellID.push_back(aCellID);
+    energy.push_back(aEnergy);
+    x.push_back(aX);
+    y.push_back(aY);
+    z.push_back(aZ);
+    time.push_back(aTime);
+    trackId.push_back(aTrackId);
+    pdg.push_back(aPdg);
+  }
+  /// Append a deposit without position
+  inline void add(uint64_t aCellID, double aEnergy, double aTime, int aTrackId, int aPdg) {
+    cellID.push_back(aCellID);
+    energy.push_back(aEnergy);
+    time.push_back(aTime);
+    trackId.push_back(aTrackId);
+    pdg.push_back(aPdg);
+  }
+  /// Append a deposit with its post-step position
+  inline void add(uint64_t aCellID, double aEnergy, double aX, double aY, double aZ, double aTime, int aTrackId,
+                  int aPdg, double aPostX, double aPostY, double aPostZ) {
+    add(aCellID, aEnergy, aX, aY, aZ, aTime, aTrackId, aPdg);
+    postX.push_back(aPostX);
+    postY.push_back(aPostY);
+    postZ.push_back(aPostZ);
+  }
+  /** Append the deposits of another buffer (e.g. of a sub-event).
+   *  @param[in] aOther buffer whose deposits are appended
+   *  @param[in] aTrackIdOffset offset added to the track IDs of the appended deposits
+   */
+  void append(const HitBuffer& aOther, int aTrackIdOffset);
+  /** Set the weight of the last deposits.
+   *  @param[in] aFirst index of the first deposit of the weight (e.g. of the step)
+   *  @param[in] aWeight weight of the deposits from aFirst to the last one
+   */
+  inline void setWeight(size_t aFirst, double aWeight) {
+    if (aWeight == 1 && weight.size() <= aFirst) return;
+    weight.resize(size(), 1);
+    std::fill(weight.begin() + aFirst, weight.end(), aWeight);
+  }
+  /// Weight of a deposit
+  inline double weightOf(size_t aIndex) const { return aIndex < weight.size() ? weight[aIndex] : 1; }
+  /// Number of deposits
+  inline size_t size() const { return cellID.size(); }
+  /// Flag whether the post-step positions are stored
+  inline bool hasPostStep() const { return m_postStep; }
+  /// Flag whether the pre-step positions are stored
+  inline bool hasPositions() const { return m_positions; }
+  /// Method from base class, number of deposits
+  virtual size_t GetSize() const override { return cellID.size(); }
+  /// Method from base class, there are no hit objects
+  virtual G4VHit* GetHit(size_t) const override { return nullptr; }
+
+  // these members are public, following the example of G4VHit:
+
+  std::vector<uint64_t> cellID;
+  std::vector<double> energy;
+  std::vector<double> x, y, z;
+  std::vector<double> time;
+  std::vector<int> trackId;
+  std::vector<int> pdg;
+  std::vector<double> postX, postY, postZ;
+  std::vector<double> weight;
+
+private:
+  /// Flag whether the post-step positions are stored
+  bool m_postStep;
+  /// Flag whether the pre-step positions are stored
+  bool m_positions;
+};
+}
+
+#endif /* SIMG4COMMON_HITBUFFER_H */
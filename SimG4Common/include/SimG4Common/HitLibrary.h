@@ -0,0 +1,131 @@
+#ifndef SIMG4COMMON_HITLIBRARY_H
+#define SIMG4COMMON_HITLIBRARY_H
+
+// FCCSW
+#include "SimG4Common/MappedFile.h"
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/** @class sim::HitLibrary SimG4Common/SimG4Common/HitLibrary.h HitLibrary.h
+ *
+ *  Library of the hits of pre-simulated interactions (e.g. minimum-bias events), read from a binary file mapped in
+ *  memory, so that its pages are shared by all the threads and processes on the node overlaying the same library.
+ *  The file starts with the header HitLibrary::Header, followed by one block per interaction: the numbers of the
+ *  calorimeter and of the tracker hits (two uint32), the calorimeter hits (HitLibrary::CaloHit, one per cell) and the
+ *  tracker hits (HitLibrary::TrackerHit), both sorted by cellID. The index at the end of the file gives the offset of
+ *  each block (uint64). All the values are in the EDM units.
+ *  The library is written by sim::HitLibraryWriter.
+ */
+
+namespace sim {
+class HitLibrary {
+public:
+  /// Header of the file of the library
+  struct Header {
+    /// "K4HLIB1" followed by the zero
+    char magic[8];
+    /// Number of interactions
+    uint64_t numInteractions;
+    /// Offset of the index of the blocks in the file
+    uint64_t indexOffset;
+  };
+  /// Calorimeter hit (summed over the deposits in the cell)
+  struct CaloHit {
+    uint64_t cellID;
+    float energy;
+    float position[3];
+  };
+  /// Tracker hit (as in the EDM SimTrackerHit)
+  struct TrackerHit {
+    uint64_t cellID;
+    double position[3];
+    float momentum[3];
+    float eDep;
+    float time;
+    float pathLength;
+  };
+  /// Hits of one interaction (within the mapped file)
+  struct Interaction {
+    const CaloHit* caloHits = nullptr;
+    uint32_t numCaloHits = 0;
+    const TrackerHit* trackerHits = nullptr;
+    uint32_t numTrackerHits = 0;
+  };
+  /** Constructor. Maps the file in memory.
+   *  @param[in] aFileName name of the file of the library
+   */
+  explicit HitLibrary(const std::string& aFileName);
+  /// Destructor. Unmaps the file.
+  ~HitLibrary();
+  HitLibrary(const HitLibrary&) = delete;
+  HitLibrary& operator=(const HitLibrary&) = delete;
+
+  /// Whether the file was mapped successfully
+  bool isValid() const { return m_index != nullptr; }
+  /// Reason why the file could not be mapped
+  const std::string& error() const { return m_error; }
+  /// Number of interactions in the library
+  size_t size() const { return m_header.numInteractions; }
+  /** Get the hits of an interaction.
+   *  @param[in] aIndex index of the interaction
+   *  @param[out] aInteraction hits of the interaction
+   *  @returns whether the block of the interaction lies within the file
+   */
+  bool interaction(size_t aIndex, Interaction& aInteraction) const;
+  /// Magic string of the file
+  static constexpr const char* kMagic = "K4HLIB1";
+
+private:
+  /// Header of the library
+  Header m_header;
+  /// Mapped file
+  MappedFile m_file;
+  /// Offsets of the blocks of the interactions (within the mapped file)
+  const uint64_t* m_index = nullptr;
+  /// Reason why the file could not be mapped
+  std::string m_error;
+};
+
+/** @class sim::HitLibraryWriter SimG4Common/SimG4Common/HitLibrary.h HitLibrary.h
+ *
+ *  Writer of the library of hits read by sim::HitLibrary. The blocks of the interactions are written as they are added,
+ *  only their offsets are kept in memory until the index is written when the library is closed.
+ */
+class HitLibraryWriter {
+public:
+  /** Constructor. Opens the file and writes a provisional header.
+   *  @param[in] aFileName name of the file of the library
+   */
+  explicit HitLibraryWriter(const std::string& aFileName);
+  /// Destructor. Closes the library if not closed yet.
+  ~HitLibraryWriter();
+  HitLibraryWriter(const HitLibraryWriter&) = delete;
+  HitLibraryWriter& operator=(const HitLibraryWriter&) = delete;
+
+  /** Add an interaction, the hits are sorted by cellID.
+   *  @param[in] aCaloHits calorimeter hits (one per cell)
+   *  @param[in] aTrackerHits tracker hits
+   */
+  void add(std::vector<HitLibrary::CaloHit>& aCaloHits, std::vector<HitLibrary::TrackerHit>& aTrackerHits);
+  /** Write the index and the final header and close the file.
+   *  @returns whether the whole library was written
+   */
+  bool close();
+  /// Whether the file could be opened
+  bool isOpen() const { return m_file.is_open(); }
+  /// Number of the interactions added
+  size_t size() const { return m_offsets.size(); }
+
+private:
+  /// File of the library
+  std::ofstream m_file;
+  /// Offsets of the blocks
+  std::vector<uint64_t> m_offsets;
+};
+}
+#endif /* SIMG4COMMON_HITLIBRARY_H */
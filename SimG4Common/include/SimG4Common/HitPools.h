@@ -0,0 +1,65 @@
+#ifndef SIMG4COMMON_HITPOOLS_H
+#define SIMG4COMMON_HITPOOLS_H
+
+// STL
+#include <cstddef>
+
+/** SimG4Common/SimG4Common/HitPools.h HitPools.h
+ *
+ *  Management of the G4Allocator pools of k4::Geant4CaloHit and k4::Geant4PreDigiTrackHit.
+ *  The pools are thread-local and created with the first hit of the thread. A pool never returns its pages on its
+ *  own, hence after a large event it keeps the memory of that event for the rest of the job; releaseHitPools() frees
+ *  the pages of the pools above a size, once no hit of the thread is alive anymore.
+ *  If the huge pages are used (SimG4Common/HugePages.h), the pages of the pools span several huge pages and each new
+ *  page is advised to be backed by them.
+ */
+
+namespace sim {
+/// Statistics of a pool of the calling thread
+struct HitPoolStatistics {
+  /// memory reserved by the pool [bytes]
+  size_t allocatedSize = 0;
+  /// largest memory reserved by the pool when checked by releaseHitPools() [bytes]
+  size_t peakSize = 0;
+  /// number and size of the pages of the pool [bytes]
+  size_t numPages = 0;
+  size_t pageSize = 0;
+  /// number of the hits of the pool not yet deleted
+  size_t numHitsInUse = 0;
+  /// number of times the pages of the pool were released
+  unsigned int numReleases = 0;
+};
+/** Set the factor by which the page size of the pools is increased (larger pages for the events with many hits).
+ *  It applies to the pools created afterwards, hence it needs to be set before the first hit of any thread.
+ *  @param[in] aFactor factor of the default G4Allocator page size (1: default)
+ */
+void setHitPoolPageFactor(unsigned int aFactor);
+/// Factor by which the page size of the pools is increased when they are created
+unsigned int hitPoolPageFactor();
+/** Factor by which the page size of a pool is increased when it is created, raised with the huge pages so that its
+ *  pages span several of them.
+ *  @param[in] aPageSize default page size of the pool [bytes]
+ */
+unsigned int hitPoolPageFactor(size_t aPageSize);
+/** Advise the kernel to back a new page of a pool with huge pages (if they are used), called when the pool grew.
+ *  @param[in] aPage start of the page (the first hit allocated after the pool grew)
+ *  @param[in] aSize size of the page [bytes]
+ */
+void adviseHitPoolPage(void* aPage, size_t aSize);
+/** Statistics of the pool of k4::Geant4CaloHit of the calling thread.
+ *  @returns statistics (zero if no hit was created in this thread)
+ */
+HitPoolStatistics caloHitPoolStatistics();
+/** Statistics of the pool of k4::Geant4PreDigiTrackHit of the calling thread.
+ *  @returns statistics (zero if no hit was created in this thread)
+ */
+HitPoolStatistics trackHitPoolStatistics();
+/** Release the pages of the pools of the calling thread reserving more than the threshold, if none of their hits is
+ *  alive (e.g. an event with hits still waits for its output). To be called in the thread that deleted the events.
+ *  @param[in] aThreshold size of the pool above which it is released [bytes]
+ *  @returns number of the pools released
+ */
+unsigned int releaseHitPools(size_t aThreshold);
+}
+
+#endif /* SIMG4COMMON_HITPOOLS_H */
@@ -0,0 +1,41 @@
+#ifndef SIMG4COMMON_HITSCOLLECTIONIDS_H
+#define SIMG4COMMON_HITSCOLLECTIONIDS_H
+
+// STL
+#include <string>
+#include <vector>
+
+// Geant
+class G4HCofThisEvent;
+
+/** @class HitsCollectionIDs SimG4Common/SimG4Common/HitsCollectionIDs.h HitsCollectionIDs.h
+ *
+ *  Indices of the hits collections with the given names in G4HCofThisEvent.
+ *  They are resolved from the collection names at the first event (the sensitive detectors may be known only to the
+ *  worker threads), and resolved again only if the collections of an event do not match them anymore.
+ *  The names passed to get() are assumed to be the same for all the events.
+ */
+
+namespace sim {
+class HitsCollectionIDs {
+public:
+  /** Get the indices of the collections.
+   *  @param[in] aCollections hits collections of the event
+   *  @param[in] aNames names of the collections (readouts)
+   *  @returns indices of the collections present in the event, in the order of the collections in the event
+   */
+  const std::vector<int>& get(const G4HCofThisEvent& aCollections, const std::vector<std::string>& aNames);
+
+private:
+  /// Check if the resolved indices still point to the same collections
+  bool matches(const G4HCofThisEvent& aCollections) const;
+  /// Indices of the collections
+  std::vector<int> m_ids;
+  /// Names of the collections at the resolved indices
+  std::vector<std::string> m_names;
+  /// Number of collections in the event for which the indices were resolved (-1: not resolved)
+  int m_numCollections = -1;
+};
+}
+
+#endif /* SIMG4COMMON_HITSCOLLECTIONIDS_H */
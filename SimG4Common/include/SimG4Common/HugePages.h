@@ -0,0 +1,40 @@
+#ifndef SIMG4COMMON_HUGEPAGES_H
+#define SIMG4COMMON_HUGEPAGES_H
+
+// STL
+#include <cstddef>
+#include <string>
+
+/** SimG4Common/SimG4Common/HugePages.h HugePages.h
+ *
+ *  Opt-in placement of the large memory of the simulation (the pools of the hits, the field maps) on transparent huge
+ *  pages, which reduces the misses of the TLB when the memory is accessed randomly. The kernel is advised to back the
+ *  ranges with huge pages (madvise); whether it does depends on its mode (/sys/kernel/mm/transparent_hugepage), on
+ *  the alignment of the ranges (only the huge pages entirely within a range) and on the fragmentation of the memory.
+ *  The policy is process-wide and needs to be set before the memory is allocated.
+ */
+
+namespace sim {
+/** Enable or disable the advice of huge pages for the memory allocated afterwards.
+ *  @param[in] aEnabled flag whether the huge pages are used
+ */
+void setHugePages(bool aEnabled);
+/// Flag whether the huge pages are used
+bool hugePages();
+/** Size of the transparent huge pages of the system.
+ *  @returns size of a huge page [bytes] (2 MB if unknown)
+ */
+size_t hugePageSize();
+/** Mode of the transparent huge pages of the system.
+ *  @returns "always", "madvise" or "never" (empty if unknown)
+ */
+std::string hugePagesMode();
+/** Advise the kernel to back the memory with huge pages, if they are used.
+ *  @param[in] aStart start of the range
+ *  @param[in] aSize size of the range [bytes]
+ *  @returns true if the advice was given
+ */
+bool adviseHugePages(void* aStart, size_t aSize);
+}
+
+#endif /* SIMG4COMMON_HUGEPAGES_H */
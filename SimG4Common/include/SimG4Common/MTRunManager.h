@@ -0,0 +1,48 @@
+#ifndef SIMG4COMMON_MTRUNMANAGER_H
+#define SIMG4COMMON_MTRUNMANAGER_H
+
+// Geant4
+#include "G4MTRunManager.hh"
+
+// Gaudi
+#include "GaudiKernel/StatusCode.h"
+
+/** @class MTRunManager SimG4Common/SimG4Common/MTRunManager.h MTRunManager.h
+ *
+ *  Master run manager for the multi-threaded simulation in Geant4.
+ *  It owns the shared (read-only) geometry and physics tables. Contrary to G4MTRunManager, it does not spawn
+ *  nor steer the worker threads: those are created by SimG4Svc (see sim::WorkerThread) and receive the events from
+ *  GAUDI one by one, so the event loop stays under control of GAUDI.
+ */
+
+namespace sim {
+class MTRunManager : public G4MTRunManager {
+public:
+  /// Constructor.
+  MTRunManager();
+  /// Destructor.
+  ~MTRunManager();
+  /** Initialization.
+   *  It substitutes the G4MTRunManager::BeamOn() method (excluding the loop over the events and the creation of the
+   * threads). Prepares the stack of UI commands that are replayed by each worker thread.
+   *  @warning This method should be called \b after calling SetUserInitialization(G4VUserDetectorConstruction*),
+   * SetUserInitialization(G4VUserPhysicsList*) and SetUserInitialization(G4VUserActionInitialization*).
+   *  @returns the status code
+   */
+  StatusCode start();
+  /// Finalization.
+  void finalize();
+
+protected:
+  /// Workers are not created by Geant, only the decay channels are set up
+  virtual void InitializeEventLoop(G4int aNumEvents, const char* aMacroFile = 0, G4int aNumSelect = -1) override;
+  /// Workers are not steered by Geant, nothing to wait for
+  virtual void WaitForReadyWorkers() override {}
+  /// Workers are not steered by Geant, nothing to wait for
+  virtual void WaitForEndEventLoopWorkers() override {}
+  /// Workers are terminated by their owner (SimG4Svc)
+  virtual void TerminateWorkers() override {}
+};
+}
+
+#endif /* SIMG4COMMON_MTRUNMANAGER_H */
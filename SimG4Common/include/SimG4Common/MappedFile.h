@@ -0,0 +1,70 @@
+#ifndef SIMG4COMMON_MAPPEDFILE_H
+#define SIMG4COMMON_MAPPEDFILE_H
+
+// STL
+#include <cstddef>
+#include <string>
+
+/** @class sim::MappedFile SimG4Common/SimG4Common/MappedFile.h MappedFile.h
+ *
+ *  Read-only memory mapping of a binary file (field maps, hit and shower libraries, tables of the cells), unmapped
+ *  at the destruction. The mapping is shared: the pages are in the page cache once, for all the processes and jobs
+ *  using the file, and are only read from the disk when first accessed. The file is closed once mapped.
+ *  A private anonymous copy of the mapping may be made (replicate()), e.g. to place a copy in each NUMA domain.
+ */
+
+namespace sim {
+class MappedFile {
+public:
+  /// Constructor of an empty (not mapped) file
+  MappedFile() = default;
+  /** Map a file.
+   *  @param[in] aFileName name of the file
+   *  @param[in] aMinSize size below which the file is not mapped (e.g. the size of its header)
+   *  @param[in] aContent description of the content of the file, for the error messages (e.g. "a field map")
+   */
+  MappedFile(const std::string& aFileName, size_t aMinSize, const std::string& aContent);
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& aOther) noexcept;
+  MappedFile& operator=(MappedFile&& aOther) noexcept;
+  /** Copy the mapping to private anonymous memory (advised to be backed by huge pages before the copy, if they are
+   *  used), read-only once copied.
+   *  @returns copy (not mapped if the memory could not be allocated, with the error)
+   */
+  MappedFile replicate() const;
+  /** Advise the kernel to back the mapping with huge pages, if they are used (see HugePages.h).
+   *  @returns true if the advice was given
+   */
+  bool adviseHugePages();
+  /// Unmap the file
+  void reset();
+  /// Flag whether the file is mapped
+  inline bool isMapped() const { return m_data != nullptr; }
+  /// Flag whether the file could be opened (false e.g. if it does not exist)
+  inline bool isOpened() const { return m_opened; }
+  /// Start of the mapping (nullptr if not mapped)
+  inline const void* data() const { return m_data; }
+  /// Pointer at the offset within the mapping
+  template <typename T>
+  inline const T* at(size_t aOffset) const {
+    return reinterpret_cast<const T*>(static_cast<const char*>(m_data) + aOffset);
+  }
+  /// Size of the mapping [bytes]
+  inline size_t size() const { return m_size; }
+  /// Reason why the file could not be mapped (empty if mapped)
+  inline const std::string& error() const { return m_error; }
+
+private:
+  /// Start of the mapping (nullptr if not mapped) and its size
+  void* m_data = nullptr;
+  size_t m_size = 0;
+  /// Flag whether the file could be opened
+  bool m_opened = false;
+  /// Reason why the file could not be mapped
+  std::string m_error;
+};
+}
+
+#endif /* SIMG4COMMON_MAPPEDFILE_H */
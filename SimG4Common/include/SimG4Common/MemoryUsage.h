@@ -0,0 +1,35 @@
+#ifndef SIMG4COMMON_MEMORYUSAGE_H
+#define SIMG4COMMON_MEMORYUSAGE_H
+
+// STL
+#include <cstddef>
+
+/** SimG4Common/SimG4Common/MemoryUsage.h MemoryUsage.h
+ *
+ *  Sampling of the memory used by the process (resident set, heap) and by the G4Allocator pools of the hits.
+ */
+
+namespace sim {
+/** Resident set size of the process.
+ *  @returns resident memory [MB] (0 if it cannot be read)
+ */
+double residentMemory();
+/** Peak resident set size of the process since its start.
+ *  @returns peak resident memory [MB]
+ */
+double peakResidentMemory();
+/** Memory allocated on the heap by malloc (in use, not returned to the system).
+ *  @returns heap memory in use [MB]
+ */
+double heapMemory();
+/** Memory reserved by the G4Allocator pool of k4::Geant4CaloHit of the calling thread.
+ *  @returns size of the pool [bytes] (0 if no hit was created in this thread)
+ */
+size_t caloHitPoolSize();
+/** Memory reserved by the G4Allocator pool of k4::Geant4PreDigiTrackHit of the calling thread.
+ *  @returns size of the pool [bytes] (0 if no hit was created in this thread)
+ */
+size_t trackHitPoolSize();
+}
+
+#endif /* SIMG4COMMON_MEMORYUSAGE_H */
@@ -0,0 +1,36 @@
+#ifndef SIMG4COMMON_NUMATOPOLOGY_H
+#define SIMG4COMMON_NUMATOPOLOGY_H
+
+// STL
+#include <vector>
+
+/** SimG4Common/SimG4Common/NumaTopology.h NumaTopology.h
+ *
+ *  NUMA domains of the cores of the job and pinning of the threads to them, for the placement of the worker threads
+ *  of the multi-threaded simulation and of their memory (allocated on the domain of the thread that first writes it).
+ *  The domains are read from /sys/devices/system/node; without it all the cores are in one domain.
+ */
+
+namespace sim {
+/** Cores of the job (its CPU affinity mask) in each NUMA domain.
+ *  @returns the cores of each domain with any core of the job, in the order of the domains
+ */
+std::vector<std::vector<int>> numaDomains();
+/** NUMA domain of the core on which the calling thread currently runs.
+ *  @returns index of the domain in numaDomains(), 0 if unknown
+ */
+int currentNumaDomain();
+/** Cores to which the workers are pinned, spread over the NUMA domains in turn.
+ *  @param[in] aNumWorkers number of the workers
+ *  @param[in] aPerCore flag whether each worker is pinned to one core (otherwise to all the cores of a domain)
+ *  @returns the cores of each worker
+ */
+std::vector<std::vector<int>> workerCores(unsigned int aNumWorkers, bool aPerCore);
+/** Pin the calling thread to the cores.
+ *  @param[in] aCores cores on which the thread may run
+ *  @returns true if the affinity of the thread was set
+ */
+bool pinCurrentThread(const std::vector<int>& aCores);
+}
+
+#endif /* SIMG4COMMON_NUMATOPOLOGY_H */
@@ -3,6 +3,7 @@
 
 // datamodel
 #include "edm4hep/MCParticle.h"
+#include "podio/ObjectID.h"
 
 // Geant4
 #include "G4VUserPrimaryParticleInformation.hh"
@@ -13,11 +14,15 @@
 /** @class FastSimParticleInformation SimG4Common/SimG4Common/FastSimParticleInformation.h FastSimParticleInformation.h
  *
  *  Describes the information that can be assosiated with a G4PrimaryParticle class object.
- *  It contains handles to the EDM Monte Carlo object.
+ *  It contains the identifier of the EDM Monte Carlo object (collection ID and index), not a handle to it: the
+ *  information belongs to the G4Event, which may be deleted by another thread after the event store released the
+ *  input collection, so the MC particle is looked up in the collection of the same event when the output is saved.
  *  It is used for the fast simulation in Geant to associate MC particle with a 'reconstructed' particle.
  *  MCParticle information is filled when EDM event is translated to G4Event.
  *  Momentum, status and vertex info is filled at the end of Geant's track processing
  *  (SaveParticlesTrackingAction::PostUserTrackingAction).
+ *  Objects are allocated from a pool (G4Allocator) shared by the threads, as the events are created by the Gaudi
+ *  thread and deleted by the worker thread that simulated them.
  *
  *  @author Anna Zaborowska
  */
@@ -31,12 +36,16 @@ public:
   explicit ParticleInformation(const edm4hep::MCParticle& aMCpart);
   /// A destructor
   virtual ~ParticleInformation();
+  /// Allocation from the pool of the information objects
+  void* operator new(size_t);
+  /// Deallocation to the pool of the information objects
+  void operator delete(void* aInformation);
   /// A printing method
   virtual void Print() const final;
-  /** Getter of the MCParticle.
-   *  @returns EDM MCParticle.
+  /** Getter of the identifier of the MCParticle.
+   *  @returns collection ID and index of the EDM MCParticle.
    */
-  const edm4hep::MCParticle& mcParticle() const;
+  const podio::ObjectID& mcParticleID() const;
   /** Setter of the end-of-tracking momentum (used for fast simulation).
    *  @param[in] aMom Particle momentum.
    */
@@ -71,8 +80,8 @@ public:
   bool smeared() const;
 
 private:
-  /// EDM MC particle
-  const edm4hep::MCParticle m_mcParticle;
+  /// Identifier of the EDM MC particle
+  const podio::ObjectID m_mcParticleID;
   /// Particle momentum at the end of tracking (filled for fast-sim)
   CLHEP::Hep3Vector m_endMomentum;
   /// Particle vertex position saved at the end of tracking (filled for fast-sim)
@@ -1,6 +1,9 @@
 #ifndef SIMG4COMMON_RUNMANAGER_H
 #define SIMG4COMMON_RUNMANAGER_H
 
+// FCCSW
+#include "SimG4Common/EventWatchdog.h"
+
 // Geant4
 #include "G4RunManager.hh"
 
@@ -38,7 +41,9 @@ public:
    *  It substitutes the G4RunManager::ProcessOneEvent(int) method (excluding the generation part).
    *  It checks if the previous event has been fully processed (including a call to terminateEvent()) and begins its
    * simulation.
-   *  @warning Each call to processEvent() should be followed by a call to terminateEvent().
+   *  An event aborted by another component than the watchdog (e.g. a fast simulation model that failed) is
+   * incomplete: processEvent() then fails and gives the event back to the caller, with its hits.
+   *  @warning Each successful call to processEvent() should be followed by a call to terminateEvent().
    *  @param[in] aEvent a generated event to be processed in a simulation
    *  @returns the status code
    */
@@ -55,12 +60,42 @@ public:
    *  @returns the status code
    */
   StatusCode terminateEvent();
+  /** Termination of the event processing, without deletion of the event.
+   *  The ownership of the event (with its hits collections) is transferred to the caller.
+   *  @param[out] aEvent a processed event
+   *  @returns the status code
+   */
+  StatusCode detachEvent(G4Event*& aEvent);
+  /** Take over an event that was not simulated as a whole (e.g. merged from several events), so that it may be
+   * retrieved and terminated as if it had been processed here.
+   *  @param[in] aEvent an event to be adopted, deleted at termination
+   *  @returns the status code
+   */
+  StatusCode adoptEvent(G4Event& aEvent);
+  /** Install the watchdog of the events (sim::EventWatchdog), wrapping the user stepping action.
+   *  Aborted events are reported by processEvent(), which still succeeds.
+   *  @warning This method should be called \b after the user actions are set, and only once.
+   *  @param[in] aBudget budgets of the event (nothing is installed if no budget is set)
+   */
+  void setWatchdog(const EventWatchdog::Budget& aBudget);
+  /** Replace the geometry between two runs, keeping the physics list and its tables.
+   *  The stores of the volumes and solids are cleaned and the new geometry is constructed at once. The regions (but
+   *  the default one of the world) keep their cuts and models, and are attached to the new logical volumes with the
+   *  names of their previous root volumes.
+   *  @warning This method should be called between finalize() and start(), for a detector construction that does
+   * not register sensitive detectors again.
+   *  @param[in] aConstruction new detector construction (ownership is transferred, the previous one is deleted)
+   *  @returns the status code (failure if a root volume of a region is missing in the new geometry)
+   */
+  StatusCode rebuildGeometry(G4VUserDetectorConstruction* aConstruction);
   /// Finalization.
   void finalize();
 
 private:
   /// Flag indicating if the previous Event was terminated in Geant successfuly
   bool m_prevEventTerminated;
+  /// Watchdog of the events (owned by the stepping manager, null if not installed)
+  EventWatchdog* m_watchdog = nullptr;
   /// Message Service
   ServiceHandle<IMessageSvc> m_msgSvc;
   /// Message Stream
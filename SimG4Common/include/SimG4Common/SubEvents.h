@@ -0,0 +1,49 @@
+#ifndef SIMG4COMMON_SUBEVENTS_H
+#define SIMG4COMMON_SUBEVENTS_H
+
+// STL
+#include <vector>
+
+// Geant
+class G4Event;
+class G4PrimaryVertex;
+
+/** SimG4Common/SimG4Common/SubEvents.h SubEvents.h
+ *
+ *  Splitting of an event into sub-events (subsets of its primary vertices) that may be simulated in parallel,
+ *  and merging of the simulated sub-events (hits collections and particle history) back into the event.
+ */
+
+namespace sim {
+/** Estimate the cost of simulating the event from its primaries: the showers grow with the kinetic energy of the
+ *  primary particles, and each of them costs in addition a fixed amount (e.g. its tracking through the tracker).
+ *  Only the order of the costs of the events matters.
+ *  @param[in] aEvent event (or primary vertex, see the overload) with its primaries
+ *  @param[in] aCostPerPrimary fixed cost of a primary particle, as kinetic energy (Geant4 units)
+ *  @returns estimated cost, as kinetic energy
+ */
+double estimateCost(const G4Event& aEvent, double aCostPerPrimary);
+double estimateCost(const G4PrimaryVertex& aVertex, double aCostPerPrimary);
+/** Split the event into sub-events, primary vertices are distributed in turn between the sub-events or, if balanced,
+ *  in the decreasing order of their cost each to the sub-event with the lowest cost (see estimateCost()).
+ *  Vertices and particles are copied, without their user information.
+ *  @param[in] aEvent event to be split
+ *  @param[in] aNumSubEvents maximum number of sub-events (not more than the number of primary vertices)
+ *  @param[in] aCostPerPrimary fixed cost of a primary particle for the balanced splitting (negative: in turn)
+ *  @returns sub-events (ownership is transferred to the caller)
+ */
+std::vector<G4Event*> splitEvent(const G4Event& aEvent, unsigned int aNumSubEvents, double aCostPerPrimary = -1);
+/** Merge the hits collections and the particle history of the simulated sub-events into the event.
+ *  G4 track IDs of each sub-event are shifted by the highest track ID of the previous sub-events, so that they stay
+ *  unique (and parent IDs consistent); cellIDs are unchanged as they depend on the geometry only.
+ *  Hits are copied, hence it needs to be called within the thread in which the merged event is deleted.
+ *  Only the collections of k4::Geant4CaloHit and k4::Geant4PreDigiTrackHit, and the hit buffers (sim::HitBuffer), may
+ *  be merged.
+ *  @param[in, out] aEvent event to which the sub-events are merged
+ *  @param[in] aSubEvents simulated sub-events, in the order of their creation
+ *  @returns number of hits collections that could not be merged
+ */
+unsigned int mergeSubEvents(G4Event& aEvent, const std::vector<G4Event*>& aSubEvents);
+}
+
+#endif /* SIMG4COMMON_SUBEVENTS_H */
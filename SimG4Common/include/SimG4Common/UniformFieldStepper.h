@@ -0,0 +1,70 @@
+#ifndef SIMG4COMMON_UNIFORMFIELDSTEPPER_H
+#define SIMG4COMMON_UNIFORMFIELDSTEPPER_H
+
+// FCCSW
+#include "SimG4Common/FieldCounters.h"
+
+// Geant 4
+#include "G4MagIntegratorStepper.hh"
+class G4ExactHelixStepper;
+class G4Mag_EqRhs;
+
+// STL
+#include <memory>
+
+/** @class sim::UniformFieldStepper SimG4Common/SimG4Common/UniformFieldStepper.h UniformFieldStepper.h
+ *
+ *  Stepper of the field uniform inside a cylinder (sim::ConstantField).
+ *  The steps that stay inside of the cylinder (decided from the position at the start and the step length, without
+ *  evaluating the field) follow the exact helix. The other steps, that may cross the boundary of the field, are
+ *  integrated with the fallback Runge-Kutta stepper.
+ *  The steps and the field evaluations of both steppers are counted, to estimate the evaluations saved by the helix.
+ */
+
+namespace sim {
+class UniformFieldStepper : public G4MagIntegratorStepper {
+public:
+  /// Steps and field evaluations of the helix and of the fallback stepper
+  struct Counters {
+    unsigned long helixSteps = 0;
+    unsigned long helixFieldCalls = 0;
+    unsigned long fallbackSteps = 0;
+    unsigned long fallbackFieldCalls = 0;
+    Counters& operator+=(const Counters& aOther);
+    /// Estimated evaluations saved: the helix steps, if integrated at the rate of the fallback stepper
+    double savedFieldCalls() const;
+  };
+  /** Constructor.
+   *  @param[in] aEquation equation of motion, shared with the fallback stepper (not owned)
+   *  @param[in] aField counting field of the equation (not owned)
+   *  @param[in] aFallback Runge-Kutta stepper on the same equation (owned)
+   *  @param[in] aRMax radius of the cylinder of the uniform field
+   *  @param[in] aZMax half-length of the cylinder of the uniform field
+   */
+  UniformFieldStepper(G4Mag_EqRhs* aEquation, const CountingField& aField, G4MagIntegratorStepper* aFallback,
+                      double aRMax, double aZMax);
+  virtual ~UniformFieldStepper();
+  virtual void Stepper(const G4double y[], const G4double dydx[], G4double h, G4double yout[],
+                       G4double yerr[]) final;
+  virtual G4double DistChord() const final;
+  virtual G4int IntegratorOrder() const final;
+  /// Steps and field evaluations of this stepper
+  const Counters& counters() const { return m_counters; }
+
+private:
+  /// Exact helix, used inside of the cylinder
+  std::unique_ptr<G4ExactHelixStepper> m_helix;
+  /// Runge-Kutta stepper, used at the boundary of the field
+  std::unique_ptr<G4MagIntegratorStepper> m_fallback;
+  /// Counting field of the equation
+  const CountingField& m_field;
+  /// Extent of the uniform field
+  double m_rMax;
+  double m_zMax;
+  /// Whether the last step followed the helix
+  bool m_lastHelix = false;
+  /// Steps and field evaluations
+  Counters m_counters;
+};
+}
+#endif /* SIMG4COMMON_UNIFORMFIELDSTEPPER_H */
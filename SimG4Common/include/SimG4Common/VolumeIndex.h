@@ -0,0 +1,77 @@
+#ifndef SIMG4COMMON_VOLUMEINDEX_H
+#define SIMG4COMMON_VOLUMEINDEX_H
+
+// STL
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class G4LogicalVolume;
+
+/** @class sim::VolumeIndex SimG4Common/SimG4Common/VolumeIndex.h VolumeIndex.h
+ *
+ *  Index of the logical volumes of the geometry by name, used by the region tools to find the volumes of their
+ *  regions. It holds the names of all the physical volumes (placements, at any depth) and of all the logical volumes
+ *  of the Geant4 volume stores, sorted, so that a name or a prefix is found without visiting the geometry tree.
+ *  The index is built once, at the first use after the geometry is constructed, and shared by all the region tools
+ *  (it is built again if the number of volumes in the stores has changed).
+ *  The names are matched as:
+ *  - Daughters: the placements in the world whose names contain the name (as the region tools always did),
+ *  - Exact: the volumes (placements or logical volumes, at any depth) of the name,
+ *  - Prefix: the volumes whose names start with the name,
+ *  - Regex: the volumes whose whole names match the regular expression.
+ */
+
+namespace sim {
+class VolumeIndex {
+public:
+  /// Matching of the names of the volumes
+  enum class Matching { Daughters, Exact, Prefix, Regex };
+  /** Matching of the job options, checked before the geometry is constructed.
+   *  @param[in] aMatchingName name of the matching ("daughters", "exact", "prefix" or "regex")
+   *  @param[in] aNames names, prefixes or regular expressions of the volumes
+   *  @param[out] aMatching matching
+   *  @returns error message, empty if the matching is known and the names are valid for it
+   */
+  static std::string configure(const std::string& aMatchingName, const std::vector<std::string>& aNames,
+                               Matching& aMatching);
+  /** Find the root volumes of the regions in the index of the current geometry.
+   *  @param[in] aNames names, prefixes or regular expressions of the volumes
+   *  @param[in] aMatching matching of the names
+   *  @param[out] aUnmatched names that match no volume (not filled if null)
+   *  @returns logical volumes matched, each once even if matched by several names
+   */
+  static std::vector<G4LogicalVolume*> match(const std::vector<std::string>& aNames, Matching aMatching,
+                                             std::vector<std::string>* aUnmatched = nullptr);
+  /** Index of the current geometry (built if needed, on the thread of the geometry construction).
+   *  @returns shared index
+   */
+  static std::shared_ptr<const VolumeIndex> instance();
+  /** Find the logical volumes.
+   *  @param[in] aName name, prefix or regular expression
+   *  @param[in] aMatching matching of the name
+   *  @returns logical volumes matched (each once, in the order of their names)
+   */
+  std::vector<G4LogicalVolume*> find(const std::string& aName, Matching aMatching) const;
+  /// Number of names in the index
+  size_t size() const { return m_volumes.size(); }
+
+private:
+  /// Matching of the name of the job options, false if the name is not known
+  static bool matching(const std::string& aName, Matching& aMatching);
+  /// False if the name is not a valid regular expression (for the regex matching)
+  static bool valid(const std::string& aName, Matching aMatching);
+  /// Build the index from the volume stores
+  VolumeIndex();
+  /// Names of the physical and logical volumes with their logical volumes, sorted by name
+  std::vector<std::pair<std::string, G4LogicalVolume*>> m_volumes;
+  /// Names of the placements in the world with their logical volumes
+  std::vector<std::pair<std::string, G4LogicalVolume*>> m_worldDaughters;
+  /// Numbers of the physical and logical volumes in the stores when the index was built
+  size_t m_numPhysical = 0;
+  size_t m_numLogical = 0;
+};
+}
+
+#endif /* SIMG4COMMON_VOLUMEINDEX_H */
@@ -0,0 +1,100 @@
+#ifndef SIMG4COMMON_WORKERRUNMANAGER_H
+#define SIMG4COMMON_WORKERRUNMANAGER_H
+
+// FCCSW
+#include "SimG4Common/EventWatchdog.h"
+
+// Geant4
+#include "G4WorkerRunManager.hh"
+
+// Gaudi
+#include "GaudiKernel/IMessageSvc.h"
+#include "GaudiKernel/MsgStream.h"
+#include "GaudiKernel/ServiceHandle.h"
+
+/** @class WorkerRunManager SimG4Common/SimG4Common/WorkerRunManager.h WorkerRunManager.h
+ *
+ *  Run manager of a worker thread in the multi-threaded simulation in Geant4.
+ *  Equivalent of sim::RunManager for the worker threads: it allows GAUDI to control of the event flow.
+ *  Geometry and physics tables are shared with the master (sim::MTRunManager), while user actions and sensitive
+ *  detectors are created for each thread.
+ *  It must be created, used and deleted within the same thread.
+ */
+
+namespace sim {
+class WorkerRunManager : public G4WorkerRunManager {
+public:
+  /// Constructor.
+  WorkerRunManager();
+  /// Destructor.
+  ~WorkerRunManager();
+  /** Initialization.
+   *  It substitutes the G4WorkerRunManager::BeamOn() method (excluding the loop over the events).
+   *  @warning This method should be called \b after calling Initialize() on the worker.
+   *  @returns the status code
+   */
+  StatusCode start();
+  /** Processing of the event.
+   *  It substitutes the G4WorkerRunManager::ProcessOneEvent(int) method (excluding the generation part).
+   *  An event aborted by another component than the watchdog (e.g. a fast simulation model that failed) is
+   * incomplete: processEvent() then fails and gives the event back to the caller, with its hits (to be deleted by
+   * deleteThreadData() within this thread).
+   *  @warning Each successful call to processEvent() should be followed by a call to terminateEvent().
+   *  @param[in] aEvent a generated event to be processed in a simulation
+   *  @returns the status code
+   */
+  StatusCode processEvent(G4Event& aEvent);
+  /** Retrieves an event.
+   *  The lifetime of the pointer to G4Event ends when method terminateEvent() is called.
+   *  @param[out] aEvent a processed event
+   *  @returns the status code
+   */
+  StatusCode retrieveEvent(G4Event*& aEvent);
+  /** Termination of the event processing.
+   *  @returns the status code
+   */
+  StatusCode terminateEvent();
+  /** Termination of the event processing, without deletion of the event.
+   *  The ownership of the event (with its hits collections) is transferred to the caller, so that the worker may
+   * process the next event while the output of this one is saved.
+   *  @warning The event needs to be deleted within the thread of this worker (hits are created by thread-local
+   * allocators).
+   *  @param[out] aEvent a processed event
+   *  @returns the status code
+   */
+  StatusCode detachEvent(G4Event*& aEvent);
+  /** Take over an event that was not simulated by this worker (e.g. merged from sub-events), so that it may be
+   * retrieved and terminated as if it had been processed here.
+   *  @param[in] aEvent an event to be adopted, deleted at termination
+   *  @returns the status code
+   */
+  StatusCode adoptEvent(G4Event& aEvent);
+  /** Delete the parts of an event created by this thread with thread-local allocators: its hits and digits
+   * collections and its trajectories. The rest of the event (the event itself, its primary vertices and particles)
+   * may then be deleted by the thread that created it, so that the G4Allocator pools of that thread are reused
+   * instead of handing their objects to the pools of the worker with each event.
+   *  @param[in, out] aEvent event simulated (or adopted) by this worker, already detached
+   */
+  static void deleteThreadData(G4Event& aEvent);
+  /** Install the watchdog of the events (sim::EventWatchdog), wrapping the user stepping action.
+   *  Aborted events are reported by processEvent(), which still succeeds.
+   *  @warning This method should be called \b after the user actions are set, and only once.
+   *  @param[in] aBudget budgets of the event (nothing is installed if no budget is set)
+   */
+  void setWatchdog(const EventWatchdog::Budget& aBudget);
+  /// Finalization.
+  void finalize();
+
+private:
+  /// Flag indicating if the previous Event was terminated in Geant successfuly
+  bool m_prevEventTerminated;
+  /// Watchdog of the events (owned by the stepping manager, null if not installed)
+  EventWatchdog* m_watchdog = nullptr;
+  /// Message Service
+  ServiceHandle<IMessageSvc> m_msgSvc;
+  /// Message Stream
+  MsgStream m_log;
+};
+}
+
+#endif /* SIMG4COMMON_WORKERRUNMANAGER_H */
@@ -0,0 +1,101 @@
+#ifndef SIMG4COMMON_WORKERTHREAD_H
+#define SIMG4COMMON_WORKERTHREAD_H
+
+// Gaudi
+#include "GaudiKernel/StatusCode.h"
+
+// STL
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Geant
+class G4WorkerThread;
+
+/** @class WorkerThread SimG4Common/SimG4Common/WorkerThread.h WorkerThread.h
+ *
+ *  Thread owning a sim::WorkerRunManager in the multi-threaded simulation.
+ *  On start it sets up the Geant4 thread context (geometry and physics workspaces, random engine, user actions,
+ *  sensitive detectors) from the master run manager, once pinned to its cores if any are given (so that its
+ *  thread-local memory is allocated on their NUMA domain). Afterwards it executes the jobs (processing, termination
+ *  of an event) that are submitted from GAUDI, one by one, within the thread in which the run manager lives.
+ */
+
+namespace sim {
+class MTRunManager;
+class WorkerRunManager;
+class WorkerThread {
+public:
+  /// Job executed within the worker thread
+  typedef std::function<StatusCode(WorkerRunManager&)> Job;
+  /** Constructor. Starts the thread and waits until the worker run manager is initialized.
+   *  @param[in] aMaster master run manager, already initialized and started
+   *  @param[in] aId identifier of the thread
+   *  @param[in] aSeeds seeds for the random engine of the thread (zero-terminated)
+   *  @param[in] aInit additional initialization executed in the thread before the run starts (e.g. magnetic field)
+   *  @param[in] aCores cores to which the thread is pinned (not pinned if empty)
+   */
+  WorkerThread(MTRunManager& aMaster, int aId, const std::vector<long>& aSeeds, Job aInit,
+               const std::vector<int>& aCores = {});
+  /// Destructor. Terminates the run and joins the thread.
+  ~WorkerThread();
+  /** Execute a job within the worker thread. Blocks until the job is done.
+   *  @param[in] aJob job to be executed
+   *  @returns the status code returned by the job
+   */
+  StatusCode execute(Job aJob);
+  /** Submit a job to be executed within the worker thread, without waiting for it.
+   *  Jobs are executed in the order of submission, all the submitted jobs are executed before the thread stops.
+   *  @param[in] aJob job to be executed
+   *  @returns the future status code returned by the job
+   */
+  std::future<StatusCode> submit(Job aJob);
+  /// Status of the initialization of the worker
+  StatusCode initStatus() const { return m_initStatus; }
+  /// Identifier of the thread
+  int id() const { return m_id; }
+  /// Flag whether the thread is pinned to its cores
+  bool pinned() const { return m_pinned; }
+
+private:
+  /// Main loop of the thread: set up, process jobs, tear down
+  void run(Job aInit);
+  /// Set up of the Geant4 worker in the current thread
+  StatusCode setUp(Job& aInit);
+  /// Master run manager
+  MTRunManager& m_master;
+  /// Identifier of the thread
+  int m_id;
+  /// Seeds for the random engine of the thread
+  std::vector<long> m_seeds;
+  /// Cores to which the thread is pinned
+  std::vector<int> m_cores;
+  /// Flag whether the thread was pinned to its cores
+  bool m_pinned = false;
+  /// Geant4 context of the worker thread
+  std::unique_ptr<G4WorkerThread> m_context;
+  /// Run manager living in the thread
+  WorkerRunManager* m_runManager;
+  /// Status of the initialization
+  StatusCode m_initStatus;
+  /// Jobs waiting for execution
+  std::deque<std::packaged_task<StatusCode()>> m_jobs;
+  /// Flag to stop the thread
+  bool m_stop;
+  /// Mutex guarding the queue of jobs
+  std::mutex m_mutex;
+  /// Condition signalling new jobs
+  std::condition_variable m_cond;
+  /// Promise fulfilled once the worker is initialized
+  std::promise<void> m_ready;
+  /// The thread
+  std::thread m_thread;
+};
+}
+
+#endif /* SIMG4COMMON_WORKERTHREAD_H */
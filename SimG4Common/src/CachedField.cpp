@@ -0,0 +1,32 @@
+// local
+#include "SimG4Common/CachedField.h"
+
+// STL
+#include <algorithm>
+
+namespace sim {
+CachedField::CachedField(const G4MagneticField* aField, double aDistance, unsigned int aSize)
+    : m_field(aField), m_distance2(aDistance * aDistance), m_cells(std::max(aSize, 1u)) {}
+
+void CachedField::GetFieldValue(const G4double point[4], double* bField) const {
+  // the most recent cells first, the steps in a volume query neighbouring points
+  for (unsigned int iCell = 0; iCell < m_filled; ++iCell) {
+    const Cell& cell = m_cells[(m_next + m_cells.size() - 1 - iCell) % m_cells.size()];
+    const double dx = point[0] - cell.point[0];
+    const double dy = point[1] - cell.point[1];
+    const double dz = point[2] - cell.point[2];
+    if (dx * dx + dy * dy + dz * dz < m_distance2) {
+      std::copy(cell.value, cell.value + 3, bField);
+      ++m_hits;
+      return;
+    }
+  }
+  Cell& cell = m_cells[m_next];
+  m_field->GetFieldValue(point, cell.value);
+  std::copy(point, point + 3, cell.point);
+  std::copy(cell.value, cell.value + 3, bField);
+  m_next = (m_next + 1) % m_cells.size();
+  m_filled = std::min<unsigned int>(m_filled + 1, m_cells.size());
+  ++m_misses;
+}
+}
@@ -0,0 +1,48 @@
+#include "SimG4Common/CellSort.h"
+
+// STL
+#include <algorithm>
+#include <numeric>
+
+namespace {
+constexpr unsigned int digitBits = 16;
+constexpr uint64_t digitMask = (1ull << digitBits) - 1;
+}
+
+namespace sim {
+void CellSort::sort(const std::vector<uint64_t>& aGroups, const std::vector<uint64_t>& aCellIDs) {
+  m_order.resize(aCellIDs.size());
+  std::iota(m_order.begin(), m_order.end(), 0);
+  // least significant key first: the stable sort by group keeps the order of the cellIDs within a group
+  sortBy(aCellIDs);
+  sortBy(aGroups);
+}
+
+void CellSort::sortBy(const std::vector<uint64_t>& aKeys) {
+  if (m_order.size() < 2) return;
+  // bits that differ between the keys, only their digits need a pass
+  uint64_t differences = 0;
+  for (uint64_t key : aKeys) {
+    differences |= key ^ aKeys.front();
+  }
+  m_buffer.resize(m_order.size());
+  m_offsets.resize(digitMask + 1);
+  for (unsigned int shift = 0; shift < 64; shift += digitBits) {
+    if (((differences >> shift) & digitMask) == 0) continue;
+    std::fill(m_offsets.begin(), m_offsets.end(), 0);
+    for (uint32_t index : m_order) {
+      ++m_offsets[(aKeys[index] >> shift) & digitMask];
+    }
+    uint32_t offset = 0;
+    for (auto& count : m_offsets) {
+      const uint32_t digitCount = count;
+      count = offset;
+      offset += digitCount;
+    }
+    for (uint32_t index : m_order) {
+      m_buffer[m_offsets[(aKeys[index] >> shift) & digitMask]++] = index;
+    }
+    m_order.swap(m_buffer);
+  }
+}
+}
@@ -0,0 +1,71 @@
+#include "SimG4Common/CellSums.h"
+
+// STL
+#include <algorithm>
+
+namespace sim {
+CellSums::CellSums(size_t aNumCells) {
+  size_t tableSize = 16;
+  while (tableSize < 2 * aNumCells) {
+    tableSize *= 2;
+  }
+  m_table.assign(tableSize, -1);
+  m_mask = tableSize - 1;
+  m_cells.reserve(aNumCells);
+}
+
+void CellSums::add(uint64_t aCellID, double aEnergy, double aX, double aY, double aZ, double aTime, int aTrackId,
+                   int aPdg, double aWeight) {
+  size_t iSlot = slot(aCellID);
+  while (m_table[iSlot] >= 0) {
+    Cell& cell = m_cells[m_table[iSlot]];
+    if (cell.cellID == aCellID) {
+      cell.energy += aEnergy;
+      cell.x += aEnergy * aX;
+      cell.y += aEnergy * aY;
+      cell.z += aEnergy * aZ;
+      cell.weight += aEnergy * aWeight;
+      if (aTime < cell.time) {
+        cell.time = aTime;
+        cell.trackId = aTrackId;
+        cell.pdg = aPdg;
+      }
+      return;
+    }
+    iSlot = (iSlot + 1) & m_mask;
+  }
+  m_table[iSlot] = m_cells.size();
+  m_cells.push_back({aCellID, aEnergy, aEnergy * aX, aEnergy * aY, aEnergy * aZ, aTime, aTrackId, aPdg,
+                     aEnergy * aWeight});
+  if (2 * m_cells.size() > m_table.size()) {
+    grow();
+  }
+}
+
+void CellSums::normalise() {
+  for (auto& cell : m_cells) {
+    const double norm = cell.energy > 0 ? 1. / cell.energy : 0;
+    cell.x *= norm;
+    cell.y *= norm;
+    cell.z *= norm;
+    cell.weight = cell.energy > 0 ? cell.weight * norm : 1;
+  }
+}
+
+void CellSums::clear() {
+  std::fill(m_table.begin(), m_table.end(), -1);
+  m_cells.clear();
+}
+
+void CellSums::grow() {
+  m_table.assign(2 * m_table.size(), -1);
+  m_mask = m_table.size() - 1;
+  for (size_t iCell = 0; iCell < m_cells.size(); ++iCell) {
+    size_t iSlot = slot(m_cells[iCell].cellID);
+    while (m_table[iSlot] >= 0) {
+      iSlot = (iSlot + 1) & m_mask;
+    }
+    m_table[iSlot] = iCell;
+  }
+}
+}
@@ -2,52 +2,172 @@
 
 #include "G4Track.hh"
 
+#include <algorithm>
+
 #include "SimG4Common/Units.h"
 
 #include "edm4hep/MCParticleCollection.h"
 
 namespace sim {
-EventInformation::EventInformation() { 
-  m_mcParticles = new edm4hep::MCParticleCollection();
-}
-
-void EventInformation::setCollections(edm4hep::MCParticleCollection*& aMCParticleCollection) {
-  // ownership is transferred here - to SaveTool which is supposed to put it in the event store
-  aMCParticleCollection = m_mcParticles;
-}
-
-void EventInformation::addParticle(const G4Track* aSecondary) {
-  auto edmParticle = m_mcParticles->create();
-  auto g4mom = aSecondary->GetMomentum();
-  auto g4energy = aSecondary->GetTotalEnergy();
-  float mass = g4energy * g4energy - g4mom.mag2();
-  mass = sqrt(fabs(mass));
-  size_t g4ID = aSecondary->GetTrackID();
-
-  edmParticle.setMomentum({
-         (float) g4mom.x() * (float) sim::g42edm::energy,
-         (float) g4mom.y() * (float) sim::g42edm::energy,
-         (float) g4mom.z() * (float) sim::g42edm::energy, });
-  edmParticle.setMass(mass * sim::g42edm::energy);
-  edmParticle.setSimulatorStatus(g4ID);
-  edmParticle.setPDG(aSecondary->GetDynamicParticle()->GetDefinition()->GetPDGEncoding());
-
-  auto g4EndPos = aSecondary->GetPosition();
-  edmParticle.setEndpoint({
-    g4EndPos.x() * sim::g42edm::length,
-    g4EndPos.y() * sim::g42edm::length,
-    g4EndPos.z() * sim::g42edm::length,
-    });
-  edmParticle.setTime(aSecondary->GetGlobalTime() * sim::g42edm::length);
-
-  size_t motherID = aSecondary->GetParentID();
-  auto g4StartPos = aSecondary->GetVertexPosition();
-  edmParticle.setVertex({
-    g4StartPos.x() * sim::g42edm::length,
-    g4StartPos.y() * sim::g42edm::length,
-    g4StartPos.z() * sim::g42edm::length,
-    });
-  // todo: no time at endpoint
+EventInformation::EventInformation(size_t aExpectedParticles) {
+  m_trackIdToIndex.reserve(aExpectedParticles);
+  m_records.reserve(aExpectedParticles);
+}
+
+EventInformation::~EventInformation() = default;
+
+std::unique_ptr<edm4hep::MCParticleCollection> EventInformation::releaseParticles() {
+  std::call_once(m_converted, &EventInformation::convertParticles, this);
+  return std::move(m_mcParticles);
+}
+
+const edm4hep::MCParticleCollection* EventInformation::particles() {
+  std::call_once(m_converted, &EventInformation::convertParticles, this);
+  return m_savedParticles;
+}
+
+void EventInformation::convertParticles() {
+  m_mcParticles = std::make_unique<edm4hep::MCParticleCollection>();
+  // pointer is kept unchanged once the ownership is transferred, so the particles can be read from several threads
+  m_savedParticles = m_mcParticles.get();
+  for (const auto& record : m_records) {
+    auto edmParticle = m_mcParticles->create();
+    float mass = record.energy * record.energy - record.px * record.px - record.py * record.py - record.pz * record.pz;
+    mass = sqrt(fabs(mass));
+    edmParticle.setMomentum({
+           (float) (record.px * sim::g42edm::energy),
+           (float) (record.py * sim::g42edm::energy),
+           (float) (record.pz * sim::g42edm::energy), });
+    edmParticle.setMass(mass * sim::g42edm::energy);
+    edmParticle.setSimulatorStatus(record.trackId);
+    edmParticle.setPDG(record.pdg);
+    edmParticle.setVertex({
+      record.vx * sim::g42edm::length,
+      record.vy * sim::g42edm::length,
+      record.vz * sim::g42edm::length,
+      });
+    // the particles are recorded before their tracking, so the endpoint is not known yet
+    edmParticle.setEndpoint({
+      record.vx * sim::g42edm::length,
+      record.vy * sim::g42edm::length,
+      record.vz * sim::g42edm::length,
+      });
+    edmParticle.setTime(record.time);
+  }
+  // link the particles to their parents, if these were saved too (the collection is not modified afterwards)
+  for (size_t iParticle = 0; iParticle < m_records.size(); ++iParticle) {
+    const int parentIndex = particleIndex(m_records[iParticle].parentId);
+    if (parentIndex < 0) continue;
+    auto particle = (*m_mcParticles)[iParticle];
+    auto parent = (*m_mcParticles)[parentIndex];
+    particle.addToParents(parent);
+    parent.addToDaughters(particle);
+  }
+}
+
+void EventInformation::addParticles(const EventInformation& aOther, int aTrackIdOffset) {
+  m_trackIdToIndex.reserve(m_trackIdToIndex.size() + aOther.m_records.size());
+  m_records.reserve(m_records.size() + aOther.m_records.size());
+  for (auto record : aOther.m_records) {
+    record.trackId += aTrackIdOffset;
+    if (record.parentId > 0) record.parentId += aTrackIdOffset;
+    addRecord(record);
+  }
+  m_numTracks += aOther.m_numTracks;
+  m_numSteps += aOther.m_numSteps;
+  for (auto staged : aOther.m_stagedTracks) {
+    staged.trackId += aTrackIdOffset;
+    m_stagedTracks.push_back(staged);
+  }
+  for (auto smeared : aOther.m_smearedParticles) {
+    smeared.trackId += aTrackIdOffset;
+    addSmearedParticle(smeared);
+  }
+}
+
+void EventInformation::addSmearedParticle(const SmearedParticle& aParticle) {
+  auto index = m_smearedIndex.emplace(aParticle.trackId, m_smearedParticles.size());
+  if (index.second) {
+    m_smearedParticles.push_back(aParticle);
+  } else {
+    m_smearedParticles[index.first->second] = aParticle;
+  }
+}
+
+namespace {
+ParticleRecord makeRecord(const G4Track& aTrack) {
+  const G4ThreeVector& momentum = aTrack.GetMomentum();
+  const G4ThreeVector& vertex = aTrack.GetVertexPosition();
+  return {aTrack.GetTrackID(), aTrack.GetParentID(), aTrack.GetParticleDefinition()->GetPDGEncoding(),
+          momentum.x(), momentum.y(), momentum.z(), aTrack.GetTotalEnergy(),
+          vertex.x(), vertex.y(), vertex.z(), aTrack.GetGlobalTime()};
+}
+}
+
+void EventInformation::addRecord(const ParticleRecord& aRecord) {
+  m_trackIdToIndex.emplace(aRecord.trackId, m_records.size());
+  m_records.push_back(aRecord);
+  m_maxTrackId = std::max(m_maxTrackId, aRecord.trackId);
+}
+
+void EventInformation::addParticle(const G4Track* aSecondary, bool aWithAncestors) {
+  addRecord(makeRecord(*aSecondary));
+  if (!aWithAncestors) {
+    return;
+  }
+  // ancestors are tracked before their descendants, walk up until reaching an already saved particle
+  int parentId = aSecondary->GetParentID();
+  while (parentId > 0 && m_trackIdToIndex.find(parentId) == m_trackIdToIndex.end()) {
+    auto candidate = m_candidates.find(parentId);
+    if (candidate == m_candidates.end()) {
+      break;
+    }
+    parentId = candidate->second.record.parentId;
+    addRecord(candidate->second.record);
+    m_candidates.erase(candidate);
+  }
+}
+
+void EventInformation::addCandidate(const G4Track* aTrack) {
+  // a suspended track tracked again keeps its record and the count of its daughters
+  m_candidates.emplace(aTrack->GetTrackID(), Candidate{makeRecord(*aTrack)});
+}
+
+void EventInformation::endTrack(const G4Track* aTrack, size_t aNumSecondaries, bool aEnded) {
+  auto candidate = m_candidates.find(aTrack->GetTrackID());
+  if (candidate == m_candidates.end()) {
+    return;
+  }
+  candidate->second.numDaughters += aNumSecondaries;
+  candidate->second.ended = aEnded;
+  if (aEnded && candidate->second.numDaughters == 0) {
+    const int parentId = candidate->second.record.parentId;
+    m_candidates.erase(candidate);
+    releaseDaughter(parentId);
+  }
+}
+
+void EventInformation::discardTrack(const G4Track* aTrack) {
+  if (m_candidates.count(aTrack->GetTrackID()) > 0) {
+    // suspended track, stacked again
+    endTrack(aTrack, 0, true);
+    return;
+  }
+  releaseDaughter(aTrack->GetParentID());
+}
+
+void EventInformation::releaseDaughter(int aParentId) {
+  // candidates moved to the history (with a saved descendant) are no longer found
+  auto candidate = m_candidates.find(aParentId);
+  while (candidate != m_candidates.end()) {
+    if (candidate->second.numDaughters > 0) --candidate->second.numDaughters;
+    if (!candidate->second.ended || candidate->second.numDaughters > 0) {
+      return;
+    }
+    const int parentId = candidate->second.record.parentId;
+    m_candidates.erase(candidate);
+    candidate = m_candidates.find(parentId);
+  }
 }
 
 } //namespace sim
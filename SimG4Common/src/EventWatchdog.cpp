@@ -0,0 +1,98 @@
+#include "SimG4Common/EventWatchdog.h"
+
+// Gaudi
+#include "GaudiKernel/MsgStream.h"
+
+// Geant
+#include "G4Event.hh"
+#include "G4EventManager.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "Randomize.hh"
+
+// STL
+#include <time.h>
+
+namespace sim {
+std::atomic<unsigned long> EventWatchdog::s_totalKilledTracks{0};
+std::atomic<unsigned long> EventWatchdog::s_totalAbortedEvents{0};
+
+EventWatchdog::EventWatchdog(const Budget& aBudget, G4UserSteppingAction* aAction)
+    : m_budget(aBudget), m_action(aAction) {
+  if (m_budget.checkInterval == 0) m_budget.checkInterval = 1;
+}
+
+EventWatchdog::~EventWatchdog() {}
+
+double EventWatchdog::threadCpuTime() {
+  struct timespec time;
+  if (::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) return 0;
+  return time.tv_sec + 1e-9 * time.tv_nsec;
+}
+
+void EventWatchdog::beginEvent() {
+  m_steps = 0;
+  m_killedTracks = 0;
+  m_killedEnergy = 0;
+  m_abort = Abort::kNone;
+  m_cpuTime = 0;
+  m_startCpuTime = threadCpuTime();
+  m_seeds[0] = G4Random::getTheSeeds()[0];
+  m_seeds[1] = G4Random::getTheSeeds()[1];
+}
+
+void EventWatchdog::SetSteppingManagerPointer(G4SteppingManager* aManager) {
+  G4UserSteppingAction::SetSteppingManagerPointer(aManager);
+  if (m_action) m_action->SetSteppingManagerPointer(aManager);
+}
+
+void EventWatchdog::UserSteppingAction(const G4Step* aStep) {
+  if (m_action) m_action->UserSteppingAction(aStep);
+  if (m_abort != Abort::kNone) return;
+  ++m_steps;
+  G4Track* track = aStep->GetTrack();
+  const unsigned long trackSteps = track->GetCurrentStepNumber();
+  if (m_budget.maxTrackSteps > 0 && trackSteps > m_budget.maxTrackSteps && track->GetTrackStatus() != fStopAndKill) {
+    track->SetTrackStatus(fStopAndKill);
+    ++m_killedTracks;
+    m_killedEnergy += track->GetKineticEnergy();
+  }
+  if (m_budget.maxSteps > 0 && m_steps > m_budget.maxSteps) {
+    abort(Abort::kSteps);
+  } else if (m_budget.maxCpuTime > 0 && m_steps % m_budget.checkInterval == 0 &&
+             threadCpuTime() - m_startCpuTime > m_budget.maxCpuTime) {
+    abort(Abort::kCpuTime);
+  }
+}
+
+void EventWatchdog::abort(Abort aReason) {
+  m_abort = aReason;
+  m_cpuTime = threadCpuTime() - m_startCpuTime;
+  // the current track and all the tracks waiting in the stacks are killed
+  G4EventManager::GetEventManager()->AbortCurrentEvent();
+}
+
+void EventWatchdog::endEvent(const G4Event& aEvent, MsgStream& aLog) const {
+  s_totalKilledTracks += m_killedTracks;
+  if (m_killedTracks > 0) {
+    aLog << MSG::INFO << "Event " << aEvent.GetEventID() << ": " << m_killedTracks << " tracks killed after "
+         << m_budget.maxTrackSteps << " steps, with kinetic energy " << m_killedEnergy / GeV << " GeV" << endmsg;
+  }
+  if (m_abort == Abort::kNone) return;
+  ++s_totalAbortedEvents;
+  aLog << MSG::WARNING << "Event " << aEvent.GetEventID() << " aborted after " << m_steps << " steps and "
+       << m_cpuTime << " s of CPU time (budget of " << (m_abort == Abort::kSteps ? "steps" : "CPU time")
+       << " exceeded), seeds at the beginning of the event: " << m_seeds[0] << "\t" << m_seeds[1] << endmsg;
+  for (int iVertex = 0; iVertex < aEvent.GetNumberOfPrimaryVertex(); ++iVertex) {
+    const G4PrimaryVertex* vertex = aEvent.GetPrimaryVertex(iVertex);
+    for (auto particle = vertex->GetPrimary(); particle != nullptr; particle = particle->GetNext()) {
+      aLog << MSG::WARNING << "  primary " << particle->GetPDGcode() << " p = (" << particle->GetPx() / GeV << ", "
+           << particle->GetPy() / GeV << ", " << particle->GetPz() / GeV << ") GeV at (" << vertex->GetX0() / mm
+           << ", " << vertex->GetY0() / mm << ", " << vertex->GetZ0() / mm << ") mm" << endmsg;
+    }
+  }
+}
+}
@@ -0,0 +1,46 @@
+// local
+#include "SimG4Common/FieldCounters.h"
+
+// STL
+#include <algorithm>
+
+namespace sim {
+FieldCounters& FieldCounters::operator+=(const FieldCounters& aOther) {
+  fieldCalls += aOther.fieldCalls;
+  integratorSteps += aOther.integratorSteps;
+  chordTrials += aOther.chordTrials;
+  rejectedSteps += aOther.rejectedSteps;
+  return *this;
+}
+
+FieldCounters FieldCounters::operator-(const FieldCounters& aOther) const {
+  FieldCounters difference;
+  difference.fieldCalls = fieldCalls - aOther.fieldCalls;
+  difference.integratorSteps = integratorSteps - aOther.integratorSteps;
+  difference.chordTrials = chordTrials - aOther.chordTrials;
+  difference.rejectedSteps = rejectedSteps - aOther.rejectedSteps;
+  return difference;
+}
+
+CountingStepper::CountingStepper(G4MagIntegratorStepper* aStepper, const CountingField& aField)
+    : G4MagIntegratorStepper(aStepper->GetEquationOfMotion(), aStepper->GetNumberOfVariables()),
+      m_stepper(aStepper),
+      m_counters(aField.counters()) {}
+
+void CountingStepper::Stepper(const G4double y[], const G4double dydx[], G4double h, G4double yout[],
+                              G4double yerr[]) {
+  ++m_counters.integratorSteps;
+  if (!m_chordEvaluated && std::equal(y, y + 6, m_lastStart)) {
+    ++m_counters.rejectedSteps;
+  }
+  std::copy(y, y + 6, m_lastStart);
+  m_chordEvaluated = false;
+  m_stepper->Stepper(y, dydx, h, yout, yerr);
+}
+
+G4double CountingStepper::DistChord() const {
+  ++m_counters.chordTrials;
+  m_chordEvaluated = true;
+  return m_stepper->DistChord();
+}
+}
@@ -0,0 +1,144 @@
+// local
+#include "SimG4Common/FieldMap.h"
+// Geant 4
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace sim {
+static_assert(sizeof(FieldMap::Header) == 72, "Header of the field map is written without padding");
+
+FieldMap::FieldMap(const std::string& aFileName, double aScale) : m_scale(aScale * tesla) {
+  std::memset(&m_header, 0, sizeof(m_header));
+  m_file = MappedFile(aFileName, sizeof(Header), "a field map");
+  if (!m_file.isMapped()) {
+    m_error = m_file.error();
+    return;
+  }
+  std::memcpy(&m_header, m_file.data(), sizeof(Header));
+  const size_t numPoints = size_t(m_header.n[0]) * m_header.n[1] * m_header.n[2];
+  if (std::strncmp(m_header.magic, kMagic, sizeof(m_header.magic)) != 0) {
+    m_error = aFileName + " is not a field map (wrong magic string)";
+  } else if (m_header.coordinates != kCartesian && m_header.coordinates != kCylindrical) {
+    m_error = aFileName + " has unknown coordinates " + std::to_string(m_header.coordinates);
+  } else if (numPoints == 0 || m_file.size() < sizeof(Header) + 3 * numPoints * sizeof(float)) {
+    m_error = aFileName + " is too short for its grid";
+  }
+  m_periodicPhi = m_header.coordinates == kCylindrical && m_header.n[1] > 1;
+  for (int iCoord = 0; iCoord < 3 && m_error.empty(); ++iCoord) {
+    if (m_header.n[iCoord] == 1) continue;
+    if (iCoord == 1 && m_periodicPhi) {
+      m_invSpacing[iCoord] = m_header.n[iCoord] / CLHEP::twopi;
+    } else if (m_header.max[iCoord] > m_header.min[iCoord]) {
+      m_invSpacing[iCoord] = (m_header.n[iCoord] - 1) / (m_header.max[iCoord] - m_header.min[iCoord]);
+    } else {
+      m_error = aFileName + " has an empty range in coordinate " + std::to_string(iCoord);
+    }
+  }
+  if (!m_error.empty()) {
+    m_file.reset();
+    return;
+  }
+  m_stride[2] = 3;
+  m_stride[1] = 3 * size_t(m_header.n[2]);
+  m_stride[0] = m_stride[1] * m_header.n[1];
+  m_values = m_file.at<float>(sizeof(Header));
+  // the pages of the file are collapsed into huge pages only if the kernel supports them for read-only files
+  m_file.adviseHugePages();
+}
+
+FieldMap::~FieldMap() {}
+
+std::unique_ptr<FieldMap> FieldMap::replicate() const {
+  std::unique_ptr<FieldMap> replica(new FieldMap(m_scale));
+  replica->m_header = m_header;
+  replica->m_error = m_error;
+  if (!m_file.isMapped()) return replica;
+  replica->m_file = m_file.replicate();
+  if (!replica->m_file.isMapped()) {
+    replica->m_error = replica->m_file.error();
+    return replica;
+  }
+  replica->m_values = replica->m_file.at<float>(sizeof(Header));
+  std::copy(m_invSpacing, m_invSpacing + 3, replica->m_invSpacing);
+  std::copy(m_stride, m_stride + 3, replica->m_stride);
+  replica->m_periodicPhi = m_periodicPhi;
+  return replica;
+}
+
+bool FieldMap::interpolate(const double aCoordinates[3], double aField[3]) const {
+  // offsets of the two neighbouring points and their weights in each coordinate
+  size_t offset[3][2];
+  double weight[3][2];
+  for (int iCoord = 0; iCoord < 3; ++iCoord) {
+    const uint32_t n = m_header.n[iCoord];
+    if (n == 1) {
+      offset[iCoord][0] = offset[iCoord][1] = 0;
+      weight[iCoord][0] = 1;
+      weight[iCoord][1] = 0;
+      continue;
+    }
+    double u = (aCoordinates[iCoord] - m_header.min[iCoord]) * m_invSpacing[iCoord];
+    size_t lower, upper;
+    if (iCoord == 1 && m_periodicPhi) {
+      u -= n * std::floor(u / n);
+      lower = std::min<size_t>(static_cast<size_t>(u), n - 1);
+      upper = lower + 1 == n ? 0 : lower + 1;
+    } else {
+      if (u < 0 || u > n - 1) return false;
+      lower = std::min<size_t>(static_cast<size_t>(u), n - 2);
+      upper = lower + 1;
+    }
+    offset[iCoord][0] = lower * m_stride[iCoord];
+    offset[iCoord][1] = upper * m_stride[iCoord];
+    weight[iCoord][1] = u - lower;
+    weight[iCoord][0] = 1 - weight[iCoord][1];
+  }
+  aField[0] = aField[1] = aField[2] = 0;
+  for (int i0 = 0; i0 < 2; ++i0) {
+    if (weight[0][i0] == 0) continue;
+    for (int i1 = 0; i1 < 2; ++i1) {
+      if (weight[1][i1] == 0) continue;
+      const double weight01 = weight[0][i0] * weight[1][i1];
+      // the two points along the last coordinate are contiguous in memory
+      const float* values = m_values + offset[0][i0] + offset[1][i1];
+      for (int i2 = 0; i2 < 2; ++i2) {
+        if (weight[2][i2] == 0) continue;
+        const double w = weight01 * weight[2][i2];
+        const float* point = values + offset[2][i2];
+        aField[0] += w * point[0];
+        aField[1] += w * point[1];
+        aField[2] += w * point[2];
+      }
+    }
+  }
+  return true;
+}
+
+void FieldMap::GetFieldValue(const G4double point[4], double* bField) const {
+  bField[0] = bField[1] = bField[2] = 0;
+  if (m_values == nullptr) return;
+  if (m_header.coordinates == kCartesian) {
+    double field[3];
+    if (!interpolate(point, field)) return;
+    bField[0] = m_scale * field[0];
+    bField[1] = m_scale * field[1];
+    bField[2] = m_scale * field[2];
+    return;
+  }
+  const double r = std::sqrt(point[0] * point[0] + point[1] * point[1]);
+  // azimuthal angle only needed if the field is not axially symmetric
+  const double coordinates[3] = {r, m_periodicPhi ? std::atan2(point[1], point[0]) : 0., point[2]};
+  double field[3];
+  if (!interpolate(coordinates, field)) return;
+  const double cosPhi = r > 0 ? point[0] / r : 1;
+  const double sinPhi = r > 0 ? point[1] / r : 0;
+  bField[0] = m_scale * (field[0] * cosPhi - field[1] * sinPhi);
+  bField[1] = m_scale * (field[0] * sinPhi + field[1] * cosPhi);
+  bField[2] = m_scale * field[2];
+}
+}
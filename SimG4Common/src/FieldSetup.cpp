@@ -0,0 +1,335 @@
+// local
+#include "SimG4Common/FieldSetup.h"
+
+// Geant 4
+#include "G4ChordFinder.hh"
+#include "G4FieldManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4MagneticField.hh"
+#include "G4CoupledTransportation.hh"
+#include "G4Navigator.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ParticleTable.hh"
+#include "G4ProcessManager.hh"
+#include "G4ProcessVector.hh"
+#include "G4PropagatorInField.hh"
+#include "G4Transportation.hh"
+#include "G4TransportationManager.hh"
+#include "G4VPhysicalVolume.hh"
+
+#include "G4ClassicalRK4.hh"
+#include "G4ExactHelixStepper.hh"
+#include "G4HelixExplicitEuler.hh"
+#include "G4HelixImplicitEuler.hh"
+#include "G4HelixSimpleRunge.hh"
+#include "G4MagIntegratorStepper.hh"
+#include "G4Mag_UsualEqRhs.hh"
+#include "G4NystromRK4.hh"
+
+namespace sim {
+namespace {
+/// Cached and counting fields of the thread
+thread_local CachedField* t_cachedField = nullptr;
+thread_local CountingField* t_countingField = nullptr;
+
+/// Set the thresholds to the transportation of type T, returns false if it is of another type
+template <class T>
+bool setThresholds(G4VProcess& aProcess, const LooperThresholds& aThresholds) {
+  auto transportation = dynamic_cast<T*>(&aProcess);
+  if (transportation == nullptr) return false;
+  transportation->SetThresholdWarningEnergy(aThresholds.warningEnergy);
+  transportation->SetThresholdImportantEnergy(aThresholds.importantEnergy);
+  transportation->SetThresholdTrials(aThresholds.numberOfTrials);
+  return true;
+}
+
+/// Get the thresholds of the transportation of type T, returns false if it is of another type
+template <class T>
+bool getThresholds(const G4VProcess& aProcess, LooperThresholds& aThresholds) {
+  auto transportation = dynamic_cast<const T*>(&aProcess);
+  if (transportation == nullptr) return false;
+  aThresholds.warningEnergy = transportation->GetThresholdWarningEnergy();
+  aThresholds.importantEnergy = transportation->GetThresholdImportantEnergy();
+  aThresholds.numberOfTrials = transportation->GetThresholdTrials();
+  return true;
+}
+}
+
+thread_local FieldSetup::ThreadLoopers* FieldSetup::t_threadLoopers = nullptr;
+
+FieldSetup::FieldSetup(const std::string& aStepper, double aMinStep, double aMaxStep, const FieldAccuracy& aAccuracy)
+    : m_msgSvc("MessageSvc", "FieldSetup"),
+      m_log(&(*m_msgSvc), "FieldSetup"),
+      m_stepper(aStepper),
+      m_minStep(aMinStep),
+      m_maxStep(aMaxStep),
+      m_accuracy(aAccuracy) {}
+
+FieldSetup::~FieldSetup() {}
+
+void FieldSetup::addVolumes(const std::vector<std::string>& aNames, const FieldAccuracy& aAccuracy) {
+  if (!aNames.empty()) m_volumeAccuracies.emplace_back(aNames, aAccuracy);
+}
+
+void FieldSetup::setUniformField(double aRMax, double aZMax) {
+  m_uniformRMax = aRMax;
+  m_uniformZMax = aZMax;
+}
+
+UniformFieldStepper::Counters FieldSetup::uniformFieldCounters() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  UniformFieldStepper::Counters counters;
+  for (const auto uniformStepper : m_uniformSteppers) {
+    counters += uniformStepper->counters();
+  }
+  return counters;
+}
+
+bool FieldSetup::isKnownStepper(const std::string& aName) {
+  return aName == "HelixImplicitEuler" || aName == "HelixSimpleRunge" || aName == "HelixExplicitEuler" ||
+         aName == "NystromRK4" || aName == "ClassicalRK4" || aName == "ExactHelix";
+}
+
+G4MagIntegratorStepper* FieldSetup::stepper(const std::string& aName, G4Mag_EqRhs* fEquation) {
+  if (!isKnownStepper(aName)) return nullptr;
+  if (aName == "HelixImplicitEuler")
+    return new G4HelixImplicitEuler(fEquation);
+  else if (aName == "HelixSimpleRunge")
+    return new G4HelixSimpleRunge(fEquation);
+  else if (aName == "HelixExplicitEuler")
+    return new G4HelixExplicitEuler(fEquation);
+  else if (aName == "ClassicalRK4")
+    return new G4ClassicalRK4(fEquation);
+  else if (aName == "ExactHelix")
+    return new G4ExactHelixStepper(fEquation);
+  return new G4NystromRK4(fEquation);
+}
+
+void FieldSetup::setAccuracy(G4FieldManager& aFieldManager, const FieldAccuracy& aAccuracy) {
+  if (aAccuracy.deltaChord > 0) aFieldManager.GetChordFinder()->SetDeltaChord(aAccuracy.deltaChord);
+  if (aAccuracy.deltaOneStep > 0) aFieldManager.SetDeltaOneStep(aAccuracy.deltaOneStep);
+  if (aAccuracy.minEpsilon > 0) aFieldManager.SetMinimumEpsilonStep(aAccuracy.minEpsilon);
+  if (aAccuracy.maxEpsilon > 0) aFieldManager.SetMaximumEpsilonStep(aAccuracy.maxEpsilon);
+}
+
+void FieldSetup::setCache(double aDistance, unsigned int aSize) {
+  m_cacheDistance = aDistance;
+  m_cacheSize = aSize;
+}
+
+std::pair<unsigned long, unsigned long> FieldSetup::cacheCounters() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::pair<unsigned long, unsigned long> counters(0, 0);
+  for (const auto& cache : m_cachedFields) {
+    counters.first += cache->hits();
+    counters.second += cache->misses();
+  }
+  return counters;
+}
+
+CachedField* FieldSetup::cachedField(G4MagneticField* aField) {
+  // one cache per thread, shared by the chord finders of the thread
+  if (t_cachedField == nullptr || t_cachedField->field() != aField) {
+    m_cachedFields.emplace_back(new CachedField(aField, m_cacheDistance, m_cacheSize));
+    t_cachedField = m_cachedFields.back().get();
+  }
+  return t_cachedField;
+}
+
+CountingField* FieldSetup::countingField(G4MagneticField* aField) {
+  // one counting field per thread, shared by the chord finders of the thread
+  if (t_countingField == nullptr || t_countingField->field() != aField) {
+    m_countingFields.emplace_back(new CountingField(aField));
+    t_countingField = m_countingFields.back().get();
+  }
+  return t_countingField;
+}
+
+const FieldCounters* FieldSetup::threadCounters() {
+  return t_countingField != nullptr ? &t_countingField->counters() : nullptr;
+}
+
+void FieldSetup::setLooperThresholds(const std::map<std::string, double>& aWarningEnergies,
+                                     const std::map<std::string, double>& aImportantEnergies,
+                                     const std::map<std::string, int>& aNumberOfTrials) {
+  m_looperThresholds.clear();
+  for (const auto& entry : aWarningEnergies) m_looperThresholds[entry.first].warningEnergy = entry.second;
+  for (const auto& entry : aImportantEnergies) m_looperThresholds[entry.first].importantEnergy = entry.second;
+  for (const auto& entry : aNumberOfTrials) m_looperThresholds[entry.first].numberOfTrials = entry.second;
+}
+
+bool FieldSetup::setLooperThresholds(G4VProcess& aTransportation, const LooperThresholds& aThresholds) {
+  return setThresholds<G4CoupledTransportation>(aTransportation, aThresholds) ||
+         setThresholds<G4Transportation>(aTransportation, aThresholds);
+}
+
+LooperThresholds FieldSetup::looperThresholds(const G4VProcess& aTransportation) {
+  LooperThresholds thresholds;
+  if (!getThresholds<G4CoupledTransportation>(aTransportation, thresholds)) {
+    getThresholds<G4Transportation>(aTransportation, thresholds);
+  }
+  return thresholds;
+}
+
+StatusCode FieldSetup::applyLooperThresholds() {
+  G4ParticleTable* particleTable = G4ParticleTable::GetParticleTable();
+  for (const auto& entry : m_looperThresholds) {
+    if (entry.first != "default" && particleTable->FindParticle(entry.first) == nullptr) {
+      m_log << MSG::ERROR << "Particle " << entry.first << " of the looper thresholds not found" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  const auto defaultEntry = m_looperThresholds.find("default");
+  // the thresholds of the particles, by transportation process, taking the defaults of Geant4 for the unset ones
+  std::unordered_map<G4VProcess*, std::vector<std::pair<const G4ParticleDefinition*, LooperThresholds>>> processes;
+  std::unordered_map<G4VProcess*, LooperThresholds> defaults;
+  auto particles = particleTable->GetIterator();
+  particles->reset();
+  while ((*particles)()) {
+    const G4ParticleDefinition* particle = particles->value();
+    G4ProcessManager* processManager = particle->GetProcessManager();
+    if (processManager == nullptr) continue;
+    G4ProcessVector* particleProcesses = processManager->GetProcessList();
+    for (size_t iProcess = 0; iProcess < particleProcesses->size(); ++iProcess) {
+      G4VProcess* process = (*particleProcesses)[iProcess];
+      if (process->GetProcessType() != fTransportation ||
+          (dynamic_cast<G4Transportation*>(process) == nullptr &&
+           dynamic_cast<G4CoupledTransportation*>(process) == nullptr)) {
+        continue;
+      }
+      auto entry = m_looperThresholds.find(particle->GetParticleName());
+      if (entry == m_looperThresholds.end()) entry = defaultEntry;
+      if (defaults.count(process) == 0) defaults[process] = looperThresholds(*process);
+      LooperThresholds thresholds = defaults[process];
+      if (entry != m_looperThresholds.end()) {
+        if (entry->second.warningEnergy >= 0) thresholds.warningEnergy = entry->second.warningEnergy;
+        if (entry->second.importantEnergy >= 0) thresholds.importantEnergy = entry->second.importantEnergy;
+        if (entry->second.numberOfTrials >= 0) thresholds.numberOfTrials = entry->second.numberOfTrials;
+      }
+      processes[process].emplace_back(particle, thresholds);
+    }
+  }
+  std::unique_ptr<ThreadLoopers> threadLoopers(new ThreadLoopers());
+  for (const auto& process : processes) {
+    const auto& first = process.second.front();
+    bool shared = false;
+    for (const auto& particle : process.second) {
+      if (!(particle.second == first.second)) shared = true;
+    }
+    setLooperThresholds(*process.first, first.second);
+    if (shared) {
+      // the thresholds are switched to those of the particle of each track
+      for (const auto& particle : process.second) {
+        threadLoopers->particles[particle.first] = std::make_pair(process.first, particle.second);
+      }
+      threadLoopers->applied[process.first] = first.second;
+      m_log << MSG::DEBUG << "Transportation " << process.first->GetProcessName() << " shared by "
+            << process.second.size() << " particles, looper thresholds switched per track" << endmsg;
+    }
+  }
+  if (threadLoopers->particles.empty()) {
+    t_threadLoopers = nullptr;
+  } else {
+    t_threadLoopers = threadLoopers.get();
+    m_threadLoopers.push_back(std::move(threadLoopers));
+  }
+  return StatusCode::SUCCESS;
+}
+
+void FieldSetup::startTrack(const G4ParticleDefinition& aParticle) {
+  if (t_threadLoopers == nullptr) return;
+  auto particle = t_threadLoopers->particles.find(&aParticle);
+  if (particle == t_threadLoopers->particles.end()) return;
+  LooperThresholds& applied = t_threadLoopers->applied[particle->second.first];
+  if (!(applied == particle->second.second)) {
+    setLooperThresholds(*particle->second.first, particle->second.second);
+    applied = particle->second.second;
+  }
+}
+
+G4ChordFinder* FieldSetup::chordFinder(G4MagneticField* aField) {
+  const bool uniform = m_stepper == "auto" && m_uniformRMax > 0 && m_uniformZMax > 0;
+  // the stepper queries the cache of the thread, if any, through the counting field
+  G4MagneticField* field = m_cacheDistance > 0 ? cachedField(aField) : aField;
+  CountingField* counting = (uniform || m_counting) ? countingField(field) : nullptr;
+  // the steppers of the chord finder share the equation, in which Geant4 sets the charge of the track
+  m_equations.emplace_back(new G4Mag_UsualEqRhs(counting != nullptr ? counting : field));
+  G4Mag_EqRhs* equation = m_equations.back().get();
+  G4MagIntegratorStepper* integrator = nullptr;
+  if (uniform) {
+    UniformFieldStepper* uniformStepper =
+        new UniformFieldStepper(equation, *counting, stepper("NystromRK4", equation), m_uniformRMax, m_uniformZMax);
+    m_uniformSteppers.push_back(uniformStepper);
+    integrator = uniformStepper;
+  } else {
+    integrator = stepper(m_stepper, equation);
+    if (integrator == nullptr) {
+      m_log << MSG::ERROR << "Stepper " << m_stepper << " not available! using NystromRK4!" << endmsg;
+      integrator = stepper("NystromRK4", equation);
+    }
+  }
+  if (m_counting) integrator = new CountingStepper(integrator, *counting);
+  m_steppers.emplace_back(integrator);
+  m_chordFinders.emplace_back(new G4ChordFinder(aField, m_minStep, integrator));
+  return m_chordFinders.back().get();
+}
+
+bool FieldSetup::attachToVolumes(const std::string& aName, G4FieldManager* aFieldManager) {
+  G4LogicalVolume* world = G4TransportationManager::GetTransportationManager()
+                               ->GetNavigatorForTracking()
+                               ->GetWorldVolume()
+                               ->GetLogicalVolume();
+  bool found = false;
+  for (int iDaughter = 0; iDaughter < world->GetNoDaughters(); ++iDaughter) {
+    if (world->GetDaughter(iDaughter)->GetName().find(aName) != std::string::npos) {
+      // the field manager is forced to all the daughters of the volume
+      world->GetDaughter(iDaughter)->GetLogicalVolume()->SetFieldManager(aFieldManager, true);
+      m_log << MSG::DEBUG << "Field manager of the volume " << world->GetDaughter(iDaughter)->GetName() << " set"
+            << endmsg;
+      found = true;
+    }
+  }
+  return found;
+}
+
+StatusCode FieldSetup::attachToThread(G4MagneticField* aField) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  G4TransportationManager* transpManager = G4TransportationManager::GetTransportationManager();
+  G4FieldManager* fieldManager = transpManager->GetFieldManager();
+  // the global field manager is set once per thread, also if attached again once the geometry is constructed
+  if (fieldManager->GetDetectorField() != aField || fieldManager->GetChordFinder() == nullptr) {
+    fieldManager->SetDetectorField(aField);
+    fieldManager->SetChordFinder(chordFinder(aField));
+    setAccuracy(*fieldManager, m_accuracy);
+    transpManager->GetPropagatorInField()->SetLargestAcceptableStep(m_maxStep);
+  }
+  // the field managers of the volumes (and the thresholds of the loopers) are set once the run manager is initialised
+  if (transpManager->GetNavigatorForTracking()->GetWorldVolume() == nullptr) {
+    return StatusCode::SUCCESS;
+  }
+  if (!m_looperThresholds.empty() && applyLooperThresholds().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (!m_fieldFreeVolumes.empty()) {
+    // without the field the charged particles are transported along straight lines
+    m_fieldManagers.emplace_back(new G4FieldManager(nullptr, nullptr, false));
+    for (const auto& name : m_fieldFreeVolumes) {
+      if (!attachToVolumes(name, m_fieldManagers.back().get())) {
+        m_log << MSG::ERROR << "Field-free volume " << name << " not found" << endmsg;
+        return StatusCode::FAILURE;
+      }
+    }
+  }
+  for (const auto& volumes : m_volumeAccuracies) {
+    m_fieldManagers.emplace_back(new G4FieldManager(aField, chordFinder(aField)));
+    setAccuracy(*m_fieldManagers.back(), volumes.second);
+    for (const auto& name : volumes.first) {
+      if (!attachToVolumes(name, m_fieldManagers.back().get())) {
+        m_log << MSG::ERROR << "Volume " << name << " with its own field accuracy not found" << endmsg;
+        return StatusCode::FAILURE;
+      }
+    }
+  }
+  return StatusCode::SUCCESS;
+}
+}
@@ -1,17 +1,43 @@
 #include "SimG4Common/GdmlDetectorConstruction.h"
 #include "G4SDManager.hh"
 
+// STL
+#include <cstdio>
+
 namespace sim {
-GdmlDetectorConstruction::GdmlDetectorConstruction(const std::string& aFileName, bool validate)
+GdmlDetectorConstruction::GdmlDetectorConstruction(const std::string& aFileName, bool validate,
+                                                   const std::string& aCacheDir)
     : m_msgSvc("MessageSvc", "GdmlDetectorConstruction"),
       m_log(&(*m_msgSvc), "GdmlDetectorConstruction"),
       m_fileName(aFileName) {
+  std::uint64_t key = aCacheDir.empty() ? 0 : geometryCacheKey(m_fileName);
+  std::string cacheFile;
+  if (key != 0) {
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(key));
+    cacheFile = aCacheDir + "/gdml_" + hex + ".g4geo";
+    m_world = readGeometryCache(cacheFile, key, m_auxMap);
+    if (m_world != nullptr) {
+      m_log << MSG::INFO << "Geometry of " << m_fileName << " read from the cache " << cacheFile << endmsg;
+      return;
+    }
+  }
   m_parser.Read(m_fileName, validate);
+  m_world = m_parser.GetWorldVolume();
+  m_auxMap = *m_parser.GetAuxMap();
+  if (key != 0 && m_world != nullptr) {
+    std::string error;
+    if (writeGeometryCache(cacheFile, key, *m_world, m_auxMap, error)) {
+      m_log << MSG::INFO << "Geometry of " << m_fileName << " written to the cache " << cacheFile << endmsg;
+    } else {
+      m_log << MSG::WARNING << "Geometry of " << m_fileName << " not cached: " << error << endmsg;
+    }
+  }
 }
 
 GdmlDetectorConstruction::~GdmlDetectorConstruction() {}
 
-G4VPhysicalVolume* GdmlDetectorConstruction::Construct() { return m_parser.GetWorldVolume(); }
+G4VPhysicalVolume* GdmlDetectorConstruction::Construct() { return m_world; }
 
 void GdmlDetectorConstruction::ConstructSDandField() {
   // Example from Geant4 examples/extended/persistency/gdml/G04
@@ -24,8 +50,7 @@ void GdmlDetectorConstruction::ConstructSDandField() {
   G4SDManager* SDman = G4SDManager::GetSDMpointer();
   SDman->AddNewDetector( trackerSD );
   */
-  const G4GDMLAuxMapType* auxMap = m_parser.GetAuxMap();
-  for (auto& entry : *auxMap) {
+  for (auto& entry : m_auxMap) {
     for (auto& info : entry.second) {
       if (info.type == "SensDet") {
         // HOW TO USE: uncomment to attach SD registered above
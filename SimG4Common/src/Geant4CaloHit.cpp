@@ -5,6 +5,7 @@ namespace k4 {
 
 // G4 allocation method
 G4ThreadLocal G4Allocator<Geant4CaloHit>* Geant4CaloHitAllocator = 0;
+G4ThreadLocal size_t Geant4CaloHitsInUse = 0;
 // Destructor
 Geant4CaloHit::~Geant4CaloHit() {}
 // Default Constructor
@@ -5,6 +5,7 @@ namespace k4 {
 
 // G4 allocation method
 G4ThreadLocal G4Allocator<Geant4PreDigiTrackHit>* Geant4PreDigiTrackHitAllocator = 0;
+G4ThreadLocal size_t Geant4PreDigiTrackHitsInUse = 0;
 // Destructor
 Geant4PreDigiTrackHit::~Geant4PreDigiTrackHit() {}
 // Default Constructor
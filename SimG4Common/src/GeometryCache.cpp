@@ -0,0 +1,572 @@
+#include "SimG4Common/GeometryCache.h"
+
+// Geant
+#include "G4Box.hh"
+#include "G4Cons.hh"
+#include "G4Element.hh"
+#include "G4Isotope.hh"
+#include "G4LogicalBorderSurface.hh"
+#include "G4LogicalSkinSurface.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4NistManager.hh"
+#include "G4Orb.hh"
+#include "G4PVPlacement.hh"
+#include "G4Polycone.hh"
+#include "G4Polyhedra.hh"
+#include "G4Sphere.hh"
+#include "G4Torus.hh"
+#include "G4Trd.hh"
+#include "G4Tubs.hh"
+#include "G4Version.hh"
+
+// STL
+#include <cmath>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace sim {
+namespace {
+const char s_magic[8] = {'S', 'I', 'M', 'G', '4', 'G', 'E', 'O'};
+const std::uint32_t s_version = 1;
+
+/// Sequential binary output
+class Writer {
+public:
+  explicit Writer(const std::string& aFileName) : m_out(aFileName, std::ios::binary) {}
+  bool good() const { return m_out.good(); }
+  template <typename T>
+  void put(const T& aValue) {
+    m_out.write(reinterpret_cast<const char*>(&aValue), sizeof(T));
+  }
+  void putString(const std::string& aValue) {
+    put<std::uint32_t>(aValue.size());
+    m_out.write(aValue.data(), aValue.size());
+  }
+  void putVector(const std::vector<double>& aValues) {
+    put<std::uint32_t>(aValues.size());
+    m_out.write(reinterpret_cast<const char*>(aValues.data()), aValues.size() * sizeof(double));
+  }
+
+private:
+  std::ofstream m_out;
+};
+
+/// Sequential binary input, the failure is checked once the values are read
+class Reader {
+public:
+  explicit Reader(const std::string& aFileName) : m_in(aFileName, std::ios::binary) {}
+  bool good() const { return m_in.good(); }
+  template <typename T>
+  T get() {
+    T value{};
+    m_in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+  }
+  std::string getString() {
+    std::string value(get<std::uint32_t>(), '\0');
+    m_in.read(&value[0], value.size());
+    return value;
+  }
+  std::vector<double> getVector() {
+    std::vector<double> values(get<std::uint32_t>());
+    m_in.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(double));
+    return values;
+  }
+  void read(char* aData, size_t aSize) { m_in.read(aData, aSize); }
+
+private:
+  std::ifstream m_in;
+};
+
+/// Objects of the geometry, indexed in the order in which they are written
+template <typename T>
+class Index {
+public:
+  /// Add the object if not yet indexed, @returns true if it was added
+  bool add(const T* aObject) {
+    if (m_index.count(aObject)) return false;
+    m_index[aObject] = m_objects.size();
+    m_objects.push_back(aObject);
+    return true;
+  }
+  bool contains(const T* aObject) const { return m_index.count(aObject) > 0; }
+  std::uint32_t operator[](const T* aObject) const { return m_index.at(aObject); }
+  const std::vector<const T*>& objects() const { return m_objects; }
+
+private:
+  std::vector<const T*> m_objects;
+  std::unordered_map<const T*, std::uint32_t> m_index;
+};
+
+/// Parameters of a supported solid (empty type if not supported)
+std::vector<double> solidParameters(const G4VSolid& aSolid, std::string& aType) {
+  aType = aSolid.GetEntityType();
+  if (auto box = dynamic_cast<const G4Box*>(&aSolid)) {
+    return {box->GetXHalfLength(), box->GetYHalfLength(), box->GetZHalfLength()};
+  } else if (auto tubs = dynamic_cast<const G4Tubs*>(&aSolid)) {
+    return {tubs->GetInnerRadius(), tubs->GetOuterRadius(), tubs->GetZHalfLength(), tubs->GetStartPhiAngle(),
+            tubs->GetDeltaPhiAngle()};
+  } else if (auto cons = dynamic_cast<const G4Cons*>(&aSolid)) {
+    return {cons->GetInnerRadiusMinusZ(), cons->GetOuterRadiusMinusZ(), cons->GetInnerRadiusPlusZ(),
+            cons->GetOuterRadiusPlusZ(),  cons->GetZHalfLength(),       cons->GetStartPhiAngle(),
+            cons->GetDeltaPhiAngle()};
+  } else if (auto trd = dynamic_cast<const G4Trd*>(&aSolid)) {
+    return {trd->GetXHalfLength1(), trd->GetXHalfLength2(), trd->GetYHalfLength1(), trd->GetYHalfLength2(),
+            trd->GetZHalfLength()};
+  } else if (auto sphere = dynamic_cast<const G4Sphere*>(&aSolid)) {
+    return {sphere->GetInnerRadius(),    sphere->GetOuterRadius(),    sphere->GetStartPhiAngle(),
+            sphere->GetDeltaPhiAngle(), sphere->GetStartThetaAngle(), sphere->GetDeltaThetaAngle()};
+  } else if (auto orb = dynamic_cast<const G4Orb*>(&aSolid)) {
+    return {orb->GetRadius()};
+  } else if (auto torus = dynamic_cast<const G4Torus*>(&aSolid)) {
+    return {torus->GetRmin(), torus->GetRmax(), torus->GetRtor(), torus->GetSPhi(), torus->GetDPhi()};
+  } else if (auto polycone = dynamic_cast<const G4Polycone*>(&aSolid)) {
+    const G4PolyconeHistorical* original = polycone->GetOriginalParameters();
+    if (original != nullptr) {
+      // start and opening angles, then the z planes with their inner and outer radii
+      std::vector<double> parameters = {original->Start_angle, original->Opening_angle};
+      for (int iPlane = 0; iPlane < original->Num_z_planes; ++iPlane) {
+        parameters.insert(parameters.end(), {original->Z_values[iPlane], original->Rmin[iPlane], original->Rmax[iPlane]});
+      }
+      return parameters;
+    }
+  } else if (auto polyhedra = dynamic_cast<const G4Polyhedra*>(&aSolid)) {
+    const G4PolyhedraHistorical* original = polyhedra->GetOriginalParameters();
+    if (original != nullptr) {
+      // radii are stored at the corners, the constructor takes them at the middle of the sides
+      const double convertRad = std::cos(0.5 * original->Opening_angle / original->numSide);
+      std::vector<double> parameters = {original->Start_angle, original->Opening_angle, double(original->numSide)};
+      for (int iPlane = 0; iPlane < original->Num_z_planes; ++iPlane) {
+        parameters.insert(parameters.end(), {original->Z_values[iPlane], original->Rmin[iPlane] * convertRad,
+                                             original->Rmax[iPlane] * convertRad});
+      }
+      return parameters;
+    }
+  }
+  aType.clear();
+  return {};
+}
+
+/// Create the solid from its parameters
+G4VSolid* createSolid(const std::string& aType, const std::string& aName, const std::vector<double>& p) {
+  auto planes = [&p](size_t aFirst, std::vector<double>& z, std::vector<double>& rmin, std::vector<double>& rmax) {
+    for (size_t i = aFirst; i + 2 < p.size(); i += 3) {
+      z.push_back(p[i]);
+      rmin.push_back(p[i + 1]);
+      rmax.push_back(p[i + 2]);
+    }
+  };
+  if (aType == "G4Box" && p.size() == 3) {
+    return new G4Box(aName, p[0], p[1], p[2]);
+  } else if (aType == "G4Tubs" && p.size() == 5) {
+    return new G4Tubs(aName, p[0], p[1], p[2], p[3], p[4]);
+  } else if (aType == "G4Cons" && p.size() == 7) {
+    return new G4Cons(aName, p[0], p[1], p[2], p[3], p[4], p[5], p[6]);
+  } else if (aType == "G4Trd" && p.size() == 5) {
+    return new G4Trd(aName, p[0], p[1], p[2], p[3], p[4]);
+  } else if (aType == "G4Sphere" && p.size() == 6) {
+    return new G4Sphere(aName, p[0], p[1], p[2], p[3], p[4], p[5]);
+  } else if (aType == "G4Orb" && p.size() == 1) {
+    return new G4Orb(aName, p[0]);
+  } else if (aType == "G4Torus" && p.size() == 5) {
+    return new G4Torus(aName, p[0], p[1], p[2], p[3], p[4]);
+  } else if (aType == "G4Polycone" && p.size() >= 2) {
+    std::vector<double> z, rmin, rmax;
+    planes(2, z, rmin, rmax);
+    return new G4Polycone(aName, p[0], p[1], z.size(), z.data(), rmin.data(), rmax.data());
+  } else if (aType == "G4Polyhedra" && p.size() >= 3) {
+    std::vector<double> z, rmin, rmax;
+    planes(3, z, rmin, rmax);
+    return new G4Polyhedra(aName, p[0], p[1], int(p[2]), z.size(), z.data(), rmin.data(), rmax.data());
+  }
+  return nullptr;
+}
+
+/// Check if createSolid supports the type with the number of parameters
+bool isSupportedSolid(const std::string& aType, const std::vector<double>& p) {
+  return (aType == "G4Box" && p.size() == 3) || (aType == "G4Tubs" && p.size() == 5) ||
+         (aType == "G4Cons" && p.size() == 7) || (aType == "G4Trd" && p.size() == 5) ||
+         (aType == "G4Sphere" && p.size() == 6) || (aType == "G4Orb" && p.size() == 1) ||
+         (aType == "G4Torus" && p.size() == 5) || (aType == "G4Polycone" && p.size() >= 2) ||
+         (aType == "G4Polyhedra" && p.size() >= 3);
+}
+
+/// Objects of the geometry as read from the cache, before the Geant4 objects are created
+struct IsotopeData {
+  std::string name;
+  int z, n, m;
+  double a;
+};
+struct ElementData {
+  std::string name, symbol;
+  double z, a;
+  /// indices of the isotopes with their abundances (none for the natural elements)
+  std::vector<std::pair<std::uint32_t, double>> isotopes;
+};
+struct MaterialData {
+  std::string name;
+  double density, temperature, pressure, excitationEnergy;
+  int state;
+  /// indices of the elements with their mass fractions
+  std::vector<std::pair<std::uint32_t, double>> elements;
+};
+struct SolidData {
+  std::string type, name;
+  std::vector<double> parameters;
+};
+struct PlacementData {
+  std::uint32_t volume;
+  std::string name;
+  int copyNo;
+  bool rotated;
+  double rotation[9];
+  double translation[3];
+};
+struct VolumeData {
+  std::string name;
+  std::uint32_t solid, material;
+  std::vector<PlacementData> daughters;
+};
+}
+
+std::uint64_t geometryCacheKey(const std::string& aFileName) {
+  std::ifstream file(aFileName);
+  if (!file) {
+    return 0;
+  }
+  std::stringstream content;
+  content << std::to_string(G4VERSION_NUMBER) << file.rdbuf();
+  // FNV-1a hash
+  std::uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : content.str()) {
+    hash = (hash ^ c) * 1099511628211ull;
+  }
+  return hash;
+}
+
+bool writeGeometryCache(const std::string& aFileName, std::uint64_t aKey, const G4VPhysicalVolume& aWorld,
+                        const GeometryAuxMap& aAuxMap, std::string& aError) {
+  if (G4LogicalSkinSurface::GetNumberOfSkinSurfaces() > 0 || G4LogicalBorderSurface::GetNumberOfBorderSurfaces() > 0) {
+    aError = "optical surfaces are not supported";
+    return false;
+  }
+  // collect and check all the objects before writing anything
+  Index<G4LogicalVolume> volumes;
+  Index<G4VSolid> solids;
+  Index<G4Material> materials;
+  Index<G4Element> elements;
+  Index<G4Isotope> isotopes;
+  std::vector<const G4LogicalVolume*> toVisit = {aWorld.GetLogicalVolume()};
+  volumes.add(aWorld.GetLogicalVolume());
+  while (!toVisit.empty()) {
+    const G4LogicalVolume* volume = toVisit.back();
+    toVisit.pop_back();
+    std::string type;
+    solidParameters(*volume->GetSolid(), type);
+    if (type.empty()) {
+      aError = "solid " + volume->GetSolid()->GetName() + " of type " + volume->GetSolid()->GetEntityType() +
+               " is not supported";
+      return false;
+    }
+    solids.add(volume->GetSolid());
+    const G4Material* material = volume->GetMaterial();
+    if (material->GetMaterialPropertiesTable() != nullptr) {
+      aError = "material properties of " + material->GetName() + " are not supported";
+      return false;
+    }
+    if (materials.add(material)) {
+      for (size_t iElement = 0; iElement < material->GetNumberOfElements(); ++iElement) {
+        const G4Element* element = material->GetElement(iElement);
+        if (elements.add(element)) {
+          for (size_t iIsotope = 0; iIsotope < element->GetNumberOfIsotopes(); ++iIsotope) {
+            isotopes.add(element->GetIsotope(iIsotope));
+          }
+        }
+      }
+    }
+    for (size_t iDaughter = 0; iDaughter < volume->GetNoDaughters(); ++iDaughter) {
+      const G4VPhysicalVolume* daughter = volume->GetDaughter(iDaughter);
+      if (dynamic_cast<const G4PVPlacement*>(daughter) == nullptr || daughter->IsReplicated()) {
+        aError = "volume " + daughter->GetName() + " is not a simple placement";
+        return false;
+      }
+      if (volumes.add(daughter->GetLogicalVolume())) {
+        toVisit.push_back(daughter->GetLogicalVolume());
+      }
+    }
+  }
+
+  // written aside and moved, so that concurrent jobs never read a partial file
+  std::string tmpFile = aFileName + ".tmp" + std::to_string(::getpid());
+  {
+    Writer out(tmpFile);
+    out.put(s_magic);
+    out.put(s_version);
+    out.put(aKey);
+    out.put<std::uint32_t>(isotopes.objects().size());
+    for (auto isotope : isotopes.objects()) {
+      out.putString(isotope->GetName());
+      out.put<std::int32_t>(isotope->GetZ());
+      out.put<std::int32_t>(isotope->GetN());
+      out.put<double>(isotope->GetA());
+      out.put<std::int32_t>(isotope->Getm());
+    }
+    out.put<std::uint32_t>(elements.objects().size());
+    for (auto element : elements.objects()) {
+      out.putString(element->GetName());
+      out.putString(element->GetSymbol());
+      out.put<double>(element->GetZ());
+      out.put<double>(element->GetA());
+      const bool natural = element->GetNaturalAbundanceFlag() || element->GetNumberOfIsotopes() == 0;
+      out.put<std::int32_t>(natural ? 0 : element->GetNumberOfIsotopes());
+      if (natural) continue;
+      for (size_t iIsotope = 0; iIsotope < element->GetNumberOfIsotopes(); ++iIsotope) {
+        out.put<std::uint32_t>(isotopes[element->GetIsotope(iIsotope)]);
+        out.put<double>(element->GetRelativeAbundanceVector()[iIsotope]);
+      }
+    }
+    out.put<std::uint32_t>(materials.objects().size());
+    for (auto material : materials.objects()) {
+      out.putString(material->GetName());
+      out.put<double>(material->GetDensity());
+      out.put<std::int32_t>(material->GetState());
+      out.put<double>(material->GetTemperature());
+      out.put<double>(material->GetPressure());
+      out.put<double>(material->GetIonisation()->GetMeanExcitationEnergy());
+      out.put<std::uint32_t>(material->GetNumberOfElements());
+      for (size_t iElement = 0; iElement < material->GetNumberOfElements(); ++iElement) {
+        out.put<std::uint32_t>(elements[material->GetElement(iElement)]);
+        out.put<double>(material->GetFractionVector()[iElement]);
+      }
+    }
+    out.put<std::uint32_t>(solids.objects().size());
+    for (auto solid : solids.objects()) {
+      std::string type;
+      std::vector<double> parameters = solidParameters(*solid, type);
+      out.putString(type);
+      out.putString(solid->GetName());
+      out.putVector(parameters);
+    }
+    out.put<std::uint32_t>(volumes.objects().size());
+    for (auto volume : volumes.objects()) {
+      out.putString(volume->GetName());
+      out.put<std::uint32_t>(solids[volume->GetSolid()]);
+      out.put<std::uint32_t>(materials[volume->GetMaterial()]);
+    }
+    for (auto volume : volumes.objects()) {
+      out.put<std::uint32_t>(volume->GetNoDaughters());
+      for (size_t iDaughter = 0; iDaughter < volume->GetNoDaughters(); ++iDaughter) {
+        const G4VPhysicalVolume* daughter = volume->GetDaughter(iDaughter);
+        out.put<std::uint32_t>(volumes[daughter->GetLogicalVolume()]);
+        out.putString(daughter->GetName());
+        out.put<std::int32_t>(daughter->GetCopyNo());
+        const G4RotationMatrix* rotation = daughter->GetFrameRotation();
+        CLHEP::HepRep3x3 rep = rotation != nullptr ? rotation->rep3x3() : CLHEP::HepRep3x3();
+        out.put<std::uint8_t>(rotation != nullptr);
+        for (double value : {rep.xx_, rep.xy_, rep.xz_, rep.yx_, rep.yy_, rep.yz_, rep.zx_, rep.zy_, rep.zz_}) {
+          out.put(value);
+        }
+        const G4ThreeVector& translation = daughter->GetTranslation();
+        out.put<double>(translation.x());
+        out.put<double>(translation.y());
+        out.put<double>(translation.z());
+      }
+    }
+    out.putString(aWorld.GetName());
+    std::uint32_t numAux = 0;
+    for (const auto& entry : aAuxMap) {
+      if (volumes.contains(entry.first)) ++numAux;
+    }
+    out.put(numAux);
+    for (const auto& entry : aAuxMap) {
+      if (!volumes.contains(entry.first)) continue;
+      out.put<std::uint32_t>(volumes[entry.first]);
+      out.put<std::uint32_t>(entry.second.size());
+      for (const auto& aux : entry.second) {
+        out.putString(aux.type);
+        out.putString(aux.value);
+        out.putString(aux.unit);
+      }
+    }
+    if (!out.good()) {
+      aError = "unable to write " + tmpFile;
+      std::remove(tmpFile.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmpFile.c_str(), aFileName.c_str()) != 0) {
+    aError = "unable to write " + aFileName;
+    std::remove(tmpFile.c_str());
+    return false;
+  }
+  return true;
+}
+
+G4VPhysicalVolume* readGeometryCache(const std::string& aFileName, std::uint64_t aKey, GeometryAuxMap& aAuxMap) {
+  Reader in(aFileName);
+  if (!in.good()) {
+    return nullptr;
+  }
+  char magic[sizeof(s_magic)];
+  in.read(magic, sizeof(magic));
+  if (!in.good() || !std::equal(magic, magic + sizeof(magic), s_magic) || in.get<std::uint32_t>() != s_version ||
+      in.get<std::uint64_t>() != aKey) {
+    return nullptr;
+  }
+  // the whole file is read and checked before any Geant4 object is created, so that a corrupted cache (falling back
+  // to the conversion) leaves no objects registered in the Geant4 stores
+  std::vector<IsotopeData> isotopeData(in.get<std::uint32_t>());
+  for (auto& isotope : isotopeData) {
+    isotope.name = in.getString();
+    isotope.z = in.get<std::int32_t>();
+    isotope.n = in.get<std::int32_t>();
+    isotope.a = in.get<double>();
+    isotope.m = in.get<std::int32_t>();
+    if (!in.good()) return nullptr;
+  }
+  std::vector<ElementData> elementData(in.get<std::uint32_t>());
+  for (auto& element : elementData) {
+    element.name = in.getString();
+    element.symbol = in.getString();
+    element.z = in.get<double>();
+    element.a = in.get<double>();
+    element.isotopes.resize(std::max(in.get<std::int32_t>(), 0));
+    for (auto& isotope : element.isotopes) {
+      isotope.first = in.get<std::uint32_t>();
+      isotope.second = in.get<double>();
+      if (!in.good() || isotope.first >= isotopeData.size()) return nullptr;
+    }
+    if (!in.good()) return nullptr;
+  }
+  std::vector<MaterialData> materialData(in.get<std::uint32_t>());
+  for (auto& material : materialData) {
+    material.name = in.getString();
+    material.density = in.get<double>();
+    material.state = in.get<std::int32_t>();
+    material.temperature = in.get<double>();
+    material.pressure = in.get<double>();
+    material.excitationEnergy = in.get<double>();
+    material.elements.resize(in.get<std::uint32_t>());
+    for (auto& element : material.elements) {
+      element.first = in.get<std::uint32_t>();
+      element.second = in.get<double>();
+      if (!in.good() || element.first >= elementData.size()) return nullptr;
+    }
+    if (!in.good()) return nullptr;
+  }
+  std::vector<SolidData> solidData(in.get<std::uint32_t>());
+  for (auto& solid : solidData) {
+    solid.type = in.getString();
+    solid.name = in.getString();
+    solid.parameters = in.getVector();
+    if (!in.good() || !isSupportedSolid(solid.type, solid.parameters)) return nullptr;
+  }
+  std::vector<VolumeData> volumeData(in.get<std::uint32_t>());
+  for (auto& volume : volumeData) {
+    volume.name = in.getString();
+    volume.solid = in.get<std::uint32_t>();
+    volume.material = in.get<std::uint32_t>();
+    if (!in.good() || volume.solid >= solidData.size() || volume.material >= materialData.size()) return nullptr;
+  }
+  for (auto& mother : volumeData) {
+    mother.daughters.resize(in.get<std::uint32_t>());
+    for (auto& daughter : mother.daughters) {
+      daughter.volume = in.get<std::uint32_t>();
+      daughter.name = in.getString();
+      daughter.copyNo = in.get<std::int32_t>();
+      daughter.rotated = in.get<std::uint8_t>();
+      for (double& value : daughter.rotation) {
+        value = in.get<double>();
+      }
+      for (double& value : daughter.translation) {
+        value = in.get<double>();
+      }
+      if (!in.good() || daughter.volume >= volumeData.size()) return nullptr;
+    }
+    if (!in.good()) return nullptr;
+  }
+  const std::string worldName = in.getString();
+  std::vector<std::pair<std::uint32_t, G4GDMLAuxListType>> auxData(in.get<std::uint32_t>());
+  for (auto& aux : auxData) {
+    aux.first = in.get<std::uint32_t>();
+    aux.second.resize(in.get<std::uint32_t>());
+    for (auto& auxStruct : aux.second) {
+      auxStruct.type = in.getString();
+      auxStruct.value = in.getString();
+      auxStruct.unit = in.getString();
+      auxStruct.auxList = nullptr;
+    }
+    if (!in.good() || aux.first >= volumeData.size()) return nullptr;
+  }
+  if (!in.good() || volumeData.empty()) {
+    return nullptr;
+  }
+
+  std::vector<G4Isotope*> isotopes;
+  isotopes.reserve(isotopeData.size());
+  for (const auto& isotope : isotopeData) {
+    isotopes.push_back(new G4Isotope(isotope.name, isotope.z, isotope.n, isotope.a, isotope.m));
+  }
+  std::vector<G4Element*> elements;
+  elements.reserve(elementData.size());
+  for (const auto& element : elementData) {
+    if (element.isotopes.empty()) {
+      elements.push_back(new G4Element(element.name, element.symbol, element.z, element.a));
+      continue;
+    }
+    elements.push_back(new G4Element(element.name, element.symbol, element.isotopes.size()));
+    for (const auto& isotope : element.isotopes) {
+      elements.back()->AddIsotope(isotopes[isotope.first], isotope.second);
+    }
+  }
+  std::vector<G4Material*> materials;
+  materials.reserve(materialData.size());
+  for (const auto& data : materialData) {
+    // NIST materials are built from the Geant4 database, as by the GDML parser
+    G4Material* material =
+        data.name.compare(0, 3, "G4_") == 0 ? G4NistManager::Instance()->FindOrBuildMaterial(data.name) : nullptr;
+    if (material == nullptr) {
+      material = new G4Material(data.name, data.density, data.elements.size(), static_cast<G4State>(data.state),
+                                data.temperature, data.pressure);
+      for (const auto& element : data.elements) {
+        material->AddElement(elements[element.first], element.second);
+      }
+      material->GetIonisation()->SetMeanExcitationEnergy(data.excitationEnergy);
+    }
+    materials.push_back(material);
+  }
+  std::vector<G4VSolid*> solids;
+  solids.reserve(solidData.size());
+  for (const auto& solid : solidData) {
+    solids.push_back(createSolid(solid.type, solid.name, solid.parameters));
+  }
+  std::vector<G4LogicalVolume*> volumes;
+  volumes.reserve(volumeData.size());
+  for (const auto& volume : volumeData) {
+    volumes.push_back(new G4LogicalVolume(solids[volume.solid], materials[volume.material], volume.name));
+  }
+  for (size_t iMother = 0; iMother < volumeData.size(); ++iMother) {
+    for (const auto& daughter : volumeData[iMother].daughters) {
+      const double* rep = daughter.rotation;
+      // rotations are owned by the user, as for the volumes read from GDML
+      G4RotationMatrix* rotation =
+          daughter.rotated ? new G4RotationMatrix(CLHEP::HepRep3x3(rep[0], rep[1], rep[2], rep[3], rep[4], rep[5],
+                                                                   rep[6], rep[7], rep[8]))
+                           : nullptr;
+      const G4ThreeVector translation(daughter.translation[0], daughter.translation[1], daughter.translation[2]);
+      new G4PVPlacement(rotation, translation, volumes[daughter.volume], daughter.name, volumes[iMother], false,
+                        daughter.copyNo);
+    }
+  }
+  for (auto& aux : auxData) {
+    aAuxMap[volumes[aux.first]] = std::move(aux.second);
+  }
+  return new G4PVPlacement(nullptr, G4ThreeVector(), volumes.front(), worldName, nullptr, false, 0);
+}
+}
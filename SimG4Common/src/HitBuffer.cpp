@@ -0,0 +1,52 @@
+#include "SimG4Common/HitBuffer.h"
+
+namespace sim {
+HitBuffer::HitBuffer(const G4String& aDetectorName, const G4String& aCollectionName, bool aPostStep,
+                     size_t aCapacity, bool aPositions)
+    : G4VHitsCollection(aDetectorName, aCollectionName), m_postStep(aPostStep), m_positions(aPositions) {
+  if (aCapacity == 0) return;
+  cellID.reserve(aCapacity);
+  energy.reserve(aCapacity);
+  if (m_positions) {
+    x.reserve(aCapacity);
+    y.reserve(aCapacity);
+    z.reserve(aCapacity);
+  }
+  time.reserve(aCapacity);
+  trackId.reserve(aCapacity);
+  pdg.reserve(aCapacity);
+  if (m_postStep) {
+    postX.reserve(aCapacity);
+    postY.reserve(aCapacity);
+    postZ.reserve(aCapacity);
+  }
+}
+
+HitBuffer::~HitBuffer() {}
+
+void HitBuffer::append(const HitBuffer& aOther, int aTrackIdOffset) {
+  if (!aOther.weight.empty()) {
+    weight.resize(size(), 1);
+    weight.insert(weight.end(), aOther.weight.begin(), aOther.weight.end());
+  }
+  cellID.insert(cellID.end(), aOther.cellID.begin(), aOther.cellID.end());
+  energy.insert(energy.end(), aOther.energy.begin(), aOther.energy.end());
+  if (m_positions && aOther.m_positions) {
+    x.insert(x.end(), aOther.x.begin(), aOther.x.end());
+    y.insert(y.end(), aOther.y.begin(), aOther.y.end());
+    z.insert(z.end(), aOther.z.begin(), aOther.z.end());
+  }
+  time.insert(time.end(), aOther.time.begin(), aOther.time.end());
+  const size_t first = trackId.size();
+  trackId.insert(trackId.end(), aOther.trackId.begin(), aOther.trackId.end());
+  for (size_t iDeposit = first; iDeposit < trackId.size(); ++iDeposit) {
+    trackId[iDeposit] += aTrackIdOffset;
+  }
+  pdg.insert(pdg.end(), aOther.pdg.begin(), aOther.pdg.end());
+  if (m_postStep && aOther.m_postStep) {
+    postX.insert(postX.end(), aOther.postX.begin(), aOther.postX.end());
+    postY.insert(postY.end(), aOther.postY.begin(), aOther.postY.end());
+    postZ.insert(postZ.end(), aOther.postZ.begin(), aOther.postZ.end());
+  }
+}
+}
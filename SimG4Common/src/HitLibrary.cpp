@@ -0,0 +1,100 @@
+// local
+#include "SimG4Common/HitLibrary.h"
+
+// STL
+#include <algorithm>
+#include <cstring>
+
+namespace sim {
+static_assert(sizeof(HitLibrary::Header) == 24, "Header of the hit library is written without padding");
+static_assert(sizeof(HitLibrary::CaloHit) == 24, "Calorimeter hits of the library are written without padding");
+static_assert(sizeof(HitLibrary::TrackerHit) == 56, "Tracker hits of the library are written without padding");
+
+HitLibrary::HitLibrary(const std::string& aFileName) {
+  std::memset(&m_header, 0, sizeof(m_header));
+  m_file = MappedFile(aFileName, sizeof(Header), "a hit library");
+  if (!m_file.isMapped()) {
+    m_error = m_file.error();
+    return;
+  }
+  std::memcpy(&m_header, m_file.data(), sizeof(Header));
+  if (std::strncmp(m_header.magic, kMagic, sizeof(m_header.magic)) != 0) {
+    m_error = aFileName + " is not a hit library (wrong magic string)";
+  } else if (m_header.indexOffset < sizeof(Header) || m_header.indexOffset % sizeof(uint64_t) != 0 ||
+             m_header.indexOffset > m_file.size() ||
+             (m_file.size() - m_header.indexOffset) / sizeof(uint64_t) < m_header.numInteractions) {
+    m_error = aFileName + " is too short for its index (not closed?)";
+  }
+  if (!m_error.empty()) {
+    m_file.reset();
+    return;
+  }
+  m_index = m_file.at<uint64_t>(m_header.indexOffset);
+}
+
+HitLibrary::~HitLibrary() {}
+
+bool HitLibrary::interaction(size_t aIndex, Interaction& aInteraction) const {
+  aInteraction = Interaction();
+  if (m_index == nullptr || aIndex >= m_header.numInteractions) return false;
+  // the blocks are only checked when used, not to read the whole file at the start
+  const uint64_t offset = m_index[aIndex];
+  if (offset < sizeof(Header) || offset % sizeof(uint64_t) != 0 ||
+      offset + 2 * sizeof(uint32_t) > m_header.indexOffset) {
+    return false;
+  }
+  const char* block = m_file.at<char>(offset);
+  uint32_t numHits[2];
+  std::memcpy(numHits, block, sizeof(numHits));
+  const uint64_t size = sizeof(numHits) + numHits[0] * sizeof(CaloHit) + numHits[1] * sizeof(TrackerHit);
+  if (offset + size > m_header.indexOffset) return false;
+  aInteraction.caloHits = reinterpret_cast<const CaloHit*>(block + sizeof(numHits));
+  aInteraction.numCaloHits = numHits[0];
+  aInteraction.trackerHits = reinterpret_cast<const TrackerHit*>(aInteraction.caloHits + numHits[0]);
+  aInteraction.numTrackerHits = numHits[1];
+  return true;
+}
+
+HitLibraryWriter::HitLibraryWriter(const std::string& aFileName)
+    : m_file(aFileName, std::ios::binary | std::ios::trunc) {
+  HitLibrary::Header header;
+  std::memset(&header, 0, sizeof(header));
+  m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+HitLibraryWriter::~HitLibraryWriter() {
+  if (m_file.is_open()) close();
+}
+
+void HitLibraryWriter::add(std::vector<HitLibrary::CaloHit>& aCaloHits,
+                           std::vector<HitLibrary::TrackerHit>& aTrackerHits) {
+  std::sort(aCaloHits.begin(), aCaloHits.end(),
+            [](const HitLibrary::CaloHit& aLhs, const HitLibrary::CaloHit& aRhs) { return aLhs.cellID < aRhs.cellID; });
+  std::stable_sort(aTrackerHits.begin(), aTrackerHits.end(),
+                   [](const HitLibrary::TrackerHit& aLhs, const HitLibrary::TrackerHit& aRhs) {
+                     return aLhs.cellID < aRhs.cellID;
+                   });
+  m_offsets.push_back(m_file.tellp());
+  const uint32_t numHits[2] = {static_cast<uint32_t>(aCaloHits.size()), static_cast<uint32_t>(aTrackerHits.size())};
+  m_file.write(reinterpret_cast<const char*>(numHits), sizeof(numHits));
+  m_file.write(reinterpret_cast<const char*>(aCaloHits.data()), aCaloHits.size() * sizeof(HitLibrary::CaloHit));
+  m_file.write(reinterpret_cast<const char*>(aTrackerHits.data()),
+               aTrackerHits.size() * sizeof(HitLibrary::TrackerHit));
+}
+
+bool HitLibraryWriter::close() {
+  if (!m_file.is_open()) return false;
+  HitLibrary::Header header;
+  std::memset(&header, 0, sizeof(header));
+  std::strncpy(header.magic, HitLibrary::kMagic, sizeof(header.magic));
+  header.numInteractions = m_offsets.size();
+  header.indexOffset = m_file.tellp();
+  m_file.write(reinterpret_cast<const char*>(m_offsets.data()), m_offsets.size() * sizeof(uint64_t));
+  // the header is only valid once the index is complete
+  m_file.seekp(0);
+  m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  const bool good = m_file.good();
+  m_file.close();
+  return good && !m_file.fail();
+}
+}
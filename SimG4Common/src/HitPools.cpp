@@ -0,0 +1,79 @@
+#include "SimG4Common/HitPools.h"
+
+// FCCSW
+#include "SimG4Common/Geant4CaloHit.h"
+#include "SimG4Common/Geant4PreDigiTrackHit.h"
+#include "SimG4Common/HugePages.h"
+
+// STL
+#include <algorithm>
+#include <atomic>
+
+namespace {
+/// Factor of the page size of the pools, set before the threads create hits
+std::atomic<unsigned int> pageFactor{1};
+/// Number of the huge pages spanned by a page of the pools, all but one being aligned within it
+const size_t kHugePagesPerPage = 4;
+/// Peak sizes and numbers of releases of the pools of the thread
+G4ThreadLocal size_t caloHitPoolPeak = 0;
+G4ThreadLocal size_t trackHitPoolPeak = 0;
+G4ThreadLocal unsigned int caloHitPoolReleases = 0;
+G4ThreadLocal unsigned int trackHitPoolReleases = 0;
+
+template <class T>
+sim::HitPoolStatistics statistics(const G4Allocator<T>* aAllocator, size_t aNumHitsInUse, size_t aPeak,
+                                  unsigned int aNumReleases) {
+  sim::HitPoolStatistics poolStatistics;
+  if (aAllocator == nullptr) return poolStatistics;
+  poolStatistics.allocatedSize = aAllocator->GetAllocatedSize();
+  poolStatistics.peakSize = std::max(aPeak, poolStatistics.allocatedSize);
+  poolStatistics.numPages = aAllocator->GetNoPages();
+  poolStatistics.pageSize = aAllocator->GetPageSize();
+  poolStatistics.numHitsInUse = aNumHitsInUse;
+  poolStatistics.numReleases = aNumReleases;
+  return poolStatistics;
+}
+
+template <class T>
+unsigned int release(G4Allocator<T>* aAllocator, size_t aNumHitsInUse, size_t aThreshold, size_t& aPeak,
+                     unsigned int& aNumReleases) {
+  if (aAllocator == nullptr) return 0;
+  const size_t size = aAllocator->GetAllocatedSize();
+  aPeak = std::max(aPeak, size);
+  // pages may only be freed when no hit points to them
+  if (aNumHitsInUse > 0 || size <= aThreshold) return 0;
+  aAllocator->ResetStorage();
+  ++aNumReleases;
+  return 1;
+}
+}
+
+namespace sim {
+void setHitPoolPageFactor(unsigned int aFactor) { pageFactor = std::max(aFactor, 1u); }
+
+unsigned int hitPoolPageFactor() { return pageFactor; }
+
+unsigned int hitPoolPageFactor(size_t aPageSize) {
+  if (!hugePages() || aPageSize == 0) return pageFactor;
+  const size_t hugeFactor = (kHugePagesPerPage * hugePageSize() + aPageSize - 1) / aPageSize;
+  return std::max<size_t>(pageFactor, hugeFactor);
+}
+
+void adviseHitPoolPage(void* aPage, size_t aSize) { adviseHugePages(aPage, aSize); }
+
+HitPoolStatistics caloHitPoolStatistics() {
+  return statistics(k4::Geant4CaloHitAllocator, k4::Geant4CaloHitsInUse, caloHitPoolPeak, caloHitPoolReleases);
+}
+
+HitPoolStatistics trackHitPoolStatistics() {
+  return statistics(k4::Geant4PreDigiTrackHitAllocator, k4::Geant4PreDigiTrackHitsInUse, trackHitPoolPeak,
+                    trackHitPoolReleases);
+}
+
+unsigned int releaseHitPools(size_t aThreshold) {
+  return release(k4::Geant4CaloHitAllocator, k4::Geant4CaloHitsInUse, aThreshold, caloHitPoolPeak,
+                 caloHitPoolReleases) +
+         release(k4::Geant4PreDigiTrackHitAllocator, k4::Geant4PreDigiTrackHitsInUse, aThreshold, trackHitPoolPeak,
+                 trackHitPoolReleases);
+}
+}
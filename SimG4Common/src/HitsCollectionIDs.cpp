@@ -0,0 +1,41 @@
+#include "SimG4Common/HitsCollectionIDs.h"
+
+// Geant
+#include "G4HCofThisEvent.hh"
+#include "G4VHitsCollection.hh"
+
+// STL
+#include <algorithm>
+
+namespace sim {
+const std::vector<int>& HitsCollectionIDs::get(const G4HCofThisEvent& aCollections,
+                                               const std::vector<std::string>& aNames) {
+  if (matches(aCollections)) {
+    return m_ids;
+  }
+  m_ids.clear();
+  m_names.clear();
+  m_numCollections = aCollections.GetNumberOfCollections();
+  for (int iCollection = 0; iCollection < m_numCollections; ++iCollection) {
+    G4VHitsCollection* collection = aCollections.GetHC(iCollection);
+    if (collection != nullptr && std::find(aNames.begin(), aNames.end(), collection->GetName()) != aNames.end()) {
+      m_ids.push_back(iCollection);
+      m_names.push_back(collection->GetName());
+    }
+  }
+  return m_ids;
+}
+
+bool HitsCollectionIDs::matches(const G4HCofThisEvent& aCollections) const {
+  if (m_numCollections != aCollections.GetNumberOfCollections()) {
+    return false;
+  }
+  for (size_t iId = 0; iId < m_ids.size(); ++iId) {
+    G4VHitsCollection* collection = aCollections.GetHC(m_ids[iId]);
+    if (collection == nullptr || collection->GetName() != m_names[iId]) {
+      return false;
+    }
+  }
+  return true;
+}
+}
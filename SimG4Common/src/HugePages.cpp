@@ -0,0 +1,48 @@
+#include "SimG4Common/HugePages.h"
+
+// STL
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+/// Flag whether the huge pages are used, set before the memory is allocated
+std::atomic<bool> enabled{false};
+}
+
+namespace sim {
+void setHugePages(bool aEnabled) { enabled = aEnabled; }
+
+bool hugePages() { return enabled; }
+
+size_t hugePageSize() {
+  static const size_t size = [] {
+    size_t pageSize = 0;
+    std::ifstream file("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size");
+    return (file >> pageSize) && pageSize > 0 ? pageSize : size_t(2 * 1024 * 1024);
+  }();
+  return size;
+}
+
+std::string hugePagesMode() {
+  // e.g. "always [madvise] never", the current mode in brackets
+  std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+  std::string modes;
+  std::getline(file, modes);
+  const size_t begin = modes.find('[');
+  const size_t end = modes.find(']', begin);
+  return begin != std::string::npos && end != std::string::npos ? modes.substr(begin + 1, end - begin - 1) : "";
+}
+
+bool adviseHugePages(void* aStart, size_t aSize) {
+  if (!enabled || aStart == nullptr) return false;
+  // the advice applies to whole pages of the system, within the range
+  const uintptr_t pageSize = ::sysconf(_SC_PAGESIZE);
+  const uintptr_t begin = (reinterpret_cast<uintptr_t>(aStart) + pageSize - 1) / pageSize * pageSize;
+  const uintptr_t end = (reinterpret_cast<uintptr_t>(aStart) + aSize) / pageSize * pageSize;
+  if (end <= begin) return false;
+  return ::madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE) == 0;
+}
+}
@@ -0,0 +1,30 @@
+#include "SimG4Common/MTRunManager.h"
+
+// Geant
+#include "G4MTRunManagerKernel.hh"
+
+namespace sim {
+MTRunManager::MTRunManager() : G4MTRunManager() {}
+
+MTRunManager::~MTRunManager() {}
+
+StatusCode MTRunManager::start() {
+  // as in G4RunManager::BeamOn(), without the event loop
+  if (G4RunManager::ConfirmBeamOnCondition()) {
+    G4RunManager::ConstructScoringWorlds();
+    G4RunManager::RunInitialization();
+    G4MTRunManager::GetMTMasterRunManagerKernel()->SetUpDecayChannels();
+    // commands applied on master so far are replayed in each worker thread
+    G4MTRunManager::PrepareCommandsStack();
+    return StatusCode::SUCCESS;
+  } else {
+    return StatusCode::FAILURE;
+  }
+}
+
+void MTRunManager::InitializeEventLoop(G4int, const char*, G4int) {
+  G4MTRunManager::GetMTMasterRunManagerKernel()->SetUpDecayChannels();
+}
+
+void MTRunManager::finalize() { G4RunManager::RunTermination(); }
+}
@@ -0,0 +1,79 @@
+#include "SimG4Common/MappedFile.h"
+#include "SimG4Common/HugePages.h"
+
+// STL
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace sim {
+MappedFile::MappedFile(const std::string& aFileName, size_t aMinSize, const std::string& aContent) {
+  const int file = ::open(aFileName.c_str(), O_RDONLY);
+  if (file < 0) {
+    m_error = "cannot open " + aFileName + ": " + std::strerror(errno);
+    return;
+  }
+  m_opened = true;
+  struct stat status;
+  if (::fstat(file, &status) != 0 || status.st_size == 0 || static_cast<size_t>(status.st_size) < aMinSize) {
+    m_error = aFileName + " is too short for the header of " + aContent;
+    ::close(file);
+    return;
+  }
+  void* data = ::mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, file, 0);
+  // the mapping stays valid after the file is closed
+  ::close(file);
+  if (data == MAP_FAILED) {
+    m_error = "cannot map " + aFileName + ": " + std::strerror(errno);
+    return;
+  }
+  m_data = data;
+  m_size = status.st_size;
+}
+
+MappedFile::~MappedFile() { reset(); }
+
+MappedFile::MappedFile(MappedFile&& aOther) noexcept { *this = std::move(aOther); }
+
+MappedFile& MappedFile::operator=(MappedFile&& aOther) noexcept {
+  if (this != &aOther) {
+    reset();
+    std::swap(m_data, aOther.m_data);
+    std::swap(m_size, aOther.m_size);
+    m_opened = aOther.m_opened;
+    m_error = std::move(aOther.m_error);
+  }
+  return *this;
+}
+
+MappedFile MappedFile::replicate() const {
+  MappedFile replica;
+  replica.m_opened = m_opened;
+  replica.m_error = m_error;
+  if (m_data == nullptr) return replica;
+  void* data = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (data == MAP_FAILED) {
+    replica.m_error = std::string("cannot allocate the replica of the mapping: ") + std::strerror(errno);
+    return replica;
+  }
+  // advised before the copy, so that the pages are huge when first written
+  sim::adviseHugePages(data, m_size);
+  std::memcpy(data, m_data, m_size);
+  ::mprotect(data, m_size, PROT_READ);
+  replica.m_data = data;
+  replica.m_size = m_size;
+  return replica;
+}
+
+bool MappedFile::adviseHugePages() { return m_data != nullptr && sim::adviseHugePages(m_data, m_size); }
+
+void MappedFile::reset() {
+  if (m_data != nullptr) ::munmap(m_data, m_size);
+  m_data = nullptr;
+  m_size = 0;
+}
+}
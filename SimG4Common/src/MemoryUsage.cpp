@@ -0,0 +1,44 @@
+#include "SimG4Common/MemoryUsage.h"
+
+// FCCSW
+#include "SimG4Common/Geant4CaloHit.h"
+#include "SimG4Common/Geant4PreDigiTrackHit.h"
+
+// STL
+#include <fstream>
+#include <malloc.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace sim {
+double residentMemory() {
+  std::ifstream statm("/proc/self/statm");
+  long size = 0, resident = 0;
+  if (!(statm >> size >> resident)) return 0;
+  return resident * static_cast<double>(::sysconf(_SC_PAGESIZE)) / (1024. * 1024.);
+}
+
+double peakResidentMemory() {
+  struct rusage usage;
+  ::getrusage(RUSAGE_SELF, &usage);
+  // in kB on Linux
+  return usage.ru_maxrss / 1024.;
+}
+
+double heapMemory() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  struct mallinfo2 info = ::mallinfo2();
+#else
+  struct mallinfo info = ::mallinfo();
+#endif
+  return (static_cast<double>(info.uordblks) + info.hblkhd) / (1024. * 1024.);
+}
+
+size_t caloHitPoolSize() {
+  return k4::Geant4CaloHitAllocator ? k4::Geant4CaloHitAllocator->GetAllocatedSize() : 0;
+}
+
+size_t trackHitPoolSize() {
+  return k4::Geant4PreDigiTrackHitAllocator ? k4::Geant4PreDigiTrackHitAllocator->GetAllocatedSize() : 0;
+}
+}
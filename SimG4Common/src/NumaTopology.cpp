@@ -0,0 +1,123 @@
+#include "SimG4Common/NumaTopology.h"
+
+// STL
+#include <algorithm>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <map>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include <string>
+
+namespace sim {
+namespace {
+/// Cores of the job per domain and the domain of each core of the job
+struct Topology {
+  std::vector<std::vector<int>> domains;
+  std::map<int, int> domainOfCore;
+};
+
+/// Parse a list of cores of the kernel, e.g. "0-7,16-23"
+std::vector<int> parseCoreList(const std::string& aList) {
+  std::vector<int> cores;
+  std::stringstream list(aList);
+  std::string range;
+  while (std::getline(list, range, ',')) {
+    if (range.empty()) continue;
+    const size_t dash = range.find('-');
+    const int first = std::atoi(range.substr(0, dash).c_str());
+    const int last = dash == std::string::npos ? first : std::atoi(range.substr(dash + 1).c_str());
+    for (int core = first; core <= last; ++core) cores.push_back(core);
+  }
+  return cores;
+}
+
+Topology readTopology() {
+  Topology topology;
+  // the cores of the job, read once: the mask of the calling thread is restricted once it is pinned
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (::sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    for (int core = 0; core < CPU_SETSIZE; ++core) CPU_SET(core, &allowed);
+  }
+  std::map<int, std::vector<int>> nodes;
+  if (DIR* directory = ::opendir("/sys/devices/system/node")) {
+    while (const dirent* entry = ::readdir(directory)) {
+      const std::string name = entry->d_name;
+      if (name.compare(0, 4, "node") != 0 || name.size() == 4 ||
+          name.find_first_not_of("0123456789", 4) != std::string::npos) {
+        continue;
+      }
+      std::ifstream cpulist("/sys/devices/system/node/" + name + "/cpulist");
+      std::string list;
+      if (std::getline(cpulist, list)) nodes[std::atoi(name.c_str() + 4)] = parseCoreList(list);
+    }
+    ::closedir(directory);
+  }
+  for (const auto& node : nodes) {
+    std::vector<int> cores;
+    for (int core : node.second) {
+      if (core < CPU_SETSIZE && CPU_ISSET(core, &allowed)) cores.push_back(core);
+    }
+    if (cores.empty()) continue;
+    for (int core : cores) topology.domainOfCore[core] = topology.domains.size();
+    topology.domains.push_back(cores);
+  }
+  // cores of the job outside of the known domains (or no topology at all) form a domain of their own
+  std::vector<int> unknown;
+  for (int core = 0; core < CPU_SETSIZE; ++core) {
+    if (CPU_ISSET(core, &allowed) && topology.domainOfCore.count(core) == 0) unknown.push_back(core);
+  }
+  if (!unknown.empty()) {
+    for (int core : unknown) topology.domainOfCore[core] = topology.domains.size();
+    topology.domains.push_back(unknown);
+  }
+  return topology;
+}
+
+const Topology& topology() {
+  static const Topology topology = readTopology();
+  return topology;
+}
+}
+
+std::vector<std::vector<int>> numaDomains() { return topology().domains; }
+
+int currentNumaDomain() {
+  const int core = ::sched_getcpu();
+  auto domain = topology().domainOfCore.find(core);
+  return domain != topology().domainOfCore.end() ? domain->second : 0;
+}
+
+std::vector<std::vector<int>> workerCores(unsigned int aNumWorkers, bool aPerCore) {
+  const auto& domains = topology().domains;
+  std::vector<std::vector<int>> workers;
+  if (domains.empty()) return workers;
+  if (!aPerCore) {
+    for (unsigned int iWorker = 0; iWorker < aNumWorkers; ++iWorker) {
+      workers.push_back(domains[iWorker % domains.size()]);
+    }
+    return workers;
+  }
+  // the cores taken from each domain in turn, so that the workers are spread over the domains
+  std::vector<int> cores;
+  for (size_t iCore = 0; cores.size() < topology().domainOfCore.size(); ++iCore) {
+    for (const auto& domain : domains) {
+      if (iCore < domain.size()) cores.push_back(domain[iCore]);
+    }
+  }
+  for (unsigned int iWorker = 0; iWorker < aNumWorkers; ++iWorker) {
+    workers.push_back({cores[iWorker % cores.size()]});
+  }
+  return workers;
+}
+
+bool pinCurrentThread(const std::vector<int>& aCores) {
+  cpu_set_t cores;
+  CPU_ZERO(&cores);
+  for (int core : aCores) CPU_SET(core, &cores);
+  return !aCores.empty() && ::pthread_setaffinity_np(::pthread_self(), sizeof(cores), &cores) == 0;
+}
+}
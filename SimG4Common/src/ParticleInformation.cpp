@@ -1,13 +1,37 @@
 #include "SimG4Common/ParticleInformation.h"
 
+// Geant4
+#include "G4Allocator.hh"
+
+// STL
+#include <mutex>
+
 namespace sim {
-ParticleInformation::ParticleInformation(const edm4hep::MCParticle& aMCpart) : m_mcParticle(aMCpart), m_smeared(false) {}
+namespace {
+// not thread-local: the objects may be deleted by another thread than the one that created them
+G4Allocator<ParticleInformation>* particleInformationAllocator = nullptr;
+std::mutex particleInformationMutex;
+}
+
+void* ParticleInformation::operator new(size_t) {
+  std::lock_guard<std::mutex> lock(particleInformationMutex);
+  if (particleInformationAllocator == nullptr) particleInformationAllocator = new G4Allocator<ParticleInformation>;
+  return particleInformationAllocator->MallocSingle();
+}
+
+void ParticleInformation::operator delete(void* aInformation) {
+  std::lock_guard<std::mutex> lock(particleInformationMutex);
+  particleInformationAllocator->FreeSingle(static_cast<ParticleInformation*>(aInformation));
+}
+
+ParticleInformation::ParticleInformation(const edm4hep::MCParticle& aMCpart)
+    : m_mcParticleID(aMCpart.getObjectID()), m_smeared(false) {}
 
 ParticleInformation::~ParticleInformation() {}
 
 void ParticleInformation::Print() const {}
 
-const edm4hep::MCParticle& ParticleInformation::mcParticle() const { return m_mcParticle; }
+const podio::ObjectID& ParticleInformation::mcParticleID() const { return m_mcParticleID; }
 void ParticleInformation::setEndMomentum(const CLHEP::Hep3Vector& aMom) { m_endMomentum = aMom; }
 const CLHEP::Hep3Vector& ParticleInformation::endMomentum() const { return m_endMomentum; }
 void ParticleInformation::setVertexPosition(const CLHEP::Hep3Vector& aPos) { m_vertexPosition = aPos; }
@@ -1,7 +1,21 @@
 #include "SimG4Common/RunManager.h"
 
 // Geant
+#include "G4Event.hh"
+#include "G4GeometryManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4SolidStore.hh"
 #include "G4VModularPhysicsList.hh"
+#include "G4VUserDetectorConstruction.hh"
+
+// STL
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace sim {
 RunManager::RunManager()
@@ -29,7 +43,16 @@ StatusCode RunManager::processEvent(G4Event& aEvent) {
     return StatusCode::FAILURE;
   }
   G4RunManager::currentEvent = &aEvent;
+  if (m_watchdog != nullptr) m_watchdog->beginEvent();
   G4RunManager::eventManager->ProcessOneEvent(G4RunManager::currentEvent);
+  // an aborted event is kept as simulated until the abort, the next events are processed
+  if (m_watchdog != nullptr) m_watchdog->endEvent(aEvent, m_log);
+  if (aEvent.IsAborted() && (m_watchdog == nullptr || m_watchdog->abortReason() == EventWatchdog::Abort::kNone)) {
+    // aborted by another component (e.g. a fast simulation model that failed): the event is incomplete
+    m_log << MSG::ERROR << "Event " << aEvent.GetEventID() << " was aborted during the simulation" << endmsg;
+    G4RunManager::currentEvent = nullptr;
+    return StatusCode::FAILURE;
+  }
   G4RunManager::AnalyzeEvent(G4RunManager::currentEvent);
   G4RunManager::UpdateScoring();
   m_prevEventTerminated = false;
@@ -54,5 +77,74 @@ StatusCode RunManager::terminateEvent() {
   m_prevEventTerminated = true;
   return StatusCode::SUCCESS;
 }
+
+StatusCode RunManager::detachEvent(G4Event*& aEvent) {
+  if (m_prevEventTerminated) {
+    m_log << MSG::ERROR << "Trying to detach an event, but no event has been processed by Geant" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  // as in G4RunManager::TerminateOneEvent(), but the event is not stacked (deleted)
+  aEvent = G4RunManager::currentEvent;
+  G4RunManager::currentEvent = nullptr;
+  ++G4RunManager::numberOfEventProcessed;
+  m_prevEventTerminated = true;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode RunManager::adoptEvent(G4Event& aEvent) {
+  if (!m_prevEventTerminated) {
+    m_log << MSG::ERROR << "Trying to adopt an event, but previous event has not been terminated" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  G4RunManager::currentEvent = &aEvent;
+  m_prevEventTerminated = false;
+  return StatusCode::SUCCESS;
+}
+
+void RunManager::setWatchdog(const EventWatchdog::Budget& aBudget) {
+  if (!aBudget.enabled() || m_watchdog != nullptr) return;
+  // the watchdog (owning the user stepping action) is owned by the stepping manager
+  m_watchdog = new EventWatchdog(aBudget, G4RunManager::userSteppingAction);
+  G4RunManager::SetUserAction(m_watchdog);
+}
+
+StatusCode RunManager::rebuildGeometry(G4VUserDetectorConstruction* aConstruction) {
+  // names of the root volumes of the regions, detached before the volumes are deleted
+  std::vector<std::pair<G4Region*, std::vector<std::string>>> regions;
+  for (G4Region* region : *G4RegionStore::GetInstance()) {
+    // the default regions are given the new world by the kernel
+    const bool defaultRegion =
+        region->GetName() == "DefaultRegionForTheWorld" || region->GetName() == "DefaultRegionForParallelWorld";
+    std::vector<G4LogicalVolume*> roots(region->GetRootLogicalVolumeIterator(),
+                                        region->GetRootLogicalVolumeIterator() + region->GetNumberOfRootVolumes());
+    if (!defaultRegion) regions.emplace_back(region, std::vector<std::string>());
+    for (G4LogicalVolume* root : roots) {
+      if (!defaultRegion) regions.back().second.push_back(root->GetName());
+      region->RemoveRootLogicalVolume(root, false);
+    }
+  }
+  G4GeometryManager::GetInstance()->OpenGeometry();
+  G4PhysicalVolumeStore::GetInstance()->Clean();
+  G4LogicalVolumeStore::GetInstance()->Clean();
+  G4SolidStore::GetInstance()->Clean();
+  delete G4RunManager::userDetector;
+  G4RunManager::userDetector = aConstruction;
+  // the stores are already cleaned, the kernel only needs the new world
+  G4RunManager::ReinitializeGeometry(false);
+  G4RunManager::InitializeGeometry();
+  for (auto& region : regions) {
+    for (const auto& name : region.second) {
+      G4LogicalVolume* root = G4LogicalVolumeStore::GetInstance()->GetVolume(name, false);
+      if (root == nullptr) {
+        m_log << MSG::ERROR << "Volume " << name << " of the region " << region.first->GetName()
+              << " is not in the new geometry" << endmsg;
+        return StatusCode::FAILURE;
+      }
+      region.first->AddRootLogicalVolume(root);
+    }
+  }
+  return StatusCode::SUCCESS;
+}
+
 void RunManager::finalize() { G4RunManager::RunTermination(); }
 }
@@ -0,0 +1,208 @@
+#include "SimG4Common/SubEvents.h"
+
+// FCCSW
+#include "SimG4Common/EventInformation.h"
+#include "SimG4Common/Geant4CaloHit.h"
+#include "SimG4Common/Geant4PreDigiTrackHit.h"
+#include "SimG4Common/HitBuffer.h"
+
+// Geant
+#include "G4Event.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+
+// STL
+#include <algorithm>
+
+namespace {
+/// Highest track ID of the hits in a collection of hits of type T (-1 if the collection is of another type)
+template <class T>
+int maxHitTrackId(G4VHitsCollection* aCollection) {
+  auto collection = dynamic_cast<G4THitsCollection<T>*>(aCollection);
+  if (collection == nullptr) {
+    return -1;
+  }
+  int maxId = 0;
+  for (size_t iHit = 0; iHit < collection->GetSize(); ++iHit) {
+    maxId = std::max(maxId, static_cast<int>((*collection)[iHit]->trackId));
+  }
+  return maxId;
+}
+
+/// Merge the collections of hits of type T with the given index (nullptr if they are of another type)
+template <class T>
+G4VHitsCollection* mergeHits(const std::vector<G4Event*>& aSubEvents, int aIndex, const std::vector<int>& aOffsets) {
+  G4THitsCollection<T>* merged = nullptr;
+  for (size_t iSub = 0; iSub < aSubEvents.size(); ++iSub) {
+    G4HCofThisEvent* collections = aSubEvents[iSub]->GetHCofThisEvent();
+    if (collections == nullptr) continue;
+    auto collection = dynamic_cast<G4THitsCollection<T>*>(collections->GetHC(aIndex));
+    if (collection == nullptr) {
+      if (collections->GetHC(aIndex) != nullptr) return nullptr;
+      continue;
+    }
+    if (merged == nullptr) {
+      merged = new G4THitsCollection<T>(collection->GetSDname(), collection->GetName());
+    }
+    for (size_t iHit = 0; iHit < collection->GetSize(); ++iHit) {
+      T* hit = new T(*(*collection)[iHit]);
+      hit->trackId += aOffsets[iSub];
+      merged->insert(hit);
+    }
+  }
+  return merged;
+}
+
+/// Highest track ID of the deposits in a hit buffer (-1 if the collection is not a hit buffer)
+int maxBufferTrackId(G4VHitsCollection* aCollection) {
+  auto buffer = dynamic_cast<sim::HitBuffer*>(aCollection);
+  if (buffer == nullptr) {
+    return -1;
+  }
+  return buffer->trackId.empty() ? 0 : *std::max_element(buffer->trackId.begin(), buffer->trackId.end());
+}
+
+/// Merge the hit buffers with the given index (nullptr if they are collections of another type)
+G4VHitsCollection* mergeBuffers(const std::vector<G4Event*>& aSubEvents, int aIndex, const std::vector<int>& aOffsets) {
+  sim::HitBuffer* merged = nullptr;
+  for (size_t iSub = 0; iSub < aSubEvents.size(); ++iSub) {
+    G4HCofThisEvent* collections = aSubEvents[iSub]->GetHCofThisEvent();
+    if (collections == nullptr) continue;
+    auto buffer = dynamic_cast<sim::HitBuffer*>(collections->GetHC(aIndex));
+    if (buffer == nullptr) {
+      if (collections->GetHC(aIndex) != nullptr) return nullptr;
+      continue;
+    }
+    if (merged == nullptr) {
+      merged = new sim::HitBuffer(buffer->GetSDname(), buffer->GetName(), buffer->hasPostStep(), 0,
+                                  buffer->hasPositions());
+    }
+    merged->append(*buffer, aOffsets[iSub]);
+  }
+  return merged;
+}
+}
+
+namespace sim {
+double estimateCost(const G4PrimaryVertex& aVertex, double aCostPerPrimary) {
+  double cost = 0;
+  for (const G4PrimaryParticle* particle = aVertex.GetPrimary(); particle != nullptr; particle = particle->GetNext()) {
+    cost += particle->GetKineticEnergy() + aCostPerPrimary;
+  }
+  return cost;
+}
+
+double estimateCost(const G4Event& aEvent, double aCostPerPrimary) {
+  double cost = 0;
+  for (int iVertex = 0; iVertex < aEvent.GetNumberOfPrimaryVertex(); ++iVertex) {
+    cost += estimateCost(*aEvent.GetPrimaryVertex(iVertex), aCostPerPrimary);
+  }
+  return cost;
+}
+
+std::vector<G4Event*> splitEvent(const G4Event& aEvent, unsigned int aNumSubEvents, double aCostPerPrimary) {
+  unsigned int numSubEvents = std::min<unsigned int>(aNumSubEvents, aEvent.GetNumberOfPrimaryVertex());
+  std::vector<G4Event*> subEvents;
+  for (unsigned int iSub = 0; iSub < numSubEvents; ++iSub) {
+    subEvents.push_back(new G4Event(aEvent.GetEventID()));
+  }
+  // sub-event of each vertex: in turn, or the cheapest sub-event for the vertices from the most expensive one
+  std::vector<unsigned int> target(aEvent.GetNumberOfPrimaryVertex());
+  for (size_t iVertex = 0; iVertex < target.size(); ++iVertex) {
+    target[iVertex] = iVertex % std::max(numSubEvents, 1u);
+  }
+  if (aCostPerPrimary >= 0 && numSubEvents > 1) {
+    std::vector<std::pair<double, int>> vertexCosts;
+    for (int iVertex = 0; iVertex < aEvent.GetNumberOfPrimaryVertex(); ++iVertex) {
+      vertexCosts.emplace_back(estimateCost(*aEvent.GetPrimaryVertex(iVertex), aCostPerPrimary), iVertex);
+    }
+    std::stable_sort(vertexCosts.begin(), vertexCosts.end(),
+                     [](const std::pair<double, int>& a, const std::pair<double, int>& b) {
+                       return a.first > b.first;
+                     });
+    std::vector<double> subEventCosts(numSubEvents, 0);
+    for (const auto& vertexCost : vertexCosts) {
+      const unsigned int cheapest =
+          std::min_element(subEventCosts.begin(), subEventCosts.end()) - subEventCosts.begin();
+      target[vertexCost.second] = cheapest;
+      subEventCosts[cheapest] += vertexCost.first;
+    }
+  }
+  // vertices are added in their original order, so that each sub-event keeps the order of the event
+  for (int iVertex = 0; iVertex < aEvent.GetNumberOfPrimaryVertex(); ++iVertex) {
+    const G4PrimaryVertex* vertex = aEvent.GetPrimaryVertex(iVertex);
+    auto copy = new G4PrimaryVertex(vertex->GetPosition(), vertex->GetT0());
+    // copies the whole list of particles of the vertex (with daughters)
+    if (vertex->GetPrimary() != nullptr) {
+      copy->SetPrimary(new G4PrimaryParticle(*vertex->GetPrimary()));
+    }
+    copy->SetWeight(vertex->GetWeight());
+    subEvents[target[iVertex]]->AddPrimaryVertex(copy);
+  }
+  return subEvents;
+}
+
+unsigned int mergeSubEvents(G4Event& aEvent, const std::vector<G4Event*>& aSubEvents) {
+  // offsets of the track IDs: child IDs are always larger than the IDs of their parents,
+  // so the highest ID found in the output of a sub-event bounds all the IDs that may be referred to
+  std::vector<int> offsets;
+  int offset = 0;
+  int numCollections = 0;
+  for (const auto subEvent : aSubEvents) {
+    offsets.push_back(offset);
+    int maxId = 0;
+    for (int iVertex = 0; iVertex < subEvent->GetNumberOfPrimaryVertex(); ++iVertex) {
+      maxId += subEvent->GetPrimaryVertex(iVertex)->GetNumberOfParticle();
+    }
+    G4HCofThisEvent* collections = subEvent->GetHCofThisEvent();
+    if (collections != nullptr) {
+      numCollections = std::max(numCollections, collections->GetNumberOfCollections());
+      for (int iColl = 0; iColl < collections->GetNumberOfCollections(); ++iColl) {
+        G4VHitsCollection* collection = collections->GetHC(iColl);
+        if (collection == nullptr) continue;
+        maxId = std::max(maxId, std::max(maxHitTrackId<k4::Geant4CaloHit>(collection),
+                                         maxHitTrackId<k4::Geant4PreDigiTrackHit>(collection)));
+        maxId = std::max(maxId, maxBufferTrackId(collection));
+      }
+    }
+    auto evtinfo = dynamic_cast<const sim::EventInformation*>(subEvent->GetUserInformation());
+    if (evtinfo != nullptr) {
+      maxId = std::max(maxId, evtinfo->maxTrackId());
+    }
+    offset += maxId;
+  }
+  unsigned int numSkipped = 0;
+  if (numCollections > 0) {
+    auto merged = new G4HCofThisEvent(numCollections);
+    for (int iColl = 0; iColl < numCollections; ++iColl) {
+      G4VHitsCollection* collection = mergeHits<k4::Geant4CaloHit>(aSubEvents, iColl, offsets);
+      if (collection == nullptr) {
+        collection = mergeHits<k4::Geant4PreDigiTrackHit>(aSubEvents, iColl, offsets);
+      }
+      if (collection == nullptr) {
+        collection = mergeBuffers(aSubEvents, iColl, offsets);
+      }
+      if (collection == nullptr) {
+        ++numSkipped;
+        continue;
+      }
+      merged->AddHitsCollection(iColl, collection);
+    }
+    aEvent.SetHCofThisEvent(merged);
+  }
+  sim::EventInformation* mergedInfo = nullptr;
+  for (size_t iSub = 0; iSub < aSubEvents.size(); ++iSub) {
+    auto evtinfo = dynamic_cast<const sim::EventInformation*>(aSubEvents[iSub]->GetUserInformation());
+    if (evtinfo == nullptr) continue;
+    if (mergedInfo == nullptr) {
+      mergedInfo = new sim::EventInformation();
+    }
+    mergedInfo->addParticles(*evtinfo, offsets[iSub]);
+  }
+  if (mergedInfo != nullptr) {
+    aEvent.SetUserInformation(mergedInfo);
+  }
+  return numSkipped;
+}
+}
@@ -0,0 +1,57 @@
+// local
+#include "SimG4Common/UniformFieldStepper.h"
+
+// Geant 4
+#include "G4ExactHelixStepper.hh"
+#include "G4Mag_EqRhs.hh"
+
+// STL
+#include <cmath>
+
+namespace sim {
+UniformFieldStepper::Counters& UniformFieldStepper::Counters::operator+=(const Counters& aOther) {
+  helixSteps += aOther.helixSteps;
+  helixFieldCalls += aOther.helixFieldCalls;
+  fallbackSteps += aOther.fallbackSteps;
+  fallbackFieldCalls += aOther.fallbackFieldCalls;
+  return *this;
+}
+
+double UniformFieldStepper::Counters::savedFieldCalls() const {
+  if (fallbackSteps == 0) return 0;
+  return double(helixSteps) * fallbackFieldCalls / fallbackSteps - double(helixFieldCalls);
+}
+
+UniformFieldStepper::UniformFieldStepper(G4Mag_EqRhs* aEquation, const CountingField& aField,
+                                         G4MagIntegratorStepper* aFallback, double aRMax, double aZMax)
+    : G4MagIntegratorStepper(aEquation, 6),
+      m_helix(new G4ExactHelixStepper(aEquation)),
+      m_fallback(aFallback),
+      m_field(aField),
+      m_rMax(aRMax),
+      m_zMax(aZMax) {}
+
+UniformFieldStepper::~UniformFieldStepper() {}
+
+void UniformFieldStepper::Stepper(const G4double y[], const G4double dydx[], G4double h, G4double yout[],
+                                  G4double yerr[]) {
+  const unsigned long callsBefore = m_field.calls();
+  // the path is not longer than the step, hence it stays in the field if the ball of radius h around the start does
+  m_lastHelix = std::sqrt(y[0] * y[0] + y[1] * y[1]) + h < m_rMax && std::abs(y[2]) + h < m_zMax;
+  if (m_lastHelix) {
+    m_helix->Stepper(y, dydx, h, yout, yerr);
+    ++m_counters.helixSteps;
+    m_counters.helixFieldCalls += m_field.calls() - callsBefore;
+  } else {
+    m_fallback->Stepper(y, dydx, h, yout, yerr);
+    ++m_counters.fallbackSteps;
+    m_counters.fallbackFieldCalls += m_field.calls() - callsBefore;
+  }
+}
+
+G4double UniformFieldStepper::DistChord() const {
+  return m_lastHelix ? m_helix->DistChord() : m_fallback->DistChord();
+}
+
+G4int UniformFieldStepper::IntegratorOrder() const { return m_fallback->IntegratorOrder(); }
+}
@@ -0,0 +1,146 @@
+#include "SimG4Common/VolumeIndex.h"
+
+// Geant4
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4TransportationManager.hh"
+#include "G4VPhysicalVolume.hh"
+
+// STL
+#include <algorithm>
+#include <mutex>
+#include <regex>
+#include <unordered_set>
+
+namespace {
+/// Add the volume to the result if it is not yet in it
+void addVolume(G4LogicalVolume* aVolume, std::unordered_set<G4LogicalVolume*>& aFound,
+               std::vector<G4LogicalVolume*>& aResult) {
+  if (aFound.insert(aVolume).second) {
+    aResult.push_back(aVolume);
+  }
+}
+}
+
+namespace sim {
+bool VolumeIndex::matching(const std::string& aName, Matching& aMatching) {
+  if (aName == "daughters") {
+    aMatching = Matching::Daughters;
+  } else if (aName == "exact") {
+    aMatching = Matching::Exact;
+  } else if (aName == "prefix") {
+    aMatching = Matching::Prefix;
+  } else if (aName == "regex") {
+    aMatching = Matching::Regex;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool VolumeIndex::valid(const std::string& aName, Matching aMatching) {
+  if (aMatching != Matching::Regex) return true;
+  try {
+    std::regex expression(aName);
+  } catch (const std::regex_error&) {
+    return false;
+  }
+  return true;
+}
+
+std::string VolumeIndex::configure(const std::string& aMatchingName, const std::vector<std::string>& aNames,
+                                   Matching& aMatching) {
+  if (!matching(aMatchingName, aMatching)) {
+    return "Unknown matching of the volume names " + aMatchingName + " (daughters, exact, prefix or regex)";
+  }
+  for (const auto& name : aNames) {
+    if (!valid(name, aMatching)) {
+      return "Volume name " + name + " is not a valid regular expression";
+    }
+  }
+  return "";
+}
+
+std::vector<G4LogicalVolume*> VolumeIndex::match(const std::vector<std::string>& aNames, Matching aMatching,
+                                                 std::vector<std::string>* aUnmatched) {
+  const auto index = instance();
+  std::vector<G4LogicalVolume*> result;
+  // a volume matched by several names is the root of one region
+  std::unordered_set<G4LogicalVolume*> found;
+  for (const auto& name : aNames) {
+    const std::vector<G4LogicalVolume*> volumes = index->find(name, aMatching);
+    if (volumes.empty() && aUnmatched != nullptr) {
+      aUnmatched->push_back(name);
+    }
+    for (G4LogicalVolume* volume : volumes) {
+      addVolume(volume, found, result);
+    }
+  }
+  return result;
+}
+
+std::shared_ptr<const VolumeIndex> VolumeIndex::instance() {
+  static std::mutex mutex;
+  static std::shared_ptr<const VolumeIndex> index;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (index == nullptr || index->m_numPhysical != G4PhysicalVolumeStore::GetInstance()->size() ||
+      index->m_numLogical != G4LogicalVolumeStore::GetInstance()->size()) {
+    index.reset(new VolumeIndex());
+  }
+  return index;
+}
+
+VolumeIndex::VolumeIndex() {
+  const G4PhysicalVolumeStore& physicalVolumes = *G4PhysicalVolumeStore::GetInstance();
+  const G4LogicalVolumeStore& logicalVolumes = *G4LogicalVolumeStore::GetInstance();
+  m_numPhysical = physicalVolumes.size();
+  m_numLogical = logicalVolumes.size();
+  m_volumes.reserve(m_numPhysical + m_numLogical);
+  for (G4VPhysicalVolume* volume : physicalVolumes) {
+    m_volumes.emplace_back(volume->GetName(), volume->GetLogicalVolume());
+  }
+  for (G4LogicalVolume* volume : logicalVolumes) {
+    m_volumes.emplace_back(volume->GetName(), volume);
+  }
+  std::sort(m_volumes.begin(), m_volumes.end());
+  m_volumes.erase(std::unique(m_volumes.begin(), m_volumes.end()), m_volumes.end());
+  G4LogicalVolume* world =
+      (*G4TransportationManager::GetTransportationManager()->GetWorldsIterator())->GetLogicalVolume();
+  for (size_t iDaughter = 0; iDaughter < world->GetNoDaughters(); ++iDaughter) {
+    m_worldDaughters.emplace_back(world->GetDaughter(iDaughter)->GetName(),
+                                  world->GetDaughter(iDaughter)->GetLogicalVolume());
+  }
+}
+
+std::vector<G4LogicalVolume*> VolumeIndex::find(const std::string& aName, Matching aMatching) const {
+  std::vector<G4LogicalVolume*> result;
+  std::unordered_set<G4LogicalVolume*> found;
+  switch (aMatching) {
+  case Matching::Daughters:
+    for (const auto& daughter : m_worldDaughters) {
+      if (daughter.first.find(aName) != std::string::npos) addVolume(daughter.second, found, result);
+    }
+    break;
+  case Matching::Exact:
+  case Matching::Prefix: {
+    // the names starting with the prefix follow it in the sorted index
+    auto volume = std::lower_bound(m_volumes.begin(), m_volumes.end(), aName,
+                                   [](const auto& aVolume, const std::string& aKey) { return aVolume.first < aKey; });
+    for (; volume != m_volumes.end() && volume->first.compare(0, aName.size(), aName) == 0; ++volume) {
+      if (aMatching == Matching::Exact && volume->first.size() != aName.size()) break;
+      addVolume(volume->second, found, result);
+    }
+    break;
+  }
+  case Matching::Regex: {
+    const std::regex expression(aName);
+    for (const auto& volume : m_volumes) {
+      if (std::regex_match(volume.first, expression)) addVolume(volume.second, found, result);
+    }
+    break;
+  }
+  }
+  return result;
+}
+}
@@ -0,0 +1,115 @@
+#include "SimG4Common/WorkerRunManager.h"
+
+// Geant
+#include "G4DCofThisEvent.hh"
+#include "G4Event.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4TrajectoryContainer.hh"
+
+namespace sim {
+WorkerRunManager::WorkerRunManager()
+    : G4WorkerRunManager(),
+      m_prevEventTerminated(true),
+      m_msgSvc("MessageSvc", "WorkerRunManager"),
+      m_log(&(*m_msgSvc), "WorkerRunManager") {}
+
+WorkerRunManager::~WorkerRunManager() {}
+
+StatusCode WorkerRunManager::start() {
+  // as in G4WorkerRunManager::BeamOn()
+  if (G4RunManager::ConfirmBeamOnCondition()) {
+    G4WorkerRunManager::ConstructScoringWorlds();
+    G4WorkerRunManager::RunInitialization();
+    return StatusCode::SUCCESS;
+  } else {
+    return StatusCode::FAILURE;
+  }
+}
+
+StatusCode WorkerRunManager::processEvent(G4Event& aEvent) {
+  if (!m_prevEventTerminated) {
+    m_log << MSG::ERROR << "Trying to process an event, but previous event has not been terminated" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  G4RunManager::currentEvent = &aEvent;
+  if (m_watchdog != nullptr) m_watchdog->beginEvent();
+  G4RunManager::eventManager->ProcessOneEvent(G4RunManager::currentEvent);
+  // an aborted event is kept as simulated until the abort, the next events are processed
+  if (m_watchdog != nullptr) m_watchdog->endEvent(aEvent, m_log);
+  if (aEvent.IsAborted() && (m_watchdog == nullptr || m_watchdog->abortReason() == EventWatchdog::Abort::kNone)) {
+    // aborted by another component (e.g. a fast simulation model that failed): the event is incomplete
+    m_log << MSG::ERROR << "Event " << aEvent.GetEventID() << " was aborted during the simulation" << endmsg;
+    G4RunManager::currentEvent = nullptr;
+    return StatusCode::FAILURE;
+  }
+  G4RunManager::AnalyzeEvent(G4RunManager::currentEvent);
+  G4RunManager::UpdateScoring();
+  m_prevEventTerminated = false;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode WorkerRunManager::retrieveEvent(G4Event*& aEvent) {
+  if (m_prevEventTerminated) {
+    m_log << MSG::ERROR << "Trying to retrieve an event, but no event has been processed by Geant" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  aEvent = const_cast<G4Event*>(G4RunManager::GetCurrentEvent());
+  return StatusCode::SUCCESS;
+}
+
+StatusCode WorkerRunManager::terminateEvent() {
+  if (m_prevEventTerminated) {
+    m_log << MSG::ERROR << "Trying to terminate an event, but no event has been processed by Geant" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  G4RunManager::TerminateOneEvent();
+  m_prevEventTerminated = true;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode WorkerRunManager::detachEvent(G4Event*& aEvent) {
+  if (m_prevEventTerminated) {
+    m_log << MSG::ERROR << "Trying to detach an event, but no event has been processed by Geant" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  // as in G4RunManager::TerminateOneEvent(), but the event is not stacked (deleted)
+  aEvent = G4RunManager::currentEvent;
+  G4RunManager::currentEvent = nullptr;
+  ++G4RunManager::numberOfEventProcessed;
+  m_prevEventTerminated = true;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode WorkerRunManager::adoptEvent(G4Event& aEvent) {
+  if (!m_prevEventTerminated) {
+    m_log << MSG::ERROR << "Trying to adopt an event, but previous event has not been terminated" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  G4RunManager::currentEvent = &aEvent;
+  m_prevEventTerminated = false;
+  return StatusCode::SUCCESS;
+}
+
+void WorkerRunManager::deleteThreadData(G4Event& aEvent) {
+  // as in ~G4Event(), which leaves null pointers alone
+  delete aEvent.GetHCofThisEvent();
+  aEvent.SetHCofThisEvent(nullptr);
+  delete aEvent.GetDCofThisEvent();
+  aEvent.SetDCofThisEvent(nullptr);
+  G4TrajectoryContainer* trajectories = aEvent.GetTrajectoryContainer();
+  if (trajectories != nullptr) {
+    trajectories->clearAndDestroy();
+    delete trajectories;
+    aEvent.SetTrajectoryContainer(nullptr);
+  }
+}
+
+void WorkerRunManager::setWatchdog(const EventWatchdog::Budget& aBudget) {
+  if (!aBudget.enabled() || m_watchdog != nullptr) return;
+  // the watchdog (owning the user stepping action) is owned by the stepping manager
+  m_watchdog = new EventWatchdog(aBudget, G4RunManager::userSteppingAction);
+  G4RunManager::SetUserAction(m_watchdog);
+}
+
+void WorkerRunManager::finalize() { G4WorkerRunManager::RunTermination(); }
+}
@@ -0,0 +1,124 @@
+#include "SimG4Common/WorkerThread.h"
+
+// FCCSW
+#include "SimG4Common/MTRunManager.h"
+#include "SimG4Common/NumaTopology.h"
+#include "SimG4Common/WorkerRunManager.h"
+
+// Geant
+#include "G4Threading.hh"
+#include "G4UImanager.hh"
+#include "G4UserWorkerThreadInitialization.hh"
+#include "G4VUserActionInitialization.hh"
+#include "G4VUserDetectorConstruction.hh"
+#include "G4VUserPhysicsList.hh"
+#include "G4WorkerThread.hh"
+#include "Randomize.hh"
+
+namespace sim {
+WorkerThread::WorkerThread(MTRunManager& aMaster, int aId, const std::vector<long>& aSeeds, Job aInit,
+                           const std::vector<int>& aCores)
+    : m_master(aMaster),
+      m_id(aId),
+      m_seeds(aSeeds),
+      m_cores(aCores),
+      m_runManager(nullptr),
+      m_initStatus(StatusCode::FAILURE),
+      m_stop(false) {
+  std::future<void> ready = m_ready.get_future();
+  m_thread = std::thread(&WorkerThread::run, this, aInit);
+  ready.wait();
+}
+
+WorkerThread::~WorkerThread() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cond.notify_one();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+StatusCode WorkerThread::execute(Job aJob) {
+  std::packaged_task<StatusCode()> task([this, &aJob]() { return aJob(*m_runManager); });
+  std::future<StatusCode> result = task.get_future();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobs.push_back(std::move(task));
+  }
+  m_cond.notify_one();
+  return result.get();
+}
+
+std::future<StatusCode> WorkerThread::submit(Job aJob) {
+  std::packaged_task<StatusCode()> task([this, aJob]() { return aJob(*m_runManager); });
+  std::future<StatusCode> result = task.get_future();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobs.push_back(std::move(task));
+  }
+  m_cond.notify_one();
+  return result;
+}
+
+// as in G4MTRunManagerKernel::StartThread(), without the event loop
+StatusCode WorkerThread::setUp(Job& aInit) {
+  // pinned first, so that all the workspaces of the thread are allocated on the NUMA domain of its cores
+  if (!m_cores.empty()) m_pinned = pinCurrentThread(m_cores);
+  G4Threading::G4SetThreadId(m_id);
+  m_context = std::make_unique<G4WorkerThread>();
+  m_context->SetThreadId(m_id);
+  // random engine of the same type as the one of the master, seeded independently
+  G4UserWorkerThreadInitialization engineInit;
+  engineInit.SetupRNGEngine(G4MTRunManager::getMasterRandomEngine());
+  G4Random::setTheSeeds(m_seeds.data());
+  // thread-local workspaces for the shared geometry and physics tables
+  G4WorkerThread::BuildGeometryAndPhysicsVector();
+  m_runManager = new WorkerRunManager();
+  m_runManager->SetWorkerThread(m_context.get());
+  m_runManager->SetUserInitialization(const_cast<G4VUserPhysicsList*>(m_master.GetUserPhysicsList()));
+  m_runManager->G4RunManager::SetUserInitialization(
+      const_cast<G4VUserDetectorConstruction*>(m_master.GetUserDetectorConstruction()));
+  // user actions are created for each thread
+  const G4VUserActionInitialization* actions = m_master.GetUserActionInitialization();
+  if (actions != nullptr) {
+    actions->Build();
+  }
+  // geometry is copied from master, sensitive detectors are constructed (ConstructSDandField)
+  m_runManager->Initialize();
+  G4UImanager* UImanager = G4UImanager::GetUIpointer();
+  for (const auto& command : m_master.GetCommandStack()) {
+    UImanager->ApplyCommand(command);
+  }
+  if (aInit && aInit(*m_runManager).isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  return m_runManager->start();
+}
+
+void WorkerThread::run(Job aInit) {
+  m_initStatus = setUp(aInit);
+  m_ready.set_value();
+  while (true) {
+    std::packaged_task<StatusCode()> task;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cond.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+      if (m_jobs.empty()) {
+        break;
+      }
+      task = std::move(m_jobs.front());
+      m_jobs.pop_front();
+    }
+    task();
+  }
+  if (m_initStatus.isSuccess()) {
+    m_runManager->finalize();
+  }
+  delete m_runManager;
+  m_runManager = nullptr;
+  G4WorkerThread::DestroyGeometryAndPhysicsVector();
+}
+}
@@ -4,15 +4,37 @@
 #include "SimG4Interface/IGeoSvc.h"
 #include "SimG4Common/Geant4CaloHit.h"
 #include "SimG4Common/Geant4PreDigiTrackHit.h"
+#include "SimG4Common/HitBuffer.h"
 
 // Geant
 #include "G4Event.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4THitsCollection.hh"
 
 // DD4hep
 #include "DDG4/Geant4Hits.h"
+#include "DDSegmentation/BitFieldCoder.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
 
 DECLARE_COMPONENT(InspectHitsCollectionsTool)
 
+namespace {
+/// Energy and cellID of a hit of a collection, or of a deposit of a buffer
+template <typename Hit>
+double energyOf(const G4THitsCollection<Hit>& aHits, size_t aIndex) {
+  return aHits[aIndex]->energyDeposit;
+}
+double energyOf(const sim::HitBuffer& aBuffer, size_t aIndex) { return aBuffer.energy[aIndex]; }
+template <typename Hit>
+uint64_t cellIDOf(const G4THitsCollection<Hit>& aHits, size_t aIndex) {
+  return aHits[aIndex]->cellID;
+}
+uint64_t cellIDOf(const sim::HitBuffer& aBuffer, size_t aIndex) { return aBuffer.cellID[aIndex]; }
+}
+
 InspectHitsCollectionsTool::InspectHitsCollectionsTool(const std::string& aType, const std::string& aName,
                                                        const IInterface* aParent)
     : GaudiTool(aType, aName, aParent), m_geoSvc("GeoSvc", aName) {
@@ -41,40 +63,115 @@ StatusCode InspectHitsCollectionsTool::initialize() {
       debug() << "Hits will be saved to EDM from the collection " << readoutName << endmsg;
     }
   }
+  if (m_sampling < 1) {
+    error() << "Sampling of the events needs to be positive" << endmsg;
+    return StatusCode::FAILURE;
+  }
   return StatusCode::SUCCESS;
 }
 
-StatusCode InspectHitsCollectionsTool::finalize() { return GaudiTool::finalize(); }
+StatusCode InspectHitsCollectionsTool::finalize() {
+  for (const auto& readout : m_readoutStatistics) {
+    const ReadoutStatistics& stats = readout.second;
+    if (stats.numEvents == 0) continue;
+    const double meanHits = stats.sumHits / stats.numEvents;
+    info() << "Readout " << readout.first << ": " << stats.numEvents << " sampled events, hits per event "
+           << meanHits << " +- " << std::sqrt(std::max(0., stats.sumHits2 / stats.numEvents - meanHits * meanHits))
+           << " (max " << stats.maxHits << "), energy per event " << stats.sumEnergy / stats.numEvents << " MeV"
+           << endmsg;
+    for (size_t iBin = 0; iBin < s_numEnergyBins; ++iBin) {
+      if (stats.energyBins[iBin] == 0) continue;
+      std::string range = "in [1e" + std::to_string(int(iBin) - 7) + ", 1e" + std::to_string(int(iBin) - 6) + ") MeV";
+      if (iBin == 0) range = "below 1 eV";
+      if (iBin == s_numEnergyBins - 1) range = "above 1 TeV";
+      info() << "\thits with energy " << range << ": " << stats.energyBins[iBin] << endmsg;
+    }
+    if (stats.decoder == nullptr) continue;
+    const auto& fields = stats.decoder->fields();
+    for (size_t iField = 0; iField < fields.size(); ++iField) {
+      const auto& values = stats.occupancy[iField];
+      if (values.empty()) continue;
+      auto minmax = std::minmax_element(values.begin(), values.end(),
+                                        [](const auto& a, const auto& b) { return a.first < b.first; });
+      auto busiest = std::max_element(values.begin(), values.end(),
+                                      [](const auto& a, const auto& b) { return a.second < b.second; });
+      info() << "\tfield " << fields[iField].name() << ": " << values.size() << " values in ["
+             << minmax.first->first << ", " << minmax.second->first << "], most hits (" << busiest->second
+             << ") for value " << busiest->first << endmsg;
+    }
+  }
+  return GaudiTool::finalize();
+}
+
+template <typename Hits>
+void InspectHitsCollectionsTool::accumulate(const Hits& aHits, ReadoutStatistics& aStatistics) const {
+  const size_t n_hit = aHits.GetSize();
+  ++aStatistics.numEvents;
+  aStatistics.sumHits += n_hit;
+  aStatistics.sumHits2 += double(n_hit) * n_hit;
+  aStatistics.maxHits = std::max(aStatistics.maxHits, n_hit);
+  const auto& fields = aStatistics.decoder->fields();
+  for (size_t iter_hit = 0; iter_hit < n_hit; iter_hit++) {
+    const double energy = energyOf(aHits, iter_hit);
+    aStatistics.sumEnergy += energy;
+    // decades of energy from 1 eV (bin 1) to 1 TeV, with underflow and overflow
+    const double decade = energy > 0 ? std::floor(std::log10(energy / CLHEP::eV)) + 1 : 0;
+    aStatistics.energyBins[std::min(static_cast<size_t>(std::max(decade, 0.)), s_numEnergyBins - 1)]++;
+    const uint64_t cellID = cellIDOf(aHits, iter_hit);
+    for (size_t iField = 0; iField < fields.size(); ++iField) {
+      aStatistics.occupancy[iField][fields[iField].value(cellID)]++;
+    }
+  }
+}
 
 StatusCode InspectHitsCollectionsTool::saveOutput(const G4Event& aEvent) {
   G4HCofThisEvent* collections = aEvent.GetHCofThisEvent();
   G4VHitsCollection* collect;
-  k4::Geant4PreDigiTrackHit* hitT;
-  k4::Geant4CaloHit* hitC;
+  if (m_statistics) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_numEvents++ % m_sampling != 0 || collections == nullptr) {
+      return StatusCode::SUCCESS;
+    }
+    for (int iter_coll : m_collectionIDs.get(*collections, m_readoutNames)) {
+      collect = collections->GetHC(iter_coll);
+      ReadoutStatistics& stats = m_readoutStatistics[collect->GetName()];
+      if (stats.decoder == nullptr) {
+        stats.decoder = m_geoSvc->lcdd()->readout(collect->GetName()).idSpec().decoder();
+        stats.occupancy.resize(stats.decoder->fields().size());
+      }
+      if (auto buffer = dynamic_cast<const sim::HitBuffer*>(collect)) {
+        accumulate(*buffer, stats);
+      } else if (auto hitsT = dynamic_cast<G4THitsCollection<k4::Geant4PreDigiTrackHit>*>(collect)) {
+        accumulate(*hitsT, stats);
+      } else if (auto hitsC = dynamic_cast<G4THitsCollection<k4::Geant4CaloHit>*>(collect)) {
+        accumulate(*hitsC, stats);
+      }
+    }
+    return StatusCode::SUCCESS;
+  }
   info() << "Obtaining hits collections that are stored in this event:" << endmsg;
   if (collections != nullptr) {
-    for (int iter_coll = 0; iter_coll < collections->GetNumberOfCollections(); iter_coll++) {
+    for (int iter_coll : m_collectionIDs.get(*collections, m_readoutNames)) {
       collect = collections->GetHC(iter_coll);
-      if (std::find(m_readoutNames.begin(), m_readoutNames.end(), collect->GetName()) != m_readoutNames.end()) {
-        info() << "\tcollection #: " << iter_coll << "\tname: " << collect->GetName()
-               << "\tsize: " << collect->GetSize() << endmsg;
-        size_t n_hit = collect->GetSize();
-        auto decoder = m_geoSvc->lcdd()->readout(collect->GetName()).idSpec().decoder();
+      info() << "\tcollection #: " << iter_coll << "\tname: " << collect->GetName() << "\tsize: " << collect->GetSize()
+             << endmsg;
+      if (!msgLevel(MSG::DEBUG)) continue;
+      size_t n_hit = collect->GetSize();
+      auto decoder = m_geoSvc->lcdd()->readout(collect->GetName()).idSpec().decoder();
+      auto print = [this, n_hit, decoder](const auto& aHits) {
         for (size_t iter_hit = 0; iter_hit < n_hit; iter_hit++) {
-          hitT = dynamic_cast<k4::Geant4PreDigiTrackHit*>(collect->GetHit(iter_hit));
-          if (hitT) {
-            dd4hep::DDSegmentation::CellID cID = hitT->cellID;
-            debug() << "hit Edep: " << hitT->energyDeposit << "\tcellID: " << cID << "\t"
-                    << decoder->valueString(cID) << endmsg;
-          } else {
-          hitC = dynamic_cast<k4::Geant4CaloHit*>(collect->GetHit(iter_hit));
-            if (hitC) {
-              dd4hep::DDSegmentation::CellID cID = hitC->cellID;
-              debug() << "hit Edep: " << hitC->energyDeposit << "\tcellID: " << cID << "\t"
-                      << decoder->valueString(cID) << endmsg;
-            }
-          }
+          dd4hep::DDSegmentation::CellID cID = cellIDOf(aHits, iter_hit);
+          debug() << "hit Edep: " << energyOf(aHits, iter_hit) << "\tcellID: " << cID << "\t"
+                  << decoder->valueString(cID) << endmsg;
         }
+      };
+      // type of the hits checked once per collection
+      if (auto buffer = dynamic_cast<const sim::HitBuffer*>(collect)) {
+        print(*buffer);
+      } else if (auto hitsT = dynamic_cast<G4THitsCollection<k4::Geant4PreDigiTrackHit>*>(collect)) {
+        print(*hitsT);
+      } else if (auto hitsC = dynamic_cast<G4THitsCollection<k4::Geant4CaloHit>*>(collect)) {
+        print(*hitsC);
       }
     }
   }
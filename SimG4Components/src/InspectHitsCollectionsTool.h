@@ -5,13 +5,35 @@
 #include "GaudiAlg/GaudiTool.h"
 
 // FCCSW
+#include "SimG4Common/HitsCollectionIDs.h"
 #include "SimG4Interface/ISimG4SaveOutputTool.h"
 class IGeoSvc;
 
+// STL
+#include <array>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Geant
+template <class T>
+class G4THitsCollection;
+
+// DD4hep
+namespace dd4hep {
+namespace DDSegmentation {
+class BitFieldCoder;
+}
+}
+
 /** @class InspectHitsCollectionsTool TestDD4hep/TestDD4hep/InspectHitsCollectionsTool.h InspectHitsCollectionsTool.h
  *
  *  Tool used to inspect the hits collection.
  *  No output in EDM is produced.
+ *  If \b'statistics' is set, the hits are not printed. Instead, for every \b'sampling'-th event, the multiplicity
+ *  of the hits, their energy and the occupancy of the values of each field of the cellID are accumulated per readout,
+ *  and a summary is printed at finalize.
  *
  *  @author Anna Zaborowska
  */
@@ -34,6 +56,42 @@ private:
   /// Name of the readouts (hits collections)
   Gaudi::Property<std::vector<std::string>> m_readoutNames{
       this, "readoutNames", {}, "Names of the readouts (hits collections)"};
+  /// Indices of the inspected collections in the events
+  sim::HitsCollectionIDs m_collectionIDs;
+  /// Flag whether the statistics should be accumulated instead of printing the hits
+  Gaudi::Property<bool> m_statistics{this, "statistics", false,
+                                      "Accumulate statistics of the hits (printed at finalize) instead of printing them"};
+  /// Fraction of the events used for the statistics
+  Gaudi::Property<unsigned int> m_sampling{this, "sampling", 1, "Accumulate the statistics for every n-th event"};
+  /// Number of bins of the energy histogram (decades from 1 eV)
+  static constexpr size_t s_numEnergyBins = 14;
+  /// Statistics of the hits of a readout
+  struct ReadoutStatistics {
+    /// Number of events in which the collection was inspected
+    size_t numEvents = 0;
+    /// Sum of the number of hits, and of its square
+    double sumHits = 0;
+    double sumHits2 = 0;
+    /// Maximal number of hits in an event
+    size_t maxHits = 0;
+    /// Sum of the energy of the hits
+    double sumEnergy = 0;
+    /// Number of hits in decades of energy (from 1 eV, with underflow and overflow)
+    std::array<size_t, s_numEnergyBins> energyBins{};
+    /// Fields of the cellID
+    const dd4hep::DDSegmentation::BitFieldCoder* decoder = nullptr;
+    /// Number of hits per value, for each field of the cellID
+    std::vector<std::unordered_map<long long, size_t>> occupancy;
+  };
+  /// Add the hits of the collection (or the deposits of the buffer) to the statistics
+  template <typename Hits>
+  void accumulate(const Hits& aHits, ReadoutStatistics& aStatistics) const;
+  /// Statistics by readout name
+  std::map<std::string, ReadoutStatistics> m_readoutStatistics;
+  /// Number of events seen (sampled or not)
+  size_t m_numEvents = 0;
+  /// Statistics may be filled from several threads
+  std::mutex m_mutex;
 };
 
 #endif /* TESTDD4HEP_INSPECTHITSCOLLECTIONSTOOL_H */
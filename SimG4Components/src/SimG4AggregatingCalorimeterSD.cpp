@@ -0,0 +1,48 @@
+#include "SimG4AggregatingCalorimeterSD.h"
+
+// FCCSW
+#include "SimG4Common/HitBuffer.h"
+
+// Geant4
+#include "G4Step.hh"
+#include "G4TouchableHistory.hh"
+
+// DD4hep
+#include "DD4hep/Detector.h"
+#include "DDG4/Factories.h"
+
+SimG4AggregatingCalorimeterSD::SimG4AggregatingCalorimeterSD(const std::string& aDetectorName,
+                                                             const std::string& aReadoutName,
+                                                             const dd4hep::Segmentation& aSegmentation)
+    : SimG4HitBufferSD(aDetectorName, aReadoutName, aSegmentation, false) {}
+
+SimG4AggregatingCalorimeterSD::~SimG4AggregatingCalorimeterSD() {}
+
+bool SimG4AggregatingCalorimeterSD::ProcessHits(G4Step* aStep, G4TouchableHistory*) {
+  const double energy = aStep->GetTotalEnergyDeposit();
+  if (energy == 0) return false;
+  const G4ThreeVector& prePos = aStep->GetPreStepPoint()->GetPosition();
+  const G4Track* track = aStep->GetTrack();
+  m_cells.add(m_cellID(*aStep), energy, prePos.x(), prePos.y(), prePos.z(), track->GetGlobalTime(),
+              track->GetTrackID(), track->GetDynamicParticle()->GetPDGcode(), track->GetWeight());
+  return true;
+}
+
+void SimG4AggregatingCalorimeterSD::endOfEvent(sim::HitBuffer& aBuffer) {
+  // one deposit per cell, so the buffer of the next event is allocated for the number of cells of this one
+  m_cells.normalise();
+  for (const auto& cell : m_cells.cells()) {
+    aBuffer.add(cell.cellID, cell.energy, cell.x, cell.y, cell.z, cell.time, cell.trackId, cell.pdg);
+    aBuffer.setWeight(aBuffer.size() - 1, cell.weight);
+  }
+  m_cells.clear();
+}
+
+namespace {
+G4VSensitiveDetector* createAggregatingCalorimeterSD(const std::string& aDetectorName, dd4hep::Detector& aLcdd) {
+  dd4hep::Readout readout = aLcdd.sensitiveDetector(aDetectorName).readout();
+  return new SimG4AggregatingCalorimeterSD(aDetectorName, readout.name(), readout.segmentation());
+}
+}
+
+DECLARE_EXTERNAL_GEANT4SENSITIVEDETECTOR(AggregatingCalorimeterSD, createAggregatingCalorimeterSD)
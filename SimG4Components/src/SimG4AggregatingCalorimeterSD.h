@@ -0,0 +1,51 @@
+#ifndef SIMG4COMPONENTS_G4AGGREGATINGCALORIMETERSD_H
+#define SIMG4COMPONENTS_G4AGGREGATINGCALORIMETERSD_H
+
+// FCCSW
+#include "SimG4Common/CellSums.h"
+
+// local
+#include "SimG4HitBufferSD.h"
+
+/** @class SimG4AggregatingCalorimeterSD SimG4Components/src/SimG4AggregatingCalorimeterSD.h SimG4AggregatingCalorimeterSD.h
+ *
+ *  Calorimeter sensitive detector (plugin AggregatingCalorimeterSD) summing the energy deposits of the steps per cell
+ *  during the tracking (sim::CellSums), so that its memory scales with the number of cells hit and not with the
+ *  number of steps, as needed for the showers of high energy particles.
+ *  The cellID is given by the segmentation of the readout at the middle of the step (SimG4StepCellID). Each cell keeps
+ *  the summed energy, the energy-weighted pre-step position and track weight, and the time, track ID and PDG code of
+ *  its earliest deposit. At the end of the event the cells are written to a hit buffer (sim::HitBuffer) of the
+ *  readout, one deposit per cell, saved by SimG4SaveCalHits. The MC contributions of the hits are hence only those of the earliest tracks.
+ *  The plugin may be used in the compact files, or replace the sensitive detectors of other types through the
+ *  property 'sensitiveTypes' of GeoSvc.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+ */
+
+class SimG4AggregatingCalorimeterSD : public SimG4HitBufferSD {
+public:
+  /** Constructor.
+   *  @param[in] aDetectorName name of the sensitive detector
+   *  @param[in] aReadoutName name of the readout (hits collection)
+   *  @param[in] aSegmentation segmentation of the readout
+   */
+  SimG4AggregatingCalorimeterSD(const std::string& aDetectorName, const std::string& aReadoutName,
+                                const dd4hep::Segmentation& aSegmentation);
+  virtual ~SimG4AggregatingCalorimeterSD();
+  /**  Add the deposit of the step to its cell.
+   *   @param[in] aStep step in the sensitive volume
+   *   @return true if the deposit was added
+   */
+  virtual bool ProcessHits(G4Step* aStep, G4TouchableHistory*) final;
+
+protected:
+  /**  Write the cells to the hit buffer.
+   *   @param[in, out] aBuffer buffer of the event
+   */
+  virtual void endOfEvent(sim::HitBuffer& aBuffer) final;
+
+private:
+  /// Sums of the deposits per cell (reused between events)
+  sim::CellSums m_cells;
+};
+
+#endif /* SIMG4COMPONENTS_G4AGGREGATINGCALORIMETERSD_H */
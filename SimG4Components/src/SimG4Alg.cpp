@@ -1,10 +1,23 @@
 #include "SimG4Alg.h"
 
 // FCCSW
+#include "SimG4Common/EventInformation.h"
+#include "SimG4Common/MemoryUsage.h"
+#include "SimG4Interface/ISimG4ProfilingSvc.h"
 #include "SimG4Interface/ISimG4Svc.h"
 
 // Geant
 #include "G4Event.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4VHitsCollection.hh"
+
+// TBB
+#include "tbb/task_group.h"
+
+// STL
+#include <algorithm>
 
 DECLARE_COMPONENT(SimG4Alg)
 
@@ -28,29 +41,208 @@ StatusCode SimG4Alg::initialize() {
     //   return StatusCode::FAILURE;
     // }
   }
+  for (auto& toolname : m_filterToolNames) {
+    m_filterTools.push_back(tool<ISimG4EventFilterTool>(toolname));
+    if (m_filterTools.back() == nullptr) {
+      error() << "Unable to retrieve the event filter " << toolname << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
   if (!m_eventTool.retrieve()) {
     error() << "Unable to retrieve the G4Event provider " << m_eventTool << endmsg;
     return StatusCode::FAILURE;
   }
+  if (m_eventsPerExecute < 1) {
+    error() << "At least one event needs to be simulated per execute" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_profiling || m_memoryProfiling) {
+    m_profilingSvc = service("SimG4ProfilingSvc");
+    if (!m_profilingSvc) {
+      error() << "Unable to locate the profiling service SimG4ProfilingSvc" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
   return StatusCode::SUCCESS;
 }
 
 StatusCode SimG4Alg::execute() {
-  // first translate the event
-  G4Event* event = m_eventTool->g4Event();
+  auto start = std::chrono::steady_clock::now();
+  const bool sampleMemory = m_memoryProfiling || m_memoryThreshold > 0;
+  // first translate the event(s)
+  std::vector<G4Event*> events;
+  for (unsigned int iEvent = 0; iEvent < m_eventsPerExecute; ++iEvent) {
+    G4Event* event = m_eventTool->g4Event();
+    if (!event) {
+      error() << "Unable to retrieve G4Event from " << m_eventTool << endmsg;
+      for (auto generated : events) delete generated;
+      return StatusCode::FAILURE;
+    }
+    events.push_back(event);
+  }
+  if (m_profilingSvc) start = recordTime("eventProvider", start);
+  if (!m_filterTools.empty()) {
+    // rejected events are dropped before their simulation
+    const size_t numGenerated = events.size();
+    auto rejected = std::remove_if(events.begin(), events.end(), [this](G4Event* aEvent) {
+      for (auto filter : m_filterTools) {
+        if (!filter->accept(*aEvent)) return true;
+      }
+      return false;
+    });
+    for (auto iter = rejected; iter != events.end(); ++iter) delete *iter;
+    events.erase(rejected, events.end());
+    if (m_profilingSvc) {
+      start = recordTime("eventFilter", start);
+      m_profilingSvc->addCount("filter:rejected", numGenerated - events.size());
+    }
+    if (events.empty()) {
+      setFilterPassed(false);
+      if (m_profilingSvc) m_profilingSvc->endOfEvent();
+      return StatusCode::SUCCESS;
+    }
+  }
+  if (m_profilingSvc) m_profilingSvc->addCount("primaries", countPrimaries(events));
 
-  if (!event) {
-    error() << "Unable to retrieve G4Event from " << m_eventTool << endmsg;
+  const double memoryAtStart = sampleMemory ? sim::residentMemory() : 0;
+  double memory = memoryAtStart;
+  const StatusCode processed =
+      events.size() == 1 ? m_geantSvc->processEvent(*events.front()) : m_geantSvc->processEventBatch(events);
+  if (processed.isFailure()) {
+    // the service has deleted the events and given back their worker
+    if (m_profilingSvc) m_profilingSvc->endOfEvent();
     return StatusCode::FAILURE;
   }
-  m_geantSvc->processEvent(*event).ignore();
+  if (m_profilingSvc) start = recordTime("processEvent", start);
+  if (sampleMemory) memory = recordMemory("processEvent", memory);
   G4Event* constevent;
   m_geantSvc->retrieveEvent(constevent).ignore();
-  for (auto& tool : m_saveTools) {
-    tool->saveOutput(*constevent).ignore();
+  if (m_profilingSvc) {
+    recordCounts(*constevent);
+    start = std::chrono::steady_clock::now();
+  }
+  if (m_concurrentOutputs) {
+    saveConcurrently(*constevent);
+    // memory is not attributed to the tools filling their output in parallel
+    if (m_profilingSvc) start = std::chrono::steady_clock::now();
+    if (sampleMemory) memory = recordMemory("saveOutput", memory);
+  } else {
+    for (size_t iTool = 0; iTool < m_saveTools.size(); ++iTool) {
+      m_saveTools[iTool]->saveOutput(*constevent).ignore();
+      if (m_profilingSvc) start = recordTime("saveOutput:" + m_saveToolNames[iTool], start);
+      if (sampleMemory) memory = recordMemory("saveOutput:" + m_saveToolNames[iTool], memory);
+    }
+  }
+  if (m_memoryProfiling) {
+    // pools of the hits are still filled, before the termination of the event
+    m_profilingSvc->addCount("memory:pool:Geant4CaloHit", sim::caloHitPoolSize() / (1024. * 1024.));
+    m_profilingSvc->addCount("memory:pool:Geant4PreDigiTrackHit", sim::trackHitPoolSize() / (1024. * 1024.));
+    m_profilingSvc->addCount("memory:resident", memory);
+    m_profilingSvc->addCount("memory:heap", sim::heapMemory());
+  }
+  if (m_memoryThreshold > 0 && memory - memoryAtStart > m_memoryThreshold) {
+    warning() << "Event " << constevent->GetEventID() << " increased the resident memory by " << memory - memoryAtStart
+              << " MB (to " << memory << " MB, peak " << sim::peakResidentMemory() << " MB)" << endmsg;
+    dumpPrimaries(*constevent);
   }
   m_geantSvc->terminateEvent().ignore();
+  if (m_profilingSvc) {
+    recordTime("terminateEvent", start);
+    m_profilingSvc->endOfEvent();
+  }
   return StatusCode::SUCCESS;
 }
 
+void SimG4Alg::saveConcurrently(const G4Event& aEvent) {
+  // particles of the history may be read by several tools, convert them before the tasks
+  auto evtinfo = dynamic_cast<sim::EventInformation*>(aEvent.GetUserInformation());
+  if (evtinfo != nullptr) evtinfo->particles();
+  // first phase: the tools fill their collections in parallel, without accessing the event store
+  std::vector<StatusCode> filled(m_saveTools.size(), StatusCode::SUCCESS);
+  tbb::task_group tasks;
+  for (size_t iTool = 0; iTool < m_saveTools.size(); ++iTool) {
+    if (!m_saveTools[iTool]->fillsConcurrently()) continue;
+    tasks.run([this, iTool, &aEvent, &filled]() {
+      auto toolStart = std::chrono::steady_clock::now();
+      filled[iTool] = m_saveTools[iTool]->fillOutput(aEvent);
+      if (m_profilingSvc) recordTime("fillOutput:" + m_saveToolNames[iTool], toolStart);
+    });
+  }
+  tasks.wait();
+  // second phase: the collections are put in the store from the thread of the algorithm (DataHandle::put is not
+  // thread-safe), in the order of the tools, the other tools saving their output in turn
+  auto start = std::chrono::steady_clock::now();
+  for (size_t iTool = 0; iTool < m_saveTools.size(); ++iTool) {
+    if (!m_saveTools[iTool]->fillsConcurrently()) {
+      m_saveTools[iTool]->saveOutput(aEvent).ignore();
+    } else if (filled[iTool].isSuccess()) {
+      m_saveTools[iTool]->putOutput().ignore();
+    }
+    if (m_profilingSvc) start = recordTime("saveOutput:" + m_saveToolNames[iTool], start);
+  }
+}
+
+std::chrono::steady_clock::time_point SimG4Alg::recordTime(const std::string& aPhase,
+                                                            std::chrono::steady_clock::time_point aStart) const {
+  auto end = std::chrono::steady_clock::now();
+  m_profilingSvc->addTime(aPhase, std::chrono::duration<double>(end - aStart).count());
+  return end;
+}
+
+double SimG4Alg::recordMemory(const std::string& aPhase, double aBefore) const {
+  double after = sim::residentMemory();
+  if (m_memoryProfiling) {
+    m_profilingSvc->addCount("memory:" + aPhase, after - aBefore);
+  }
+  return after;
+}
+
+void SimG4Alg::dumpPrimaries(const G4Event& aEvent) const {
+  for (int iVertex = 0; iVertex < aEvent.GetNumberOfPrimaryVertex(); ++iVertex) {
+    const G4PrimaryVertex* vertex = aEvent.GetPrimaryVertex(iVertex);
+    warning() << "Primary vertex (" << vertex->GetX0() << ", " << vertex->GetY0() << ", " << vertex->GetZ0()
+              << ") mm, t = " << vertex->GetT0() << " ns" << endmsg;
+    for (const G4PrimaryParticle* particle = vertex->GetPrimary(); particle != nullptr; particle = particle->GetNext()) {
+      warning() << "    PDG " << particle->GetPDGcode() << ", p = (" << particle->GetPx() << ", " << particle->GetPy()
+                << ", " << particle->GetPz() << ") MeV" << endmsg;
+    }
+  }
+}
+
+size_t SimG4Alg::countPrimaries(const std::vector<G4Event*>& aEvents) const {
+  size_t numPrimaries = 0;
+  for (auto event : aEvents) {
+    for (int iVertex = 0; iVertex < event->GetNumberOfPrimaryVertex(); ++iVertex) {
+      numPrimaries += event->GetPrimaryVertex(iVertex)->GetNumberOfParticle();
+    }
+  }
+  return numPrimaries;
+}
+
+void SimG4Alg::recordCounts(const G4Event& aEvent) const {
+  size_t numHits = 0;
+  G4HCofThisEvent* collections = aEvent.GetHCofThisEvent();
+  if (collections != nullptr) {
+    for (int iCollection = 0; iCollection < collections->GetNumberOfCollections(); ++iCollection) {
+      G4VHitsCollection* collection = collections->GetHC(iCollection);
+      if (collection != nullptr) {
+        numHits += collection->GetSize();
+        m_profilingSvc->addCount("hits:" + collection->GetName(), collection->GetSize());
+      }
+    }
+  }
+  m_profilingSvc->addCount("hits", numHits);
+  auto evtinfo = dynamic_cast<const sim::EventInformation*>(aEvent.GetUserInformation());
+  if (evtinfo != nullptr && evtinfo->numSteps() > 0) {
+    m_profilingSvc->addCount("tracks", evtinfo->numTracks());
+    m_profilingSvc->addCount("steps", evtinfo->numSteps());
+  }
+  if (evtinfo != nullptr && evtinfo->regionOfInterest().defined) {
+    const sim::RegionOfInterest& region = evtinfo->regionOfInterest();
+    m_profilingSvc->addCount("roi:cones", region.cones.size());
+    m_profilingSvc->addCount("roi:killedAtCreation", region.killedAtCreation);
+    m_profilingSvc->addCount("roi:killedLeaving", region.killedLeaving);
+  }
+}
+
 StatusCode SimG4Alg::finalize() { return GaudiAlgorithm::finalize(); }
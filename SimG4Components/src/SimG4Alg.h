@@ -6,12 +6,18 @@
 
 // FCCSW
 #include "k4FWCore/DataHandle.h"
+#include "SimG4Interface/ISimG4EventFilterTool.h"
 #include "SimG4Interface/ISimG4EventProviderTool.h"
 #include "SimG4Interface/ISimG4SaveOutputTool.h"
 
+// STL
+#include <chrono>
+#include <vector>
+
 // Forward declarations:
 // Interfaces
 class ISimG4Svc;
+class ISimG4ProfilingSvc;
 
 // Geant
 class G4Event;
@@ -23,6 +29,21 @@ class G4Event;
  *  retrieves it after the finished simulation, and stores the output as specified in tools.
  *  It takes MCParticleCollection (\b'genParticles') as the input
  *  as well as a list of names of tools that define the EDM output (\b'outputs').
+ *  If \b'profiling' is set, the time spent in each phase and the event counters (primaries, hits in total and per
+ *  collection, and tracks and steps if counted by the user actions) are recorded in SimG4ProfilingSvc.
+ *  If \b'memoryProfiling' is set, the growth of the resident memory during the simulation and each saving tool, the
+ *  resident and heap memory, and the size of the G4Allocator pools of the hits are recorded too. Events growing the
+ *  resident memory by more than \b'memoryThreshold' are logged with their primaries.
+ *  If \b'eventsPerExecute' is larger than 1, that many events are taken from the event provider in each call of
+ *  execute(), simulated back-to-back and merged into one event, so that the output tools fill their collections once
+ *  for the whole batch (meant for generator tools, e.g. SimG4SingleParticleGeneratorTool).
+ *  If \b'concurrentOutputs' is set, the output is saved in two phases: the tools that support it (e.g. SimG4SaveCalHits
+ *  and SimG4SaveTrackerHits) fill their collections in parallel TBB tasks, without accessing the event store, then the
+ *  collections are put in the store one tool after another on the thread of the algorithm, the other tools saving
+ *  their output in turn.
+ *  The generated events are passed to the filters (\b'filters', e.g. SimG4PrimariesFilterTool) before the
+ *  simulation: the events rejected by any of them are not simulated. If no event of the call is accepted, the
+ *  simulation and the saving tools are skipped and the filter decision of the algorithm is set to false.
  *  [For more information please see](@ref md_sim_doc_geant4fullsim).
  *
  *  @author Anna Zaborowska
@@ -50,6 +71,36 @@ public:
   virtual StatusCode finalize() final;
 
 private:
+  /** Record the time spent in a phase in the profiling service.
+   *  @param[in] aPhase name of the phase
+   *  @param[in] aStart time at which the phase started
+   *  @return time at which the phase ended
+   */
+  std::chrono::steady_clock::time_point recordTime(const std::string& aPhase,
+                                                   std::chrono::steady_clock::time_point aStart) const;
+  /** Record the counters of the simulated event in the profiling service.
+   *  @param[in] aEvent simulated event
+   */
+  void recordCounts(const G4Event& aEvent) const;
+  /** Count the primary particles of the events.
+   *  @param[in] aEvents generated events
+   *  @return number of primary particles
+   */
+  size_t countPrimaries(const std::vector<G4Event*>& aEvents) const;
+  /** Record the growth of the resident memory during a phase in the profiling service (if memory is profiled).
+   *  @param[in] aPhase name of the phase
+   *  @param[in] aBefore resident memory at the start of the phase [MB]
+   *  @return resident memory at the end of the phase [MB]
+   */
+  double recordMemory(const std::string& aPhase, double aBefore) const;
+  /** Save the output of the event with the tools filling their collections in parallel (concurrentOutputs).
+   *  @param[in] aEvent simulated event
+   */
+  void saveConcurrently(const G4Event& aEvent);
+  /** Log the primary particles of the event, so that it may be reproduced.
+   *  @param[in] aEvent simulated event
+   */
+  void dumpPrimaries(const G4Event& aEvent) const;
   /// Pointer to the interface of Geant simulation service
   ServiceHandle<ISimG4Svc> m_geantSvc;
   /// Handle to the tools saving the output
@@ -58,7 +109,29 @@ private:
   /// Names for the saving tools
   /// to be deleted once the ToolHandleArray<ISimG4SaveOutputTool> m_saveTools is in place
   Gaudi::Property<std::vector<std::string>> m_saveToolNames{this, "outputs", {}, "Names for the saving tools"};
+  /// Filters of the generated events
+  /// to be replaced with the ToolHandleArray<ISimG4EventFilterTool> m_filterTools
+  std::vector<ISimG4EventFilterTool*> m_filterTools;
+  /// Names for the filters of the generated events
+  Gaudi::Property<std::vector<std::string>> m_filterToolNames{
+      this, "filters", {}, "Names for the filters of the generated events (all accepted if empty)"};
   /// Handle for tool that creates the G4Event
   ToolHandle<ISimG4EventProviderTool> m_eventTool{"SimG4PrimariesFromEdmTool", this};
+  /// Flag whether the simulation phases should be timed and events counted
+  Gaudi::Property<bool> m_profiling{this, "profiling", false, "Record timing and counters in SimG4ProfilingSvc"};
+  /// Flag whether the memory used in each phase should be recorded
+  Gaudi::Property<bool> m_memoryProfiling{this, "memoryProfiling", false,
+                                          "Record the memory usage of each phase in SimG4ProfilingSvc"};
+  /// Growth of the resident memory during an event above which the event is logged [MB] (0: none)
+  Gaudi::Property<double> m_memoryThreshold{
+      this, "memoryThreshold", 0, "Log events (with primaries) growing the resident memory by more than this [MB]"};
+  /// Number of events taken from the event provider and simulated in each call of execute()
+  Gaudi::Property<unsigned int> m_eventsPerExecute{this, "eventsPerExecute", 1,
+                                                   "Number of generated events simulated (and saved together) per execute"};
+  /// Flag whether the saving tools should fill their output in parallel tasks
+  Gaudi::Property<bool> m_concurrentOutputs{this, "concurrentOutputs", false,
+                                            "Fill the output of the saving tools in parallel tasks before putting it"};
+  /// Pointer to the profiling service (if profiling is enabled)
+  SmartIF<ISimG4ProfilingSvc> m_profilingSvc;
 };
 #endif /* SIMG4COMPONENTS_G4SIMALG_H */
@@ -0,0 +1,66 @@
+#include "SimG4BufferedSD.h"
+
+// FCCSW
+#include "SimG4Common/HitBuffer.h"
+
+// Geant4
+#include "G4Step.hh"
+#include "G4TouchableHistory.hh"
+
+// DD4hep
+#include "DD4hep/Detector.h"
+#include "DDG4/Factories.h"
+
+SimG4BufferedSD::SimG4BufferedSD(const std::string& aDetectorName, const std::string& aReadoutName,
+                                 const dd4hep::Segmentation& aSegmentation, bool aTracker, bool aPositions)
+    : SimG4HitBufferSD(aDetectorName, aReadoutName, aSegmentation, aTracker, aPositions) {}
+
+SimG4BufferedSD::~SimG4BufferedSD() {}
+
+bool SimG4BufferedSD::ProcessHits(G4Step* aStep, G4TouchableHistory*) {
+  const double energy = aStep->GetTotalEnergyDeposit();
+  if (energy == 0) return false;
+  const G4Track* track = aStep->GetTrack();
+  if (!m_buffer->hasPositions()) {
+    m_buffer->add(m_cellID(*aStep), energy, track->GetGlobalTime(), track->GetTrackID(),
+                  track->GetDynamicParticle()->GetPDGcode());
+    m_buffer->setWeight(m_buffer->size() - 1, track->GetWeight());
+    return true;
+  }
+  const G4ThreeVector& prePos = aStep->GetPreStepPoint()->GetPosition();
+  if (m_buffer->hasPostStep()) {
+    const G4ThreeVector& postPos = aStep->GetPostStepPoint()->GetPosition();
+    m_buffer->add(m_cellID(*aStep), energy, prePos.x(), prePos.y(), prePos.z(), track->GetGlobalTime(),
+                  track->GetTrackID(), track->GetDynamicParticle()->GetPDGcode(), postPos.x(), postPos.y(),
+                  postPos.z());
+  } else {
+    m_buffer->add(m_cellID(*aStep), energy, prePos.x(), prePos.y(), prePos.z(), track->GetGlobalTime(),
+                  track->GetTrackID(), track->GetDynamicParticle()->GetPDGcode());
+  }
+  m_buffer->setWeight(m_buffer->size() - 1, track->GetWeight());
+  return true;
+}
+
+namespace {
+G4VSensitiveDetector* createBufferedSD(const std::string& aDetectorName, dd4hep::Detector& aLcdd, bool aTracker,
+                                       bool aPositions = true) {
+  dd4hep::Readout readout = aLcdd.sensitiveDetector(aDetectorName).readout();
+  return new SimG4BufferedSD(aDetectorName, readout.name(), readout.segmentation(), aTracker, aPositions);
+}
+
+G4VSensitiveDetector* createBufferedCalorimeterSD(const std::string& aDetectorName, dd4hep::Detector& aLcdd) {
+  return createBufferedSD(aDetectorName, aLcdd, false);
+}
+
+G4VSensitiveDetector* createBufferedEnergyCalorimeterSD(const std::string& aDetectorName, dd4hep::Detector& aLcdd) {
+  return createBufferedSD(aDetectorName, aLcdd, false, false);
+}
+
+G4VSensitiveDetector* createBufferedTrackerSD(const std::string& aDetectorName, dd4hep::Detector& aLcdd) {
+  return createBufferedSD(aDetectorName, aLcdd, true);
+}
+}
+
+DECLARE_EXTERNAL_GEANT4SENSITIVEDETECTOR(BufferedCalorimeterSD, createBufferedCalorimeterSD)
+DECLARE_EXTERNAL_GEANT4SENSITIVEDETECTOR(BufferedEnergyCalorimeterSD, createBufferedEnergyCalorimeterSD)
+DECLARE_EXTERNAL_GEANT4SENSITIVEDETECTOR(BufferedTrackerSD, createBufferedTrackerSD)
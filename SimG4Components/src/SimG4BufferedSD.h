@@ -0,0 +1,41 @@
+#ifndef SIMG4COMPONENTS_G4BUFFEREDSD_H
+#define SIMG4COMPONENTS_G4BUFFEREDSD_H
+
+// local
+#include "SimG4HitBufferSD.h"
+
+/** @class SimG4BufferedSD SimG4Components/src/SimG4BufferedSD.h SimG4BufferedSD.h
+ *
+ *  Sensitive detector appending the energy deposits of the steps directly to the arrays of a hit buffer
+ *  (sim::HitBuffer) of its readout, without allocating a hit per step.
+ *  The cellID is given by the segmentation of the readout at the middle of the step (the volume ID if the readout has
+ *  no segmentation), the position and time are those of the pre-step point and of the track.
+ *  The trackers (plugin BufferedTrackerSD) store the post-step position as well, the calorimeters (plugin
+ *  BufferedCalorimeterSD) do not. The calorimeters of plugin BufferedEnergyCalorimeterSD store no position at all,
+ *  for the energy-only output of SimG4SaveCalHits. Steps without energy deposit are not stored.
+ *  The buffers are allocated for the number of deposits of the previous event of the thread.
+ *  These plugins may be used in the compact files, or replace the sensitive detectors of other types through the
+ *  property 'sensitiveTypes' of GeoSvc.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+ */
+
+class SimG4BufferedSD : public SimG4HitBufferSD {
+public:
+  /** Constructor.
+   *  @param[in] aDetectorName name of the sensitive detector
+   *  @param[in] aReadoutName name of the readout (hits collection)
+   *  @param[in] aSegmentation segmentation of the readout
+   *  @param[in] aTracker flag whether the post-step positions are stored
+   *  @param[in] aPositions flag whether the pre-step positions are stored
+   */
+  SimG4BufferedSD(const std::string& aDetectorName, const std::string& aReadoutName,
+                  const dd4hep::Segmentation& aSegmentation, bool aTracker, bool aPositions = true);
+  virtual ~SimG4BufferedSD();
+  /**  Append the deposit of the step to the buffer.
+   *   @param[in] aStep step in the sensitive volume
+   *   @return true if the deposit was stored
+   */
+  virtual bool ProcessHits(G4Step* aStep, G4TouchableHistory*) final;
+};
+
+#endif /* SIMG4COMPONENTS_G4BUFFEREDSD_H */
@@ -0,0 +1,104 @@
+#include "SimG4ClusterCountingSD.h"
+
+// FCCSW
+#include "SimG4Common/HitBuffer.h"
+
+// Geant4
+#include "G4IonisParamMat.hh"
+#include "G4Material.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Poisson.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4TouchableHistory.hh"
+#include "Randomize.hh"
+
+// DD4hep
+#include "DD4hep/DD4hepUnits.h"
+#include "DD4hep/Detector.h"
+#include "DDG4/Factories.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+
+namespace {
+/// Dependence of the primary ionisation on beta gamma, with aLogFactor = ln(2 m_e c^2 / I)
+double ionisation(double aLogFactor, double aBetaGamma) {
+  const double beta2 = aBetaGamma * aBetaGamma / (1 + aBetaGamma * aBetaGamma);
+  return (aLogFactor + 2 * std::log(aBetaGamma) - beta2) / beta2;
+}
+}
+
+SimG4ClusterCountingSD::SimG4ClusterCountingSD(const std::string& aDetectorName, const std::string& aReadoutName,
+                                               const dd4hep::Segmentation& aSegmentation, double aClusterDensity,
+                                               double aPlateau)
+    : SimG4HitBufferSD(aDetectorName, aReadoutName, aSegmentation, true),
+      m_clusterDensity(aClusterDensity),
+      m_plateau(aPlateau) {}
+
+SimG4ClusterCountingSD::~SimG4ClusterCountingSD() {}
+
+double SimG4ClusterCountingSD::relativeDensity(const G4Material* aMaterial, double aBetaGamma) {
+  auto material = m_materials.find(aMaterial);
+  if (material == m_materials.end()) {
+    const double logFactor =
+        std::log(2 * electron_mass_c2 / aMaterial->GetIonisation()->GetMeanExcitationEnergy());
+    // minimum of ionisation, searched between beta gamma of 0.1 and 1000
+    double minimum = ionisation(logFactor, 0.1);
+    for (int iPoint = 1; iPoint <= 400; ++iPoint) {
+      minimum = std::min(minimum, ionisation(logFactor, std::pow(10., -1 + 0.01 * iPoint)));
+    }
+    material = m_materials.emplace(aMaterial, std::make_pair(logFactor, minimum)).first;
+  }
+  return std::min(ionisation(material->second.first, aBetaGamma) / material->second.second, m_plateau);
+}
+
+bool SimG4ClusterCountingSD::ProcessHits(G4Step* aStep, G4TouchableHistory*) {
+  const G4StepPoint* pre = aStep->GetPreStepPoint();
+  const G4StepPoint* post = aStep->GetPostStepPoint();
+  const double charge = pre->GetCharge();
+  const double mass = pre->GetMass();
+  if (charge == 0 || mass == 0 || aStep->GetStepLength() == 0) return false;
+  const double betaGamma = 0.5 * (pre->GetMomentum().mag() + post->GetMomentum().mag()) / mass;
+  if (betaGamma <= 0) return false;
+  const double mean = m_clusterDensity * charge * charge * relativeDensity(pre->GetMaterial(), betaGamma) *
+                      aStep->GetStepLength();
+  const long numClusters = G4Poisson(mean);
+  if (numClusters == 0) return false;
+  const uint64_t cellID = m_cellID(*aStep);
+  const double energy = aStep->GetTotalEnergyDeposit() / numClusters;
+  const G4ThreeVector& prePos = pre->GetPosition();
+  const G4ThreeVector step = post->GetPosition() - prePos;
+  const double preTime = pre->GetGlobalTime();
+  const double stepTime = post->GetGlobalTime() - preTime;
+  const G4Track* track = aStep->GetTrack();
+  const int trackId = track->GetTrackID(), pdg = track->GetDynamicParticle()->GetPDGcode();
+  // the clusters are uniform along the (straight) step, as the primary ionisation is a Poisson process
+  const size_t firstCluster = m_buffer->size();
+  for (long iCluster = 0; iCluster < numClusters; ++iCluster) {
+    const double fraction = G4UniformRand();
+    const G4ThreeVector position = prePos + fraction * step;
+    m_buffer->add(cellID, energy, position.x(), position.y(), position.z(), preTime + fraction * stepTime, trackId,
+                  pdg, position.x(), position.y(), position.z());
+  }
+  m_buffer->setWeight(firstCluster, track->GetWeight());
+  return true;
+}
+
+namespace {
+double constant(dd4hep::Detector& aLcdd, const std::string& aName, double aDefault) {
+  const auto& constants = aLcdd.constants();
+  return constants.find(aName) != constants.end() ? aLcdd.constantAsDouble(aName) : aDefault;
+}
+
+G4VSensitiveDetector* createClusterCountingTrackerSD(const std::string& aDetectorName, dd4hep::Detector& aLcdd) {
+  dd4hep::Readout readout = aLcdd.sensitiveDetector(aDetectorName).readout();
+  // the compact file is in the units of DD4hep
+  const double density = constant(aLcdd, aDetectorName + "_clusterDensity", 12. / dd4hep::cm) * dd4hep::cm / cm;
+  return new SimG4ClusterCountingSD(aDetectorName, readout.name(), readout.segmentation(), density,
+                                    constant(aLcdd, aDetectorName + "_clusterPlateau", 1.6));
+}
+}
+
+DECLARE_EXTERNAL_GEANT4SENSITIVEDETECTOR(ClusterCountingTrackerSD, createClusterCountingTrackerSD)
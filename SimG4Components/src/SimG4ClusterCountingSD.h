@@ -0,0 +1,61 @@
+#ifndef SIMG4COMPONENTS_G4CLUSTERCOUNTINGSD_H
+#define SIMG4COMPONENTS_G4CLUSTERCOUNTINGSD_H
+
+// local
+#include "SimG4HitBufferSD.h"
+
+// STL
+#include <string>
+#include <unordered_map>
+
+class G4Material;
+
+/** @class SimG4ClusterCountingSD SimG4Components/src/SimG4ClusterCountingSD.h SimG4ClusterCountingSD.h
+ *
+ *  Tracker sensitive detector (plugin ClusterCountingTrackerSD) for the drift chamber, sampling the primary
+ *  ionisation clusters along the steps of the charged particles, so that the clusters can be counted without limiting
+ *  the steps. The mean number of clusters of a step is its length times the cluster density of the gas at the minimum
+ *  of ionisation (constant <name of the detector>_clusterDensity of the compact file, 12/cm by default), times the
+ *  charge squared, times the dependence on the velocity: (ln(2 m_e c^2 (beta gamma)^2 / I) - beta^2) / beta^2 (with
+ *  the mean excitation energy I of the material), relative to its minimum and saturated at the Fermi plateau
+ *  (constant <name of the detector>_clusterPlateau, 1.6 by default). The beta gamma is the mean of the pre- and
+ *  post-step ones. The number of clusters is sampled from a Poisson distribution, their positions uniformly along the
+ *  step (and their times between the pre- and post-step times).
+ *  Each cluster is appended to a hit buffer (sim::HitBuffer) of the readout as a deposit with the position of the
+ *  cluster as both pre- and post-step positions and an equal share of the energy deposit of the step, saved by
+ *  SimG4SaveTrackerHits: the number of hits of a track in a cell is its number of clusters.
+ *  The plugin may be used in the compact files, or replace the sensitive detectors of other types through the
+ *  property 'sensitiveTypes' of GeoSvc.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+ */
+
+class SimG4ClusterCountingSD : public SimG4HitBufferSD {
+public:
+  /** Constructor.
+   *  @param[in] aDetectorName name of the sensitive detector
+   *  @param[in] aReadoutName name of the readout (hits collection)
+   *  @param[in] aSegmentation segmentation of the readout
+   *  @param[in] aClusterDensity number of clusters per length at the minimum of ionisation
+   *  @param[in] aPlateau ratio of the cluster density at the Fermi plateau to that at the minimum
+   */
+  SimG4ClusterCountingSD(const std::string& aDetectorName, const std::string& aReadoutName,
+                         const dd4hep::Segmentation& aSegmentation, double aClusterDensity, double aPlateau);
+  virtual ~SimG4ClusterCountingSD();
+  /**  Sample the clusters of the step and append them to the buffer.
+   *   @param[in] aStep step in the sensitive volume
+   *   @return true if clusters were stored
+   */
+  virtual bool ProcessHits(G4Step* aStep, G4TouchableHistory*) final;
+
+private:
+  /// Dependence of the cluster density of the material on beta gamma, relative to the minimum of ionisation
+  double relativeDensity(const G4Material* aMaterial, double aBetaGamma);
+  /// Number of clusters per length at the minimum of ionisation
+  double m_clusterDensity;
+  /// Ratio of the cluster density at the Fermi plateau to that at the minimum
+  double m_plateau;
+  /// ln(2 m_e c^2 / I) and the minimum of the dependence on beta gamma of the materials, computed on their first step
+  std::unordered_map<const G4Material*, std::pair<double, double>> m_materials;
+};
+
+#endif /* SIMG4COMPONENTS_G4CLUSTERCOUNTINGSD_H */
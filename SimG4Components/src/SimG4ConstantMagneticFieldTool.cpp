@@ -3,24 +3,7 @@
 
 // FCCSW
 #include "SimG4Common/ConstantField.h"
-
-// Geant 4
-#include "G4ChordFinder.hh"
-#include "G4FieldManager.hh"
-#include "G4MagneticField.hh"
-#include "G4TransportationManager.hh"
-#include "G4MagIntegratorDriver.hh"
-#include "G4VUserPrimaryGeneratorAction.hh"
-
-#include "G4ClassicalRK4.hh"
-#include "G4HelixExplicitEuler.hh"
-#include "G4ExactHelixStepper.hh"
-#include "G4HelixImplicitEuler.hh"
-#include "G4HelixSimpleRunge.hh"
-#include "G4MagIntegratorStepper.hh"
-#include "G4Mag_UsualEqRhs.hh"
-#include "G4NystromRK4.hh"
-#include "G4PropagatorInField.hh"
+#include "SimG4Common/FieldSetup.h"
 
 // Declaration of the Tool
 DECLARE_COMPONENT(SimG4ConstantMagneticFieldTool)
@@ -40,52 +23,48 @@ StatusCode SimG4ConstantMagneticFieldTool::initialize() {
   if (sc.isFailure()) return sc;
 
   if (m_fieldOn) {
-    G4TransportationManager* transpManager = G4TransportationManager::GetTransportationManager();
-    G4FieldManager* fieldManager = transpManager->GetFieldManager();
-    G4PropagatorInField* propagator = transpManager->GetPropagatorInField();
-
     // The field manager keeps an observing pointer to the field, ownership stays with this tool. (Cleaned up in dtor)
     m_field =
         new sim::ConstantField(m_fieldComponentX, m_fieldComponentY, m_fieldComponentZ, m_fieldRadMax, m_fieldZMax);
-    fieldManager->SetDetectorField(m_field);
-
-    G4ChordFinder* chordFinder = 
-    new G4ChordFinder( m_field,  m_minStep, stepper(m_integratorStepper, m_field));
-    fieldManager->SetChordFinder(chordFinder);
-
-    propagator->SetLargestAcceptableStep(m_maxStep);
-
-    if (m_deltaChord > 0) fieldManager->GetChordFinder()->SetDeltaChord(m_deltaChord);
-    if (m_deltaOneStep > 0) fieldManager->SetDeltaOneStep(m_deltaOneStep);
-    if (m_minEps > 0) fieldManager->SetMinimumEpsilonStep(m_minEps);
-    if (m_maxEps > 0) fieldManager->SetMaximumEpsilonStep(m_maxEps);
+    if (m_integratorStepper != "auto" && !sim::FieldSetup::isKnownStepper(m_integratorStepper)) {
+      error() << "Stepper " << m_integratorStepper.value() << " not available! using NystromRK4!" << endmsg;
+      m_integratorStepper = "NystromRK4";
+    }
+    const sim::FieldAccuracy accuracy{m_deltaChord, m_deltaOneStep, m_minEps, m_maxEps};
+    m_fieldSetup = std::make_unique<sim::FieldSetup>(m_integratorStepper, m_minStep, m_maxStep, accuracy);
+    if (m_integratorStepper == "auto") {
+      // the field is uniform inside of its cylinder: exact helix inside, Runge-Kutta at the boundary
+      m_fieldSetup->setUniformField(m_fieldRadMax, m_fieldZMax);
+      info() << "Exact helix stepper inside of the uniform field (r < " << m_fieldRadMax / m << " m, |z| < "
+             << m_fieldZMax / m << " m), NystromRK4 at its boundary" << endmsg;
+    }
+    m_fieldSetup->setFieldFreeVolumes(m_fieldFreeVolumes);
+    m_fieldSetup->setCounting(m_countPropagation);
+    m_fieldSetup->setLooperThresholds(m_looperWarningEnergy, m_looperImportantEnergy, m_looperNumberOfTrials);
+    m_fieldSetup->addVolumes(m_looseVolumes,
+                             sim::FieldAccuracy{m_looseDeltaChord, m_looseDeltaOneStep, m_looseMinEps, m_looseMaxEps});
+    sc = attachToThread();
   }
   return sc;
 }
 
 StatusCode SimG4ConstantMagneticFieldTool::finalize() {
+  if (m_fieldSetup != nullptr && m_integratorStepper == "auto") {
+    const auto counters = m_fieldSetup->uniformFieldCounters();
+    info() << "Uniform field: " << counters.helixSteps << " helix steps (" << counters.helixFieldCalls
+           << " field evaluations), " << counters.fallbackSteps << " Runge-Kutta steps at the boundary ("
+           << counters.fallbackFieldCalls << " field evaluations), estimated " << counters.savedFieldCalls()
+           << " field evaluations saved" << endmsg;
+  }
   StatusCode sc = GaudiTool::finalize();
   return sc;
 }
 
 const G4MagneticField* SimG4ConstantMagneticFieldTool::field() const { return m_field; }
 
-G4MagIntegratorStepper* SimG4ConstantMagneticFieldTool::stepper(const std::string& name, G4MagneticField* field) const {
-  G4Mag_UsualEqRhs* fEquation = new G4Mag_UsualEqRhs(field);
-  if (name == "HelixImplicitEuler")
-    return new G4HelixImplicitEuler(fEquation);
-  else if (name == "HelixSimpleRunge")
-    return new G4HelixSimpleRunge(fEquation);
-  else if (name == "HelixExplicitEuler")
-    return new G4HelixExplicitEuler(fEquation);
-  else if (name == "NystromRK4")
-    return new G4NystromRK4(fEquation);
-  else if (name == "ClassicalRK4")
-    return new G4ClassicalRK4(fEquation);
-  else if (name == "ExactHelix")
-    return new G4ExactHelixStepper(fEquation);
-  else {
-    error() << "Stepper " << name << " not available! returning NystromRK4!" << endmsg;
-    return new G4NystromRK4(fEquation);
+StatusCode SimG4ConstantMagneticFieldTool::attachToThread() const {
+  if (m_fieldOn && nullptr != m_field) {
+    return m_fieldSetup->attachToThread(m_field);
   }
+  return StatusCode::SUCCESS;
 }
@@ -10,19 +10,29 @@
 // Geant4
 #include "G4SystemOfUnits.hh"
 
-// Forward declarations:
-// Geant 4 classes
-class G4MagIntegratorStepper;
+// STL
+#include <map>
+#include <memory>
 
+// Forward declarations:
 // FCCSW
 namespace sim {
 class ConstantField;
+class FieldSetup;
 }
 
 /** @class SimG4ConstantMagneticFieldTool SimG4Components/src/SimG4ConstantMagneticFieldTool.h
 * SimG4ConstantMagneticFieldTool.h
 *
 *  Implementation of ISimG4MagneticFieldTool that generates a constant field
+*  The volumes \b'FieldFreeVolumes' have no field (straight-line transport), the volumes \b'LooseVolumes' have their own
+*  accuracy parameters (\b'LooseDeltaChord', \b'LooseDeltaOneStep', \b'LooseMinimumEpsilon', \b'LooseMaximumEpsilon').
+*  Volumes are the daughters of the world whose names contain the given names (with all their daughters).
+*  With the stepper \b'IntegratorStepper' "auto", the steps inside of the cylinder of the field follow the exact helix
+*  and only the steps at its boundary are integrated with NystromRK4. The field evaluations saved are reported at the
+*  finalisation. The thresholds of the transportation killing the looping particles may be set per particle
+*  (\b'LooperWarningEnergy', \b'LooperImportantEnergy', \b'LooperNumberOfTrials'), the killed loopers are counted
+*  by SimG4FieldStatisticsActions.
 *
 *  @author Andrea Dell'Acqua
 *  @date   2016-02-22
@@ -46,13 +56,15 @@ public:
   /// @returns pointer to G4MagneticField
   virtual const G4MagneticField* field() const final;
 
-  /// Get the stepper
-  /// @returns pointer to G4MagIntegratorStepper (ownership is transferred to the caller)
-  G4MagIntegratorStepper* stepper(const std::string&, G4MagneticField*) const;
+  /// Configure the field manager of the calling thread with the field of this tool
+  /// @returns status code
+  virtual StatusCode attachToThread() const final;
 
 private:
   /// Pointer to the actual Geant 4 magnetic field
   sim::ConstantField* m_field;
+  /// Configuration of the field managers (global and of the volumes)
+  std::unique_ptr<sim::FieldSetup> m_fieldSetup;
   /// Switch to turn field on or off (default is off). Set with property FieldOn
   Gaudi::Property<bool> m_fieldOn{this, "FieldOn", false, "Switch to turn field off"};
   /// Minimum epsilon (relative error of position / momentum, see G4 doc for more details). Set with property
@@ -70,8 +82,29 @@ private:
   Gaudi::Property<double> m_maxStep{this, "MaximumStep", 1. * m, "Maximum step length in field (see G4 documentation)"};
   /// Lower limit of the step size, see G4 doc for more details. Set with property MaximumStep
   Gaudi::Property<double> m_minStep{this, "MinimumStep", 0.01 * mm, "Maximum step length in field (see G4 documentation)"};
-  /// Name of the integration stepper, defaults to NystromRK4.
+  /// Name of the integration stepper, defaults to NystromRK4 ("auto": exact helix in the uniform field)
   Gaudi::Property<std::string> m_integratorStepper{this, "IntegratorStepper", "NystromRK4", "Integrator stepper name"};
+  /// Names of the volumes without field
+  Gaudi::Property<std::vector<std::string>> m_fieldFreeVolumes{
+      this, "FieldFreeVolumes", {}, "Names of the volumes without field (straight-line transport)"};
+  /// Names of the volumes with their own accuracy
+  Gaudi::Property<std::vector<std::string>> m_looseVolumes{
+      this, "LooseVolumes", {}, "Names of the volumes with their own accuracy (Loose* properties)"};
+  /// Accuracy in the volumes LooseVolumes (0: default of Geant4)
+  Gaudi::Property<double> m_looseDeltaChord{this, "LooseDeltaChord", 0, "Missing distance in LooseVolumes"};
+  Gaudi::Property<double> m_looseDeltaOneStep{this, "LooseDeltaOneStep", 0, "Delta(one-step) in LooseVolumes"};
+  Gaudi::Property<double> m_looseMinEps{this, "LooseMinimumEpsilon", 0, "Minimum epsilon in LooseVolumes"};
+  Gaudi::Property<double> m_looseMaxEps{this, "LooseMaximumEpsilon", 0, "Maximum epsilon in LooseVolumes"};
+  /// Thresholds of the looping particles by particle name ("default": the other particles), default of Geant4 if unset
+  Gaudi::Property<std::map<std::string, double>> m_looperWarningEnergy{
+      this, "LooperWarningEnergy", {}, "Energy below which the looping particles are killed without warning"};
+  Gaudi::Property<std::map<std::string, double>> m_looperImportantEnergy{
+      this, "LooperImportantEnergy", {}, "Energy above which the looping particles survive LooperNumberOfTrials"};
+  Gaudi::Property<std::map<std::string, int>> m_looperNumberOfTrials{
+      this, "LooperNumberOfTrials", {}, "Number of looping steps of an important particle before it is killed"};
+  /// Whether the field evaluations and the integration steps are counted (for SimG4FieldStatisticsActions)
+  Gaudi::Property<bool> m_countPropagation{this, "CountPropagation", false,
+                                           "Count the field evaluations and the integration steps"};
 
   /// Field component in X direction. Set with property FieldComponentX
   Gaudi::Property<double> m_fieldComponentX{this, "FieldComponentX", 0, "Field X component"};
@@ -25,6 +25,11 @@ StatusCode SimG4DD4hepDetector::initialize() {
             << "Make sure you have GeoSvc and SimSvc in the right order in the configuration." << endmsg;
     return StatusCode::FAILURE;
   }
+  // the Geant4 geometry is built by the geometry service only when requested
+  if (m_geoSvc->getGeant4Geo() == nullptr) {
+    error() << "Unable to build the Geant4 geometry" << endmsg;
+    return StatusCode::FAILURE;
+  }
   return StatusCode::SUCCESS;
 }
 
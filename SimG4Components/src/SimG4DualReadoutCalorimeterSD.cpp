@@ -0,0 +1,124 @@
+#include "SimG4DualReadoutCalorimeterSD.h"
+
+// FCCSW
+#include "SimG4Common/HitBuffer.h"
+
+// Geant4
+#include "G4EmSaturation.hh"
+#include "G4LossTableManager.hh"
+#include "G4Material.hh"
+#include "G4MaterialPropertiesTable.hh"
+#include "G4Poisson.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4TouchableHistory.hh"
+
+// DD4hep
+#include "DD4hep/Detector.h"
+#include "DDG4/Factories.h"
+
+// STL
+#include <algorithm>
+
+SimG4DualReadoutCalorimeterSD::SimG4DualReadoutCalorimeterSD(const std::string& aDetectorName,
+                                                             const std::string& aReadoutName,
+                                                             const dd4hep::Segmentation& aSegmentation,
+                                                             double aCherenkovEfficiency,
+                                                             double aScintillationEfficiency)
+    : SimG4HitBufferSD(aDetectorName, aReadoutName, aSegmentation, false),
+      m_cherenkovEfficiency(aCherenkovEfficiency),
+      m_scintillationEfficiency(aScintillationEfficiency) {}
+
+SimG4DualReadoutCalorimeterSD::~SimG4DualReadoutCalorimeterSD() {}
+
+const SimG4DualReadoutCalorimeterSD::Optics& SimG4DualReadoutCalorimeterSD::optics(const G4Material* aMaterial) {
+  auto known = m_optics.find(aMaterial);
+  if (known != m_optics.end()) return known->second;
+  Optics& optics = m_optics[aMaterial];
+  G4MaterialPropertiesTable* properties = aMaterial->GetMaterialPropertiesTable();
+  if (properties == nullptr) return optics;
+  G4MaterialPropertyVector* rindex = properties->GetProperty("RINDEX");
+  if (rindex != nullptr) {
+    for (size_t iPoint = 0; iPoint < rindex->GetVectorLength(); ++iPoint) {
+      optics.energies.push_back(rindex->Energy(iPoint));
+      optics.indices.push_back((*rindex)[iPoint]);
+      optics.maxIndex = std::max(optics.maxIndex, (*rindex)[iPoint]);
+    }
+  }
+  if (properties->ConstPropertyExists("SCINTILLATIONYIELD")) {
+    optics.scintillationYield = properties->GetConstProperty("SCINTILLATIONYIELD");
+  }
+  return optics;
+}
+
+double SimG4DualReadoutCalorimeterSD::cherenkovPerLength(const Optics& aOptics, double aBeta) {
+  // Frank-Tamm: dN/dx = alpha / (hbar c) * z^2 * integral of (1 - 1 / (beta n)^2) over the photon energies
+  const double factor = 369.81 / (eV * cm);
+  if (aOptics.energies.size() < 2 || aBeta * aOptics.maxIndex <= 1) return 0;
+  auto integrand = [aBeta](double aIndex) { return 1 - 1 / (aBeta * aBeta * aIndex * aIndex); };
+  double integral = 0;
+  for (size_t iPoint = 1; iPoint < aOptics.energies.size(); ++iPoint) {
+    const double low = integrand(aOptics.indices[iPoint - 1]), high = integrand(aOptics.indices[iPoint]);
+    const double width = aOptics.energies[iPoint] - aOptics.energies[iPoint - 1];
+    if (low >= 0 && high >= 0) {
+      integral += 0.5 * (low + high) * width;
+    } else if (low > 0 || high > 0) {
+      // only the part above the threshold of the interval, with the integrand linear in it
+      const double positive = std::max(low, high);
+      integral += 0.5 * positive * width * positive / (positive - std::min(low, high));
+    }
+  }
+  return factor * integral;
+}
+
+bool SimG4DualReadoutCalorimeterSD::ProcessHits(G4Step* aStep, G4TouchableHistory*) {
+  const G4StepPoint* pre = aStep->GetPreStepPoint();
+  const Optics& light = optics(pre->GetMaterial());
+  double mean = 0;
+  const double charge = pre->GetCharge();
+  if (charge != 0 && !light.energies.empty()) {
+    const double beta = 0.5 * (pre->GetBeta() + aStep->GetPostStepPoint()->GetBeta());
+    mean += m_cherenkovEfficiency * charge * charge * cherenkovPerLength(light, beta) * aStep->GetStepLength();
+  }
+  if (light.scintillationYield > 0 && aStep->GetTotalEnergyDeposit() > 0) {
+    G4EmSaturation* saturation = G4LossTableManager::Instance()->EmSaturation();
+    const double visible = saturation != nullptr ? saturation->VisibleEnergyDepositionAtAStep(aStep)
+                                                 : aStep->GetTotalEnergyDeposit();
+    mean += m_scintillationEfficiency * light.scintillationYield * visible;
+  }
+  if (mean <= 0) return false;
+  // only the detected photo-electrons are sampled, no optical photon is created
+  const long photoElectrons = G4Poisson(mean);
+  if (photoElectrons == 0) return false;
+  const G4ThreeVector& prePos = pre->GetPosition();
+  const G4Track* track = aStep->GetTrack();
+  m_cells.add(m_cellID(*aStep), photoElectrons, prePos.x(), prePos.y(), prePos.z(), track->GetGlobalTime(),
+              track->GetTrackID(), track->GetDynamicParticle()->GetPDGcode(), track->GetWeight());
+  return true;
+}
+
+void SimG4DualReadoutCalorimeterSD::endOfEvent(sim::HitBuffer& aBuffer) {
+  // one deposit per cell, so the buffer of the next event is allocated for the number of cells of this one
+  m_cells.normalise();
+  for (const auto& cell : m_cells.cells()) {
+    aBuffer.add(cell.cellID, cell.energy, cell.x, cell.y, cell.z, cell.time, cell.trackId, cell.pdg);
+    aBuffer.setWeight(aBuffer.size() - 1, cell.weight);
+  }
+  m_cells.clear();
+}
+
+namespace {
+double efficiency(dd4hep::Detector& aLcdd, const std::string& aName) {
+  const auto& constants = aLcdd.constants();
+  return constants.find(aName) != constants.end() ? aLcdd.constantAsDouble(aName) : 1.;
+}
+
+G4VSensitiveDetector* createDualReadoutCalorimeterSD(const std::string& aDetectorName, dd4hep::Detector& aLcdd) {
+  dd4hep::Readout readout = aLcdd.sensitiveDetector(aDetectorName).readout();
+  return new SimG4DualReadoutCalorimeterSD(aDetectorName, readout.name(), readout.segmentation(),
+                                           efficiency(aLcdd, aDetectorName + "_cherenkovEfficiency"),
+                                           efficiency(aLcdd, aDetectorName + "_scintillationEfficiency"));
+}
+}
+
+DECLARE_EXTERNAL_GEANT4SENSITIVEDETECTOR(DualReadoutCalorimeterSD, createDualReadoutCalorimeterSD)
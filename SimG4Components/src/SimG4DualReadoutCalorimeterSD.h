@@ -0,0 +1,87 @@
+#ifndef SIMG4COMPONENTS_G4DUALREADOUTCALORIMETERSD_H
+#define SIMG4COMPONENTS_G4DUALREADOUTCALORIMETERSD_H
+
+// FCCSW
+#include "SimG4Common/CellSums.h"
+
+// local
+#include "SimG4HitBufferSD.h"
+
+// STL
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class G4Material;
+
+/** @class SimG4DualReadoutCalorimeterSD SimG4Components/src/SimG4DualReadoutCalorimeterSD.h
+ * SimG4DualReadoutCalorimeterSD.h
+ *
+ *  Calorimeter sensitive detector (plugin DualReadoutCalorimeterSD) counting the photo-electrons of the Cherenkov and
+ *  scintillation light of the steps without creating optical photons (the physics list has no optical physics).
+ *  The mean number of photons of a step is computed from the material of the step: the Cherenkov photons of charged
+ *  particles from the refractive index (property RINDEX) and the velocity of the particle (Frank-Tamm formula, mean of
+ *  the pre- and post-step velocities, as G4Cerenkov), the scintillation photons from the yield per energy (constant
+ *  property SCINTILLATIONYIELD) and the visible energy of the step (with the Birks constant of the material if set).
+ *  Each mean is multiplied by the detection efficiency of the light, the fraction trapped in the fibre times the
+ *  quantum efficiency of the photodetector, given by the constants <name of the detector>_cherenkovEfficiency and
+ *  <name of the detector>_scintillationEfficiency of the compact file (1 if not defined). The number of detected
+ *  photo-electrons is then sampled from a Poisson distribution.
+ *  The photo-electrons are summed per cell (sim::CellSums, as AggregatingCalorimeterSD) and written at the end of the
+ *  event to a hit buffer (sim::HitBuffer) of the readout, saved by SimG4SaveCalHits: the energy of the hits is the
+ *  number of photo-electrons. The Cherenkov and scintillation fibres are told apart by their cellIDs.
+ *  The plugin may be used in the compact files, or replace the sensitive detectors of other types through the
+ *  property 'sensitiveTypes' of GeoSvc.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+ */
+
+class SimG4DualReadoutCalorimeterSD : public SimG4HitBufferSD {
+public:
+  /** Constructor.
+   *  @param[in] aDetectorName name of the sensitive detector
+   *  @param[in] aReadoutName name of the readout (hits collection)
+   *  @param[in] aSegmentation segmentation of the readout
+   *  @param[in] aCherenkovEfficiency detection efficiency of the Cherenkov photons
+   *  @param[in] aScintillationEfficiency detection efficiency of the scintillation photons
+   */
+  SimG4DualReadoutCalorimeterSD(const std::string& aDetectorName, const std::string& aReadoutName,
+                                const dd4hep::Segmentation& aSegmentation, double aCherenkovEfficiency,
+                                double aScintillationEfficiency);
+  virtual ~SimG4DualReadoutCalorimeterSD();
+  /**  Add the photo-electrons of the step to its cell.
+   *   @param[in] aStep step in the sensitive volume
+   *   @return true if photo-electrons were added
+   */
+  virtual bool ProcessHits(G4Step* aStep, G4TouchableHistory*) final;
+
+protected:
+  /**  Write the cells to the hit buffer.
+   *   @param[in, out] aBuffer buffer of the event
+   */
+  virtual void endOfEvent(sim::HitBuffer& aBuffer) final;
+
+private:
+  /// Optical properties of a material, from its material properties table
+  struct Optics {
+    /// Photon energies and refractive indices (no Cherenkov light if empty)
+    std::vector<double> energies, indices;
+    /// Maximum refractive index
+    double maxIndex = 0;
+    /// Scintillation yield per energy (no scintillation light if 0)
+    double scintillationYield = 0;
+  };
+  /// Optical properties of the material, read on its first step
+  const Optics& optics(const G4Material* aMaterial);
+  /// Mean number of Cherenkov photons per length of a particle of unit charge
+  static double cherenkovPerLength(const Optics& aOptics, double aBeta);
+  /// Detection efficiency of the Cherenkov photons
+  double m_cherenkovEfficiency;
+  /// Detection efficiency of the scintillation photons
+  double m_scintillationEfficiency;
+  /// Optical properties of the materials
+  std::unordered_map<const G4Material*, Optics> m_optics;
+  /// Sums of the photo-electrons per cell (reused between events)
+  sim::CellSums m_cells;
+};
+
+#endif /* SIMG4COMPONENTS_G4DUALREADOUTCALORIMETERSD_H */
@@ -0,0 +1,201 @@
+#include "SimG4EnergyDepositMonitor.h"
+
+// FCCSW
+#include "SimG4Common/Geant4CaloHit.h"
+#include "SimG4Common/Geant4PreDigiTrackHit.h"
+#include "SimG4Common/HitBuffer.h"
+#include "SimG4Common/Units.h"
+#include "SimG4Interface/IGeoSvc.h"
+
+// Geant
+#include "G4Event.hh"
+#include "G4THitsCollection.hh"
+
+// DD4hep
+#include "DD4hep/Detector.h"
+#include "DDSegmentation/BitFieldCoder.h"
+
+// STL
+#include <sstream>
+
+DECLARE_COMPONENT(SimG4EnergyDepositMonitor)
+
+SimG4EnergyDepositMonitor::SimG4EnergyDepositMonitor(const std::string& aType, const std::string& aName,
+                                                     const IInterface* aParent)
+    : GaudiTool(aType, aName, aParent), m_geoSvc("GeoSvc", aName) {
+  declareInterface<ISimG4SaveOutputTool>(this);
+}
+
+SimG4EnergyDepositMonitor::~SimG4EnergyDepositMonitor() {}
+
+StatusCode SimG4EnergyDepositMonitor::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (!m_geoSvc) {
+    error() << "Unable to locate Geometry Service. "
+            << "Make sure you have GeoSvc and SimSvc in the right order in the configuration." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  auto lcdd = m_geoSvc->lcdd();
+  auto allReadouts = lcdd->readouts();
+  for (auto& readoutName : m_readoutNames) {
+    if (allReadouts.find(readoutName) == allReadouts.end()) {
+      error() << "Readout " << readoutName << " not found! Please check tool configuration." << endmsg;
+      return StatusCode::FAILURE;
+    }
+    m_layers[readoutName] = nullptr;
+    auto layerField = m_layerFields.value().find(readoutName);
+    if (layerField == m_layerFields.value().end()) continue;
+    auto decoder = lcdd->readout(readoutName).idSpec().decoder();
+    try {
+      m_layers[readoutName] = &(*decoder)[decoder->index(layerField->second)];
+    } catch (const std::exception& e) {
+      error() << "Readout " << readoutName << " does not contain the layer field: " << e.what() << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  for (const auto& layerField : m_layerFields.value()) {
+    if (m_layers.count(layerField.first) == 0) {
+      warning() << "Layer field given for readout " << layerField.first << " that is not monitored" << endmsg;
+    }
+  }
+  if (m_publishEvery < 1) {
+    error() << "Number of events between the summaries needs to be positive" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_summaryFile.value().empty()) {
+    m_file.open(m_summaryFile, std::ios::app);
+    if (!m_file) {
+      error() << "Unable to open the file of the summaries " << m_summaryFile.value() << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  // readouts without hits are summed too, so that they are reported
+  for (const auto& readoutName : m_readoutNames) {
+    m_period.readouts[readoutName];
+    m_job.readouts[readoutName];
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4EnergyDepositMonitor::finalize() {
+  if (m_period.numEvents > 0) {
+    publish(m_period, true);
+  }
+  if (m_job.numEvents > 0) {
+    info() << "Summary of the job:" << endmsg;
+    publish(m_job, false);
+  }
+  m_file.close();
+  return GaudiTool::finalize();
+}
+
+void SimG4EnergyDepositMonitor::add(const Period& aSums, Period& aPeriod) {
+  aPeriod.numEvents += aSums.numEvents;
+  for (const auto& readout : aSums.readouts) {
+    ReadoutSums& sums = aPeriod.readouts[readout.first];
+    sums.total.hits += readout.second.total.hits;
+    sums.total.energy += readout.second.total.energy;
+    for (const auto& layer : readout.second.layers) {
+      sums.layers[layer.first].hits += layer.second.hits;
+      sums.layers[layer.first].energy += layer.second.energy;
+    }
+  }
+}
+
+StatusCode SimG4EnergyDepositMonitor::saveOutput(const G4Event& aEvent) {
+  // the event is summed without the lock, only its sums are added to the period
+  Period event;
+  event.numEvents = 1;
+  G4HCofThisEvent* collections = aEvent.GetHCofThisEvent();
+  if (collections != nullptr) {
+    for (int iter_coll : m_collectionIDs.get(*collections, m_readoutNames)) {
+      G4VHitsCollection* collect = collections->GetHC(iter_coll);
+      ReadoutSums& sums = event.readouts[collect->GetName()];
+      const dd4hep::DDSegmentation::BitFieldElement* layerField = m_layers[collect->GetName()];
+      auto addHit = [&sums, layerField](uint64_t aCellID, double aEnergy) {
+        const double energy = aEnergy * sim::g42edm::energy;
+        sums.total.hits += 1;
+        sums.total.energy += energy;
+        if (layerField != nullptr) {
+          Sums& layer = sums.layers[layerField->value(aCellID)];
+          layer.hits += 1;
+          layer.energy += energy;
+        }
+      };
+      if (auto buffer = dynamic_cast<const sim::HitBuffer*>(collect)) {
+        for (size_t iter_hit = 0; iter_hit < buffer->size(); iter_hit++) {
+          addHit(buffer->cellID[iter_hit], buffer->energy[iter_hit]);
+        }
+      } else if (auto hitsT = dynamic_cast<G4THitsCollection<k4::Geant4PreDigiTrackHit>*>(collect)) {
+        for (size_t iter_hit = 0; iter_hit < hitsT->GetSize(); iter_hit++) {
+          addHit((*hitsT)[iter_hit]->cellID, (*hitsT)[iter_hit]->energyDeposit);
+        }
+      } else if (auto hitsC = dynamic_cast<G4THitsCollection<k4::Geant4CaloHit>*>(collect)) {
+        for (size_t iter_hit = 0; iter_hit < hitsC->GetSize(); iter_hit++) {
+          addHit((*hitsC)[iter_hit]->cellID, (*hitsC)[iter_hit]->energyDeposit);
+        }
+      }
+    }
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  add(event, m_period);
+  add(event, m_job);
+  if (m_period.numEvents >= m_publishEvery) {
+    publish(m_period, true);
+    m_period = Period();
+    for (const auto& readoutName : m_readoutNames) {
+      m_period.readouts[readoutName];
+    }
+  }
+  return StatusCode::SUCCESS;
+}
+
+void SimG4EnergyDepositMonitor::publish(const Period& aPeriod, bool aWarn) {
+  const double numEvents = aPeriod.numEvents;
+  std::stringstream json;
+  json << "{\"period\": " << (aWarn ? long(m_numPeriods) : -1) << ", \"events\": " << aPeriod.numEvents
+       << ", \"readouts\": {";
+  bool firstReadout = true;
+  for (const auto& readout : aPeriod.readouts) {
+    const ReadoutSums& sums = readout.second;
+    info() << "Readout " << readout.first << " (" << aPeriod.numEvents << " events): hits per event "
+           << sums.total.hits / numEvents << ", energy per event " << sums.total.energy / numEvents << " GeV" << endmsg;
+    json << (firstReadout ? "" : ", ") << "\"" << readout.first << "\": {\"hits\": " << sums.total.hits / numEvents
+         << ", \"energy\": " << sums.total.energy / numEvents << ", \"layers\": {";
+    firstReadout = false;
+    if (aWarn && sums.total.hits == 0) {
+      warning() << "No hits in readout " << readout.first << " in " << aPeriod.numEvents << " events" << endmsg;
+    }
+    std::stringstream layers;
+    std::vector<long> missingLayers;
+    long previous = 0;
+    for (auto layer = sums.layers.begin(); layer != sums.layers.end(); ++layer) {
+      // the layers are sorted, the gaps between them have no hits
+      for (long missing = previous + 1; layer != sums.layers.begin() && missing < layer->first; ++missing) {
+        missingLayers.push_back(missing);
+      }
+      previous = layer->first;
+      layers << " " << layer->first << ": " << layer->second.energy / numEvents;
+      json << (layer == sums.layers.begin() ? "" : ", ") << "\"" << layer->first
+           << "\": {\"hits\": " << layer->second.hits / numEvents
+           << ", \"energy\": " << layer->second.energy / numEvents << "}";
+    }
+    json << "}}";
+    if (!sums.layers.empty()) {
+      info() << "\tenergy per event [GeV] by layer:" << layers.str() << endmsg;
+    }
+    if (aWarn && !missingLayers.empty()) {
+      std::stringstream missing;
+      for (long layer : missingLayers) missing << " " << layer;
+      warning() << "Layers of readout " << readout.first << " without hits in " << aPeriod.numEvents
+                << " events:" << missing.str() << endmsg;
+    }
+  }
+  json << "}}";
+  if (m_file.is_open()) {
+    m_file << json.str() << std::endl;
+  }
+  if (aWarn) ++m_numPeriods;
+}
@@ -0,0 +1,103 @@
+#ifndef SIMG4COMPONENTS_SIMG4ENERGYDEPOSITMONITOR_H
+#define SIMG4COMPONENTS_SIMG4ENERGYDEPOSITMONITOR_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "SimG4Common/HitsCollectionIDs.h"
+#include "SimG4Interface/ISimG4SaveOutputTool.h"
+class IGeoSvc;
+
+// STL
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// DD4hep
+namespace dd4hep {
+namespace DDSegmentation {
+class BitFieldElement;
+}
+}
+
+/** @class SimG4EnergyDepositMonitor SimG4Components/src/SimG4EnergyDepositMonitor.h SimG4EnergyDepositMonitor.h
+ *
+ *  Monitoring of the energy deposits for the data quality of the production, read from the hits collections of the
+ *  Geant4 event without creating any EDM collection.
+ *  For the readouts \b'readoutNames' the number of hits and their energy are summed per event, and per layer for
+ *  the readouts given in \b'layerFields' (name of the field of the cellID holding the layer, by readout).
+ *  The summaries (mean per event of the readouts and of their layers) are published every \b'publishEvery' events:
+ *  printed, and appended as one JSON object per line to \b'summaryFile' (if set). A warning is printed for a readout
+ *  without any hit in the period, and for the layers without hits between the first and the last layer hit, which
+ *  usually comes from a broken geometry or configuration.
+ */
+
+class SimG4EnergyDepositMonitor : public GaudiTool, virtual public ISimG4SaveOutputTool {
+public:
+  explicit SimG4EnergyDepositMonitor(const std::string& aType, const std::string& aName, const IInterface* aParent);
+  virtual ~SimG4EnergyDepositMonitor();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize: publish the remaining events and the summary of the job.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /**  Accumulate the deposits of the event.
+   *   @param[in] aEvent Event with the hits collections.
+   *   @return status code
+   */
+  virtual StatusCode saveOutput(const G4Event& aEvent) final;
+
+private:
+  /// Number of hits and their energy
+  struct Sums {
+    double hits = 0;
+    double energy = 0;
+  };
+  /// Sums of a readout, in total and per layer
+  struct ReadoutSums {
+    Sums total;
+    std::map<long, Sums> layers;
+  };
+  /// Sums of a period of events
+  struct Period {
+    unsigned long numEvents = 0;
+    std::map<std::string, ReadoutSums> readouts;
+  };
+  /// Add the sums of an event (or of a period) to a period
+  static void add(const Period& aSums, Period& aPeriod);
+  /// Print the summary of the period (and write it to the file)
+  void publish(const Period& aPeriod, bool aWarn);
+  /// Pointer to the geometry service
+  ServiceHandle<IGeoSvc> m_geoSvc;
+  /// Name of the readouts (hits collections)
+  Gaudi::Property<std::vector<std::string>> m_readoutNames{
+      this, "readoutNames", {}, "Names of the readouts (hits collections) monitored"};
+  /// Field of the layer, by readout
+  Gaudi::Property<std::map<std::string, std::string>> m_layerFields{
+      this, "layerFields", {}, "Name of the field of the layer by readout name (no layers if not given)"};
+  /// Number of events of a period
+  Gaudi::Property<unsigned int> m_publishEvery{this, "publishEvery", 100, "Number of events between the summaries"};
+  /// File of the summaries (JSON lines)
+  Gaudi::Property<std::string> m_summaryFile{this, "summaryFile", "",
+                                             "File to which the summaries are appended (one JSON object per line)"};
+  /// Indices of the monitored collections in the events
+  sim::HitsCollectionIDs m_collectionIDs;
+  /// Field of the layer, by readout (nullptr if no layers)
+  std::map<std::string, const dd4hep::DDSegmentation::BitFieldElement*> m_layers;
+  /// Sums of the current period and of the job
+  Period m_period;
+  Period m_job;
+  /// Number of periods published
+  unsigned long m_numPeriods = 0;
+  /// File of the summaries
+  std::ofstream m_file;
+  /// Sums filled from several threads
+  std::mutex m_mutex;
+};
+
+#endif /* SIMG4COMPONENTS_SIMG4ENERGYDEPOSITMONITOR_H */
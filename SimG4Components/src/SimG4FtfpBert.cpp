@@ -2,6 +2,8 @@
 
 // Geant4
 #include "FTFP_BERT.hh"
+#include "G4EmParameters.hh"
+#include "G4PhysicsConstructorRegistry.hh"
 #include "G4VModularPhysicsList.hh"
 
 DECLARE_COMPONENT(SimG4FtfpBert)
@@ -13,11 +15,48 @@ SimG4FtfpBert::SimG4FtfpBert(const std::string& aType, const std::string& aName,
 
 SimG4FtfpBert::~SimG4FtfpBert() {}
 
-StatusCode SimG4FtfpBert::initialize() { return AlgTool::initialize(); }
+StatusCode SimG4FtfpBert::initialize() {
+  if (AlgTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  // check the names now, so that a wrong configuration does not fail in the middle of the initialisation of Geant
+  G4PhysicsConstructorRegistry* registry = G4PhysicsConstructorRegistry::Instance();
+  std::vector<std::string> constructors(m_replacePhysics.value());
+  if (!m_emPhysics.value().empty()) constructors.push_back(m_emPhysics);
+  for (const auto& constructor : constructors) {
+    if (!registry->IsKnownPhysicsConstructor(constructor)) {
+      error() << "Physics constructor " << constructor << " is not known to Geant4" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  if (m_gammaGeneralProcess < -1 || m_gammaGeneralProcess > 1) {
+    error() << "gammaGeneralProcess needs to be 1 (on), 0 (off) or -1 (default)" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
 
 StatusCode SimG4FtfpBert::finalize() { return AlgTool::finalize(); }
 
 G4VModularPhysicsList* SimG4FtfpBert::physicsList() {
   // ownership passed to SimG4Svc which will register it in G4RunManager. To be deleted in ~G4RunManager()
-  return new FTFP_BERT;
+  G4VModularPhysicsList* physicsList = new FTFP_BERT;
+  G4PhysicsConstructorRegistry* registry = G4PhysicsConstructorRegistry::Instance();
+  std::vector<std::string> constructors(m_replacePhysics.value());
+  if (!m_emPhysics.value().empty()) constructors.insert(constructors.begin(), m_emPhysics);
+  for (const auto& constructor : constructors) {
+    // the constructor of the same type (e.g. electromagnetic) is deleted by the physics list
+    physicsList->ReplacePhysics(registry->GetPhysicsConstructor(constructor));
+    info() << "Physics constructor " << constructor << " used in FTFP_BERT" << endmsg;
+  }
+  for (const auto& constructor : m_removePhysics) {
+    physicsList->RemovePhysics(constructor);
+    info() << "Physics constructor " << constructor << " removed from FTFP_BERT" << endmsg;
+  }
+  // electromagnetic constructors set the default in their constructor, so it is overridden afterwards
+  if (m_gammaGeneralProcess >= 0) {
+    G4EmParameters::Instance()->SetGeneralProcessActive(m_gammaGeneralProcess == 1);
+    info() << "Gamma general process " << (m_gammaGeneralProcess == 1 ? "on" : "off") << endmsg;
+  }
+  return physicsList;
 }
@@ -9,6 +9,11 @@
 /** @class SimG4FtfpBert SimG4Components/src/SimG4FtfpBert.h SimG4FtfpBert.h
  *
  *  FTFP_BERT physics list tool.
+ *  The electromagnetic constructor may be swapped (\b'emPhysics', e.g. "G4EmStandardPhysics_option1" for a faster
+ *  or "G4EmStandardPhysics_option4" for a more precise simulation), the gamma general process may be switched on or
+ *  off (\b'gammaGeneralProcess') and other constructors may be replaced by the constructor of the same type
+ *  (\b'replacePhysics') or removed (\b'removePhysics'). Constructors are given by the names of the Geant4 physics
+ *  constructor registry.
  *
  *  @author Anna Zaborowska
  */
@@ -29,6 +34,20 @@ public:
    *  @return pointer to G4VModularPhysicsList (ownership is transferred to the caller)
    */
   virtual G4VModularPhysicsList* physicsList();
+
+private:
+  /// Name of the electromagnetic constructor replacing the default one (empty to keep it)
+  Gaudi::Property<std::string> m_emPhysics{this, "emPhysics", "",
+                                           "Name of the electromagnetic constructor (empty to keep the default)"};
+  /// Gamma general process: 1 on, 0 off, -1 default of the electromagnetic constructor
+  Gaudi::Property<int> m_gammaGeneralProcess{this, "gammaGeneralProcess", -1,
+                                             "Gamma general process: 1 on, 0 off, -1 default of the EM constructor"};
+  /// Names of the constructors replacing the constructors of the same type
+  Gaudi::Property<std::vector<std::string>> m_replacePhysics{
+      this, "replacePhysics", {}, "Names of the constructors replacing the constructors of the same type"};
+  /// Names of the constructors to be removed
+  Gaudi::Property<std::vector<std::string>> m_removePhysics{this, "removePhysics", {},
+                                                            "Names of the constructors to be removed"};
 };
 
 #endif /* SIMG4COMPONENTS_G4FTFPBERT_H */
@@ -14,6 +14,8 @@
  *
  *  Detector construction tool using the GDML file.
  *  GDML file name needs to be specified in job options file (\b'gdml').
+ *  If a directory is given in \b'geometryCache', the geometry is cached there in a binary file and read from it
+ *  by the next jobs using the same GDML file.
  *
  *  @author Anna Zaborowska
  */
@@ -40,6 +42,9 @@ private:
   Gaudi::Property<std::string> m_gdmlFile{this, "gdml", "", "name of the GDML file"};
   // validate gdml schema
   Gaudi::Property<bool> m_validate{this, "validateGDMLSchema", false, "try to validate the GDML schema"};
+  /// directory of the binary geometry cache
+  Gaudi::Property<std::string> m_cacheDir{this, "geometryCache", "",
+                                          "directory of the binary geometry cache (no cache if empty)"};
 };
 
 #endif /* SIMG4COMPONENTS_G4GDMLDETECTOR_H */
@@ -16,6 +16,9 @@
 #include "G4ParticleDefinition.hh"
 #include "G4ParticleTable.hh"
 
+// STL
+#include <cmath>
+
 // Declaration of the Tool
 DECLARE_COMPONENT(SimG4GeantinosFromEdmTool)
 
@@ -24,11 +27,24 @@ SimG4GeantinosFromEdmTool::SimG4GeantinosFromEdmTool(const std::string& type,
                                                      const IInterface* parent)
     : GaudiTool(type, name, parent) {
   declareProperty("GenParticles", m_genParticles, "Handle for the EDM MC particles to be read");
+  declareProperty("GeantinoRays", m_rays, "Handle for the rays (MC particle index, eta, phi)");
 }
 
 SimG4GeantinosFromEdmTool::~SimG4GeantinosFromEdmTool() {}
 
-StatusCode SimG4GeantinosFromEdmTool::initialize() { return GaudiTool::initialize(); }
+StatusCode SimG4GeantinosFromEdmTool::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_numEtaRays < 1 || m_numPhiRays < 1) {
+    error() << "Number of rays per MC particle needs to be positive" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_numEtaRays * m_numPhiRays > 1) {
+    info() << "Each MC particle is replaced by " << m_numEtaRays * m_numPhiRays << " rays" << endmsg;
+  }
+  return StatusCode::SUCCESS;
+}
 
 G4Event* SimG4GeantinosFromEdmTool::g4Event() {
   G4ParticleTable* particleTable = G4ParticleTable::GetParticleTable();
@@ -39,31 +55,56 @@ G4Event* SimG4GeantinosFromEdmTool::g4Event() {
   G4ParticleDefinition* particleDefNeutral = particleTable->FindParticle("geantino");
 
   const edm4hep::MCParticleCollection* mcparticles = m_genParticles.get();
+  podio::UserDataCollection<float>* rays = m_saveRays ? m_rays.createAndPut() : nullptr;
+  int particleIndex = 0;
   for (const auto& mcparticle : *mcparticles) {
     auto v =  mcparticle.getVertex();
     G4PrimaryVertex* g4Vertex = new G4PrimaryVertex(v.x * sim::edm2g4::length,
                                                     v.y * sim::edm2g4::length,
                                                     v.z * sim::edm2g4::length,
                                                     mcparticle.getTime() / Gaudi::Units::c_light * sim::edm2g4::length);
-    G4PrimaryParticle* part = nullptr;
-    if (mcparticle.getCharge() > 0) {
-      part = new G4PrimaryParticle(particleDefPos);
-    } else if (mcparticle.getCharge() < 0) {
-      part = new G4PrimaryParticle(particleDefNeg);
-    } else {
-      part = new G4PrimaryParticle(particleDefNeutral);
-    }
-
-    part->SetMass(mcparticle.getMass());
-    part->SetCharge(mcparticle.getCharge());
     auto mom = mcparticle.getMomentum();
-    double pX = mom.x * sim::edm2g4::energy;
-    double pY = mom.y * sim::edm2g4::energy;
-    double pZ = mom.z * sim::edm2g4::energy;
-    part->SetUserInformation(new sim::ParticleInformation(mcparticle));
-    part->SetMomentum(pX, pY, pZ);
-    g4Vertex->SetPrimary(part);
+    const G4ThreeVector momentum(mom.x * sim::edm2g4::energy, mom.y * sim::edm2g4::energy,
+                                 mom.z * sim::edm2g4::energy);
+    // particles along the beam have no eta, they are shot as a single ray
+    const bool grid = momentum.perp2() > 0;
+    const unsigned int numEta = grid ? m_numEtaRays.value() : 1;
+    const unsigned int numPhi = grid ? m_numPhiRays.value() : 1;
+    const double eta0 = grid ? momentum.pseudoRapidity() : 0;
+    const double phi0 = grid ? momentum.phi() : 0;
+    for (unsigned int iEta = 0; iEta < numEta; ++iEta) {
+      const double eta = eta0 + (iEta - 0.5 * (numEta - 1)) * m_deltaEta;
+      for (unsigned int iPhi = 0; iPhi < numPhi; ++iPhi) {
+        const double phi = phi0 + (iPhi - 0.5 * (numPhi - 1)) * m_deltaPhi;
+        G4PrimaryParticle* part = nullptr;
+        if (mcparticle.getCharge() > 0) {
+          part = new G4PrimaryParticle(particleDefPos);
+        } else if (mcparticle.getCharge() < 0) {
+          part = new G4PrimaryParticle(particleDefNeg);
+        } else {
+          part = new G4PrimaryParticle(particleDefNeutral);
+        }
+
+        part->SetMass(mcparticle.getMass());
+        part->SetCharge(mcparticle.getCharge());
+        part->SetUserInformation(new sim::ParticleInformation(mcparticle));
+        if (numEta * numPhi == 1) {
+          part->SetMomentum(momentum.x(), momentum.y(), momentum.z());
+        } else {
+          const double pT = momentum.mag() / std::cosh(eta);
+          part->SetMomentum(pT * std::cos(phi), pT * std::sin(phi), pT * std::sinh(eta));
+        }
+        // the rays of the particle share its vertex, in the order of their index
+        g4Vertex->SetPrimary(part);
+        if (rays != nullptr) {
+          rays->push_back(particleIndex);
+          rays->push_back(grid ? eta : 0);
+          rays->push_back(grid ? phi : 0);
+        }
+      }
+    }
     theEvent->AddPrimaryVertex(g4Vertex);
+    ++particleIndex;
   }
   return theEvent;
 }
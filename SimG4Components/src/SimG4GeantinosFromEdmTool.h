@@ -9,12 +9,24 @@
 
 #include "G4VUserPrimaryGeneratorAction.hh"
 
+// datamodel
+#include "podio/UserDataCollection.h"
+
 // Forward declarations
 // datamodel
 namespace edm4hep {
 class MCParticleCollection;
 }
 
+/** @class SimG4GeantinosFromEdmTool SimG4Components/src/SimG4GeantinosFromEdmTool.h SimG4GeantinosFromEdmTool.h
+ *
+ *  Event provider creating geantinos (or charged geantinos) along the EDM MC particles.
+ *  For scans, each particle may be replaced by a grid of \b'numEtaRays' x \b'numPhiRays' rays centred on its
+ *  direction, spaced by \b'deltaEta' and \b'deltaPhi', with the same vertex and momentum magnitude, so that many
+ *  independent rays share one event. The rays are the primaries of the event in order, the ray index is the Geant
+ *  track ID minus one (saved in the hits with the track ID). With \b'saveRays' the index of the MC particle, the
+ *  eta and the phi of each ray are written to \b'GeantinoRays'.
+ */
 class SimG4GeantinosFromEdmTool : public GaudiTool, virtual public ISimG4EventProviderTool {
 public:
   /// Standard constructor
@@ -31,6 +43,19 @@ public:
 private:
   /// Handle for the EDM MC particles to be read
   DataHandle<edm4hep::MCParticleCollection> m_genParticles{"GenParticles", Gaudi::DataHandle::Reader, this};
+  /// Handle for the rays: index of the MC particle, eta and phi of each ray
+  DataHandle<podio::UserDataCollection<float>> m_rays{"GeantinoRays", Gaudi::DataHandle::Writer, this};
+  /// Number of rays in eta per MC particle
+  Gaudi::Property<unsigned int> m_numEtaRays{this, "numEtaRays", 1, "Number of rays in eta per MC particle"};
+  /// Number of rays in phi per MC particle
+  Gaudi::Property<unsigned int> m_numPhiRays{this, "numPhiRays", 1, "Number of rays in phi per MC particle"};
+  /// Distance in eta between the rays
+  Gaudi::Property<double> m_deltaEta{this, "deltaEta", 0, "Distance in eta between the rays of a MC particle"};
+  /// Distance in phi between the rays
+  Gaudi::Property<double> m_deltaPhi{this, "deltaPhi", 0, "Distance in phi between the rays of a MC particle [rad]"};
+  /// Flag whether the rays are saved
+  Gaudi::Property<bool> m_saveRays{this, "saveRays", false,
+                                   "Save the MC particle index, eta and phi of each ray (GeantinoRays)"};
 };
 
 #endif
@@ -0,0 +1,33 @@
+#include "SimG4HitBufferSD.h"
+
+// FCCSW
+#include "SimG4Common/HitBuffer.h"
+
+// Geant4
+#include "G4HCofThisEvent.hh"
+#include "G4SDManager.hh"
+
+SimG4HitBufferSD::SimG4HitBufferSD(const std::string& aDetectorName, const std::string& aReadoutName,
+                                   const dd4hep::Segmentation& aSegmentation, bool aPostStep, bool aPositions)
+    : G4VSensitiveDetector(aDetectorName), m_cellID(aSegmentation), m_postStep(aPostStep), m_positions(aPositions) {
+  // name of the collection is the name of the readout
+  collectionName.insert(aReadoutName);
+}
+
+SimG4HitBufferSD::~SimG4HitBufferSD() {}
+
+void SimG4HitBufferSD::Initialize(G4HCofThisEvent* aHitsCollections) {
+  m_buffer = new sim::HitBuffer(SensitiveDetectorName, collectionName[0], m_postStep, m_capacity, m_positions);
+  if (m_collectionID < 0) {
+    m_collectionID = G4SDManager::GetSDMpointer()->GetCollectionID(m_buffer);
+  }
+  aHitsCollections->AddHitsCollection(m_collectionID, m_buffer);
+}
+
+void SimG4HitBufferSD::EndOfEvent(G4HCofThisEvent*) {
+  if (m_buffer == nullptr) return;
+  endOfEvent(*m_buffer);
+  m_capacity = m_buffer->size();
+  // the buffer is deleted with the event
+  m_buffer = nullptr;
+}
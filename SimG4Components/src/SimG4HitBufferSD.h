@@ -0,0 +1,69 @@
+#ifndef SIMG4COMPONENTS_G4HITBUFFERSD_H
+#define SIMG4COMPONENTS_G4HITBUFFERSD_H
+
+// Geant4
+#include "G4VSensitiveDetector.hh"
+
+// local
+#include "SimG4StepCellID.h"
+
+// STL
+#include <string>
+
+namespace sim {
+class HitBuffer;
+}
+
+/** @class SimG4HitBufferSD SimG4Components/src/SimG4HitBufferSD.h SimG4HitBufferSD.h
+ *
+ *  Base of the sensitive detectors writing the deposits of their readout to a hit buffer (sim::HitBuffer):
+ *  SimG4BufferedSD, SimG4AggregatingCalorimeterSD, SimG4DualReadoutCalorimeterSD and SimG4ClusterCountingSD.
+ *  The collection is named after the readout. For each event the buffer is created (allocated for the number of
+ *  deposits of the previous event of the thread) and registered in the hits collections of the event, which own it.
+ *  The derived detectors append the deposits during the tracking (ProcessHits), or at the end of the event
+ *  (endOfEvent), with the weight of their track at the time of the deposit (changed by the biasing, e.g.
+ *  SimG4ImportanceBiasingRegion).
+ */
+
+class SimG4HitBufferSD : public G4VSensitiveDetector {
+public:
+  /** Constructor.
+   *  @param[in] aDetectorName name of the sensitive detector
+   *  @param[in] aReadoutName name of the readout (hits collection)
+   *  @param[in] aSegmentation segmentation of the readout
+   *  @param[in] aPostStep flag whether the post-step positions are stored
+   *  @param[in] aPositions flag whether the pre-step positions are stored
+   */
+  SimG4HitBufferSD(const std::string& aDetectorName, const std::string& aReadoutName,
+                   const dd4hep::Segmentation& aSegmentation, bool aPostStep, bool aPositions = true);
+  virtual ~SimG4HitBufferSD();
+  /**  Create the hit buffer and register it in the hits collections of the event.
+   *   @param[in] aHitsCollections hits collections of the event
+   */
+  virtual void Initialize(G4HCofThisEvent* aHitsCollections) final;
+  /**  Complete the buffer (endOfEvent) and keep its size, to allocate the buffer of the next event.
+   */
+  virtual void EndOfEvent(G4HCofThisEvent*) final;
+
+protected:
+  /**  Append the deposits kept until the end of the event (e.g. the sums of the cells).
+   *   @param[in, out] aBuffer buffer of the event
+   */
+  virtual void endOfEvent(sim::HitBuffer& /*aBuffer*/) {}
+  /// Cell ID of the steps
+  SimG4StepCellID m_cellID;
+  /// Buffer of the current event (owned by the hits collections of the event)
+  sim::HitBuffer* m_buffer = nullptr;
+
+private:
+  /// Flag whether the post-step positions are stored
+  bool m_postStep;
+  /// Flag whether the pre-step positions are stored
+  bool m_positions;
+  /// Index of the collection in the hits collections of the event (-1: not resolved)
+  int m_collectionID = -1;
+  /// Number of deposits of the previous event
+  size_t m_capacity = 0;
+};
+
+#endif /* SIMG4COMPONENTS_G4HITBUFFERSD_H */
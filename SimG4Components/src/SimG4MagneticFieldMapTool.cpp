@@ -0,0 +1,85 @@
+// local
+#include "SimG4MagneticFieldMapTool.h"
+
+// FCCSW
+#include "SimG4Common/FieldMap.h"
+#include "SimG4Common/FieldSetup.h"
+#include "SimG4Common/NumaTopology.h"
+
+// Declaration of the Tool
+DECLARE_COMPONENT(SimG4MagneticFieldMapTool)
+
+SimG4MagneticFieldMapTool::SimG4MagneticFieldMapTool(const std::string& type, const std::string& name,
+                                                     const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareInterface<ISimG4MagneticFieldTool>(this);
+}
+
+SimG4MagneticFieldMapTool::~SimG4MagneticFieldMapTool() {}
+
+StatusCode SimG4MagneticFieldMapTool::initialize() {
+  StatusCode sc = GaudiTool::initialize();
+  if (sc.isFailure()) return sc;
+  if (m_fileName.value().empty()) {
+    error() << "No file of the field map is given" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_field = std::make_unique<sim::FieldMap>(m_fileName, m_scale);
+  if (!m_field->isValid()) {
+    error() << "Unable to read the field map: " << m_field->error() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  const sim::FieldMap::Header& header = m_field->header();
+  info() << "Field map " << m_fileName.value() << " on a "
+         << (header.coordinates == sim::FieldMap::kCartesian ? "Cartesian" : "cylindrical") << " grid of "
+         << header.n[0] << " x " << header.n[1] << " x " << header.n[2] << " points, scaled by " << m_scale.value()
+         << endmsg;
+  if (!sim::FieldSetup::isKnownStepper(m_integratorStepper)) {
+    error() << "Stepper " << m_integratorStepper.value() << " not available! using NystromRK4!" << endmsg;
+    m_integratorStepper = "NystromRK4";
+  }
+  const sim::FieldAccuracy accuracy{m_deltaChord, m_deltaOneStep, m_minEps, m_maxEps};
+  m_fieldSetup = std::make_unique<sim::FieldSetup>(m_integratorStepper, m_minStep, m_maxStep, accuracy);
+  m_fieldSetup->setFieldFreeVolumes(m_fieldFreeVolumes);
+    m_fieldSetup->setCounting(m_countPropagation);
+  m_fieldSetup->setLooperThresholds(m_looperWarningEnergy, m_looperImportantEnergy, m_looperNumberOfTrials);
+  m_fieldSetup->setCache(m_cacheDistance, m_cacheSize);
+  m_fieldSetup->addVolumes(m_looseVolumes,
+                           sim::FieldAccuracy{m_looseDeltaChord, m_looseDeltaOneStep, m_looseMinEps, m_looseMaxEps});
+  return attachToThread();
+}
+
+StatusCode SimG4MagneticFieldMapTool::finalize() {
+  if (m_fieldSetup != nullptr && m_cacheDistance > 0) {
+    const auto cacheCounters = m_fieldSetup->cacheCounters();
+    const unsigned long queries = cacheCounters.first + cacheCounters.second;
+    info() << "Field cache: " << cacheCounters.first << " of " << queries << " values reused ("
+           << (queries > 0 ? 100. * cacheCounters.first / queries : 0.) << " %), " << cacheCounters.second
+           << " interpolations of the map" << endmsg;
+  }
+  return GaudiTool::finalize();
+}
+
+const G4MagneticField* SimG4MagneticFieldMapTool::field() const { return m_field.get(); }
+
+StatusCode SimG4MagneticFieldMapTool::attachToThread() const {
+  if (!m_field) {
+    return StatusCode::FAILURE;
+  }
+  if (!m_replicatePerNumaDomain) {
+    return m_fieldSetup->attachToThread(m_field.get());
+  }
+  // the copy is written by the first thread of the domain, hence placed on it
+  const int domain = sim::currentNumaDomain();
+  std::lock_guard<std::mutex> lock(m_replicasMutex);
+  auto& replica = m_replicas[domain];
+  if (!replica) {
+    replica = m_field->replicate();
+    if (!replica->isValid()) {
+      error() << "Unable to copy the field map for the NUMA domain " << domain << ": " << replica->error() << endmsg;
+      return StatusCode::FAILURE;
+    }
+    info() << "Copy of the field map for the NUMA domain " << domain << endmsg;
+  }
+  return m_fieldSetup->attachToThread(replica.get());
+}
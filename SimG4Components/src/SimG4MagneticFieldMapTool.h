@@ -0,0 +1,117 @@
+#ifndef SIMG4COMPONENTS_G4MAGNETICFIELDMAPTOOL_H
+#define SIMG4COMPONENTS_G4MAGNETICFIELDMAPTOOL_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4MagneticFieldTool.h"
+
+// Geant4
+#include "G4SystemOfUnits.hh"
+
+// STL
+#include <map>
+#include <memory>
+#include <mutex>
+
+// Forward declarations:
+// FCCSW
+namespace sim {
+class FieldMap;
+class FieldSetup;
+}
+
+/** @class SimG4MagneticFieldMapTool SimG4Components/src/SimG4MagneticFieldMapTool.h SimG4MagneticFieldMapTool.h
+ *
+ *  Implementation of ISimG4MagneticFieldTool that interpolates the field from a map on a Cartesian or a cylindrical
+ *  grid (sim::FieldMap), read from the binary file \b'fileName' mapped in memory (shared by the threads and the
+ *  processes). The field may be scaled with \b'scale'. If \b'cacheDistance' is set, each thread keeps the
+ *  \b'cacheSize' recent values of the field, reused for the points closer than that distance (sim::CachedField).
+ *  With \b'replicatePerNumaDomain', the threads use a copy of the map on their NUMA domain, made by the first thread
+ *  of the domain, instead of the pages of the file on one domain (for workers pinned with workerAffinity of SimG4Svc).
+ *  The other properties configure the integration in the field, the field-free volumes, or volumes with their own
+ *  accuracy, and the thresholds of the looping particles, as in SimG4ConstantMagneticFieldTool.
+ */
+
+class SimG4MagneticFieldMapTool : public GaudiTool, virtual public ISimG4MagneticFieldTool {
+public:
+  /// Standard constructor
+  SimG4MagneticFieldMapTool(const std::string& type, const std::string& name, const IInterface* parent);
+
+  /// Destructor
+  virtual ~SimG4MagneticFieldMapTool();
+
+  /// Initialize method
+  virtual StatusCode initialize() final;
+
+  /// Finalize method
+  virtual StatusCode finalize() final;
+
+  /// Get the magnetic field
+  /// @returns pointer to G4MagneticField
+  virtual const G4MagneticField* field() const final;
+
+  /// Configure the field manager of the calling thread with the field of this tool
+  /// @returns status code
+  virtual StatusCode attachToThread() const final;
+
+private:
+  /// Field map (shared by the threads)
+  std::unique_ptr<sim::FieldMap> m_field;
+  /// Configuration of the field managers (global and of the volumes)
+  std::unique_ptr<sim::FieldSetup> m_fieldSetup;
+  /// Copies of the field map per NUMA domain (if replicated)
+  mutable std::map<int, std::unique_ptr<sim::FieldMap>> m_replicas;
+  /// Mutex guarding the copies of the field map
+  mutable std::mutex m_replicasMutex;
+  /// Name of the file of the field map
+  Gaudi::Property<std::string> m_fileName{this, "fileName", "", "Name of the binary file of the field map"};
+  /// Scale of the field
+  Gaudi::Property<double> m_scale{this, "scale", 1, "Scale factor of the field (e.g. -1 for the opposite polarity)"};
+  /// Distance within which a recent value of the field is reused
+  Gaudi::Property<double> m_cacheDistance{this, "cacheDistance", 0,
+                                          "Distance within which a recent value of the field is reused (0: no cache)"};
+  /// Number of recent values of the field kept by each thread
+  Gaudi::Property<unsigned int> m_cacheSize{this, "cacheSize", 4, "Number of recent values of the field kept"};
+  /// Flag whether the threads use a copy of the map on their NUMA domain
+  Gaudi::Property<bool> m_replicatePerNumaDomain{
+      this, "replicatePerNumaDomain", false, "Set to true for the threads to use a copy of the map per NUMA domain"};
+  /// Minimum epsilon (relative error of position / momentum, see G4 doc for more details)
+  Gaudi::Property<double> m_minEps{this, "MinimumEpsilon", 0, "Minimum epsilon (see G4 documentation)"};
+  /// Maximum epsilon (relative error of position / momentum, see G4 doc for more details)
+  Gaudi::Property<double> m_maxEps{this, "MaximumEpsilon", 0, "Maximum epsilon (see G4 documentation)"};
+  /// This parameter governs accuracy of volume intersection, see G4 doc for more details
+  Gaudi::Property<double> m_deltaChord{this, "DeltaChord", 0, "Missing distance for the chord finder"};
+  /// This parameter is roughly the position error which is acceptable in an integration step, see G4 doc for details
+  Gaudi::Property<double> m_deltaOneStep{this, "DeltaOneStep", 0, "Delta(one-step)"};
+  /// Upper limit of the step size, see G4 doc for more details
+  Gaudi::Property<double> m_maxStep{this, "MaximumStep", 1. * m, "Maximum step length in field (see G4 documentation)"};
+  /// Lower limit of the step size, see G4 doc for more details
+  Gaudi::Property<double> m_minStep{this, "MinimumStep", 0.01 * mm, "Minimum step length in field (see G4 documentation)"};
+  /// Name of the integration stepper, defaults to NystromRK4.
+  Gaudi::Property<std::string> m_integratorStepper{this, "IntegratorStepper", "NystromRK4", "Integrator stepper name"};
+  /// Names of the volumes without field
+  Gaudi::Property<std::vector<std::string>> m_fieldFreeVolumes{
+      this, "FieldFreeVolumes", {}, "Names of the volumes without field (straight-line transport)"};
+  /// Names of the volumes with their own accuracy
+  Gaudi::Property<std::vector<std::string>> m_looseVolumes{
+      this, "LooseVolumes", {}, "Names of the volumes with their own accuracy (Loose* properties)"};
+  /// Accuracy in the volumes LooseVolumes (0: default of Geant4)
+  Gaudi::Property<double> m_looseDeltaChord{this, "LooseDeltaChord", 0, "Missing distance in LooseVolumes"};
+  Gaudi::Property<double> m_looseDeltaOneStep{this, "LooseDeltaOneStep", 0, "Delta(one-step) in LooseVolumes"};
+  Gaudi::Property<double> m_looseMinEps{this, "LooseMinimumEpsilon", 0, "Minimum epsilon in LooseVolumes"};
+  Gaudi::Property<double> m_looseMaxEps{this, "LooseMaximumEpsilon", 0, "Maximum epsilon in LooseVolumes"};
+  /// Thresholds of the looping particles by particle name ("default": the other particles), default of Geant4 if unset
+  Gaudi::Property<std::map<std::string, double>> m_looperWarningEnergy{
+      this, "LooperWarningEnergy", {}, "Energy below which the looping particles are killed without warning"};
+  Gaudi::Property<std::map<std::string, double>> m_looperImportantEnergy{
+      this, "LooperImportantEnergy", {}, "Energy above which the looping particles survive LooperNumberOfTrials"};
+  Gaudi::Property<std::map<std::string, int>> m_looperNumberOfTrials{
+      this, "LooperNumberOfTrials", {}, "Number of looping steps of an important particle before it is killed"};
+  /// Whether the field evaluations and the integration steps are counted (for SimG4FieldStatisticsActions)
+  Gaudi::Property<bool> m_countPropagation{this, "CountPropagation", false,
+                                           "Count the field evaluations and the integration steps"};
+};
+
+#endif
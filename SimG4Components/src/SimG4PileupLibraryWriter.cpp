@@ -0,0 +1,84 @@
+#include "SimG4PileupLibraryWriter.h"
+
+// datamodel
+#include "edm4hep/SimCalorimeterHitCollection.h"
+#include "edm4hep/SimTrackerHitCollection.h"
+
+DECLARE_COMPONENT(SimG4PileupLibraryWriter)
+
+SimG4PileupLibraryWriter::SimG4PileupLibraryWriter(const std::string& aName, ISvcLocator* aSvcLoc)
+    : GaudiAlgorithm(aName, aSvcLoc) {
+  declareProperty("caloHits", m_caloHits, "Handle for the calorimeter hits");
+  declareProperty("trackerHits", m_trackerHits, "Handle for the tracker hits");
+}
+
+StatusCode SimG4PileupLibraryWriter::initialize() {
+  if (GaudiAlgorithm::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (!m_saveCaloHits && !m_saveTrackerHits) {
+    error() << "Neither the calorimeter nor the tracker hits are saved to the library" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_writer = std::make_unique<sim::HitLibraryWriter>(m_filename);
+  if (!m_writer->isOpen()) {
+    error() << "Cannot open the hit library " << m_filename.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4PileupLibraryWriter::execute() {
+  m_libraryCaloHits.clear();
+  m_libraryTrackerHits.clear();
+  if (m_saveCaloHits) {
+    m_cells.clear();
+    for (const auto& hit : *m_caloHits.get()) {
+      auto cell = m_cells.emplace(hit.getCellID(), m_libraryCaloHits.size());
+      if (cell.second) {
+        m_libraryCaloHits.push_back({hit.getCellID(), 0, {0, 0, 0}});
+      }
+      // energy-weighted position, normalised below
+      sim::HitLibrary::CaloHit& libraryHit = m_libraryCaloHits[cell.first->second];
+      const float energy = hit.getEnergy();
+      libraryHit.energy += energy;
+      libraryHit.position[0] += energy * hit.getPosition().x;
+      libraryHit.position[1] += energy * hit.getPosition().y;
+      libraryHit.position[2] += energy * hit.getPosition().z;
+    }
+    for (auto& libraryHit : m_libraryCaloHits) {
+      if (libraryHit.energy <= 0) continue;
+      for (auto& coordinate : libraryHit.position) {
+        coordinate /= libraryHit.energy;
+      }
+    }
+  }
+  if (m_saveTrackerHits) {
+    for (const auto& hit : *m_trackerHits.get()) {
+      const auto& position = hit.getPosition();
+      const auto& momentum = hit.getMomentum();
+      m_libraryTrackerHits.push_back({hit.getCellID(),
+                                      {position.x, position.y, position.z},
+                                      {momentum.x, momentum.y, momentum.z},
+                                      hit.getEDep(),
+                                      hit.getTime(),
+                                      hit.getPathLength()});
+    }
+  }
+  debug() << "Interaction " << m_writer->size() << " with " << m_libraryCaloHits.size() << " calorimeter cells and "
+          << m_libraryTrackerHits.size() << " tracker hits added to the library" << endmsg;
+  m_writer->add(m_libraryCaloHits, m_libraryTrackerHits);
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4PileupLibraryWriter::finalize() {
+  if (m_writer != nullptr) {
+    const size_t numInteractions = m_writer->size();
+    if (!m_writer->close()) {
+      error() << "Failed to write the hit library " << m_filename.value() << endmsg;
+      return StatusCode::FAILURE;
+    }
+    info() << numInteractions << " interactions written to the hit library " << m_filename.value() << endmsg;
+  }
+  return GaudiAlgorithm::finalize();
+}
@@ -0,0 +1,68 @@
+#ifndef SIMG4COMPONENTS_G4PILEUPLIBRARYWRITER_H
+#define SIMG4COMPONENTS_G4PILEUPLIBRARYWRITER_H
+
+// Gaudi
+#include "GaudiAlg/GaudiAlgorithm.h"
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+#include "SimG4Common/HitLibrary.h"
+
+// STL
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// datamodel
+namespace edm4hep {
+class SimCalorimeterHitCollection;
+class SimTrackerHitCollection;
+}
+
+/** @class SimG4PileupLibraryWriter SimG4Components/src/SimG4PileupLibraryWriter.h SimG4PileupLibraryWriter.h
+ *
+ *  Writes the hits of pre-simulated interactions (e.g. minimum-bias events saved by SimG4SaveCalHits and
+ *  SimG4SaveTrackerHits) to a library of hits (sim::HitLibrary, \b'filename'), one interaction per event, to be
+ *  overlaid on the signal events by SimG4PileupOverlay.
+ *  The calorimeter hits (\b'caloHits', if \b'saveCaloHits') are summed per cell, with the energy-weighted position;
+ *  the tracker hits (\b'trackerHits', if \b'saveTrackerHits') are kept as they are, without their MC particle.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+ */
+
+class SimG4PileupLibraryWriter : public GaudiAlgorithm {
+public:
+  SimG4PileupLibraryWriter(const std::string& aName, ISvcLocator* aSvcLoc);
+  /**  Initialize. Opens the library.
+   *   @return status code
+   */
+  StatusCode initialize();
+  /**  Finalize. Writes the index of the library.
+   *   @return status code
+   */
+  StatusCode finalize();
+  /**  Add the hits of the event to the library as one interaction.
+   *   @return status code
+   */
+  StatusCode execute();
+
+private:
+  /// Handle for the calorimeter hits
+  DataHandle<edm4hep::SimCalorimeterHitCollection> m_caloHits{"CaloHits", Gaudi::DataHandle::Reader, this};
+  /// Handle for the tracker hits
+  DataHandle<edm4hep::SimTrackerHitCollection> m_trackerHits{"TrackerHits", Gaudi::DataHandle::Reader, this};
+  /// Name of the file of the library
+  Gaudi::Property<std::string> m_filename{this, "filename", "pileupLibrary.bin", "Name of the file of the library"};
+  /// Flag whether the calorimeter hits are saved
+  Gaudi::Property<bool> m_saveCaloHits{this, "saveCaloHits", true, "Save the calorimeter hits"};
+  /// Flag whether the tracker hits are saved
+  Gaudi::Property<bool> m_saveTrackerHits{this, "saveTrackerHits", true, "Save the tracker hits"};
+  /// Writer of the library
+  std::unique_ptr<sim::HitLibraryWriter> m_writer;
+  /// Index of the cells in the calorimeter hits of the event (reused between events)
+  std::unordered_map<uint64_t, size_t> m_cells;
+  /// Hits of the event (reused between events)
+  std::vector<sim::HitLibrary::CaloHit> m_libraryCaloHits;
+  std::vector<sim::HitLibrary::TrackerHit> m_libraryTrackerHits;
+};
+
+#endif /* SIMG4COMPONENTS_G4PILEUPLIBRARYWRITER_H */
@@ -0,0 +1,119 @@
+#include "SimG4PileupOverlay.h"
+
+// datamodel
+#include "edm4hep/SimCalorimeterHitCollection.h"
+#include "edm4hep/SimTrackerHitCollection.h"
+
+// STL
+#include <algorithm>
+
+DECLARE_COMPONENT(SimG4PileupOverlay)
+
+SimG4PileupOverlay::SimG4PileupOverlay(const std::string& aName, ISvcLocator* aSvcLoc)
+    : GaudiAlgorithm(aName, aSvcLoc) {
+  declareProperty("caloHits", m_caloHits, "Handle for the calorimeter hits of the signal");
+  declareProperty("trackerHits", m_trackerHits, "Handle for the tracker hits of the signal");
+  declareProperty("caloHitsWithPileup", m_caloHitsWithPileup, "Handle for the calorimeter hits with the pileup");
+  declareProperty("trackerHitsWithPileup", m_trackerHitsWithPileup, "Handle for the tracker hits with the pileup");
+}
+
+StatusCode SimG4PileupOverlay::initialize() {
+  if (GaudiAlgorithm::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_mu <= 0 || m_lastBunch < m_firstBunch) {
+    error() << "Mean number of interactions needs to be positive and the range of bunch crossings not empty" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_library = std::make_unique<sim::HitLibrary>(m_filename);
+  if (!m_library->isValid()) {
+    error() << "Cannot read the hit library: " << m_library->error() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_library->size() == 0) {
+    error() << "Hit library " << m_filename.value() << " contains no interactions" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_poisson.initialize(randSvc(), Rndm::Poisson(m_mu)).isFailure() ||
+      m_flat.initialize(randSvc(), Rndm::Flat(0, 1)).isFailure()) {
+    error() << "Couldn't initialize the random number generators" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  info() << "Overlaying interactions from the hit library " << m_filename.value() << " of " << m_library->size()
+         << " interactions" << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4PileupOverlay::execute() {
+  edm4hep::SimCalorimeterHitCollection* caloHits = nullptr;
+  if (m_overlayCaloHits) {
+    caloHits = m_caloHitsWithPileup.createAndPut();
+    m_cells.clear();
+    for (const auto& hit : *m_caloHits.get()) {
+      m_cells.emplace(hit.getCellID(), caloHits->size());
+      caloHits->push_back(hit.clone());
+    }
+  }
+  edm4hep::SimTrackerHitCollection* trackerHits = nullptr;
+  if (m_overlayTrackerHits) {
+    trackerHits = m_trackerHitsWithPileup.createAndPut();
+    for (const auto& hit : *m_trackerHits.get()) {
+      trackerHits->push_back(hit.clone());
+    }
+  }
+  const size_t librarySize = m_library->size();
+  unsigned long numInteractions = 0;
+  for (int bunch = m_firstBunch; bunch <= m_lastBunch; ++bunch) {
+    const float timeShift = bunch * m_bunchSpacing;
+    const unsigned long numBunchInteractions = static_cast<unsigned long>(m_poisson());
+    for (unsigned long iInteraction = 0; iInteraction < numBunchInteractions; ++iInteraction) {
+      const size_t index = std::min(static_cast<size_t>(m_flat() * librarySize), librarySize - 1);
+      sim::HitLibrary::Interaction interaction;
+      if (!m_library->interaction(index, interaction)) {
+        error() << "Interaction " << index << " of the hit library " << m_filename.value() << " is corrupted" << endmsg;
+        return StatusCode::FAILURE;
+      }
+      ++numInteractions;
+      if (caloHits != nullptr) {
+        for (uint32_t iHit = 0; iHit < interaction.numCaloHits; ++iHit) {
+          const sim::HitLibrary::CaloHit& libraryHit = interaction.caloHits[iHit];
+          auto cell = m_cells.find(libraryHit.cellID);
+          if (cell != m_cells.end()) {
+            edm4hep::SimCalorimeterHit hit = (*caloHits)[cell->second];
+            hit.setEnergy(hit.getEnergy() + libraryHit.energy);
+            continue;
+          }
+          m_cells.emplace(libraryHit.cellID, caloHits->size());
+          edm4hep::SimCalorimeterHit hit = caloHits->create();
+          hit.setCellID(libraryHit.cellID);
+          hit.setEnergy(libraryHit.energy);
+          hit.setPosition({libraryHit.position[0], libraryHit.position[1], libraryHit.position[2]});
+        }
+      }
+      if (trackerHits != nullptr) {
+        for (uint32_t iHit = 0; iHit < interaction.numTrackerHits; ++iHit) {
+          const sim::HitLibrary::TrackerHit& libraryHit = interaction.trackerHits[iHit];
+          edm4hep::SimTrackerHit hit = trackerHits->create();
+          hit.setCellID(libraryHit.cellID);
+          hit.setEDep(libraryHit.eDep);
+          hit.setTime(libraryHit.time + timeShift);
+          hit.setPosition({libraryHit.position[0], libraryHit.position[1], libraryHit.position[2]});
+          hit.setMomentum({libraryHit.momentum[0], libraryHit.momentum[1], libraryHit.momentum[2]});
+          hit.setPathLength(libraryHit.pathLength);
+        }
+      }
+    }
+  }
+  debug() << numInteractions << " interactions overlaid" << endmsg;
+  ++m_numEvents;
+  m_numInteractions += numInteractions;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4PileupOverlay::finalize() {
+  if (m_numEvents > 0) {
+    info() << m_numInteractions << " interactions overlaid on " << m_numEvents << " events ("
+           << double(m_numInteractions) / m_numEvents << " per event)" << endmsg;
+  }
+  return GaudiAlgorithm::finalize();
+}
@@ -0,0 +1,89 @@
+#ifndef SIMG4COMPONENTS_G4PILEUPOVERLAY_H
+#define SIMG4COMPONENTS_G4PILEUPOVERLAY_H
+
+// Gaudi
+#include "GaudiAlg/GaudiAlgorithm.h"
+#include "GaudiKernel/RndmGenerators.h"
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+#include "SimG4Common/HitLibrary.h"
+
+// STL
+#include <memory>
+#include <unordered_map>
+
+// datamodel
+namespace edm4hep {
+class SimCalorimeterHitCollection;
+class SimTrackerHitCollection;
+}
+
+/** @class SimG4PileupOverlay SimG4Components/src/SimG4PileupOverlay.h SimG4PileupOverlay.h
+ *
+ *  Overlays the hits of pre-simulated interactions, taken at random from a library of hits (sim::HitLibrary written by
+ *  SimG4PileupLibraryWriter, \b'filename'), on the hits of the signal event.
+ *  In each bunch crossing from \b'firstBunch' to \b'lastBunch' (0 being that of the signal) a Poisson number of
+ *  interactions with mean \b'mu' is overlaid; the times of the tracker hits of the interactions are shifted by the
+ *  number of the bunch crossing times \b'bunchSpacing'.
+ *  The calorimeter hits of the signal (\b'caloHits') are copied to \b'caloHitsWithPileup', with the energy of the
+ *  interactions added to the same cells (whatever their bunch crossing), the cells hit only by the interactions added.
+ *  The tracker hits of the signal (\b'trackerHits') and of the interactions are copied to \b'trackerHitsWithPileup'
+ *  (the hits of the interactions without their MC particle).
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+ */
+
+class SimG4PileupOverlay : public GaudiAlgorithm {
+public:
+  SimG4PileupOverlay(const std::string& aName, ISvcLocator* aSvcLoc);
+  /**  Initialize. Maps the library.
+   *   @return status code
+   */
+  StatusCode initialize();
+  /**  Finalize.
+   *   @return status code
+   */
+  StatusCode finalize();
+  /**  Overlay the interactions on the hits of the event.
+   *   @return status code
+   */
+  StatusCode execute();
+
+private:
+  /// Handle for the calorimeter hits of the signal
+  DataHandle<edm4hep::SimCalorimeterHitCollection> m_caloHits{"CaloHits", Gaudi::DataHandle::Reader, this};
+  /// Handle for the tracker hits of the signal
+  DataHandle<edm4hep::SimTrackerHitCollection> m_trackerHits{"TrackerHits", Gaudi::DataHandle::Reader, this};
+  /// Handle for the calorimeter hits with the pileup
+  DataHandle<edm4hep::SimCalorimeterHitCollection> m_caloHitsWithPileup{"CaloHitsWithPileup",
+                                                                        Gaudi::DataHandle::Writer, this};
+  /// Handle for the tracker hits with the pileup
+  DataHandle<edm4hep::SimTrackerHitCollection> m_trackerHitsWithPileup{"TrackerHitsWithPileup",
+                                                                       Gaudi::DataHandle::Writer, this};
+  /// Name of the file of the library
+  Gaudi::Property<std::string> m_filename{this, "filename", "pileupLibrary.bin", "Name of the file of the library"};
+  /// Mean number of interactions per bunch crossing
+  Gaudi::Property<double> m_mu{this, "mu", 1, "Mean number of interactions per bunch crossing"};
+  /// Range of the bunch crossings overlaid (relative to that of the signal)
+  Gaudi::Property<int> m_firstBunch{this, "firstBunch", 0, "First bunch crossing overlaid (0: that of the signal)"};
+  Gaudi::Property<int> m_lastBunch{this, "lastBunch", 0, "Last bunch crossing overlaid (0: that of the signal)"};
+  /// Time between the bunch crossings
+  Gaudi::Property<double> m_bunchSpacing{this, "bunchSpacing", 25, "Time between the bunch crossings [ns]"};
+  /// Flag whether the calorimeter hits are overlaid
+  Gaudi::Property<bool> m_overlayCaloHits{this, "overlayCaloHits", true, "Overlay the calorimeter hits"};
+  /// Flag whether the tracker hits are overlaid
+  Gaudi::Property<bool> m_overlayTrackerHits{this, "overlayTrackerHits", true, "Overlay the tracker hits"};
+  /// Library of the hits
+  std::unique_ptr<sim::HitLibrary> m_library;
+  /// Poisson distribution of the number of interactions per bunch crossing
+  Rndm::Numbers m_poisson;
+  /// Uniform distribution of the interactions in the library
+  Rndm::Numbers m_flat;
+  /// Index of the cells in the calorimeter hits with the pileup (reused between events)
+  std::unordered_map<uint64_t, size_t> m_cells;
+  /// Number of the events and of the interactions overlaid
+  unsigned long m_numEvents = 0;
+  unsigned long m_numInteractions = 0;
+};
+
+#endif /* SIMG4COMPONENTS_G4PILEUPOVERLAY_H */
@@ -0,0 +1,190 @@
+// local
+#include "SimG4PrefetchingEventProviderTool.h"
+
+// Gaudi
+#include "GaudiKernel/ThreadLocalContext.h"
+
+// CLHEP
+#include "CLHEP/Random/MixMaxRng.h"
+
+// Geant4
+#include "G4Event.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "Randomize.hh"
+
+// STL
+#include <cstdint>
+
+// Declaration of the Tool
+DECLARE_COMPONENT(SimG4PrefetchingEventProviderTool)
+
+SimG4PrefetchingEventProviderTool::SimG4PrefetchingEventProviderTool(const std::string& type,
+                                                                     const std::string& name,
+                                                                     const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareInterface<ISimG4EventProviderTool>(this);
+  declareProperty("provider", m_provider, "Handle for the tool that creates the G4Event");
+}
+
+SimG4PrefetchingEventProviderTool::~SimG4PrefetchingEventProviderTool() { stop(); }
+
+StatusCode SimG4PrefetchingEventProviderTool::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+#ifndef G4MULTITHREADED
+  error() << "Geant4 was built without multi-threading support, the random engine cannot be set for the background "
+          << "thread" << endmsg;
+  return StatusCode::FAILURE;
+#endif
+  if (!m_provider.retrieve()) {
+    error() << "Unable to retrieve the G4Event provider " << m_provider << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_queueSize == 0 || m_eventsPerExecute == 0) {
+    error() << "Size of the queue and number of events per execute need to be positive" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_engine = std::make_unique<CLHEP::MixMaxRng>();
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4PrefetchingEventProviderTool::finalize() {
+  stop();
+  m_queue.clear();
+  return GaudiTool::finalize();
+}
+
+void SimG4PrefetchingEventProviderTool::stop() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_condition.notify_all();
+  if (m_thread.joinable()) m_thread.join();
+}
+
+G4Event* SimG4PrefetchingEventProviderTool::g4Event() {
+  if (!m_thread.joinable()) {
+    m_thread = std::thread(&SimG4PrefetchingEventProviderTool::prefetch, this, Gaudi::Hive::currentContext());
+  }
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_condition.wait(lock, [this] { return !m_queue.empty() || m_finished; });
+  if (m_queue.empty()) return nullptr;
+  std::unique_ptr<Event> event = std::move(m_queue.front());
+  m_queue.pop_front();
+  lock.unlock();
+  m_condition.notify_all();
+  return event != nullptr ? build(*event) : nullptr;
+}
+
+std::unique_ptr<SimG4PrefetchingEventProviderTool::Event> SimG4PrefetchingEventProviderTool::copy(G4Event& aEvent) {
+  auto event = std::make_unique<Event>();
+  event->eventID = aEvent.GetEventID();
+  for (int iVertex = 0; iVertex < aEvent.GetNumberOfPrimaryVertex(); ++iVertex) {
+    G4PrimaryVertex* g4Vertex = aEvent.GetPrimaryVertex(iVertex);
+    Vertex vertex{g4Vertex->GetPosition(), g4Vertex->GetT0(), g4Vertex->GetWeight(),
+                  std::unique_ptr<G4VUserPrimaryVertexInformation>(g4Vertex->GetUserInformation()),
+                  {}};
+    g4Vertex->SetUserInformation(nullptr);
+    for (G4PrimaryParticle* g4Particle = g4Vertex->GetPrimary(); g4Particle != nullptr;
+         g4Particle = g4Particle->GetNext()) {
+      vertex.particles.push_back(copy(*g4Particle));
+    }
+    event->vertices.push_back(std::move(vertex));
+  }
+  return event;
+}
+
+SimG4PrefetchingEventProviderTool::Particle SimG4PrefetchingEventProviderTool::copy(G4PrimaryParticle& aParticle) {
+  Particle particle{aParticle.GetPDGcode(),
+                    aParticle.GetG4code(),
+                    aParticle.GetMomentum(),
+                    aParticle.GetMass(),
+                    aParticle.GetCharge(),
+                    aParticle.GetPolarization(),
+                    aParticle.GetWeight(),
+                    aParticle.GetProperTime(),
+                    std::unique_ptr<G4VUserPrimaryParticleInformation>(aParticle.GetUserInformation()),
+                    {}};
+  aParticle.SetUserInformation(nullptr);
+  for (G4PrimaryParticle* daughter = aParticle.GetDaughter(); daughter != nullptr; daughter = daughter->GetNext()) {
+    particle.daughters.push_back(copy(*daughter));
+  }
+  return particle;
+}
+
+G4Event* SimG4PrefetchingEventProviderTool::build(Event& aEvent) {
+  auto g4Event = new G4Event(aEvent.eventID);
+  for (auto& vertex : aEvent.vertices) {
+    auto g4Vertex = new G4PrimaryVertex(vertex.position, vertex.time);
+    g4Vertex->SetWeight(vertex.weight);
+    g4Vertex->SetUserInformation(vertex.information.release());
+    for (auto& particle : vertex.particles) {
+      g4Vertex->SetPrimary(build(particle));
+    }
+    g4Event->AddPrimaryVertex(g4Vertex);
+  }
+  return g4Event;
+}
+
+G4PrimaryParticle* SimG4PrefetchingEventProviderTool::build(Particle& aParticle) {
+  auto g4Particle = aParticle.definition != nullptr ? new G4PrimaryParticle(aParticle.definition)
+                                                    : new G4PrimaryParticle(aParticle.pdg);
+  // the mass first, from which the kinetic energy is computed with the momentum
+  g4Particle->SetMass(aParticle.mass);
+  g4Particle->SetMomentum(aParticle.momentum.x(), aParticle.momentum.y(), aParticle.momentum.z());
+  g4Particle->SetCharge(aParticle.charge);
+  g4Particle->SetPolarization(aParticle.polarization);
+  g4Particle->SetWeight(aParticle.weight);
+  g4Particle->SetProperTime(aParticle.properTime);
+  g4Particle->SetUserInformation(aParticle.information.release());
+  for (auto& daughter : aParticle.daughters) {
+    g4Particle->SetDaughter(build(daughter));
+  }
+  return g4Particle;
+}
+
+void SimG4PrefetchingEventProviderTool::prefetch(EventContext aFirstContext) {
+  // engines are thread-local in the multi-threaded build of Geant4
+  G4Random::setTheEngine(m_engine.get());
+  for (unsigned long iCall = 0;; ++iCall) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(lock, [this] { return m_stop || m_queue.size() < m_queueSize; });
+      if (m_stop) break;
+    }
+    EventContext context(aFirstContext);
+    context.setEvt(aFirstContext.evt() + iCall / m_eventsPerExecute);
+    Gaudi::Hive::setCurrentContext(context);
+    // two positive 31-bit seeds from the seed of the tool and the number of the call (splitmix64 mixing)
+    uint64_t hash = static_cast<uint64_t>(m_seed.value()) ^ (iCall * 0x9e3779b97f4a7c15ULL);
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    const long seeds[3] = {static_cast<long>(hash & 0x7fffffff) | 1, static_cast<long>((hash >> 32) & 0x7fffffff) | 1,
+                           0};
+    m_engine->setSeeds(seeds, 2);
+    G4Event* g4Event = m_provider->g4Event();
+    // the G4 objects are deleted by this thread, which allocated them
+    std::unique_ptr<Event> event;
+    if (g4Event != nullptr) {
+      event = copy(*g4Event);
+      delete g4Event;
+    }
+    const bool failed = event == nullptr;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_queue.push_back(std::move(event));
+    }
+    m_condition.notify_all();
+    // the simulation thread gets the failure, nothing is created after it
+    if (failed) break;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_finished = true;
+  }
+  m_condition.notify_all();
+}
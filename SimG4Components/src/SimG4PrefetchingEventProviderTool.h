@@ -0,0 +1,141 @@
+#ifndef SIMG4COMPONENTS_G4PREFETCHINGEVENTPROVIDERTOOL_H
+#define SIMG4COMPONENTS_G4PREFETCHINGEVENTPROVIDERTOOL_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+#include "GaudiKernel/EventContext.h"
+#include "GaudiKernel/ToolHandle.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4EventProviderTool.h"
+
+// Geant4
+#include "G4ThreeVector.hh"
+#include "G4VUserPrimaryParticleInformation.hh"
+#include "G4VUserPrimaryVertexInformation.hh"
+
+// STL
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Forward declarations
+namespace CLHEP {
+class HepRandomEngine;
+}
+class G4ParticleDefinition;
+class G4PrimaryParticle;
+
+/** @class SimG4PrefetchingEventProviderTool SimG4PrefetchingEventProviderTool.h "SimG4PrefetchingEventProviderTool.h"
+*
+*  Decorator of an event provider (\b'provider') that creates the upcoming G4Events on a background thread, while the
+*  current event is simulated. At most \b'queueSize' events are created in advance.
+*  The provider is called on the background thread with the event context of the event that will use the G4Event
+*  (the context of the first event, with the event number advanced every \b'eventsPerExecute' calls, as in SimG4Alg),
+*  and with its own random engine, reseeded for each event from \b'seed' and the number of the call, so that the
+*  generated events do not depend on the simulation.
+*  The G4Event, primary vertices and particles are allocated from pools of the thread creating them (G4Allocator),
+*  hence they may only be deleted by that thread: the events of the provider are copied to plain data and deleted on
+*  the background thread, and the G4Event is rebuilt from the copy on the thread taking it (keeping the user
+*  information of the vertices and particles).
+*  Only providers independent of the Gaudi event store can be prefetched (e.g. SimG4SingleParticleGeneratorTool
+*  without saveEdm): the store holds only the current event. The events are taken in order by a single algorithm
+*  (SimG4Alg). Requires Geant4 built with multi-threading support (thread-local random engines).
+*/
+
+class SimG4PrefetchingEventProviderTool : public GaudiTool, virtual public ISimG4EventProviderTool {
+public:
+  /// Standard constructor
+  SimG4PrefetchingEventProviderTool(const std::string& type, const std::string& name, const IInterface* parent);
+
+  virtual ~SimG4PrefetchingEventProviderTool();
+
+  virtual StatusCode initialize() final;
+
+  /// Stop the background thread and delete the events not used
+  virtual StatusCode finalize() final;
+
+  /// Takes the next prefetched event (waits for it if not ready yet), starts the background thread at the first call
+  /// @returns G4Event from the provider (ownership is transferred to the caller), nullptr if the provider failed
+  virtual G4Event* g4Event() final;
+
+private:
+  /// Primary particle of a prefetched event, with its daughters
+  struct Particle {
+    int pdg;
+    const G4ParticleDefinition* definition;
+    G4ThreeVector momentum;
+    double mass, charge;
+    G4ThreeVector polarization;
+    double weight, properTime;
+    std::unique_ptr<G4VUserPrimaryParticleInformation> information;
+    std::vector<Particle> daughters;
+  };
+  /// Primary vertex of a prefetched event
+  struct Vertex {
+    G4ThreeVector position;
+    double time, weight;
+    std::unique_ptr<G4VUserPrimaryVertexInformation> information;
+    std::vector<Particle> particles;
+  };
+  /// Prefetched event, without the G4 objects allocated from the pools of the background thread
+  struct Event {
+    int eventID;
+    std::vector<Vertex> vertices;
+  };
+  /** Copy the event of the provider (taking the user information of its vertices and particles), on the background
+   *  thread.
+   *  @param[in, out] aEvent event of the provider, to be deleted after the copy
+   *  @returns copy of the event
+   */
+  static std::unique_ptr<Event> copy(G4Event& aEvent);
+  /** Copy a particle with its daughters.
+   *  @param[in, out] aParticle particle of the provider (its user information is taken)
+   *  @returns copy of the particle
+   */
+  static Particle copy(G4PrimaryParticle& aParticle);
+  /** Build the G4Event from the copy, on the thread taking the event.
+   *  @param[in, out] aEvent copy of the event (its user information is moved to the G4Event)
+   *  @returns G4Event (ownership is transferred to the caller)
+   */
+  static G4Event* build(Event& aEvent);
+  /** Build a particle with its daughters.
+   *  @param[in, out] aParticle copy of the particle (its user information is moved to the G4PrimaryParticle)
+   *  @returns particle (ownership is transferred to the caller)
+   */
+  static G4PrimaryParticle* build(Particle& aParticle);
+  /** Create the events on the background thread.
+   *  @param[in] aFirstContext context of the first event
+   */
+  void prefetch(EventContext aFirstContext);
+  /// Stop and join the background thread
+  void stop();
+  /// Handle for the tool that creates the G4Event
+  ToolHandle<ISimG4EventProviderTool> m_provider{"SimG4SingleParticleGeneratorTool", this};
+  /// Number of events created in advance
+  Gaudi::Property<unsigned int> m_queueSize{this, "queueSize", 2, "Maximum number of events created in advance"};
+  /// Number of calls per Gaudi event (eventsPerExecute of SimG4Alg)
+  Gaudi::Property<unsigned int> m_eventsPerExecute{this, "eventsPerExecute", 1,
+                                                   "Number of events taken in each Gaudi event (as in SimG4Alg)"};
+  /// Seed of the random engine of the background thread
+  Gaudi::Property<long> m_seed{this, "seed", 12345, "Seed of the random engine of the background thread"};
+  /// Background thread
+  std::thread m_thread;
+  /// Random engine of the background thread
+  std::unique_ptr<CLHEP::HepRandomEngine> m_engine;
+  /// Events created in advance (nullptr if the provider failed)
+  std::deque<std::unique_ptr<Event>> m_queue;
+  /// Mutex guarding the queue
+  std::mutex m_mutex;
+  /// Signals that an event was added to the queue or taken from it, or that prefetching stops
+  std::condition_variable m_condition;
+  /// Flag to stop the background thread
+  bool m_stop = false;
+  /// Flag that the background thread does not create any more events
+  bool m_finished = false;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#include "SimG4PrimariesFilterTool.h"
+
+// Geant
+#include "G4Event.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+
+// STL
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+
+DECLARE_COMPONENT(SimG4PrimariesFilterTool)
+
+SimG4PrimariesFilterTool::SimG4PrimariesFilterTool(const std::string& aType, const std::string& aName,
+                                                   const IInterface* aParent)
+    : GaudiTool(aType, aName, aParent) {
+  declareInterface<ISimG4EventFilterTool>(this);
+}
+
+SimG4PrimariesFilterTool::~SimG4PrimariesFilterTool() {}
+
+StatusCode SimG4PrimariesFilterTool::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_maxAbsEta < 0) {
+    error() << "Maximum absolute pseudorapidity needs to be positive (or 0 for no limit)" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_selectedPdgCodes.clear();
+  for (int pdg : m_pdgCodes) {
+    m_selectedPdgCodes.insert(std::abs(pdg));
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4PrimariesFilterTool::finalize() {
+  const double efficiency = m_seen > 0 ? double(m_accepted) / m_seen : 0;
+  info() << "Accepted " << m_accepted << " of " << m_seen << " events (efficiency " << efficiency << ")" << endmsg;
+  if (!m_statisticsFile.value().empty()) {
+    std::ofstream file(m_statisticsFile.value());
+    if (!file) {
+      error() << "Unable to write the statistics of the filter to " << m_statisticsFile.value() << endmsg;
+      return StatusCode::FAILURE;
+    }
+    file << "seen,accepted,efficiency\n" << m_seen << "," << m_accepted << "," << efficiency << "\n";
+  }
+  return GaudiTool::finalize();
+}
+
+bool SimG4PrimariesFilterTool::accept(const G4Event& aEvent) {
+  ++m_seen;
+  unsigned int numSelected = 0;
+  for (int iVertex = 0; iVertex < aEvent.GetNumberOfPrimaryVertex() && numSelected < m_minCount; ++iVertex) {
+    numSelected += countSelected(aEvent.GetPrimaryVertex(iVertex)->GetPrimary());
+  }
+  if (numSelected < m_minCount) {
+    return false;
+  }
+  ++m_accepted;
+  return true;
+}
+
+unsigned int SimG4PrimariesFilterTool::countSelected(const G4PrimaryParticle* aParticle) const {
+  unsigned int numSelected = 0;
+  for (const G4PrimaryParticle* particle = aParticle; particle != nullptr; particle = particle->GetNext()) {
+    numSelected += countSelected(particle->GetDaughter());
+    if (!m_selectedPdgCodes.empty() && m_selectedPdgCodes.count(std::abs(particle->GetPDGcode())) == 0) continue;
+    const G4ThreeVector& momentum = particle->GetMomentum();
+    if (momentum.perp() < m_minPt) continue;
+    // particles along the beam have no pseudorapidity
+    if (m_maxAbsEta > 0 && (momentum.perp2() == 0 || std::abs(momentum.pseudoRapidity()) > m_maxAbsEta)) continue;
+    ++numSelected;
+  }
+  return numSelected;
+}
@@ -0,0 +1,74 @@
+#ifndef SIMG4COMPONENTS_G4PRIMARIESFILTERTOOL_H
+#define SIMG4COMPONENTS_G4PRIMARIESFILTERTOOL_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4EventFilterTool.h"
+
+// STL
+#include <atomic>
+#include <set>
+#include <vector>
+
+class G4PrimaryParticle;
+
+/** @class SimG4PrimariesFilterTool SimG4Components/src/SimG4PrimariesFilterTool.h SimG4PrimariesFilterTool.h
+ *
+ *  Generator-level filter of the events before their simulation (in \b'filters' of SimG4Alg): an event is accepted if
+ *  at least \b'minCount' of its primaries (including the pre-assigned decay products) are of the types \b'pdgCodes'
+ *  (absolute values, all types if empty), with the transverse momentum above \b'minPt' and the pseudorapidity within
+ *  \b'maxAbsEta' (0: no limit), e.g. at least one electron with pT > 20 GeV within the acceptance of the tracker.
+ *  The numbers of the seen and accepted events are printed at the finalisation, and written to \b'statisticsFile' (if
+ *  set), so that the cross-section of the simulated sample may be corrected by the efficiency of the filter.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+ */
+
+class SimG4PrimariesFilterTool : public GaudiTool, virtual public ISimG4EventFilterTool {
+public:
+  explicit SimG4PrimariesFilterTool(const std::string& aType, const std::string& aName, const IInterface* aParent);
+  virtual ~SimG4PrimariesFilterTool();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize.
+   *   Print and write the numbers of the seen and accepted events.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /**  Select the event.
+   *   @param[in] aEvent Generated event, with its primaries.
+   *   @return true if enough primaries pass the cuts
+   */
+  virtual bool accept(const G4Event& aEvent) final;
+
+private:
+  /** Count the primaries passing the cuts, with their pre-assigned decay products.
+   *  @param[in] aParticle first of the primaries (linked by GetNext)
+   *  @return number of primaries passing the cuts
+   */
+  unsigned int countSelected(const G4PrimaryParticle* aParticle) const;
+  /// Types of the selected primaries (absolute values of the PDG codes)
+  Gaudi::Property<std::vector<int>> m_pdgCodes{
+      this, "pdgCodes", {}, "Types of the selected primaries (absolute values of the PDG codes, all if empty)"};
+  /// Minimum transverse momentum of the selected primaries
+  Gaudi::Property<double> m_minPt{this, "minPt", 0, "Minimum transverse momentum of the selected primaries"};
+  /// Maximum absolute pseudorapidity of the selected primaries (0: no limit)
+  Gaudi::Property<double> m_maxAbsEta{this, "maxAbsEta", 0,
+                                      "Maximum absolute pseudorapidity of the selected primaries (0: no limit)"};
+  /// Minimum number of selected primaries of the accepted events
+  Gaudi::Property<unsigned int> m_minCount{this, "minCount", 1,
+                                           "Minimum number of selected primaries of the accepted events"};
+  /// File to which the numbers of the seen and accepted events are written (not written if empty)
+  Gaudi::Property<std::string> m_statisticsFile{
+      this, "statisticsFile", "", "File of the numbers of seen and accepted events (not written if empty)"};
+  /// Types of the selected primaries
+  std::set<int> m_selectedPdgCodes;
+  /// Numbers of the seen and accepted events
+  std::atomic<unsigned long> m_seen{0};
+  std::atomic<unsigned long> m_accepted{0};
+};
+
+#endif /* SIMG4COMPONENTS_G4PRIMARIESFILTERTOOL_H */
@@ -14,6 +14,12 @@
 // Geant4
 #include "G4Event.hh"
 
+// STL
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+
 // Declaration of the Tool
 DECLARE_COMPONENT(SimG4PrimariesFromEdmTool)
 
@@ -28,23 +34,68 @@ SimG4PrimariesFromEdmTool::~SimG4PrimariesFromEdmTool() {}
 
 StatusCode SimG4PrimariesFromEdmTool::initialize() { return GaudiTool::initialize(); }
 
+bool SimG4PrimariesFromEdmTool::isDecayed(const edm4hep::MCParticle& aParticle) const {
+  return m_preassignedDecays && aParticle.getGeneratorStatus() == m_decayedStatus && aParticle.daughters_size() > 0;
+}
+
+bool SimG4PrimariesFromEdmTool::isConverted(const edm4hep::MCParticle& aParticle) const {
+  return m_generatorStatus.value().empty() || isDecayed(aParticle) ||
+         std::find(m_generatorStatus.value().begin(), m_generatorStatus.value().end(),
+                   aParticle.getGeneratorStatus()) != m_generatorStatus.value().end();
+}
+
+G4PrimaryParticle* SimG4PrimariesFromEdmTool::primary(const edm4hep::MCParticle& aParticle,
+                                                      std::unordered_set<int>& aConverted) const {
+  aConverted.insert(aParticle.getObjectID().index);
+  const edm4hep::Vector3f mom = aParticle.getMomentum();
+  G4PrimaryParticle* g4Particle = new G4PrimaryParticle(aParticle.getPDG(),
+                                                        mom.x * sim::edm2g4::energy,
+                                                        mom.y * sim::edm2g4::energy,
+                                                        mom.z * sim::edm2g4::energy);
+  g4Particle->SetUserInformation(new sim::ParticleInformation(aParticle));
+  if (isDecayed(aParticle)) {
+    for (const auto& daughter : aParticle.getDaughters()) {
+      // a daughter of several decayed particles is assigned to the first one
+      if (!isConverted(daughter) || aConverted.count(daughter.getObjectID().index) > 0) continue;
+      g4Particle->SetDaughter(primary(daughter, aConverted));
+    }
+    // decay at the generated time, in the rest frame of the particle (same convention of the time as the vertex)
+    const double decayTime = (aParticle.getDaughters(0).getTime() - aParticle.getTime()) / Gaudi::Units::c_light *
+                             sim::edm2g4::length;
+    const double energy = std::sqrt(mom.x * mom.x + mom.y * mom.y + mom.z * mom.z +
+                                    aParticle.getMass() * aParticle.getMass());
+    if (decayTime > 0 && energy > 0) g4Particle->SetProperTime(decayTime * aParticle.getMass() / energy);
+  }
+  return g4Particle;
+}
+
 G4Event* SimG4PrimariesFromEdmTool::g4Event() {
   auto theEvent = new G4Event();
   const edm4hep::MCParticleCollection* mcparticles = m_genParticles.get();
+  std::unordered_set<int> converted;
+  converted.reserve(mcparticles->size());
+  std::map<std::array<double, 4>, G4PrimaryVertex*> vertices;
   for (const auto& mcparticle : *mcparticles) {
+    if (!isConverted(mcparticle) || converted.count(mcparticle.getObjectID().index) > 0) continue;
+    // the decay products of the pre-assigned decays are added with their parent
+    const auto parents = mcparticle.getParents();
+    if (std::any_of(parents.begin(), parents.end(), [this](const auto& aParent) { return isDecayed(aParent); })) {
+      continue;
+    }
+    // the particles produced at the same point share the vertex (otherwise the key is unique)
     const edm4hep::Vector3d v = mcparticle.getVertex();
-    G4PrimaryVertex* g4Vertex = new G4PrimaryVertex(v.x * sim::edm2g4::length,
-                                                    v.y * sim::edm2g4::length,
-                                                    v.z * sim::edm2g4::length,
-                                                    mcparticle.getTime() / Gaudi::Units::c_light  * sim::edm2g4::length);
-    const edm4hep::Vector3f mom = mcparticle.getMomentum();
-    G4PrimaryParticle* g4Particle = new G4PrimaryParticle(mcparticle.getPDG(),
-                                                          mom.x * sim::edm2g4::energy,
-                                                          mom.y * sim::edm2g4::energy,
-                                                          mom.z * sim::edm2g4::energy);
-    g4Particle->SetUserInformation(new sim::ParticleInformation(mcparticle));
-    g4Vertex->SetPrimary(g4Particle);
-    theEvent->AddPrimaryVertex(g4Vertex);
+    const double key = m_shareVertices ? mcparticle.getTime() : double(mcparticle.getObjectID().index);
+    G4PrimaryVertex*& g4Vertex = vertices[{v.x, v.y, v.z, key}];
+    if (g4Vertex == nullptr) {
+      g4Vertex = new G4PrimaryVertex(v.x * sim::edm2g4::length,
+                                     v.y * sim::edm2g4::length,
+                                     v.z * sim::edm2g4::length,
+                                     mcparticle.getTime() / Gaudi::Units::c_light  * sim::edm2g4::length);
+      theEvent->AddPrimaryVertex(g4Vertex);
+    }
+    g4Vertex->SetPrimary(primary(mcparticle, converted));
   }
+  debug() << converted.size() << " of " << mcparticles->size() << " particles converted to primaries at "
+          << vertices.size() << " vertices" << endmsg;
   return theEvent;
 }
@@ -9,15 +9,27 @@
 
 #include "G4VUserPrimaryGeneratorAction.hh"
 
+// STL
+#include <unordered_set>
+
 // Forward declarations
 // datamodel
 namespace edm4hep {
+class MCParticle;
 class MCParticleCollection;
 }
+class G4PrimaryParticle;
 
 /** @class SimG4PrimariesFromEdmTool SimG4PrimariesFromEdmTool.h "SimG4PrimariesFromEdmTool.h"
 *
 *  Tool to translate an EDM MCParticleCollection into a G4Event
+*  Only the particles of the generator statuses \b'generatorStatus' become primaries (all if empty, e.g. [1] for the
+*  final-state particles of a full generator record), so that the intermediate particles are not simulated twice.
+*  If \b'preassignedDecays' is set, the decayed particles (status \b'decayedStatus') are simulated too, with their
+*  daughters of the record as their pre-assigned decay products (G4PrimaryParticle::SetDaughter) instead of separate
+*  primaries: Geant4 tracks them up to their generated decay time, including its propagation in the magnetic field.
+*  The particles produced at the same point (position and time) share one G4PrimaryVertex, unless
+*  \b'shareVertices' is false (e.g. to split the particles of one collision between sub-events of SimG4Svc).
 *
 *  @author A. Zaborowska, J. Lingemann, A. Dell'Acqua
 *  @date   2016-01-11
@@ -36,8 +48,29 @@ public:
   virtual G4Event* g4Event() final;
 
 private:
+  /// Whether the particle is converted (status selected, or decayed if the decays are pre-assigned)
+  bool isConverted(const edm4hep::MCParticle& aParticle) const;
+  /// Whether the decay of the particle is pre-assigned
+  bool isDecayed(const edm4hep::MCParticle& aParticle) const;
+  /** Create the primary particle, with its pre-assigned decay products.
+   *  @param[in] aParticle generated particle
+   *  @param[in, out] aConverted indices of the particles already converted
+   *  @returns primary particle (ownership is transferred to the caller)
+   */
+  G4PrimaryParticle* primary(const edm4hep::MCParticle& aParticle, std::unordered_set<int>& aConverted) const;
   /// Handle for the EDM MC particles to be read
   DataHandle<edm4hep::MCParticleCollection> m_genParticles{"GenParticles", Gaudi::DataHandle::Reader, this};
+  /// Generator statuses of the particles converted to primaries
+  Gaudi::Property<std::vector<int>> m_generatorStatus{
+      this, "generatorStatus", {}, "Generator statuses of the particles converted to primaries (all if empty)"};
+  /// Flag whether the decays of the decayed particles are pre-assigned
+  Gaudi::Property<bool> m_preassignedDecays{this, "preassignedDecays", false,
+                                            "Simulate the decayed particles with their pre-assigned decay products"};
+  /// Generator status of the decayed particles
+  Gaudi::Property<int> m_decayedStatus{this, "decayedStatus", 2, "Generator status of the decayed particles"};
+  /// Flag whether the particles produced at the same point share the vertex
+  Gaudi::Property<bool> m_shareVertices{this, "shareVertices", true,
+                                        "Set to true for the particles produced at the same point to share the vertex"};
 };
 
 #endif
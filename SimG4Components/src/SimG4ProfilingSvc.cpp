@@ -0,0 +1,172 @@
+#include "SimG4ProfilingSvc.h"
+
+// FCCSW
+#include "SimG4Common/EventWatchdog.h"
+#include "SimG4Common/MemoryUsage.h"
+
+// STL
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+DECLARE_COMPONENT(SimG4ProfilingSvc)
+
+SimG4ProfilingSvc::SimG4ProfilingSvc(const std::string& aName, ISvcLocator* aSL)
+    : base_class(aName, aSL), m_created(std::chrono::steady_clock::now()) {}
+
+SimG4ProfilingSvc::~SimG4ProfilingSvc() {}
+
+void SimG4ProfilingSvc::Stat::add(double aValue) {
+  ++entries;
+  sum += aValue;
+  sum2 += aValue * aValue;
+  if (aValue < min) min = aValue;
+  if (aValue > max) max = aValue;
+}
+
+double SimG4ProfilingSvc::Stat::rms() const {
+  if (entries == 0) return 0;
+  double m = mean();
+  return std::sqrt(std::fabs(sum2 / entries - m * m));
+}
+
+StatusCode SimG4ProfilingSvc::initialize() {
+  if (Service::initialize().isFailure()) {
+    error() << "Unable to initialize Service()" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
+
+void SimG4ProfilingSvc::addTime(const std::string& aPhase, double aSeconds) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_loopStarted) {
+    // the event loop started when the first phase did
+    m_loopStart = std::chrono::steady_clock::now() - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                          std::chrono::duration<double>(aSeconds));
+    m_loopStarted = true;
+  }
+  m_times[aPhase].add(aSeconds);
+}
+
+void SimG4ProfilingSvc::addCount(const std::string& aCounter, double aValue) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_counts[aCounter].add(aValue);
+}
+
+void SimG4ProfilingSvc::endOfEvent() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ++m_numEvents;
+  m_loopEnd = std::chrono::steady_clock::now();
+}
+
+SimG4ProfilingSvc::JobMetrics SimG4ProfilingSvc::jobMetrics() const {
+  JobMetrics metrics;
+  const auto loopStart = m_loopStarted ? m_loopStart : std::chrono::steady_clock::now();
+  metrics.initialisationSeconds = std::chrono::duration<double>(loopStart - m_created).count();
+  metrics.eventLoopSeconds = m_numEvents > 0 ? std::chrono::duration<double>(m_loopEnd - m_loopStart).count() : 0;
+  metrics.eventsPerSecond = metrics.eventLoopSeconds > 0 ? m_numEvents / metrics.eventLoopSeconds : 0;
+  metrics.peakResidentMB = sim::peakResidentMemory();
+  metrics.killedTracks = sim::EventWatchdog::totalKilledTracks();
+  metrics.abortedEvents = sim::EventWatchdog::totalAbortedEvents();
+  return metrics;
+}
+
+StatusCode SimG4ProfilingSvc::writeJson(const JobMetrics& aMetrics) const {
+  std::ofstream out(m_filename.value());
+  if (!out.good()) {
+    error() << "Unable to open the output file " << m_filename.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  auto writeStats = [&out](const std::map<std::string, Stat>& aStats) {
+    bool first = true;
+    for (const auto& stat : aStats) {
+      out << (first ? "" : ",") << "\n    \"" << stat.first << "\": {\"entries\": " << stat.second.entries
+          << ", \"total\": " << stat.second.sum << ", \"mean\": " << stat.second.mean()
+          << ", \"rms\": " << stat.second.rms() << ", \"min\": " << stat.second.min << ", \"max\": " << stat.second.max
+          << "}";
+      first = false;
+    }
+  };
+  out << std::setprecision(9) << "{\n  \"events\": " << m_numEvents << ",\n  \"job\": {\"initialisation_seconds\": "
+      << aMetrics.initialisationSeconds << ", \"event_loop_seconds\": " << aMetrics.eventLoopSeconds
+      << ", \"events_per_second\": " << aMetrics.eventsPerSecond << ", \"peak_rss_MB\": " << aMetrics.peakResidentMB
+      << ", \"killed_tracks\": " << aMetrics.killedTracks << ", \"aborted_events\": " << aMetrics.abortedEvents
+      << "},\n  \"times\": {";
+  writeStats(m_times);
+  out << "\n  },\n  \"counters\": {";
+  writeStats(m_counts);
+  out << "\n  }\n}\n";
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4ProfilingSvc::writePrometheus(const JobMetrics& aMetrics) const {
+  std::ofstream out(m_prometheusFile.value());
+  if (!out.good()) {
+    error() << "Unable to open the output file " << m_prometheusFile.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  // values of the labels need their backslashes and quotes escaped
+  auto label = [](const std::string& aName, const std::string& aValue) {
+    std::string escaped;
+    for (char c : aValue) {
+      if (c == '\\' || c == '"') escaped += '\\';
+      escaped += c;
+    }
+    return aName + "=\"" + escaped + "\"";
+  };
+  const std::string job = label("job", m_jobLabel);
+  auto gauge = [&out](const std::string& aName, const std::string& aHelp) {
+    out << "# HELP k4simgeant4_" << aName << " " << aHelp << "\n# TYPE k4simgeant4_" << aName << " gauge\n";
+  };
+  out << std::setprecision(9);
+  gauge("events", "Number of processed events");
+  out << "k4simgeant4_events{" << job << "} " << m_numEvents << "\n";
+  gauge("initialisation_seconds", "Time from the creation of the profiling service to the first event");
+  out << "k4simgeant4_initialisation_seconds{" << job << "} " << aMetrics.initialisationSeconds << "\n";
+  gauge("event_loop_seconds", "Wall-clock time of the event loop");
+  out << "k4simgeant4_event_loop_seconds{" << job << "} " << aMetrics.eventLoopSeconds << "\n";
+  gauge("events_per_second", "Events per second of the event loop");
+  out << "k4simgeant4_events_per_second{" << job << "} " << aMetrics.eventsPerSecond << "\n";
+  gauge("peak_rss_megabytes", "Peak resident memory of the process");
+  out << "k4simgeant4_peak_rss_megabytes{" << job << "} " << aMetrics.peakResidentMB << "\n";
+  gauge("killed_tracks", "Tracks killed by the watchdog for their steps");
+  out << "k4simgeant4_killed_tracks{" << job << "} " << aMetrics.killedTracks << "\n";
+  gauge("aborted_events", "Events aborted by the watchdog");
+  out << "k4simgeant4_aborted_events{" << job << "} " << aMetrics.abortedEvents << "\n";
+  gauge("phase_seconds_mean", "Mean time per event of a phase of the simulation");
+  for (const auto& time : m_times) {
+    out << "k4simgeant4_phase_seconds_mean{" << job << "," << label("phase", time.first) << "} " << time.second.mean()
+        << "\n";
+  }
+  gauge("counter_mean", "Mean value per event of a counter (tracks, steps, hits per collection, ...)");
+  for (const auto& count : m_counts) {
+    out << "k4simgeant4_counter_mean{" << job << "," << label("counter", count.first) << "} " << count.second.mean()
+        << "\n";
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4ProfilingSvc::finalize() {
+  info() << "Simulation profile for " << m_numEvents << " events" << endmsg;
+  for (const auto& time : m_times) {
+    info() << std::setw(40) << std::left << time.first << " total " << std::setw(12) << time.second.sum
+           << " s, mean " << std::setw(12) << time.second.mean() << " s, max " << time.second.max << " s" << endmsg;
+  }
+  for (const auto& count : m_counts) {
+    info() << std::setw(40) << std::left << count.first << " mean " << std::setw(12) << count.second.mean()
+           << ", rms " << std::setw(12) << count.second.rms() << ", max " << count.second.max << endmsg;
+  }
+  const JobMetrics metrics = jobMetrics();
+  info() << "Initialisation " << metrics.initialisationSeconds << " s, event loop " << metrics.eventLoopSeconds
+         << " s (" << metrics.eventsPerSecond << " events/s), peak resident memory " << metrics.peakResidentMB
+         << " MB, " << metrics.killedTracks << " tracks killed, " << metrics.abortedEvents << " events aborted"
+         << endmsg;
+  if (!m_filename.value().empty() && writeJson(metrics).isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (!m_prometheusFile.value().empty() && writePrometheus(metrics).isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  return Service::finalize();
+}
@@ -0,0 +1,108 @@
+#ifndef SIMG4COMPONENTS_G4PROFILINGSVC_H
+#define SIMG4COMPONENTS_G4PROFILINGSVC_H
+
+// FCCSW
+#include "SimG4Interface/ISimG4ProfilingSvc.h"
+
+// Gaudi
+#include "GaudiKernel/Service.h"
+
+// STL
+#include <chrono>
+#include <limits>
+#include <map>
+#include <mutex>
+
+/** @class SimG4ProfilingSvc SimG4Components/src/SimG4ProfilingSvc.h SimG4ProfilingSvc.h
+ *
+ *  Service collecting the timing of the simulation phases and the per-event counters.
+ *  Statistics (total, mean, RMS, minimum and maximum per event) are printed at finalization
+ *  and optionally written to a JSON file (\b'filename').
+ *  The metrics of the job are added to the file: the initialisation time (from the creation of the service, listed
+ *  first in the external services, to the first recorded phase), the time of the event loop, the events per second,
+ *  the peak resident memory and the numbers of tracks killed and events aborted by the watchdog of SimG4Svc.
+ *  With \b'prometheusFile' the metrics of the job and the means of the phases and counters are also written in the
+ *  text format of Prometheus (e.g. for the textfile collector of an exporter, or to be pushed to a push gateway),
+ *  labelled with \b'jobLabel'.
+ *  It is filled by SimG4Alg if its property \b'profiling' is set.
+ */
+
+class SimG4ProfilingSvc : public extends1<Service, ISimG4ProfilingSvc> {
+public:
+  /// Standard constructor
+  explicit SimG4ProfilingSvc(const std::string& aName, ISvcLocator* aSL);
+  /// Standard destructor
+  virtual ~SimG4ProfilingSvc();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize: print the summary and write it to the output file.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /**  Record the duration of a phase of the simulation loop.
+   *   @param[in] aPhase Name of the phase.
+   *   @param[in] aSeconds Wall-clock time spent in the phase [s].
+   */
+  virtual void addTime(const std::string& aPhase, double aSeconds) final;
+  /**  Record the value of a per-event counter.
+   *   @param[in] aCounter Name of the counter.
+   *   @param[in] aValue Value of the counter in the current event.
+   */
+  virtual void addCount(const std::string& aCounter, double aValue) final;
+  /**  Mark the end of the event.
+   */
+  virtual void endOfEvent() final;
+
+private:
+  /// Statistics of one quantity
+  struct Stat {
+    unsigned long entries = 0;
+    double sum = 0;
+    double sum2 = 0;
+    double min = std::numeric_limits<double>::max();
+    double max = std::numeric_limits<double>::lowest();
+    void add(double aValue);
+    double mean() const { return entries ? sum / entries : 0; }
+    double rms() const;
+  };
+  /// Metrics of the job
+  struct JobMetrics {
+    double initialisationSeconds;
+    double eventLoopSeconds;
+    double eventsPerSecond;
+    double peakResidentMB;
+    unsigned long killedTracks;
+    unsigned long abortedEvents;
+  };
+  /// Compute the metrics of the job
+  JobMetrics jobMetrics() const;
+  /// Write the summary in JSON format
+  StatusCode writeJson(const JobMetrics& aMetrics) const;
+  /// Write the metrics in the text format of Prometheus
+  StatusCode writePrometheus(const JobMetrics& aMetrics) const;
+  /// Timing of the phases
+  std::map<std::string, Stat> m_times;
+  /// Per-event counters
+  std::map<std::string, Stat> m_counts;
+  /// Number of processed events
+  unsigned long m_numEvents = 0;
+  /// Creation of the service, and first and last times of the event loop
+  std::chrono::steady_clock::time_point m_created;
+  std::chrono::steady_clock::time_point m_loopStart;
+  std::chrono::steady_clock::time_point m_loopEnd;
+  /// Flag whether a phase was recorded
+  bool m_loopStarted = false;
+  /// Mutex guarding the statistics
+  std::mutex m_mutex;
+  /// Name of the JSON output file (no output if empty)
+  Gaudi::Property<std::string> m_filename{this, "filename", "", "Name of the JSON output file (no file if empty)"};
+  /// Name of the output file in the text format of Prometheus (no output if empty)
+  Gaudi::Property<std::string> m_prometheusFile{this, "prometheusFile", "",
+                                                "Name of the file in the Prometheus text format (no file if empty)"};
+  /// Label of the job in the Prometheus metrics (e.g. name of the configuration)
+  Gaudi::Property<std::string> m_jobLabel{this, "jobLabel", "", "Label 'job' of the metrics in the Prometheus format"};
+};
+
+#endif /* SIMG4COMPONENTS_G4PROFILINGSVC_H */
@@ -0,0 +1,63 @@
+#include "SimG4ReentrantAlg.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4Svc.h"
+
+// Geant
+#include "G4Event.hh"
+
+DECLARE_COMPONENT(SimG4ReentrantAlg)
+
+SimG4ReentrantAlg::SimG4ReentrantAlg(const std::string& aName, ISvcLocator* aSvcLoc)
+    : Gaudi::Algorithm(aName, aSvcLoc), m_geantSvc("SimG4Svc", aName) {
+  declareProperty("eventProvider", m_eventTool, "Handle for tool that creates the G4Event");
+  declareProperty("outputs", m_saveTools, "Handles to the tools saving the output");
+  // waiting for the Geant worker thread, may be scheduled on the pool of blocking tasks
+  setBlocking(true);
+}
+SimG4ReentrantAlg::~SimG4ReentrantAlg() {}
+
+StatusCode SimG4ReentrantAlg::initialize() {
+  if (Gaudi::Algorithm::initialize().isFailure()) return StatusCode::FAILURE;
+  if (!m_geantSvc) {
+    error() << "Unable to locate Geant Simulation Service" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_saveTools.retrieve()) {
+    error() << "Unable to retrieve the output saving tools" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_eventTool.retrieve()) {
+    error() << "Unable to retrieve the G4Event provider " << m_eventTool << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4ReentrantAlg::execute(const EventContext& aContext) const {
+  // first translate the event
+  G4Event* event = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(m_toolsMutex);
+    event = m_eventTool->g4Event();
+  }
+  if (!event) {
+    error() << "Unable to retrieve G4Event from " << m_eventTool << " in slot " << aContext.slot() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_geantSvc->processEvent(*event).isFailure()) {
+    error() << "Unable to simulate event in slot " << aContext.slot() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  G4Event* constevent = nullptr;
+  if (m_geantSvc->retrieveEvent(constevent).isSuccess()) {
+    std::lock_guard<std::mutex> lock(m_toolsMutex);
+    for (auto& tool : m_saveTools) {
+      tool->saveOutput(*constevent).ignore();
+    }
+  }
+  m_geantSvc->terminateEvent().ignore();
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4ReentrantAlg::finalize() { return Gaudi::Algorithm::finalize(); }
@@ -0,0 +1,63 @@
+#ifndef SIMG4COMPONENTS_G4SIMREENTRANTALG_H
+#define SIMG4COMPONENTS_G4SIMREENTRANTALG_H
+
+// GAUDI
+#include "Gaudi/Algorithm.h"
+#include "GaudiKernel/ToolHandle.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4EventProviderTool.h"
+#include "SimG4Interface/ISimG4SaveOutputTool.h"
+
+// STL
+#include <mutex>
+
+// Forward declarations:
+// Interfaces
+class ISimG4Svc;
+
+/** @class SimG4ReentrantAlg SimG4Components/src/SimG4ReentrantAlg.h SimG4ReentrantAlg.h
+ *
+ *  Reentrant Geant simulation algorithm, to be used with the multi-threaded mode of SimG4Svc
+ *  (numberOfThreads > 0) and the GAUDI Hive scheduler.
+ *  Controls the event flow in the same way as SimG4Alg, but several events (one per event slot) may be simulated
+ *  at once. While the event is simulated in a Geant worker thread, the calling thread waits, hence the algorithm
+ *  is declared as blocking, so that other algorithms (e.g. generation, digitisation) are not stalled.
+ *  Event provider and saving tools are shared between the event slots and are called one at a time.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+ */
+
+class SimG4ReentrantAlg : public Gaudi::Algorithm {
+public:
+  explicit SimG4ReentrantAlg(const std::string&, ISvcLocator*);
+  virtual ~SimG4ReentrantAlg();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Execute the simulation of the event of the given context.
+   *   G4Event is created by the event provider, passed to SimG4Svc for the simulation and retrieved afterwards.
+   *   The tools m_saveTools are used to save the output from the retrieved events.
+   *   Finally, the event is terminated.
+   *   @param[in] aContext context of the event
+   *   @return status code
+   */
+  virtual StatusCode execute(const EventContext& aContext) const final;
+  /**  Finalize.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /// Algorithm may be executed concurrently for different events
+  virtual bool isReEntrant() const final { return true; }
+
+private:
+  /// Pointer to the interface of Geant simulation service
+  ServiceHandle<ISimG4Svc> m_geantSvc;
+  /// Handles to the tools saving the output
+  ToolHandleArray<ISimG4SaveOutputTool> m_saveTools{this};
+  /// Handle for tool that creates the G4Event
+  ToolHandle<ISimG4EventProviderTool> m_eventTool{"SimG4PrimariesFromEdmTool", this};
+  /// Mutex serializing the calls to the (non reentrant) tools
+  mutable std::mutex m_toolsMutex;
+};
+#endif /* SIMG4COMPONENTS_G4SIMREENTRANTALG_H */
@@ -1,26 +1,44 @@
 #include "SimG4SaveCalHits.h"
 
 // FCCSW
+#include "SimG4Common/EventInformation.h"
 #include "SimG4Common/Geant4CaloHit.h"
+#include "SimG4Common/HitBuffer.h"
 #include "SimG4Interface/IGeoSvc.h"
 #include "SimG4Common/Units.h"
+#include "StreamBlocks.h"
 
 // Geant4
 #include "G4Event.hh"
+#include "G4THitsCollection.hh"
+#include "Randomize.hh"
 
 // datamodel
+#include "edm4hep/CaloHitContributionCollection.h"
+#include "edm4hep/MCParticleCollection.h"
 #include "edm4hep/SimCalorimeterHitCollection.h"
 
 // DD4hep
+#include "DD4hep/Detector.h"
 #include "DDG4/Geant4Hits.h"
+#include "DDSegmentation/BitFieldCoder.h"
+
+// STL
+#include <algorithm>
+#include <functional>
+#include <memory>
 
 DECLARE_COMPONENT(SimG4SaveCalHits)
 
 SimG4SaveCalHits::SimG4SaveCalHits(const std::string& aType, const std::string& aName, const IInterface* aParent)
-    : GaudiTool(aType, aName, aParent), m_geoSvc("GeoSvc", aName) {
+    : GaudiTool(aType, aName, aParent), m_geoSvc("GeoSvc", aName), m_streamSvc("SimG4OutputStreamSvc", aName) {
   declareInterface<ISimG4SaveOutputTool>(this);
   declareProperty("CaloHits", m_caloHits, "Handle for calo hits");
+  declareProperty("CaloHitContributions", m_contributions, "Handle for the MC contributions to the calo hits");
+  declareProperty("CaloHitsIndex", m_index, "Handle for the offsets of the ranges of sorted calo hits");
+  declareProperty("CaloHitsSlices", m_slices, "Handle for the offsets of the time slices of the calo hits");
   declareProperty("GeoSvc", m_geoSvc);
+  declareProperty("OutputStreamSvc", m_streamSvc);
 }
 
 SimG4SaveCalHits::~SimG4SaveCalHits() {}
@@ -44,38 +62,462 @@ StatusCode SimG4SaveCalHits::initialize() {
       debug() << "Hits will be saved to EDM from the collection " << readoutName << endmsg;
     }
   }
+  if (m_contributionsMode != "" && m_contributionsMode != "track" && m_contributionsMode != "pdg") {
+    error() << "Unknown granularity of the MC contributions: " << m_contributionsMode.value()
+            << ", possible: \"track\" or \"pdg\"" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  for (auto& threshold : m_energyThresholds.value()) {
+    if (std::find(m_readoutNames.begin(), m_readoutNames.end(), threshold.first) == m_readoutNames.end()) {
+      warning() << "Energy threshold given for readout " << threshold.first << " that is not saved" << endmsg;
+    }
+  }
+  if (!m_outputStream.value().empty() && (!m_streamSvc || !m_streamSvc->hasStream(m_outputStream))) {
+    error() << "Output stream " << m_outputStream.value() << " is not configured in SimG4OutputStreamSvc" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_thinningMasks.assign(m_readoutNames.size(), ~uint64_t(0));
+  if (!m_thinningThresholds.value().empty()) {
+    if (m_aggregateCells) {
+      error() << "Thinning of the deposits requires the cells not to be aggregated (aggregateCells)" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    if (m_thinningFraction <= 0 || m_thinningFraction > 1) {
+      error() << "Fraction of the kept thinned deposits needs to be in (0, 1]" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    for (auto& threshold : m_thinningThresholds.value()) {
+      if (std::find(m_readoutNames.begin(), m_readoutNames.end(), threshold.first) == m_readoutNames.end()) {
+        warning() << "Thinning energy given for readout " << threshold.first << " that is not saved" << endmsg;
+      }
+    }
+    if (!m_thinningFields.value().empty()) {
+      for (size_t iReadout = 0; iReadout < m_readoutNames.size(); ++iReadout) {
+        auto decoder = lcdd->readout(m_readoutNames[iReadout]).idSpec().decoder();
+        uint64_t mask = 0;
+        for (const auto& field : m_thinningFields.value()) {
+          try {
+            mask |= (*decoder)[decoder->index(field)].mask();
+          } catch (const std::exception& e) {
+            error() << "Readout " << m_readoutNames[iReadout] << " does not contain the thinning field " << field
+                    << ": " << e.what() << endmsg;
+            return StatusCode::FAILURE;
+          }
+        }
+        m_thinningMasks[iReadout] = mask;
+      }
+    }
+  }
+  if (!m_timeSlices.value().empty()) {
+    if (m_timeSlices.value().size() < 2 ||
+        std::adjacent_find(m_timeSlices.value().begin(), m_timeSlices.value().end(), std::greater_equal<double>()) !=
+            m_timeSlices.value().end()) {
+      error() << "Time slices need at least two edges, in increasing order" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    if (!m_thinningThresholds.value().empty()) {
+      error() << "Thinning of the deposits is not supported with time slices" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  m_cellIndices.resize(m_timeSlices.value().empty() ? 1 : m_timeSlices.value().size() - 1);
+  m_indexFields.assign(m_readoutNames.size(), nullptr);
+  if (!m_indexField.value().empty()) {
+    if (!m_sortByCellID) {
+      error() << "Index of the field " << m_indexField.value() << " requires the hits to be sorted (sortByCellID)"
+              << endmsg;
+      return StatusCode::FAILURE;
+    }
+    for (size_t iReadout = 0; iReadout < m_readoutNames.size(); ++iReadout) {
+      auto decoder = lcdd->readout(m_readoutNames[iReadout]).idSpec().decoder();
+      try {
+        m_indexFields[iReadout] = &(*decoder)[decoder->index(m_indexField)];
+      } catch (const std::exception& e) {
+        error() << "Readout " << m_readoutNames[iReadout] << " does not contain the indexed field: " << e.what()
+                << endmsg;
+        return StatusCode::FAILURE;
+      }
+    }
+  }
   return StatusCode::SUCCESS;
 }
 
 StatusCode SimG4SaveCalHits::finalize() { return GaudiTool::finalize(); }
 
 StatusCode SimG4SaveCalHits::saveOutput(const G4Event& aEvent) {
+  if (fillOutput(aEvent).isFailure()) return StatusCode::FAILURE;
+  return putOutput();
+}
+
+bool SimG4SaveCalHits::fillsConcurrently() const {
+  // the thinning draws from the random engine, whose sequence would depend on the thread filling the output
+  return m_thinningThresholds.value().empty();
+}
+
+StatusCode SimG4SaveCalHits::fillOutput(const G4Event& aEvent) {
   G4HCofThisEvent* collections = aEvent.GetHCofThisEvent();
-  G4VHitsCollection* collect;
   k4::Geant4CaloHit* hit;
+  m_pendingHits.reset();
+  m_pendingContributions.reset();
+  m_pendingIndex.reset();
+  m_pendingSlices.reset();
   if (collections != nullptr) {
-    auto edmHits = m_caloHits.createAndPut();
-    for (int iter_coll = 0; iter_coll < collections->GetNumberOfCollections(); iter_coll++) {
-      collect = collections->GetHC(iter_coll);
-      if (std::find(m_readoutNames.begin(), m_readoutNames.end(), collect->GetName()) != m_readoutNames.end()) {
-        size_t n_hit = collect->GetSize();
-        debug() << "\t" << n_hit << " hits are stored in a collection #" << iter_coll << ": " << collect->GetName()
+    const bool saveContributions = !m_contributionsMode.value().empty();
+    const bool byTrack = m_contributionsMode == "track";
+    // edges of the time slices (the deposits are not split if empty)
+    const std::vector<double>& sliceEdges = m_timeSlices.value();
+    const bool sliced = !sliceEdges.empty();
+    // collections are put in the event store (or written to the output stream) by putOutput
+    m_pendingHits = std::make_unique<edm4hep::SimCalorimeterHitCollection>();
+    if (saveContributions) m_pendingContributions = std::make_unique<edm4hep::CaloHitContributionCollection>();
+    if (!m_indexField.value().empty()) m_pendingIndex = std::make_unique<podio::UserDataCollection<int>>();
+    if (sliced) m_pendingSlices = std::make_unique<podio::UserDataCollection<int>>();
+    auto edmHits = m_pendingHits.get();
+    edm4hep::CaloHitContributionCollection* edmContributions = m_pendingContributions.get();
+    // particles of the history, to which the contributions of the tracks are linked
+    auto evtinfo = dynamic_cast<sim::EventInformation*>(aEvent.GetUserInformation());
+    const edm4hep::MCParticleCollection* particles =
+        (byTrack && evtinfo != nullptr) ? evtinfo->particles() : nullptr;
+    m_cells.clear();
+    for (auto& cellIndex : m_cellIndices) cellIndex.clear();
+    m_cellContributions.clear();
+    m_contributionIndex.clear();
+    m_deposits.clear();
+    m_sortGroups.clear();
+    podio::UserDataCollection<int>* index = m_pendingIndex.get();
+    podio::UserDataCollection<int>* slices = m_pendingSlices.get();
+    m_sliceCounts.assign(m_cellIndices.size(), 0);
+    // sorting group of the hits of the current collection: time slice, index of its readout and value of the indexed
+    // field
+    uint64_t readoutGroup = 0;
+    const dd4hep::DDSegmentation::BitFieldElement* indexField = nullptr;
+    auto sortGroup = [&](uint64_t aCellID, int aSlice) {
+      return (uint64_t(aSlice) << 48) | readoutGroup |
+             (indexField != nullptr ? static_cast<uint32_t>(indexField->value(aCellID)) : 0);
+    };
+    // start a range of the index if the next sorted hit is in another group than the previous one
+    bool indexed = false;
+    uint64_t indexedGroup = 0;
+    auto indexHit = [&](uint64_t aGroup) {
+      if (index == nullptr || (indexed && aGroup == indexedGroup)) return;
+      indexed = true;
+      indexedGroup = aGroup;
+      index->push_back((aGroup >> 32) & 0xffff);
+      index->push_back(static_cast<int32_t>(aGroup & 0xffffffff));
+      index->push_back(edmHits->size());
+    };
+    auto createHit = [&](uint64_t aCellID, int aTrackId, int aPdg, double aEnergy, double aTime, double aX, double aY,
+                         double aZ) {
+      edm4hep::SimCalorimeterHit edmHit = edmHits->create();
+      edmHit.setCellID(aCellID);
+      edmHit.setEnergy(aEnergy * sim::g42edm::energy);
+      if (!m_energyOnly) {
+        edmHit.setPosition({
+                     (float) aX * (float) sim::g42edm::length,
+                     (float) aY * (float) sim::g42edm::length,
+                     (float) aZ * (float) sim::g42edm::length,
+        });
+      }
+      if (saveContributions) {
+        auto contribution = edmContributions->create();
+        contribution.setPDG(aPdg);
+        contribution.setEnergy(aEnergy * sim::g42edm::energy);
+        contribution.setTime(aTime);
+        if (!m_energyOnly) {
+          contribution.setStepPosition({(float) (aX * sim::g42edm::length), (float) (aY * sim::g42edm::length),
+                                        (float) (aZ * sim::g42edm::length)});
+        }
+        const int particleIndex = particles != nullptr ? evtinfo->particleIndex(aTrackId) : -1;
+        if (particleIndex >= 0) contribution.setParticle((*particles)[particleIndex]);
+        edmHit.addToContributions(contribution);
+      }
+    };
+    // energy below which the deposits of the current collection are thinned (0: not thinned)
+    double thinningThreshold = 0;
+    size_t numThinned = 0;
+    // deposit of a hit, or of the arrays of a hit buffer
+    auto addDeposit = [&](uint64_t aCellID, int aTrackId, int aPdg, double aEnergy, double aTime, double aX, double aY,
+                          double aZ, double aWeight, double aEnergyThreshold) {
+      if (m_maxTime > 0 && aTime > m_maxTime) return;
+      // time slice of the deposit, those outside of the slices are not saved
+      int slice = 0;
+      if (sliced) {
+        auto edge = std::upper_bound(sliceEdges.begin(), sliceEdges.end(), aTime);
+        if (edge == sliceEdges.begin() || edge == sliceEdges.end()) return;
+        slice = edge - sliceEdges.begin() - 1;
+      }
+      if (m_trackWeights) aEnergy *= aWeight;
+      if (m_aggregateCells) {
+        auto cell = m_cellIndices[slice].emplace(aCellID, m_cells.size());
+        if (cell.second) {
+          m_cells.push_back({aCellID, 0, 0, 0, 0, aEnergyThreshold, slice});
+          if (m_sortByCellID) m_sortGroups.push_back(sortGroup(aCellID, slice));
+        }
+        CellSum& sum = m_cells[cell.first->second];
+        sum.energy += aEnergy;
+        sum.x += aEnergy * aX;
+        sum.y += aEnergy * aY;
+        sum.z += aEnergy * aZ;
+        if (saveContributions) {
+          const uint32_t key = byTrack ? aTrackId : aPdg;
+          auto contribution = m_contributionIndex.emplace((uint64_t(cell.first->second) << 32) | key,
+                                                          m_cellContributions.size());
+          if (contribution.second) {
+            m_cellContributions.push_back({cell.first->second, aTrackId, aPdg, 0, aTime, 0, 0, 0});
+          }
+          ContributionSum& contributionSum = m_cellContributions[contribution.first->second];
+          contributionSum.energy += aEnergy;
+          contributionSum.time = std::min(contributionSum.time, aTime);
+          contributionSum.x += aEnergy * aX;
+          contributionSum.y += aEnergy * aY;
+          contributionSum.z += aEnergy * aZ;
+        }
+        return;
+      }
+      if (aEnergy < aEnergyThreshold) return;
+      if (m_sortByCellID || thinningThreshold > 0 || sliced) {
+        m_deposits.push_back({aCellID, aTrackId, aPdg, aEnergy, aTime, aX, aY, aZ, slice});
+        if (m_sortByCellID) m_sortGroups.push_back(sortGroup(aCellID, slice));
+        return;
+      }
+      createHit(aCellID, aTrackId, aPdg, aEnergy, aTime, aX, aY, aZ);
+    };
+    for (int iter_coll : m_collectionIDs.get(*collections, m_readoutNames)) {
+      G4VHitsCollection* g4collection = collections->GetHC(iter_coll);
+      auto threshold = m_energyThresholds.value().find(g4collection->GetName());
+      const double energyThreshold = threshold != m_energyThresholds.value().end() ? threshold->second : 0;
+      const size_t iReadout =
+          std::find(m_readoutNames.begin(), m_readoutNames.end(), g4collection->GetName()) - m_readoutNames.begin();
+      if (m_sortByCellID) {
+        readoutGroup = uint64_t(iReadout) << 32;
+        indexField = m_indexFields[iReadout];
+      }
+      auto thinning = m_thinningThresholds.value().find(g4collection->GetName());
+      thinningThreshold = thinning != m_thinningThresholds.value().end() ? thinning->second : 0;
+      const size_t firstDeposit = m_deposits.size();
+      // deposits written directly by the buffered sensitive detectors, converted without the hit objects
+      if (auto buffer = dynamic_cast<const sim::HitBuffer*>(g4collection)) {
+        const size_t n_deposit = buffer->size();
+        debug() << "\t" << n_deposit << " deposits are stored in a buffer #" << iter_coll << ": " << buffer->GetName()
                 << endmsg;
-        for (size_t iter_hit = 0; iter_hit < n_hit; iter_hit++) {
-          hit = dynamic_cast<k4::Geant4CaloHit*>(collect->GetHit(iter_hit));
-          edm4hep::SimCalorimeterHit edmHit = edmHits->create();
-          edmHit.setCellID(hit->cellID);
-          //todo
-          //edmHitCore.bits = hit->trackId;
-          edmHit.setEnergy(hit->energyDeposit * sim::g42edm::energy);
-          edmHit.setPosition({
-                       (float) hit->position.x() * (float) sim::g42edm::length,
-                       (float) hit->position.y() * (float) sim::g42edm::length,
-                       (float) hit->position.z() * (float) sim::g42edm::length,
-          });
+        if (m_energyOnly || !buffer->hasPositions()) {
+          for (size_t iter_hit = 0; iter_hit < n_deposit; iter_hit++) {
+            addDeposit(buffer->cellID[iter_hit], buffer->trackId[iter_hit], buffer->pdg[iter_hit],
+                       buffer->energy[iter_hit], buffer->time[iter_hit], 0, 0, 0, buffer->weightOf(iter_hit),
+                       energyThreshold);
+          }
+        } else {
+          for (size_t iter_hit = 0; iter_hit < n_deposit; iter_hit++) {
+            addDeposit(buffer->cellID[iter_hit], buffer->trackId[iter_hit], buffer->pdg[iter_hit],
+                       buffer->energy[iter_hit], buffer->time[iter_hit], buffer->x[iter_hit], buffer->y[iter_hit],
+                       buffer->z[iter_hit], buffer->weightOf(iter_hit), energyThreshold);
+          }
+        }
+        if (thinningThreshold > 0) numThinned += thin(firstDeposit, thinningThreshold, m_thinningMasks[iReadout]);
+        continue;
+      }
+      auto collect = dynamic_cast<G4THitsCollection<k4::Geant4CaloHit>*>(g4collection);
+      if (collect == nullptr) {
+        warning() << "Collection " << g4collection->GetName() << " does not contain calorimeter hits" << endmsg;
+        continue;
+      }
+      size_t n_hit = collect->GetSize();
+      debug() << "\t" << n_hit << " hits are stored in a collection #" << iter_coll << ": " << collect->GetName()
+              << endmsg;
+      if (m_trackWeights && !m_warnedUnweighted) {
+        warning() << "The hits of " << collect->GetName() << " carry no track weight, they are saved with weight 1 "
+                  << "(the weights are recorded by the buffered sensitive detectors)" << endmsg;
+        m_warnedUnweighted = true;
+      }
+      for (size_t iter_hit = 0; iter_hit < n_hit; iter_hit++) {
+        hit = (*collect)[iter_hit];
+        if (m_energyOnly) {
+          addDeposit(hit->cellID, static_cast<int>(hit->trackId), hit->pdgId, hit->energyDeposit, hit->time, 0, 0, 0, 1,
+                     energyThreshold);
+          continue;
         }
+        addDeposit(hit->cellID, static_cast<int>(hit->trackId), hit->pdgId, hit->energyDeposit, hit->time,
+                   hit->position.x(), hit->position.y(), hit->position.z(), 1, energyThreshold);
+      }
+      if (thinningThreshold > 0) numThinned += thin(firstDeposit, thinningThreshold, m_thinningMasks[iReadout]);
+    }
+    if (numThinned > 0) {
+      debug() << "\t" << numThinned << " deposits removed by the thinning" << endmsg;
+    }
+    // order of the written cells, or deposits if they are not aggregated
+    const std::vector<uint32_t>* order = nullptr;
+    if (m_sortByCellID) {
+      m_sortCellIDs.clear();
+      if (m_aggregateCells) {
+        for (const CellSum& cell : m_cells) m_sortCellIDs.push_back(cell.cellID);
+      } else {
+        for (const Deposit& deposit : m_deposits) m_sortCellIDs.push_back(deposit.cellID);
+      }
+      m_sort.sort(m_sortGroups, m_sortCellIDs);
+      order = &m_sort.order();
+    } else if (sliced) {
+      // grouped by slice (counting sort), in the order of the hits within each slice
+      std::vector<size_t> firsts(m_cellIndices.size() + 1, 0);
+      const size_t numHits = m_aggregateCells ? m_cells.size() : m_deposits.size();
+      for (size_t iHit = 0; iHit < numHits; ++iHit) {
+        ++firsts[(m_aggregateCells ? m_cells[iHit].slice : m_deposits[iHit].slice) + 1];
       }
+      for (size_t iSlice = 1; iSlice < firsts.size(); ++iSlice) firsts[iSlice] += firsts[iSlice - 1];
+      m_sliceOrder.resize(numHits);
+      for (size_t iHit = 0; iHit < numHits; ++iHit) {
+        m_sliceOrder[firsts[m_aggregateCells ? m_cells[iHit].slice : m_deposits[iHit].slice]++] = iHit;
+      }
+      order = &m_sliceOrder;
+    }
+    for (size_t iSorted = 0; iSorted < m_deposits.size(); ++iSorted) {
+      const size_t iDeposit = order != nullptr ? (*order)[iSorted] : iSorted;
+      const Deposit& deposit = m_deposits[iDeposit];
+      if (m_sortByCellID) indexHit(m_sortGroups[iDeposit]);
+      createHit(deposit.cellID, deposit.trackId, deposit.pdg, deposit.energy, deposit.time, deposit.x, deposit.y,
+                deposit.z);
+      ++m_sliceCounts[deposit.slice];
+    }
+    // index of the EDM hits of the cells (-1 if below the threshold)
+    std::vector<int> cellHits(saveContributions ? m_cells.size() : 0, -1);
+    for (size_t iSorted = 0; iSorted < m_cells.size(); ++iSorted) {
+      const size_t iCell = order != nullptr ? (*order)[iSorted] : iSorted;
+      const CellSum& cell = m_cells[iCell];
+      if (cell.energy < cell.threshold) continue;
+      if (m_sortByCellID) indexHit(m_sortGroups[iCell]);
+      ++m_sliceCounts[cell.slice];
+      edm4hep::SimCalorimeterHit edmHit = edmHits->create();
+      edmHit.setCellID(cell.cellID);
+      edmHit.setEnergy(cell.energy * sim::g42edm::energy);
+      // cells without energy keep no position
+      const double weight = cell.energy > 0 ? sim::g42edm::length / cell.energy : 0;
+      if (!m_energyOnly) {
+        edmHit.setPosition({(float) (cell.x * weight), (float) (cell.y * weight), (float) (cell.z * weight)});
+      }
+      if (saveContributions) cellHits[iCell] = edmHits->size() - 1;
+    }
+    for (const auto& sum : m_cellContributions) {
+      if (cellHits[sum.cell] < 0) continue;
+      auto contribution = edmContributions->create();
+      contribution.setPDG(sum.pdg);
+      contribution.setEnergy(sum.energy * sim::g42edm::energy);
+      contribution.setTime(sum.time);
+      const double weight = sum.energy > 0 ? sim::g42edm::length / sum.energy : 0;
+      if (!m_energyOnly) {
+        contribution.setStepPosition({(float) (sum.x * weight), (float) (sum.y * weight), (float) (sum.z * weight)});
+      }
+      // contributions grouped by type are not linked to a particle
+      const int particleIndex = particles != nullptr ? evtinfo->particleIndex(sum.trackId) : -1;
+      if (particleIndex >= 0) contribution.setParticle((*particles)[particleIndex]);
+      (*edmHits)[cellHits[sum.cell]].addToContributions(contribution);
+    }
+    if (m_aggregateCells) {
+      debug() << "\t hits merged into " << m_cells.size() << " cells" << endmsg;
+    }
+    if (slices != nullptr) {
+      int first = 0;
+      for (size_t count : m_sliceCounts) {
+        slices->push_back(first);
+        first += count;
+      }
+      slices->push_back(first);
     }
   }
   return StatusCode::SUCCESS;
 }
+
+StatusCode SimG4SaveCalHits::putOutput() {
+  if (m_pendingHits == nullptr) return StatusCode::SUCCESS;
+  // collections written to the output stream are not put in the event store
+  if (!m_outputStream.value().empty()) {
+    if (sim::writeBlock(*m_streamSvc, m_outputStream, m_caloHits.objKey(), sim::caloHitsBlock(*m_pendingHits))
+            .isFailure()) {
+      return StatusCode::FAILURE;
+    }
+    if (m_pendingContributions != nullptr &&
+        sim::writeBlock(*m_streamSvc, m_outputStream, m_contributions.objKey(),
+                        sim::contributionsBlock(*m_pendingContributions))
+            .isFailure()) {
+      return StatusCode::FAILURE;
+    }
+    if (m_pendingIndex != nullptr &&
+        sim::writeBlock(*m_streamSvc, m_outputStream, m_index.objKey(), sim::userDataBlock(*m_pendingIndex))
+            .isFailure()) {
+      return StatusCode::FAILURE;
+    }
+    if (m_pendingSlices != nullptr &&
+        sim::writeBlock(*m_streamSvc, m_outputStream, m_slices.objKey(), sim::userDataBlock(*m_pendingSlices))
+            .isFailure()) {
+      return StatusCode::FAILURE;
+    }
+    m_pendingHits.reset();
+    m_pendingContributions.reset();
+    m_pendingIndex.reset();
+    m_pendingSlices.reset();
+    return StatusCode::SUCCESS;
+  }
+  m_caloHits.put(m_pendingHits.release());
+  if (m_pendingContributions != nullptr) m_contributions.put(m_pendingContributions.release());
+  if (m_pendingIndex != nullptr) m_index.put(m_pendingIndex.release());
+  if (m_pendingSlices != nullptr) m_slices.put(m_pendingSlices.release());
+  return StatusCode::SUCCESS;
+}
+
+size_t SimG4SaveCalHits::thin(size_t aFirst, double aThreshold, uint64_t aMask) {
+  m_thinningGroups.clear();
+  m_thinningIndex.clear();
+  m_depositGroups.assign(m_deposits.size() - aFirst, -1);
+  m_keptDeposits.assign(m_deposits.size() - aFirst, 1);
+  for (size_t iDeposit = aFirst; iDeposit < m_deposits.size(); ++iDeposit) {
+    const Deposit& deposit = m_deposits[iDeposit];
+    if (deposit.energy >= aThreshold) continue;
+    auto group = m_thinningIndex.emplace(deposit.cellID & aMask, m_thinningGroups.size());
+    if (group.second) m_thinningGroups.push_back({0, 0, 0, 0, 0, 0, 0, 0, iDeposit});
+    ThinningGroup& sum = m_thinningGroups[group.first->second];
+    sum.energy += deposit.energy;
+    sum.x += deposit.energy * deposit.x;
+    sum.y += deposit.energy * deposit.y;
+    sum.z += deposit.energy * deposit.z;
+    if (deposit.energy > m_deposits[sum.largest].energy) sum.largest = iDeposit;
+    const bool kept = G4UniformRand() < m_thinningFraction;
+    m_depositGroups[iDeposit - aFirst] = group.first->second;
+    m_keptDeposits[iDeposit - aFirst] = kept;
+    if (kept) {
+      sum.keptEnergy += deposit.energy;
+      sum.keptX += deposit.energy * deposit.x;
+      sum.keptY += deposit.energy * deposit.y;
+      sum.keptZ += deposit.energy * deposit.z;
+    }
+  }
+  // groups of which no deposit with energy was kept keep their largest one
+  for (ThinningGroup& sum : m_thinningGroups) {
+    if (sum.keptEnergy > 0) continue;
+    const Deposit& largest = m_deposits[sum.largest];
+    m_keptDeposits[sum.largest - aFirst] = 1;
+    sum.keptEnergy = largest.energy;
+    sum.keptX = largest.energy * largest.x;
+    sum.keptY = largest.energy * largest.y;
+    sum.keptZ = largest.energy * largest.z;
+  }
+  // the scaling keeps the energy-weighted position of the kept deposits, the shift moves it to the one of the group
+  size_t kept = aFirst;
+  for (size_t iDeposit = aFirst; iDeposit < m_deposits.size(); ++iDeposit) {
+    if (!m_keptDeposits[iDeposit - aFirst]) continue;
+    Deposit deposit = m_deposits[iDeposit];
+    const int iGroup = m_depositGroups[iDeposit - aFirst];
+    if (iGroup >= 0) {
+      const ThinningGroup& sum = m_thinningGroups[iGroup];
+      if (sum.energy > 0 && sum.keptEnergy > 0) {
+        deposit.x += sum.x / sum.energy - sum.keptX / sum.keptEnergy;
+        deposit.y += sum.y / sum.energy - sum.keptY / sum.keptEnergy;
+        deposit.z += sum.z / sum.energy - sum.keptZ / sum.keptEnergy;
+        deposit.energy *= sum.energy / sum.keptEnergy;
+      }
+    }
+    if (m_sortByCellID) m_sortGroups[kept] = m_sortGroups[iDeposit];
+    m_deposits[kept++] = deposit;
+  }
+  const size_t removed = m_deposits.size() - kept;
+  m_deposits.resize(kept);
+  if (m_sortByCellID) m_sortGroups.resize(kept);
+  return removed;
+}
@@ -6,11 +6,32 @@
 
 // FCCSW
 #include "k4FWCore/DataHandle.h"
+#include "SimG4Common/CellSort.h"
+#include "SimG4Common/HitsCollectionIDs.h"
+#include "SimG4Interface/ISimG4OutputStreamSvc.h"
 #include "SimG4Interface/ISimG4SaveOutputTool.h"
 class IGeoSvc;
 
+// podio
+#include "podio/UserDataCollection.h"
+
+// DD4hep
+namespace dd4hep {
+namespace DDSegmentation {
+class BitFieldElement;
+}
+}
+
+// STL
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 // datamodel
 namespace edm4hep {
+class CaloHitContributionCollection;
 class SimCalorimeterHitCollection;
 }
 
@@ -21,6 +42,36 @@ class SimCalorimeterHitCollection;
  *  Readout name is defined in DD4hep XML file as the attribute 'readout' of 'detector' tag.
  *  If (\b'readoutNames') contain no elements or names that do not correspond to any hit collection,
  *  tool will fail at initialization.
+ *  If \b'aggregateCells' is set, the hits with the same cellID are merged into one EDM hit, with the summed energy and
+ *  the energy-weighted position.
+ *  Hits (or cells, if aggregated) below the energy threshold of their readout (\b'energyThresholds') and hits created
+ *  after \b'maxTime' are not saved.
+ *  If \b'contributions' is set to "track" or "pdg", the MC contributions to the hits are saved too, one per track
+ *  (linked to the particle of the history if it was saved) or one per particle type in each cell.
+ *  The buffers of the buffered sensitive detectors (sim::HitBuffer) are converted in bulk from their arrays.
+ *  If \b'sortByCellID' is set, the hits are written sorted by readout (in the order of \b'readoutNames'), by the value
+ *  of the field \b'indexField' of the cellID (if set) and by cellID. With \b'indexField', the offsets of the ranges of
+ *  hits are written to \b'CaloHitsIndex': for each range, the index of its readout, the value of the field and the
+ *  index of its first hit.
+ *  If \b'trackWeights' is set, the energies are multiplied by the weights of the tracks changed by the biasing (e.g.
+ *  SimG4ImportanceBiasingRegion), as recorded in the buffers by the sensitive detectors at the time of the deposits.
+ *  The hit objects carry no weight and are saved with weight 1.
+ *  Deposits below the thinning energy of their readout (\b'thinningThresholds') are thinned if the cells are not
+ *  aggregated: a random fraction \b'thinningFraction' of them is kept, and in each group of cells (same values of the
+ *  fields \b'thinningFields' of the cellID, or same cell if empty) the energies of the kept deposits are scaled and
+ *  their positions shifted so that the summed energy and the energy-weighted position of the thinned deposits of the
+ *  group are preserved. At least the largest thinned deposit of each group is kept.
+ *  If \b'timeSlices' is set (the edges of the slices, increasing), the deposits are split by the slice of their time
+ *  (those outside of the slices are not saved): the cells are aggregated per slice, the hits are written grouped by
+ *  slice (then sorted within the slice if \b'sortByCellID' is set), and the index of the first hit of each slice,
+ *  followed by the number of hits, is written to \b'CaloHitsSlices'.
+ *  If \b'energyOnly' is set, the positions of the deposits are not converted: the hits (and the contributions) keep
+ *  only the cellID, the energy and the time, positions being left at the origin. The buffers without positions (of the
+ *  sensitive detector BufferedEnergyCalorimeterSD) are converted in any mode as in this one.
+ *  If \b'outputStream' is set, the collections are written to this stream of SimG4OutputStreamSvc (e.g. a file of the
+ *  sub-detector), with the names of their handles, instead of the event store.
+ *  Unless the deposits are thinned, the hits may be filled in a parallel task of SimG4Alg (\b'concurrentOutputs'), the
+ *  collections being put in the store (or written to the stream) afterwards on the thread of the algorithm.
  *  [For more information please see](@ref md_sim_doc_geant4fullsim).
  *
  *  @author Anna Zaborowska
@@ -44,15 +95,156 @@ public:
    *   @return status code
    */
   virtual StatusCode saveOutput(const G4Event& aEvent) final;
+  /**  Whether the output may be filled concurrently with the other tools (unless the deposits are thinned).
+   *   @return true if fillOutput() may run in a parallel task
+   */
+  virtual bool fillsConcurrently() const final;
+  /**  Fill the calorimeter hits of the event in the collections of the tool, without accessing the event store.
+   *   @param[in] aEvent Event with data to save.
+   *   @return status code
+   */
+  virtual StatusCode fillOutput(const G4Event& aEvent) final;
+  /**  Put the collections filled by fillOutput() in the event store, or write them to the output stream.
+   *   @return status code
+   */
+  virtual StatusCode putOutput() final;
 
 private:
   /// Pointer to the geometry service
   ServiceHandle<IGeoSvc> m_geoSvc;
+  /// Pointer to the service of the output streams (used if outputStream is set)
+  ServiceHandle<ISimG4OutputStreamSvc> m_streamSvc;
+  /// Name of the output stream of the collections (event store if empty)
+  Gaudi::Property<std::string> m_outputStream{this, "outputStream", "",
+                                              "Output stream of SimG4OutputStreamSvc (event store if empty)"};
   /// Handle for calo hits
   DataHandle<edm4hep::SimCalorimeterHitCollection> m_caloHits{"CaloHits", Gaudi::DataHandle::Writer, this};
+  /// Handle for the MC contributions to the calo hits
+  DataHandle<edm4hep::CaloHitContributionCollection> m_contributions{"CaloHitContributions",
+                                                                      Gaudi::DataHandle::Writer, this};
+  /// Handle for the offsets of the ranges of sorted hits (readout index, value of the indexed field, first hit)
+  DataHandle<podio::UserDataCollection<int>> m_index{"CaloHitsIndex", Gaudi::DataHandle::Writer, this};
+  /// Handle for the offsets of the time slices of the hits (first hit of each slice and number of hits)
+  DataHandle<podio::UserDataCollection<int>> m_slices{"CaloHitsSlices", Gaudi::DataHandle::Writer, this};
+  /// Collections filled by fillOutput(), until they are put by putOutput()
+  std::unique_ptr<edm4hep::SimCalorimeterHitCollection> m_pendingHits;
+  std::unique_ptr<edm4hep::CaloHitContributionCollection> m_pendingContributions;
+  std::unique_ptr<podio::UserDataCollection<int>> m_pendingIndex;
+  std::unique_ptr<podio::UserDataCollection<int>> m_pendingSlices;
   /// Name of the readouts (hits collections) to save
   Gaudi::Property<std::vector<std::string>> m_readoutNames{
       this, "readoutNames", {}, "Name of the readouts (hits collections) to save"};
+  /// Indices of the saved collections in the events
+  sim::HitsCollectionIDs m_collectionIDs;
+  /// Flag whether hits in the same cell should be merged
+  Gaudi::Property<bool> m_aggregateCells{this, "aggregateCells", false,
+                                         "Merge the hits with the same cellID (sum of energy, energy-weighted position)"};
+  /// Energy thresholds of the saved hits, by readout
+  Gaudi::Property<std::map<std::string, double>> m_energyThresholds{
+      this, "energyThresholds", {}, "Energy thresholds of the saved hits (or cells) by readout name"};
+  /// Time after which the hits are not saved (0: no limit)
+  Gaudi::Property<double> m_maxTime{this, "maxTime", 0, "Time after which hits are not saved (0: no limit)"};
+  /// Granularity of the MC contributions: "" (not saved), "track" or "pdg"
+  Gaudi::Property<std::string> m_contributionsMode{
+      this, "contributions", "", "Save MC contributions grouped by cell and \"track\" or \"pdg\" (empty: not saved)"};
+  /// Flag whether the hits are written sorted by cellID
+  Gaudi::Property<bool> m_sortByCellID{this, "sortByCellID", false,
+                                       "Write the hits sorted by readout, value of the indexField and cellID"};
+  /// Field of the cellID whose ranges of hits are indexed (no index if empty)
+  Gaudi::Property<std::string> m_indexField{
+      this, "indexField", "", "Field of the cellID (e.g. system or layer) whose ranges of sorted hits are indexed"};
+  /// Flag whether the energies are weighted by the weights of the biased tracks
+  Gaudi::Property<bool> m_trackWeights{this, "trackWeights", false,
+                                       "Multiply the energies by the weights of the biased tracks"};
+  /// Flag whether the hit objects without weight were reported (once per job)
+  bool m_warnedUnweighted = false;
+  /// Edges of the time slices of the hits (not sliced if empty)
+  Gaudi::Property<std::vector<double>> m_timeSlices{
+      this, "timeSlices", {}, "Edges of the time slices in which the hits are split (increasing, not sliced if empty)"};
+  /// Flag whether only the cellID, energy and time of the hits are saved
+  Gaudi::Property<bool> m_energyOnly{this, "energyOnly", false,
+                                     "Save only the cellID, energy and time of the hits, without their positions"};
+  /// Energies below which the deposits are thinned, by readout
+  Gaudi::Property<std::map<std::string, double>> m_thinningThresholds{
+      this, "thinningThresholds", {}, "Energies below which the deposits are thinned by readout name"};
+  /// Fraction of the thinned deposits that is kept
+  Gaudi::Property<double> m_thinningFraction{this, "thinningFraction", 0.1,
+                                             "Fraction of the deposits below the thinning energy that is kept"};
+  /// Fields of the cellID defining the groups of cells whose energy and position are preserved (cell if empty)
+  Gaudi::Property<std::vector<std::string>> m_thinningFields{
+      this, "thinningFields", {}, "Fields of the cellID of the groups preserved by the thinning (same cell if empty)"};
+  /// Indexed field of each readout (in the order of m_readoutNames)
+  std::vector<const dd4hep::DDSegmentation::BitFieldElement*> m_indexFields;
+  /// Mask of the thinning groups of each readout (in the order of m_readoutNames)
+  std::vector<uint64_t> m_thinningMasks;
+  /**  Thin the deposits of a collection.
+   *   @param[in] aFirst index of the first deposit of the collection in m_deposits
+   *   @param[in] aThreshold energy below which the deposits are thinned
+   *   @param[in] aMask mask of the cellID defining the thinning groups
+   *   @return number of the removed deposits
+   */
+  size_t thin(size_t aFirst, double aThreshold, uint64_t aMask);
+  /// Sums of the thinned deposits of a group of cells
+  struct ThinningGroup {
+    double energy, x, y, z;
+    double keptEnergy, keptX, keptY, keptZ;
+    /// largest deposit of the group, kept if no other one is
+    size_t largest;
+  };
+  /// Thinning groups of the collection, with their index by masked cellID (reused between events)
+  std::vector<ThinningGroup> m_thinningGroups;
+  std::unordered_map<uint64_t, size_t> m_thinningIndex;
+  /// Group of each deposit of the collection (-1 if not thinned) and decision to keep it (reused between events)
+  std::vector<int> m_depositGroups;
+  std::vector<char> m_keptDeposits;
+  /// Sort of the hits (buffers reused between events)
+  sim::CellSort m_sort;
+  /// Sorting groups (readout index and value of the indexed field) and cellIDs of the sorted hits
+  std::vector<uint64_t> m_sortGroups;
+  std::vector<uint64_t> m_sortCellIDs;
+  /// Deposit kept to be written sorted (if the cells are not aggregated)
+  struct Deposit {
+    uint64_t cellID;
+    int trackId;
+    int pdg;
+    double energy;
+    double time;
+    double x, y, z;
+    /// time slice (0 if not sliced)
+    int slice;
+  };
+  /// Deposits of the event, in the order of the hits (reused between events)
+  std::vector<Deposit> m_deposits;
+  /// Sum of the hits of a track (or of a particle type) in a cell
+  struct ContributionSum {
+    size_t cell;
+    int trackId;
+    int pdg;
+    double energy;
+    double time;
+    double x, y, z;
+  };
+  /// Contributions of the event (reused between events)
+  std::vector<ContributionSum> m_cellContributions;
+  /// Index of the contributions in m_cellContributions by cell index and track ID (or PDG code)
+  std::unordered_map<uint64_t, size_t> m_contributionIndex;
+  /// Sum of the hits in a cell
+  struct CellSum {
+    uint64_t cellID;
+    double energy;
+    double x, y, z;
+    /// energy threshold of the readout
+    double threshold;
+    /// time slice (0 if not sliced)
+    int slice;
+  };
+  /// Cells of the event, in the order of their first hit (reused between events)
+  std::vector<CellSum> m_cells;
+  /// Index of the cells in m_cells by cellID, one per time slice (reused between events)
+  std::vector<std::unordered_map<uint64_t, size_t>> m_cellIndices;
+  /// Order of the hits grouped by time slice if they are not sorted, and number of hits of each slice
+  std::vector<uint32_t> m_sliceOrder;
+  std::vector<size_t> m_sliceCounts;
 };
 
 #endif /* SIMG4COMPONENTS_G4SAVECALHITS_H */
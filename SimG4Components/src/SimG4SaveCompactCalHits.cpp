@@ -0,0 +1,116 @@
+#include "SimG4SaveCompactCalHits.h"
+
+// FCCSW
+#include "SimG4Common/Geant4CaloHit.h"
+#include "SimG4Common/HitBuffer.h"
+#include "SimG4Interface/IGeoSvc.h"
+#include "SimG4Common/Units.h"
+
+// Geant4
+#include "G4Event.hh"
+#include "G4THitsCollection.hh"
+
+// DD4hep
+#include "DD4hep/Detector.h"
+
+// STL
+#include <cmath>
+#include <limits>
+
+DECLARE_COMPONENT(SimG4SaveCompactCalHits)
+
+SimG4SaveCompactCalHits::SimG4SaveCompactCalHits(const std::string& aType, const std::string& aName,
+                                                 const IInterface* aParent)
+    : GaudiTool(aType, aName, aParent), m_geoSvc("GeoSvc", aName) {
+  declareInterface<ISimG4SaveOutputTool>(this);
+  declareProperty("CellIDs", m_cellIDs, "Handle for the cellIDs of the cells");
+  declareProperty("Energies", m_energies, "Handle for the quantised energies of the cells");
+  declareProperty("Times", m_times, "Handle for the times of the cells");
+  declareProperty("Encoding", m_encoding, "Handle for the parameters of the encoding of the energy");
+  declareProperty("GeoSvc", m_geoSvc);
+}
+
+SimG4SaveCompactCalHits::~SimG4SaveCompactCalHits() {}
+
+StatusCode SimG4SaveCompactCalHits::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (!m_geoSvc) {
+    error() << "Unable to locate Geometry Service. "
+            << "Make sure you have GeoSvc and SimSvc in the right order in the configuration." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  auto allReadouts = m_geoSvc->lcdd()->readouts();
+  for (auto& readoutName : m_readoutNames) {
+    if (allReadouts.find(readoutName) == allReadouts.end()) {
+      error() << "Readout " << readoutName << " not found! Please check tool configuration." << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  if (m_minEnergy <= 0 || m_energyPrecision <= 0) {
+    error() << "Smallest saved energy and precision of the energy need to be positive" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_logRatio = std::log1p(2 * m_energyPrecision);
+  info() << "Energies of the cells saved from " << m_minEnergy / CLHEP::MeV << " MeV to "
+         << m_minEnergy * std::exp(m_logRatio * (std::numeric_limits<uint16_t>::max() - 1)) / CLHEP::MeV
+         << " MeV with a relative precision of " << m_energyPrecision.value() << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4SaveCompactCalHits::finalize() {
+  if (m_numSaturated > 0) {
+    warning() << m_numSaturated << " cells above the largest energy of the encoding, decrease energyPrecision"
+              << endmsg;
+  }
+  return GaudiTool::finalize();
+}
+
+StatusCode SimG4SaveCompactCalHits::saveOutput(const G4Event& aEvent) {
+  G4HCofThisEvent* collections = aEvent.GetHCofThisEvent();
+  if (collections == nullptr) {
+    return StatusCode::SUCCESS;
+  }
+  m_cells.clear();
+  for (int iter_coll : m_collectionIDs.get(*collections, m_readoutNames)) {
+    G4VHitsCollection* g4collection = collections->GetHC(iter_coll);
+    // deposits written directly by the buffered sensitive detectors, converted without the hit objects
+    if (auto buffer = dynamic_cast<const sim::HitBuffer*>(g4collection)) {
+      for (size_t iter_hit = 0; iter_hit < buffer->size(); iter_hit++) {
+        m_cells.add(buffer->cellID[iter_hit], buffer->energy[iter_hit], 0, 0, 0, buffer->time[iter_hit],
+                    buffer->trackId[iter_hit], buffer->pdg[iter_hit]);
+      }
+      continue;
+    }
+    auto collect = dynamic_cast<G4THitsCollection<k4::Geant4CaloHit>*>(g4collection);
+    if (collect == nullptr) {
+      warning() << "Collection " << g4collection->GetName() << " does not contain calorimeter hits" << endmsg;
+      continue;
+    }
+    for (size_t iter_hit = 0; iter_hit < collect->GetSize(); iter_hit++) {
+      const k4::Geant4CaloHit* hit = (*collect)[iter_hit];
+      m_cells.add(hit->cellID, hit->energyDeposit, 0, 0, 0, hit->time, hit->trackId, hit->pdgId);
+    }
+  }
+  auto cellIDs = m_cellIDs.createAndPut();
+  auto energies = m_energies.createAndPut();
+  auto times = m_times.createAndPut();
+  auto encoding = m_encoding.createAndPut();
+  encoding->push_back(m_minEnergy * sim::g42edm::energy);
+  encoding->push_back(std::exp(m_logRatio));
+  const double maxCode = std::numeric_limits<uint16_t>::max();
+  for (const auto& cell : m_cells.cells()) {
+    if (cell.energy < m_minEnergy) continue;
+    double code = 1 + std::round(std::log(cell.energy / m_minEnergy) / m_logRatio);
+    if (code > maxCode) {
+      code = maxCode;
+      ++m_numSaturated;
+    }
+    cellIDs->push_back(cell.cellID);
+    energies->push_back(static_cast<uint16_t>(code));
+    times->push_back(cell.time);
+  }
+  debug() << "\t" << cellIDs->size() << " cells saved in the compact format" << endmsg;
+  return StatusCode::SUCCESS;
+}
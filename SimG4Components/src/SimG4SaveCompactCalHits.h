@@ -0,0 +1,86 @@
+#ifndef SIMG4COMPONENTS_G4SAVECOMPACTCALHITS_H
+#define SIMG4COMPONENTS_G4SAVECOMPACTCALHITS_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+#include "SimG4Common/CellSums.h"
+#include "SimG4Common/HitsCollectionIDs.h"
+#include "SimG4Interface/ISimG4SaveOutputTool.h"
+class IGeoSvc;
+
+// Geant4
+#include "G4SystemOfUnits.hh"
+
+// podio
+#include "podio/UserDataCollection.h"
+
+// STL
+#include <atomic>
+#include <cstdint>
+
+/** @class SimG4SaveCompactCalHits SimG4Components/src/SimG4SaveCompactCalHits.h SimG4SaveCompactCalHits.h
+ *
+ *  Save calorimeter hits tool writing a compact, lossy format instead of edm4hep::SimCalorimeterHit: the hits of the
+ *  collections \b'readoutNames' are summed per cell, and each cell is stored without its position (which can be
+ *  computed from the cellID and the segmentation by ExpandCompactCalHits) as its cellID (\b'CellIDs'), its energy
+ *  quantised on a logarithmic scale in 16 bits (\b'Energies') and the time of its earliest deposit (\b'Times').
+ *  The energy \f$E \ge E_{min}\f$ (\b'minEnergy') is stored as the code \f$1 + round(\ln(E / E_{min}) / \ln r)\f$
+ *  with \f$r = 1 + 2 p\f$, so that its relative error is at most \b'energyPrecision' \f$p\f$; cells below
+ *  \f$E_{min}\f$ are not saved, cells above the largest code are stored with it (and counted).
+ *  The parameters of the encoding (\f$E_{min}\f$ in GeV and \f$r\f$) are saved in each event (\b'Encoding').
+ */
+
+class SimG4SaveCompactCalHits : public GaudiTool, virtual public ISimG4SaveOutputTool {
+public:
+  explicit SimG4SaveCompactCalHits(const std::string& aType, const std::string& aName, const IInterface* aParent);
+  virtual ~SimG4SaveCompactCalHits();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize();
+  /**  Finalize.
+   *   @return status code
+   */
+  virtual StatusCode finalize();
+  /**  Save the data output.
+   *   Saves the cells of the collections as specified in the job options in \b'readoutNames'.
+   *   @param[in] aEvent Event with data to save.
+   *   @return status code
+   */
+  virtual StatusCode saveOutput(const G4Event& aEvent) final;
+
+private:
+  /// Pointer to the geometry service
+  ServiceHandle<IGeoSvc> m_geoSvc;
+  /// Handle for the cellIDs of the cells
+  DataHandle<podio::UserDataCollection<uint64_t>> m_cellIDs{"CompactCaloHitCellIDs", Gaudi::DataHandle::Writer, this};
+  /// Handle for the quantised energies of the cells
+  DataHandle<podio::UserDataCollection<uint16_t>> m_energies{"CompactCaloHitEnergies", Gaudi::DataHandle::Writer,
+                                                              this};
+  /// Handle for the times of the cells
+  DataHandle<podio::UserDataCollection<float>> m_times{"CompactCaloHitTimes", Gaudi::DataHandle::Writer, this};
+  /// Handle for the parameters of the encoding of the energy
+  DataHandle<podio::UserDataCollection<double>> m_encoding{"CompactCaloHitEncoding", Gaudi::DataHandle::Writer,
+                                                            this};
+  /// Name of the readouts (hits collections) to save
+  Gaudi::Property<std::vector<std::string>> m_readoutNames{
+      this, "readoutNames", {}, "Name of the readouts (hits collections) to save"};
+  /// Smallest saved energy of a cell
+  Gaudi::Property<double> m_minEnergy{this, "minEnergy", 1 * CLHEP::keV, "Smallest saved energy of a cell"};
+  /// Maximal relative error of the quantised energy
+  Gaudi::Property<double> m_energyPrecision{this, "energyPrecision", 1e-3,
+                                            "Maximal relative error of the quantised energy"};
+  /// Indices of the saved collections in the events
+  sim::HitsCollectionIDs m_collectionIDs;
+  /// Sums of the hits per cell (reused between events)
+  sim::CellSums m_cells;
+  /// Logarithm of the ratio between the energies of consecutive codes
+  double m_logRatio = 0;
+  /// Number of cells above the largest code
+  std::atomic<unsigned long> m_numSaturated{0};
+};
+
+#endif /* SIMG4COMPONENTS_G4SAVECOMPACTCALHITS_H */
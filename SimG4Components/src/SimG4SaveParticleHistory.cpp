@@ -3,6 +3,7 @@
 // FCCSW
 #include "SimG4Common/ParticleInformation.h"
 #include "SimG4Common/Units.h"
+#include "StreamBlocks.h"
 
 // Geant4
 #include "G4Event.hh"
@@ -13,22 +14,54 @@
 // datamodel
 #include "edm4hep/MCParticleCollection.h"
 
+// STL
+#include <memory>
+
 DECLARE_COMPONENT(SimG4SaveParticleHistory)
 
 SimG4SaveParticleHistory::SimG4SaveParticleHistory(const std::string& aType, const std::string& aName,
                                                    const IInterface* aParent)
-    : GaudiTool(aType, aName, aParent) {
+    : GaudiTool(aType, aName, aParent), m_streamSvc("SimG4OutputStreamSvc", aName) {
   declareInterface<ISimG4SaveOutputTool>(this);
   declareProperty("GenParticles", m_mcParticles, "Handle to the secondary particles");
+  declareProperty("OutputStreamSvc", m_streamSvc);
+}
+
+StatusCode SimG4SaveParticleHistory::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (!m_outputStream.value().empty() && (!m_streamSvc || !m_streamSvc->hasStream(m_outputStream))) {
+    error() << "Output stream " << m_outputStream.value() << " is not configured in SimG4OutputStreamSvc" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
 }
 
 
 StatusCode SimG4SaveParticleHistory::saveOutput(const G4Event& aEvent) {
   auto evtinfo = dynamic_cast<sim::EventInformation*>(aEvent.GetUserInformation());
-  // take over ownership of particle and vertex collections
-  evtinfo->setCollections(m_mcParticleColl);
-  info() << "Saved " << m_mcParticleColl->size() << " particles from Geant4 history." << endmsg;
-  m_mcParticles.put(m_mcParticleColl);
+  if (evtinfo == nullptr) {
+    error() << "No particle history in the event, the user action ParticleHistoryEventAction is needed" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  // take over ownership of the particle collection, linked to the parents
+  std::unique_ptr<edm4hep::MCParticleCollection> particles = evtinfo->releaseParticles();
+  if (particles == nullptr) {
+    error() << "Particle history of the event was already saved" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_denseTrackIds) {
+    // the same index as the quality of the tracker hits saved with denseTrackIds
+    for (size_t iParticle = 0; iParticle < particles->size(); ++iParticle) {
+      (*particles)[iParticle].setSimulatorStatus(iParticle);
+    }
+  }
+  info() << "Saved " << particles->size() << " particles from Geant4 history." << endmsg;
+  if (!m_outputStream.value().empty()) {
+    return sim::writeBlock(*m_streamSvc, m_outputStream, m_mcParticles.objKey(), sim::particlesBlock(*particles));
+  }
+  m_mcParticles.put(particles.release());
 
   return StatusCode::SUCCESS;
 }
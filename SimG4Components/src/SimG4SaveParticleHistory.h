@@ -7,6 +7,7 @@
 // FCCSW
 #include "k4FWCore/DataHandle.h"
 #include "SimG4Common/EventInformation.h"
+#include "SimG4Interface/ISimG4OutputStreamSvc.h"
 #include "SimG4Interface/ISimG4SaveOutputTool.h"
 
 class IGeoSvc;
@@ -22,7 +23,10 @@ class EventInformation;
 
 /** @class SimG4SaveParticleHistory SimG4Components/src/SimG4SaveParticleHistory.h SimG4SaveParticleHistory.h
  *
- *  This tool allows to save the particle history of particles decaying during the simulation
+ *  This tool allows to save the particle history of particles decaying during the simulation.
+ *  The saved particles are linked to their parents and daughters (the links to the primary particles are not set).
+ *  If \b'outputStream' is set, the particles are written to this stream of SimG4OutputStreamSvc, with the name of
+ *  their handle, instead of the event store.
  *
  *  @author J. Lingemann
  *  @author V. Volkl
@@ -32,19 +36,30 @@ class SimG4SaveParticleHistory : public GaudiTool, virtual public ISimG4SaveOutp
 public:
   explicit SimG4SaveParticleHistory(const std::string& aType, const std::string& aName, const IInterface* aParent);
   virtual ~SimG4SaveParticleHistory() = default;
+  /**  Initialize.
+   *   @return status code
+   */
+  StatusCode initialize() override;
 
   /**  Save the history
-   *   Creates particles and gen vertices that allow association of parents and children
+   *   Puts the particles recorded during the tracking, converted to EDM and linked to their parents, in the event store
+   *   (the tool keeps no state of the event)
    *   @param[in] aEvent The Geant Event conatining data to save.
    *   @return status code
    */
   StatusCode saveOutput(const G4Event& aEvent) override final;
 
 private:
+  /// Pointer to the service of the output streams (used if outputStream is set)
+  ServiceHandle<ISimG4OutputStreamSvc> m_streamSvc;
+  /// Name of the output stream of the particles (event store if empty)
+  Gaudi::Property<std::string> m_outputStream{this, "outputStream", "",
+                                              "Output stream of SimG4OutputStreamSvc (event store if empty)"};
+  /// Flag whether the simulator status of the particles is their index in the collection instead of the track ID
+  Gaudi::Property<bool> m_denseTrackIds{
+      this, "denseTrackIds", false, "Store in the simulator status the index of the particle instead of the track ID"};
   /// Handle for collection of MC particles to create
   DataHandle<edm4hep::MCParticleCollection> m_mcParticles{"SimParticleSecondaries", Gaudi::DataHandle::Writer, this};
-  /// Pointer to the particle collection, ownership should be handled in a algorithm / tool
-  edm4hep::MCParticleCollection* m_mcParticleColl;
 };
 
 #endif /* SIMG4COMPONENTS_SIMG4SAVEPARTICLEHISTORY_H */
@@ -0,0 +1,41 @@
+#include "SimG4SaveRegionOfInterest.h"
+
+// FCCSW
+#include "SimG4Common/EventInformation.h"
+#include "SimG4Common/Units.h"
+
+// Geant4
+#include "G4Event.hh"
+
+DECLARE_COMPONENT(SimG4SaveRegionOfInterest)
+
+SimG4SaveRegionOfInterest::SimG4SaveRegionOfInterest(const std::string& aType, const std::string& aName,
+                                                     const IInterface* aParent)
+    : GaudiTool(aType, aName, aParent) {
+  declareInterface<ISimG4SaveOutputTool>(this);
+  declareProperty("RegionOfInterest", m_cones, "Handle for the cones of the region of interest");
+  declareProperty("RegionOfInterestKills", m_kills, "Handle for the tracks killed outside the region of interest");
+}
+
+StatusCode SimG4SaveRegionOfInterest::saveOutput(const G4Event& aEvent) {
+  auto evtinfo = dynamic_cast<const sim::EventInformation*>(aEvent.GetUserInformation());
+  if (evtinfo == nullptr || !evtinfo->regionOfInterest().defined) {
+    error() << "No region of interest in the event, the user actions of SimG4RegionOfInterestActions are needed"
+            << endmsg;
+    return StatusCode::FAILURE;
+  }
+  const sim::RegionOfInterest& region = evtinfo->regionOfInterest();
+  auto cones = m_cones.createAndPut();
+  for (const auto& cone : region.cones) {
+    cones->push_back(cone.eta);
+    cones->push_back(cone.phi);
+    cones->push_back(cone.deltaR);
+  }
+  auto kills = m_kills.createAndPut();
+  kills->push_back(region.killedAtCreation);
+  kills->push_back(region.killedLeaving);
+  kills->push_back(region.killedEnergy * sim::g42edm::energy);
+  debug() << "Saved " << region.cones.size() << " cones of the region of interest, " << region.killedAtCreation
+          << " tracks killed at creation, " << region.killedLeaving << " when leaving" << endmsg;
+  return StatusCode::SUCCESS;
+}
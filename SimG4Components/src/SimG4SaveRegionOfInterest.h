@@ -0,0 +1,40 @@
+#ifndef SIMG4COMPONENTS_SIMG4SAVEREGIONOFINTEREST_H
+#define SIMG4COMPONENTS_SIMG4SAVEREGIONOFINTEREST_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+#include "SimG4Interface/ISimG4SaveOutputTool.h"
+
+// podio
+#include "podio/UserDataCollection.h"
+
+/** @class SimG4SaveRegionOfInterest SimG4Components/src/SimG4SaveRegionOfInterest.h SimG4SaveRegionOfInterest.h
+ *
+ *  Saves the region of interest of the event, defined by the user actions of SimG4RegionOfInterestActions:
+ *  the cones (\b'RegionOfInterest', three values per cone: pseudorapidity, azimuth and radius) and the tracks killed
+ *  outside of them (\b'RegionOfInterestKills': number killed at their creation, number killed when leaving the cones
+ *  and their kinetic energy in GeV).
+ */
+
+class SimG4SaveRegionOfInterest : public GaudiTool, virtual public ISimG4SaveOutputTool {
+public:
+  explicit SimG4SaveRegionOfInterest(const std::string& aType, const std::string& aName, const IInterface* aParent);
+  virtual ~SimG4SaveRegionOfInterest() = default;
+
+  /**  Save the region of interest of the event.
+   *   @param[in] aEvent The Geant Event containing data to save.
+   *   @return status code
+   */
+  StatusCode saveOutput(const G4Event& aEvent) override final;
+
+private:
+  /// Handle for the cones of the region of interest
+  DataHandle<podio::UserDataCollection<float>> m_cones{"RegionOfInterest", Gaudi::DataHandle::Writer, this};
+  /// Handle for the numbers and energy of the killed tracks
+  DataHandle<podio::UserDataCollection<double>> m_kills{"RegionOfInterestKills", Gaudi::DataHandle::Writer, this};
+};
+
+#endif /* SIMG4COMPONENTS_SIMG4SAVEREGIONOFINTEREST_H */
@@ -1,13 +1,14 @@
 #include "SimG4SaveSmearedParticles.h"
 
 // FCCSW
-#include "SimG4Common/ParticleInformation.h"
+#include "SimG4Common/EventInformation.h"
 #include "SimG4Common/Units.h"
 
 // Geant4
 #include "G4Event.hh"
 
 // datamodel
+#include "edm4hep/MCParticleCollection.h"
 #include "edm4hep/ReconstructedParticleCollection.h"
 #include "edm4hep/MCRecoParticleAssociationCollection.h"
 
@@ -20,6 +21,7 @@ SimG4SaveSmearedParticles::SimG4SaveSmearedParticles(const std::string& aType, c
                                                      const IInterface* aParent)
     : GaudiTool(aType, aName, aParent) {
   declareInterface<ISimG4SaveOutputTool>(this);
+  declareProperty("GenParticles", m_genParticles, "Handle for the MC particles from which the primaries were created");
   declareProperty("RecParticles", m_particles, "Handle for the particles to be written");
   declareProperty("MCRecoParticleAssoc", m_particlesMCparticles,
                   "Handle for the associations between particles and MC particles to be written");
@@ -34,33 +36,32 @@ StatusCode SimG4SaveSmearedParticles::finalize() { return GaudiTool::finalize();
 StatusCode SimG4SaveSmearedParticles::saveOutput(const G4Event& aEvent) {
   auto particles = m_particles.createAndPut();
   auto associations = m_particlesMCparticles.createAndPut();
-  int n_part = 0;
-  for (int i = 0; i < aEvent.GetNumberOfPrimaryVertex(); i++) {
-    for (int j = 0; j < aEvent.GetPrimaryVertex(i)->GetNumberOfParticle(); j++) {
-      const G4PrimaryParticle* g4particle = aEvent.GetPrimaryVertex(i)->GetPrimary(j);
-      sim::ParticleInformation* info = dynamic_cast<sim::ParticleInformation*>(g4particle->GetUserInformation());
-      if (info->smeared()) {
-        const edm4hep::MCParticle& MCparticle = info->mcParticle();
-        edm4hep::ReconstructedParticle particle = particles->create();
-        edm4hep::MCRecoParticleAssociation association = associations->create();
-        association.setRec(particle);
-        association.setSim(MCparticle);
-        particle.setCharge(g4particle->GetCharge());
-        particle.setMomentum({
-          (float) (info->endMomentum().x() * sim::g42edm::energy),
-          (float) (info->endMomentum().y() * sim::g42edm::energy),
-          (float) (info->endMomentum().z() * sim::g42edm::energy),
-        });
-        particle.setMass(g4particle->GetMass() * sim::g42edm::energy);
-        particle.setReferencePoint({
-            (float) (info->vertexPosition().x() * sim::g42edm::length),
-            (float) (info->vertexPosition().y() * sim::g42edm::length),
-            (float) (info->vertexPosition().z() * sim::g42edm::length),
-        });
-        n_part++;
-      }
+  // the smeared primaries are recorded in the event by the fast simulation, no need to scan the primaries
+  auto evtinfo = static_cast<const sim::EventInformation*>(aEvent.GetUserInformation());
+  if (evtinfo == nullptr || evtinfo->smearedParticles().empty()) {
+    debug() << "\t0 particles are stored in smeared particles collection" << endmsg;
+    return StatusCode::SUCCESS;
+  }
+  const edm4hep::MCParticleCollection* genParticles = m_genParticles.get();
+  const auto genParticlesID = static_cast<decltype(podio::ObjectID::collectionID)>(genParticles->getID());
+  for (const auto& smeared : evtinfo->smearedParticles()) {
+    const podio::ObjectID& id = smeared.mcParticleID;
+    if (id.collectionID != genParticlesID || id.index < 0 || static_cast<size_t>(id.index) >= genParticles->size()) {
+      error() << "MC particle of a primary is not in the collection " << m_genParticles.objKey() << endmsg;
+      return StatusCode::FAILURE;
     }
+    edm4hep::ReconstructedParticle particle = particles->create();
+    edm4hep::MCRecoParticleAssociation association = associations->create();
+    association.setRec(particle);
+    association.setSim((*genParticles)[id.index]);
+    particle.setCharge(smeared.charge);
+    particle.setMomentum({(float)(smeared.px * sim::g42edm::energy), (float)(smeared.py * sim::g42edm::energy),
+                          (float)(smeared.pz * sim::g42edm::energy)});
+    particle.setMass(smeared.mass * sim::g42edm::energy);
+    particle.setReferencePoint({(float)(smeared.vx * sim::g42edm::length), (float)(smeared.vy * sim::g42edm::length),
+                                (float)(smeared.vz * sim::g42edm::length)});
   }
-  debug() << "\t" << n_part << " particles are stored in smeared particles collection" << endmsg;
+  debug() << "\t" << evtinfo->smearedParticles().size() << " particles are stored in smeared particles collection"
+          << endmsg;
   return StatusCode::SUCCESS;
 }
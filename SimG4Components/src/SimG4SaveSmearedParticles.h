@@ -10,6 +10,7 @@
 
 // datamodel
 namespace edm4hep {
+class MCParticleCollection;
 class ReconstructedParticleCollection;
 class MCRecoParticleAssociationCollection;
 }
@@ -17,6 +18,10 @@ class MCRecoParticleAssociationCollection;
 /** @class SimG4SaveSmearedParticles SimG4Components/src/SimG4SaveSmearedParticles.h SimG4SaveSmearedParticles.h
  *
  *  Save 'reconstructed' (smeared) particles.
+ *  The smeared primaries are those recorded in the event information (sim::EventInformation) by the fast simulation
+ *  of the tracker, in the order in which they were smeared, so that the primaries are not scanned.
+ *  The MC particles associated to them are looked up in the collection \b'GenParticles' of the event, from which the
+ *  primaries were created (the records keep their identifiers).
  *
  *  @author Anna Zaborowska
  */
@@ -41,6 +46,8 @@ public:
   virtual StatusCode saveOutput(const G4Event& aEvent) final;
 
 private:
+  /// Handle for the MC particles from which the primaries were created
+  DataHandle<edm4hep::MCParticleCollection> m_genParticles{"GenParticles", Gaudi::DataHandle::Reader, this};
   /// Handle for the particles to be written
   DataHandle<edm4hep::ReconstructedParticleCollection> m_particles{"RecParticlesSmeared", Gaudi::DataHandle::Writer, this};
   /// Handle for the associations between particles and MC particles to be written
@@ -0,0 +1,53 @@
+#include "SimG4SaveStagedParticles.h"
+
+// FCCSW
+#include "SimG4Common/EventInformation.h"
+#include "SimG4Common/Units.h"
+
+// Gaudi
+#include "GaudiKernel/PhysicalConstants.h"
+
+// Geant4
+#include "G4Event.hh"
+
+// datamodel
+#include "edm4hep/MCParticleCollection.h"
+
+DECLARE_COMPONENT(SimG4SaveStagedParticles)
+
+SimG4SaveStagedParticles::SimG4SaveStagedParticles(const std::string& aType, const std::string& aName,
+                                                   const IInterface* aParent)
+    : GaudiTool(aType, aName, aParent) {
+  declareInterface<ISimG4SaveOutputTool>(this);
+  declareProperty("StagedParticles", m_particles, "Handle for the tracks stopped at the envelopes");
+}
+
+StatusCode SimG4SaveStagedParticles::saveOutput(const G4Event& aEvent) {
+  auto particles = m_particles.createAndPut();
+  // events without any staged track have no information if nothing else created it
+  auto evtinfo = dynamic_cast<const sim::EventInformation*>(aEvent.GetUserInformation());
+  if (evtinfo == nullptr) {
+    return StatusCode::SUCCESS;
+  }
+  for (const auto& track : evtinfo->stagedTracks()) {
+    auto particle = particles->create();
+    particle.setPDG(track.pdg);
+    particle.setGeneratorStatus(1);
+    particle.setSimulatorStatus(track.trackId);
+    particle.setMass(track.mass * sim::g42edm::energy);
+    particle.setCharge(track.charge);
+    particle.setMomentum({
+        (float) (track.px * sim::g42edm::energy),
+        (float) (track.py * sim::g42edm::energy),
+        (float) (track.pz * sim::g42edm::energy),
+    });
+    particle.setVertex({
+        track.x * sim::g42edm::length,
+        track.y * sim::g42edm::length,
+        track.z * sim::g42edm::length,
+    });
+    particle.setTime(track.time * Gaudi::Units::c_light * sim::g42edm::length);
+  }
+  debug() << "Saved " << particles->size() << " particles stopped at the envelopes" << endmsg;
+  return StatusCode::SUCCESS;
+}
@@ -0,0 +1,42 @@
+#ifndef SIMG4COMPONENTS_SIMG4SAVESTAGEDPARTICLES_H
+#define SIMG4COMPONENTS_SIMG4SAVESTAGEDPARTICLES_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+#include "SimG4Interface/ISimG4SaveOutputTool.h"
+
+// datamodel
+namespace edm4hep {
+class MCParticleCollection;
+}
+
+/** @class SimG4SaveStagedParticles SimG4Components/src/SimG4SaveStagedParticles.h SimG4SaveStagedParticles.h
+ *
+ *  Saves the tracks stopped at the envelopes of a staged simulation (SimG4StagingRegion) as MC particles
+ *  (\b'StagedParticles'), in their state at the boundary: type, mass, charge, momentum, position (vertex) and time,
+ *  with the generator status 1 and the G4 track ID of the first stage as the simulator status (as in the particle
+ *  history). The time follows the convention of SimG4PrimariesFromEdmTool (c times the time, in mm), which reads the
+ *  particles back as the primaries of the second stage.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+ */
+
+class SimG4SaveStagedParticles : public GaudiTool, virtual public ISimG4SaveOutputTool {
+public:
+  explicit SimG4SaveStagedParticles(const std::string& aType, const std::string& aName, const IInterface* aParent);
+  virtual ~SimG4SaveStagedParticles() = default;
+
+  /**  Save the staged tracks of the event.
+   *   @param[in] aEvent The Geant Event containing data to save.
+   *   @return status code
+   */
+  StatusCode saveOutput(const G4Event& aEvent) override final;
+
+private:
+  /// Handle for the staged particles
+  DataHandle<edm4hep::MCParticleCollection> m_particles{"StagedParticles", Gaudi::DataHandle::Writer, this};
+};
+
+#endif /* SIMG4COMPONENTS_SIMG4SAVESTAGEDPARTICLES_H */
@@ -0,0 +1,87 @@
+#include "SimG4SaveToServer.h"
+
+// FCCSW
+#include "SimG4Common/Geant4CaloHit.h"
+#include "SimG4Common/Geant4PreDigiTrackHit.h"
+#include "SimG4Common/HitBuffer.h"
+#include "SimG4Common/Units.h"
+
+// Geant4
+#include "G4Event.hh"
+#include "G4THitsCollection.hh"
+
+// STL
+#include <sstream>
+
+DECLARE_COMPONENT(SimG4SaveToServer)
+
+namespace {
+/// Append the line of a hit to the reply
+void addHit(std::ostringstream& aReply, uint64_t aCellID, double aEnergy, double aX, double aY, double aZ,
+            double aTime) {
+  aReply << aCellID << ' ' << aEnergy * sim::g42edm::energy << ' ' << aX * sim::g42edm::length << ' '
+         << aY * sim::g42edm::length << ' ' << aZ * sim::g42edm::length << ' ' << aTime / CLHEP::ns << '\n';
+}
+}
+
+SimG4SaveToServer::SimG4SaveToServer(const std::string& aType, const std::string& aName, const IInterface* aParent)
+    : GaudiTool(aType, aName, aParent), m_serverSvc("SimG4ServerSvc", aName) {
+  declareInterface<ISimG4SaveOutputTool>(this);
+  declareProperty("ServerSvc", m_serverSvc, "Handle for the service of the server mode");
+}
+
+SimG4SaveToServer::~SimG4SaveToServer() {}
+
+StatusCode SimG4SaveToServer::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (!m_serverSvc.retrieve()) {
+    error() << "Unable to locate the service of the server mode" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4SaveToServer::saveOutput(const G4Event& aEvent) {
+  std::ostringstream reply;
+  reply.precision(9);
+  G4HCofThisEvent* collections = aEvent.GetHCofThisEvent();
+  if (collections != nullptr) {
+    std::vector<int> allIDs;
+    if (m_readoutNames.empty()) {
+      for (int iter_coll = 0; iter_coll < collections->GetNumberOfCollections(); iter_coll++) {
+        if (collections->GetHC(iter_coll) != nullptr) allIDs.push_back(iter_coll);
+      }
+    }
+    const auto& ids = m_readoutNames.empty() ? allIDs : m_collectionIDs.get(*collections, m_readoutNames);
+    for (int iter_coll : ids) {
+      G4VHitsCollection* g4collection = collections->GetHC(iter_coll);
+      reply << "HITS " << g4collection->GetName() << ' ' << g4collection->GetSize() << '\n';
+      if (auto buffer = dynamic_cast<const sim::HitBuffer*>(g4collection)) {
+        // buffers without positions are sent with the positions at the origin
+        const bool positions = buffer->hasPositions();
+        for (size_t iter_hit = 0; iter_hit < buffer->size(); iter_hit++) {
+          addHit(reply, buffer->cellID[iter_hit], buffer->energy[iter_hit], positions ? buffer->x[iter_hit] : 0,
+                 positions ? buffer->y[iter_hit] : 0, positions ? buffer->z[iter_hit] : 0, buffer->time[iter_hit]);
+        }
+      } else if (auto calo = dynamic_cast<G4THitsCollection<k4::Geant4CaloHit>*>(g4collection)) {
+        for (size_t iter_hit = 0; iter_hit < calo->GetSize(); iter_hit++) {
+          const k4::Geant4CaloHit* hit = (*calo)[iter_hit];
+          addHit(reply, hit->cellID, hit->energyDeposit, hit->position.x(), hit->position.y(), hit->position.z(),
+                 hit->time);
+        }
+      } else if (auto tracker = dynamic_cast<G4THitsCollection<k4::Geant4PreDigiTrackHit>*>(g4collection)) {
+        for (size_t iter_hit = 0; iter_hit < tracker->GetSize(); iter_hit++) {
+          const k4::Geant4PreDigiTrackHit* hit = (*tracker)[iter_hit];
+          addHit(reply, hit->cellID, hit->energyDeposit, hit->prePos.x(), hit->prePos.y(), hit->prePos.z(),
+                 hit->time);
+        }
+      } else {
+        warning() << "Collection " << g4collection->GetName() << " does not contain known hits" << endmsg;
+      }
+    }
+  }
+  reply << "DONE " << aEvent.GetEventID() << '\n';
+  return m_serverSvc->reply(reply.str());
+}
@@ -0,0 +1,46 @@
+#ifndef SIMG4COMPONENTS_G4SAVETOSERVER_H
+#define SIMG4COMPONENTS_G4SAVETOSERVER_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+#include "GaudiKernel/ServiceHandle.h"
+
+// FCCSW
+#include "SimG4Common/HitsCollectionIDs.h"
+#include "SimG4Interface/ISimG4SaveOutputTool.h"
+#include "SimG4Interface/ISimG4ServerSvc.h"
+
+/** @class SimG4SaveToServer SimG4Components/src/SimG4SaveToServer.h SimG4SaveToServer.h
+ *
+ *  Save tool of the server mode: the hits of the collections \b'readoutNames' (all the collections if empty) are sent
+ *  back to the client that requested the event, instead of being written to the output file.
+ *  The reply of each collection is a line "HITS <name> <number of hits>", followed by one line per hit
+ *  "cellID energy x y z t" (GeV, mm, ns); the reply of the event ends with the line "DONE <event ID>".
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+ */
+
+class SimG4SaveToServer : public GaudiTool, virtual public ISimG4SaveOutputTool {
+public:
+  explicit SimG4SaveToServer(const std::string& aType, const std::string& aName, const IInterface* aParent);
+  virtual ~SimG4SaveToServer();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize();
+  /**  Send the hits of the event to the client.
+   *   @param[in] aEvent Event with data to save.
+   *   @return status code
+   */
+  virtual StatusCode saveOutput(const G4Event& aEvent) final;
+
+private:
+  /// Handle for the service of the server mode
+  ServiceHandle<ISimG4ServerSvc> m_serverSvc;
+  /// Name of the readouts (hits collections) to send
+  Gaudi::Property<std::vector<std::string>> m_readoutNames{
+      this, "readoutNames", {}, "Name of the readouts (hits collections) to send, all if empty"};
+  /// Indices of the sent collections in the events
+  sim::HitsCollectionIDs m_collectionIDs;
+};
+
+#endif /* SIMG4COMPONENTS_G4SAVETOSERVER_H */
@@ -2,17 +2,26 @@
 
 // FCCSW
 #include "SimG4Interface/IGeoSvc.h"
+#include "SimG4Common/EventInformation.h"
 #include "SimG4Common/Units.h"
 #include "SimG4Common/Geant4PreDigiTrackHit.h"
+#include "SimG4Common/HitBuffer.h"
+#include "StreamBlocks.h"
 
 // Geant4
 #include "G4Event.hh"
+#include "G4THitsCollection.hh"
 
 // datamodel
 #include "edm4hep/SimTrackerHitCollection.h"
 
 // DD4hep
 #include "DD4hep/Detector.h"
+#include "DDSegmentation/BitFieldCoder.h"
+
+// STL
+#include <algorithm>
+#include <memory>
 
 
 DECLARE_COMPONENT(SimG4SaveTrackerHits)
@@ -20,11 +29,15 @@ DECLARE_COMPONENT(SimG4SaveTrackerHits)
 SimG4SaveTrackerHits::SimG4SaveTrackerHits(const std::string& aType, const std::string& aName,
                                            const IInterface* aParent)
     : GaudiTool(aType, aName, aParent),
-      m_geoSvc("GeoSvc", aName)
+      m_geoSvc("GeoSvc", aName),
+      m_streamSvc("SimG4OutputStreamSvc", aName)
     {
   declareInterface<ISimG4SaveOutputTool>(this);
   declareProperty("SimTrackHits", m_trackHits, "Handle for tracker hits");
+  declareProperty("TrackerHitsIndex", m_index, "Handle for the offsets of the ranges of sorted tracker hits");
+  declareProperty("TrackerHitsWeights", m_weights, "Handle for the weights of the tracks of the tracker hits");
   declareProperty("GeoSvc", m_geoSvc);
+  declareProperty("OutputStreamSvc", m_streamSvc);
 }
 
 SimG4SaveTrackerHits::~SimG4SaveTrackerHits() {}
@@ -48,48 +61,234 @@ StatusCode SimG4SaveTrackerHits::initialize() {
       debug() << "Hits will be saved to EDM from the collection " << readoutName << endmsg;
     }
   }
+  for (auto& threshold : m_energyThresholds.value()) {
+    if (std::find(m_readoutNames.begin(), m_readoutNames.end(), threshold.first) == m_readoutNames.end()) {
+      warning() << "Energy threshold given for readout " << threshold.first << " that is not saved" << endmsg;
+    }
+  }
+  if (!m_outputStream.value().empty() && (!m_streamSvc || !m_streamSvc->hasStream(m_outputStream))) {
+    error() << "Output stream " << m_outputStream.value() << " is not configured in SimG4OutputStreamSvc" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_indexFields.assign(m_readoutNames.size(), nullptr);
+  if (!m_indexField.value().empty()) {
+    if (!m_sortByCellID) {
+      error() << "Index of the field " << m_indexField.value() << " requires the hits to be sorted (sortByCellID)"
+              << endmsg;
+      return StatusCode::FAILURE;
+    }
+    for (size_t iReadout = 0; iReadout < m_readoutNames.size(); ++iReadout) {
+      auto decoder = lcdd->readout(m_readoutNames[iReadout]).idSpec().decoder();
+      try {
+        m_indexFields[iReadout] = &(*decoder)[decoder->index(m_indexField)];
+      } catch (const std::exception& e) {
+        error() << "Readout " << m_readoutNames[iReadout] << " does not contain the indexed field: " << e.what()
+                << endmsg;
+        return StatusCode::FAILURE;
+      }
+    }
+  }
   return StatusCode::SUCCESS;
 }
 
 StatusCode SimG4SaveTrackerHits::finalize() { return GaudiTool::finalize(); }
 
 StatusCode SimG4SaveTrackerHits::saveOutput(const G4Event& aEvent) {
+  if (fillOutput(aEvent).isFailure()) return StatusCode::FAILURE;
+  return putOutput();
+}
+
+StatusCode SimG4SaveTrackerHits::fillOutput(const G4Event& aEvent) {
   G4HCofThisEvent* collections = aEvent.GetHCofThisEvent();
-  G4VHitsCollection* collect;
   k4::Geant4PreDigiTrackHit* hit;
+  m_pendingHits.reset();
+  m_pendingWeights.reset();
+  m_pendingIndex.reset();
   if (collections != nullptr) {
-    edm4hep::SimTrackerHitCollection* edmHits = m_trackHits.createAndPut();
-    for (int iter_coll = 0; iter_coll < collections->GetNumberOfCollections(); iter_coll++) {
-      collect = collections->GetHC(iter_coll);
-      if (std::find(m_readoutNames.begin(), m_readoutNames.end(), collect->GetName()) != m_readoutNames.end()) {
-        size_t n_hit = collect->GetSize();
-        verbose() << "\t" << n_hit << " hits are stored in a tracker collection #" << iter_coll << ": "
-               << collect->GetName() << endmsg;
-        for (size_t iter_hit = 0; iter_hit < n_hit; iter_hit++) {
-          hit = dynamic_cast<k4::Geant4PreDigiTrackHit*>(collect->GetHit(iter_hit));
-          edm4hep::SimTrackerHit edmHit = edmHits->create();
-          edmHit.setCellID(hit->cellID);
-          edmHit.setEDep(hit->energyDeposit * sim::g42edm::energy);
-          /// workaround, store trackid in an unrelated field
-          edmHit.setQuality(hit->trackId);
-          edmHit.setTime(hit->time);
-          edmHit.setPosition({
-                              hit->prePos.x() * sim::g42edm::length,
-                              hit->prePos.y() * sim::g42edm::length,
-                              hit->prePos.z() * sim::g42edm::length,
-          });
-          CLHEP::Hep3Vector diff = hit->postPos - hit->prePos;
-          edmHit.setMomentum({
-                               (float) (diff.x() * sim::g42edm::length),
-                               (float) (diff.y() * sim::g42edm::length),
-                               (float) (diff.z() * sim::g42edm::length),
-          });
-          edmHit.setPathLength(diff.mag());
-
-          
+    // collections are put in the event store (or written to the output stream) by putOutput
+    m_pendingHits = std::make_unique<edm4hep::SimTrackerHitCollection>();
+    if (m_trackWeights) m_pendingWeights = std::make_unique<podio::UserDataCollection<float>>();
+    if (!m_indexField.value().empty()) m_pendingIndex = std::make_unique<podio::UserDataCollection<int>>();
+    edm4hep::SimTrackerHitCollection* edmHits = m_pendingHits.get();
+    m_hits.clear();
+    m_sortGroups.clear();
+    m_eventInformation = dynamic_cast<const sim::EventInformation*>(aEvent.GetUserInformation());
+    if (m_denseTrackIds && m_eventInformation == nullptr) {
+      error() << "No particle history in the event, denseTrackIds needs the user action ParticleHistoryEventAction"
+              << endmsg;
+      return StatusCode::FAILURE;
+    }
+    m_currentWeights = m_pendingWeights.get();
+    for (int iter_coll : m_collectionIDs.get(*collections, m_readoutNames)) {
+      if (m_sortByCellID) {
+        const size_t iReadout = std::find(m_readoutNames.begin(), m_readoutNames.end(),
+                                          collections->GetHC(iter_coll)->GetName()) -
+                                m_readoutNames.begin();
+        m_readoutGroup = uint64_t(iReadout) << 32;
+        m_currentIndexField = m_indexFields[iReadout];
+      }
+      // deposits written directly by the buffered sensitive detectors, converted without the hit objects
+      if (auto buffer = dynamic_cast<const sim::HitBuffer*>(collections->GetHC(iter_coll))) {
+        saveBuffer(*buffer, *edmHits);
+        continue;
+      }
+      auto collect = dynamic_cast<G4THitsCollection<k4::Geant4PreDigiTrackHit>*>(collections->GetHC(iter_coll));
+      if (collect == nullptr) {
+        warning() << "Collection " << collections->GetHC(iter_coll)->GetName() << " does not contain tracker hits"
+                  << endmsg;
+        continue;
+      }
+      size_t n_hit = collect->GetSize();
+      verbose() << "\t" << n_hit << " hits are stored in a tracker collection #" << iter_coll << ": "
+             << collect->GetName() << endmsg;
+      if (m_trackWeights && !m_warnedUnweighted) {
+        warning() << "The hits of " << collect->GetName() << " carry no track weight, they are saved with weight 1 "
+                  << "(the weights are recorded by the buffered sensitive detectors)" << endmsg;
+        m_warnedUnweighted = true;
+      }
+      auto threshold = m_energyThresholds.value().find(collect->GetName());
+      const double energyThreshold = threshold != m_energyThresholds.value().end() ? threshold->second : 0;
+      for (size_t iter_hit = 0; iter_hit < n_hit; iter_hit++) {
+        hit = (*collect)[iter_hit];
+        if (m_maxTime > 0 && hit->time > m_maxTime) continue;
+        CLHEP::Hep3Vector exit = hit->postPos;
+        double energy = hit->energyDeposit;
+        double pathLength = (hit->postPos - hit->prePos).mag();
+        if (m_mergeSteps) {
+          // consecutive steps of the same track in the same cell, each within the time window
+          while (iter_hit + 1 < n_hit && (*collect)[iter_hit + 1]->cellID == hit->cellID &&
+                 (*collect)[iter_hit + 1]->trackId == hit->trackId) {
+            const k4::Geant4PreDigiTrackHit* next = (*collect)[++iter_hit];
+            if (m_maxTime > 0 && next->time > m_maxTime) continue;
+            energy += next->energyDeposit;
+            pathLength += (next->postPos - next->prePos).mag();
+            exit = next->postPos;
+          }
+        }
+        if (energy < energyThreshold) continue;
+        const CLHEP::Hep3Vector diff = exit - hit->prePos;
+        addHit({hit->cellID, static_cast<int>(hit->trackId), hit->time, energy, pathLength, hit->prePos.x(),
+                hit->prePos.y(), hit->prePos.z(), diff.x(), diff.y(), diff.z(), 1},
+               *edmHits);
+      }
+    }
+    if (m_sortByCellID) {
+      podio::UserDataCollection<int>* index = m_pendingIndex.get();
+      m_sortCellIDs.clear();
+      for (const Hit& sortedHit : m_hits) m_sortCellIDs.push_back(sortedHit.cellID);
+      m_sort.sort(m_sortGroups, m_sortCellIDs);
+      for (size_t iSorted = 0; iSorted < m_hits.size(); ++iSorted) {
+        const uint32_t iHit = m_sort.order()[iSorted];
+        // start a range of the index if the hit is in another group than the previous one
+        if (index != nullptr && (iSorted == 0 || m_sortGroups[iHit] != m_sortGroups[m_sort.order()[iSorted - 1]])) {
+          index->push_back(m_sortGroups[iHit] >> 32);
+          index->push_back(static_cast<int32_t>(m_sortGroups[iHit] & 0xffffffff));
+          index->push_back(edmHits->size());
         }
+        createHit(m_hits[iHit], *edmHits);
       }
     }
   }
   return StatusCode::SUCCESS;
 }
+
+StatusCode SimG4SaveTrackerHits::putOutput() {
+  if (m_pendingHits == nullptr) return StatusCode::SUCCESS;
+  // collections written to the output stream are not put in the event store
+  if (!m_outputStream.value().empty()) {
+    if (sim::writeBlock(*m_streamSvc, m_outputStream, m_trackHits.objKey(), sim::trackerHitsBlock(*m_pendingHits))
+            .isFailure()) {
+      return StatusCode::FAILURE;
+    }
+    if (m_pendingWeights != nullptr &&
+        sim::writeBlock(*m_streamSvc, m_outputStream, m_weights.objKey(), sim::userDataBlock(*m_pendingWeights))
+            .isFailure()) {
+      return StatusCode::FAILURE;
+    }
+    if (m_pendingIndex != nullptr &&
+        sim::writeBlock(*m_streamSvc, m_outputStream, m_index.objKey(), sim::userDataBlock(*m_pendingIndex))
+            .isFailure()) {
+      return StatusCode::FAILURE;
+    }
+    m_pendingHits.reset();
+    m_pendingWeights.reset();
+    m_pendingIndex.reset();
+    return StatusCode::SUCCESS;
+  }
+  m_trackHits.put(m_pendingHits.release());
+  if (m_pendingWeights != nullptr) m_weights.put(m_pendingWeights.release());
+  if (m_pendingIndex != nullptr) m_index.put(m_pendingIndex.release());
+  return StatusCode::SUCCESS;
+}
+
+void SimG4SaveTrackerHits::addHit(const Hit& aHit, edm4hep::SimTrackerHitCollection& aEdmHits) {
+  if (!m_sortByCellID) {
+    createHit(aHit, aEdmHits);
+    return;
+  }
+  m_hits.push_back(aHit);
+  m_sortGroups.push_back(m_readoutGroup | (m_currentIndexField != nullptr
+                                               ? static_cast<uint32_t>(m_currentIndexField->value(aHit.cellID))
+                                               : 0));
+}
+
+void SimG4SaveTrackerHits::createHit(const Hit& aHit, edm4hep::SimTrackerHitCollection& aEdmHits) const {
+  edm4hep::SimTrackerHit edmHit = aEdmHits.create();
+  edmHit.setCellID(aHit.cellID);
+  edmHit.setEDep(aHit.energy * sim::g42edm::energy);
+  /// workaround, store trackid (or the index of its particle) in an unrelated field
+  edmHit.setQuality(m_denseTrackIds ? m_eventInformation->particleIndex(aHit.trackId) : aHit.trackId);
+  edmHit.setTime(aHit.time);
+  edmHit.setPosition({
+                      aHit.x * sim::g42edm::length,
+                      aHit.y * sim::g42edm::length,
+                      aHit.z * sim::g42edm::length,
+  });
+  edmHit.setMomentum({
+                       (float) (aHit.dx * sim::g42edm::length),
+                       (float) (aHit.dy * sim::g42edm::length),
+                       (float) (aHit.dz * sim::g42edm::length),
+  });
+  edmHit.setPathLength(aHit.pathLength);
+  if (m_currentWeights != nullptr) m_currentWeights->push_back(aHit.weight);
+}
+
+void SimG4SaveTrackerHits::saveBuffer(const sim::HitBuffer& aBuffer, edm4hep::SimTrackerHitCollection& aEdmHits) {
+  const size_t n_deposit = aBuffer.size();
+  verbose() << "\t" << n_deposit << " deposits are stored in a tracker buffer: " << aBuffer.GetName() << endmsg;
+  if (!aBuffer.hasPostStep()) {
+    warning() << "Buffer " << aBuffer.GetName() << " does not contain tracker hits" << endmsg;
+    return;
+  }
+  auto threshold = m_energyThresholds.value().find(aBuffer.GetName());
+  const double energyThreshold = threshold != m_energyThresholds.value().end() ? threshold->second : 0;
+  for (size_t iter_hit = 0; iter_hit < n_deposit; iter_hit++) {
+    if (m_maxTime > 0 && aBuffer.time[iter_hit] > m_maxTime) continue;
+    const size_t first = iter_hit;
+    auto stepLength = [&aBuffer](size_t aIndex) {
+      return CLHEP::Hep3Vector(aBuffer.postX[aIndex] - aBuffer.x[aIndex], aBuffer.postY[aIndex] - aBuffer.y[aIndex],
+                               aBuffer.postZ[aIndex] - aBuffer.z[aIndex])
+          .mag();
+    };
+    double energy = aBuffer.energy[first];
+    double pathLength = stepLength(first);
+    // last step merged into the hit, giving its exit position
+    size_t last = first;
+    if (m_mergeSteps) {
+      // consecutive steps of the same track in the same cell, each within the time window
+      while (iter_hit + 1 < n_deposit && aBuffer.cellID[iter_hit + 1] == aBuffer.cellID[first] &&
+             aBuffer.trackId[iter_hit + 1] == aBuffer.trackId[first]) {
+        ++iter_hit;
+        if (m_maxTime > 0 && aBuffer.time[iter_hit] > m_maxTime) continue;
+        energy += aBuffer.energy[iter_hit];
+        pathLength += stepLength(iter_hit);
+        last = iter_hit;
+      }
+    }
+    if (energy < energyThreshold) continue;
+    addHit({aBuffer.cellID[first], aBuffer.trackId[first], aBuffer.time[first], energy, pathLength, aBuffer.x[first],
+            aBuffer.y[first], aBuffer.z[first], aBuffer.postX[last] - aBuffer.x[first],
+            aBuffer.postY[last] - aBuffer.y[first], aBuffer.postZ[last] - aBuffer.z[first], aBuffer.weightOf(first)},
+           aEdmHits);
+  }
+}
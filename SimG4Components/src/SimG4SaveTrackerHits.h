@@ -6,8 +6,31 @@
 
 // FCCSW
 #include "k4FWCore/DataHandle.h"
+#include "SimG4Common/CellSort.h"
+#include "SimG4Common/HitsCollectionIDs.h"
+#include "SimG4Interface/ISimG4OutputStreamSvc.h"
 #include "SimG4Interface/ISimG4SaveOutputTool.h"
 class IGeoSvc;
+namespace sim {
+class EventInformation;
+class HitBuffer;
+}
+
+// podio
+#include "podio/UserDataCollection.h"
+
+// DD4hep
+namespace dd4hep {
+namespace DDSegmentation {
+class BitFieldElement;
+}
+}
+
+// STL
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
 
 // datamodel
 namespace edm4hep {
@@ -21,6 +44,23 @@ class SimTrackerHitCollection;
  *  Readout name is defined in DD4hep XML file as the attribute 'readout' of 'detector' tag.
  *  If (\b'readoutNames') contain no elements or names that do not correspond to any hit collection,
  *  tool will fail at initialization.
+ *  Hits below the energy threshold of their readout (\b'energyThresholds') and hits created after \b'maxTime' are not
+ *  saved.
+ *  If \b'mergeSteps' is set, consecutive steps of the same track in the same cell are saved as one hit, with the summed
+ *  energy deposit, the entry position, the exit position (stored as the difference to the entry in the momentum) and
+ *  the total path length.
+ *  The buffers of the buffered sensitive detectors (sim::HitBuffer) are converted in bulk from their arrays.
+ *  If \b'sortByCellID' is set, the hits are written sorted by readout (in the order of \b'readoutNames'), by the value
+ *  of the field \b'indexField' of the cellID (if set) and by cellID. With \b'indexField', the offsets of the ranges of
+ *  hits are written to \b'TrackerHitsIndex': for each range, the index of its readout, the value of the field and the
+ *  index of its first hit.
+ *  If \b'trackWeights' is set, the weights of the tracks changed by the biasing (e.g. SimG4ImportanceBiasingRegion),
+ *  as recorded in the buffers by the sensitive detectors at the time of the deposits, are written to
+ *  \b'TrackerHitsWeights', one per hit, in the order of the hits. The hit objects carry no weight and get weight 1.
+ *  If \b'outputStream' is set, the collections are written to this stream of SimG4OutputStreamSvc (e.g. a file of the
+ *  sub-detector), with the names of their handles, instead of the event store.
+ *  The hits may be filled in a parallel task of SimG4Alg (\b'concurrentOutputs'), the collections being put in the
+ *  store (or written to the stream) afterwards on the thread of the algorithm.
  *  [For more information please see](@ref md_sim_doc_geant4fullsim).
  *
  *  @author Anna Zaborowska
@@ -45,16 +85,109 @@ public:
    *   @return status code
    */
   virtual StatusCode saveOutput(const G4Event& aEvent) final;
+  /**  Whether the output may be filled concurrently with the other tools.
+   *   @return true
+   */
+  virtual bool fillsConcurrently() const final { return true; }
+  /**  Fill the tracker hits of the event in the collections of the tool, without accessing the event store.
+   *   @param[in] aEvent Event with data to save.
+   *   @return status code
+   */
+  virtual StatusCode fillOutput(const G4Event& aEvent) final;
+  /**  Put the collections filled by fillOutput() in the event store, or write them to the output stream.
+   *   @return status code
+   */
+  virtual StatusCode putOutput() final;
 
 private:
+  /// Hit to be written, with the exit position relative to the entry position
+  struct Hit {
+    uint64_t cellID;
+    int trackId;
+    double time;
+    double energy;
+    double pathLength;
+    double x, y, z;
+    double dx, dy, dz;
+    /// weight of the track at the first step of the hit
+    double weight;
+  };
+  /**  Write the hit, or keep it to be written sorted.
+   *   @param[in] aHit hit with the units of Geant4
+   *   @param[out] aEdmHits tracker hits to which the hit is saved
+   */
+  void addHit(const Hit& aHit, edm4hep::SimTrackerHitCollection& aEdmHits);
+  /**  Write the hit.
+   *   @param[in] aHit hit with the units of Geant4
+   *   @param[out] aEdmHits tracker hits to which the hit is saved
+   */
+  void createHit(const Hit& aHit, edm4hep::SimTrackerHitCollection& aEdmHits) const;
+  /**  Save the deposits of a buffered sensitive detector, in bulk from the arrays of the buffer.
+   *   @param[in] aBuffer buffer of the deposits of a readout
+   *   @param[out] aEdmHits tracker hits to which the deposits are saved
+   */
+  void saveBuffer(const sim::HitBuffer& aBuffer, edm4hep::SimTrackerHitCollection& aEdmHits);
   /// Pointer to the geometry service
   ServiceHandle<IGeoSvc> m_geoSvc;
+  /// Pointer to the service of the output streams (used if outputStream is set)
+  ServiceHandle<ISimG4OutputStreamSvc> m_streamSvc;
+  /// Name of the output stream of the collections (event store if empty)
+  Gaudi::Property<std::string> m_outputStream{this, "outputStream", "",
+                                              "Output stream of SimG4OutputStreamSvc (event store if empty)"};
   /// Handle for tracker hits
   DataHandle<edm4hep::SimTrackerHitCollection> m_trackHits{"TrackerHits", Gaudi::DataHandle::Writer, this};
-  /// Handle for tracker hits including position information
+  /// Handle for the offsets of the ranges of sorted hits (readout index, value of the indexed field, first hit)
+  DataHandle<podio::UserDataCollection<int>> m_index{"TrackerHitsIndex", Gaudi::DataHandle::Writer, this};
+  /// Handle for the weights of the tracks of the hits (in the order of the hits)
+  DataHandle<podio::UserDataCollection<float>> m_weights{"TrackerHitsWeights", Gaudi::DataHandle::Writer, this};
+  /// Collections filled by fillOutput(), until they are put by putOutput()
+  std::unique_ptr<edm4hep::SimTrackerHitCollection> m_pendingHits;
+  std::unique_ptr<podio::UserDataCollection<float>> m_pendingWeights;
+  std::unique_ptr<podio::UserDataCollection<int>> m_pendingIndex;
   /// Name of the readouts (hits collections) to save
   Gaudi::Property<std::vector<std::string>> m_readoutNames{
       this, "readoutNames", {}, "Name of the readouts (hits collections) to save"};
+  /// Energy thresholds of the saved hits, by readout
+  Gaudi::Property<std::map<std::string, double>> m_energyThresholds{
+      this, "energyThresholds", {}, "Energy thresholds of the saved hits by readout name"};
+  /// Time after which the hits are not saved (0: no limit)
+  Gaudi::Property<double> m_maxTime{this, "maxTime", 0, "Time after which hits are not saved (0: no limit)"};
+  /// Flag whether consecutive steps of a track in a cell should be merged
+  Gaudi::Property<bool> m_mergeSteps{this, "mergeSteps", false,
+                                     "Merge consecutive steps of the same track in the same cell into one hit"};
+  /// Flag whether the hits are written sorted by cellID
+  Gaudi::Property<bool> m_sortByCellID{this, "sortByCellID", false,
+                                       "Write the hits sorted by readout, value of the indexField and cellID"};
+  /// Field of the cellID whose ranges of hits are indexed (no index if empty)
+  Gaudi::Property<std::string> m_indexField{
+      this, "indexField", "", "Field of the cellID (e.g. system or layer) whose ranges of sorted hits are indexed"};
+  /// Flag whether the weights of the biased tracks are saved
+  Gaudi::Property<bool> m_trackWeights{this, "trackWeights", false,
+                                       "Save the weights of the biased tracks of the hits to TrackerHitsWeights"};
+  /// Flag whether the quality of the hits is the index of their particle in the saved history instead of the track ID
+  Gaudi::Property<bool> m_denseTrackIds{
+      this, "denseTrackIds", false,
+      "Store in the quality of the hits the index of their particle in the saved history (-1 if not saved)"};
+  /// Indices of the saved collections in the events
+  sim::HitsCollectionIDs m_collectionIDs;
+  /// Indexed field of each readout (in the order of m_readoutNames)
+  std::vector<const dd4hep::DDSegmentation::BitFieldElement*> m_indexFields;
+  /// Sorting group of the hits of the current collection (index of its readout)
+  uint64_t m_readoutGroup = 0;
+  /// Indexed field of the current collection
+  const dd4hep::DDSegmentation::BitFieldElement* m_currentIndexField = nullptr;
+  /// Information of the current event, with the particle history
+  const sim::EventInformation* m_eventInformation = nullptr;
+  /// Weights of the hits of the current event (nullptr if not saved)
+  podio::UserDataCollection<float>* m_currentWeights = nullptr;
+  /// Flag whether the hit objects without weight were reported (once per job)
+  bool m_warnedUnweighted = false;
+  /// Sort of the hits (buffers reused between events)
+  sim::CellSort m_sort;
+  /// Hits of the event kept to be written sorted, with their sorting groups and cellIDs (reused between events)
+  std::vector<Hit> m_hits;
+  std::vector<uint64_t> m_sortGroups;
+  std::vector<uint64_t> m_sortCellIDs;
 };
 
 #endif /* SIMG4COMPONENTS_G4SAVETRACKERHITS_H */
@@ -6,8 +6,17 @@
 
 // Geant4
 #include "G4Event.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Navigator.hh"
+#include "G4Region.hh"
 #include "G4Trajectory.hh"
+#include "G4TransportationManager.hh"
+#include "G4VPhysicalVolume.hh"
 #include "G4VTrajectory.hh"
+#include "G4VTrajectoryPoint.hh"
+
+// STL
+#include <algorithm>
 
 
 // datamodel
@@ -15,6 +24,43 @@
 
 DECLARE_COMPONENT(SimG4SaveTrajectory)
 
+namespace {
+/// Douglas-Peucker simplification: keeps the points of the polyline so that every dropped point is within the tolerance
+/// of the chord between the kept points around it (the first and the last points are kept)
+void simplify(const std::vector<G4ThreeVector>& aPoints, double aTolerance, std::vector<G4ThreeVector>& aKept) {
+  std::vector<bool> kept(aPoints.size(), false);
+  kept.front() = kept.back() = true;
+  std::vector<std::pair<size_t, size_t>> segments{{0, aPoints.size() - 1}};
+  while (!segments.empty()) {
+    const auto segment = segments.back();
+    segments.pop_back();
+    const G4ThreeVector& start = aPoints[segment.first];
+    const G4ThreeVector chord = aPoints[segment.second] - start;
+    const double length = chord.mag();
+    double maxDistance = 0;
+    size_t farthest = segment.first;
+    for (size_t iPoint = segment.first + 1; iPoint < segment.second; ++iPoint) {
+      const G4ThreeVector offset = aPoints[iPoint] - start;
+      // distance to the start point if the chord is degenerate (a looping track back to its start)
+      const double distance = length > 0 ? offset.cross(chord).mag() / length : offset.mag();
+      if (distance > maxDistance) {
+        maxDistance = distance;
+        farthest = iPoint;
+      }
+    }
+    if (maxDistance >= aTolerance) {
+      kept[farthest] = true;
+      segments.emplace_back(segment.first, farthest);
+      segments.emplace_back(farthest, segment.second);
+    }
+  }
+  aKept.clear();
+  for (size_t iPoint = 0; iPoint < aPoints.size(); ++iPoint) {
+    if (kept[iPoint]) aKept.push_back(aPoints[iPoint]);
+  }
+}
+}
+
 SimG4SaveTrajectory::SimG4SaveTrajectory(const std::string& aType, const std::string& aName,
                                            const IInterface* aParent)
     : GaudiTool(aType, aName, aParent), m_geoSvc("GeoSvc", aName) {
@@ -28,18 +74,63 @@ StatusCode SimG4SaveTrajectory::initialize() {
   if (GaudiTool::initialize().isFailure()) {
     return StatusCode::FAILURE;
   }
+  if (m_pointStep < 1) {
+    error() << "Step between the saved points needs to be positive" << endmsg;
+    return StatusCode::FAILURE;
+  }
   return StatusCode::SUCCESS;
 }
 
 StatusCode SimG4SaveTrajectory::finalize() { return GaudiTool::finalize(); }
 
+bool SimG4SaveTrajectory::isSelected(const G4VTrajectory& aTrajectory) {
+  if (m_primaryOnly && aTrajectory.GetParentID() != 0) return false;
+  if (aTrajectory.GetInitialMomentum().mag() < m_minMomentum) return false;
+  if (!m_pdgCodes.empty() &&
+      std::find(m_pdgCodes.begin(), m_pdgCodes.end(), aTrajectory.GetPDGEncoding()) == m_pdgCodes.end()) {
+    return false;
+  }
+  if (!m_regions.empty() && aTrajectory.GetPointEntries() > 0) {
+    if (!m_navigator) {
+      m_navigator = std::make_unique<G4Navigator>();
+      m_navigator->SetWorldVolume(
+          G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume());
+    }
+    const G4VPhysicalVolume* volume =
+        m_navigator->LocateGlobalPointAndSetup(aTrajectory.GetPoint(0)->GetPosition(), nullptr, false, true);
+    const G4Region* region = volume ? volume->GetLogicalVolume()->GetRegion() : nullptr;
+    if (region == nullptr || std::find(m_regions.begin(), m_regions.end(), region->GetName()) == m_regions.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 StatusCode SimG4SaveTrajectory::saveOutput(const G4Event& aEvent) {
   auto edmPositions = m_trackHits.createAndPut();
   G4TrajectoryContainer* trajectoryContainer = aEvent.GetTrajectoryContainer();
+  if (trajectoryContainer == nullptr) {
+    warning() << "No trajectories stored, use the Geant4 command /tracking/storeTrajectory 1 or SimG4TrajectoryFilterActions"
+              << endmsg;
+    return StatusCode::SUCCESS;
+  }
+  std::vector<G4ThreeVector> points;
+  std::vector<G4ThreeVector> simplified;
   for (size_t trajectoryIndex = 0; trajectoryIndex < trajectoryContainer->size(); ++trajectoryIndex) {
     G4VTrajectory* theTrajectory =  (*trajectoryContainer)[trajectoryIndex];
-    for (int pointIndex = 0; pointIndex < theTrajectory->GetPointEntries(); ++pointIndex) {
-      auto trajectoryPoint = theTrajectory->GetPoint(pointIndex)->GetPosition();
+    if (!isSelected(*theTrajectory)) continue;
+    const int numPoints = theTrajectory->GetPointEntries();
+    points.clear();
+    for (int pointIndex = 0; pointIndex < numPoints; ++pointIndex) {
+      // first and last points are always kept
+      if (pointIndex % m_pointStep != 0 && pointIndex != numPoints - 1) continue;
+      points.push_back(theTrajectory->GetPoint(pointIndex)->GetPosition());
+    }
+    if (m_maxDeviation > 0 && points.size() > 2) {
+      simplify(points, m_maxDeviation, simplified);
+      points.swap(simplified);
+    }
+    for (const auto& trajectoryPoint : points) {
       edm4hep::TrackerHit edmHit = edmPositions->create();
       edmHit.setCellID(0);
       edmHit.setEDep(0);
@@ -9,6 +9,13 @@
 #include "SimG4Interface/ISimG4SaveOutputTool.h"
 class IGeoSvc;
 
+// Geant4
+class G4Navigator;
+class G4VTrajectory;
+
+// STL
+#include <memory>
+
 // datamodel
 namespace edm4hep {
 class TrackerHitCollection;
@@ -16,8 +23,13 @@ class TrackerHitCollection;
 
 /** @class SimG4SaveTrajectory SimG4Components/src/SimG4SaveTrajectory.h SimG4SaveTrajectory.h
  *
- * Tool to save Geant4 Trajectory data. Requires Geant to be run with the command "/tracking/storeTrajectory 1".
+ * Tool to save Geant4 Trajectory data. Requires Geant to be run with the command "/tracking/storeTrajectory 1", or
+ *  the trajectories to be created per track by SimG4TrajectoryFilterActions (configured with the same selection).
  *  Note that access to trajectories is expensive, so this tool should only be used for debugging and visualisation.
+ *  Trajectories may be selected by their initial momentum (\b'minMomentum'), particle type (\b'pdgCodes'), region of
+ *  their starting point (\b'regions') and origin (\b'primaryOnly'). Points may be decimated, keeping every n-th point
+ *  (\b'pointStep') and/or only the points needed for every dropped point to be within \b'maxDeviation' of the straight
+ *  line between the kept points around it (Douglas-Peucker); the first and the last points are always kept.
  *
  */
 
@@ -40,11 +52,29 @@ public:
   virtual StatusCode saveOutput(const G4Event& aEvent) final;
 
 private:
+  /// Check if the trajectory passes the selection
+  bool isSelected(const G4VTrajectory& aTrajectory);
   /// Pointer to the geometry service
   ServiceHandle<IGeoSvc> m_geoSvc;
   /// Handle for trajectory hits including position information
   DataHandle<edm4hep::TrackerHitCollection> m_trackHits{"Hits/Trajectory",
                                                                       Gaudi::DataHandle::Writer, this};
+  /// Minimal initial momentum of the saved trajectories
+  Gaudi::Property<double> m_minMomentum{this, "minMomentum", 0, "Minimal initial momentum of the saved trajectories"};
+  /// PDG codes of the saved trajectories (all if empty)
+  Gaudi::Property<std::vector<int>> m_pdgCodes{this, "pdgCodes", {}, "PDG codes of the saved trajectories (all if empty)"};
+  /// Regions in which the saved trajectories start (all if empty)
+  Gaudi::Property<std::vector<std::string>> m_regions{
+      this, "regions", {}, "Names of the regions in which the saved trajectories start (all if empty)"};
+  /// Flag whether only the trajectories of the primary particles should be saved
+  Gaudi::Property<bool> m_primaryOnly{this, "primaryOnly", false, "Save only the trajectories of primary particles"};
+  /// Step between the saved points
+  Gaudi::Property<int> m_pointStep{this, "pointStep", 1, "Save every n-th point of the trajectories"};
+  /// Minimal distance of the saved points from the line between their neighbours (0: all points)
+  Gaudi::Property<double> m_maxDeviation{
+      this, "maxDeviation", 0, "Drop the points closer than this to the straight line between the kept points"};
+  /// Navigator locating the starting points of the trajectories (if selected by region)
+  std::unique_ptr<G4Navigator> m_navigator;
 };
 
 #endif /* SIMG4COMPONENTS_G4SAVETRAJECTORY */
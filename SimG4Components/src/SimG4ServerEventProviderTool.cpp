@@ -0,0 +1,60 @@
+#include "SimG4ServerEventProviderTool.h"
+
+// FCCSW
+#include "SimG4Common/Units.h"
+
+// Gaudi
+#include "GaudiKernel/IEventProcessor.h"
+#include "GaudiKernel/ISvcLocator.h"
+
+// Geant4
+#include "G4Event.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+
+// STL
+#include <vector>
+
+DECLARE_COMPONENT(SimG4ServerEventProviderTool)
+
+SimG4ServerEventProviderTool::SimG4ServerEventProviderTool(const std::string& aType, const std::string& aName,
+                                                           const IInterface* aParent)
+    : GaudiTool(aType, aName, aParent), m_serverSvc("SimG4ServerSvc", aName) {
+  declareInterface<ISimG4EventProviderTool>(this);
+  declareProperty("ServerSvc", m_serverSvc, "Handle for the service of the server mode");
+}
+
+SimG4ServerEventProviderTool::~SimG4ServerEventProviderTool() {}
+
+StatusCode SimG4ServerEventProviderTool::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (!m_serverSvc.retrieve()) {
+    error() << "Unable to locate the service of the server mode" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
+
+G4Event* SimG4ServerEventProviderTool::g4Event() {
+  auto theEvent = new G4Event();
+  std::vector<ISimG4ServerSvc::Primary> primaries;
+  if (!m_serverSvc->nextEvent(primaries)) {
+    // the event loop ends with this (empty) event
+    SmartIF<IEventProcessor> eventProcessor(serviceLocator()->service("ApplicationMgr"));
+    if (eventProcessor) eventProcessor->stopRun().ignore();
+    info() << "Simulation server stopped" << endmsg;
+    return theEvent;
+  }
+  for (const auto& primary : primaries) {
+    G4PrimaryVertex* vertex =
+        new G4PrimaryVertex(primary.x * sim::edm2g4::length, primary.y * sim::edm2g4::length,
+                            primary.z * sim::edm2g4::length, primary.time * CLHEP::ns);
+    vertex->SetPrimary(new G4PrimaryParticle(primary.pdg, primary.px * sim::edm2g4::energy,
+                                             primary.py * sim::edm2g4::energy, primary.pz * sim::edm2g4::energy));
+    theEvent->AddPrimaryVertex(vertex);
+  }
+  debug() << "Event with " << primaries.size() << " primaries requested" << endmsg;
+  return theEvent;
+}
@@ -0,0 +1,42 @@
+#ifndef SIMG4COMPONENTS_G4SERVEREVENTPROVIDERTOOL_H
+#define SIMG4COMPONENTS_G4SERVEREVENTPROVIDERTOOL_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+#include "GaudiKernel/ServiceHandle.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4EventProviderTool.h"
+#include "SimG4Interface/ISimG4ServerSvc.h"
+
+/** @class SimG4ServerEventProviderTool SimG4Components/src/SimG4ServerEventProviderTool.h
+ * SimG4ServerEventProviderTool.h
+ *
+ *  Event provider of the server mode: it waits for the next event requested from SimG4ServerSvc and creates its
+ *  primaries, one vertex per primary particle. Once the server is stopped, the job is stopped after an event without
+ *  primaries. The primaries have no MC particle (sim::ParticleInformation), hence the tools needing one (e.g. the fast
+ *  simulation of the tracker) cannot be used in the server mode.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+ */
+
+class SimG4ServerEventProviderTool : public GaudiTool, virtual public ISimG4EventProviderTool {
+public:
+  /// Standard constructor
+  SimG4ServerEventProviderTool(const std::string& aType, const std::string& aName, const IInterface* aParent);
+  /// Destructor
+  virtual ~SimG4ServerEventProviderTool();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Wait for the next requested event.
+   *   @return G4Event with the requested primaries (ownership is transferred to the caller)
+   */
+  virtual G4Event* g4Event() final;
+
+private:
+  /// Handle for the service of the server mode
+  ServiceHandle<ISimG4ServerSvc> m_serverSvc;
+};
+
+#endif /* SIMG4COMPONENTS_G4SERVEREVENTPROVIDERTOOL_H */
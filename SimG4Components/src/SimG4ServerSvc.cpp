@@ -0,0 +1,191 @@
+#include "SimG4ServerSvc.h"
+
+// Geant4
+#include "G4UImanager.hh"
+
+// STL
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+DECLARE_COMPONENT(SimG4ServerSvc)
+
+SimG4ServerSvc::SimG4ServerSvc(const std::string& aName, ISvcLocator* aSL) : base_class(aName, aSL) {}
+
+SimG4ServerSvc::~SimG4ServerSvc() {}
+
+StatusCode SimG4ServerSvc::initialize() {
+  if (Service::initialize().isFailure()) {
+    error() << "Unable to initialize Service()" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (m_socketPath.value().empty() || m_socketPath.value().size() >= sizeof(address.sun_path)) {
+    error() << "Path of the socket " << m_socketPath.value() << " is empty or too long" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  std::strncpy(address.sun_path, m_socketPath.value().c_str(), sizeof(address.sun_path) - 1);
+  // a socket left by a previous job is replaced, but no other file and no socket of a running server
+  struct stat status;
+  if (::lstat(address.sun_path, &status) == 0) {
+    if (!S_ISSOCK(status.st_mode)) {
+      error() << "Path of the socket " << m_socketPath.value() << " exists and is not a socket" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    const int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    const bool running =
+        probe >= 0 && ::connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    if (probe >= 0) ::close(probe);
+    if (running) {
+      error() << "Another server is listening on the socket " << m_socketPath.value() << endmsg;
+      return StatusCode::FAILURE;
+    }
+    if (::unlink(address.sun_path) != 0) {
+      error() << "Unable to remove the stale socket " << m_socketPath.value() << ": " << std::strerror(errno)
+              << endmsg;
+      return StatusCode::FAILURE;
+    }
+  } else if (errno != ENOENT) {
+    error() << "Unable to check the path of the socket " << m_socketPath.value() << ": " << std::strerror(errno)
+            << endmsg;
+    return StatusCode::FAILURE;
+  }
+  // the clients can apply any Geant4 command (e.g. /control/shell), so only the owner may connect (0600)
+  m_listening = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  const mode_t mask = ::umask(0177);
+  const bool bound =
+      m_listening >= 0 && ::bind(m_listening, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+  const int bindError = errno;
+  ::umask(mask);
+  if (!bound || ::listen(m_listening, 4) != 0) {
+    error() << "Unable to listen on the socket " << m_socketPath.value() << ": "
+            << std::strerror(bound ? errno : bindError) << endmsg;
+    return StatusCode::FAILURE;
+  }
+  info() << "Simulation server listening on " << m_socketPath.value() << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4ServerSvc::finalize() {
+  closeClient();
+  if (m_listening >= 0) {
+    ::close(m_listening);
+    m_listening = -1;
+    ::unlink(m_socketPath.value().c_str());
+  }
+  info() << m_numEvents << " events requested by " << m_numClients << " clients" << endmsg;
+  return Service::finalize();
+}
+
+void SimG4ServerSvc::closeClient() {
+  if (m_client >= 0) {
+    ::close(m_client);
+    m_client = -1;
+  }
+  m_received.clear();
+}
+
+bool SimG4ServerSvc::readLine(std::string& aLine) {
+  while (true) {
+    const size_t end = m_received.find('\n');
+    if (end != std::string::npos) {
+      aLine = m_received.substr(0, end);
+      m_received.erase(0, end + 1);
+      if (!aLine.empty() && aLine.back() == '\r') aLine.pop_back();
+      return true;
+    }
+    if (m_client < 0) {
+      m_client = ::accept(m_listening, nullptr, nullptr);
+      if (m_client < 0) {
+        if (errno == EINTR) continue;
+        error() << "Unable to accept a client: " << std::strerror(errno) << endmsg;
+        return false;
+      }
+      ++m_numClients;
+      debug() << "Client " << m_numClients << " connected" << endmsg;
+    }
+    char data[4096];
+    const ssize_t size = ::read(m_client, data, sizeof(data));
+    if (size > 0) {
+      m_received.append(data, size);
+    } else if (size == 0 || errno != EINTR) {
+      // the client disconnected, the next one is waited for
+      closeClient();
+    }
+  }
+}
+
+bool SimG4ServerSvc::nextEvent(std::vector<Primary>& aPrimaries) {
+  aPrimaries.clear();
+  bool inEvent = false;
+  unsigned long eventClient = 0;
+  std::string line;
+  while (!m_stopped && readLine(line)) {
+    if (inEvent && eventClient != m_numClients) {
+      // the client disconnected within the event, which is dropped
+      aPrimaries.clear();
+      inEvent = false;
+    }
+    std::istringstream words(line);
+    std::string keyword;
+    if (!(words >> keyword)) continue;
+    if (inEvent) {
+      if (keyword == "END") {
+        ++m_numEvents;
+        return true;
+      }
+      std::istringstream values(line);
+      Primary primary;
+      if (!(values >> primary.pdg >> primary.x >> primary.y >> primary.z >> primary.time >> primary.px >>
+            primary.py >> primary.pz)) {
+        // the rest of the event is skipped
+        reply("ERROR malformed primary: " + line + "\n").ignore();
+        aPrimaries.clear();
+        inEvent = false;
+        continue;
+      }
+      aPrimaries.push_back(primary);
+    } else if (keyword == "EVENT") {
+      inEvent = true;
+      eventClient = m_numClients;
+    } else if (keyword == "COMMAND") {
+      std::string command;
+      std::getline(words >> std::ws, command);
+      const int code = G4UImanager::GetUIpointer()->ApplyCommand(command);
+      reply(code == 0 ? std::string("OK\n") : "ERROR " + std::to_string(code) + "\n").ignore();
+    } else if (keyword == "STOP") {
+      reply("STOPPED\n").ignore();
+      closeClient();
+      m_stopped = true;
+    } else {
+      reply("ERROR unknown request: " + line + "\n").ignore();
+    }
+  }
+  return false;
+}
+
+StatusCode SimG4ServerSvc::reply(const std::string& aText) {
+  if (m_client < 0) {
+    warning() << "No client to reply to" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  size_t sent = 0;
+  while (sent < aText.size()) {
+    // no signal if the client disconnected, the error is returned instead
+    const ssize_t size = ::send(m_client, aText.data() + sent, aText.size() - sent, MSG_NOSIGNAL);
+    if (size < 0) {
+      if (errno == EINTR) continue;
+      warning() << "Unable to reply to the client: " << std::strerror(errno) << endmsg;
+      closeClient();
+      return StatusCode::FAILURE;
+    }
+    sent += size;
+  }
+  return StatusCode::SUCCESS;
+}
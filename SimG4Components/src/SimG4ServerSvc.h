@@ -0,0 +1,76 @@
+#ifndef SIMG4COMPONENTS_G4SERVERSVC_H
+#define SIMG4COMPONENTS_G4SERVERSVC_H
+
+// FCCSW
+#include "SimG4Interface/ISimG4ServerSvc.h"
+
+// Gaudi
+#include "GaudiKernel/Service.h"
+
+// STL
+#include <string>
+
+/** @class SimG4ServerSvc SimG4Components/src/SimG4ServerSvc.h SimG4ServerSvc.h
+ *
+ *  Service of the server mode: the job (with SimG4Alg, SimG4ServerEventProviderTool as its event provider, and an
+ *  unlimited number of events) keeps the initialised geometry and physics and simulates the events requested by the
+ *  clients connected to the local socket \b'socketPath', one client after the other.
+ *  The requests are lines of text:
+ *  - "EVENT", followed by one line per primary particle "pdg x y z t px py pz" (mm, ns, GeV), and "END": an event;
+ *  - "COMMAND <Geant4 command>": a command applied between the events (e.g. /run/setCut 1 mm), answered with
+ *    "OK" or "ERROR <code>";
+ *  - "STOP": the job terminates after the current event.
+ *  The output of each event is sent back by the saving tool SimG4SaveToServer; malformed requests are answered with
+ *  "ERROR <reason>". The server mode is sequential: the events are simulated in the order of the requests.
+ *  A client can apply any Geant4 command, including /control/shell (any shell command with the rights of the job):
+ *  the socket is created accessible to its owner only (0600), and should be placed in a directory where nobody else
+ *  can create files. An existing file at the path is replaced only if it is the socket of a server no longer running.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+ */
+
+class SimG4ServerSvc : public extends1<Service, ISimG4ServerSvc> {
+public:
+  /// Standard constructor
+  explicit SimG4ServerSvc(const std::string& aName, ISvcLocator* aSL);
+  /// Standard destructor
+  virtual ~SimG4ServerSvc();
+  /**  Initialize: create the socket.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize: close the socket.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /**  Wait for the next requested event (from the current client, or from the next one if it disconnected).
+   *   @param[out] aPrimaries primary particles of the event
+   *   @return false if the server was stopped
+   */
+  virtual bool nextEvent(std::vector<Primary>& aPrimaries) final;
+  /**  Send a reply to the current client.
+   *   @param[in] aText text of the reply
+   *   @return status code
+   */
+  virtual StatusCode reply(const std::string& aText) final;
+
+private:
+  /// Read the next line from the current client, waiting for a client if none is connected
+  bool readLine(std::string& aLine);
+  /// Close the connection to the current client
+  void closeClient();
+  /// Path of the socket
+  Gaudi::Property<std::string> m_socketPath{this, "socketPath", "k4simgeant4.sock", "Path of the local socket"};
+  /// Socket listening to the clients
+  int m_listening = -1;
+  /// Connection to the current client (-1: none)
+  int m_client = -1;
+  /// Data received from the current client, not yet read as lines
+  std::string m_received;
+  /// Flag whether the server was stopped
+  bool m_stopped = false;
+  /// Numbers of the requested events and of the clients
+  unsigned long m_numEvents = 0;
+  unsigned long m_numClients = 0;
+};
+
+#endif /* SIMG4COMPONENTS_G4SERVERSVC_H */
@@ -6,6 +6,7 @@
 
 // Gaudi
 #include "GaudiKernel/PhysicalConstants.h"
+#include "GaudiKernel/ThreadLocalContext.h"
 
 // CLHEP
 #include <CLHEP/Random/RandFlat.h>
@@ -18,6 +19,9 @@
 // datamodel
 #include "edm4hep/MCParticleCollection.h"
 
+// STL
+#include <algorithm>
+
 // Declaration of the Tool
 DECLARE_COMPONENT(SimG4SingleParticleGeneratorTool)
 
@@ -35,10 +39,17 @@ StatusCode SimG4SingleParticleGeneratorTool::initialize() {
   if (GaudiTool::initialize().isFailure()) {
     return StatusCode::FAILURE;
   }
-  if (!G4ParticleTable::GetParticleTable()->contains(m_particleName.value())) {
+  m_particleDef = G4ParticleTable::GetParticleTable()->FindParticle(m_particleName.value());
+  if (m_particleDef == nullptr) {
     error() << "Particle " << m_particleName << " cannot be found in G4ParticleTable" << endmsg;
     return StatusCode::FAILURE;
   }
+  debug() << "particle definition " << m_particleDef << " +++ " << m_particleName << ", mass "
+          << m_particleDef->GetPDGMass() << endmsg;
+  if (m_numParticles == 0) {
+    error() << "At least one particle needs to be generated per event" << endmsg;
+    return StatusCode::FAILURE;
+  }
   if (m_energyMin > m_energyMax) {
     error() << "Maximum energy cannot be lower than the minumum energy" << endmsg;
     return StatusCode::FAILURE;
@@ -51,56 +62,87 @@ StatusCode SimG4SingleParticleGeneratorTool::initialize() {
     error() << "Maximum azimuthal angle cannot be lower than the minumum angle" << endmsg;
     return StatusCode::FAILURE;
   }
+  if (m_eventsPerPoint == 0) {
+    error() << "Number of events per point of the scan needs to be positive" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_energies.empty() || !m_etas.empty()) {
+    info() << "Scan of " << std::max<size_t>(1, m_energies.size()) * std::max<size_t>(1, m_etas.size())
+           << " points with " << m_eventsPerPoint << " events each" << endmsg;
+  }
   return StatusCode::SUCCESS;
 }
 
 G4Event* SimG4SingleParticleGeneratorTool::g4Event() {
   auto theEvent = new G4Event();
-  G4ParticleTable* particleTable = G4ParticleTable::GetParticleTable();
-  G4ParticleDefinition* particleDef = particleTable->FindParticle(m_particleName.value());
-  debug() << "particle definition " << particleDef << " +++ " << m_particleName << endmsg;
-  G4double mass = particleDef->GetPDGMass();
-  debug() << "particle mass = " << mass << endmsg;
-
-  double particleEnergy = CLHEP::RandFlat::shoot(m_energyMin, m_energyMax);
-
-  debug() << "particle energy = " << particleEnergy << endmsg;
+  G4double mass = m_particleDef->GetPDGMass();
 
-  double eta = CLHEP::RandFlat::shoot(m_etaMin, m_etaMax);
-  double phi = CLHEP::RandFlat::shoot(m_phiMin, m_phiMax);
+  // point of the scan of the event (all the events of a batch of SimG4Alg share the point)
+  const size_t numEtas = std::max<size_t>(1, m_etas.size());
+  const size_t numPoints = std::max<size_t>(1, m_energies.size()) * numEtas;
+  const size_t point = (Gaudi::Hive::currentContext().evt() / m_eventsPerPoint) % numPoints;
 
-  debug() << "particle eta, phi  = " << eta << " " << phi << endmsg;
-
-  double theta = std::atan(std::exp(-eta)) * 2.;
-  double randomX = std::sin(theta) * std::cos(phi);
-  double randomY = std::sin(theta) * std::sin(phi);
-  double randomZ = std::cos(theta);
-
-  G4ThreeVector particleDir = G4ThreeVector(randomX, randomY, randomZ);
   G4ThreeVector particlePosition = G4ThreeVector(CLHEP::RandFlat::shoot(-m_vertexX, m_vertexX),
                                                  CLHEP::RandFlat::shoot(-m_vertexY, m_vertexY),
                                                  CLHEP::RandFlat::shoot(-m_vertexZ, m_vertexZ));
-
+  // all the particles of the event share the vertex
   G4PrimaryVertex* vertex = new G4PrimaryVertex(particlePosition, 0.);
-  G4PrimaryParticle* part = new G4PrimaryParticle(particleDef);
-
-  part->SetMass(mass);
-  part->SetKineticEnergy(particleEnergy);
-  part->SetMomentumDirection(particleDir);
-  part->SetCharge(particleDef->GetPDGCharge());
 
-  vertex->SetPrimary(part);
-  theEvent->AddPrimaryVertex(vertex);
-  if (m_saveEdm) {
-    saveToEdm(vertex, part).ignore();
+  // axis of the cone (direction of each particle if the particles are independent)
+  G4ThreeVector axis;
+  for (unsigned int iParticle = 0; iParticle < m_numParticles; ++iParticle) {
+    double particleEnergy = m_energies.empty() ? CLHEP::RandFlat::shoot(m_energyMin, m_energyMax)
+                                               : m_energies.value()[point / numEtas];
+
+    debug() << "particle energy = " << particleEnergy << endmsg;
+
+    G4ThreeVector particleDir;
+    if (iParticle == 0 || m_coneAngle <= 0) {
+      double eta = m_etas.empty() ? CLHEP::RandFlat::shoot(m_etaMin, m_etaMax) : m_etas.value()[point % numEtas];
+      double phi = CLHEP::RandFlat::shoot(m_phiMin, m_phiMax);
+
+      debug() << "particle eta, phi  = " << eta << " " << phi << endmsg;
+
+      double theta = std::atan(std::exp(-eta)) * 2.;
+      axis = G4ThreeVector(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+    }
+    if (m_coneAngle > 0) {
+      // uniform in the solid angle of the cone around the axis
+      const double cosTheta = CLHEP::RandFlat::shoot(std::cos(m_coneAngle.value()), 1.);
+      const double sinTheta = std::sqrt(1. - cosTheta * cosTheta);
+      const double phi = CLHEP::RandFlat::shoot(0., 2 * M_PI);
+      particleDir = G4ThreeVector(sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta);
+      particleDir.rotateUz(axis);
+    } else {
+      particleDir = axis;
+    }
+
+    G4PrimaryParticle* part = new G4PrimaryParticle(m_particleDef);
+
+    part->SetMass(mass);
+    part->SetKineticEnergy(particleEnergy);
+    part->SetMomentumDirection(particleDir);
+    part->SetCharge(m_particleDef->GetPDGCharge());
+
+    vertex->SetPrimary(part);
+    if (m_saveEdm) {
+      saveToEdm(vertex, part).ignore();
+    }
   }
+  theEvent->AddPrimaryVertex(vertex);
   return theEvent;
 }
 
 StatusCode SimG4SingleParticleGeneratorTool::saveToEdm(const G4PrimaryVertex* aVertex,
                                                        const G4PrimaryParticle* aParticle) {
-  edm4hep::MCParticleCollection* particles = new edm4hep::MCParticleCollection();
-  edm4hep::MCParticle particle = particles->create();
+  // events generated within the same Gaudi event (batch mode of SimG4Alg) share the collection
+  const auto eventNumber = Gaudi::Hive::currentContext().evt();
+  if (m_genParticles == nullptr || eventNumber != m_genParticlesEvent) {
+    m_genParticles = new edm4hep::MCParticleCollection();
+    m_genParticlesHandle.put(m_genParticles);
+    m_genParticlesEvent = eventNumber;
+  }
+  edm4hep::MCParticle particle = m_genParticles->create();
   particle.setVertex({
        aVertex->GetX0() * sim::g42edm::length,
        aVertex->GetY0() * sim::g42edm::length,
@@ -116,7 +158,5 @@ StatusCode SimG4SingleParticleGeneratorTool::saveToEdm(const G4PrimaryVertex* aV
                (float) (aParticle->GetPz() * sim::g42edm::energy),
     });
   particle.setMass(aParticle->GetMass() * sim::g42edm::energy);
-
-  m_genParticlesHandle.put(particles);
   return StatusCode::SUCCESS;
 }
@@ -3,6 +3,7 @@
 
 // Gaudi
 #include "GaudiAlg/GaudiTool.h"
+#include "GaudiKernel/EventContext.h"
 
 // FCCSW
 #include "k4FWCore/DataHandle.h"
@@ -11,9 +12,13 @@
 // Geant4
 #include "G4SystemOfUnits.hh"
 
+// STL
+#include <vector>
+
 // Forward declarations
 // Geant4
 class G4Event;
+class G4ParticleDefinition;
 class G4PrimaryVertex;
 class G4PrimaryParticle;
 // datamodel
@@ -24,6 +29,14 @@ class MCParticleCollection;
 /** @class SimG4SingleParticleGeneratorTool SimG4SingleParticleGeneratorTool.h "SimG4SingleParticleGeneratorTool.h"
 *
 *  Tool that generates single particles with parameters set via options file.
+*  For calibration campaigns, the energy and pseudorapidity may be scanned over the points of \b'energies' and
+*  \b'etas' (each energy with each eta, the energies in the outer loop) instead of being drawn from their ranges.
+*  \b'eventsPerPoint' consecutive events are generated at each point, the scan is repeated if there are more events.
+*  The point of the Gaudi event number N is (N / eventsPerPoint) % (number of points), which is what the study
+*  algorithms use to fill the histograms of each point.
+*  Each event has \b'numParticles' particles from the same vertex, with independent kinematics, or, if
+*  \b'coneAngle' is set, with directions uniform within a cone of that half-angle around the direction drawn for the
+*  event (jet-like). The particle definition is found at the initialization.
 *
 *  @author Andrea Dell'Acqua, J. Lingemann
 *  @date   2014-10-01
@@ -58,6 +71,13 @@ private:
   Gaudi::Property<double> m_phiMin{this, "phiMin", 0., "Minimum phi of generated particles"};
   /// Maximum phi of the particles generated, set with phiMax
   Gaudi::Property<double> m_phiMax{this, "phiMax", 2 * M_PI, "Maximum phi of generated particles"};
+  /// Energies of the scan (drawn between energyMin and energyMax if empty)
+  Gaudi::Property<std::vector<double>> m_energies{this, "energies", {}, "Energies of the scan of generated particles"};
+  /// Pseudorapidities of the scan (drawn between etaMin and etaMax if empty)
+  Gaudi::Property<std::vector<double>> m_etas{this, "etas", {}, "Eta values of the scan of generated particles"};
+  /// Number of consecutive events generated at each point of the scan
+  Gaudi::Property<unsigned int> m_eventsPerPoint{this, "eventsPerPoint", 1,
+                                                 "Number of consecutive events generated at each point of the scan"};
   /// x position of the vertex associated with the particles generated, set with vertexX
   Gaudi::Property<double> m_vertexX{this, "vertexX", 0};
   /// y position of the vertex associated with the particles generated, set with vertexY
@@ -66,10 +86,21 @@ private:
   Gaudi::Property<double> m_vertexZ{this, "vertexZ", 0};
   /// Name of the generated particle, set with particleName
   Gaudi::Property<std::string> m_particleName{this, "particleName", "geantino", "Name of the generated particles"};
+  /// Number of particles per event
+  Gaudi::Property<unsigned int> m_numParticles{this, "numParticles", 1, "Number of particles generated per event"};
+  /// Half-angle of the cone of the particles (independent directions if 0)
+  Gaudi::Property<double> m_coneAngle{this, "coneAngle", 0,
+                                      "Half-angle of the cone around the event direction (independent if 0)"};
+  /// Definition of the generated particles
+  G4ParticleDefinition* m_particleDef = nullptr;
   /// Flag whether to save primary particle to EDM, set with saveEdm
   Gaudi::Property<bool> m_saveEdm{this, "saveEdm", false};
   /// Handle for the genparticles to be written
   DataHandle<edm4hep::MCParticleCollection> m_genParticlesHandle{"GenParticles", Gaudi::DataHandle::Writer, this};
+  /// Genparticles of the current Gaudi event (owned by the event store)
+  edm4hep::MCParticleCollection* m_genParticles = nullptr;
+  /// Number of the Gaudi event in which the genparticles were put
+  EventContext::ContextEvt_t m_genParticlesEvent = 0;
 };
 
 #endif
@@ -7,6 +7,16 @@
 // Geant4
 #include "G4Event.hh"
 
+// CLHEP
+#include "CLHEP/Vector/ThreeVector.h"
+
+// TBB
+#include "tbb/parallel_for.h"
+
+// STL
+#include <algorithm>
+#include <random>
+
 // datamodel
 #include "edm4hep/MCParticleCollection.h"
 
@@ -29,6 +39,21 @@ StatusCode SimG4SmearGenParticles::initialize() {
     info() << "Generated particels will not be smeared!!!" << endmsg;
     return StatusCode::SUCCESS;
   }
+  if (m_parallelThreshold > 0) {
+    if (m_chunkSize == 0) {
+      error() << "Size of the chunks needs to be positive" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    if (m_flatSeedDist.initialize(randSvc(), Rndm::Flat(0., 4294967296.)).isFailure()) {
+      error() << "Couldn't initialize the random number generator of the seeds" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    m_parallelSmearing = m_smearTool->supportsConcurrentSmearing();
+    if (!m_parallelSmearing) {
+      warning() << "Smearing tool " << m_smearTool.typeAndName()
+                << " cannot smear in parallel, the particles will be smeared sequentially" << endmsg;
+    }
+  }
   return StatusCode::SUCCESS;
 }
 
@@ -36,33 +61,64 @@ StatusCode SimG4SmearGenParticles::execute() {
 
   auto particles = m_particles.createAndPut();
   const edm4hep::MCParticleCollection* coll = m_inParticles.get();
-  info() << "Input particle collection size: " << coll->size() << endmsg;
+  debug() << "Input particle collection size: " << coll->size() << endmsg;
   
-  int n_part = 0;
-  for (const auto& j : *coll) {
-    const edm4hep::MCParticle& MCparticle = j;
+  // momenta of the selected particles are smeared in one call
+  m_selected.clear();
+  m_momenta.clear();
+  m_pdgs.clear();
+  for (size_t i = 0; i < coll->size(); ++i) {
+    const edm4hep::MCParticle& MCparticle = (*coll)[i];
     // save only charged particles, visible in tracker
-    verbose() << "Charge of input particles: " << MCparticle.getCharge() << endmsg;
+    if (msgLevel(MSG::VERBOSE)) {
+      verbose() << "Charge of input particles: " << MCparticle.getCharge() << endmsg;
+    }
 
     if ( MCparticle.getCharge()!=0 || MCparticle.getPDG()==-211 || !m_simTracker){
-      
-      edm4hep::MCParticle particle = MCparticle.clone();
-      // smear momentum according to trackers resolution
       auto edm_mom = MCparticle.getMomentum();
-      CLHEP::Hep3Vector mom = CLHEP::Hep3Vector(edm_mom.x, edm_mom.y, edm_mom.z);
-      //    m_smearTool->checkConditions(5000,10000000,6);
-      m_smearTool->smearMomentum(mom, MCparticle.getPDG()).ignore();
-      particle.setMomentum({
-                (float) mom.x(),
-                (float) mom.y(),
-                (float) mom.z(),
-      });
-      
-      n_part++;
-      particles->push_back(particle);
+      m_selected.push_back(i);
+      m_momenta.emplace_back(edm_mom.x, edm_mom.y, edm_mom.z);
+      m_pdgs.push_back(MCparticle.getPDG());
     }
   }
-  
+  // smear momentum according to trackers resolution
+  const size_t numSmeared = m_momenta.size();
+  if (m_parallelSmearing && numSmeared >= m_parallelThreshold) {
+    // seeds are drawn in the order of the chunks, independently of the threads that smear them
+    const size_t numChunks = (numSmeared + m_chunkSize - 1) / m_chunkSize;
+    m_seeds.resize(numChunks);
+    m_gaussNumbers.resize(numSmeared);
+    for (auto& seed : m_seeds) {
+      seed = static_cast<uint32_t>(m_flatSeedDist());
+    }
+    const size_t chunkSize = m_chunkSize;
+    const ISimG4ParticleSmearTool* smearTool = m_smearTool.get();
+    tbb::parallel_for(size_t(0), numChunks, [&](size_t aChunk) {
+      const size_t first = aChunk * chunkSize;
+      const size_t size = std::min(chunkSize, numSmeared - first);
+      std::mt19937 engine(m_seeds[aChunk]);
+      std::normal_distribution<double> gauss;
+      double* numbers = &m_gaussNumbers[first];
+      for (size_t i = 0; i < size; ++i) {
+        numbers[i] = gauss(engine);
+      }
+      smearTool->smearMomenta(&m_momenta[first], &m_pdgs[first], size, numbers).ignore();
+    });
+  } else {
+    m_smearTool->smearMomenta(m_momenta.data(), m_pdgs.data(), numSmeared).ignore();
+  }
+  for (size_t i = 0; i < m_selected.size(); ++i) {
+    edm4hep::MCParticle particle = (*coll)[m_selected[i]].clone();
+    const CLHEP::Hep3Vector& mom = m_momenta[i];
+    particle.setMomentum({
+              (float) mom.x(),
+              (float) mom.y(),
+              (float) mom.z(),
+    });
+    particles->push_back(particle);
+  }
+  const size_t n_part = m_selected.size();
+
   debug() << "\t" << n_part << " particles are stored in smeared particles collection" << endmsg;
   debug() << "Output particle collection size: " << particles->size() << endmsg;
 
@@ -3,6 +3,7 @@
 
 // Gaudi
 #include "GaudiAlg/GaudiAlgorithm.h"
+#include "GaudiKernel/RndmGenerators.h"
 #include "GaudiKernel/ToolHandle.h"
 
 // FCCSW
@@ -10,6 +11,13 @@
 #include "SimG4Interface/ISimG4SaveOutputTool.h"
 #include "SimG4Interface/ISimG4ParticleSmearTool.h"
 
+// CLHEP
+#include "CLHEP/Vector/ThreeVector.h"
+
+// STL
+#include <cstdint>
+#include <vector>
+
 // datamodel
 namespace edm4hep {
 class MCParticleCollection;
@@ -18,6 +26,10 @@ class MCParticleCollection;
 /** @class SimG4SmearGenParticles SimG4Components/src/SimG4SmearGenParticles.h SimG4SmearGenParticles.h
  *
  *  Smear 'generated' (smeared) particles.
+ *  Events with at least \b'parallelThreshold' smeared particles are smeared in parallel chunks of \b'chunkSize'
+ *  particles, each with its own random number stream seeded from the random number service (so that the result
+ *  does not depend on the number of threads). It requires a smearing tool that accepts the random numbers
+ *  (ISimG4ParticleSmearTool::supportsConcurrentSmearing), otherwise the particles are smeared sequentially.
  *
  *  @author Coralie Neubüser
  */
@@ -49,6 +61,25 @@ class SimG4SmearGenParticles : public GaudiAlgorithm {
   ToolHandle<ISimG4ParticleSmearTool> m_smearTool{"SimG4ParticleSmearRootFile", this};
   /// Flag to decide on wether to only smear and write out charged particles
   Gaudi::Property<bool> m_simTracker{this, "simulateTracker", true};
+  /// Minimum number of smeared particles for which the smearing runs in parallel (0: never)
+  Gaudi::Property<size_t> m_parallelThreshold{this, "parallelThreshold", 0,
+                                              "Minimum number of particles smeared in parallel (0: never)"};
+  /// Number of particles in a chunk smeared with one random number stream
+  Gaudi::Property<size_t> m_chunkSize{this, "chunkSize", 1000, "Number of particles smeared with one random stream"};
+  /// Flag whether the smearing tool accepts the random numbers (can be called in parallel)
+  bool m_parallelSmearing = false;
+  /// Uniform distribution of the seeds of the random number streams of the chunks
+  Rndm::Numbers m_flatSeedDist;
+  /// Seeds of the chunks (reused between events)
+  std::vector<uint32_t> m_seeds;
+  /// Unit Gaussian random numbers of the particles smeared in parallel (reused between events)
+  std::vector<double> m_gaussNumbers;
+  /// Indices of the smeared particles in the input collection (reused between events)
+  std::vector<size_t> m_selected;
+  /// Momenta of the smeared particles (reused between events)
+  std::vector<CLHEP::Hep3Vector> m_momenta;
+  /// PDG codes of the smeared particles (reused between events)
+  std::vector<int> m_pdgs;
 };
 
 #endif /* SIMG4COMPONENTS_G4SAVESMEAREDPARTICLES_H */
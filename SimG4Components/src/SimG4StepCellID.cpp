@@ -0,0 +1,27 @@
+#include "SimG4StepCellID.h"
+
+// Geant4
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4VTouchable.hh"
+
+// DD4hep
+#include "DD4hep/DD4hepUnits.h"
+#include "DDG4/Geant4Mapping.h"
+
+SimG4StepCellID::SimG4StepCellID(const dd4hep::Segmentation& aSegmentation)
+    : m_segmentation(aSegmentation), m_volumeManager(dd4hep::sim::Geant4Mapping::instance().volumeManager()) {}
+
+uint64_t SimG4StepCellID::operator()(const G4Step& aStep) const {
+  const G4VTouchable* touchable = aStep.GetPreStepPoint()->GetTouchable();
+  const dd4hep::VolumeID volumeID = m_volumeManager.volumeID(touchable);
+  if (!m_segmentation.isValid()) {
+    return volumeID;
+  }
+  const G4ThreeVector global = 0.5 * (aStep.GetPreStepPoint()->GetPosition() + aStep.GetPostStepPoint()->GetPosition());
+  const G4ThreeVector local = touchable->GetHistory()->GetTopTransform().TransformPoint(global);
+  const double toDD4hep = dd4hep::mm / CLHEP::mm;
+  return m_segmentation.cellID(dd4hep::Position(local.x() * toDD4hep, local.y() * toDD4hep, local.z() * toDD4hep),
+                               dd4hep::Position(global.x() * toDD4hep, global.y() * toDD4hep, global.z() * toDD4hep),
+                               volumeID);
+}
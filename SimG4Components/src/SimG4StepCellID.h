@@ -0,0 +1,36 @@
+#ifndef SIMG4COMPONENTS_G4STEPCELLID_H
+#define SIMG4COMPONENTS_G4STEPCELLID_H
+
+// DD4hep
+#include "DD4hep/Segmentations.h"
+#include "DDG4/Geant4VolumeManager.h"
+
+// STL
+#include <cstdint>
+
+// Geant4
+class G4Step;
+
+/** @class SimG4StepCellID SimG4Components/src/SimG4StepCellID.h SimG4StepCellID.h
+ *
+ *  Cell ID of the steps in the sensitive volumes of a readout, given by its segmentation at the middle of the step
+ *  (the volume ID if the readout has no segmentation), for the sensitive detectors of SimG4Components.
+ */
+
+class SimG4StepCellID {
+public:
+  /** Constructor.
+   *  @param[in] aSegmentation segmentation of the readout
+   */
+  explicit SimG4StepCellID(const dd4hep::Segmentation& aSegmentation);
+  /// Cell ID of the middle of the step
+  uint64_t operator()(const G4Step& aStep) const;
+
+private:
+  /// Segmentation of the readout
+  dd4hep::Segmentation m_segmentation;
+  /// Volume manager translating the Geant4 touchables into volume IDs
+  dd4hep::sim::Geant4VolumeManager m_volumeManager;
+};
+
+#endif /* SIMG4COMPONENTS_G4STEPCELLID_H */
@@ -1,18 +1,56 @@
 #include "SimG4Svc.h"
 
+// FCCSW
+#include "SimG4Common/HitPools.h"
+#include "SimG4Common/HugePages.h"
+#include "SimG4Common/NumaTopology.h"
+#include "SimG4Common/SubEvents.h"
+#include "SimG4Common/WorkerRunManager.h"
+
 // Gaudi
+#include "Gaudi/Interfaces/IOptionsSvc.h"
+#include "GaudiKernel/IIncidentSvc.h"
+#include "GaudiKernel/IProperty.h"
+#include "GaudiKernel/Incident.h"
 #include "GaudiKernel/IRndmEngine.h"
 #include "GaudiKernel/IToolSvc.h"
+#include "GaudiKernel/ThreadLocalContext.h"
 
 // Geant
+#include "G4EmParameters.hh"
 #include "G4Event.hh"
 #include "G4HadronicProcessStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4SDManager.hh"
 #include "G4UImanager.hh"
 #include "G4UIsession.hh"
 #include "G4UIterminal.hh"
 #include "G4VModularPhysicsList.hh"
+#include "G4VPhysicsConstructor.hh"
+#include "G4Version.hh"
 #include "G4VisExecutive.hh"
 #include "G4VisManager.hh"
+#include "Randomize.hh"
+
+// TBB
+#include "tbb/task_arena.h"
+
+// STL
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sched.h>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
 
 DECLARE_COMPONENT(SimG4Svc)
 
@@ -41,6 +79,16 @@ StatusCode SimG4Svc::initialize() {
     error() << "Unable to locate RndmGen Service" << endmsg;
     return StatusCode::FAILURE;
   }
+  // before the tools allocate their tables (e.g. the field maps)
+  if (m_hugePages) {
+    sim::setHugePages(true);
+    const std::string mode = sim::hugePagesMode();
+    info() << "Transparent huge pages of " << sim::hugePageSize() / (1024 * 1024) << " MB, mode "
+           << (mode.empty() ? "unknown" : mode) << endmsg;
+    if (mode == "never") {
+      warning() << "Transparent huge pages are disabled in the kernel, the memory stays on ordinary pages" << endmsg;
+    }
+  }
   if (!m_detectorTool.retrieve()) {
     error() << "Unable to retrieve detector construction" << endmsg;
     return StatusCode::FAILURE;
@@ -58,18 +106,94 @@ StatusCode SimG4Svc::initialize() {
     return StatusCode::FAILURE;
   }
 
+  if (!m_scanPoints.empty()) {
+    // the configurations follow each other in one run manager
+    if (m_numThreads > 0 || m_sharedCores || m_numProcesses > 1) {
+      error() << "Scans are only available in the sequential mode with a single process" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    if (m_eventsPerScanPoint == 0) {
+      error() << "Number of events per point of the scan needs to be positive" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    // the first point is configured before the initialization
+    bool geometryChanged = false, fieldChanged = false;
+    if (setScanProperties(0, geometryChanged, fieldChanged).isFailure()) {
+      return StatusCode::FAILURE;
+    }
+    info() << "Scan of " << m_scanPoints.size() << " configurations, " << m_eventsPerScanPoint.value()
+           << " events each" << endmsg;
+  }
+
+  // Geant4 workers and scheduler threads share the cores of the job
+  const unsigned int numCores = jobCores();
+  const unsigned int numSchedulerThreads = schedulerThreads();
+  if (m_sharedCores) {
+    m_numThreads = numCores > numSchedulerThreads ? numCores - numSchedulerThreads : 1;
+    info() << m_numThreads.value() << " Geant4 worker threads next to the " << numSchedulerThreads
+           << " threads of the Gaudi scheduler, on " << numCores << " cores" << endmsg;
+  } else if (m_numThreads > 0 && m_numThreads + numSchedulerThreads > numCores) {
+    warning() << m_numThreads.value() << " Geant4 worker threads and " << numSchedulerThreads
+              << " threads of the Gaudi scheduler oversubscribe the " << numCores << " cores of the job" << endmsg;
+  }
+
+  if (m_workerAffinity != "none" && m_workerAffinity != "core" && m_workerAffinity != "numa") {
+    error() << "Unknown pinning of the workers " << m_workerAffinity.value() << " (none, core or numa)" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_costOrdering && m_costPerPrimary < 0) {
+    error() << "Cost per primary particle of the cost ordering needs to be positive or zero" << endmsg;
+    return StatusCode::FAILURE;
+  }
+
+  // the pools of the hits are created by the threads with their first hit
+  sim::setHitPoolPageFactor(m_hitPoolPageFactor);
+
   // Initialize Geant run manager
+  G4RunManager* runManager = nullptr;
+  if (m_numThreads > 0) {
+#ifdef G4MULTITHREADED
+    if (m_numProcesses > 1) {
+      error() << "Worker processes are only available in the sequential mode (numberOfThreads = 0)" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    m_mtRunManager = std::make_unique<sim::MTRunManager>();
+    m_mtRunManager->SetNumberOfThreads(m_numThreads);
+    runManager = m_mtRunManager.get();
+    info() << "Simulation in multi-threaded mode with " << m_numThreads << " worker threads" << endmsg;
+#else
+    error() << "Geant4 was built without multi-threading support, set numberOfThreads to 0" << endmsg;
+    return StatusCode::FAILURE;
+#endif
+  } else {
+    if (m_pipelinedOutput) {
+      warning() << "Pipelined output is only available in the multi-threaded mode (numberOfThreads > 0)" << endmsg;
+    }
+    if (m_numSubEvents > 1) {
+      warning() << "Sub-events are only available in the multi-threaded mode (numberOfThreads > 0)" << endmsg;
+    }
+    if (m_costOrdering) {
+      warning() << "Cost ordering is only available in the multi-threaded mode (numberOfThreads > 0)" << endmsg;
+    }
+    m_runManager = std::make_unique<sim::RunManager>();
+    runManager = m_runManager.get();
+  }
   // Load physics list, deleted in ~G4RunManager()
-  m_runManager.SetUserInitialization(m_physicsListTool->physicsList());
+  runManager->SetUserInitialization(m_physicsListTool->physicsList());
   // Take geometry (from DD4Hep), deleted in ~G4RunManager()
-  m_runManager.SetUserInitialization(m_detectorTool->detectorConstruction());
+  runManager->SetUserInitialization(m_detectorTool->detectorConstruction());
 
   G4UImanager* UImanager = G4UImanager::GetUIpointer();
   for (auto command : m_g4PreInitCommands) {
     UImanager->ApplyCommand(command);
   }
 
-  m_runManager.Initialize();
+  runManager->Initialize();
+  // field managers of the volumes are set once the geometry is constructed (workers set theirs when started)
+  if (m_magneticFieldTool->attachToThread().isFailure()) {
+    error() << "Unable to attach the magnetic field to the geometry" << endmsg;
+    return StatusCode::FAILURE;
+  }
 
   if (m_interactiveMode) {
     m_visManager = std::make_unique<G4VisExecutive>();
@@ -79,8 +203,8 @@ StatusCode SimG4Svc::initialize() {
     m_session->SessionStart();
   }
 
-  // Attach user actions
-  m_runManager.SetUserInitialization(m_actionsTool->userActionInitialization());
+  // Attach user actions (in multi-threaded mode they are built for each worker thread)
+  runManager->SetUserInitialization(m_actionsTool->userActionInitialization());
   if (!msgLevel(MSG::DEBUG)) {
     G4HadronicProcessStore::Instance()->SetVerbose(0);
     UImanager->ApplyCommand("/run/verbose 0");
@@ -104,6 +228,12 @@ StatusCode SimG4Svc::initialize() {
   for (auto command : m_g4PostInitCommands) {
     UImanager->ApplyCommand(command);
   }
+  if (!m_scanPoints.empty()) {
+    applyScanCommands(0);
+  }
+  if (!m_physicsTablesDir.value().empty() && setUpPhysicsTables(*runManager).isFailure()) {
+    return StatusCode::FAILURE;
+  }
 
   // configure the random service
   if (m_rndmFromGaudi) {
@@ -114,16 +244,409 @@ StatusCode SimG4Svc::initialize() {
   }
   info() << "Random numbers seeds: " << CLHEP::HepRandom::getTheSeeds()[0] << "\t" << CLHEP::HepRandom::getTheSeeds()[1]
          << endmsg;
+  if (m_perEventSeeding) {
+    if (m_jobSeed == 0) {
+      std::vector<long> seedsVec;
+      m_randSvc->engine()->seeds(seedsVec).ignore();
+      m_jobSeed = seedsVec.empty() ? 1 : seedsVec[0];
+    }
+    info() << "Random engine reseeded for each event, job seed: " << m_jobSeed.value() << ", from the "
+           << (m_seedFromEventNumber ? "event number of the event ID" : "index of the event in the job") << endmsg;
+  }
 
-  if (!m_runManager.start()) {
+  if (watchdogBudget().enabled()) {
+    info() << "Events aborted after " << m_maxEventCpuTime.value() << " s of CPU time or " << m_maxEventSteps.value()
+           << " steps, tracks killed after " << m_maxTrackSteps.value() << " steps (0: no limit)" << endmsg;
+  }
+  if (m_runManager) {
+    m_runManager->setWatchdog(watchdogBudget());
+  }
+  StatusCode sc = m_mtRunManager ? m_mtRunManager->start() : m_runManager->start();
+  if (!sc) {
     error() << "Unable to initialize GEANT correctly." << endmsg;
     return StatusCode::FAILURE;
   }
+  if (m_storePhysicsTables) {
+    storePhysicsTables();
+  }
+  if (m_mtRunManager && startWorkers().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  // geometry and sensitive detectors of all threads are constructed (e.g. GeoSvc may release its description)
+  SmartIF<IIncidentSvc> incidentSvc(service("IncidentSvc"));
+  if (incidentSvc) {
+    incidentSvc->fireIncident(Incident(name(), "SimG4GeometryConstructed"));
+  }
+  if (!m_checkpointFile.value().empty()) {
+    // the completed events are a prefix of the job only if they are simulated in order
+    if (m_numThreads > 0 || m_numProcesses > 1) {
+      error() << "Checkpoints are only available in the sequential mode with a single process" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    if (m_resume && resumeFromCheckpoint().isFailure()) {
+      return StatusCode::FAILURE;
+    }
+    // the events are completed once the algorithms writing the output were executed
+    m_execStateSvc = service("AlgExecStateSvc");
+    if (!incidentSvc || !m_execStateSvc) {
+      error() << "Unable to locate IncidentSvc and AlgExecStateSvc, needed for the checkpoints" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    incidentSvc->addListener(this, IncidentType::EndEvent);
+  }
+  if (m_numProcesses > 1) {
+    return forkProcesses();
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4Svc::forkProcesses() {
+  SmartIF<IProperty> appMgr(serviceLocator());
+  long numEvents = std::stol(appMgr->getProperty("EvtMax").toString());
+  if (numEvents < 0) {
+    error() << "Worker processes need a fixed number of events (EvtMax)" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  info() << "Forking " << m_numProcesses - 1 << " worker processes, sharing the initialized geometry and physics"
+         << endmsg;
+  for (unsigned int iProcess = 1; iProcess < m_numProcesses; ++iProcess) {
+    pid_t pid = ::fork();
+    if (pid < 0) {
+      error() << "Unable to fork worker process " << iProcess << endmsg;
+      return StatusCode::FAILURE;
+    }
+    if (pid == 0) {
+      m_processIndex = iProcess;
+      m_children.clear();
+      break;
+    }
+    m_children.push_back(pid);
+  }
+  // contiguous slice of the events for this process
+  const long base = numEvents / m_numProcesses;
+  const long remainder = numEvents % m_numProcesses;
+  const long numProcessEvents = base + (static_cast<long>(m_processIndex) < remainder ? 1 : 0);
+  m_firstEvent = m_processIndex * base + std::min<long>(m_processIndex, remainder);
+  if (appMgr->setProperty("EvtMax", std::to_string(numProcessEvents)).isFailure()) {
+    error() << "Unable to set the number of events of worker process " << m_processIndex << endmsg;
+    return StatusCode::FAILURE;
+  }
+  adjustOutputs("_" + std::to_string(m_processIndex));
+  if (!m_perEventSeeding) {
+    // otherwise the seeds depend on the event only
+    long seeds[] = {CLHEP::HepRandom::getTheSeeds()[0] + static_cast<long>(m_processIndex),
+                    CLHEP::HepRandom::getTheSeeds()[1], 0};
+    CLHEP::HepRandom::setTheSeeds(seeds);
+  }
+  info() << "Worker process " << m_processIndex << " (pid " << ::getpid() << ") simulates " << numProcessEvents
+         << " events from event " << m_firstEvent << endmsg;
   return StatusCode::SUCCESS;
 }
 
+void SimG4Svc::adjustOutputs(const std::string& aSuffix) {
+  // properties of the components not yet initialized (e.g. output file names)
+  auto& options = serviceLocator()->getOptsSvc();
+  for (auto& name : m_processOutputs) {
+    std::string value = options.get(name);
+    if (value.size() > 1 && (value.front() == '"' || value.front() == '\'')) {
+      value = value.substr(1, value.size() - 2);
+    }
+    auto extension = value.rfind('.');
+    if (extension == std::string::npos || value.find('/', extension) != std::string::npos) extension = value.size();
+    value.insert(extension, aSuffix);
+    options.set(name, "\"" + value + "\"");
+  }
+  for (auto& name : m_processEventOffsets) {
+    options.set(name, std::to_string(m_firstEvent));
+  }
+}
+
+StatusCode SimG4Svc::resumeFromCheckpoint() {
+  std::ifstream file(m_checkpointFile.value());
+  if (!file) {
+    info() << "No checkpoint " << m_checkpointFile.value() << ", the job starts from the first event" << endmsg;
+    return StatusCode::SUCCESS;
+  }
+  std::string magic;
+  int version = 0;
+  file >> magic >> version;
+  if (magic != kCheckpointMagic || version != 1) {
+    error() << m_checkpointFile.value() << " is not a checkpoint of the simulation" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  long completed = -1;
+  long jobSeed = 0;
+  std::string key;
+  // keys up to the state of the random engine, the outputs of the previous job are only listed for the user
+  while (file >> key && key != "engine") {
+    if (key == "events") {
+      file >> completed;
+    } else if (key == "jobSeed") {
+      file >> jobSeed;
+    }
+    file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+  }
+  if (key != "engine" || completed < 0 || !G4Random::getTheEngine()->get(file)) {
+    error() << "Checkpoint " << m_checkpointFile.value() << " is incomplete" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_perEventSeeding) {
+    m_jobSeed = jobSeed;
+  }
+  SmartIF<IProperty> appMgr(serviceLocator());
+  const long numEvents = std::stol(appMgr->getProperty("EvtMax").toString());
+  if (numEvents >= 0) {
+    const long remaining = std::max(numEvents - completed, 0L);
+    if (appMgr->setProperty("EvtMax", std::to_string(remaining)).isFailure()) {
+      error() << "Unable to set the number of events of the resumed job" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  m_firstEvent = completed;
+  adjustOutputs("_from" + std::to_string(completed));
+  info() << "Job resumed from the checkpoint " << m_checkpointFile.value() << " after " << completed
+         << " completed events" << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4Svc::writeCheckpoint() {
+  // the previous checkpoint is kept until the new one is complete
+  const std::string temporary = m_checkpointFile.value() + ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::trunc);
+    file << kCheckpointMagic << " 1\n";
+    file << "events " << m_firstEvent + static_cast<long>(m_numCompleted) << "\n";
+    file << "jobSeed " << m_jobSeed.value() << "\n";
+    // events completed with the outputs of this job
+    auto& options = serviceLocator()->getOptsSvc();
+    for (auto& name : m_processOutputs) {
+      file << "output " << name << " " << options.get(name) << " " << m_numCompleted << "\n";
+    }
+    file << "engine\n";
+    G4Random::getTheEngine()->put(file);
+    file.close();
+    if (!file) {
+      error() << "Unable to write the checkpoint " << temporary << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  if (std::rename(temporary.c_str(), m_checkpointFile.value().c_str()) != 0) {
+    error() << "Unable to replace the checkpoint " << m_checkpointFile.value() << ": " << std::strerror(errno)
+            << endmsg;
+    return StatusCode::FAILURE;
+  }
+  debug() << "Checkpoint written after " << m_firstEvent + static_cast<long>(m_numCompleted) << " events" << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4Svc::setUpPhysicsTables(const G4RunManager& aRunManager) {
+  std::stringstream key;
+  key << "Geant4 " << G4VERSION_NUMBER << "\nphysics list " << m_physicsListTool.typeAndName() << "\ndefault cut "
+      << aRunManager.GetUserPhysicsList()->GetDefaultCutValue() << "\n";
+  for (auto& command : m_g4PreInitCommands) key << "pre-init " << command << "\n";
+  for (auto& command : m_g4PostInitCommands) key << "post-init " << command << "\n";
+  for (auto& toolname : m_regionToolNames) key << "regions " << toolname << "\n";
+  // constructors of the physics list (that may be configured by the physics list tool)
+  auto modularList = dynamic_cast<const G4VModularPhysicsList*>(aRunManager.GetUserPhysicsList());
+  if (modularList != nullptr) {
+    for (int i = 0; modularList->GetPhysics(i) != nullptr; ++i) {
+      key << "constructor " << modularList->GetPhysics(i)->GetPhysicsName() << "\n";
+    }
+  }
+  key << "gamma general process " << G4EmParameters::Instance()->GeneralProcessActive() << "\n";
+  // production cuts of the regions (set by the region tools)
+  for (const G4Region* region : *G4RegionStore::GetInstance()) {
+    const G4ProductionCuts* cuts = region->GetProductionCuts();
+    if (cuts == nullptr) continue;
+    key << "cuts " << region->GetName();
+    for (double cut : cuts->GetProductionCuts()) key << " " << cut;
+    key << "\n";
+  }
+  m_physicsTablesKey = key.str();
+  std::ifstream keyFile(m_physicsTablesDir.value() + "/physicsTables.key");
+  std::stringstream storedKey;
+  storedKey << keyFile.rdbuf();
+  if (keyFile && storedKey.str() == m_physicsTablesKey) {
+    info() << "Physics tables retrieved from " << m_physicsTablesDir.value() << endmsg;
+    G4UImanager::GetUIpointer()->ApplyCommand("/run/particle/retrievePhysicsTable " + m_physicsTablesDir.value());
+    return StatusCode::SUCCESS;
+  }
+  if (::mkdir(m_physicsTablesDir.value().c_str(), 0755) != 0 && errno != EEXIST) {
+    error() << "Unable to create the physics tables cache " << m_physicsTablesDir.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  info() << "Physics tables do not match the cache, they are built and stored in " << m_physicsTablesDir.value()
+         << endmsg;
+  m_storePhysicsTables = true;
+  return StatusCode::SUCCESS;
+}
+
+void SimG4Svc::storePhysicsTables() {
+  G4UImanager::GetUIpointer()->ApplyCommand("/run/particle/storePhysicsTable " + m_physicsTablesDir.value());
+  // the key is written last, so that the tables are not retrieved before they are all stored
+  std::ofstream keyFile(m_physicsTablesDir.value() + "/physicsTables.key");
+  keyFile << m_physicsTablesKey;
+  if (!keyFile) {
+    warning() << "Unable to write the key of the physics tables cache" << endmsg;
+  }
+}
+
+StatusCode SimG4Svc::startWorkers() {
+  if (m_pipelinedOutput) {
+    info() << "Workers are released before the output is saved (pipelined output)" << endmsg;
+  }
+  // per-thread part of the magnetic field initialization (field managers are thread-local),
+  // watchdog of the events (wrapping the stepping action of the thread)
+  // and per-thread part of the regions (fast simulation models and regional stepping actions are thread-local)
+  // the workers are initialized one after the other, so the tools are not called concurrently
+  const sim::EventWatchdog::Budget budget = watchdogBudget();
+  sim::WorkerThread::Job initThread = [this, budget](sim::WorkerRunManager& aRunManager) {
+    aRunManager.setWatchdog(budget);
+    for (auto& tool : m_regionTools) {
+      if (tool->createForWorker().isFailure()) {
+        error() << "Unable to create the regions of " << tool->name() << " on a worker thread "
+                << "(the tool may not support the multi-threaded mode)" << endmsg;
+        return StatusCode::FAILURE;
+      }
+    }
+    return m_magneticFieldTool->attachToThread();
+  };
+  // the workers are spread over the NUMA domains, so that each domain holds the memory of its workers
+  std::vector<std::vector<int>> cores;
+  if (m_workerAffinity != "none") {
+    cores = sim::workerCores(m_numThreads, m_workerAffinity == "core");
+    info() << "Workers pinned to " << (m_workerAffinity == "core" ? "cores" : "NUMA domains") << " of "
+           << sim::numaDomains().size() << " NUMA domains" << endmsg;
+  }
+  for (unsigned int iThread = 0; iThread < m_numThreads; ++iThread) {
+    // seeds of the workers are drawn from the (already seeded) master engine
+    std::vector<long> seeds = {static_cast<long>(1e8 * G4UniformRand()), static_cast<long>(1e8 * G4UniformRand()), 0};
+    auto worker = std::make_unique<sim::WorkerThread>(*m_mtRunManager, iThread, seeds, initThread,
+                                                      iThread < cores.size() ? cores[iThread] : std::vector<int>());
+    if (worker->initStatus().isFailure()) {
+      error() << "Unable to initialize GEANT worker thread " << iThread << endmsg;
+      return StatusCode::FAILURE;
+    }
+    if (iThread < cores.size() && !worker->pinned()) {
+      warning() << "Unable to pin the worker thread " << iThread << " to its cores" << endmsg;
+    }
+    debug() << "Worker thread " << iThread << " initialized with seeds " << seeds[0] << "\t" << seeds[1] << endmsg;
+    m_idleWorkers.push_back(worker.get());
+    m_workers.push_back(std::move(worker));
+  }
+  return StatusCode::SUCCESS;
+}
+
+unsigned int SimG4Svc::jobCores() {
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  if (::sched_getaffinity(0, sizeof(cpus), &cpus) == 0 && CPU_COUNT(&cpus) > 0) {
+    return CPU_COUNT(&cpus);
+  }
+  return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+unsigned int SimG4Svc::schedulerThreads() {
+  SmartIF<IProperty> scheduler(serviceLocator()->service("AvalancheSchedulerSvc", false));
+  if (!scheduler || !scheduler->hasProperty("ThreadPoolSize")) {
+    // algorithms run in the thread of the event loop
+    return 1;
+  }
+  const long poolSize = std::stol(scheduler->getProperty("ThreadPoolSize").toString());
+  // the scheduler takes the default concurrency of TBB (that of the affinity mask) if not limited
+  return poolSize > 0 ? poolSize : tbb::this_task_arena::max_concurrency();
+}
+
+sim::EventWatchdog::Budget SimG4Svc::watchdogBudget() const {
+  sim::EventWatchdog::Budget budget;
+  budget.maxCpuTime = m_maxEventCpuTime;
+  budget.maxSteps = m_maxEventSteps;
+  budget.maxTrackSteps = m_maxTrackSteps;
+  return budget;
+}
+
+std::vector<sim::WorkerThread*> SimG4Svc::acquireWorkers(size_t aNumWorkers) {
+  std::vector<sim::WorkerThread*> workers;
+  std::unique_lock<std::mutex> lock(m_workersMutex);
+  const auto slot = Gaudi::Hive::currentContext().slot();
+  if (m_activeWorkers.count(slot)) {
+    return workers;
+  }
+  // all the workers are taken at once, so that several slots waiting for workers do not block each other
+  m_workersCond.wait(lock, [this, aNumWorkers]() { return m_idleWorkers.size() >= aNumWorkers; });
+  for (size_t iWorker = 0; iWorker < aNumWorkers; ++iWorker) {
+    workers.push_back(m_idleWorkers.front());
+    m_idleWorkers.pop_front();
+  }
+  m_activeWorkers[slot] = workers.front();
+  return workers;
+}
+
+void SimG4Svc::releaseHelperWorkers(const std::vector<sim::WorkerThread*>& aWorkers) {
+  {
+    std::lock_guard<std::mutex> lock(m_workersMutex);
+    for (size_t iWorker = 1; iWorker < aWorkers.size(); ++iWorker) {
+      m_idleWorkers.push_back(aWorkers[iWorker]);
+    }
+  }
+  m_workersCond.notify_all();
+}
+
+sim::WorkerThread* SimG4Svc::assignedWorker() {
+  std::lock_guard<std::mutex> lock(m_workersMutex);
+  auto it = m_activeWorkers.find(Gaudi::Hive::currentContext().slot());
+  return it == m_activeWorkers.end() ? nullptr : it->second;
+}
+
+void SimG4Svc::releaseWorker() {
+  {
+    std::lock_guard<std::mutex> lock(m_workersMutex);
+    auto it = m_activeWorkers.find(Gaudi::Hive::currentContext().slot());
+    if (it == m_activeWorkers.end()) {
+      return;
+    }
+    m_idleWorkers.push_back(it->second);
+    m_activeWorkers.erase(it);
+  }
+  m_workersCond.notify_all();
+}
+
 StatusCode SimG4Svc::processEvent(G4Event& aEvent) {
-  StatusCode status = m_runManager.processEvent(aEvent);
+  StatusCode status = StatusCode::FAILURE;
+  if (m_mtRunManager) {
+    if (m_numSubEvents > 1 && aEvent.GetNumberOfPrimaryVertex() > 1) {
+      if (processSubEvents(aEvent).isFailure()) {
+        delete &aEvent;
+        return StatusCode::FAILURE;
+      }
+      return StatusCode::SUCCESS;
+    }
+    std::vector<sim::WorkerThread*> workers = acquireWorkers(1);
+    if (workers.empty()) {
+      error() << "Trying to process an event, but previous event has not been terminated" << endmsg;
+      delete &aEvent;
+      return StatusCode::FAILURE;
+    }
+    std::vector<long> seeds = m_perEventSeeding ? eventSeeds(0) : std::vector<long>();
+    status = workers.front()->execute([&aEvent, &seeds](sim::WorkerRunManager& aRunManager) {
+      if (!seeds.empty()) G4Random::setTheSeeds(seeds.data());
+      return aRunManager.processEvent(aEvent);
+    });
+    if (!status) {
+      discardEvent(workers.front(), aEvent);
+    }
+  } else {
+    if (!m_scanPoints.empty() && updateScanPoint().isFailure()) {
+      delete &aEvent;
+      return StatusCode::FAILURE;
+    }
+    if (m_perEventSeeding) {
+      G4Random::setTheSeeds(eventSeeds(0).data());
+    }
+    status = m_runManager->processEvent(aEvent);
+    // the run manager gives the event back if it fails
+    if (!status) delete &aEvent;
+  }
   if (!status) {
     error() << "Unable to process event in Geant" << endmsg;
     return StatusCode::FAILURE;
@@ -131,14 +654,428 @@ StatusCode SimG4Svc::processEvent(G4Event& aEvent) {
   return StatusCode::SUCCESS;
 }
 
-StatusCode SimG4Svc::retrieveEvent(G4Event*& aEvent) { return m_runManager.retrieveEvent(aEvent); }
+StatusCode SimG4Svc::processSubEvents(G4Event& aEvent) {
+  // with the cost ordering, more sub-events than workers may be balanced between them
+  std::vector<G4Event*> subEvents =
+      m_costOrdering ? sim::splitEvent(aEvent, m_numSubEvents, m_costPerPrimary)
+                     : sim::splitEvent(aEvent, std::min<unsigned int>(m_numSubEvents, m_numThreads));
+  debug() << "Event split into " << subEvents.size() << " sub-events" << endmsg;
+  return processAndMerge(aEvent, subEvents);
+}
+
+StatusCode SimG4Svc::processAndMerge(G4Event& aEvent, std::vector<G4Event*>& aParts) {
+  std::vector<sim::WorkerThread*> workers = acquireWorkers(std::min<size_t>(aParts.size(), m_numThreads));
+  if (workers.empty()) {
+    error() << "Trying to process an event, but previous event has not been terminated" << endmsg;
+    for (auto subEvent : aParts) delete subEvent;
+    aParts.clear();
+    return StatusCode::FAILURE;
+  }
+  std::vector<std::vector<long>> seeds(aParts.size());
+  if (m_perEventSeeding) {
+    for (size_t iSub = 0; iSub < aParts.size(); ++iSub) seeds[iSub] = eventSeeds(iSub + 1);
+  }
+  // worker that simulated each part, which deletes it
+  std::vector<sim::WorkerThread*> simulatedBy(aParts.size());
+  std::vector<std::future<StatusCode>> results;
+  if (m_costOrdering) {
+    // parts from the most expensive one, each taken by the first of the workers that is done with its previous part
+    std::vector<size_t> order(aParts.size());
+    std::vector<double> costs(aParts.size());
+    for (size_t iSub = 0; iSub < aParts.size(); ++iSub) {
+      order[iSub] = iSub;
+      costs[iSub] = sim::estimateCost(*aParts[iSub], m_costPerPrimary);
+    }
+    std::stable_sort(order.begin(), order.end(), [&costs](size_t a, size_t b) { return costs[a] > costs[b]; });
+    auto next = std::make_shared<std::atomic<size_t>>(0);
+    for (auto worker : workers) {
+      results.push_back(worker->submit([&aParts, &seeds, &simulatedBy, order, next, worker](
+                                           sim::WorkerRunManager& aRunManager) {
+        for (size_t iNext = (*next)++; iNext < order.size(); iNext = (*next)++) {
+          const size_t iSub = order[iNext];
+          simulatedBy[iSub] = worker;
+          if (!seeds[iSub].empty()) G4Random::setTheSeeds(seeds[iSub].data());
+          G4Event* detached = nullptr;
+          if (aRunManager.processEvent(*aParts[iSub]).isFailure() || aRunManager.detachEvent(detached).isFailure()) {
+            return StatusCode::FAILURE;
+          }
+        }
+        return StatusCode::SUCCESS;
+      }));
+    }
+  } else {
+    for (size_t iSub = 0; iSub < aParts.size(); ++iSub) {
+      G4Event* subEvent = aParts[iSub];
+      const std::vector<long>& subSeeds = seeds[iSub];
+      simulatedBy[iSub] = workers[iSub % workers.size()];
+      // sub-event stays alive (with its hits) after the processing, until merged
+      results.push_back(simulatedBy[iSub]->submit([subEvent, subSeeds](sim::WorkerRunManager& aRunManager) {
+        if (!subSeeds.empty()) G4Random::setTheSeeds(subSeeds.data());
+        if (aRunManager.processEvent(*subEvent).isFailure()) return StatusCode::FAILURE;
+        G4Event* detached = nullptr;
+        return aRunManager.detachEvent(detached);
+      }));
+    }
+  }
+  StatusCode status = StatusCode::SUCCESS;
+  for (auto& result : results) {
+    if (result.get().isFailure()) status = StatusCode::FAILURE;
+  }
+  if (status.isSuccess()) {
+    // merged hits are created by the worker which keeps the event until its termination
+    unsigned int numSkipped = 0;
+    status = workers.front()->execute([&aEvent, &aParts, &numSkipped](sim::WorkerRunManager& aRunManager) {
+      numSkipped = sim::mergeSubEvents(aEvent, aParts);
+      return aRunManager.adoptEvent(aEvent);
+    });
+    if (numSkipped > 0) {
+      warning() << numSkipped << " hits collections of unknown type could not be merged from sub-events" << endmsg;
+    }
+  }
+  // sub-events are deleted by the workers that simulated them (parts not taken after a failure by the first one)
+  for (size_t iSub = 0; iSub < aParts.size(); ++iSub) {
+    G4Event* subEvent = aParts[iSub];
+    sim::WorkerThread* worker = simulatedBy[iSub] != nullptr ? simulatedBy[iSub] : workers.front();
+    worker->submit([this, subEvent](sim::WorkerRunManager&) {
+      releaseEvent(subEvent);
+      return StatusCode::SUCCESS;
+    });
+  }
+  aParts.clear();
+  releaseHelperWorkers(workers);
+  if (!status) {
+    // hits merged before a failed adoption are deleted within the worker that created them, the event by the caller
+    workers.front()
+        ->execute([&aEvent](sim::WorkerRunManager&) {
+          sim::WorkerRunManager::deleteThreadData(aEvent);
+          return StatusCode::SUCCESS;
+        })
+        .ignore();
+    releaseWorker();
+    error() << "Unable to process sub-events in Geant" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4Svc::processEventBatch(std::vector<G4Event*>& aEvents) {
+  if (aEvents.empty()) {
+    error() << "Trying to process an empty batch of events" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  // the merged event is deleted at the termination
+  G4Event* merged = new G4Event(aEvents.front()->GetEventID());
+  if (m_mtRunManager) {
+    if (processAndMerge(*merged, aEvents).isFailure()) {
+      delete merged;
+      return StatusCode::FAILURE;
+    }
+    return StatusCode::SUCCESS;
+  }
+  if (!m_scanPoints.empty() && updateScanPoint().isFailure()) {
+    delete merged;
+    return StatusCode::FAILURE;
+  }
+  StatusCode status = StatusCode::SUCCESS;
+  std::vector<G4Event*> simulated;
+  for (size_t iEvent = 0; iEvent < aEvents.size(); ++iEvent) {
+    if (m_perEventSeeding) {
+      G4Random::setTheSeeds(eventSeeds(iEvent + 1).data());
+    }
+    G4Event* detached = nullptr;
+    if (m_runManager->processEvent(*aEvents[iEvent]).isFailure() ||
+        m_runManager->detachEvent(detached).isFailure()) {
+      status = StatusCode::FAILURE;
+      break;
+    }
+    simulated.push_back(detached);
+  }
+  if (status.isSuccess()) {
+    if (sim::mergeSubEvents(*merged, simulated) > 0) {
+      warning() << "Hits collections of unknown type could not be merged from the batch of events" << endmsg;
+    }
+    status = m_runManager->adoptEvent(*merged);
+  }
+  for (auto event : aEvents) delete event;
+  aEvents.clear();
+  if (!status) {
+    delete merged;
+    error() << "Unable to process the batch of events in Geant" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
+
+std::vector<long> SimG4Svc::eventSeeds(unsigned int aSubEvent) const {
+  const EventContext& context = Gaudi::Hive::currentContext();
+  // event number from the event ID (e.g. set by the input) or the index of the event in the job (shifted by the first
+  // event of the slice in a worker process or of the resumed job)
+  const unsigned long long eventNumber =
+      m_seedFromEventNumber ? context.eventID().event_number() : context.evt() + m_firstEvent;
+  const unsigned long long runNumber = context.eventID().run_number();
+  // splitmix64 mixing of the event identifiers
+  auto mix = [](uint64_t aValue) {
+    aValue += 0x9e3779b97f4a7c15ULL;
+    aValue = (aValue ^ (aValue >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    aValue = (aValue ^ (aValue >> 27)) * 0x94d049bb133111ebULL;
+    return aValue ^ (aValue >> 31);
+  };
+  uint64_t hash = mix(static_cast<uint64_t>(m_jobSeed.value()));
+  hash = mix(hash ^ runNumber);
+  hash = mix(hash ^ eventNumber);
+  hash = mix(hash ^ aSubEvent);
+  // two positive 31-bit seeds, engines do not accept zero seeds
+  long seed1 = static_cast<long>(hash & 0x7fffffff);
+  long seed2 = static_cast<long>((hash >> 32) & 0x7fffffff);
+  if (msgLevel(MSG::DEBUG)) {
+    debug() << "Seeds for run " << runNumber << ", event " << eventNumber << ", sub-event " << aSubEvent << ": "
+            << (seed1 ? seed1 : 1) << "\t" << (seed2 ? seed2 : 1) << endmsg;
+  }
+  return {seed1 ? seed1 : 1, seed2 ? seed2 : 1, 0};
+}
+
+StatusCode SimG4Svc::retrieveEvent(G4Event*& aEvent) {
+  if (m_mtRunManager) {
+    sim::WorkerThread* worker = assignedWorker();
+    if (worker == nullptr) {
+      error() << "Trying to retrieve an event, but no event has been processed by Geant" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    if (!m_pipelinedOutput) {
+      return worker->execute([&aEvent](sim::WorkerRunManager& aRunManager) {
+        return aRunManager.retrieveEvent(aEvent);
+      });
+    }
+    // the event (with hits collections) is taken from the worker, that may start the next event
+    if (worker->execute([&aEvent](sim::WorkerRunManager& aRunManager) { return aRunManager.detachEvent(aEvent); })
+            .isFailure()) {
+      return StatusCode::FAILURE;
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_workersMutex);
+      m_detachedEvents[Gaudi::Hive::currentContext().slot()] = std::make_pair(worker, aEvent);
+    }
+    releaseWorker();
+    return StatusCode::SUCCESS;
+  }
+  return m_runManager->retrieveEvent(aEvent);
+}
 
 StatusCode SimG4Svc::terminateEvent() {
-  m_runManager.terminateEvent().ignore();
+  if (m_mtRunManager) {
+    std::pair<sim::WorkerThread*, G4Event*> detached(nullptr, nullptr);
+    {
+      std::lock_guard<std::mutex> lock(m_workersMutex);
+      auto it = m_detachedEvents.find(Gaudi::Hive::currentContext().slot());
+      if (it != m_detachedEvents.end()) {
+        detached = it->second;
+        m_detachedEvents.erase(it);
+      }
+    }
+    if (detached.first != nullptr) {
+      // hits are deleted within the worker thread that simulated them, once it is done with its current event
+      G4Event* event = detached.second;
+      detached.first->submit([this, event](sim::WorkerRunManager&) {
+        releaseEvent(event);
+        return StatusCode::SUCCESS;
+      });
+      deleteReleasedEvents();
+      return StatusCode::SUCCESS;
+    }
+    sim::WorkerThread* worker = assignedWorker();
+    if (worker != nullptr) {
+      // hits are deleted within the worker thread, the rest of the event within this thread
+      G4Event* event = nullptr;
+      if (worker
+              ->execute([this, &event](sim::WorkerRunManager& aRunManager) {
+                if (aRunManager.detachEvent(event).isFailure()) return StatusCode::FAILURE;
+                sim::WorkerRunManager::deleteThreadData(*event);
+                releaseHitPools();
+                return StatusCode::SUCCESS;
+              })
+              .isSuccess()) {
+        delete event;
+      }
+      releaseWorker();
+    }
+    deleteReleasedEvents();
+    return StatusCode::SUCCESS;
+  }
+  m_runManager->terminateEvent().ignore();
+  releaseHitPools();
+  return StatusCode::SUCCESS;
+}
+
+void SimG4Svc::handle(const Incident& aIncident) {
+  if (aIncident.type() != IncidentType::EndEvent) return;
+  // the failed events are simulated again by the resumed job
+  if (m_execStateSvc->eventStatus(aIncident.context()) != EventStatus::Success) return;
+  ++m_numCompleted;
+  if (m_checkpointInterval > 0 && m_numCompleted % m_checkpointInterval == 0 && writeCheckpoint().isFailure()) {
+    m_checkpointFailed = true;
+  }
+}
+
+void SimG4Svc::discardEvent(sim::WorkerThread* aWorker, G4Event& aEvent) {
+  // hits of an event whose simulation failed are deleted within the worker thread, the rest of the event within this
+  // thread, and the worker is free for the next events
+  aWorker
+      ->execute([this, &aEvent](sim::WorkerRunManager& aRunManager) {
+        G4Event* detached = nullptr;
+        if (aRunManager.GetCurrentEvent() == &aEvent) {
+          aRunManager.detachEvent(detached).ignore();
+        }
+        sim::WorkerRunManager::deleteThreadData(aEvent);
+        releaseHitPools();
+        return StatusCode::SUCCESS;
+      })
+      .ignore();
+  delete &aEvent;
+  releaseWorker();
+}
+
+void SimG4Svc::releaseEvent(G4Event* aEvent) {
+  sim::WorkerRunManager::deleteThreadData(*aEvent);
+  releaseHitPools();
+  std::lock_guard<std::mutex> lock(m_workersMutex);
+  m_releasedEvents.push_back(aEvent);
+}
+
+void SimG4Svc::deleteReleasedEvents() {
+  std::vector<G4Event*> events;
+  {
+    std::lock_guard<std::mutex> lock(m_workersMutex);
+    events.swap(m_releasedEvents);
+  }
+  for (auto event : events) delete event;
+}
+
+void SimG4Svc::releaseHitPools() {
+  if (m_hitPoolReleaseThreshold <= 0) return;
+  m_numHitPoolReleases += sim::releaseHitPools(static_cast<size_t>(m_hitPoolReleaseThreshold * 1024 * 1024));
+}
+
+StatusCode SimG4Svc::setScanProperties(unsigned int aPoint, bool& aGeometryChanged, bool& aFieldChanged) {
+  aGeometryChanged = false;
+  aFieldChanged = false;
+  for (const auto& change : m_scanPoints[aPoint]) {
+    if (change.empty() || change.front() == '/') continue;
+    const auto dot = change.find('.');
+    const auto equal = change.find('=');
+    if (dot == std::string::npos || equal == std::string::npos || dot > equal) {
+      error() << "Invalid change of the point " << aPoint << " of the scan: " << change
+              << ", expected a Geant4 command or tool.property=value" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    const std::string tool = change.substr(0, dot);
+    const std::string property = change.substr(dot + 1, equal - dot - 1);
+    SmartIF<IProperty> properties;
+    if (tool == "detector") {
+      properties = SmartIF<IProperty>(m_detectorTool.get());
+      aGeometryChanged = true;
+    } else if (tool == "magneticField") {
+      properties = SmartIF<IProperty>(m_magneticFieldTool.get());
+      aFieldChanged = true;
+    } else {
+      error() << "Only the properties of the detector and magneticField tools may be scanned, not " << tool << endmsg;
+      return StatusCode::FAILURE;
+    }
+    if (!properties || properties->setProperty(property, change.substr(equal + 1)).isFailure()) {
+      error() << "Unable to set the property " << property << " of the " << tool << " tool" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  return StatusCode::SUCCESS;
+}
+
+void SimG4Svc::applyScanCommands(unsigned int aPoint) {
+  G4UImanager* UImanager = G4UImanager::GetUIpointer();
+  for (const auto& change : m_scanPoints[aPoint]) {
+    if (!change.empty() && change.front() == '/') UImanager->ApplyCommand(change);
+  }
+}
+
+StatusCode SimG4Svc::updateScanPoint() {
+  const unsigned int point = (Gaudi::Hive::currentContext().evt() / m_eventsPerScanPoint) % m_scanPoints.size();
+  if (point == m_scanPoint) {
+    return StatusCode::SUCCESS;
+  }
+  info() << "Configuration " << point << " of the scan" << endmsg;
+  m_runManager->finalize();
+  bool geometryChanged = false, fieldChanged = false;
+  if (setScanProperties(point, geometryChanged, fieldChanged).isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (geometryChanged) {
+    // the sensitive detectors would be registered again with the same names
+    G4SDManager* sdManager = G4SDManager::GetSDMpointerIfExist();
+    if (sdManager != nullptr && sdManager->GetHCtable()->entries() > 0) {
+      error() << "The geometry with sensitive detectors cannot be rebuilt, only changed by Geant4 commands" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    if (m_runManager->rebuildGeometry(m_detectorTool->detectorConstruction()).isFailure()) {
+      error() << "Unable to rebuild the geometry of the configuration " << point << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  if ((geometryChanged || fieldChanged) && m_magneticFieldTool->attachToThread().isFailure()) {
+    error() << "Unable to attach the magnetic field to the geometry" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  applyScanCommands(point);
+  // the volumes changed in place by the commands are optimised again, the physics tables only for the new cuts
+  m_runManager->GeometryHasBeenModified();
+  m_scanPoint = point;
+  if (m_runManager->start().isFailure()) {
+    error() << "Unable to start the run of the configuration " << point << endmsg;
+    return StatusCode::FAILURE;
+  }
   return StatusCode::SUCCESS;
 }
 
 StatusCode SimG4Svc::finalize() {
-  m_runManager.finalize();
-  return Service::finalize();
+  StatusCode status = StatusCode::SUCCESS;
+  if (m_runManager) {
+    // pools of the workers are thread-local, only those of the sequential mode are reported
+    for (const auto& pool : {std::make_pair("Geant4CaloHit", sim::caloHitPoolStatistics()),
+                             std::make_pair("Geant4PreDigiTrackHit", sim::trackHitPoolStatistics())}) {
+      if (pool.second.peakSize == 0) continue;
+      info() << "Pool of " << pool.first << ": peak " << pool.second.peakSize / (1024. * 1024.) << " MB, "
+             << pool.second.numPages << " pages of " << pool.second.pageSize << " bytes at the end, released "
+             << pool.second.numReleases << " times" << endmsg;
+    }
+  } else if (m_numHitPoolReleases > 0) {
+    info() << "Pools of the hits released " << m_numHitPoolReleases << " times" << endmsg;
+  }
+  if (!m_checkpointFile.value().empty() && m_runManager) {
+    if (m_checkpointInterval == 0 || m_numCompleted % m_checkpointInterval != 0) {
+      status = writeCheckpoint();
+    }
+    if (m_checkpointFailed) {
+      error() << "Checkpoints of the job could not be written" << endmsg;
+      status = StatusCode::FAILURE;
+    }
+  }
+  if (m_mtRunManager) {
+    // workers finish their runs and are joined
+    m_idleWorkers.clear();
+    m_activeWorkers.clear();
+    m_detachedEvents.clear();
+    m_workers.clear();
+    // the joined workers had released all their events
+    deleteReleasedEvents();
+    m_mtRunManager->finalize();
+  } else if (m_runManager) {
+    m_runManager->finalize();
+  }
+  for (auto pid : m_children) {
+    int childStatus = 0;
+    if (::waitpid(pid, &childStatus, 0) < 0 || !WIFEXITED(childStatus) || WEXITSTATUS(childStatus) != 0) {
+      error() << "Worker process " << pid << " did not finish successfully" << endmsg;
+      status = StatusCode::FAILURE;
+    }
+  }
+  m_children.clear();
+  if (Service::finalize().isFailure()) return StatusCode::FAILURE;
+  return status;
 }
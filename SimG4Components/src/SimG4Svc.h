@@ -2,7 +2,9 @@
 #define SIMG4COMPONENTS_G4SIMSVC_H
 
 // FCCSW
+#include "SimG4Common/MTRunManager.h"
 #include "SimG4Common/RunManager.h"
+#include "SimG4Common/WorkerThread.h"
 #include "SimG4Interface/ISimG4ActionTool.h"
 #include "SimG4Interface/ISimG4DetectorConstruction.h"
 #include "SimG4Interface/ISimG4MagneticFieldTool.h"
@@ -11,25 +13,53 @@
 #include "SimG4Interface/ISimG4Svc.h"
 
 // Gaudi
+#include "GaudiKernel/EventContext.h"
+#include "GaudiKernel/IAlgExecStateSvc.h"
+#include "GaudiKernel/IIncidentListener.h"
 #include "GaudiKernel/IRndmGenSvc.h"
 #include "GaudiKernel/Service.h"
 #include "GaudiKernel/ToolHandle.h"
 
+#include "G4SystemOfUnits.hh"
 #include "G4UIsession.hh"
 #include "G4UIterminal.hh"
 #include "G4VisExecutive.hh"
 #include "G4VisManager.hh"
 
+// STL
+#include <sys/types.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+
 /** @class SimG4Svc SimG4Components/SimG4Components/SimG4Svc.h SimG4Svc.h
  *
  *  Main Geant simulation service.
  *  It handles Geant initialization (via tools) and communication with the G4RunManager.
+ *  If numberOfThreads is set, events are simulated by Geant4 worker threads (sim::WorkerThread) that share the
+ *  geometry and physics tables of the master run manager (sim::MTRunManager). Events are assigned to the workers
+ *  by event slot, so that several events may be in flight at once (see SimG4ReentrantAlg).
+ *  If checkpointFile is set (sequential mode), the number of completed events and the state of the random engine are
+ *  checkpointed every checkpointInterval events, and a job with resume set continues from the checkpoint. An event
+ *  is completed at its end (EndEvent incident), once the algorithms of the event (with the output) succeeded.
+ *  The pools of the hits of a thread larger than hitPoolReleaseThreshold are released after its events are deleted.
+ *  With hugePages the pools of the hits and the field maps are advised to be backed by transparent huge pages.
+ *  With workerAffinity the workers are pinned to cores or NUMA domains (SimG4Common/NumaTopology.h), spread over them.
+ *  With costOrdering the sub-events and the events of a batch are dispatched from the most expensive one (estimated
+ *  from the primaries) to the first worker done with its previous part, instead of in turn, and the vertices are
+ *  balanced between the sub-events (whose number is then not limited by the number of workers).
+ *  If scanPoints is set (sequential mode), the job scans several configurations, changed every eventsPerScanPoint
+ *  events between two runs (cycling as the points of SimG4SaveSamplingFraction), without initializing the physics
+ *  again: each point lists Geant4 commands and properties of the detector or magnetic field tools
+ *  ("detector.gdml=b.gdml"). The geometry is rebuilt if a property of the detector tool is changed.
  *  [For more information please see](@ref md_sim_doc_geant4fullsim).
  *
  *  @author Anna Zaborowska
  */
 
-class SimG4Svc : public extends1<Service, ISimG4Svc> {
+class SimG4Svc : public extends<Service, ISimG4Svc, IIncidentListener> {
 public:
   /// Standard constructor
   explicit SimG4Svc(const std::string& aName, ISvcLocator* aSL);
@@ -46,10 +76,15 @@ public:
    */
   virtual StatusCode finalize() final;
   /**  Simulate the event with Geant.
-   *   @param[in] aEvent An event to be processed.
+   *   @param[in] aEvent An event to be processed, owned by the service (deleted if the processing fails).
    *   @return status code
    */
   StatusCode processEvent(G4Event& aEvent);
+  /**  Simulate a batch of events with Geant, merged into one event.
+   *   @param[in] aEvents Events to be processed, owned by the service (the vector is emptied).
+   *   @return status code
+   */
+  StatusCode processEventBatch(std::vector<G4Event*>& aEvents);
   /**  Retrieve the processed event.
    *   @param[out] aEvent The processed event.
    *   @return status code
@@ -59,8 +94,127 @@ public:
    *   @return status code
    */
   StatusCode terminateEvent();
+  /**  Count the completed events at the end of each event and write the checkpoints.
+   *   @param[in] aIncident incident (EndEvent)
+   */
+  virtual void handle(const Incident& aIncident) override;
 
 private:
+  /**  Start the worker threads of the multi-threaded mode.
+   *   @return status code
+   */
+  StatusCode startWorkers();
+  /**  Take idle workers, the first one is assigned to the event slot of the current context (blocks until enough
+   *   workers are idle).
+   *   @param[in] aNumWorkers number of workers
+   *   @return the workers (empty if an event is already processed for this slot)
+   */
+  std::vector<sim::WorkerThread*> acquireWorkers(size_t aNumWorkers);
+  /**  Give back the workers that were helping with the sub-events (all but the first, assigned one).
+   *   @param[in] aWorkers workers taken by acquireWorkers()
+   */
+  void releaseHelperWorkers(const std::vector<sim::WorkerThread*>& aWorkers);
+  /**  Simulate the event split into sub-events in parallel, and merge them back.
+   *   @param[in] aEvent An event to be processed.
+   *   @return status code
+   */
+  StatusCode processSubEvents(G4Event& aEvent);
+  /**  Simulate the parts of an event in parallel on the workers, and merge them into the event then assigned to the
+   *   event slot of the current context.
+   *   @param[in] aEvent An event to be filled with the merged output.
+   *   @param[in] aParts Events to be processed, deleted by the workers (the vector is emptied).
+   *   @return status code
+   */
+  StatusCode processAndMerge(G4Event& aEvent, std::vector<G4Event*>& aParts);
+  /**  Seeds of the random engine for the event of the current context, derived from the job seed, the run number,
+   *   the event number and the sub-event index (independent of the thread and of the order of processing).
+   *   @param[in] aSubEvent index of the sub-event (0 if the event is not split)
+   *   @return zero-terminated list of seeds
+   */
+  std::vector<long> eventSeeds(unsigned int aSubEvent) const;
+  /**  Fork the worker processes (numberOfProcesses), each simulating a contiguous slice of the events, after the
+   *   initialization so that the geometry and physics tables are shared copy-on-write.
+   *   @return status code
+   */
+  StatusCode forkProcesses();
+  /**  Append a suffix to the output properties (processOutputs) and set the event offset properties
+   *   (processEventOffsets) to the first event of this process, for the components not yet initialized.
+   *   @param[in] aSuffix suffix of the output files (inserted before the extension)
+   */
+  void adjustOutputs(const std::string& aSuffix);
+  /**  Restore the progress of the job from its checkpoint (checkpointFile): the random engine and the job seed are
+   *   restored, the completed events are removed from EvtMax and the outputs are renamed (as for a process).
+   *   Without a checkpoint the job starts from the first event.
+   *   @return status code
+   */
+  StatusCode resumeFromCheckpoint();
+  /**  Write the progress of the job (number of completed events and state of the random engine) to its checkpoint,
+   *   replacing the previous one only once fully written.
+   *   @return status code
+   */
+  StatusCode writeCheckpoint();
+  /**  Configure the physics tables cache: the tables are retrieved if the cache matches the physics configuration,
+   *   otherwise they are stored once built (see storePhysicsTables()).
+   *   @param[in] aRunManager the (master) run manager, already initialized
+   *   @return status code
+   */
+  StatusCode setUpPhysicsTables(const G4RunManager& aRunManager);
+  /**  Store the built physics tables in the cache, and mark it valid for the physics configuration.
+   */
+  void storePhysicsTables();
+  /**  Hand an event from its worker to the Gaudi threads: the worker deletes its hits (with the thread-local
+   *   allocators of the worker) and the rest of the event is deleted by the next Gaudi thread terminating an event.
+   *   To be called within the worker thread.
+   *   @param[in] aEvent event detached from the worker
+   */
+  void releaseEvent(G4Event* aEvent);
+  /**  Delete an event whose simulation failed, with its hits deleted within the worker that simulated it, and give
+   *   back the worker.
+   *   @param[in] aWorker worker assigned to the event
+   *   @param[in] aEvent event that failed
+   */
+  void discardEvent(sim::WorkerThread* aWorker, G4Event& aEvent);
+  /**  Delete the events released by the workers, within the calling (Gaudi) thread.
+   */
+  void deleteReleasedEvents();
+  /**  Release the pools of the hits of the calling thread above hitPoolReleaseThreshold, once its events are deleted.
+   */
+  void releaseHitPools();
+  /**  Get the worker assigned to the event slot of the current context.
+   *   @return the worker (nullptr if no event is processed for this slot)
+   */
+  sim::WorkerThread* assignedWorker();
+  /**  Give back the worker assigned to the event slot of the current context.
+   */
+  void releaseWorker();
+  /**  Number of the cores the job may run on (its CPU affinity mask, e.g. restricted to a NUMA domain).
+   */
+  static unsigned int jobCores();
+  /**  Number of the threads of the Gaudi scheduler (ThreadPoolSize of AvalancheSchedulerSvc, the concurrency of the
+   *   TBB arena if not limited, 1 without the scheduler).
+   */
+  unsigned int schedulerThreads();
+  /**  Set the properties of the tools of a point of the scan (entries "detector.<property>=<value>" or
+   *   "magneticField.<property>=<value>").
+   *   @param[in] aPoint index of the point in scanPoints
+   *   @param[out] aGeometryChanged whether a property of the detector tool was set
+   *   @param[out] aFieldChanged whether a property of the magnetic field tool was set
+   *   @return status code
+   */
+  StatusCode setScanProperties(unsigned int aPoint, bool& aGeometryChanged, bool& aFieldChanged);
+  /**  Apply the Geant4 commands of a point of the scan (entries starting with '/').
+   *   @param[in] aPoint index of the point in scanPoints
+   */
+  void applyScanCommands(unsigned int aPoint);
+  /**  Move to the point of the scan of the current event if it changed: the run is terminated, the configuration
+   *   changed (the geometry rebuilt if needed) and a new run started with the same physics.
+   *   @return status code
+   */
+  StatusCode updateScanPoint();
+  /**  Budgets of the events for the watchdog of the run managers (maxEventCpuTime, maxEventSteps, maxTrackSteps).
+   */
+  sim::EventWatchdog::Budget watchdogBudget() const;
+
   /// Pointer to the tool service
   SmartIF<IToolSvc> m_toolSvc;
   /// Pointer to the random numbers service
@@ -89,10 +243,144 @@ private:
   /// Flag whether random numbers seeds should be taken from Gaudi (default: true)
   Gaudi::Property<bool> m_rndmFromGaudi{this, "randomNumbersFromGaudi", true, "Whether random numbers should be taken from Gaudi"};
 
+  /// Flag whether the random engine should be reseeded for each event
+  Gaudi::Property<bool> m_perEventSeeding{
+      this, "perEventSeeding", false,
+      "Reseed the random engine for each event from the job seed, the run number and the event number"};
+  /// Seed of the job used for the per-event seeding (0: taken from Gaudi random engine)
+  Gaudi::Property<long> m_jobSeed{this, "jobSeed", 0,
+                                  "Seed of the job for the per-event seeding (0: taken from the Gaudi random engine)"};
+  /// Flag whether the per-event seeds use the event number of the event ID instead of the index of the event in the job
+  Gaudi::Property<bool> m_seedFromEventNumber{
+      this, "seedFromEventNumber", false,
+      "Per-event seeds from the event number of the event ID (e.g. set by the input) instead of the event index"};
+
+  /// Directory caching the physics tables (no caching if empty)
+  Gaudi::Property<std::string> m_physicsTablesDir{
+      this, "physicsTablesCache", "",
+      "Directory where physics tables are stored by the first job and retrieved by the next ones (no caching if empty)"};
+  /// Key of the physics configuration (Geant4 version, physics list, cuts and commands) the tables are built for
+  std::string m_physicsTablesKey;
+  /// Flag whether the physics tables should be stored once built (cache missing or not matching)
+  bool m_storePhysicsTables = false;
+
+  /// Budget of CPU time of an event before it is aborted (0: no limit)
+  Gaudi::Property<double> m_maxEventCpuTime{this, "maxEventCpuTime", 0,
+                                            "CPU time [s] after which an event is aborted (0: no limit)"};
+  /// Budget of steps of an event before it is aborted (0: no limit)
+  Gaudi::Property<unsigned long> m_maxEventSteps{this, "maxEventSteps", 0,
+                                                 "Number of steps after which an event is aborted (0: no limit)"};
+  /// Budget of steps of a track before it is killed (0: no limit)
+  Gaudi::Property<unsigned long> m_maxTrackSteps{this, "maxTrackSteps", 0,
+                                                 "Number of steps after which a track is killed (0: no limit)"};
   Gaudi::Property<bool> m_interactiveMode{this, "InteractiveMode", false, "Enter the interactive mode"};
 
-  /// Run Manager
-  sim::RunManager m_runManager;
+  /// Number of Geant4 worker threads (0: sequential mode)
+  Gaudi::Property<unsigned int> m_numThreads{this, "numberOfThreads", 0,
+                                             "Number of Geant4 worker threads (0: sequential simulation)"};
+  /// Flag whether the Geant4 workers take the cores of the job not used by the threads of the Gaudi scheduler
+  Gaudi::Property<bool> m_sharedCores{
+      this, "sharedCores", false,
+      "Use as many Geant4 worker threads as the cores of the job not used by the threads of the Gaudi scheduler"};
+  /// Pinning of the Geant4 workers: none, core (one core each) or numa (the cores of one NUMA domain each)
+  Gaudi::Property<std::string> m_workerAffinity{
+      this, "workerAffinity", "none",
+      "Pinning of the Geant4 workers: none, core (one core each) or numa (all the cores of one NUMA domain each)"};
+
+  /// Flag whether workers should be released before the output is saved (multi-threaded mode)
+  Gaudi::Property<bool> m_pipelinedOutput{
+      this, "pipelinedOutput", false,
+      "Release the worker once the event is simulated, so that it simulates the next event while the output is saved"};
+
+  /// Number of sub-events into which events are split (multi-threaded mode, 0 or 1: no splitting)
+  Gaudi::Property<unsigned int> m_numSubEvents{
+      this, "numberOfSubEvents", 0,
+      "Number of sub-events (subsets of primary vertices) simulated in parallel for each event (0: no splitting)"};
+
+  /// Flag whether the sub-events and the events of a batch are dispatched in the decreasing order of their cost
+  Gaudi::Property<bool> m_costOrdering{
+      this, "costOrdering", false,
+      "Dispatch the sub-events and the events of a batch from the most expensive one to the first idle worker"};
+  /// Fixed cost of a primary particle, in addition to its kinetic energy, in the estimated cost of the events
+  Gaudi::Property<double> m_costPerPrimary{this, "costPerPrimary", 1 * CLHEP::GeV,
+                                           "Fixed cost of a primary particle (as kinetic energy) in the cost ordering"};
+
+  /// Number of processes simulating the events (sequential mode, 0 or 1: no forking)
+  Gaudi::Property<unsigned int> m_numProcesses{
+      this, "numberOfProcesses", 0,
+      "Number of processes (forked after the initialization) simulating slices of the events (0: no forking)"};
+  /// Properties (Component.property) of the output file names, suffixed by the index of the process
+  Gaudi::Property<std::vector<std::string>> m_processOutputs{
+      this, "processOutputs", {}, "Properties of output files (Component.property) suffixed with the process index"};
+  /// Properties (Component.property) set to the first event of the slice of the process (e.g. of the input reader)
+  Gaudi::Property<std::vector<std::string>> m_processEventOffsets{
+      this, "processEventOffsets", {}, "Properties (Component.property) set to the first event of the process"};
+  /// Index of this process (0: parent process)
+  unsigned int m_processIndex = 0;
+  /// Index (in the job) of the first event simulated by this process
+  long m_firstEvent = 0;
+  /// Worker processes forked by this (parent) process
+  std::vector<pid_t> m_children;
+
+  /// File of the checkpoints of the job (no checkpoints if empty)
+  Gaudi::Property<std::string> m_checkpointFile{
+      this, "checkpointFile", "", "File where the progress of the job is checkpointed (no checkpoints if empty)"};
+  /// Number of events between the checkpoints (0: only at the end of the job)
+  Gaudi::Property<unsigned int> m_checkpointInterval{this, "checkpointInterval", 100,
+                                                     "Number of events between the checkpoints (0: only at the end)"};
+  /// Flag whether the job is resumed from its checkpoint
+  Gaudi::Property<bool> m_resume{this, "resume", false,
+                                 "Resume the job from its checkpoint, skipping the completed events"};
+  /// Number of events completed by this job (with their output)
+  unsigned long m_numCompleted = 0;
+  /// Flag whether writing a checkpoint failed (the job fails at the finalisation)
+  bool m_checkpointFailed = false;
+  /// Service of the execution states, with the status of the ending event
+  SmartIF<IAlgExecStateSvc> m_execStateSvc;
+
+  /// Changes of the configuration at each point of the scan (Geant4 commands and properties of the tools)
+  Gaudi::Property<std::vector<std::vector<std::string>>> m_scanPoints{
+      this, "scanPoints", {}, "Changes of each configuration of the scan: Geant4 commands or tool.property=value"};
+  /// Number of events simulated with each configuration of the scan
+  Gaudi::Property<unsigned int> m_eventsPerScanPoint{this, "eventsPerScanPoint", 0,
+                                                     "Number of events simulated with each configuration of the scan"};
+  /// Index of the current point of the scan
+  unsigned int m_scanPoint = 0;
+
+  /// Factor by which the page size of the pools of the hits is increased
+  Gaudi::Property<unsigned int> m_hitPoolPageFactor{
+      this, "hitPoolPageFactor", 1, "Factor of the page size of the G4Allocator pools of the hits (1: default)"};
+  /// Size of the pools of the hits above which they are released after an event [MB] (0: never)
+  Gaudi::Property<double> m_hitPoolReleaseThreshold{
+      this, "hitPoolReleaseThreshold", 0,
+      "Size of the pools of the hits of a thread above which they are released after an event [MB] (0: never)"};
+  /// Flag whether the pools of the hits and the field maps are placed on transparent huge pages
+  Gaudi::Property<bool> m_hugePages{this, "hugePages", false,
+                                    "Place the pools of the hits and the field maps on transparent huge pages"};
+  /// Number of the releases of the pools of the hits (all threads)
+  std::atomic<unsigned long> m_numHitPoolReleases{0};
+  /// Magic string of the checkpoints
+  static constexpr const char* kCheckpointMagic = "K4SIMCHECKPOINT";
+
+  /// Run Manager (sequential mode)
+  std::unique_ptr<sim::RunManager> m_runManager;
+  /// Master Run Manager (multi-threaded mode)
+  std::unique_ptr<sim::MTRunManager> m_mtRunManager;
+  /// Worker threads (multi-threaded mode)
+  std::vector<std::unique_ptr<sim::WorkerThread>> m_workers;
+  /// Workers waiting for an event
+  std::deque<sim::WorkerThread*> m_idleWorkers;
+  /// Workers processing an event, by the event slot that submitted it
+  std::map<EventContext::ContextID_t, sim::WorkerThread*> m_activeWorkers;
+  /// Events detached from their workers (pipelined output), with the worker that simulated them, by event slot
+  std::map<EventContext::ContextID_t, std::pair<sim::WorkerThread*, G4Event*>> m_detachedEvents;
+  /// Events whose worker data (hits) were deleted by their worker, to be deleted (with their primaries) by a Gaudi
+  /// thread, in whose pools they were allocated
+  std::vector<G4Event*> m_releasedEvents;
+  /// Mutex guarding the workers bookkeeping
+  std::mutex m_workersMutex;
+  /// Condition signalling an idle worker
+  std::condition_variable m_workersCond;
 
   std::unique_ptr<G4VisManager> m_visManager{nullptr};
   // Define UI terminal for interactive mode
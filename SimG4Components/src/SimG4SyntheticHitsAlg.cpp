@@ -0,0 +1,180 @@
+#include "SimG4SyntheticHitsAlg.h"
+
+// FCCSW
+#include "SimG4Common/Geant4CaloHit.h"
+#include "SimG4Common/Geant4PreDigiTrackHit.h"
+#include "SimG4Common/HitBuffer.h"
+#include "SimG4Common/Units.h"
+#include "SimG4Interface/IGeoSvc.h"
+#include "SimG4Interface/ISimG4SaveOutputTool.h"
+
+// Geant4
+#include "G4Event.hh"
+#include "G4HCofThisEvent.hh"
+
+// DD4hep
+#include "DD4hep/Detector.h"
+
+// datamodel
+#include "edm4hep/CalorimeterHitCollection.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+
+DECLARE_COMPONENT(SimG4SyntheticHitsAlg)
+
+namespace {
+/// Number of tracks to which the synthetic hits are attributed
+const unsigned int kNumTracks = 100;
+/// Length of the steps of the synthetic tracker hits [mm]
+const double kStepLength = 0.1;
+}
+
+SimG4SyntheticHitsAlg::SimG4SyntheticHitsAlg(const std::string& aName, ISvcLocator* aSvcLoc)
+    : GaudiAlgorithm(aName, aSvcLoc), m_geoSvc("GeoSvc", aName) {
+  declareProperty("GeoSvc", m_geoSvc);
+  declareProperty("caloHits", m_caloHits, "Handle for the generated hits");
+}
+
+StatusCode SimG4SyntheticHitsAlg::initialize() {
+  if (GaudiAlgorithm::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (!m_geoSvc) {
+    error() << "Unable to locate Geometry Service. "
+            << "Make sure you have GeoSvc and SimSvc in the right order in the configuration." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  auto readouts = m_geoSvc->lcdd()->readouts();
+  if (readouts.find(m_readoutName) == readouts.end()) {
+    error() << "Readout " << m_readoutName.value() << " not found! Please check the configuration." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_decoder = m_geoSvc->lcdd()->readout(m_readoutName).idSpec().decoder();
+  m_ranges.clear();
+  const auto& fields = m_decoder->fields();
+  for (size_t iField = 0; iField < fields.size(); ++iField) {
+    FieldRange range{iField, static_cast<long>(fields[iField].minValue()),
+                     static_cast<long>(fields[iField].maxValue())};
+    auto given = m_fieldRanges.value().find(fields[iField].name());
+    if (given != m_fieldRanges.value().end()) {
+      if (given->second.size() != 2 || given->second[0] > given->second[1] || given->second[0] < range.min ||
+          given->second[1] > range.max) {
+        error() << "Range of the field " << given->first << " needs a minimum and a maximum within [" << range.min
+                << ", " << range.max << "]" << endmsg;
+        return StatusCode::FAILURE;
+      }
+      range.min = given->second[0];
+      range.max = given->second[1];
+    }
+    m_ranges.push_back(range);
+  }
+  for (const auto& given : m_fieldRanges.value()) {
+    if (std::none_of(fields.begin(), fields.end(), [&given](const dd4hep::DDSegmentation::BitFieldElement& aField) {
+          return aField.name() == given.first;
+        })) {
+      warning() << "Range given for the field " << given.first << " that is not in the readout "
+                << m_readoutName.value() << endmsg;
+    }
+  }
+  if (!m_g4Hits.value().empty() && m_g4Hits.value() != "calo" && m_g4Hits.value() != "tracker") {
+    error() << "Type of the Geant4 hits needs to be calo or tracker, not " << m_g4Hits.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  for (auto& toolname : m_saveToolNames) {
+    m_saveTools.push_back(tool<ISimG4SaveOutputTool>(toolname));
+  }
+  if (!m_saveTools.empty() && m_g4Hits.value().empty()) {
+    warning() << "Saving tools given without Geant4 hits (property g4Hits), they will see no hits" << endmsg;
+  }
+  if (m_flat.initialize(randSvc(), Rndm::Flat(0, 1)).isFailure()) {
+    error() << "Couldn't initialize the random number generator" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  info() << "Generating " << m_numHits.value() << " hits per event of the readout " << m_readoutName.value()
+         << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4SyntheticHitsAlg::execute() {
+  const size_t numHits = m_numHits;
+  m_cellIDs.resize(numHits);
+  m_x.resize(numHits);
+  m_y.resize(numHits);
+  m_z.resize(numHits);
+  m_energy.resize(numHits);
+  const auto& fields = m_decoder->fields();
+  for (size_t iHit = 0; iHit < numHits; ++iHit) {
+    dd4hep::DDSegmentation::CellID cellID = 0;
+    for (const auto& range : m_ranges) {
+      const long value = range.min + static_cast<long>(std::floor(m_flat() * (range.max - range.min + 1)));
+      fields[range.index].set(cellID, std::min(value, range.max));
+    }
+    m_cellIDs[iHit] = cellID;
+    m_x[iHit] = (2 * m_flat() - 1) * m_positionRange;
+    m_y[iHit] = (2 * m_flat() - 1) * m_positionRange;
+    m_z[iHit] = (2 * m_flat() - 1) * m_positionRange;
+    m_energy[iHit] = m_flat() * m_maxEnergy;
+  }
+  if (m_createCaloHits) {
+    auto edmHits = m_caloHits.createAndPut();
+    for (size_t iHit = 0; iHit < numHits; ++iHit) {
+      auto edmHit = edmHits->create();
+      edmHit.setCellID(m_cellIDs[iHit]);
+      edmHit.setEnergy(m_energy[iHit]);
+      edmHit.setPosition({(float) m_x[iHit], (float) m_y[iHit], (float) m_z[iHit]});
+    }
+  }
+  if (!m_g4Hits.value().empty()) {
+    // the hits are deleted with the event, in this thread
+    G4Event event;
+    fillG4Hits(event);
+    for (auto tool : m_saveTools) {
+      tool->saveOutput(event).ignore();
+    }
+  }
+  return StatusCode::SUCCESS;
+}
+
+void SimG4SyntheticHitsAlg::fillG4Hits(G4Event& aEvent) {
+  const bool tracker = m_g4Hits.value() == "tracker";
+  const size_t numHits = m_cellIDs.size();
+  auto collections = new G4HCofThisEvent(1);
+  aEvent.SetHCofThisEvent(collections);
+  if (m_buffer) {
+    auto buffer = new sim::HitBuffer("SyntheticHits", m_readoutName.value(), tracker, numHits);
+    for (size_t iHit = 0; iHit < numHits; ++iHit) {
+      const double energy = m_energy[iHit] * sim::edm2g4::energy;
+      const int trackId = iHit % kNumTracks + 1;
+      if (tracker) {
+        buffer->add(m_cellIDs[iHit], energy, m_x[iHit], m_y[iHit], m_z[iHit], 0, trackId, 11, m_x[iHit], m_y[iHit],
+                    m_z[iHit] + kStepLength);
+      } else {
+        buffer->add(m_cellIDs[iHit], energy, m_x[iHit], m_y[iHit], m_z[iHit], 0, trackId, 11);
+      }
+    }
+    collections->AddHitsCollection(0, buffer);
+  } else if (tracker) {
+    auto hits = new G4THitsCollection<k4::Geant4PreDigiTrackHit>("SyntheticHits", m_readoutName.value());
+    for (size_t iHit = 0; iHit < numHits; ++iHit) {
+      auto hit = new k4::Geant4PreDigiTrackHit(iHit % kNumTracks + 1, 11, m_energy[iHit] * sim::edm2g4::energy, 0);
+      hit->cellID = m_cellIDs[iHit];
+      hit->prePos = CLHEP::Hep3Vector(m_x[iHit], m_y[iHit], m_z[iHit]);
+      hit->postPos = CLHEP::Hep3Vector(m_x[iHit], m_y[iHit], m_z[iHit] + kStepLength);
+      hits->insert(hit);
+    }
+    collections->AddHitsCollection(0, hits);
+  } else {
+    auto hits = new G4THitsCollection<k4::Geant4CaloHit>("SyntheticHits", m_readoutName.value());
+    for (size_t iHit = 0; iHit < numHits; ++iHit) {
+      auto hit = new k4::Geant4CaloHit(iHit % kNumTracks + 1, 11, m_energy[iHit] * sim::edm2g4::energy, 0);
+      hit->cellID = m_cellIDs[iHit];
+      hit->position = CLHEP::Hep3Vector(m_x[iHit], m_y[iHit], m_z[iHit]);
+      hits->insert(hit);
+    }
+    collections->AddHitsCollection(0, hits);
+  }
+}
+
+StatusCode SimG4SyntheticHitsAlg::finalize() { return GaudiAlgorithm::finalize(); }
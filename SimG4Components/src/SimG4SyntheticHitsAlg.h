@@ -0,0 +1,108 @@
+#ifndef SIMG4COMPONENTS_G4SYNTHETICHITSALG_H
+#define SIMG4COMPONENTS_G4SYNTHETICHITSALG_H
+
+// Gaudi
+#include "GaudiAlg/GaudiAlgorithm.h"
+#include "GaudiKernel/RndmGenerators.h"
+#include "GaudiKernel/ServiceHandle.h"
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+
+// DD4hep
+#include "DDSegmentation/BitFieldCoder.h"
+
+// STL
+#include <map>
+#include <string>
+#include <vector>
+
+class IGeoSvc;
+class ISimG4SaveOutputTool;
+class G4Event;
+
+// datamodel
+namespace edm4hep {
+class CalorimeterHitCollection;
+}
+
+/** @class SimG4SyntheticHitsAlg SimG4Components/src/SimG4SyntheticHitsAlg.h SimG4SyntheticHitsAlg.h
+ *
+ *  Generates \b'numHits' hits with random cellIDs of the readout \b'readout', to measure the throughput of the hit
+ *  conversion and cellID transformation algorithms without simulating the events.
+ *  Each field of the bit field takes uniformly a value of its range in \b'fieldRanges' (minimum and maximum, the
+ *  whole range of the field if not given), so that the ranges set how many hits fall in the same cell. The positions
+ *  are uniform in a cube of half-size \b'positionRange' (mm) and the energies in [0, \b'maxEnergy'] (GeV).
+ *  The hits are stored as a CalorimeterHitCollection (\b'caloHits', if \b'createCaloHits' is set), the input of the
+ *  algorithms of DetComponents (e.g. MergeCells, RewriteBitfield, RedoSegmentation).
+ *  If \b'g4Hits' is "calo" or "tracker", the same hits are also filled, as Geant4 hits (or as a hit buffer of the
+ *  buffered sensitive detectors if \b'buffer' is set) named after the readout, in a G4Event passed to the saving
+ *  tools \b'outputs' (e.g. SimG4SaveCalHits, SimG4SaveTrackerHits), if any.
+ *  It is used by the benchmark tests/scripts/kernel_benchmark.py.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+ */
+
+class SimG4SyntheticHitsAlg : public GaudiAlgorithm {
+public:
+  SimG4SyntheticHitsAlg(const std::string& aName, ISvcLocator* aSvcLoc);
+  /**  Initialize. Resolves the ranges of the fields of the readout and retrieves the saving tools.
+   *   @return status code
+   */
+  StatusCode initialize();
+  /**  Generate the hits of the event and pass them to the saving tools.
+   *   @return status code
+   */
+  StatusCode execute();
+  /**  Finalize.
+   *   @return status code
+   */
+  StatusCode finalize();
+
+private:
+  /// Range of values drawn for a field of the bit field
+  struct FieldRange {
+    size_t index;
+    long min;
+    long max;
+  };
+  /** Fill the hits collection of the readout in the hits collections of an event.
+   *  @param[in] aEvent event whose hits collections are created
+   */
+  void fillG4Hits(G4Event& aEvent);
+  /// Pointer to the geometry service
+  ServiceHandle<IGeoSvc> m_geoSvc;
+  /// Handle for the generated hits
+  DataHandle<edm4hep::CalorimeterHitCollection> m_caloHits{"caloHits", Gaudi::DataHandle::Writer, this};
+  /// Name of the readout
+  Gaudi::Property<std::string> m_readoutName{this, "readout", "", "Name of the readout of the cellIDs"};
+  /// Number of hits per event
+  Gaudi::Property<unsigned int> m_numHits{this, "numHits", 1000, "Number of hits generated per event"};
+  /// Ranges of the fields (others take the whole range of their bits)
+  Gaudi::Property<std::map<std::string, std::vector<long>>> m_fieldRanges{
+      this, "fieldRanges", {}, "Minimum and maximum values of the fields (default: whole range of the field)"};
+  /// Half-size of the cube of the positions
+  Gaudi::Property<double> m_positionRange{this, "positionRange", 1000, "Half-size of the cube of the positions [mm]"};
+  /// Maximal energy of the hits
+  Gaudi::Property<double> m_maxEnergy{this, "maxEnergy", 0.01, "Maximal energy of the hits [GeV]"};
+  /// Flag whether the CalorimeterHitCollection is stored
+  Gaudi::Property<bool> m_createCaloHits{this, "createCaloHits", true, "Store the hits as a CalorimeterHitCollection"};
+  /// Type of the Geant4 hits passed to the saving tools
+  Gaudi::Property<std::string> m_g4Hits{this, "g4Hits", "", "Geant4 hits passed to the saving tools: calo, tracker"};
+  /// Flag whether the Geant4 hits are stored in a hit buffer
+  Gaudi::Property<bool> m_buffer{this, "buffer", false, "Store the Geant4 hits in a hit buffer (sim::HitBuffer)"};
+  /// Names of the saving tools
+  Gaudi::Property<std::vector<std::string>> m_saveToolNames{this, "outputs", {}, "Names of the saving tools"};
+  /// Saving tools
+  std::vector<ISimG4SaveOutputTool*> m_saveTools;
+  /// Ranges of the fields of the bit field
+  std::vector<FieldRange> m_ranges;
+  /// Decoder of the cellIDs
+  const dd4hep::DDSegmentation::BitFieldCoder* m_decoder = nullptr;
+  /// Uniform distribution
+  Rndm::Numbers m_flat;
+  /// CellIDs, positions [mm] and energies [GeV] of the hits of the current event
+  std::vector<uint64_t> m_cellIDs;
+  std::vector<double> m_x, m_y, m_z, m_energy;
+};
+
+#endif /* SIMG4COMPONENTS_G4SYNTHETICHITSALG_H */
@@ -0,0 +1,159 @@
+#include "StreamBlocks.h"
+
+// Gaudi
+#include "GaudiKernel/ThreadLocalContext.h"
+
+// datamodel
+#include "edm4hep/CaloHitContributionCollection.h"
+#include "edm4hep/MCParticleCollection.h"
+#include "edm4hep/SimCalorimeterHitCollection.h"
+#include "edm4hep/SimTrackerHitCollection.h"
+
+namespace {
+/// Index of the related object in its collection, -1 if not set
+template <typename T>
+int relatedIndex(const T& aObject) {
+  return aObject.isAvailable() ? aObject.getObjectID().index : -1;
+}
+}
+
+namespace sim {
+StatusCode writeBlock(ISimG4OutputStreamSvc& aStreamSvc, const std::string& aStream, const std::string& aCollection,
+                      ISimG4OutputStreamSvc::Block&& aBlock) {
+  aBlock.collection = aCollection;
+  aBlock.event = Gaudi::Hive::currentContext().evt();
+  return aStreamSvc.write(aStream, std::move(aBlock));
+}
+
+ISimG4OutputStreamSvc::Block caloHitsBlock(const edm4hep::SimCalorimeterHitCollection& aHits) {
+  ISimG4OutputStreamSvc::Block block;
+  auto& cellID = block.ids["cellID"];
+  auto& energy = block.floats["energy"];
+  auto& x = block.floats["x"];
+  auto& y = block.floats["y"];
+  auto& z = block.floats["z"];
+  auto& contributions = block.ints["contributions"];
+  auto& contributionsBegin = block.ints["contributions_begin"];
+  auto& contributionsSize = block.ints["contributions_size"];
+  for (auto* column : {&energy, &x, &y, &z}) column->reserve(aHits.size());
+  cellID.reserve(aHits.size());
+  for (const auto& hit : aHits) {
+    cellID.push_back(hit.getCellID());
+    energy.push_back(hit.getEnergy());
+    x.push_back(hit.getPosition().x);
+    y.push_back(hit.getPosition().y);
+    z.push_back(hit.getPosition().z);
+    contributionsBegin.push_back(contributions.size());
+    for (const auto& contribution : hit.getContributions()) contributions.push_back(relatedIndex(contribution));
+    contributionsSize.push_back(contributions.size() - contributionsBegin.back());
+  }
+  return block;
+}
+
+ISimG4OutputStreamSvc::Block contributionsBlock(const edm4hep::CaloHitContributionCollection& aContributions) {
+  ISimG4OutputStreamSvc::Block block;
+  auto& pdg = block.ints["PDG"];
+  auto& particle = block.ints["particle"];
+  auto& energy = block.floats["energy"];
+  auto& time = block.floats["time"];
+  auto& x = block.floats["x"];
+  auto& y = block.floats["y"];
+  auto& z = block.floats["z"];
+  for (const auto& contribution : aContributions) {
+    pdg.push_back(contribution.getPDG());
+    particle.push_back(relatedIndex(contribution.getParticle()));
+    energy.push_back(contribution.getEnergy());
+    time.push_back(contribution.getTime());
+    x.push_back(contribution.getStepPosition().x);
+    y.push_back(contribution.getStepPosition().y);
+    z.push_back(contribution.getStepPosition().z);
+  }
+  return block;
+}
+
+ISimG4OutputStreamSvc::Block trackerHitsBlock(const edm4hep::SimTrackerHitCollection& aHits) {
+  ISimG4OutputStreamSvc::Block block;
+  auto& cellID = block.ids["cellID"];
+  auto& quality = block.ints["quality"];
+  auto& particle = block.ints["particle"];
+  auto& eDep = block.floats["EDep"];
+  auto& time = block.floats["time"];
+  auto& pathLength = block.floats["pathLength"];
+  auto& x = block.floats["x"];
+  auto& y = block.floats["y"];
+  auto& z = block.floats["z"];
+  auto& px = block.floats["px"];
+  auto& py = block.floats["py"];
+  auto& pz = block.floats["pz"];
+  for (const auto& hit : aHits) {
+    cellID.push_back(hit.getCellID());
+    quality.push_back(hit.getQuality());
+    particle.push_back(relatedIndex(hit.getMCParticle()));
+    eDep.push_back(hit.getEDep());
+    time.push_back(hit.getTime());
+    pathLength.push_back(hit.getPathLength());
+    x.push_back(hit.getPosition().x);
+    y.push_back(hit.getPosition().y);
+    z.push_back(hit.getPosition().z);
+    px.push_back(hit.getMomentum().x);
+    py.push_back(hit.getMomentum().y);
+    pz.push_back(hit.getMomentum().z);
+  }
+  return block;
+}
+
+ISimG4OutputStreamSvc::Block particlesBlock(const edm4hep::MCParticleCollection& aParticles) {
+  ISimG4OutputStreamSvc::Block block;
+  auto& pdg = block.ints["PDG"];
+  auto& generatorStatus = block.ints["generatorStatus"];
+  auto& simulatorStatus = block.ints["simulatorStatus"];
+  auto& parents = block.ints["parents"];
+  auto& parentsBegin = block.ints["parents_begin"];
+  auto& parentsSize = block.ints["parents_size"];
+  auto& charge = block.floats["charge"];
+  auto& time = block.floats["time"];
+  auto& mass = block.floats["mass"];
+  auto& vx = block.floats["vx"];
+  auto& vy = block.floats["vy"];
+  auto& vz = block.floats["vz"];
+  auto& ex = block.floats["ex"];
+  auto& ey = block.floats["ey"];
+  auto& ez = block.floats["ez"];
+  auto& px = block.floats["px"];
+  auto& py = block.floats["py"];
+  auto& pz = block.floats["pz"];
+  for (const auto& particle : aParticles) {
+    pdg.push_back(particle.getPDG());
+    generatorStatus.push_back(particle.getGeneratorStatus());
+    simulatorStatus.push_back(particle.getSimulatorStatus());
+    parentsBegin.push_back(parents.size());
+    for (const auto& parent : particle.getParents()) parents.push_back(relatedIndex(parent));
+    parentsSize.push_back(parents.size() - parentsBegin.back());
+    charge.push_back(particle.getCharge());
+    time.push_back(particle.getTime());
+    mass.push_back(particle.getMass());
+    vx.push_back(particle.getVertex().x);
+    vy.push_back(particle.getVertex().y);
+    vz.push_back(particle.getVertex().z);
+    ex.push_back(particle.getEndpoint().x);
+    ey.push_back(particle.getEndpoint().y);
+    ez.push_back(particle.getEndpoint().z);
+    px.push_back(particle.getMomentum().x);
+    py.push_back(particle.getMomentum().y);
+    pz.push_back(particle.getMomentum().z);
+  }
+  return block;
+}
+
+ISimG4OutputStreamSvc::Block userDataBlock(const podio::UserDataCollection<int>& aData) {
+  ISimG4OutputStreamSvc::Block block;
+  block.ints["value"].assign(aData.begin(), aData.end());
+  return block;
+}
+
+ISimG4OutputStreamSvc::Block userDataBlock(const podio::UserDataCollection<float>& aData) {
+  ISimG4OutputStreamSvc::Block block;
+  block.floats["value"].assign(aData.begin(), aData.end());
+  return block;
+}
+}
@@ -0,0 +1,46 @@
+#ifndef SIMG4COMPONENTS_STREAMBLOCKS_H
+#define SIMG4COMPONENTS_STREAMBLOCKS_H
+
+// FCCSW
+#include "SimG4Interface/ISimG4OutputStreamSvc.h"
+
+// podio
+#include "podio/UserDataCollection.h"
+
+// datamodel
+namespace edm4hep {
+class CaloHitContributionCollection;
+class MCParticleCollection;
+class SimCalorimeterHitCollection;
+class SimTrackerHitCollection;
+}
+
+/** Conversion of the EDM collections to the blocks of columns written by the output streams (ISimG4OutputStreamSvc),
+ *  in the units of the EDM. The relations are written as the indices of the related objects in their collections (-1
+ *  if not set), and the relations to many objects as the flat indices with the first index and the number of indices
+ *  of each object.
+ */
+namespace sim {
+/// Calorimeter hits: cellID, energy, x, y, z and the indices of their contributions
+ISimG4OutputStreamSvc::Block caloHitsBlock(const edm4hep::SimCalorimeterHitCollection& aHits);
+/// Contributions to the calorimeter hits: PDG, energy, time, x, y, z and the index of their particle
+ISimG4OutputStreamSvc::Block contributionsBlock(const edm4hep::CaloHitContributionCollection& aContributions);
+/// Tracker hits: cellID, EDep, time, pathLength, quality, x, y, z, px, py, pz and the index of their particle
+ISimG4OutputStreamSvc::Block trackerHitsBlock(const edm4hep::SimTrackerHitCollection& aHits);
+/// MC particles: PDG, statuses, charge, time, mass, vertex, endpoint, momentum and the indices of their parents
+ISimG4OutputStreamSvc::Block particlesBlock(const edm4hep::MCParticleCollection& aParticles);
+/**  Queue the block for writing to the stream, with the number of the current event.
+ *   @param[in] aStreamSvc service of the output streams.
+ *   @param[in] aStream name of the stream.
+ *   @param[in] aCollection name of the collection.
+ *   @param[in] aBlock block of the collection.
+ *   @return status code
+ */
+StatusCode writeBlock(ISimG4OutputStreamSvc& aStreamSvc, const std::string& aStream, const std::string& aCollection,
+                      ISimG4OutputStreamSvc::Block&& aBlock);
+/// User data: the values, in the column "value"
+ISimG4OutputStreamSvc::Block userDataBlock(const podio::UserDataCollection<int>& aData);
+ISimG4OutputStreamSvc::Block userDataBlock(const podio::UserDataCollection<float>& aData);
+}
+
+#endif /* SIMG4COMPONENTS_STREAMBLOCKS_H */
@@ -0,0 +1,206 @@
+// local
+#include "SimG4HepMC3EventProviderTool.h"
+
+// FCCSW
+#include "SimG4Common/ParticleInformation.h"
+#include "SimG4Common/Units.h"
+
+// Gaudi
+#include "GaudiKernel/PhysicalConstants.h"
+#include "GaudiKernel/ThreadLocalContext.h"
+
+// Geant4
+#include "G4Event.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ParticleTable.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4SystemOfUnits.hh"
+
+// HepMC3
+#include "HepMC3/GenEvent.h"
+#include "HepMC3/GenParticle.h"
+#include "HepMC3/GenVertex.h"
+#include "HepMC3/ReaderFactory.h"
+
+// datamodel
+#include "edm4hep/MCParticleCollection.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace {
+/// Position of the production vertex of the particle (of the event if it has none), lengths in mm
+HepMC3::FourVector productionPosition(const HepMC3::GenEvent& aEvent, const HepMC3::ConstGenParticlePtr& aParticle) {
+  return aParticle->production_vertex() != nullptr ? aParticle->production_vertex()->position() : aEvent.event_pos();
+}
+}
+
+// Declaration of the Tool
+DECLARE_COMPONENT(SimG4HepMC3EventProviderTool)
+
+SimG4HepMC3EventProviderTool::SimG4HepMC3EventProviderTool(const std::string& type,
+                                                           const std::string& name,
+                                                           const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareInterface<ISimG4EventProviderTool>(this);
+  declareProperty("GenParticles", m_genParticlesHandle, "Handle for the genparticles to be written");
+}
+
+SimG4HepMC3EventProviderTool::~SimG4HepMC3EventProviderTool() {}
+
+StatusCode SimG4HepMC3EventProviderTool::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  m_reader = HepMC3::deduce_reader(m_filename);
+  if (m_reader == nullptr || m_reader->failed()) {
+    error() << "Unable to open the HepMC3 file " << m_filename << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_skipEvents > 0 && !m_reader->skip(m_skipEvents)) {
+    error() << "Unable to skip " << m_skipEvents << " events of " << m_filename << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4HepMC3EventProviderTool::finalize() {
+  if (m_reader != nullptr) {
+    m_reader->close();
+  }
+  info() << m_numEvents << " events read from " << m_filename << endmsg;
+  return GaudiTool::finalize();
+}
+
+bool SimG4HepMC3EventProviderTool::isDecayed(const HepMC3::ConstGenParticlePtr& aParticle) const {
+  return m_preassignedDecays && aParticle->status() == m_decayedStatus && aParticle->end_vertex() != nullptr &&
+         !aParticle->end_vertex()->particles_out().empty();
+}
+
+bool SimG4HepMC3EventProviderTool::isConverted(const HepMC3::ConstGenParticlePtr& aParticle) const {
+  return m_generatorStatus.value().empty() || isDecayed(aParticle) ||
+         std::find(m_generatorStatus.value().begin(), m_generatorStatus.value().end(), aParticle->status()) !=
+             m_generatorStatus.value().end();
+}
+
+G4PrimaryParticle* SimG4HepMC3EventProviderTool::primary(const HepMC3::ConstGenParticlePtr& aParticle,
+                                                         const edm4hep::MCParticleCollection* aSaved, size_t aOffset,
+                                                         std::unordered_set<int>& aConverted) const {
+  aConverted.insert(aParticle->id());
+  // the event is read in MeV and mm
+  const HepMC3::FourVector& mom = aParticle->momentum();
+  G4PrimaryParticle* g4Particle = new G4PrimaryParticle(aParticle->pid(), mom.px() * CLHEP::MeV,
+                                                        mom.py() * CLHEP::MeV, mom.pz() * CLHEP::MeV);
+  if (aSaved != nullptr) {
+    g4Particle->SetUserInformation(new sim::ParticleInformation((*aSaved)[aOffset + aParticle->id() - 1]));
+  }
+  if (isDecayed(aParticle)) {
+    for (const auto& daughter : aParticle->end_vertex()->particles_out()) {
+      // a daughter of several decayed particles is assigned to the first one
+      if (!isConverted(daughter) || aConverted.count(daughter->id()) > 0) continue;
+      g4Particle->SetDaughter(primary(daughter, aSaved, aOffset, aConverted));
+    }
+    // decay at the time of the end vertex, in the rest frame of the particle (the time is c*t)
+    const HepMC3::ConstGenVertexPtr production = aParticle->production_vertex();
+    const double productionTime = production != nullptr ? production->position().t() : 0;
+    const double decayTime =
+        (aParticle->end_vertex()->position().t() - productionTime) * CLHEP::mm / Gaudi::Units::c_light;
+    const double mass = aParticle->generated_mass();
+    if (decayTime > 0 && mom.e() > 0) g4Particle->SetProperTime(decayTime * mass / mom.e());
+  }
+  return g4Particle;
+}
+
+G4Event* SimG4HepMC3EventProviderTool::g4Event() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  HepMC3::GenEvent hepmcEvent(HepMC3::Units::MEV, HepMC3::Units::MM);
+  if (!m_reader->read_event(hepmcEvent) || m_reader->failed()) {
+    error() << "Unable to read the event " << m_skipEvents + m_numEvents << " of " << m_filename << endmsg;
+    return nullptr;
+  }
+  ++m_numEvents;
+  hepmcEvent.set_units(HepMC3::Units::MEV, HepMC3::Units::MM);
+  const HepMC3::GenEvent& record = hepmcEvent;
+  const std::vector<HepMC3::ConstGenParticlePtr>& particles = record.particles();
+
+  const size_t offset = m_saveEdm ? saveToEdm(particles) : 0;
+  const edm4hep::MCParticleCollection* saved = m_saveEdm ? m_genParticles : nullptr;
+  auto theEvent = new G4Event();
+  std::unordered_set<int> converted;
+  converted.reserve(particles.size());
+  // the primaries produced at the same vertex share the G4PrimaryVertex (those without vertex the event position)
+  std::map<HepMC3::ConstGenVertexPtr, G4PrimaryVertex*> vertices;
+  for (const auto& particle : particles) {
+    if (!isConverted(particle) || converted.count(particle->id()) > 0) continue;
+    // the decay products of the pre-assigned decays are added with their parent
+    const auto parents = particle->parents();
+    if (std::any_of(parents.begin(), parents.end(), [this](const auto& aParent) { return isDecayed(aParent); })) {
+      continue;
+    }
+    G4PrimaryVertex*& g4Vertex = vertices[particle->production_vertex()];
+    if (g4Vertex == nullptr) {
+      const HepMC3::FourVector position = productionPosition(record, particle);
+      g4Vertex = new G4PrimaryVertex(position.x() * CLHEP::mm, position.y() * CLHEP::mm, position.z() * CLHEP::mm,
+                                     position.t() * CLHEP::mm / Gaudi::Units::c_light);
+      theEvent->AddPrimaryVertex(g4Vertex);
+    }
+    g4Vertex->SetPrimary(primary(particle, saved, offset, converted));
+  }
+  debug() << converted.size() << " of " << particles.size() << " particles of the event " << record.event_number()
+          << " converted to primaries at " << vertices.size() << " vertices" << endmsg;
+  return theEvent;
+}
+
+size_t SimG4HepMC3EventProviderTool::saveToEdm(const std::vector<HepMC3::ConstGenParticlePtr>& aParticles) {
+  // events generated within the same Gaudi event (batch mode of SimG4Alg) share the collection
+  const auto eventNumber = Gaudi::Hive::currentContext().evt();
+  if (m_genParticles == nullptr || eventNumber != m_genParticlesEvent) {
+    m_genParticles = new edm4hep::MCParticleCollection();
+    m_genParticlesHandle.put(m_genParticles);
+    m_genParticlesEvent = eventNumber;
+  }
+  const size_t offset = m_genParticles->size();
+  const G4ParticleTable* particleTable = G4ParticleTable::GetParticleTable();
+  // the particles of the record are numbered from 1, one MC particle each in the same order
+  for (const auto& particle : aParticles) {
+    edm4hep::MCParticle edmParticle = m_genParticles->create();
+    edmParticle.setPDG(particle->pid());
+    edmParticle.setGeneratorStatus(particle->status());
+    const HepMC3::FourVector& mom = particle->momentum();
+    edmParticle.setMomentum({(float)(mom.px() * CLHEP::MeV * sim::g42edm::energy),
+                             (float)(mom.py() * CLHEP::MeV * sim::g42edm::energy),
+                             (float)(mom.pz() * CLHEP::MeV * sim::g42edm::energy)});
+    edmParticle.setMass(particle->generated_mass() * CLHEP::MeV * sim::g42edm::energy);
+    const G4ParticleDefinition* definition = particleTable->FindParticle(particle->pid());
+    if (definition != nullptr) {
+      edmParticle.setCharge(definition->GetPDGCharge());
+    }
+    const HepMC3::ConstGenVertexPtr production = particle->production_vertex();
+    if (production != nullptr) {
+      const HepMC3::FourVector& position = production->position();
+      edmParticle.setVertex({position.x() * CLHEP::mm * sim::g42edm::length,
+                             position.y() * CLHEP::mm * sim::g42edm::length,
+                             position.z() * CLHEP::mm * sim::g42edm::length});
+      edmParticle.setTime(position.t() * CLHEP::mm * sim::g42edm::length);
+    }
+    if (particle->end_vertex() != nullptr) {
+      const HepMC3::FourVector& position = particle->end_vertex()->position();
+      edmParticle.setEndpoint({position.x() * CLHEP::mm * sim::g42edm::length,
+                               position.y() * CLHEP::mm * sim::g42edm::length,
+                               position.z() * CLHEP::mm * sim::g42edm::length});
+    }
+  }
+  for (const auto& particle : aParticles) {
+    auto edmParticle = (*m_genParticles)[offset + particle->id() - 1];
+    for (const auto& daughter : particle->children()) {
+      edmParticle.addToDaughters((*m_genParticles)[offset + daughter->id() - 1]);
+    }
+    for (const auto& parent : particle->parents()) {
+      edmParticle.addToParents((*m_genParticles)[offset + parent->id() - 1]);
+    }
+  }
+  return offset;
+}
@@ -0,0 +1,108 @@
+#ifndef SIMG4COMPONENTS_SIMG4HEPMC3EVENTPROVIDERTOOL_H
+#define SIMG4COMPONENTS_SIMG4HEPMC3EVENTPROVIDERTOOL_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+#include "GaudiKernel/EventContext.h"
+
+// FCCSW
+#include "k4FWCore/DataHandle.h"
+#include "SimG4Interface/ISimG4EventProviderTool.h"
+
+// HepMC3
+#include "HepMC3/GenParticle_fwd.h"
+#include "HepMC3/Reader.h"
+
+// STL
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Forward declarations
+class G4PrimaryParticle;
+namespace edm4hep {
+class MCParticleCollection;
+}
+
+/** @class SimG4HepMC3EventProviderTool SimG4Components/src/hepmc3/SimG4HepMC3EventProviderTool.h
+ *  SimG4HepMC3EventProviderTool.h
+ *
+ *  Tool reading the events of a HepMC3 file (\b'filename', in any format and compression known to
+ *  HepMC3::deduce_reader) directly into G4Events, without converting them to EDM first.
+ *  As for SimG4PrimariesFromEdmTool, only the particles of the generator statuses \b'generatorStatus' become
+ *  primaries (all if empty) and, if \b'preassignedDecays' is set, the decayed particles (status \b'decayedStatus')
+ *  are simulated with the children of their end vertex as pre-assigned decay products, decaying at the time of that
+ *  vertex. The primaries produced at the same vertex share one G4PrimaryVertex.
+ *  If \b'saveEdm' is set, the whole record is written once as MC particles (with the parent-daughter relations),
+ *  and the primaries are associated with them (sim::ParticleInformation).
+ *  The first \b'skipEvents' events of the file are skipped. The file is read by one thread at a time.
+ *  Built only if HepMC3 is found.
+ */
+
+class SimG4HepMC3EventProviderTool : public GaudiTool, virtual public ISimG4EventProviderTool {
+public:
+  /// Standard constructor
+  SimG4HepMC3EventProviderTool(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SimG4HepMC3EventProviderTool();
+  /**  Initialize: open the file and skip the first events.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize: close the file.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /// Reads the next event of the file
+  /// @returns G4Event with the primaries of the event (ownership is transferred to the caller), nullptr at the end
+  virtual G4Event* g4Event() final;
+
+private:
+  /// Whether the particle is converted (status selected, or decayed if the decays are pre-assigned)
+  bool isConverted(const HepMC3::ConstGenParticlePtr& aParticle) const;
+  /// Whether the decay of the particle is pre-assigned
+  bool isDecayed(const HepMC3::ConstGenParticlePtr& aParticle) const;
+  /** Create the primary particle, with its pre-assigned decay products.
+   *  @param[in] aParticle generated particle
+   *  @param[in] aSaved saved MC particles of the record (associated with the primaries if not null)
+   *  @param[in] aOffset index of the first particle of the record in the saved MC particles
+   *  @param[in, out] aConverted identifiers of the particles already converted
+   *  @returns primary particle (ownership is transferred to the caller)
+   */
+  G4PrimaryParticle* primary(const HepMC3::ConstGenParticlePtr& aParticle, const edm4hep::MCParticleCollection* aSaved,
+                             size_t aOffset, std::unordered_set<int>& aConverted) const;
+  /** Save the record of the event as MC particles.
+   *  @param[in] aParticles particles of the event
+   *  @returns index of the first particle of the record in the collection of the Gaudi event
+   */
+  size_t saveToEdm(const std::vector<HepMC3::ConstGenParticlePtr>& aParticles);
+  /// Name of the HepMC3 file
+  Gaudi::Property<std::string> m_filename{this, "filename", "", "Name of the HepMC3 file (possibly compressed)"};
+  /// Number of events skipped at the beginning of the file
+  Gaudi::Property<unsigned int> m_skipEvents{this, "skipEvents", 0, "Number of events skipped at the beginning"};
+  /// Generator statuses of the particles converted to primaries
+  Gaudi::Property<std::vector<int>> m_generatorStatus{
+      this, "generatorStatus", {1}, "Generator statuses of the particles converted to primaries (all if empty)"};
+  /// Flag whether the decays of the decayed particles are pre-assigned
+  Gaudi::Property<bool> m_preassignedDecays{this, "preassignedDecays", false,
+                                            "Simulate the decayed particles with their pre-assigned decay products"};
+  /// Generator status of the decayed particles
+  Gaudi::Property<int> m_decayedStatus{this, "decayedStatus", 2, "Generator status of the decayed particles"};
+  /// Flag whether to save the generator record to EDM, set with saveEdm
+  Gaudi::Property<bool> m_saveEdm{this, "saveEdm", false, "Save the generator record as MC particles"};
+  /// Handle for the genparticles to be written
+  DataHandle<edm4hep::MCParticleCollection> m_genParticlesHandle{"GenParticles", Gaudi::DataHandle::Writer, this};
+  /// Genparticles of the current Gaudi event (owned by the event store)
+  edm4hep::MCParticleCollection* m_genParticles = nullptr;
+  /// Number of the Gaudi event in which the genparticles were put
+  EventContext::ContextEvt_t m_genParticlesEvent = 0;
+  /// Reader of the file
+  std::shared_ptr<HepMC3::Reader> m_reader;
+  /// Mutex of the reader (and of the saved genparticles)
+  std::mutex m_mutex;
+  /// Number of the events read
+  unsigned int m_numEvents = 0;
+};
+
+#endif /* SIMG4COMPONENTS_SIMG4HEPMC3EVENTPROVIDERTOOL_H */
@@ -0,0 +1,140 @@
+#include "SimG4OutputStreamSvc.h"
+
+// ROOT
+#include "TFile.h"
+#include "TROOT.h"
+#include "TTree.h"
+
+DECLARE_COMPONENT(SimG4OutputStreamSvc)
+
+SimG4OutputStreamSvc::SimG4OutputStreamSvc(const std::string& aName, ISvcLocator* aSL) : base_class(aName, aSL) {}
+
+SimG4OutputStreamSvc::~SimG4OutputStreamSvc() {}
+
+StatusCode SimG4OutputStreamSvc::initialize() {
+  if (Service::initialize().isFailure()) {
+    error() << "Unable to initialize Service()" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_maxQueueSize == 0) {
+    error() << "Size of the queues needs to be positive" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  // each file is written by one thread only, but ROOT needs to know it is used by several
+  ROOT::EnableThreadSafety();
+  for (const auto& streamFile : m_streamFiles.value()) {
+    auto stream = std::make_unique<Stream>();
+    stream->file.reset(TFile::Open(streamFile.second.c_str(), "RECREATE"));
+    if (!stream->file || stream->file->IsZombie()) {
+      error() << "Unable to open the file " << streamFile.second << " of the stream " << streamFile.first << endmsg;
+      return StatusCode::FAILURE;
+    }
+    info() << "Stream " << streamFile.first << " written to " << streamFile.second << endmsg;
+    m_streams[streamFile.first] = std::move(stream);
+  }
+  for (auto& stream : m_streams) {
+    Stream& current = *stream.second;
+    current.writer = std::thread([this, &current]() { writeLoop(current); });
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4OutputStreamSvc::finalize() {
+  for (auto& stream : m_streams) {
+    {
+      std::lock_guard<std::mutex> lock(stream.second->mutex);
+      stream.second->done = true;
+    }
+    stream.second->queueChanged.notify_all();
+  }
+  for (auto& stream : m_streams) {
+    Stream& current = *stream.second;
+    if (current.writer.joinable()) current.writer.join();
+    info() << "Stream " << stream.first << ": " << current.numBlocks << " blocks written in " << current.trees.size()
+           << " collections" << endmsg;
+    if (current.numMismatched > 0) {
+      warning() << "Stream " << stream.first << ": " << current.numMismatched
+                << " blocks with other columns than the first block of their collection" << endmsg;
+    }
+    current.file->Write();
+    current.file->Close();
+    current.file.reset();
+  }
+  m_streams.clear();
+  return Service::finalize();
+}
+
+bool SimG4OutputStreamSvc::hasStream(const std::string& aStream) const {
+  return m_streamFiles.value().find(aStream) != m_streamFiles.value().end();
+}
+
+StatusCode SimG4OutputStreamSvc::write(const std::string& aStream, Block&& aBlock) {
+  auto stream = m_streams.find(aStream);
+  if (stream == m_streams.end()) {
+    error() << "Output stream " << aStream << " is not configured" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  Stream& current = *stream->second;
+  {
+    std::unique_lock<std::mutex> lock(current.mutex);
+    current.queueChanged.wait(lock, [&]() { return current.queue.size() < m_maxQueueSize || current.done; });
+    if (current.done) {
+      error() << "Output stream " << aStream << " is already closed" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    current.queue.push_back(std::move(aBlock));
+  }
+  current.queueChanged.notify_all();
+  return StatusCode::SUCCESS;
+}
+
+void SimG4OutputStreamSvc::writeLoop(Stream& aStream) {
+  while (true) {
+    Block block;
+    {
+      std::unique_lock<std::mutex> lock(aStream.mutex);
+      aStream.queueChanged.wait(lock, [&]() { return !aStream.queue.empty() || aStream.done; });
+      // the queued blocks are still written once the service is finalized
+      if (aStream.queue.empty()) return;
+      block = std::move(aStream.queue.front());
+      aStream.queue.pop_front();
+    }
+    aStream.queueChanged.notify_all();
+    writeBlock(aStream, block);
+  }
+}
+
+void SimG4OutputStreamSvc::writeBlock(Stream& aStream, Block& aBlock) {
+  Tree& tree = aStream.trees[aBlock.collection];
+  if (tree.tree == nullptr) {
+    // no smart pointers possible because TTree is owned by the file
+    aStream.file->cd();
+    tree.tree = new TTree(aBlock.collection.c_str(), aBlock.collection.c_str());
+    tree.tree->Branch("event", &tree.event);
+    // the branches point to the buffers of the tree, which do not move in the maps
+    for (auto& column : aBlock.ids) tree.tree->Branch(column.first.c_str(), &tree.buffers.ids[column.first]);
+    for (auto& column : aBlock.ints) tree.tree->Branch(column.first.c_str(), &tree.buffers.ints[column.first]);
+    for (auto& column : aBlock.floats) tree.tree->Branch(column.first.c_str(), &tree.buffers.floats[column.first]);
+  }
+  bool matching = aBlock.ids.size() == tree.buffers.ids.size() && aBlock.ints.size() == tree.buffers.ints.size() &&
+                  aBlock.floats.size() == tree.buffers.floats.size();
+  // the columns missing in the block are written empty, the columns not in the tree are dropped
+  auto fill = [&matching](auto& aBuffers, auto& aColumns) {
+    for (auto& buffer : aBuffers) {
+      auto column = aColumns.find(buffer.first);
+      if (column == aColumns.end()) {
+        buffer.second.clear();
+        matching = false;
+      } else {
+        buffer.second.swap(column->second);
+      }
+    }
+  };
+  fill(tree.buffers.ids, aBlock.ids);
+  fill(tree.buffers.ints, aBlock.ints);
+  fill(tree.buffers.floats, aBlock.floats);
+  tree.event = aBlock.event;
+  tree.tree->Fill();
+  ++aStream.numBlocks;
+  if (!matching) ++aStream.numMismatched;
+}
@@ -0,0 +1,94 @@
+#ifndef SIMG4COMPONENTS_G4OUTPUTSTREAMSVC_H
+#define SIMG4COMPONENTS_G4OUTPUTSTREAMSVC_H
+
+// FCCSW
+#include "SimG4Interface/ISimG4OutputStreamSvc.h"
+
+// Gaudi
+#include "GaudiKernel/Service.h"
+
+// STL
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// ROOT
+class TFile;
+class TTree;
+
+/** @class SimG4OutputStreamSvc SimG4Components/src/root/SimG4OutputStreamSvc.h SimG4OutputStreamSvc.h
+ *
+ *  Service writing the collections of the saving tools (with their property \b'outputStream') to separate ROOT files,
+ *  one per stream (\b'streams', name of the stream and name of its file), e.g. one per sub-detector, so that the jobs
+ *  reading a sub-detector do not read the others. Each stream is written by its own thread, from a queue of at most
+ *  \b'maxQueueSize' blocks (the saving tools wait if it is full).
+ *  Each collection is written to a tree of its name, with one entry per block (a Geant event) holding the number of
+ *  the Gaudi event ("event") and one vector branch per column. The columns are those of the first block of the
+ *  collection; the following blocks of the collection need the same columns.
+ *  The numbers of the blocks written to each stream are printed at finalization.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+ */
+
+class SimG4OutputStreamSvc : public extends1<Service, ISimG4OutputStreamSvc> {
+public:
+  /// Standard constructor
+  explicit SimG4OutputStreamSvc(const std::string& aName, ISvcLocator* aSL);
+  /// Standard destructor
+  virtual ~SimG4OutputStreamSvc();
+  /**  Initialize: open the files and start the writing threads.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize: write the queued blocks and close the files.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /**  Check if the stream is configured.
+   *   @param[in] aStream Name of the stream.
+   *   @return true if the blocks of the stream can be written
+   */
+  virtual bool hasStream(const std::string& aStream) const final;
+  /**  Queue the block for writing to the stream.
+   *   @param[in] aStream Name of the stream.
+   *   @param[in] aBlock Block, taken over by the service.
+   *   @return status code
+   */
+  virtual StatusCode write(const std::string& aStream, Block&& aBlock) final;
+
+private:
+  /// Tree of a collection, with the buffers of its branches
+  struct Tree {
+    TTree* tree = nullptr;
+    unsigned long long event = 0;
+    Block buffers;
+  };
+  /// Stream written by its own thread
+  struct Stream {
+    std::unique_ptr<TFile> file;
+    std::map<std::string, Tree> trees;
+    std::deque<Block> queue;
+    std::mutex mutex;
+    std::condition_variable queueChanged;
+    bool done = false;
+    std::thread writer;
+    unsigned long long numBlocks = 0;
+    unsigned long long numMismatched = 0;
+  };
+  /// Write the queued blocks of the stream until the service is finalized
+  void writeLoop(Stream& aStream);
+  /// Write one block to the tree of its collection
+  void writeBlock(Stream& aStream, Block& aBlock);
+  /// Names of the streams and of their files
+  Gaudi::Property<std::map<std::string, std::string>> m_streamFiles{
+      this, "streams", {}, "Names of the output streams and of their files"};
+  /// Maximum number of blocks waiting to be written per stream
+  Gaudi::Property<unsigned int> m_maxQueueSize{this, "maxQueueSize", 16,
+                                               "Maximum number of blocks waiting to be written per stream"};
+  /// Streams, by name
+  std::map<std::string, std::unique_ptr<Stream>> m_streams;
+};
+
+#endif /* SIMG4COMPONENTS_G4OUTPUTSTREAMSVC_H */
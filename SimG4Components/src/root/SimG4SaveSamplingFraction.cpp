@@ -0,0 +1,193 @@
+#include "SimG4SaveSamplingFraction.h"
+
+// FCCSW
+#include "SimG4Common/Geant4CaloHit.h"
+#include "SimG4Common/HitBuffer.h"
+#include "SimG4Common/Units.h"
+#include "SimG4Interface/IGeoSvc.h"
+
+// Gaudi
+#include "GaudiKernel/ITHistSvc.h"
+#include "GaudiKernel/ThreadLocalContext.h"
+
+// Geant4
+#include "G4Event.hh"
+#include "G4THitsCollection.hh"
+
+// DD4hep
+#include "DD4hep/Detector.h"
+#include "DD4hep/Readout.h"
+
+// ROOT
+#include "TH1F.h"
+#include "TTree.h"
+
+// STL
+#include <algorithm>
+
+DECLARE_COMPONENT(SimG4SaveSamplingFraction)
+
+SimG4SaveSamplingFraction::SimG4SaveSamplingFraction(const std::string& aType, const std::string& aName,
+                                                     const IInterface* aParent)
+    : GaudiTool(aType, aName, aParent), m_geoSvc("GeoSvc", aName), m_histSvc("THistSvc", aName) {
+  declareInterface<ISimG4SaveOutputTool>(this);
+  declareProperty("GeoSvc", m_geoSvc);
+}
+
+SimG4SaveSamplingFraction::~SimG4SaveSamplingFraction() {}
+
+StatusCode SimG4SaveSamplingFraction::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (!m_geoSvc) {
+    error() << "Unable to locate Geometry Service. "
+            << "Make sure you have GeoSvc and SimSvc in the right order in the configuration." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_histSvc) {
+    error() << "Unable to locate Histogram Service" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  auto lcdd = m_geoSvc->lcdd();
+  if (lcdd->readouts().find(m_readoutName) == lcdd->readouts().end()) {
+    error() << "Readout <<" << m_readoutName << ">> does not exist." << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_decoder = lcdd->readout(m_readoutName).idSpec().decoder();
+  try {
+    m_layerField = m_decoder->index(m_layerFieldName);
+    m_activeField = m_decoder->index(m_activeFieldName);
+  } catch (const std::exception& e) {
+    error() << "Readout <<" << m_readoutName << ">> does not contain the field: " << e.what() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_numPoints == 0 || m_eventsPerPoint == 0) {
+    error() << "Number of points of the scan and of events per point need to be positive" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_histograms.clear();
+  m_histograms.resize(m_numPoints);
+  for (uint iPoint = 0; iPoint < m_numPoints; ++iPoint) {
+    if (bookHistograms(m_numPoints > 1 ? "_point" + std::to_string(iPoint) : "", m_histograms[iPoint]).isFailure()) {
+      return StatusCode::FAILURE;
+    }
+  }
+  m_sumElayers.assign(m_numLayers, 0);
+  m_sumEactiveLayers.assign(m_numLayers, 0);
+  if (m_saveLayerSums) {
+    m_tree = new TTree("layerSums", "Deposited energy in each layer");
+    m_tree->Branch("point", &m_point);
+    m_tree->Branch("totalEnergy", &m_sumE);
+    m_tree->Branch("activeEnergy", &m_sumEactive);
+    m_tree->Branch("totalEnergyLayers", &m_sumElayers);
+    m_tree->Branch("activeEnergyLayers", &m_sumEactiveLayers);
+    if (m_histSvc->regTree("/rec/layerSums", m_tree).isFailure()) {
+      error() << "Couldn't register tree" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4SaveSamplingFraction::bookHistograms(const std::string& aSuffix, Histograms& aHistograms) {
+  auto book = [this, &aSuffix](const std::string& aName, const std::string& aTitle, double aMax,
+                               const std::string& aPath) -> TH1F* {
+    TH1F* hist = new TH1F((aName + aSuffix).c_str(), aTitle.c_str(), 1000, 0, aMax);
+    if (m_histSvc->regHist(aPath + aSuffix, hist).isFailure()) {
+      error() << "Couldn't register histogram" << endmsg;
+      return nullptr;
+    }
+    return hist;
+  };
+  for (uint i = 0; i < m_numLayers; i++) {
+    aHistograms.totalEnLayers.push_back(book("ecal_totalEnergy_layer" + std::to_string(i),
+                                             "Total deposited energy in layer " + std::to_string(i), 1.2 * m_energy,
+                                             "/rec/ecal_total_layer" + std::to_string(i)));
+    aHistograms.activeEnLayers.push_back(book("ecal_activeEnergy_layer" + std::to_string(i),
+                                              "Deposited energy in active material, in layer " + std::to_string(i),
+                                              1.2 * m_energy, "/rec/ecal_active_layer" + std::to_string(i)));
+    aHistograms.sfLayers.push_back(book("ecal_sf_layer" + std::to_string(i), "SF for layer " + std::to_string(i), 1,
+                                        "/rec/ecal_sf_layer" + std::to_string(i)));
+    if (aHistograms.totalEnLayers.back() == nullptr || aHistograms.activeEnLayers.back() == nullptr ||
+        aHistograms.sfLayers.back() == nullptr) {
+      return StatusCode::FAILURE;
+    }
+  }
+  aHistograms.totalEnergy = book("ecal_totalEnergy", "Total deposited energy", 1.2 * m_energy, "/rec/ecal_total");
+  aHistograms.totalActiveEnergy =
+      book("ecal_active", "Deposited energy in active material", 1.2 * m_energy, "/rec/ecal_active");
+  aHistograms.sf = book("ecal_sf", "Sampling fraction", 1, "/rec/ecal_sf");
+  if (aHistograms.totalEnergy == nullptr || aHistograms.totalActiveEnergy == nullptr || aHistograms.sf == nullptr) {
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4SaveSamplingFraction::finalize() { return GaudiTool::finalize(); }
+
+StatusCode SimG4SaveSamplingFraction::saveOutput(const G4Event& aEvent) {
+  G4HCofThisEvent* collections = aEvent.GetHCofThisEvent();
+  if (collections == nullptr) {
+    return StatusCode::SUCCESS;
+  }
+  const std::vector<std::string> readoutNames{m_readoutName};
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_sumE = 0;
+  m_sumEactive = 0;
+  std::fill(m_sumElayers.begin(), m_sumElayers.end(), 0);
+  std::fill(m_sumEactiveLayers.begin(), m_sumEactiveLayers.end(), 0);
+  const auto& layerField = (*m_decoder)[m_layerField];
+  const auto& activeField = (*m_decoder)[m_activeField];
+  for (int iter_coll : m_collectionIDs.get(*collections, readoutNames)) {
+    G4VHitsCollection* collect = collections->GetHC(iter_coll);
+    // deposits written directly by the buffered sensitive detectors, or hit objects
+    auto buffer = dynamic_cast<const sim::HitBuffer*>(collect);
+    auto hits = dynamic_cast<G4THitsCollection<k4::Geant4CaloHit>*>(collect);
+    if (buffer == nullptr && hits == nullptr) {
+      warning() << "Collection " << collect->GetName() << " does not contain calorimeter hits" << endmsg;
+      continue;
+    }
+    size_t n_hit = collect->GetSize();
+    for (size_t iter_hit = 0; iter_hit < n_hit; iter_hit++) {
+      const double energy =
+          (buffer != nullptr ? buffer->energy[iter_hit] : (*hits)[iter_hit]->energyDeposit) * sim::g42edm::energy;
+      const uint64_t cID = buffer != nullptr ? buffer->cellID[iter_hit] : (*hits)[iter_hit]->cellID;
+      const uint id = layerField.value(cID);
+      if (id >= m_numLayers) {
+        warning() << "Hit in layer " << id << " outside of the " << m_numLayers << " histogrammed layers" << endmsg;
+        continue;
+      }
+      m_sumElayers[id] += energy;
+      // check if energy was deposited in the calorimeter (active/passive material)
+      if (id >= m_firstLayerId) {
+        m_sumE += energy;
+        // active material of calorimeter
+        if (activeField.value(cID) == m_activeFieldValue) {
+          m_sumEactive += energy;
+          m_sumEactiveLayers[id] += energy;
+        }
+      }
+    }
+  }
+  // Fill histograms of the point of the scan of this event
+  m_point = (Gaudi::Hive::currentContext().evt() / m_eventsPerPoint) % m_numPoints;
+  Histograms& histograms = m_histograms[m_point];
+  histograms.totalEnergy->Fill(m_sumE);
+  histograms.totalActiveEnergy->Fill(m_sumEactive);
+  if (m_sumE > 0) {
+    histograms.sf->Fill(m_sumEactive / m_sumE);
+  }
+  for (uint i = 0; i < m_numLayers; i++) {
+    histograms.totalEnLayers[i]->Fill(m_sumElayers[i]);
+    histograms.activeEnLayers[i]->Fill(m_sumEactiveLayers[i]);
+    if (m_sumElayers[i] > 0) {
+      histograms.sfLayers[i]->Fill(m_sumEactiveLayers[i] / m_sumElayers[i]);
+    }
+  }
+  if (m_tree != nullptr) {
+    m_tree->Fill();
+  }
+  debug() << "Total energy: " << m_sumE << " GeV, in active material: " << m_sumEactive << " GeV" << endmsg;
+  return StatusCode::SUCCESS;
+}
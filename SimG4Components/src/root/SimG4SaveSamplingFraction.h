@@ -0,0 +1,127 @@
+#ifndef SIMG4COMPONENTS_G4SAVESAMPLINGFRACTION_H
+#define SIMG4COMPONENTS_G4SAVESAMPLINGFRACTION_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+#include "GaudiKernel/ServiceHandle.h"
+
+// FCCSW
+#include "SimG4Common/HitsCollectionIDs.h"
+#include "SimG4Interface/ISimG4SaveOutputTool.h"
+class IGeoSvc;
+class ITHistSvc;
+
+// DD4hep
+#include "DDSegmentation/BitFieldCoder.h"
+
+// STL
+#include <mutex>
+#include <vector>
+
+class TH1F;
+class TTree;
+
+/** @class SimG4SaveSamplingFraction SimG4Components/src/root/SimG4SaveSamplingFraction.h SimG4SaveSamplingFraction.h
+ *
+ *  Sampling fraction tool.
+ *  Sums the energy deposited in each layer of the calorimeter (\b'readoutName') and in its active material directly
+ *  from the Geant hits collection, at the end of each event, so that the sampling fraction can be computed in the
+ *  simulation job without saving the hits.
+ *  The histograms are the same as the ones of the algorithm SamplingFractionInLayers (with the same properties:
+ *  \b'layerFieldName', \b'numLayers', \b'firstLayerId', \b'activeFieldName', \b'activeFieldValue', \b'energyAxis').
+ *  If \b'saveLayerSums' is set, the sums of each event are also written to the tree "/rec/layerSums".
+ *  In a scan of SimG4SingleParticleGeneratorTool, \b'numPoints' and \b'eventsPerPoint' give the scan of the generator,
+ *  and the histograms are filled for each point (with the name suffixed by "_point<index>"); the tree holds the
+ *  index of the point.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+ */
+
+class SimG4SaveSamplingFraction : public GaudiTool, virtual public ISimG4SaveOutputTool {
+public:
+  explicit SimG4SaveSamplingFraction(const std::string& aType, const std::string& aName, const IInterface* aParent);
+  virtual ~SimG4SaveSamplingFraction();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize();
+  /**  Finalize.
+   *   @return status code
+   */
+  virtual StatusCode finalize();
+  /**  Save the data output.
+   *   Fills the histograms with the energy of the hits collection \b'readoutName'.
+   *   @param[in] aEvent Event with data to save.
+   *   @return status code
+   */
+  virtual StatusCode saveOutput(const G4Event& aEvent) final;
+
+private:
+  /// Pointer to the geometry service
+  ServiceHandle<IGeoSvc> m_geoSvc;
+  /// Pointer to the interface of histogram service
+  ServiceHandle<ITHistSvc> m_histSvc;
+  /// Name of the detector readout
+  Gaudi::Property<std::string> m_readoutName{this, "readoutName", "", "Name of the detector readout"};
+  /// Name of the active field
+  Gaudi::Property<std::string> m_activeFieldName{this, "activeFieldName", "", "Identifier of active material"};
+  /// Value of the active material
+  Gaudi::Property<int> m_activeFieldValue{this, "activeFieldValue", 0, "Value of identifier for active material"};
+  /// Name of the layer/cell field
+  Gaudi::Property<std::string> m_layerFieldName{this, "layerFieldName", "", "Identifier of layers"};
+  /// Number of layers/cells
+  Gaudi::Property<uint> m_numLayers{this, "numLayers", 8, "Number of layers"};
+  /// Id of the first layer
+  Gaudi::Property<uint> m_firstLayerId{this, "firstLayerId", 0, "ID of first layer"};
+  // Maximum energy for the axis range
+  Gaudi::Property<double> m_energy{this, "energyAxis", 500, "Maximum energy for axis range"};
+  /// Flag whether the sums of each event are written to a tree
+  Gaudi::Property<bool> m_saveLayerSums{this, "saveLayerSums", false, "Write the energy sums of each event to a tree"};
+  /// Number of points of the scan of the generator (one set of histograms for all events if 1)
+  Gaudi::Property<uint> m_numPoints{this, "numPoints", 1, "Number of points of the scan of the generator"};
+  /// Number of consecutive events generated at each point of the scan
+  Gaudi::Property<uint> m_eventsPerPoint{this, "eventsPerPoint", 1, "Number of events at each point of the scan"};
+  /// Indices of the collection in the events
+  sim::HitsCollectionIDs m_collectionIDs;
+  /// Decoder of the readout
+  dd4hep::DDSegmentation::BitFieldCoder* m_decoder = nullptr;
+  /// Index of the layer field
+  size_t m_layerField = 0;
+  /// Index of the active field
+  size_t m_activeField = 0;
+  /// Histograms of one point of the scan
+  struct Histograms {
+    // Histograms of total deposited energy within layer
+    std::vector<TH1F*> totalEnLayers;
+    // Histogram of total deposited energy in the calorimeter (in active and passive material, from the first layer)
+    TH1F* totalEnergy = nullptr;
+    // Histograms of energy deposited in the active material within layer
+    std::vector<TH1F*> activeEnLayers;
+    // Histogram of energy deposited in the active material of the calorimeter
+    TH1F* totalActiveEnergy = nullptr;
+    // Histograms of sampling fraction (active/total energy) calculated within layer
+    std::vector<TH1F*> sfLayers;
+    // Histogram of sampling fraction (active/total energy) calculated for the calorimeter
+    TH1F* sf = nullptr;
+  };
+  /**  Create and register the histograms of one point of the scan.
+   *   @param[in] aSuffix suffix of the names of the histograms
+   *   @param[out] aHistograms histograms
+   *   @return status code
+   */
+  StatusCode bookHistograms(const std::string& aSuffix, Histograms& aHistograms);
+  /// Histograms of each point of the scan
+  std::vector<Histograms> m_histograms;
+  /// Tree of the sums of each event (owned by the histogram service)
+  TTree* m_tree = nullptr;
+  /// Point of the scan of the event
+  unsigned int m_point = 0;
+  /// Sums of the event: total and active energy, in each layer [GeV]
+  double m_sumE = 0;
+  double m_sumEactive = 0;
+  std::vector<double> m_sumElayers;
+  std::vector<double> m_sumEactiveLayers;
+  /// Events may be saved by several threads
+  std::mutex m_mutex;
+};
+
+#endif /* SIMG4COMPONENTS_G4SAVESAMPLINGFRACTION_H */
@@ -0,0 +1,141 @@
+#include "SimG4StreamCalHits.h"
+
+// FCCSW
+#include "SimG4Common/Geant4CaloHit.h"
+#include "SimG4Common/HitBuffer.h"
+#include "SimG4Common/Units.h"
+
+// Gaudi
+#include "GaudiKernel/ThreadLocalContext.h"
+
+// Geant4
+#include "G4Event.hh"
+#include "G4THitsCollection.hh"
+
+// ROOT
+#include "TFile.h"
+#include "TTree.h"
+
+// STL
+#include <algorithm>
+
+DECLARE_COMPONENT(SimG4StreamCalHits)
+
+SimG4StreamCalHits::SimG4StreamCalHits(const std::string& aType, const std::string& aName,
+                                       const IInterface* aParent)
+    : GaudiTool(aType, aName, aParent) {
+  declareInterface<ISimG4SaveOutputTool>(this);
+}
+
+SimG4StreamCalHits::~SimG4StreamCalHits() {}
+
+StatusCode SimG4StreamCalHits::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_readoutNames.empty()) {
+    error() << "No readout names given" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_chunkSize == 0) {
+    error() << "Size of the chunks needs to be positive" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_file.reset(TFile::Open(m_filename.value().c_str(), "RECREATE"));
+  if (!m_file || m_file->IsZombie()) {
+    error() << "Unable to open the output file " << m_filename.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  // no smart pointers possible because TTree is owned by the file
+  m_hitsTree = new TTree("hits", "Chunks of calorimeter hits");
+  m_hitsTree->Branch("cellID", &m_cellID);
+  m_hitsTree->Branch("energy", &m_energy);
+  m_hitsTree->Branch("time", &m_time);
+  m_hitsTree->Branch("x", &m_x);
+  m_hitsTree->Branch("y", &m_y);
+  m_hitsTree->Branch("z", &m_z);
+  m_indexTree = new TTree("index", "Chunks of each event and collection");
+  m_indexTree->Branch("event", &m_event);
+  m_indexTree->Branch("collection", &m_collection);
+  m_indexTree->Branch("firstEntry", &m_firstEntry);
+  m_indexTree->Branch("numChunks", &m_numChunks);
+  m_indexTree->Branch("numHits", &m_numHits);
+  m_file->WriteObject(&m_readoutNames.value(), "readoutNames");
+  for (auto* buffer : {&m_energy, &m_time, &m_x, &m_y, &m_z}) {
+    buffer->reserve(m_chunkSize);
+  }
+  m_cellID.reserve(m_chunkSize);
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4StreamCalHits::finalize() {
+  if (m_file) {
+    m_file->Write();
+    m_file->Close();
+    m_file.reset();
+  }
+  return GaudiTool::finalize();
+}
+
+void SimG4StreamCalHits::flush() {
+  m_hitsTree->Fill();
+  ++m_numChunks;
+  m_numHits += m_cellID.size();
+  for (auto* buffer : {&m_energy, &m_time, &m_x, &m_y, &m_z}) {
+    buffer->clear();
+  }
+  m_cellID.clear();
+}
+
+StatusCode SimG4StreamCalHits::saveOutput(const G4Event& aEvent) {
+  G4HCofThisEvent* collections = aEvent.GetHCofThisEvent();
+  if (collections == nullptr) {
+    return StatusCode::SUCCESS;
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_event = Gaudi::Hive::currentContext().evt();
+  auto addHit = [this](uint64_t aCellID, double aEnergy, double aTime, double aX, double aY, double aZ) {
+    m_cellID.push_back(aCellID);
+    m_energy.push_back(aEnergy * sim::g42edm::energy);
+    m_time.push_back(aTime);
+    m_x.push_back(aX * sim::g42edm::length);
+    m_y.push_back(aY * sim::g42edm::length);
+    m_z.push_back(aZ * sim::g42edm::length);
+    if (m_cellID.size() == m_chunkSize) {
+      flush();
+    }
+  };
+  for (int iter_coll : m_collectionIDs.get(*collections, m_readoutNames)) {
+    G4VHitsCollection* collect = collections->GetHC(iter_coll);
+    auto buffer = dynamic_cast<const sim::HitBuffer*>(collect);
+    auto hits = dynamic_cast<G4THitsCollection<k4::Geant4CaloHit>*>(collect);
+    if (buffer == nullptr && hits == nullptr) {
+      warning() << "Collection " << collect->GetName() << " does not contain calorimeter hits" << endmsg;
+      continue;
+    }
+    m_collection = std::find(m_readoutNames.begin(), m_readoutNames.end(), collect->GetName()) - m_readoutNames.begin();
+    m_firstEntry = m_hitsTree->GetEntries();
+    m_numChunks = 0;
+    m_numHits = 0;
+    size_t n_hit = collect->GetSize();
+    for (size_t iter_hit = 0; iter_hit < n_hit; iter_hit++) {
+      if (buffer != nullptr) {
+        // deposits written directly by the buffered sensitive detectors (positions at 0 if they are not stored)
+        const bool positions = buffer->hasPositions();
+        addHit(buffer->cellID[iter_hit], buffer->energy[iter_hit], buffer->time[iter_hit],
+               positions ? buffer->x[iter_hit] : 0, positions ? buffer->y[iter_hit] : 0,
+               positions ? buffer->z[iter_hit] : 0);
+        continue;
+      }
+      const k4::Geant4CaloHit* hit = (*hits)[iter_hit];
+      addHit(hit->cellID, hit->energyDeposit, hit->time, hit->position.x(), hit->position.y(), hit->position.z());
+    }
+    if (!m_cellID.empty()) {
+      flush();
+    }
+    m_indexTree->Fill();
+    debug() << "\t" << m_numHits << " hits of collection " << collect->GetName() << " written in " << m_numChunks
+            << " chunks" << endmsg;
+  }
+  return StatusCode::SUCCESS;
+}
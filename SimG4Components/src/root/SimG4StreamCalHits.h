@@ -0,0 +1,87 @@
+#ifndef SIMG4COMPONENTS_G4STREAMCALHITS_H
+#define SIMG4COMPONENTS_G4STREAMCALHITS_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "SimG4Common/HitsCollectionIDs.h"
+#include "SimG4Interface/ISimG4SaveOutputTool.h"
+
+// STL
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// ROOT
+class TFile;
+class TTree;
+
+/** @class SimG4StreamCalHits SimG4Components/src/root/SimG4StreamCalHits.h SimG4StreamCalHits.h
+ *
+ *  Stream calorimeter hits tool.
+ *  Writes the hits of the collections passed in the job options (\b'readoutNames') directly to a ROOT file
+ *  (\b'filename'), without creating the EDM collections in the event store, which avoids a second copy of the hits
+ *  for very large events.
+ *  Hits are written in chunks of at most \b'chunkSize' hits (entries of the tree "hits", with the columns cellID,
+ *  energy [GeV], time, x, y and z [mm]). The tree "index" allows to reassemble the hits of each event and
+ *  collection: it holds the number of the event, the index of the collection in \b'readoutNames', the first entry
+ *  and the number of the chunks, and the number of hits.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+ */
+
+class SimG4StreamCalHits : public GaudiTool, virtual public ISimG4SaveOutputTool {
+public:
+  explicit SimG4StreamCalHits(const std::string& aType, const std::string& aName, const IInterface* aParent);
+  virtual ~SimG4StreamCalHits();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize();
+  /**  Finalize.
+   *   @return status code
+   */
+  virtual StatusCode finalize();
+  /**  Save the data output.
+   *   Writes the calorimeter hits from the collections as specified in the job options in \b'readoutNames'.
+   *   @param[in] aEvent Event with data to save.
+   *   @return status code
+   */
+  virtual StatusCode saveOutput(const G4Event& aEvent) final;
+
+private:
+  /// Write the buffered hits as one chunk
+  void flush();
+  /// Name of the readouts (hits collections) to save
+  Gaudi::Property<std::vector<std::string>> m_readoutNames{
+      this, "readoutNames", {}, "Name of the readouts (hits collections) to save"};
+  /// Name of the output file
+  Gaudi::Property<std::string> m_filename{this, "filename", "streamedCaloHits.root", "Name of the output file"};
+  /// Maximal number of hits in a chunk
+  Gaudi::Property<unsigned int> m_chunkSize{this, "chunkSize", 100000, "Maximal number of hits written at once"};
+  /// Indices of the saved collections in the events
+  sim::HitsCollectionIDs m_collectionIDs;
+  /// Output file
+  std::unique_ptr<TFile> m_file;
+  /// Tree of the chunks of hits (owned by the file)
+  TTree* m_hitsTree = nullptr;
+  /// Tree of the index of the chunks (owned by the file)
+  TTree* m_indexTree = nullptr;
+  /// Events may be saved by several threads
+  std::mutex m_mutex;
+  /// Buffers of the chunk
+  std::vector<unsigned long long> m_cellID;
+  std::vector<float> m_energy;
+  std::vector<float> m_time;
+  std::vector<float> m_x;
+  std::vector<float> m_y;
+  std::vector<float> m_z;
+  /// Index of the chunks of the current collection
+  unsigned long long m_event = 0;
+  int m_collection = 0;
+  long long m_firstEntry = 0;
+  unsigned int m_numChunks = 0;
+  unsigned long long m_numHits = 0;
+};
+
+#endif /* SIMG4COMPONENTS_G4STREAMCALHITS_H */
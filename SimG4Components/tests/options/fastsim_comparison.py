@@ -0,0 +1,116 @@
+### \file
+### \ingroup SimulationTests
+### | **input (alg)**                 | other algorithms                   |                                                   |                                   | **output (alg)**                                |
+### | ------------------------------- | ---------------------------------- | ------------------------------------------------- | --------------------------------- | ----------------------------------------------- |
+### | generate single particles       | convert `HepMC::GenEvent` to EDM   | geometry taken from XML - tracker or ECAL         | full or fast simulation, profiled | write the EDM output to ROOT file using PODIO   |
+###
+### Workload of the comparison of the fast and full simulation (tests/scripts/fastsim_comparison.py), configured by
+### environment variables: COMPARISON_PARTICLE (PDG code), COMPARISON_ENERGY (GeV), COMPARISON_DETECTOR (tracker or
+### calorimeter), COMPARISON_SIMULATION (full or fast), COMPARISON_EVENTS, COMPARISON_SEED (seed of the particle gun,
+### the same in both simulations so that they get the same primaries), COMPARISON_RESOLUTION (momentum resolution of
+### the fast tracker), COMPARISON_PROFILE (JSON file of SimG4ProfilingSvc), COMPARISON_OUTPUT (ROOT file) and
+### COMPARISON_HISTOGRAMS (ROOT file of SimG4FastSimHistograms).
+
+import os
+from Gaudi.Configuration import *
+
+particle = int(os.environ.get("COMPARISON_PARTICLE", "11"))
+energy = float(os.environ.get("COMPARISON_ENERGY", "10"))
+calorimeter = os.environ.get("COMPARISON_DETECTOR", "calorimeter") == "calorimeter"
+fastsim = os.environ.get("COMPARISON_SIMULATION", "full") == "fast"
+numEvents = int(os.environ.get("COMPARISON_EVENTS", "100"))
+seed = int(os.environ.get("COMPARISON_SEED", "1234"))
+resolution = os.environ.get("COMPARISON_RESOLUTION", "0.01")
+
+from Configurables import FCCDataSvc
+podioevent = FCCDataSvc("EventDataSvc")
+
+# the particle gun draws from the Gaudi engine, the simulation from its own engine (seeded from it at initialisation)
+from Configurables import RndmGenSvc, HepRndm__Engine_CLHEP__RanluxEngine_
+randomEngine = HepRndm__Engine_CLHEP__RanluxEngine_("RndmGenSvc.Engine", Seeds=[seed])
+randomService = RndmGenSvc("RndmGenSvc", Engine=randomEngine.name())
+
+from Configurables import GenAlg, MomentumRangeParticleGun
+pgun = MomentumRangeParticleGun("PGun",
+                                PdgCodes=[particle],
+                                MomentumMin = energy, # GeV
+                                MomentumMax = energy, # GeV
+                                ThetaMin = 1.57, # rad
+                                ThetaMax = 1.57, # rad
+                                PhiMin = 0, # rad
+                                PhiMax = 6.28) # rad
+gen = GenAlg("ParticleGun", SignalProvider=pgun)
+gen.hepmc.Path = "hepmc"
+
+from Configurables import HepMCToEDMConverter
+hepmc_converter = HepMCToEDMConverter("Converter")
+hepmc_converter.hepmc.Path="hepmc"
+hepmc_converter.genparticles.Path="allGenParticles"
+hepmc_converter.genvertices.Path="allGenVertices"
+
+from Configurables import GeoSvc, SimG4Svc, SimG4ProfilingSvc, SimG4FtfpBert, SimG4FastSimPhysicsList
+from Configurables import SimG4Alg, SimG4PrimariesFromEdmTool, SimG4SaveCalHits, SimG4SaveTrackerHits
+from Configurables import SimG4SaveSmearedParticles
+profiling = SimG4ProfilingSvc("SimG4ProfilingSvc",
+                              filename=os.environ.get("COMPARISON_PROFILE", "comparison_profile.json"))
+particle_converter = SimG4PrimariesFromEdmTool("EdmConverter")
+particle_converter.genParticles.Path = "allGenParticles"
+fullphysicstool = SimG4FtfpBert("FullPhysics")
+algorithms = []
+if calorimeter:
+    geoservice = GeoSvc("GeoSvc", detectors=['file:Detector/DetFCChhBaseline1/compact/FCChh_DectEmptyMaster.xml',
+                                             'file:Detector/DetFCChhECalInclined/compact/FCChh_ECalBarrel_withCryostat.xml'])
+    # the deposits of the full and of the parametrised showers are saved by the same tool
+    saveecaltool = SimG4SaveCalHits("saveECalHits", readoutNames = ["ECalBarrelEta"])
+    saveecaltool.CaloHits.Path = "caloHits"
+    outputs = ["SimG4SaveCalHits/saveECalHits"]
+    if fastsim:
+        from Configurables import SimG4GflashSamplingCalo, SimG4FastSimCalorimeterRegion
+        gflash = SimG4GflashSamplingCalo("gflash", materialActive = "G4_lAr", materialPassive = "G4_Pb",
+                                         thicknessActive = 4, thicknessPassive = 2)
+        regiontool = SimG4FastSimCalorimeterRegion("model", volumeNames=["ECalBarrel"], parametrisation = gflash)
+        regions = ["SimG4FastSimCalorimeterRegion/model"]
+elif fastsim:
+    geoservice = GeoSvc("GeoSvc", detectors=['file:Detector/DetFCChhBaseline1/compact/FCChh_DectEmptyMaster.xml',
+                                             'file:Detector/DetFCChhBaseline1/compact/FCChh_TrackerAir.xml'])
+    from Configurables import SimG4ParticleSmearFormula, SimG4FastSimTrackerRegion, SimG4FastSimHistograms
+    smeartool = SimG4ParticleSmearFormula("smear", resolutionMomentum = resolution)
+    regiontool = SimG4FastSimTrackerRegion("model", volumeNames=["TrackerEnvelopeBarrel"], smearing = smeartool)
+    regions = ["SimG4FastSimTrackerRegion/model"]
+    saveparticlestool = SimG4SaveSmearedParticles("saveSmearedParticles")
+    saveparticlestool.GenParticles.Path = "allGenParticles"
+    saveparticlestool.MCRecoParticleAssoc.Path = "particleMCparticleAssociation"
+    outputs = ["SimG4SaveSmearedParticles/saveSmearedParticles"]
+    # momentum resolution of the fast tracker
+    hist = SimG4FastSimHistograms("fastHist")
+    hist.particlesMCparticles.Path = "particleMCparticleAssociation"
+    THistSvc().Output = ["rec DATAFILE='%s' TYP='ROOT' OPT='RECREATE'" %
+                         os.environ.get("COMPARISON_HISTOGRAMS", "comparison_histograms.root")]
+    algorithms = [hist]
+else:
+    geoservice = GeoSvc("GeoSvc", detectors=['file:Detector/DetFCChhBaseline1/compact/FCChh_DectEmptyMaster.xml',
+                                             'file:Detector/DetFCChhTrackerTkLayout/compact/Tracker.xml'])
+    savetrackertool = SimG4SaveTrackerHits("saveTrackerHits", readoutNames = ["TrackerBarrelReadout",
+                                                                              "TrackerEndcapReadout"])
+    savetrackertool.SimTrackHits.Path = "trackerHits"
+    outputs = ["SimG4SaveTrackerHits/saveTrackerHits"]
+if fastsim:
+    physicslisttool = SimG4FastSimPhysicsList("Physics", fullphysics=fullphysicstool)
+    geantservice = SimG4Svc("SimG4Svc", physicslist=physicslisttool, regions=regions)
+else:
+    geantservice = SimG4Svc("SimG4Svc", detector="SimG4DD4hepDetector", physicslist=fullphysicstool,
+                            actions="SimG4FullSimActions")
+geantsim = SimG4Alg("SimG4Alg", outputs = outputs, eventProvider=particle_converter, profiling=True)
+
+from Configurables import PodioOutput
+out = PodioOutput("out", filename = os.environ.get("COMPARISON_OUTPUT", "comparison.root"))
+out.outputCommands = ["keep *"]
+
+from Configurables import ApplicationMgr
+ApplicationMgr( TopAlg = [gen, hepmc_converter, geantsim] + algorithms + [out],
+                EvtSel = 'NONE',
+                EvtMax = numEvents,
+                # order is important, as GeoSvc is needed by SimG4Svc
+                ExtSvc = [randomService, podioevent, geoservice, profiling, geantservice],
+                OutputLevel=WARNING
+ )
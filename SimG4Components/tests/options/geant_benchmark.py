@@ -0,0 +1,84 @@
+### \file
+### \ingroup SimulationTests
+### | **input (alg)**                 | other algorithms                   |                                                   |                                   | **output (alg)**                                |
+### | ------------------------------- | ---------------------------------- | ------------------------------------------------- | --------------------------------- | ----------------------------------------------- |
+### | generate single particles       | convert `HepMC::GenEvent` to EDM   | geometry taken from XML - main + ECAL / tracker   | full or fast simulation, profiled | write the EDM output to ROOT file using PODIO   |
+###
+### Workload of the throughput benchmark (tests/scripts/geant_benchmark.py), configured by environment variables:
+### BENCHMARK_PARTICLE (PDG code), BENCHMARK_ENERGY (GeV), BENCHMARK_SIMULATION (full or fast), BENCHMARK_EVENTS,
+### BENCHMARK_PROFILE (JSON file of SimG4ProfilingSvc), BENCHMARK_OUTPUT (ROOT file), BENCHMARK_EM_PHYSICS (name of the
+### electromagnetic constructor, empty for the default of FTFP_BERT), BENCHMARK_GAMMA_GENERAL (1 on, 0 off, -1 default)
+### and BENCHMARK_HUGE_PAGES (1 to place the pools of the hits on transparent huge pages).
+
+import os
+from Gaudi.Configuration import *
+
+particle = int(os.environ.get("BENCHMARK_PARTICLE", "11"))
+energy = float(os.environ.get("BENCHMARK_ENERGY", "10"))
+fastsim = os.environ.get("BENCHMARK_SIMULATION", "full") == "fast"
+numEvents = int(os.environ.get("BENCHMARK_EVENTS", "100"))
+emPhysics = os.environ.get("BENCHMARK_EM_PHYSICS", "")
+gammaGeneral = int(os.environ.get("BENCHMARK_GAMMA_GENERAL", "-1"))
+hugePages = os.environ.get("BENCHMARK_HUGE_PAGES", "0") == "1"
+
+from Configurables import FCCDataSvc
+podioevent = FCCDataSvc("EventDataSvc")
+
+from Configurables import GenAlg, MomentumRangeParticleGun
+pgun = MomentumRangeParticleGun("PGun",
+                                PdgCodes=[particle],
+                                MomentumMin = energy, # GeV
+                                MomentumMax = energy, # GeV
+                                ThetaMin = 1.57, # rad
+                                ThetaMax = 1.57, # rad
+                                PhiMin = 0, # rad
+                                PhiMax = 6.28) # rad
+gen = GenAlg("ParticleGun", SignalProvider=pgun)
+gen.hepmc.Path = "hepmc"
+
+from Configurables import HepMCToEDMConverter
+hepmc_converter = HepMCToEDMConverter("Converter")
+hepmc_converter.hepmc.Path="hepmc"
+hepmc_converter.genparticles.Path="allGenParticles"
+hepmc_converter.genvertices.Path="allGenVertices"
+
+from Configurables import GeoSvc, SimG4Svc, SimG4ProfilingSvc, SimG4FtfpBert
+from Configurables import SimG4Alg, SimG4PrimariesFromEdmTool, SimG4SaveCalHits, SimG4SaveSmearedParticles
+profiling = SimG4ProfilingSvc("SimG4ProfilingSvc", filename=os.environ.get("BENCHMARK_PROFILE", "benchmark_profile.json"))
+particle_converter = SimG4PrimariesFromEdmTool("EdmConverter")
+particle_converter.genParticles.Path = "allGenParticles"
+fullphysicstool = SimG4FtfpBert("FullPhysics", emPhysics=emPhysics, gammaGeneralProcess=gammaGeneral)
+if fastsim:
+    geoservice = GeoSvc("GeoSvc", detectors=['file:Detector/DetFCChhBaseline1/compact/FCChh_DectEmptyMaster.xml',
+                                             'file:Detector/DetFCChhBaseline1/compact/FCChh_TrackerAir.xml'])
+    from Configurables import SimG4FastSimPhysicsList, SimG4FastSimTrackerRegion
+    regiontool = SimG4FastSimTrackerRegion("model", volumeNames=["TrackerEnvelopeBarrel"])
+    physicslisttool = SimG4FastSimPhysicsList("Physics", fullphysics=fullphysicstool)
+    geantservice = SimG4Svc("SimG4Svc", physicslist=physicslisttool, regions=["SimG4FastSimTrackerRegion/model"],
+                            hugePages=hugePages)
+    saveparticlestool = SimG4SaveSmearedParticles("saveSmearedParticles")
+    saveparticlestool.particlesMCparticles.Path = "particleMCparticleAssociation"
+    outputs = ["SimG4SaveSmearedParticles/saveSmearedParticles"]
+else:
+    geoservice = GeoSvc("GeoSvc", detectors=['file:Detector/DetFCChhBaseline1/compact/FCChh_DectEmptyMaster.xml',
+                                             'file:Detector/DetFCChhECalInclined/compact/FCChh_ECalBarrel_withCryostat.xml'])
+    geantservice = SimG4Svc("SimG4Svc", detector="SimG4DD4hepDetector", physicslist=fullphysicstool, actions="SimG4FullSimActions",
+                            hugePages=hugePages)
+    saveecaltool = SimG4SaveCalHits("saveECalHits", readoutNames = ["ECalBarrelEta"])
+    saveecaltool.positionedCaloHits.Path = "positionedCaloHits"
+    saveecaltool.caloHits.Path = "caloHits"
+    outputs = ["SimG4SaveCalHits/saveECalHits"]
+geantsim = SimG4Alg("SimG4Alg", outputs = outputs, eventProvider=particle_converter, profiling=True)
+
+from Configurables import PodioOutput
+out = PodioOutput("out", filename = os.environ.get("BENCHMARK_OUTPUT", "benchmark.root"))
+out.outputCommands = ["keep *"]
+
+from Configurables import ApplicationMgr
+ApplicationMgr( TopAlg = [gen, hepmc_converter, geantsim, out],
+                EvtSel = 'NONE',
+                EvtMax = numEvents,
+                # order is important, as GeoSvc is needed by SimG4Svc
+                ExtSvc = [podioevent, geoservice, profiling, geantservice],
+                OutputLevel=WARNING
+ )
@@ -0,0 +1,51 @@
+### \file
+### \ingroup SimulationTests
+### | **input (alg)**                 | other algorithms                   |                                   |                          | **output (alg)**                                |
+### | ------------------------------- | ---------------------------------- | --------------------------------- | ------------------------ | ----------------------------------------------- |
+### | generate single particles (G4)  |                                    | geometry taken from XML - ECAL    | FTFP_BERT physics list   | write the EDM output to ROOT file using PODIO   |
+###
+### Job of the test of the checkpoints (tests/scripts/geant_fullsim_checkpoint.py), configured by environment
+### variables: CHECKPOINT_EVENTS (EvtMax), CHECKPOINT_FILE (no checkpoints if empty), CHECKPOINT_INTERVAL,
+### CHECKPOINT_RESUME (resume from the checkpoint if set to 1) and CHECKPOINT_OUTPUT (ROOT file, with the number of the
+### completed events appended by SimG4Svc in a resumed job).
+### The particles are generated by Geant4 (SimG4SingleParticleGeneratorTool), so that they come from the random engine
+### restored from the checkpoint.
+
+import os
+from Gaudi.Configuration import *
+
+from Configurables import FCCDataSvc
+podioevent = FCCDataSvc("EventDataSvc")
+
+from Configurables import GeoSvc
+geoservice = GeoSvc("GeoSvc", detectors=['file:Detector/DetFCChhBaseline1/compact/FCChh_DectEmptyMaster.xml',
+                                         'file:Detector/DetFCChhECalInclined/compact/FCChh_ECalBarrel_withCryostat.xml'])
+
+from Configurables import SimG4Svc
+geantservice = SimG4Svc("SimG4Svc", detector='SimG4DD4hepDetector', physicslist="SimG4FtfpBert",
+                        actions="SimG4FullSimActions",
+                        checkpointFile = os.environ.get("CHECKPOINT_FILE", ""),
+                        checkpointInterval = int(os.environ.get("CHECKPOINT_INTERVAL", "3")),
+                        resume = os.environ.get("CHECKPOINT_RESUME", "0") == "1",
+                        processOutputs = ["out.filename"])
+
+from Configurables import SimG4Alg, SimG4SaveCalHits, SimG4SingleParticleGeneratorTool
+pgun = SimG4SingleParticleGeneratorTool("SimG4SingleParticleGeneratorTool", saveEdm=True, particleName="e-",
+                                        energyMin=1000, energyMax=50000, etaMin=-0.5, etaMax=0.5)
+pgun.GenParticles.Path = "GenParticles"
+saveecaltool = SimG4SaveCalHits("saveECalHits", readoutNames = ["ECalBarrelEta"])
+saveecaltool.CaloHits.Path = "ECalHits"
+geantsim = SimG4Alg("SimG4Alg", outputs = ["SimG4SaveCalHits/saveECalHits"], eventProvider=pgun)
+
+from Configurables import PodioOutput
+out = PodioOutput("out", filename = os.environ.get("CHECKPOINT_OUTPUT", "test_geant_fullsim_checkpoint.root"))
+out.outputCommands = ["keep *"]
+
+from Configurables import ApplicationMgr
+ApplicationMgr( TopAlg = [geantsim, out],
+                EvtSel = 'NONE',
+                EvtMax = int(os.environ.get("CHECKPOINT_EVENTS", "10")),
+                # order is important, as GeoSvc is needed by SimG4Svc
+                ExtSvc = [podioevent, geoservice, geantservice],
+                OutputLevel=WARNING
+ )
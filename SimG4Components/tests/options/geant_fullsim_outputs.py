@@ -0,0 +1,84 @@
+### \file
+### \ingroup SimulationTests
+### | **input (alg)**                 | other algorithms                   |                                          |                          | **output (alg)**                                |
+### | ------------------------------- | ---------------------------------- | ---------------------------------------- | ------------------------ | ----------------------------------------------- |
+### | generate single particles (G4)  |                                    | geometry taken from XML - tracker, ECAL  | FTFP_BERT physics list   | write the EDM output to ROOT file using PODIO   |
+###
+### Job of the test of the saving tools (tests/scripts/geant_fullsim_outputs.py): the same hits are saved by the
+### reference tools (hits in the order of the sensitive detectors) and by the tools in each of their output modes, to
+### be compared event by event. The output file is given by OUTPUTS_FILE, the files of the output streams of the
+### ECAL and of the tracker by OUTPUTS_ECAL_STREAM and OUTPUTS_TRACKER_STREAM.
+
+import os
+from Gaudi.Configuration import *
+
+from Configurables import FCCDataSvc
+podioevent = FCCDataSvc("EventDataSvc")
+
+from Configurables import GeoSvc
+geoservice = GeoSvc("GeoSvc", detectors=['file:Detector/DetFCChhBaseline1/compact/FCChh_DectEmptyMaster.xml',
+                                         'file:Detector/DetFCChhTrackerTkLayout/compact/Tracker.xml',
+                                         'file:Detector/DetFCChhECalInclined/compact/FCChh_ECalBarrel_withCryostat.xml'])
+
+from Configurables import SimG4Svc, SimG4FullSimActions
+from GaudiKernel.SystemOfUnits import MeV
+# part of the particles saved, so that some hits belong to tracks that are not saved
+actions = SimG4FullSimActions("Actions", enableHistory=True, energyCut=100*MeV)
+geantservice = SimG4Svc("SimG4Svc", detector='SimG4DD4hepDetector', physicslist="SimG4FtfpBert", actions=actions)
+
+from Configurables import SimG4Alg, SimG4SaveCalHits, SimG4SaveTrackerHits, SimG4SaveParticleHistory
+from Configurables import SimG4SingleParticleGeneratorTool
+pgun = SimG4SingleParticleGeneratorTool("SimG4SingleParticleGeneratorTool", saveEdm=True, particleName="e-",
+                                        energyMin=20000, energyMax=20000, etaMin=-0.5, etaMax=0.5)
+trackerReadouts = ["TrackerBarrelReadout", "TrackerEndcapReadout"]
+calorimeterReadouts = ["ECalBarrelEta"]
+# reference outputs
+saveecaltool = SimG4SaveCalHits("saveECalHits", readoutNames = calorimeterReadouts)
+saveecaltool.CaloHits.Path = "ECalHits"
+savetrackertool = SimG4SaveTrackerHits("saveTrackerHits", readoutNames = trackerReadouts)
+savetrackertool.SimTrackHits.Path = "TrackerHits"
+savehisttool = SimG4SaveParticleHistory("saveHistory")
+savehisttool.GenParticles.Path = "SimParticles"
+# hits sorted by cellID, with the index of the ranges of the layers (ECAL) and of the sub-detectors (tracker)
+sortedecaltool = SimG4SaveCalHits("saveSortedECalHits", readoutNames = calorimeterReadouts, sortByCellID = True,
+                                  indexField = "layer")
+sortedecaltool.CaloHits.Path = "SortedECalHits"
+sortedecaltool.CaloHitsIndex.Path = "SortedECalHitsIndex"
+sortedtrackertool = SimG4SaveTrackerHits("saveSortedTrackerHits", readoutNames = trackerReadouts,
+                                         sortByCellID = True, indexField = "system")
+sortedtrackertool.SimTrackHits.Path = "SortedTrackerHits"
+sortedtrackertool.TrackerHitsIndex.Path = "SortedTrackerHitsIndex"
+# hits without their positions
+energyonlyecaltool = SimG4SaveCalHits("saveEnergyOnlyECalHits", readoutNames = calorimeterReadouts, energyOnly = True)
+energyonlyecaltool.CaloHits.Path = "EnergyOnlyECalHits"
+# hits written by sub-detector to the files of the output streams, instead of the event store
+from Configurables import SimG4OutputStreamSvc
+streamservice = SimG4OutputStreamSvc("SimG4OutputStreamSvc",
+                                     streams = {"ecal": os.environ.get("OUTPUTS_ECAL_STREAM",
+                                                                       "test_geant_fullsim_outputs_ecal.root"),
+                                                "tracker": os.environ.get("OUTPUTS_TRACKER_STREAM",
+                                                                          "test_geant_fullsim_outputs_tracker.root")})
+streamecaltool = SimG4SaveCalHits("streamECalHits", readoutNames = calorimeterReadouts, outputStream = "ecal")
+streamecaltool.CaloHits.Path = "StreamedECalHits"
+streamtrackertool = SimG4SaveTrackerHits("streamTrackerHits", readoutNames = trackerReadouts, outputStream = "tracker")
+streamtrackertool.SimTrackHits.Path = "StreamedTrackerHits"
+# tracker hits linked by the index of their particle in the saved history instead of the track ID
+densetrackertool = SimG4SaveTrackerHits("saveDenseTrackerHits", readoutNames = trackerReadouts, denseTrackIds = True)
+densetrackertool.SimTrackHits.Path = "DenseTrackerHits"
+outputs = [saveecaltool, savetrackertool, savehisttool, sortedecaltool, sortedtrackertool, streamecaltool,
+           streamtrackertool, densetrackertool, energyonlyecaltool]
+geantsim = SimG4Alg("SimG4Alg", outputs = ["%s/%s" % (tool.getType(), tool.getName()) for tool in outputs],
+                    eventProvider=pgun)
+
+from Configurables import PodioOutput
+out = PodioOutput("out", filename = os.environ.get("OUTPUTS_FILE", "test_geant_fullsim_outputs.root"))
+out.outputCommands = ["keep *"]
+
+from Configurables import ApplicationMgr
+ApplicationMgr( TopAlg = [geantsim, out],
+                EvtSel = 'NONE',
+                EvtMax = 10,
+                # order is important, as GeoSvc is needed by SimG4Svc
+                ExtSvc = [podioevent, geoservice, streamservice, geantservice],
+                OutputLevel=WARNING
+ )
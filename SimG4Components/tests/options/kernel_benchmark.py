@@ -0,0 +1,102 @@
+### \file
+### \ingroup SimulationTests
+### | **input (alg)**                       | other algorithms                                      |                                       | **output (alg)** |
+### | ------------------------------------- | ----------------------------------------------------- | ------------------------------------- | ---------------- |
+### | synthetic hits with random cellIDs    | cellID transformation or conversion of Geant4 hits    | readouts of the DetComponents tests   | none             |
+###
+### Workload of the kernel benchmark (tests/scripts/kernel_benchmark.py), configured by environment variables:
+### BENCHMARK_KERNEL (one of KERNELS below, the baselines only generate the hits), BENCHMARK_HITS (hits per event) and
+### BENCHMARK_EVENTS (number of events).
+
+import os
+from Gaudi.Configuration import *
+
+kernel = os.environ.get("BENCHMARK_KERNEL", "none")
+numHits = int(os.environ.get("BENCHMARK_HITS", "1000"))
+numEvents = int(os.environ.get("BENCHMARK_EVENTS", "10"))
+
+# geometry of the DetComponents tests per kernel
+boxCalo = ['file:Test/TestGeometry/data/TestBoxCaloSD_3readouts.xml']
+barrelCalo = ['file:Test/TestGeometry/data/Barrel_testCaloSD_rphiz.xml']
+endcapCalo = ['file:Detector/DetFCChhBaseline1/compact/FCChh_DectEmptyMaster.xml',
+              'file:Detector/DetFCChhCalDiscs/compact/Endcaps_coneCryo.xml']
+tracker = ['file:Detector/DetFCChhBaseline1/compact/FCChh_DectEmptyMaster.xml',
+           'file:Detector/DetFCChhTrackerTkLayout/compact/Tracker.xml']
+KERNELS = {
+    # name: geometry, readout, Geant4 hits (empty: CalorimeterHitCollection only), hit buffer
+    # baselines, only generating the hits
+    "none": (boxCalo, "ECalHits", "", False),
+    "caloHits": (boxCalo, "ECalHits", "calo", False),
+    "caloBuffer": (boxCalo, "ECalHits", "calo", True),
+    "trackerHits": (tracker, "TrackerBarrelReadout", "tracker", False),
+    "trackerBuffer": (tracker, "TrackerBarrelReadout", "tracker", True),
+    # cellID transformations
+    "mergeCells": (boxCalo, "ECalHits", "", False),
+    "mergeCellsAggregated": (boxCalo, "ECalHits", "", False),
+    "mergeLayers": (barrelCalo, "ECalHits", "", False),
+    "rewriteBitfield": (endcapCalo, "EMECPhiEta", "", False),
+    "redoSegmentation": (boxCalo, "ECalHits", "", False),
+    # conversion of the Geant4 hits
+    "saveCalHits": (boxCalo, "ECalHits", "calo", False),
+    "saveCalHitsAggregated": (boxCalo, "ECalHits", "calo", False),
+    "saveCalHitsBuffer": (boxCalo, "ECalHits", "calo", True),
+    "saveTrackerHits": (tracker, "TrackerBarrelReadout", "tracker", False),
+    "saveTrackerHitsBuffer": (tracker, "TrackerBarrelReadout", "tracker", True),
+}
+detectors, readout, g4Hits, buffer = KERNELS[kernel]
+
+from Configurables import FCCDataSvc
+podioevent = FCCDataSvc("EventDataSvc")
+
+from Configurables import GeoSvc
+geoservice = GeoSvc("GeoSvc", detectors=detectors, OutputLevel = WARNING)
+
+from Configurables import SimG4SyntheticHitsAlg, SimG4SaveCalHits, SimG4SaveTrackerHits
+outputs = []
+if kernel.startswith("saveCalHits"):
+    savetool = SimG4SaveCalHits("saveHits", readoutNames = [readout], aggregateCells = kernel.endswith("Aggregated"))
+    savetool.CaloHits.Path = "savedHits"
+    outputs = ["SimG4SaveCalHits/saveHits"]
+elif kernel.startswith("saveTrackerHits"):
+    savetool = SimG4SaveTrackerHits("saveHits", readoutNames = [readout])
+    savetool.SimTrackHits.Path = "savedHits"
+    outputs = ["SimG4SaveTrackerHits/saveHits"]
+synthetic = SimG4SyntheticHitsAlg("SyntheticHits",
+                                  readout = readout,
+                                  numHits = numHits,
+                                  # the calorimeter hits of the saving tools are not converted twice
+                                  createCaloHits = not g4Hits,
+                                  g4Hits = g4Hits,
+                                  buffer = buffer,
+                                  outputs = outputs)
+synthetic.caloHits.Path = "caloHits"
+
+from Configurables import MergeCells, MergeLayers, RewriteBitfield, RedoSegmentation
+algorithms = []
+if kernel.startswith("mergeCells"):
+    kernelAlg = MergeCells("mergeCells", readout = readout, identifier = "x", merge = 3,
+                           aggregate = kernel.endswith("Aggregated"))
+    algorithms = [kernelAlg]
+elif kernel == "mergeLayers":
+    kernelAlg = MergeLayers("mergeLayers", volumeName = "slice", identifier = "z", readout = readout,
+                            merge = [3000,10001,3000])
+    algorithms = [kernelAlg]
+elif kernel == "rewriteBitfield":
+    kernelAlg = RewriteBitfield("rewrite", oldReadoutName = readout, removeIds = ["sublayer"],
+                                newReadoutName = "EMECPhiEtaReco")
+    algorithms = [kernelAlg]
+elif kernel == "redoSegmentation":
+    kernelAlg = RedoSegmentation("resegment", oldReadoutName = readout, oldSegmentationIds = ["x","y","z"],
+                                 newReadoutName = "ECalHitsPhiEta")
+    algorithms = [kernelAlg]
+for algorithm in algorithms:
+    algorithm.inhits.Path = "caloHits"
+    algorithm.outhits.Path = "newCaloHits"
+
+from Configurables import ApplicationMgr
+ApplicationMgr( TopAlg = [synthetic] + algorithms,
+                EvtSel = 'NONE',
+                EvtMax = numEvents,
+                ExtSvc = [podioevent, geoservice],
+                OutputLevel=WARNING
+ )
@@ -0,0 +1,21 @@
+### \file
+### \ingroup SimulationTests
+### Options appended by the performance gate (tests/scripts/performance_gate.py) to a reference configuration, e.g.
+### k4run SimG4Components/tests/options/geant_fullsim_ecal.py SimG4Components/tests/options/performance_gate.py
+### They profile SimG4Alg in SimG4ProfilingSvc and silence the output, configured by environment variables:
+### GATE_EVENTS (number of events), GATE_PROFILE (JSON file of SimG4ProfilingSvc) and GATE_OUTPUT (ROOT file).
+
+import os
+from Gaudi.Configuration import *
+
+# the messages of the reference configurations (some at DEBUG level) are not part of the measurement
+for configurable in allConfigurables.values():
+    if "OutputLevel" in configurable.getDefaultProperties():
+        configurable.OutputLevel = WARNING
+
+from Configurables import SimG4Alg, SimG4ProfilingSvc, PodioOutput, ApplicationMgr
+profiling = SimG4ProfilingSvc("SimG4ProfilingSvc", filename=os.environ.get("GATE_PROFILE", "gate_profile.json"))
+SimG4Alg("SimG4Alg").profiling = True
+PodioOutput("out").filename = os.environ.get("GATE_OUTPUT", "gate_output.root")
+ApplicationMgr().EvtMax = int(os.environ.get("GATE_EVENTS", "50"))
+ApplicationMgr().ExtSvc += [profiling]
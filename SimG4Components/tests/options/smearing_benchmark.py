@@ -0,0 +1,48 @@
+### \file
+### \ingroup SimulationTests
+### | **input (alg)**                        | other algorithms                       |                                     | **output (alg)** |
+### | -------------------------------------- | -------------------------------------- | ----------------------------------- | ---------------- |
+### | momenta uniform in eta and in log(p)   | smearing tools of the fast simulation  | formula tabulated and not tabulated | JSON report      |
+###
+### Throughput benchmark of the smearing tools, configured by environment variables: BENCHMARK_EVENTS,
+### BENCHMARK_PARTICLES (particles smeared per event), BENCHMARK_BATCH (1: smearMomenta, 0: smearMomentum per particle),
+### BENCHMARK_RESOLUTION_FILE (resolutions of SimG4ParticleSmearRootFile, not measured if empty) and BENCHMARK_REPORT.
+
+import os
+from Gaudi.Configuration import *
+
+numEvents = int(os.environ.get("BENCHMARK_EVENTS", "100"))
+numParticles = int(os.environ.get("BENCHMARK_PARTICLES", "10000"))
+batch = os.environ.get("BENCHMARK_BATCH", "1") == "1"
+resolutionFile = os.environ.get("BENCHMARK_RESOLUTION_FILE", "")
+
+from Configurables import SimG4ParticleSmearSimple, SimG4ParticleSmearFormula, SimG4ParticleSmearRootFile
+simple = SimG4ParticleSmearSimple("simple", sigma = 0.01)
+# tracker-like resolution: constant term and term linear in the momentum (x in MeV)
+formula = "sqrt(0.005^2 + (2e-5 * x / 1000)^2)"
+evaluated = SimG4ParticleSmearFormula("formula", resolutionMomentum = formula)
+tabulated = SimG4ParticleSmearFormula("formulaTabulated", resolutionMomentum = formula,
+                                      tabulationMinMomentum = 1000, tabulationMaxMomentum = 1e6)
+tools = ["SimG4ParticleSmearSimple/simple", "SimG4ParticleSmearFormula/formula",
+         "SimG4ParticleSmearFormula/formulaTabulated"]
+if resolutionFile:
+    rootfile = SimG4ParticleSmearRootFile("rootFile", filename = resolutionFile)
+    tools.append("SimG4ParticleSmearRootFile/rootFile")
+
+from Configurables import SimG4SmearingBenchmark
+benchmark = SimG4SmearingBenchmark("SmearingBenchmark",
+                                   smearTools = tools,
+                                   references = {"SimG4ParticleSmearFormula/formulaTabulated":
+                                                 "SimG4ParticleSmearFormula/formula"},
+                                   numParticles = numParticles,
+                                   etaMin = -2.5, etaMax = 2.5,
+                                   momentumMin = 1, momentumMax = 1000,
+                                   batch = batch,
+                                   filename = os.environ.get("BENCHMARK_REPORT", "smearing_benchmark.json"))
+
+from Configurables import ApplicationMgr
+ApplicationMgr( TopAlg = [benchmark],
+                EvtSel = 'NONE',
+                EvtMax = numEvents,
+                OutputLevel=INFO
+ )
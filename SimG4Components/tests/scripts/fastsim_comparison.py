@@ -0,0 +1,145 @@
+# Comparison of the fast and the full simulation: runs each workload (tests/options/fastsim_comparison.py) with the same
+# primaries in the full and in the fast simulation and writes the CPU time per event, peak RSS and output bytes per
+# event of both, and the speedup of the fast simulation, to a JSON report.
+# The calorimeter workloads compare the energy response (mean deposited energy over the energy of the particle) and the
+# resolution (RMS over mean) of the full and the parametrised showers. The tracker workloads compare the momentum
+# resolution of the fast tracker (Gaussian fit of DiffP of SimG4FastSimHistograms) with a reference resolution, since
+# the full simulation gives only the hits (e.g. the resolution of the reconstruction of the full simulation).
+# The physics of a workload agrees if the relative differences are within the tolerance (PyROOT needed).
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+WORKLOADS = [
+    # name, detector, PDG code, energy (GeV)
+    ("e-_10GeV_calorimeter", "calorimeter", 11, 10),
+    ("e-_100GeV_calorimeter", "calorimeter", 11, 100),
+    ("gamma_50GeV_calorimeter", "calorimeter", 22, 50),
+    ("pi-_10GeV_tracker", "tracker", -211, 10),
+    ("mu-_50GeV_tracker", "tracker", 13, 50),
+]
+
+
+def depositedEnergy(fileName):
+    """Mean and RMS of the energy (GeV) of the calorimeter hits per event, None if it cannot be read"""
+    import ROOT
+    rootFile = ROOT.TFile.Open(fileName)
+    tree = rootFile.Get("events") if rootFile else None
+    if not tree or not tree.GetBranch("caloHits"):
+        return None
+    numEvents = tree.Draw("Sum$(caloHits.energy)", "", "goff")
+    energies = [tree.GetV1()[i] for i in range(numEvents)]
+    if not energies:
+        return None
+    mean = sum(energies) / len(energies)
+    return mean, (sum((energy - mean) ** 2 for energy in energies) / len(energies)) ** 0.5
+
+
+def momentumResolution(fileName):
+    """Mean and sigma of the Gaussian fit of the relative momentum difference of the fast tracker, None if not read"""
+    import ROOT
+    rootFile = ROOT.TFile.Open(fileName)
+    diff = rootFile.Get("DiffP") if rootFile else None
+    if not diff or diff.GetEntries() == 0:
+        return None
+    fit = diff.Fit("gaus", "SQ0")
+    return fit.Parameter(1), abs(fit.Parameter(2))
+
+
+def run(options, name, detector, pdg, energy, simulation, events, seed, resolution):
+    """Run the workload in one simulation, returns the metrics and the names of its files"""
+    prefix = "comparison_%s_%s" % (name, simulation)
+    env = dict(os.environ, COMPARISON_PARTICLE=str(pdg), COMPARISON_ENERGY=str(energy),
+               COMPARISON_DETECTOR=detector, COMPARISON_SIMULATION=simulation, COMPARISON_EVENTS=str(events),
+               COMPARISON_SEED=str(seed), COMPARISON_RESOLUTION=str(resolution),
+               COMPARISON_PROFILE=prefix + ".json", COMPARISON_OUTPUT=prefix + ".root",
+               COMPARISON_HISTOGRAMS=prefix + "_histograms.root")
+    job = subprocess.Popen(["k4run", options], env=env)
+    _, status, usage = os.wait4(job.pid, 0)
+    if status != 0:
+        sys.exit("Workload %s failed in the %s simulation" % (name, simulation))
+    with open(env["COMPARISON_PROFILE"]) as profileFile:
+        profile = json.load(profileFile)
+    # time spent by SimG4Alg in the event loop, the rest is the initialisation (and finalisation)
+    eventTime = sum(phase["total"] for phase in profile["times"].values())
+    numEvents = max(profile["events"], 1)
+    metrics = {
+        "events": profile["events"],
+        "seconds_per_event": eventTime / numEvents,
+        "cpu_seconds": usage.ru_utime + usage.ru_stime,
+        "peak_rss_MB": usage.ru_maxrss / 1024.,  # kB on Linux
+        "output_bytes_per_event": os.path.getsize(env["COMPARISON_OUTPUT"]) / float(numEvents),
+    }
+    return metrics, env["COMPARISON_OUTPUT"], env["COMPARISON_HISTOGRAMS"]
+
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--options", default="SimG4Components/tests/options/fastsim_comparison.py")
+parser.add_argument("--events", type=int, default=200)
+parser.add_argument("--seed", type=int, default=1234, help="seed of the particle gun, the same in both simulations")
+parser.add_argument("--resolution", type=float, default=0.01, help="momentum resolution of the fast tracker")
+parser.add_argument("--reference-resolution", type=float,
+                    help="momentum resolution to which the fast tracker is compared (--resolution if not given)")
+parser.add_argument("--tolerance", type=float, default=0.05,
+                    help="allowed relative difference of the response and of the resolution")
+parser.add_argument("--workloads", nargs="*", help="names of the workloads to run (all if not given)")
+parser.add_argument("--report", default="fastsim_comparison_report.json")
+parser.add_argument("--check", action="store_true", help="fail if the physics of any workload does not agree")
+args = parser.parse_args()
+referenceResolution = args.reference_resolution or args.resolution
+
+report = {}
+for name, detector, pdg, energy in WORKLOADS:
+    if args.workloads and name not in args.workloads:
+        continue
+    full, fullOutput, _ = run(args.options, name, detector, pdg, energy, "full", args.events, args.seed,
+                              args.resolution)
+    fast, fastOutput, fastHistograms = run(args.options, name, detector, pdg, energy, "fast", args.events, args.seed,
+                                           args.resolution)
+    report[name] = {"full": full, "fast": fast,
+                    "speedup": full["seconds_per_event"] / fast["seconds_per_event"]
+                    if fast["seconds_per_event"] > 0 else 0.}
+    print("%-24s full %10.4f s/event %8.1f MB %10.0f B/event, fast %10.4f s/event %8.1f MB %10.0f B/event, "
+          "speedup %8.1f" % (name, full["seconds_per_event"], full["peak_rss_MB"], full["output_bytes_per_event"],
+                             fast["seconds_per_event"], fast["peak_rss_MB"], fast["output_bytes_per_event"],
+                             report[name]["speedup"]))
+    if detector == "calorimeter":
+        deposited = {simulation: depositedEnergy(output) for simulation, output in
+                     (("full", fullOutput), ("fast", fastOutput))}
+        if not all(deposited.values()):
+            print("%-24s no calorimeter hits to compare" % name)
+            continue
+        physics = {}
+        for simulation, (mean, rms) in deposited.items():
+            physics[simulation + "_response"] = mean / energy
+            physics[simulation + "_resolution"] = rms / mean if mean > 0 else 0.
+        physics["response_difference"] = physics["fast_response"] / physics["full_response"] - 1.
+        physics["resolution_difference"] = (physics["fast_resolution"] / physics["full_resolution"] - 1.
+                                            if physics["full_resolution"] > 0 else 0.)
+        differences = [physics["response_difference"], physics["resolution_difference"]]
+        print("%-24s response full %8.4f fast %8.4f, resolution full %8.4f fast %8.4f" % (
+            name, physics["full_response"], physics["fast_response"], physics["full_resolution"],
+            physics["fast_resolution"]))
+    else:
+        fitted = momentumResolution(fastHistograms)
+        if fitted is None:
+            print("%-24s no smeared particles to compare" % name)
+            continue
+        physics = {"fast_bias": fitted[0], "fast_resolution": fitted[1], "reference_resolution": referenceResolution,
+                   "resolution_difference": fitted[1] / referenceResolution - 1.}
+        differences = [physics["resolution_difference"]]
+        print("%-24s momentum resolution fast %8.5f (bias %8.5f), reference %8.5f" % (
+            name, physics["fast_resolution"], physics["fast_bias"], referenceResolution))
+    physics["agrees"] = all(abs(difference) <= args.tolerance for difference in differences)
+    report[name]["physics"] = physics
+
+with open(args.report, "w") as reportFile:
+    json.dump(report, reportFile, indent=2, sort_keys=True)
+
+if args.check:
+    disagreements = [name for name in report if not report[name].get("physics", {}).get("agrees", False)]
+    for name in disagreements:
+        print("Fast simulation does not agree with the full simulation in %s" % name)
+    assert(not disagreements)
@@ -0,0 +1,149 @@
+# Throughput benchmark of the simulation: runs a fixed set of workloads (tests/options/geant_benchmark.py) and writes
+# events/s, initialisation time, peak RSS and output bytes per event of each of them to a JSON report.
+# The full simulation workloads also report the mean and RMS of the energy deposited in the calorimeter per event
+# (if PyROOT is available), to compare the speed of the electromagnetic options of SimG4FtfpBert with their accuracy.
+# With --perf the misses of the data TLB per event are measured with perf stat, and with --huge-pages each workload is
+# also run with the pools of the hits on transparent huge pages (SimG4Svc hugePages), reporting the change of the
+# throughput, of the peak RSS and of the TLB misses.
+# If a reference report is given, fails if the throughput of any workload dropped by more than the tolerance.
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+WORKLOADS = [
+    # name, PDG code, energy (GeV), simulation, electromagnetic constructor (empty for default), gamma general process
+    ("e-_10GeV_full", 11, 10, "full", "", -1),
+    ("e-_100GeV_full", 11, 100, "full", "", -1),
+    ("pi-_10GeV_full", -211, 10, "full", "", -1),
+    ("pi-_100GeV_full", -211, 100, "full", "", -1),
+    ("e-_10GeV_fast", 11, 10, "fast", "", -1),
+    ("pi-_10GeV_fast", -211, 10, "fast", "", -1),
+    # electromagnetic physics options
+    ("e-_10GeV_full_emOpt1", 11, 10, "full", "G4EmStandardPhysics_option1", -1),
+    ("e-_10GeV_full_emOpt4", 11, 10, "full", "G4EmStandardPhysics_option4", -1),
+    ("e-_10GeV_full_gammaGeneral", 11, 10, "full", "", 1),
+    ("e-_10GeV_full_noGammaGeneral", 11, 10, "full", "", 0),
+]
+
+
+def depositedEnergy(fileName):
+    """Mean and RMS of the energy (GeV) of the calorimeter hits per event, None if it cannot be read"""
+    try:
+        import ROOT
+    except ImportError:
+        return None
+    rootFile = ROOT.TFile.Open(fileName)
+    tree = rootFile.Get("events") if rootFile else None
+    if not tree or not tree.GetBranch("caloHits"):
+        return None
+    numEvents = tree.Draw("Sum$(caloHits.energy)", "", "goff")
+    energies = [tree.GetV1()[i] for i in range(numEvents)]
+    if not energies:
+        return None
+    mean = sum(energies) / len(energies)
+    return mean, (sum((energy - mean) ** 2 for energy in energies) / len(energies)) ** 0.5
+
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--options", default="SimG4Components/tests/options/geant_benchmark.py")
+parser.add_argument("--events", type=int, default=100)
+parser.add_argument("--report", default="geant_benchmark_report.json")
+parser.add_argument("--reference", help="report of a previous release to compare with")
+parser.add_argument("--tolerance", type=float, default=0.1, help="allowed relative drop of the throughput")
+parser.add_argument("--perf", action="store_true", help="measure the misses of the data TLB with perf stat")
+parser.add_argument("--huge-pages", action="store_true",
+                    help="run each workload also with the pools of the hits on transparent huge pages")
+args = parser.parse_args()
+
+
+def tlbMisses(fileName):
+    """Number of the load and store misses of the data TLB in the output of perf stat (CSV), None if not counted"""
+    misses = 0
+    counted = False
+    with open(fileName) as perfFile:
+        for line in perfFile:
+            fields = line.strip().split(",")
+            if len(fields) > 2 and fields[2].startswith("dTLB-") and fields[0].isdigit():
+                misses += int(fields[0])
+                counted = True
+    return misses if counted else None
+
+
+workloads = [(name, pdg, energy, simulation, emPhysics, gammaGeneral, False)
+             for name, pdg, energy, simulation, emPhysics, gammaGeneral in WORKLOADS]
+if args.huge_pages:
+    workloads += [(name + "_hugePages", pdg, energy, simulation, emPhysics, gammaGeneral, True)
+                  for name, pdg, energy, simulation, emPhysics, gammaGeneral in WORKLOADS]
+
+report = {}
+for name, pdg, energy, simulation, emPhysics, gammaGeneral, hugePages in workloads:
+    env = dict(os.environ, BENCHMARK_PARTICLE=str(pdg), BENCHMARK_ENERGY=str(energy),
+               BENCHMARK_SIMULATION=simulation, BENCHMARK_EVENTS=str(args.events),
+               BENCHMARK_EM_PHYSICS=emPhysics, BENCHMARK_GAMMA_GENERAL=str(gammaGeneral),
+               BENCHMARK_HUGE_PAGES="1" if hugePages else "0",
+               BENCHMARK_PROFILE="benchmark_%s.json" % name, BENCHMARK_OUTPUT="benchmark_%s.root" % name)
+    command = ["k4run", args.options]
+    perfFile = "benchmark_%s_perf.csv" % name
+    if args.perf:
+        command = ["perf", "stat", "-x", ",", "-o", perfFile, "-e", "dTLB-load-misses,dTLB-store-misses"] + command
+    start = time.time()
+    job = subprocess.Popen(command, env=env)
+    _, status, usage = os.wait4(job.pid, 0)
+    wall = time.time() - start
+    if status != 0:
+        sys.exit("Workload %s failed" % name)
+    with open(env["BENCHMARK_PROFILE"]) as profileFile:
+        profile = json.load(profileFile)
+    # time spent by SimG4Alg in the event loop, the rest is the initialisation (and finalisation)
+    eventTime = sum(phase["total"] for phase in profile["times"].values())
+    numEvents = profile["events"]
+    report[name] = {
+        "events": numEvents,
+        "events_per_second": numEvents / eventTime if eventTime > 0 else 0.,
+        "initialisation_seconds": wall - eventTime,
+        "peak_rss_MB": usage.ru_maxrss / 1024.,  # kB on Linux
+        "output_bytes_per_event": os.path.getsize(env["BENCHMARK_OUTPUT"]) / float(max(numEvents, 1)),
+    }
+    if args.perf:
+        # the misses of the whole job, including the initialisation
+        misses = tlbMisses(perfFile)
+        if misses is not None:
+            report[name]["dtlb_misses_per_event"] = misses / float(max(numEvents, 1))
+            print("%-20s %14.0f dTLB misses/event" % (name, report[name]["dtlb_misses_per_event"]))
+    print("%-20s %10.2f events/s, initialisation %8.2f s, peak RSS %8.1f MB, %10.0f B/event" % (
+        name, report[name]["events_per_second"], report[name]["initialisation_seconds"], report[name]["peak_rss_MB"],
+        report[name]["output_bytes_per_event"]))
+    if simulation == "full":
+        deposited = depositedEnergy(env["BENCHMARK_OUTPUT"])
+        if deposited:
+            report[name]["deposited_energy_mean_GeV"], report[name]["deposited_energy_rms_GeV"] = deposited
+            print("%-20s deposited energy %8.4f GeV, RMS %8.4f GeV" % (name, deposited[0], deposited[1]))
+
+# change of the workloads on huge pages with respect to the ordinary pages
+for name in list(report):
+    if not name.endswith("_hugePages") or name[:-len("_hugePages")] not in report:
+        continue
+    ordinary = report[name[:-len("_hugePages")]]
+    change = {}
+    for metric in ("events_per_second", "peak_rss_MB", "dtlb_misses_per_event"):
+        if metric in report[name] and ordinary.get(metric, 0) > 0:
+            change[metric] = report[name][metric] / ordinary[metric] - 1.
+    report[name]["change_from_ordinary_pages"] = change
+    print("%-20s %s" % (name, ", ".join("%s %+.1f%%" % (metric, 100 * value)
+                                        for metric, value in sorted(change.items()))))
+
+with open(args.report, "w") as reportFile:
+    json.dump(report, reportFile, indent=2, sort_keys=True)
+
+if args.reference:
+    with open(args.reference) as referenceFile:
+        reference = json.load(referenceFile)
+    regressions = [name for name in report if name in reference and report[name]["events_per_second"] <
+                   (1. - args.tolerance) * reference[name]["events_per_second"]]
+    for name in regressions:
+        print("Throughput regression in %s: %.2f events/s (reference %.2f)" % (
+            name, report[name]["events_per_second"], reference[name]["events_per_second"]))
+    assert(not regressions)
@@ -0,0 +1,71 @@
+# Test of the checkpoints: runs the job of tests/options/geant_fullsim_checkpoint.py once without checkpoints (the
+# reference), then as a job stopped after a part of its events and resumed from its checkpoint. The events of the
+# stopped and of the resumed job need to be the events of the reference, in the same order (PyROOT needed).
+import argparse
+import os
+import subprocess
+import sys
+
+import ROOT
+
+
+def run(options, events, output, checkpoint="", interval=0, resume=False):
+    """Run the job, returns the number of completed events of its checkpoint (None without checkpoint)"""
+    env = dict(os.environ, CHECKPOINT_EVENTS=str(events), CHECKPOINT_OUTPUT=output, CHECKPOINT_FILE=checkpoint,
+               CHECKPOINT_INTERVAL=str(interval), CHECKPOINT_RESUME="1" if resume else "0")
+    if subprocess.call(["k4run", options], env=env) != 0:
+        sys.exit("Job of %d events writing %s failed" % (events, output))
+    if not checkpoint:
+        return None
+    with open(checkpoint) as checkpointFile:
+        assert checkpointFile.readline().split()[0] == "K4SIMCHECKPOINT", "%s is not a checkpoint" % checkpoint
+        for line in checkpointFile:
+            if line.split()[0] == "events":
+                return int(line.split()[1])
+    sys.exit("No number of completed events in %s" % checkpoint)
+
+
+def events(fileName):
+    """Primary particles and ECAL hits of each event of the output"""
+    rootFile = ROOT.TFile.Open(fileName)
+    tree = rootFile.Get("events") if rootFile else None
+    if not tree:
+        sys.exit("No events in %s" % fileName)
+    return [([(particle.PDG, particle.momentum.x, particle.momentum.y, particle.momentum.z)
+              for particle in entry.GenParticles],
+             sorted((hit.cellID, hit.energy) for hit in entry.ECalHits)) for entry in tree]
+
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--options", default="SimG4Components/tests/options/geant_fullsim_checkpoint.py")
+parser.add_argument("--events", type=int, default=10, help="events of the job")
+parser.add_argument("--stop", type=int, default=6, help="events after which the job is stopped")
+parser.add_argument("--interval", type=int, default=4, help="events between the checkpoints")
+parser.add_argument("--checkpoint", default="test_geant_fullsim_checkpoint.checkpoint")
+args = parser.parse_args()
+
+for fileName in (args.checkpoint, args.checkpoint + ".tmp"):
+    if os.path.exists(fileName):
+        os.remove(fileName)
+run(args.options, args.events, "test_geant_fullsim_checkpoint_reference.root")
+# the first submission with resume starts from the first event, as there is no checkpoint yet
+completed = run(args.options, args.stop, "test_geant_fullsim_checkpoint.root", args.checkpoint, args.interval,
+                resume=True)
+assert completed == args.stop, "Checkpoint of the stopped job has %s events instead of %d" % (completed, args.stop)
+completed = run(args.options, args.events, "test_geant_fullsim_checkpoint.root", args.checkpoint, args.interval,
+                resume=True)
+assert completed == args.events, "Checkpoint of the resumed job has %s events instead of %d" % (completed,
+                                                                                               args.events)
+
+ROOT.gSystem.Load("libedm4hepDict")
+reference = events("test_geant_fullsim_checkpoint_reference.root")
+stopped = events("test_geant_fullsim_checkpoint.root")
+resumed = events("test_geant_fullsim_checkpoint_from%d.root" % args.stop)
+assert len(reference) == args.events, "Reference has %d events instead of %d" % (len(reference), args.events)
+assert len(stopped) == args.stop, "Stopped job has %d events instead of %d" % (len(stopped), args.stop)
+assert len(resumed) == args.events - args.stop, "Resumed job has %d events instead of %d" % (
+    len(resumed), args.events - args.stop)
+for iEvent, event in enumerate(stopped + resumed):
+    assert event[0] == reference[iEvent][0], "Primary particles of event %d differ from the reference" % iEvent
+    assert event[1] == reference[iEvent][1], "ECAL hits of event %d differ from the reference" % iEvent
+print("Events of the stopped and of the resumed job match the %d events of the reference" % len(reference))
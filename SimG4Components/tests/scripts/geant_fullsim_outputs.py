@@ -0,0 +1,104 @@
+# Test of the saving tools: runs the job of tests/options/geant_fullsim_outputs.py and compares, event by event, the
+# hits saved in each output mode with the hits saved by the reference tools (PyROOT needed).
+import argparse
+import os
+import subprocess
+import sys
+
+import ROOT
+
+
+def events(fileName, treeName="events"):
+    """Entries of the tree of the file (the file is kept open while they are read)"""
+    rootFile = ROOT.TFile.Open(fileName)
+    tree = rootFile.Get(treeName) if rootFile else None
+    if not tree:
+        sys.exit("No tree %s in %s" % (treeName, fileName))
+    for entry in tree:
+        yield entry
+
+
+def caloDeposits(hits):
+    """Sorted cellIDs and energies of the calorimeter hits"""
+    return sorted((hit.cellID, hit.energy) for hit in hits)
+
+
+def trackerDeposits(hits):
+    """Sorted cellIDs, energies and track IDs of the tracker hits"""
+    return sorted((hit.cellID, hit.EDep, hit.quality) for hit in hits)
+
+
+def streamedEvents(fileName, treeName):
+    """CellIDs and energies of the entries of a collection of an output stream, by event"""
+    return {entry.event: sorted(zip(entry.cellID, entry.energy if hasattr(entry, "energy") else entry.EDep))
+            for entry in events(fileName, treeName)}
+
+
+def checkSorted(name, iEvent, hits, index):
+    """Check that the hits are sorted by cellID within the ranges of the index, which cover all the hits"""
+    ranges = [(index[i], index[i + 1], index[i + 2]) for i in range(0, len(index), 3)]
+    assert len(index) % 3 == 0, "%s of event %d: index is not made of triplets" % (name, iEvent)
+    assert not hits or (ranges and ranges[0][2] == 0), "%s of event %d: first range does not start at 0" % (
+        name, iEvent)
+    for (readout, value, first), (nextReadout, nextValue, nextFirst) in zip(ranges, ranges[1:]):
+        assert first < nextFirst, "%s of event %d: empty or overlapping ranges" % (name, iEvent)
+        assert (readout, value) < (nextReadout, nextValue), "%s of event %d: ranges not sorted" % (name, iEvent)
+    for iRange, (_, _, first) in enumerate(ranges):
+        last = ranges[iRange + 1][2] if iRange + 1 < len(ranges) else len(hits)
+        cellIDs = [hits[iHit].cellID for iHit in range(first, last)]
+        assert cellIDs == sorted(cellIDs), "%s of event %d: hits of a range not sorted by cellID" % (name, iEvent)
+
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--options", default="SimG4Components/tests/options/geant_fullsim_outputs.py")
+parser.add_argument("--output", default="test_geant_fullsim_outputs.root")
+parser.add_argument("--ecal-stream", default="test_geant_fullsim_outputs_ecal.root")
+parser.add_argument("--tracker-stream", default="test_geant_fullsim_outputs_tracker.root")
+args = parser.parse_args()
+
+env = dict(os.environ, OUTPUTS_FILE=args.output, OUTPUTS_ECAL_STREAM=args.ecal_stream,
+           OUTPUTS_TRACKER_STREAM=args.tracker_stream)
+if subprocess.call(["k4run", args.options], env=env) != 0:
+    sys.exit("Job of the saving tools failed")
+ROOT.gSystem.Load("libedm4hepDict")
+
+streamedCaloHits = streamedEvents(args.ecal_stream, "StreamedECalHits")
+streamedTrackerHits = streamedEvents(args.tracker_stream, "StreamedTrackerHits")
+numEvents = 0
+numCaloHits = 0
+numTrackerHits = 0
+numSavedParticles = 0
+numUnsavedParticles = 0
+for iEvent, event in enumerate(events(args.output)):
+    numEvents += 1
+    numCaloHits += event.ECalHits.size()
+    numTrackerHits += event.TrackerHits.size()
+    # sorted output: the same hits, reordered
+    assert caloDeposits(event.SortedECalHits) == caloDeposits(event.ECalHits), \
+        "Sorted ECAL hits of event %d differ from the reference" % iEvent
+    assert trackerDeposits(event.SortedTrackerHits) == trackerDeposits(event.TrackerHits), \
+        "Sorted tracker hits of event %d differ from the reference" % iEvent
+    checkSorted("Sorted ECAL hits", iEvent, event.SortedECalHits, event.SortedECalHitsIndex)
+    checkSorted("Sorted tracker hits", iEvent, event.SortedTrackerHits, event.SortedTrackerHitsIndex)
+    # energy-only output: the same cells and energies, without positions
+    assert caloDeposits(event.EnergyOnlyECalHits) == caloDeposits(event.ECalHits), \
+        "Energy-only ECAL hits of event %d differ from the reference" % iEvent
+    assert all(hit.position.x == 0 and hit.position.y == 0 and hit.position.z == 0
+               for hit in event.EnergyOnlyECalHits), "Energy-only ECAL hits of event %d have positions" % iEvent
+    # dense track IDs: the index of the particle of the track in the history, -1 if the particle was not saved
+    particleIndices = {particle.simulatorStatus: iParticle for iParticle, particle in enumerate(event.SimParticles)}
+    numSavedParticles += sum(1 for hit in event.TrackerHits if hit.quality in particleIndices)
+    numUnsavedParticles += sum(1 for hit in event.TrackerHits if hit.quality not in particleIndices)
+    assert [hit.quality for hit in event.DenseTrackerHits] == \
+        [particleIndices.get(hit.quality, -1) for hit in event.TrackerHits], \
+        "Dense track IDs of the tracker hits of event %d do not match the saved particles" % iEvent
+    # output streams: the same hits, in the file of their sub-detector
+    assert streamedCaloHits.get(iEvent) == [deposit[:2] for deposit in caloDeposits(event.ECalHits)], \
+        "Streamed ECAL hits of event %d differ from the reference" % iEvent
+    assert streamedTrackerHits.get(iEvent) == sorted((hit.cellID, hit.EDep) for hit in event.TrackerHits), \
+        "Streamed tracker hits of event %d differ from the reference" % iEvent
+
+print("Compared the outputs of %d events (%d ECAL hits, %d tracker hits)" % (numEvents, numCaloHits, numTrackerHits))
+assert numEvents == 10, "Output has %d events instead of 10" % numEvents
+assert numCaloHits > 0 and numTrackerHits > 0, "Test needs ECAL and tracker hits"
+assert numSavedParticles > 0 and numUnsavedParticles > 0, "Test needs tracker hits of saved and of unsaved particles"
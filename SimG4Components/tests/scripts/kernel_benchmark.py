@@ -0,0 +1,78 @@
+# Throughput benchmark of the cellID transformations and of the conversion of the Geant4 hits: runs each kernel of
+# tests/options/kernel_benchmark.py on synthetic hits (SimG4SyntheticHitsAlg), for numbers of hits per event from 10^3
+# to 10^7, and writes the hits/s of each of them to a JSON report.
+# The time of a kernel is the wall time of its job minus that of its baseline job, which only generates the same hits.
+# If a reference report is given, fails if the throughput of any kernel dropped by more than the tolerance.
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+KERNELS = [
+    # name, baseline
+    ("mergeCells", "none"),
+    ("mergeCellsAggregated", "none"),
+    ("mergeLayers", "none"),
+    ("rewriteBitfield", "none"),
+    ("redoSegmentation", "none"),
+    ("saveCalHits", "caloHits"),
+    ("saveCalHitsAggregated", "caloHits"),
+    ("saveCalHitsBuffer", "caloBuffer"),
+    ("saveTrackerHits", "trackerHits"),
+    ("saveTrackerHitsBuffer", "trackerBuffer"),
+]
+
+
+def runJob(kernel, numHits, numEvents):
+    """Wall time (s) of the job of the kernel"""
+    env = dict(os.environ, BENCHMARK_KERNEL=kernel, BENCHMARK_HITS=str(numHits), BENCHMARK_EVENTS=str(numEvents))
+    start = time.time()
+    status = subprocess.call(["k4run", args.options], env=env)
+    if status != 0:
+        sys.exit("Kernel %s with %d hits failed" % (kernel, numHits))
+    return time.time() - start
+
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--options", default="SimG4Components/tests/options/kernel_benchmark.py")
+parser.add_argument("--events", type=int, default=10)
+parser.add_argument("--sizes", type=int, nargs="+", default=[10 ** 3, 10 ** 4, 10 ** 5, 10 ** 6, 10 ** 7],
+                    help="numbers of hits per event")
+parser.add_argument("--kernels", nargs="+", help="kernels to run (default: all)")
+parser.add_argument("--report", default="kernel_benchmark_report.json")
+parser.add_argument("--reference", help="report of a previous release to compare with")
+parser.add_argument("--tolerance", type=float, default=0.1, help="allowed relative drop of the throughput")
+args = parser.parse_args()
+
+report = {}
+for size in args.sizes:
+    baselines = {}
+    for kernel, baseline in KERNELS:
+        if args.kernels and kernel not in args.kernels:
+            continue
+        if baseline not in baselines:
+            baselines[baseline] = runJob(baseline, size, args.events)
+        kernelTime = runJob(kernel, size, args.events) - baselines[baseline]
+        name = "%s_%d" % (kernel, size)
+        report[name] = {
+            "hits": size * args.events,
+            "seconds": kernelTime,
+            # a kernel faster than the fluctuations of the baseline is not measured
+            "hits_per_second": size * args.events / kernelTime if kernelTime > 0 else 0.,
+        }
+        print("%-32s %14.0f hits/s, %8.3f s" % (name, report[name]["hits_per_second"], kernelTime))
+
+with open(args.report, "w") as reportFile:
+    json.dump(report, reportFile, indent=2, sort_keys=True)
+
+if args.reference:
+    with open(args.reference) as referenceFile:
+        reference = json.load(referenceFile)
+    regressions = [name for name in report if name in reference and 0 < report[name]["hits_per_second"] <
+                   (1. - args.tolerance) * reference[name]["hits_per_second"]]
+    for name in regressions:
+        print("Throughput regression in %s: %.0f hits/s (reference %.0f)" % (
+            name, report[name]["hits_per_second"], reference[name]["hits_per_second"]))
+    assert(not regressions)
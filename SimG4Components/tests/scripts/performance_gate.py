@@ -0,0 +1,111 @@
+# Performance gate of the reference configurations: runs each of them several times with the options of
+# tests/options/performance_gate.py appended, and measures the events/s, initialisation time, peak RSS and output bytes
+# per event, as the throughput benchmark (geant_benchmark.py) does.
+# With --write-baseline the means and standard deviations of the runs are stored as the baseline of the machine.
+# With --baseline they are compared to a stored baseline: a metric is flagged if it got worse by more than the
+# tolerance and the change is statistically significant (Welch's t above --significance, from the spread of the
+# repeated runs of both), and the gate fails if any metric is flagged.
+import argparse
+import json
+import math
+import os
+import subprocess
+import sys
+import time
+
+CONFIGURATIONS = [
+    # name, options file (relative to the repository)
+    ("fullsim_ecal", "SimG4Components/tests/options/geant_fullsim_ecal.py"),
+    ("fullsim_hcal", "SimG4Components/tests/options/geant_fullsim_hcal.py"),
+    ("fastsim_simple", "SimG4Components/tests/options/geant_fastsim_simple.py"),
+]
+# metric, whether larger values are better
+METRICS = [
+    ("events_per_second", True),
+    ("initialisation_seconds", False),
+    ("peak_rss_MB", False),
+    ("output_bytes_per_event", False),
+]
+
+
+def measure(name, options):
+    """Metrics of one run of the configuration"""
+    env = dict(os.environ, GATE_EVENTS=str(args.events), GATE_PROFILE="gate_%s.json" % name,
+               GATE_OUTPUT="gate_%s.root" % name)
+    start = time.time()
+    job = subprocess.Popen(["k4run", options, args.gate_options], env=env)
+    _, status, usage = os.wait4(job.pid, 0)
+    wall = time.time() - start
+    if status != 0:
+        sys.exit("Configuration %s failed" % name)
+    with open(env["GATE_PROFILE"]) as profileFile:
+        profile = json.load(profileFile)
+    # time spent by SimG4Alg in the event loop, the rest is the initialisation (and finalisation)
+    eventTime = sum(phase["total"] for phase in profile["times"].values())
+    numEvents = profile["events"]
+    return {
+        "events_per_second": numEvents / eventTime if eventTime > 0 else 0.,
+        "initialisation_seconds": wall - eventTime,
+        "peak_rss_MB": usage.ru_maxrss / 1024.,  # kB on Linux
+        "output_bytes_per_event": os.path.getsize(env["GATE_OUTPUT"]) / float(max(numEvents, 1)),
+    }
+
+
+def summarise(values):
+    """Mean, standard deviation and number of the values"""
+    mean = sum(values) / len(values)
+    variance = sum((value - mean) ** 2 for value in values) / (len(values) - 1) if len(values) > 1 else 0.
+    return {"mean": mean, "std": math.sqrt(variance), "runs": len(values)}
+
+
+def regressed(current, baseline, largerIsBetter):
+    """Relative change to the worse and Welch's t of the change (t is infinite without spread)"""
+    worse = baseline["mean"] - current["mean"] if largerIsBetter else current["mean"] - baseline["mean"]
+    relative = worse / baseline["mean"] if baseline["mean"] != 0 else 0.
+    spread = math.sqrt(current["std"] ** 2 / current["runs"] + baseline["std"] ** 2 / baseline["runs"])
+    t = worse / spread if spread > 0 else (math.inf if worse > 0 else 0.)
+    return relative, t
+
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--gate-options", default="SimG4Components/tests/options/performance_gate.py")
+parser.add_argument("--events", type=int, default=50)
+parser.add_argument("--repetitions", type=int, default=5, help="runs of each configuration")
+parser.add_argument("--report", default="performance_gate_report.json")
+parser.add_argument("--write-baseline", help="store the report as the baseline in this file")
+parser.add_argument("--baseline", help="baseline to compare with")
+parser.add_argument("--tolerance", type=float, default=0.05, help="allowed relative degradation of each metric")
+parser.add_argument("--significance", type=float, default=3., help="minimal Welch's t of a flagged degradation")
+args = parser.parse_args()
+
+report = {}
+for name, options in CONFIGURATIONS:
+    runs = [measure(name, options) for _ in range(args.repetitions)]
+    report[name] = {metric: summarise([run[metric] for run in runs]) for metric, _ in METRICS}
+    print("%-16s %10.2f events/s, initialisation %8.2f s, peak RSS %8.1f MB, %10.0f B/event" % (
+        name, report[name]["events_per_second"]["mean"], report[name]["initialisation_seconds"]["mean"],
+        report[name]["peak_rss_MB"]["mean"], report[name]["output_bytes_per_event"]["mean"]))
+
+with open(args.report, "w") as reportFile:
+    json.dump(report, reportFile, indent=2, sort_keys=True)
+if args.write_baseline:
+    with open(args.write_baseline, "w") as baselineFile:
+        json.dump(report, baselineFile, indent=2, sort_keys=True)
+
+if args.baseline:
+    with open(args.baseline) as baselineFile:
+        baseline = json.load(baselineFile)
+    regressions = []
+    for name in report:
+        if name not in baseline:
+            print("No baseline for %s" % name)
+            continue
+        for metric, largerIsBetter in METRICS:
+            if metric not in baseline[name]:
+                continue
+            relative, t = regressed(report[name][metric], baseline[name][metric], largerIsBetter)
+            if relative > args.tolerance and t > args.significance:
+                regressions.append((name, metric))
+                print("Regression in %s, %s: %.4g (baseline %.4g), %.1f%% worse, t = %.1f" % (
+                    name, metric, report[name][metric]["mean"], baseline[name][metric]["mean"], 100 * relative, t))
+    assert(not regressions)
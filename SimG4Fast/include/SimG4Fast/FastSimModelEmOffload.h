@@ -0,0 +1,97 @@
+#ifndef SIMG4FAST_FASTSIMMODELEMOFFLOAD_H
+#define SIMG4FAST_FASTSIMMODELEMOFFLOAD_H
+
+// FCCSW
+#include "SimG4Fast/SensitiveDeposit.h"
+#include "SimG4Interface/ISimG4EmTransportTool.h"
+
+// Geant
+#include "G4VFastSimulationModel.hh"
+class G4Track;
+
+// Gaudi
+#include "GaudiKernel/IMessageSvc.h"
+#include "GaudiKernel/MsgStream.h"
+#include "GaudiKernel/ServiceHandle.h"
+#include "GaudiKernel/ToolHandle.h"
+
+// STL
+#include <memory>
+#include <set>
+#include <vector>
+
+/** FastSimModelEmOffload SimG4Fast/SimG4Fast/FastSimModelEmOffload.h FastSimModelEmOffload.h
+ *
+ *  Fast simulation model of the calorimeter that offloads the electromagnetic showers to an external transport
+ *  engine (e.g. on a GPU, see ISimG4EmTransportTool).
+ *  a) electrons, positrons and photons are offloaded (or the particles given to the constructor);
+ *  b) the particle needs to be within the energy range of the model.
+ *  Instead of the ordinary tracking, the particle is killed and kept in the batch of the event. The batch is given
+ *  to the engine at the end of the event (in Flush(), called by Geant), or once it holds the maximum number of
+ *  particles. The deposits returned by the engine are passed to the sensitive detectors of the volumes where they
+ *  fall, as steps of the particle that started the shower (see SensitiveDeposit), so that the readouts create the
+ *  usual calorimeter hits. If the engine fails, the event is aborted, so that its simulation fails (see
+ *  sim::RunManager::processEvent).
+ */
+
+namespace sim {
+class FastSimModelEmOffload : public G4VFastSimulationModel {
+public:
+  /** Constructor.
+   *  @param aModelName Name of the fast simulation model.
+   *  @param aEnvelope Region where the model can take over the ordinary tracking.
+   *  @param aTransportTool Engine transporting the showers.
+   *  @param aMinEnergy Minimum energy of the particle that triggers the model
+   *  @param aMaxEnergy Maximum energy of the particle that triggers the model
+   *  @param aMaxBatchSize Maximum number of particles of a batch (0: one batch per event)
+   *  @param aPdgCodes Particles that can trigger the model (electrons, positrons and photons if empty)
+   */
+  explicit FastSimModelEmOffload(const std::string& aModelName, G4Region* aEnvelope,
+                                 ToolHandle<ISimG4EmTransportTool>& aTransportTool, double aMinEnergy,
+                                 double aMaxEnergy, size_t aMaxBatchSize = 0, const std::set<int>& aPdgCodes = {});
+  virtual ~FastSimModelEmOffload();
+  /** Check if this model should be applied to this particle type.
+   *  @param aParticle Particle definition (type).
+   */
+  virtual G4bool IsApplicable(const G4ParticleDefinition& aParticle) final;
+  /** Check if the model should be applied taking into account the kinematics of a track.
+   *  @param aFastTrack Track.
+   */
+  virtual G4bool ModelTrigger(const G4FastTrack& aFastTrack) final;
+  /** Apply the parametrisation.
+   *  Add the particle to the batch and kill it.
+   *  @param aFastTrack Track.
+   *  @param aFastStep Step.
+   */
+  virtual void DoIt(const G4FastTrack& aFastTrack, G4FastStep& aFastStep) final;
+  /// Transport the remaining batch of the event and deposit the energy.
+  virtual void Flush() final;
+
+private:
+  /// Transport the batch with the engine and deposit the energy
+  void transportBatch();
+  /// Message Service
+  ServiceHandle<IMessageSvc> m_msgSvc;
+  /// Message Stream
+  MsgStream m_log;
+  /// Pointer to the transport engine
+  ToolHandle<ISimG4EmTransportTool>& m_transportTool;
+  /// Minimum energy that triggers the model
+  double m_minEnergy;
+  /// Maximum energy that triggers the model
+  double m_maxEnergy;
+  /// Maximum number of particles of a batch
+  size_t m_maxBatchSize;
+  /// Particles that can trigger the model
+  std::set<int> m_pdgCodes;
+  /// Particles of the batch (copies of the killed tracks, to which the deposits are attributed)
+  std::vector<std::unique_ptr<G4Track>> m_pending;
+  /// Particles of the batch and their deposits, as given to the engine (reused between the batches)
+  std::vector<ISimG4EmTransportTool::Track> m_tracks;
+  std::vector<ISimG4EmTransportTool::Deposit> m_deposits;
+  /// Deposits in the sensitive detectors
+  SensitiveDeposit m_deposit;
+};
+}
+
+#endif /* SIMG4FAST_FASTSIMMODELEMOFFLOAD_H */
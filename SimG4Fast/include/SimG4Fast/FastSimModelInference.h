@@ -0,0 +1,106 @@
+#ifndef SIMG4FAST_FASTSIMMODELINFERENCE_H
+#define SIMG4FAST_FASTSIMMODELINFERENCE_H
+
+// FCCSW
+#include "SimG4Fast/SensitiveDeposit.h"
+class ISimG4ShowerInferenceTool;
+
+// Geant
+#include "G4VFastSimulationModel.hh"
+class G4Track;
+
+// Gaudi
+#include "GaudiKernel/IMessageSvc.h"
+#include "GaudiKernel/MsgStream.h"
+#include "GaudiKernel/ServiceHandle.h"
+#include "GaudiKernel/ToolHandle.h"
+
+// STL
+#include <memory>
+#include <set>
+#include <vector>
+
+/** FastSimModelInference SimG4Fast/SimG4Fast/FastSimModelInference.h FastSimModelInference.h
+ *
+ *  Fast simulation model of the calorimeter generating the showers with a trained generative model.
+ *  a) electrons, positrons and photons are parametrised (or the particles given to the constructor);
+ *  b) the particle needs to be within the energy range of the model.
+ *  Instead of the ordinary tracking, the particle is killed and kept until the end of the event. Then all the
+ *  particles of the event are inferred in one batch by the inference tool (in Flush(), called by Geant at the end of
+ *  the event), with the inputs: latent variables drawn from a unit Gaussian, the energy of the particle [GeV] and the
+ *  polar angle of its direction [rad].
+ *  The outputs are the fractions of the particle energy in the cells of a cylindrical mesh around the direction of
+ *  the particle (ordered in radius, azimuthal angle and depth, depth being the fastest), starting at its position.
+ *  The energy of each cell is deposited at the centre of the cell, in the sensitive detector of the volume where it
+ *  falls, as a step of the particle (see SensitiveDeposit): the readout of the detector computes the cell ID and
+ *  creates the hit.
+ */
+
+namespace sim {
+class FastSimModelInference : public G4VFastSimulationModel {
+public:
+  /// Cylindrical mesh of the shower
+  struct Mesh {
+    unsigned int numR;
+    unsigned int numPhi;
+    unsigned int numZ;
+    /// size of the cells in radius and depth (mm)
+    double sizeR;
+    double sizeZ;
+  };
+  /** Constructor.
+   *  @param aModelName Name of the fast simulation model.
+   *  @param aEnvelope Region where the model can take over the ordinary tracking.
+   *  @param aInferenceTool Tool running the inference (its output size needs to match the mesh).
+   *  @param aMesh Mesh of the output of the model.
+   *  @param aMinEnergy Minimum energy of the particle that triggers the model
+   *  @param aMaxEnergy Maximum energy of the particle that triggers the model
+   *  @param aPdgCodes Particles that can trigger the model (electrons, positrons and photons if empty)
+   */
+  explicit FastSimModelInference(const std::string& aModelName, G4Region* aEnvelope,
+                                 ToolHandle<ISimG4ShowerInferenceTool>& aInferenceTool, const Mesh& aMesh,
+                                 double aMinEnergy, double aMaxEnergy, const std::set<int>& aPdgCodes = {});
+  virtual ~FastSimModelInference();
+  /** Check if this model should be applied to this particle type.
+   *  @param aParticle Particle definition (type).
+   */
+  virtual G4bool IsApplicable(const G4ParticleDefinition& aParticle) final;
+  /** Check if the model should be applied taking into account the kinematics of a track.
+   *  @param aFastTrack Track.
+   */
+  virtual G4bool ModelTrigger(const G4FastTrack& aFastTrack) final;
+  /** Apply the parametrisation.
+   *  Keep the particle for the inference at the end of the event and kill it.
+   *  @param aFastTrack Track.
+   *  @param aFastStep Step.
+   */
+  virtual void DoIt(const G4FastTrack& aFastTrack, G4FastStep& aFastStep) final;
+  /// Infer the showers of the particles of the event in one batch and deposit their energy.
+  virtual void Flush() final;
+
+private:
+  /// Message Service
+  ServiceHandle<IMessageSvc> m_msgSvc;
+  /// Message Stream
+  MsgStream m_log;
+  /// Pointer to the inference tool
+  ToolHandle<ISimG4ShowerInferenceTool>& m_inferenceTool;
+  /// Mesh of the output
+  Mesh m_mesh;
+  /// Minimum energy that triggers the model
+  double m_minEnergy;
+  /// Maximum energy that triggers the model
+  double m_maxEnergy;
+  /// Particles that can trigger the model
+  std::set<int> m_pdgCodes;
+  /// Particles of the event waiting for the inference (copies of the killed tracks)
+  std::vector<std::unique_ptr<G4Track>> m_pending;
+  /// Inputs and outputs of the batch
+  std::vector<float> m_input;
+  std::vector<float> m_output;
+  /// Deposits in the sensitive detectors
+  SensitiveDeposit m_deposit;
+};
+}
+
+#endif /* SIMG4FAST_FASTSIMMODELINFERENCE_H */
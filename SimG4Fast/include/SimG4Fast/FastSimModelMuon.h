@@ -0,0 +1,100 @@
+#ifndef SIMG4FAST_FASTSIMMODELMUON_H
+#define SIMG4FAST_FASTSIMMODELMUON_H
+
+// Geant
+#include "G4EmCalculator.hh"
+#include "G4VFastSimulationModel.hh"
+class G4Material;
+class G4Navigator;
+
+// Gaudi
+#include "GaudiKernel/IMessageSvc.h"
+#include "GaudiKernel/MsgStream.h"
+#include "GaudiKernel/ServiceHandle.h"
+
+// STL
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/** FastSimModelMuon SimG4Fast/SimG4Fast/FastSimModelMuon.h FastSimModelMuon.h
+ *
+ *  Parametrised propagation of the muons through the envelopes of a region (e.g. the hadronic calorimeter and the
+ *  return yoke), instead of the ordinary tracking with its many steps and delta-rays.
+ *  a) muons are parametrised;
+ *  b) the muon needs to be within the kinetic energy range of the model and not on the surface of the envelope.
+ *  The muon is moved through the envelope in steps of at most the maximum step length (shorter at the boundaries of
+ *  the volumes if the energy is deposited), with:
+ *  - the mean energy loss (ionisation and radiative losses) of the material of each step, interpolated in a table of
+ *    the total stopping power of each material filled at the first use,
+ *  - the multiple scattering angle and lateral displacement of each step, sampled from Gaussian distributions of the
+ *    width given by the Highland formula with the radiation length of the material,
+ *  - the deflection in the magnetic field at the middle of each step.
+ *  The muon leaves the envelope with its degraded energy and direction and is tracked ordinarily from there; a muon
+ *  that stops in the envelope is killed (without its decay products).
+ *  If the energy is deposited (setDepositEnergy()), the mean energy lost in each step through a sensitive volume is
+ *  passed to its sensitive detector, which creates the hits of the cells crossed. Otherwise the energy lost in the
+ *  envelope is not deposited (the step of the model has no energy deposit).
+ */
+
+namespace sim {
+class FastSimModelMuon : public G4VFastSimulationModel {
+public:
+  /** Constructor.
+   *  @param aModelName Name of the fast simulation model.
+   *  @param aEnvelope Region where the model can take over the ordinary tracking.
+   *  @param aMinEnergy Minimum kinetic energy of the muon that triggers the model
+   *  @param aMaxEnergy Maximum kinetic energy of the muon that triggers the model
+   *  @param aMaxStep Maximum length of the steps of the propagation
+   */
+  explicit FastSimModelMuon(const std::string& aModelName, G4Region* aEnvelope, double aMinEnergy, double aMaxEnergy,
+                            double aMaxStep);
+  virtual ~FastSimModelMuon();
+  /** Check if this model should be applied to this particle type.
+   *  @param aParticle Particle definition (type).
+   */
+  virtual G4bool IsApplicable(const G4ParticleDefinition& aParticle) final;
+  /** Check if the model should be applied taking into account the kinematics of a track.
+   *  @param aFastTrack Track.
+   */
+  virtual G4bool ModelTrigger(const G4FastTrack& aFastTrack) final;
+  /** Apply the parametrisation.
+   *  Move the muon to the exit of the envelope with the parametrised energy loss and multiple scattering.
+   *  @param aFastTrack Track.
+   *  @param aFastStep Step.
+   */
+  virtual void DoIt(const G4FastTrack& aFastTrack, G4FastStep& aFastStep) final;
+  /** Enable the deposits of the mean energy loss in the sensitive volumes crossed.
+   *  @param aDeposit Flag whether the energy is deposited.
+   */
+  inline void setDepositEnergy(bool aDeposit) { m_depositEnergy = aDeposit; }
+
+private:
+  /** Mean energy loss per path length.
+   *  @param aMaterial Material.
+   *  @param aEnergy Kinetic energy of the muon.
+   *  @return Total stopping power, interpolated in the table of the material (filled at the first use)
+   */
+  double stoppingPower(const G4Material* aMaterial, double aEnergy);
+  /// Message Service
+  ServiceHandle<IMessageSvc> m_msgSvc;
+  /// Message Stream
+  MsgStream m_log;
+  /// Minimum kinetic energy that triggers the model
+  double m_minEnergy;
+  /// Maximum kinetic energy that triggers the model
+  double m_maxEnergy;
+  /// Maximum length of the steps
+  double m_maxStep;
+  /// Flag whether the energy loss is deposited in the sensitive volumes
+  bool m_depositEnergy = false;
+  /// Calculator of the stopping powers of the tables
+  G4EmCalculator m_calculator;
+  /// Total stopping power of the muons per material, on the logarithmic grid of the kinetic energy
+  std::unordered_map<const G4Material*, std::vector<double>> m_stoppingPowers;
+  /// Navigator locating the materials and the sensitive volumes along the path (created at the first use)
+  std::unique_ptr<G4Navigator> m_navigator;
+};
+}
+
+#endif /* SIMG4FAST_FASTSIMMODELMUON_H */
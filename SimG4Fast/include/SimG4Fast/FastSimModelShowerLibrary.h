@@ -0,0 +1,74 @@
+#ifndef SIMG4FAST_FASTSIMMODELSHOWERLIBRARY_H
+#define SIMG4FAST_FASTSIMMODELSHOWERLIBRARY_H
+
+// FCCSW
+#include "SimG4Fast/ShowerLibrary.h"
+
+// Geant
+#include "G4VFastSimulationModel.hh"
+#include "GFlashHitMaker.hh"
+
+// STL
+#include <memory>
+#include <set>
+
+/** FastSimModelShowerLibrary SimG4Fast/SimG4Fast/FastSimModelShowerLibrary.h FastSimModelShowerLibrary.h
+ *
+ *  Fast simulation model of the calorimeter replaying frozen showers from a sim::ShowerLibrary.
+ *  a) electrons, positrons and photons are parametrised (or the particles given to the constructor);
+ *  b) the particle needs to be within the energy range of the model and within a bin of the library that holds at
+ *  least one shower.
+ *  Instead of the ordinary tracking, a shower of the bin is chosen at random, its spots are rotated to the direction of
+ *  the particle (and by a random angle around it, if set) and translated to its position, their energy is scaled by
+ *  the ratio of the particle energy and the shower energy, and they are deposited with the GFlashHitMaker in the
+ *  sensitive detectors of the volumes where they fall. The particle is killed.
+ */
+
+namespace sim {
+class FastSimModelShowerLibrary : public G4VFastSimulationModel {
+public:
+  /** Constructor.
+   *  @param aModelName Name of the fast simulation model.
+   *  @param aEnvelope Region where the model can take over the ordinary tracking.
+   *  @param aLibrary Library of showers (shared by the models, needs to outlive them).
+   *  @param aMinEnergy Minimum energy of the particle that triggers the model
+   *  @param aMaxEnergy Maximum energy of the particle that triggers the model
+   *  @param aRandomRotation Flag whether the showers are rotated by a random angle around the direction
+   *  @param aPdgCodes Particles that can trigger the model (electrons, positrons and photons if empty)
+   */
+  explicit FastSimModelShowerLibrary(const std::string& aModelName, G4Region* aEnvelope,
+                                     const ShowerLibrary& aLibrary, double aMinEnergy, double aMaxEnergy,
+                                     bool aRandomRotation, const std::set<int>& aPdgCodes = {});
+  virtual ~FastSimModelShowerLibrary();
+  /** Check if this model should be applied to this particle type.
+   *  @param aParticle Particle definition (type).
+   */
+  virtual G4bool IsApplicable(const G4ParticleDefinition& aParticle) final;
+  /** Check if the model should be applied taking into account the kinematics of a track.
+   *  @param aFastTrack Track.
+   */
+  virtual G4bool ModelTrigger(const G4FastTrack& aFastTrack) final;
+  /** Apply the parametrisation.
+   *  Deposit the spots of a shower of the library and kill the particle.
+   *  @param aFastTrack Track.
+   *  @param aFastStep Step.
+   */
+  virtual void DoIt(const G4FastTrack& aFastTrack, G4FastStep& aFastStep) final;
+
+private:
+  /// Library of showers
+  const ShowerLibrary& m_library;
+  /// Minimum energy that triggers the model
+  double m_minEnergy;
+  /// Maximum energy that triggers the model
+  double m_maxEnergy;
+  /// Flag whether the showers are rotated by a random angle around the direction
+  bool m_randomRotation;
+  /// Particles that can trigger the model
+  std::set<int> m_pdgCodes;
+  /// Makes the energy spots in the sensitive detector of the volume
+  std::unique_ptr<GFlashHitMaker> m_hitMaker;
+};
+}
+
+#endif /* SIMG4FAST_FASTSIMMODELSHOWERLIBRARY_H */
@@ -14,6 +14,10 @@ class ISimG4ParticleSmearTool;
 #include "GaudiKernel/ToolHandle.h"
 
 class IToolSvc;
+class G4Navigator;
+
+// STL
+#include <memory>
 
 /** FastSimModelTracker SimG4Fast/SimG4Fast/FastSimModelTracker.h FastSimModelTracker.h
  *
@@ -22,13 +26,19 @@ class IToolSvc;
  *  Particles need to have the parametrisation process attached (FastSimPhysics)
  *  and fulfill conditions of a) FastSimModelTracker::IsApplicable() and b) FastSimModelTracker::ModelTrigger().
  *  a) all charged particles are parametrised.
- *  b) if minimum and/or maximum momentum is defined, particle within that range are parametrised. Maximum eta can also
- * be set.
+ *  b) if minimum and/or maximum momentum is defined, particle within that range are parametrised. Maximum absolute
+ * value of eta can also be set.
  *  Volumes are represented by G4Region given to the constructor of FastSimModelTracker.
  *  For those volumes, if the model is triggered, instead of the ordinary tracking,
  *  a particle is moved to the exit of the tracker (as it would be transported with initial momentum and no
  *  physics processes on the way) and the particle momentum is smeared according to the smearing tool
  *  defined in the job options file.
+ *  If the envelope is a full cylinder (G4Tubs, not rotated) and the field is either absent or a sim::ConstantField
+ *  along z covering the whole envelope, the exit point is computed analytically from the helix; otherwise the track
+ *  is propagated with G4PathFinder to the next boundary.
+ *  If the hits are enabled (setHitParameters()) and the exit point is computed analytically, the helix is also
+ *  intersected with the sensitive volumes inside the envelope: a step from the entry to the exit point of each volume,
+ *  smeared in r-phi and z, is passed to its sensitive detector, which creates the tracker hit.
  *
  *  @author    Anna Zaborowska
  */
@@ -69,8 +79,42 @@ public:
    *  @param aFastStep Step.
    */
   virtual void DoIt(const G4FastTrack& aFastTrack, G4FastStep& aFastStep) final;
+  /// Configuration of the hits created along the trajectory
+  struct HitParameters {
+    /// resolution of the hit position in r-phi and z
+    double resolutionRPhi;
+    double resolutionZ;
+    /// energy deposited per path length in the sensitive volumes
+    double energyPerLength;
+    /// maximum length of the chords of the helix used to search for the volumes
+    double maxStep;
+  };
+  /** Enable the creation of the hits along the trajectory.
+   *  @param aParameters Configuration of the hits.
+   */
+  void setHitParameters(const HitParameters& aParameters);
+  /** Smear the momenta with the Gaussian random numbers of the Geant4 engine of the thread, concurrently with the
+   *  models of the other threads (the smearing tool needs to support it, see
+   *  ISimG4ParticleSmearTool::supportsConcurrentSmearing()).
+   *  @param aConcurrent Flag whether the momenta are smeared concurrently.
+   */
+  void setConcurrentSmearing(bool aConcurrent) { m_concurrentSmearing = aConcurrent; }
 
 private:
+  /** Compute the exit point of the envelope analytically.
+   *  @param aFastTrack Track.
+   *  @param[out] aExit Exit point (global coordinates).
+   *  @param[out] aPath Path length to the exit.
+   *  @param[out] aCurvature Curvature of the transverse motion (rotation angle per path length, 0 without field).
+   *  @return false if the envelope or the field is not supported (the path finder needs to be used)
+   */
+  bool helixExit(const G4FastTrack& aFastTrack, G4ThreeVector& aExit, double& aPath, double& aCurvature) const;
+  /** Create the hits in the sensitive volumes crossed by the helix.
+   *  @param aFastTrack Track.
+   *  @param aPath Path length to the exit of the envelope.
+   *  @param aCurvature Curvature of the transverse motion.
+   */
+  void makeHits(const G4FastTrack& aFastTrack, double aPath, double aCurvature);
   /// Message Service
   ServiceHandle<IMessageSvc> m_msgSvc;
   /// Message Stream
@@ -78,11 +122,23 @@ private:
   /// Pointer to a smearing tool
   ToolHandle<ISimG4ParticleSmearTool>& m_smearTool;
   /// minimum P that triggers model
-  double m_minTriggerMomentum;
+  double m_minTriggerMomentum = 0;
   /// maximum P that triggers model
-  double m_maxTriggerMomentum;
+  double m_maxTriggerMomentum = 0;
   /// maximum eta that triggers model
-  double m_maxTriggerEta;
+  double m_maxTriggerEta = 0;
+  /// squares of the momentum thresholds and of cos(theta) at the maximum eta, compared in the trigger
+  double m_minTriggerMomentum2 = 0;
+  double m_maxTriggerMomentum2 = 0;
+  double m_maxTriggerCosTheta2 = 1;
+  /// flag whether the momenta are smeared with the random numbers of the thread
+  bool m_concurrentSmearing = false;
+  /// flag whether the hits are created
+  bool m_makeHits = false;
+  /// configuration of the hits
+  HitParameters m_hitParameters{0, 0, 0, 0};
+  /// navigator locating the sensitive volumes along the helix (created at the first use)
+  std::unique_ptr<G4Navigator> m_navigator;
 };
 }
 
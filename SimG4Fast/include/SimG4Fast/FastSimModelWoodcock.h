@@ -0,0 +1,102 @@
+#ifndef SIMG4FAST_FASTSIMMODELWOODCOCK_H
+#define SIMG4FAST_FASTSIMMODELWOODCOCK_H
+
+// Geant
+#include "G4ThreeVector.hh"
+#include "G4VFastSimulationModel.hh"
+class G4MaterialCutsCouple;
+class G4Navigator;
+class G4Track;
+class G4VProcess;
+
+// Gaudi
+#include "GaudiKernel/IMessageSvc.h"
+#include "GaudiKernel/MsgStream.h"
+#include "GaudiKernel/ServiceHandle.h"
+
+// STL
+#include <memory>
+#include <vector>
+
+/** FastSimModelWoodcock SimG4Fast/SimG4Fast/FastSimModelWoodcock.h FastSimModelWoodcock.h
+ *
+ *  Woodcock (delta) tracking of photons in the envelopes of a region, used where Geant4 does not provide it natively.
+ *  a) photons are tracked;
+ *  b) the photon needs to be within the energy range of the model and not on the surface of the envelope.
+ *  Instead of the ordinary tracking, which stops at each boundary of the volumes of the envelope, the photon flies
+ *  through the envelope with the majorant cross-section (the largest total cross-section of the materials of the
+ *  region at its energy). At each tentative interaction point the real material is located and the interaction is
+ *  accepted with the probability of the ratio of the real and majorant cross-sections (each process with its own
+ *  cross-section), otherwise the flight continues. An accepted interaction is performed by the Geant4 process itself,
+ *  its secondaries are added to the event and its local energy deposit is given to the sensitive detector of the volume
+ *  at the interaction point. A photon that reaches the surface of the envelope is moved there and tracked ordinarily.
+ *  The processes of the photon are the discrete processes of its process manager (electromagnetic and hadronic).
+ */
+
+namespace sim {
+class FastSimModelWoodcock : public G4VFastSimulationModel {
+public:
+  /** Constructor.
+   *  @param aModelName Name of the fast simulation model.
+   *  @param aEnvelope Region where the model can take over the ordinary tracking.
+   *  @param aMinEnergy Minimum energy of the photon that triggers the model
+   *  @param aMaxEnergy Maximum energy of the photon that triggers the model
+   */
+  explicit FastSimModelWoodcock(const std::string& aModelName, G4Region* aEnvelope, double aMinEnergy,
+                                double aMaxEnergy);
+  virtual ~FastSimModelWoodcock();
+  /** Check if this model should be applied to this particle type.
+   *  @param aParticle Particle definition (type).
+   */
+  virtual G4bool IsApplicable(const G4ParticleDefinition& aParticle) final;
+  /** Check if the model should be applied taking into account the kinematics of a track.
+   *  @param aFastTrack Track.
+   */
+  virtual G4bool ModelTrigger(const G4FastTrack& aFastTrack) final;
+  /** Apply the parametrisation.
+   *  Fly the photon to its next real interaction (and perform it) or to the surface of the envelope.
+   *  @param aFastTrack Track.
+   *  @param aFastStep Step.
+   */
+  virtual void DoIt(const G4FastTrack& aFastTrack, G4FastStep& aFastStep) final;
+
+private:
+  /// Collect the processes of the photon and the material-cuts couples of the region (at the first use)
+  void initialise();
+  /** Total cross-section of the processes in the material.
+   *  @param aEnergy Energy of the photon.
+   *  @param aCouple Material-cuts couple.
+   *  @param aCrossSections Cross-sections of the processes (filled).
+   *  @return Sum of the cross-sections.
+   */
+  double crossSection(double aEnergy, const G4MaterialCutsCouple* aCouple, std::vector<double>& aCrossSections) const;
+  /** Perform the interaction of the process at the position and propose its result in the fast step.
+   *  @param aProcess Process.
+   *  @param aTrack Photon, at the position of the interaction.
+   *  @param aFastStep Step.
+   */
+  void interact(G4VProcess* aProcess, G4Track& aTrack, G4FastStep& aFastStep);
+  /// Message Service
+  ServiceHandle<IMessageSvc> m_msgSvc;
+  /// Message Stream
+  MsgStream m_log;
+  /// Region of the envelopes
+  G4Region* m_region;
+  /// Minimum energy that triggers the model
+  double m_minEnergy;
+  /// Maximum energy that triggers the model
+  double m_maxEnergy;
+  /// Discrete processes of the photon
+  std::vector<G4VProcess*> m_processes;
+  /// Material-cuts couples of the region (defining the majorant cross-section)
+  std::vector<const G4MaterialCutsCouple*> m_couples;
+  /// Cross-sections of the processes at the tentative interaction point
+  std::vector<double> m_crossSections;
+  /// Flag whether a material with cross-section above the majorant has been reported
+  bool m_majorantReported = false;
+  /// Navigator locating the tentative interaction points (created at the first use)
+  std::unique_ptr<G4Navigator> m_navigator;
+};
+}
+
+#endif /* SIMG4FAST_FASTSIMMODELWOODCOCK_H */
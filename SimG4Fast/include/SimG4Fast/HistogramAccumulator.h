@@ -0,0 +1,68 @@
+#ifndef SIMG4FAST_HISTOGRAMACCUMULATOR_H
+#define SIMG4FAST_HISTOGRAMACCUMULATOR_H
+
+// TBB
+#include "tbb/enumerable_thread_specific.h"
+
+// STL
+#include <string>
+#include <vector>
+
+class TH1F;
+
+/** HistogramAccumulator SimG4Fast/SimG4Fast/HistogramAccumulator.h HistogramAccumulator.h
+ *
+ *  Fixed-bin histogram that may be filled concurrently without locks: each thread fills its own buffer, and the
+ *  buffers are summed only when the ROOT histogram is created (at the end of the job).
+ *  The underflow and overflow bins and the statistics (entries, mean, RMS) are the same as for TH1::Fill.
+ */
+
+namespace sim {
+class HistogramAccumulator {
+public:
+  /** Constructor.
+   *  @param aName Name of the histogram.
+   *  @param aTitle Title of the histogram.
+   *  @param aNumBins Number of bins.
+   *  @param aMin Lower edge of the first bin.
+   *  @param aMax Upper edge of the last bin.
+   */
+  HistogramAccumulator(const std::string& aName, const std::string& aTitle, unsigned int aNumBins, double aMin,
+                       double aMax);
+  /** Fill the buffer of the calling thread.
+   *  @param aValue Value.
+   *  @param aWeight Weight.
+   */
+  void fill(double aValue, double aWeight = 1);
+  /** Sum the buffers of all threads into a ROOT histogram.
+   *  @return new histogram (owned by the caller)
+   */
+  TH1F* histogram() const;
+  /// Clear the buffers of all threads
+  void reset();
+
+private:
+  /// Content of the bins (with underflow and overflow) and statistics filled by one thread
+  struct Buffer {
+    explicit Buffer(unsigned int aNumBins = 0) : sumW(aNumBins + 2, 0), sumW2(aNumBins + 2, 0) {}
+    std::vector<double> sumW;
+    std::vector<double> sumW2;
+    double entries = 0;
+    double sumWInRange = 0;
+    double sumW2InRange = 0;
+    double sumWX = 0;
+    double sumWX2 = 0;
+  };
+  std::string m_name;
+  std::string m_title;
+  unsigned int m_numBins;
+  double m_min;
+  double m_max;
+  /// Number of bins per unit of the value
+  double m_scale;
+  /// Buffers of the threads
+  tbb::enumerable_thread_specific<Buffer> m_buffers;
+};
+}
+
+#endif /* SIMG4FAST_HISTOGRAMACCUMULATOR_H */
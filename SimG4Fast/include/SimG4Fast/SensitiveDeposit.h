@@ -0,0 +1,41 @@
+#ifndef SIMG4FAST_SENSITIVEDEPOSIT_H
+#define SIMG4FAST_SENSITIVEDEPOSIT_H
+
+// Geant
+#include "G4ThreeVector.hh"
+class G4Navigator;
+class G4Track;
+
+// STL
+#include <memory>
+
+/** SensitiveDeposit SimG4Fast/SimG4Fast/SensitiveDeposit.h SensitiveDeposit.h
+ *
+ *  Deposits the energy computed outside of the ordinary tracking (e.g. by a fast simulation model at the end of the
+ *  event) in the sensitive detector of the volume where it falls, as a step of zero length of the track: the readout
+ *  of the detector computes the cell ID and creates the hit.
+ *  The volumes are located with a navigator of its own (created at the first use), so the navigator of the tracking
+ *  is not disturbed. One instance is used by one thread.
+ */
+
+namespace sim {
+class SensitiveDeposit {
+public:
+  SensitiveDeposit();
+  ~SensitiveDeposit();
+  /** Deposit the energy in the sensitive detector of the volume at the position.
+   *  @param aTrack Track to which the deposit is attributed.
+   *  @param aPosition Global position.
+   *  @param aEnergy Energy.
+   *  @param aTime Global time of the deposit.
+   *  @return false if there is no sensitive detector at the position (the energy is not deposited)
+   */
+  bool deposit(G4Track& aTrack, const G4ThreeVector& aPosition, double aEnergy, double aTime);
+
+private:
+  /// Navigator locating the deposits
+  std::unique_ptr<G4Navigator> m_navigator;
+};
+}
+
+#endif /* SIMG4FAST_SENSITIVEDEPOSIT_H */
@@ -0,0 +1,115 @@
+#ifndef SIMG4FAST_SHOWERLIBRARY_H
+#define SIMG4FAST_SHOWERLIBRARY_H
+
+// FCCSW
+#include "SimG4Common/MappedFile.h"
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** ShowerLibrary SimG4Fast/SimG4Fast/ShowerLibrary.h ShowerLibrary.h
+ *
+ *  Library of frozen showers, memory-mapped from a binary file.
+ *  The showers are binned in the energy of the particle, in the absolute value of the pseudorapidity of its direction
+ *  and in the distance of its position from the z axis (at the entrance to the calorimeter).
+ *  Each shower is a list of energy spots, given in the frame of the shower: the distance along the direction of the
+ *  particle (w) and the two transverse coordinates (u, v), with the energy as a fraction of the shower energy.
+ *  The file starts with a header (magic word, version, number of bins and of showers and spots), followed by the bin
+ *  edges (doubles), the index of the first shower of each bin (one more entry than bins), the showers and the spots.
+ *  The file is written in the byte order of the machine, and is rejected if it does not match.
+ */
+
+namespace sim {
+class ShowerLibrary {
+public:
+  /// Energy spot of a shower (energy as fraction of the shower energy, positions in mm)
+  struct Spot {
+    float fraction;
+    float u;
+    float v;
+    float w;
+  };
+  /// Shower of the library and its spots
+  struct Shower {
+    /// energy of the particle that created the shower (MeV)
+    double energy;
+    std::uint64_t firstSpot;
+    std::uint64_t numSpots;
+  };
+  /// Shower to be written to a library
+  struct Record {
+    /// energy of the particle (MeV)
+    double energy;
+    /// pseudorapidity of the direction of the particle
+    double eta;
+    /// distance of the position of the particle from the z axis (mm)
+    double position;
+    std::vector<Spot> spots;
+  };
+  ShowerLibrary() = default;
+  ShowerLibrary(const ShowerLibrary&) = delete;
+  ShowerLibrary& operator=(const ShowerLibrary&) = delete;
+  ~ShowerLibrary();
+  /** Map the library file to memory.
+   *  @param[in] aFileName name of the file
+   *  @param[out] aError reason for which the file cannot be used
+   *  @returns false if the file cannot be read or is not a valid library
+   */
+  bool open(const std::string& aFileName, std::string& aError);
+  /// Unmap the library
+  void close();
+  /** Find the bin of a particle.
+   *  @param[in] aEnergy energy (MeV)
+   *  @param[in] aEta pseudorapidity of the direction
+   *  @param[in] aPosition distance from the z axis (mm)
+   *  @returns index of the bin, -1 outside of the library or if the bin has no shower
+   */
+  long bin(double aEnergy, double aEta, double aPosition) const;
+  /// Number of showers of a bin
+  inline std::size_t numShowers(long aBin) const { return m_binFirstShower[aBin + 1] - m_binFirstShower[aBin]; }
+  /// Shower of a bin
+  inline const Shower& shower(long aBin, std::size_t aIndex) const {
+    return m_showers[m_binFirstShower[aBin] + aIndex];
+  }
+  /// First spot of a shower
+  inline const Spot* spots(const Shower& aShower) const { return m_spots + aShower.firstSpot; }
+  /// Total number of showers
+  inline std::uint64_t size() const { return m_numShowers; }
+  /** Write a library.
+   *  The records outside of the bins are not written.
+   *  @param[in] aFileName name of the file
+   *  @param[in] aEnergyEdges edges of the energy bins (MeV)
+   *  @param[in] aEtaEdges edges of the bins of the absolute value of pseudorapidity
+   *  @param[in] aPositionEdges edges of the bins of the distance from the z axis (mm)
+   *  @param[in] aRecords showers
+   *  @param[out] aError reason for which the library was not written
+   *  @returns false if the edges are not increasing or the file cannot be written
+   */
+  static bool write(const std::string& aFileName, const std::vector<double>& aEnergyEdges,
+                    const std::vector<double>& aEtaEdges, const std::vector<double>& aPositionEdges,
+                    const std::vector<Record>& aRecords, std::string& aError);
+
+private:
+  /// Index of the bin of a value in the edges, -1 outside
+  static long findBin(const double* aEdges, std::uint32_t aNumBins, double aValue);
+  /// Mapped file
+  MappedFile m_file;
+  /// Number of bins in energy, eta and position
+  std::uint32_t m_numEnergy = 0;
+  std::uint32_t m_numEta = 0;
+  std::uint32_t m_numPosition = 0;
+  std::uint64_t m_numShowers = 0;
+  /// Tables inside the mapped file
+  const double* m_energyEdges = nullptr;
+  const double* m_etaEdges = nullptr;
+  const double* m_positionEdges = nullptr;
+  const std::uint64_t* m_binFirstShower = nullptr;
+  const Shower* m_showers = nullptr;
+  const Spot* m_spots = nullptr;
+};
+}
+
+#endif /* SIMG4FAST_SHOWERLIBRARY_H */
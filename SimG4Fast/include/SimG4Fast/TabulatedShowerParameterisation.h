@@ -0,0 +1,96 @@
+#ifndef SIMG4FAST_TABULATEDSHOWERPARAMETERISATION_H
+#define SIMG4FAST_TABULATEDSHOWERPARAMETERISATION_H
+
+// Geant
+#include "globals.hh"
+
+// STL
+#include <memory>
+#include <utility>
+#include <vector>
+
+/** IncompleteGammaTable SimG4Fast/SimG4Fast/TabulatedShowerParameterisation.h TabulatedShowerParameterisation.h
+ *
+ *  Table of the regularised lower incomplete gamma function P(a, x), the integral of the longitudinal profile of the
+ *  GFlash showers (a gamma distribution of shape a, x being the depth in radiation lengths times the rate).
+ *  The table covers the shapes [minShape, maxShape] and the depths [0, maxX] with regular steps and is interpolated
+ *  bilinearly; P(a, x) is computed outside of the shapes of the table and is 1 beyond maxX.
+ *  The table is filled at the construction and only read afterwards, so it may be shared by all the threads.
+ */
+
+namespace sim {
+class IncompleteGammaTable {
+public:
+  /** Constructor, fills the table.
+   *  @param[in] aMinShape smallest tabulated shape
+   *  @param[in] aMaxShape largest tabulated shape
+   *  @param[in] aShapeStep step of the shapes
+   *  @param[in] aMaxX largest tabulated depth
+   *  @param[in] aXStep step of the depths
+   */
+  IncompleteGammaTable(double aMinShape = 0.5, double aMaxShape = 16, double aShapeStep = 0.05, double aMaxX = 64,
+                       double aXStep = 0.025);
+  /** Interpolated value of the function.
+   *  @param[in] aShape shape a
+   *  @param[in] aX depth x
+   *  @return P(a, x)
+   */
+  double operator()(double aShape, double aX) const;
+  /** Value of the function, computed with the series (x < a + 1) or the continued fraction.
+   *  @param[in] aShape shape a
+   *  @param[in] aX depth x
+   *  @return P(a, x)
+   */
+  static double compute(double aShape, double aX);
+  /// Table with the default range, created at the first call and shared by all the parametrisations of the job
+  static std::shared_ptr<const IncompleteGammaTable> shared();
+  /// Number of the tabulated values
+  size_t size() const { return m_values.size(); }
+
+private:
+  /// Range and steps of the table
+  double m_minShape;
+  double m_shapeStep;
+  size_t m_numShapes;
+  double m_xStep;
+  size_t m_numX;
+  /// Values by shape, then by depth
+  std::vector<float> m_values;
+};
+
+/** TabulatedShowerParameterisation SimG4Fast/SimG4Fast/TabulatedShowerParameterisation.h
+ *  TabulatedShowerParameterisation.h
+ *
+ *  GFlash parametrisation (GFlashHomoShowerParameterisation or GFlashSamplingShowerParameterisation) whose
+ *  longitudinal profiles of the energy and of the number of spots are integrated by a lookup in the shared table of
+ *  the incomplete gamma function, instead of its evaluation for each step of each shower. The parameters of the
+ *  shower (drawn for each shower from the energy) and the radial profiles are those of the parametrisation.
+ */
+
+template <class Parameterisation>
+class TabulatedShowerParameterisation : public Parameterisation {
+public:
+  /** Constructor.
+   *  @param[in] aTable table of the incomplete gamma function (shared)
+   *  @param[in] aArgs arguments of the constructor of the parametrisation
+   */
+  template <typename... Args>
+  TabulatedShowerParameterisation(std::shared_ptr<const IncompleteGammaTable> aTable, Args&&... aArgs)
+      : Parameterisation(std::forward<Args>(aArgs)...), m_table(std::move(aTable)) {}
+  virtual ~TabulatedShowerParameterisation() = default;
+  /// Fraction of the energy of the shower deposited up to the depth
+  G4double IntegrateEneLongitudinal(G4double aLongitudinalStep) override {
+    return (*m_table)(this->Alpha, this->Beta * aLongitudinalStep / this->GetX0());
+  }
+  /// Fraction of the spots of the shower created up to the depth
+  G4double IntegrateNspLongitudinal(G4double aLongitudinalStep) override {
+    return (*m_table)(this->AlphaNspots, this->BetaNspots * aLongitudinalStep / this->GetX0());
+  }
+
+private:
+  /// Table of the incomplete gamma function
+  std::shared_ptr<const IncompleteGammaTable> m_table;
+};
+}
+
+#endif /* SIMG4FAST_TABULATEDSHOWERPARAMETERISATION_H */
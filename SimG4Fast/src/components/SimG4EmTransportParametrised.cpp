@@ -0,0 +1,57 @@
+#include "SimG4EmTransportParametrised.h"
+
+// Geant4
+#include "G4PhysicalConstants.hh"
+#include "G4ThreeVector.hh"
+#include "Randomize.hh"
+
+// STL
+#include <algorithm>
+#include <cmath>
+
+DECLARE_COMPONENT(SimG4EmTransportParametrised)
+
+SimG4EmTransportParametrised::SimG4EmTransportParametrised(const std::string& type, const std::string& name,
+                                                           const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareInterface<ISimG4EmTransportTool>(this);
+}
+
+StatusCode SimG4EmTransportParametrised::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_radiationLength <= 0 || m_moliereRadius <= 0 || m_criticalEnergy <= 0 || m_spotEnergy <= 0) {
+    error() << "Parameters of the showers need to be positive" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4EmTransportParametrised::transport(const std::vector<Track>& aTracks,
+                                                   std::vector<Deposit>& aDeposits) const {
+  const double b = 0.5;
+  // exponential transverse profile with 90% of the energy within the Moliere radius
+  const double transverseSlope = m_moliereRadius / std::log(10.);
+  for (unsigned int iTrack = 0; iTrack < aTracks.size(); ++iTrack) {
+    const Track& track = aTracks[iTrack];
+    if (track.energy <= 0) continue;
+    const double tMax = std::log(track.energy / m_criticalEnergy) + (track.pdg == 22 ? 0.5 : -0.5);
+    const double a = std::max(b * tMax + 1, 1.);
+    const unsigned int numSpots = std::max<unsigned int>(m_minSpots, std::ceil(track.energy / m_spotEnergy));
+    const double spotEnergy = track.energy / numSpots;
+    const G4ThreeVector position(track.x, track.y, track.z);
+    const G4ThreeVector direction = G4ThreeVector(track.dx, track.dy, track.dz).unit();
+    const G4ThreeVector uAxis = direction.orthogonal().unit();
+    const G4ThreeVector vAxis = direction.cross(uAxis);
+    for (unsigned int iSpot = 0; iSpot < numSpots; ++iSpot) {
+      const double depth = CLHEP::RandGamma::shoot(a, b) * m_radiationLength;
+      const double radius = -transverseSlope * std::log(1 - G4UniformRand());
+      const double phi = CLHEP::twopi * G4UniformRand();
+      const G4ThreeVector spot =
+          position + depth * direction + radius * (std::cos(phi) * uAxis + std::sin(phi) * vAxis);
+      aDeposits.push_back({iTrack, spot.x(), spot.y(), spot.z(), spotEnergy, track.time + depth / CLHEP::c_light});
+    }
+  }
+  return StatusCode::SUCCESS;
+}
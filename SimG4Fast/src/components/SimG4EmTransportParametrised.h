@@ -0,0 +1,56 @@
+#ifndef SIMG4FAST_SIMG4EMTRANSPORTPARAMETRISED_H
+#define SIMG4FAST_SIMG4EMTRANSPORTPARAMETRISED_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+#include "GaudiKernel/SystemOfUnits.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4EmTransportTool.h"
+
+/** @class SimG4EmTransportParametrised SimG4Fast/src/components/SimG4EmTransportParametrised.h
+ * SimG4EmTransportParametrised.h
+ *
+ *  Reference engine of the offload of the electromagnetic showers (CPU, in the calling thread), to validate the
+ *  configuration of SimG4FastSimEmOffloadRegion and the readouts without the external engine.
+ *  Each shower of energy E is deposited in spots of \b'spotEnergy' (at least \b'minSpots'): the depth of a spot
+ *  follows the mean longitudinal profile, a Gamma distribution in radiation lengths (\b'radiationLength') with
+ *  b = 0.5 and a maximum at ln(E / \b'criticalEnergy') - 0.5 (+ 0.5 for photons); its distance from the axis
+ *  follows an exponential distribution with 90% of the energy within the Moliere radius (\b'moliereRadius').
+ *  [For more information please see](@ref md_sim_doc_geant4fastsim).
+ */
+
+class SimG4EmTransportParametrised : public GaudiTool, virtual public ISimG4EmTransportTool {
+public:
+  explicit SimG4EmTransportParametrised(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SimG4EmTransportParametrised() = default;
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /// Name of the engine
+  virtual std::string engineName() const final { return "parametrised EM showers (CPU)"; }
+  /**  Deposit the showers of the particles of the batch.
+   *   @param[in] aTracks particles of the batch
+   *   @param[out] aDeposits energy deposits of the batch (appended)
+   *   @return status code
+   */
+  virtual StatusCode transport(const std::vector<Track>& aTracks, std::vector<Deposit>& aDeposits) const final;
+
+private:
+  /// Radiation length of the calorimeter
+  Gaudi::Property<double> m_radiationLength{this, "radiationLength", 8.9 * Gaudi::Units::mm,
+                                            "Radiation length of the calorimeter"};
+  /// Moliere radius of the calorimeter
+  Gaudi::Property<double> m_moliereRadius{this, "moliereRadius", 21.9 * Gaudi::Units::mm,
+                                          "Moliere radius of the calorimeter"};
+  /// Critical energy of the calorimeter
+  Gaudi::Property<double> m_criticalEnergy{this, "criticalEnergy", 9.6 * Gaudi::Units::MeV,
+                                           "Critical energy of the calorimeter"};
+  /// Energy of a spot
+  Gaudi::Property<double> m_spotEnergy{this, "spotEnergy", 10 * Gaudi::Units::MeV, "Energy of a spot of the shower"};
+  /// Minimum number of spots of a shower
+  Gaudi::Property<unsigned int> m_minSpots{this, "minSpots", 10, "Minimum number of spots of a shower"};
+};
+
+#endif /* SIMG4FAST_SIMG4EMTRANSPORTPARAMETRISED_H */
@@ -1,15 +1,31 @@
 #include "SimG4FastSimCalorimeterRegion.h"
 
+// FCCSW
+#include "SimG4Common/VolumeIndex.h"
+
 // Geant4
 #include "G4Electron.hh"
+#include "G4FastTrack.hh"
+#include "G4LogicalVolume.hh"
 #include "G4Positron.hh"
 #include "G4RegionStore.hh"
-#include "G4TransportationManager.hh"
+#include "G4Track.hh"
 #include "G4VFastSimulationModel.hh"
 #include "GFlashShowerModel.hh"
 
 #include "G4NistManager.hh"
 
+namespace {
+/// GFlash model triggered only by the secondary particles
+class GFlashSecondaryShowerModel : public GFlashShowerModel {
+public:
+  GFlashSecondaryShowerModel(const G4String& aName, G4Envelope* aEnvelope) : GFlashShowerModel(aName, aEnvelope) {}
+  G4bool ModelTrigger(const G4FastTrack& aFastTrack) override {
+    return aFastTrack.GetPrimaryTrack()->GetParentID() > 0 && GFlashShowerModel::ModelTrigger(aFastTrack);
+  }
+};
+}
+
 DECLARE_COMPONENT(SimG4FastSimCalorimeterRegion)
 
 SimG4FastSimCalorimeterRegion::SimG4FastSimCalorimeterRegion(const std::string& type, const std::string& name,
@@ -30,10 +46,27 @@ StatusCode SimG4FastSimCalorimeterRegion::initialize() {
     error() << "No detector name is specified for the parametrisation" << endmsg;
     return StatusCode::FAILURE;
   }
-  if (m_minTriggerEnergy > m_maxTriggerEnergy) {
-    error() << "Energy range is not defined properly" << endmsg;
+  const std::string matchingError = sim::VolumeIndex::configure(m_volumeMatching, m_volumeNames, m_matching);
+  if (!matchingError.empty()) {
+    error() << matchingError << endmsg;
     return StatusCode::FAILURE;
   }
+  for (const auto* energies :
+       {&m_minTriggerEnergies.value(), &m_maxTriggerEnergies.value(), &m_energiesToKill.value()}) {
+    for (const auto& particleEnergy : *energies) {
+      if (particleEnergy.first != 11 && particleEnergy.first != -11) {
+        error() << "GFlash parametrises only electrons and positrons, not the PDG code " << particleEnergy.first
+                << endmsg;
+        return StatusCode::FAILURE;
+      }
+    }
+  }
+  for (int pdg : {11, -11}) {
+    if (energy(m_minTriggerEnergies, pdg, m_minTriggerEnergy) > energy(m_maxTriggerEnergies, pdg, m_maxTriggerEnergy)) {
+      error() << "Energy range is not defined properly for the PDG code " << pdg << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
   if (!m_parametrisationTool.retrieve()) {
     error() << "GFlash parametrisation tool cannot be retieved" << endmsg;
     return StatusCode::FAILURE;
@@ -43,45 +76,59 @@ StatusCode SimG4FastSimCalorimeterRegion::initialize() {
 
 StatusCode SimG4FastSimCalorimeterRegion::finalize() { return GaudiTool::finalize(); }
 
+double SimG4FastSimCalorimeterRegion::energy(const std::map<int, double>& aEnergies, int aPdg,
+                                             double aDefault) const {
+  auto found = aEnergies.find(aPdg);
+  return (found != aEnergies.end() ? found->second : aDefault) / Gaudi::Units::MeV;
+}
+
 StatusCode SimG4FastSimCalorimeterRegion::create() {
-  G4LogicalVolume* world =
-      (*G4TransportationManager::GetTransportationManager()->GetWorldsIterator())->GetLogicalVolume();
-  for (const auto& calorimeterName : m_volumeNames) {
-    for (int iter_region = 0; iter_region < world->GetNoDaughters(); ++iter_region) {
-      if (world->GetDaughter(iter_region)->GetName().find(calorimeterName) != std::string::npos) {
-        /// all G4Region objects are deleted by the G4RegionStore
-        m_g4regions.emplace_back(
-            new G4Region(world->GetDaughter(iter_region)->GetLogicalVolume()->GetName() + "_fastsim"));
-        m_g4regions.back()->AddRootLogicalVolume(world->GetDaughter(iter_region)->GetLogicalVolume());
-        std::unique_ptr<GFlashShowerModel> model(
-            new GFlashShowerModel(m_g4regions.back()->GetName(), m_g4regions.back()));
-        // make model active (by default it is inactive)
-        model->SetFlagParamType(1);
-        // energy cuts - currently all are the same
-        m_particleBounds = std::unique_ptr<GFlashParticleBounds>(new GFlashParticleBounds());
-        m_particleBounds->SetMinEneToParametrise(*G4Electron::ElectronDefinition(),
-                                                 m_minTriggerEnergy / Gaudi::Units::MeV);
-        m_particleBounds->SetMinEneToParametrise(*G4Positron::PositronDefinition(),
-                                                 m_minTriggerEnergy / Gaudi::Units::MeV);
-        m_particleBounds->SetMaxEneToParametrise(*G4Electron::ElectronDefinition(),
-                                                 m_maxTriggerEnergy / Gaudi::Units::MeV);
-        m_particleBounds->SetMaxEneToParametrise(*G4Positron::PositronDefinition(),
-                                                 m_maxTriggerEnergy / Gaudi::Units::MeV);
-        m_particleBounds->SetEneToKill(*G4Electron::ElectronDefinition(), m_energyToKill / Gaudi::Units::MeV);
-        m_particleBounds->SetEneToKill(*G4Positron::PositronDefinition(), m_energyToKill / Gaudi::Units::MeV);
-        model->SetParticleBounds(*m_particleBounds);
+  for (G4LogicalVolume* volume : sim::VolumeIndex::match(m_volumeNames, m_matching)) {
+    /// all G4Region objects are deleted by the G4RegionStore
+    m_g4regions.emplace_back(new G4Region(volume->GetName() + "_fastsim"));
+    m_g4regions.back()->AddRootLogicalVolume(volume);
+    // set parametrisation with the material (created once by the tool)
+    if (m_parametrisation == nullptr) m_parametrisation = m_parametrisationTool->parametrisation();
+    createModel(m_g4regions.back(), *m_parametrisation);
+    info() << "Attaching a Calorimeter fast simulation model (GFlash) to the region "
+           << m_g4regions.back()->GetName() << endmsg;
+  }
+  return StatusCode::SUCCESS;
+}
 
-        // set parametrisation with the material
-        m_parametrisation = std::unique_ptr<GVFlashShowerParameterisation>(m_parametrisationTool->parametrisation());
-        model->SetParameterisation(*m_parametrisation);
-        // Makes the Energy Spots in the SD attached to the volume
-        m_hitMaker = std::unique_ptr<GFlashHitMaker>(new GFlashHitMaker());
-        model->SetHitMaker(*m_hitMaker);
-        m_models.push_back(std::move(model));
-        info() << "Attaching a Calorimeter fast simulation model (GFlash) to the region "
-               << m_g4regions.back()->GetName() << endmsg;
-      }
-    }
+StatusCode SimG4FastSimCalorimeterRegion::createForWorker() {
+  if (m_g4regions.empty()) return StatusCode::SUCCESS;
+  // the fast simulation managers of the regions are thread-local: the worker gets models of its own,
+  // sharing a parametrisation of the thread
+  m_workerParametrisations.push_back(m_parametrisationTool->createParametrisation());
+  for (G4Region* region : m_g4regions) {
+    createModel(region, *m_workerParametrisations.back());
   }
   return StatusCode::SUCCESS;
 }
+
+void SimG4FastSimCalorimeterRegion::createModel(G4Region* aRegion, GVFlashShowerParameterisation& aParametrisation) {
+  std::unique_ptr<GFlashShowerModel> model;
+  if (m_secondariesOnly) {
+    model.reset(new GFlashSecondaryShowerModel(aRegion->GetName(), aRegion));
+  } else {
+    model.reset(new GFlashShowerModel(aRegion->GetName(), aRegion));
+  }
+  // make model active (by default it is inactive)
+  model->SetFlagParamType(1);
+  // energy window of the electrons and of the positrons
+  // (the objects given to the model are kept for each model, as the model keeps pointers to them)
+  m_particleBounds.push_back(std::unique_ptr<GFlashParticleBounds>(new GFlashParticleBounds()));
+  for (const G4ParticleDefinition* particle : {G4Electron::ElectronDefinition(), G4Positron::PositronDefinition()}) {
+    const int pdg = particle->GetPDGEncoding();
+    m_particleBounds.back()->SetMinEneToParametrise(*particle, energy(m_minTriggerEnergies, pdg, m_minTriggerEnergy));
+    m_particleBounds.back()->SetMaxEneToParametrise(*particle, energy(m_maxTriggerEnergies, pdg, m_maxTriggerEnergy));
+    m_particleBounds.back()->SetEneToKill(*particle, energy(m_energiesToKill, pdg, m_energyToKill));
+  }
+  model->SetParticleBounds(*m_particleBounds.back());
+  model->SetParameterisation(aParametrisation);
+  // Makes the Energy Spots in the SD attached to the volume
+  m_hitMakers.push_back(std::unique_ptr<GFlashHitMaker>(new GFlashHitMaker()));
+  model->SetHitMaker(*m_hitMakers.back());
+  m_models.push_back(std::move(model));
+}
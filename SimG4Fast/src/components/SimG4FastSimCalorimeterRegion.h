@@ -8,8 +8,12 @@
 
 // FCCSW
 #include "SimG4Interface/ISimG4GflashTool.h"
+#include "SimG4Common/VolumeIndex.h"
 #include "SimG4Interface/ISimG4RegionTool.h"
 
+// STL
+#include <map>
+
 // Geant
 #include "GFlashHitMaker.hh"
 #include "GFlashParticleBounds.hh"
@@ -21,8 +25,16 @@ class G4Region;
  * SimG4FastSimCalorimeterRegion.h
  *
  *  Tool for creating regions for fast simulation, attaching GFlashModel to them.
- *  Regions are created for volumes specified in the job options (\b'volumeNames').
+ *  Regions are created for volumes specified in the job options (\b'volumeNames'), matched as set by
+ *  \b'volumeMatching' (sim::VolumeIndex).
  *  Details on the parametrisation of shower profiles is set by tool '\b parametrisation'
+ *  The model is triggered by the electrons and positrons (the particles parametrised by GFlash) with a kinetic energy
+ *  between \b'minEnergy' and \b'maxEnergy', and the electrons and positrons below \b'energyToKill' are killed. The
+ *  window may be given per particle type (\b'minEnergies', \b'maxEnergies', \b'energiesToKill', by PDG code 11 or
+ *  -11), and restricted to the secondary particles (\b'secondariesOnly'), e.g. to parametrise in the hadronic
+ *  calorimeter only the electromagnetic secondaries below a few GeV.
+ *  In the multi-threaded mode the models are created again on each worker thread, with a parametrisation of the
+ *  thread (the parametrisation holds the state of the shower being simulated).
  *  [For more information please see](@ref md_sim_doc_geant4fastsim).
  *
  *  @author Anna Zaborowska
@@ -44,6 +56,10 @@ public:
    *   @return status code
    */
   virtual StatusCode create() final;
+  /**  Create the fast simulation models of the worker thread in the regions of create()
+   *   @return status code
+   */
+  virtual StatusCode createForWorker() final;
   /**  Get the names of the volumes where fast simulation should be performed.
    *   @return vector of volume names
    */
@@ -57,24 +73,56 @@ private:
   std::vector<G4Region*> m_g4regions;
   /// Fast simulation (parametrisation) models
   std::vector<std::unique_ptr<G4VFastSimulationModel>> m_models;
-  /// GFlash model parametrisation (retrieved from the m_parametrisationTool)
-  std::unique_ptr<GVFlashShowerParameterisation> m_parametrisation{nullptr};
-  /// GFlash model configuration
-  std::unique_ptr<GFlashParticleBounds> m_particleBounds{nullptr};
-  /// GFlash hit maker
-  std::unique_ptr<GFlashHitMaker> m_hitMaker{nullptr};
+  /// GFlash model parametrisation (retrieved from the m_parametrisationTool, shared by the models)
+  std::shared_ptr<GVFlashShowerParameterisation> m_parametrisation;
+  /// GFlash model parametrisations of the worker threads (shared by the models of the thread)
+  std::vector<std::shared_ptr<GVFlashShowerParameterisation>> m_workerParametrisations;
+  /// GFlash model configurations of the models
+  std::vector<std::unique_ptr<GFlashParticleBounds>> m_particleBounds;
+  /// GFlash hit makers of the models
+  std::vector<std::unique_ptr<GFlashHitMaker>> m_hitMakers;
   /// Names of the parametrised volumes (set by job options)
   Gaudi::Property<std::vector<std::string>> m_volumeNames{
       this, "volumeNames", {}, "Names of the parametrised volumes (set by job options)"};
+  /// Matching of the volume names (set by job options)
+  Gaudi::Property<std::string> m_volumeMatching{
+      this, "volumeMatching", "daughters",
+      "Matching of the volume names: daughters (of the world, containing the name), exact, prefix or regex"};
+  /// Matching of the volume names
+  sim::VolumeIndex::Matching m_matching = sim::VolumeIndex::Matching::Daughters;
   /// minimum energy of the electron (positron) that triggers the model
   Gaudi::Property<double> m_minTriggerEnergy{this, "minEnergy", 0.1 * Gaudi::Units::GeV,
                                              "minimum energy of the electron (positron) that triggers the model"};
   /// maximum energy of the electron (positron) that triggers the model
-  Gaudi::Property<double> m_maxTriggerEnergy{this, "minEnergy", 10 * Gaudi::Units::TeV,
+  Gaudi::Property<double> m_maxTriggerEnergy{this, "maxEnergy", 10 * Gaudi::Units::TeV,
                                              "maximum energy of the electron (positron) that triggers the model"};
   /// threshold below which the electrons (positrons) are killed
-  Gaudi::Property<double> m_energyToKill{this, "minEnergy", 0.1 * Gaudi::Units::GeV,
+  Gaudi::Property<double> m_energyToKill{this, "energyToKill", 0.1 * Gaudi::Units::GeV,
                                          "threshold below which the electrons (positrons) are killed"};
+  /// minimum energy that triggers the model per PDG code (instead of minEnergy)
+  Gaudi::Property<std::map<int, double>> m_minTriggerEnergies{
+      this, "minEnergies", {}, "minimum energy that triggers the model per PDG code (11 or -11)"};
+  /// maximum energy that triggers the model per PDG code (instead of maxEnergy)
+  Gaudi::Property<std::map<int, double>> m_maxTriggerEnergies{
+      this, "maxEnergies", {}, "maximum energy that triggers the model per PDG code (11 or -11)"};
+  /// threshold below which the particles are killed per PDG code (instead of energyToKill)
+  Gaudi::Property<std::map<int, double>> m_energiesToKill{
+      this, "energiesToKill", {}, "threshold below which the particles are killed per PDG code (11 or -11)"};
+  /// Flag whether only the secondary particles trigger the model
+  Gaudi::Property<bool> m_secondariesOnly{this, "secondariesOnly", false,
+                                          "Set to true for only the secondary particles to trigger the model"};
+  /** Energy of the particle type.
+   *  @param[in] aEnergies energies per PDG code
+   *  @param[in] aPdg PDG code of the particle
+   *  @param[in] aDefault energy of the particle types not in the map
+   *  @return energy in MeV
+   */
+  double energy(const std::map<int, double>& aEnergies, int aPdg, double aDefault) const;
+  /** Create the GFlash model of the region in the calling thread.
+   *  @param[in] aRegion region of the model
+   *  @param[in] aParametrisation parametrisation of the model
+   */
+  void createModel(G4Region* aRegion, GVFlashShowerParameterisation& aParametrisation);
 };
 
 #endif /* SIMG4FAST_SIMG4FASTSIMCALORIMETERREGION_H */
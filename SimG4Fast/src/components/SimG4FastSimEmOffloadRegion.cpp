@@ -0,0 +1,75 @@
+#include "SimG4FastSimEmOffloadRegion.h"
+
+// FCCSW
+#include "SimG4Fast/FastSimModelEmOffload.h"
+
+// Geant4
+#include "G4RegionStore.hh"
+#include "G4TransportationManager.hh"
+#include "G4VFastSimulationModel.hh"
+
+DECLARE_COMPONENT(SimG4FastSimEmOffloadRegion)
+
+SimG4FastSimEmOffloadRegion::SimG4FastSimEmOffloadRegion(const std::string& type, const std::string& name,
+                                                         const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareInterface<ISimG4RegionTool>(this);
+  declareProperty("transport", m_transportTool, "Pointer to the engine transporting the electromagnetic showers");
+}
+
+SimG4FastSimEmOffloadRegion::~SimG4FastSimEmOffloadRegion() {}
+
+StatusCode SimG4FastSimEmOffloadRegion::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_volumeNames.size() == 0) {
+    error() << "No detector name is specified for the parametrisation" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_minTriggerEnergy > m_maxTriggerEnergy) {
+    error() << "Energy range is not defined properly" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_transportTool.retrieve()) {
+    error() << "Transport engine cannot be retieved" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  info() << "Electromagnetic showers are offloaded to " << m_transportTool->engineName() << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4FastSimEmOffloadRegion::finalize() { return GaudiTool::finalize(); }
+
+StatusCode SimG4FastSimEmOffloadRegion::create() {
+  G4LogicalVolume* world =
+      (*G4TransportationManager::GetTransportationManager()->GetWorldsIterator())->GetLogicalVolume();
+  for (const auto& calorimeterName : m_volumeNames) {
+    for (int iter_region = 0; iter_region < world->GetNoDaughters(); ++iter_region) {
+      if (world->GetDaughter(iter_region)->GetName().find(calorimeterName) != std::string::npos) {
+        /// all G4Region objects are deleted by the G4RegionStore
+        m_g4regions.emplace_back(
+            new G4Region(world->GetDaughter(iter_region)->GetLogicalVolume()->GetName() + "_fastsim"));
+        m_g4regions.back()->AddRootLogicalVolume(world->GetDaughter(iter_region)->GetLogicalVolume());
+        createModel(m_g4regions.back());
+        info() << "Attaching a Calorimeter fast simulation model (offload of the EM showers) to the region "
+               << m_g4regions.back()->GetName() << endmsg;
+      }
+    }
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4FastSimEmOffloadRegion::createForWorker() {
+  // the fast simulation managers of the regions are thread-local: the worker gets models of its own
+  for (G4Region* region : m_g4regions) {
+    createModel(region);
+  }
+  return StatusCode::SUCCESS;
+}
+
+void SimG4FastSimEmOffloadRegion::createModel(G4Region* aRegion) {
+  const std::set<int> pdgCodes(m_pdgCodes.value().begin(), m_pdgCodes.value().end());
+  m_models.emplace_back(new sim::FastSimModelEmOffload(aRegion->GetName(), aRegion, m_transportTool, m_minTriggerEnergy,
+                                                       m_maxTriggerEnergy, m_maxBatchSize, pdgCodes));
+}
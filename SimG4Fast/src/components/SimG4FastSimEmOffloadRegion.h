@@ -0,0 +1,83 @@
+#ifndef SIMG4FAST_SIMG4FASTSIMEMOFFLOADREGION_H
+#define SIMG4FAST_SIMG4FASTSIMEMOFFLOADREGION_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+#include "GaudiKernel/SystemOfUnits.h"
+#include "GaudiKernel/ToolHandle.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4EmTransportTool.h"
+#include "SimG4Interface/ISimG4RegionTool.h"
+
+// Geant
+class G4VFastSimulationModel;
+class G4Region;
+
+/** @class SimG4FastSimEmOffloadRegion SimG4Fast/src/components/SimG4FastSimEmOffloadRegion.h
+ * SimG4FastSimEmOffloadRegion.h
+ *
+ *  Tool for creating regions for fast simulation, attaching the model offloading the electromagnetic showers to an
+ *  external transport engine (sim::FastSimModelEmOffload) to them.
+ *  Regions are created for volumes specified in the job options (\b'volumeNames').
+ *  The showers are transported by the engine \b'transport', in batches of the particles of an event (of at most
+ *  \b'maxBatchSize' particles, if set). In the multi-threaded mode the models are created again on each worker thread,
+ *  and the engine is given the batches of several threads.
+ *  [For more information please see](@ref md_sim_doc_geant4fastsim).
+*/
+
+class SimG4FastSimEmOffloadRegion : public GaudiTool, virtual public ISimG4RegionTool {
+public:
+  explicit SimG4FastSimEmOffloadRegion(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SimG4FastSimEmOffloadRegion();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /**  Create regions and fast simulation models
+   *   @return status code
+   */
+  virtual StatusCode create() final;
+  /**  Create the fast simulation models of the worker thread in the regions of create()
+   *   @return status code
+   */
+  virtual StatusCode createForWorker() final;
+  /**  Get the names of the volumes where fast simulation should be performed.
+   *   @return vector of volume names
+   */
+  inline virtual const std::vector<std::string>& volumeNames() const final { return m_volumeNames; };
+
+private:
+  /** Create the offload model of the region in the calling thread.
+   *  @param[in] aRegion region of the model
+   */
+  void createModel(G4Region* aRegion);
+  /// Pointer to the transport engine
+  ToolHandle<ISimG4EmTransportTool> m_transportTool{"SimG4EmTransportParametrised", this, true};
+  /// Envelopes that are used in a parametric simulation
+  /// deleted by the G4RegionStore
+  std::vector<G4Region*> m_g4regions;
+  /// Fast simulation (parametrisation) models
+  std::vector<std::unique_ptr<G4VFastSimulationModel>> m_models;
+  /// Names of the parametrised volumes (set by job options)
+  Gaudi::Property<std::vector<std::string>> m_volumeNames{
+      this, "volumeNames", {}, "Names of the parametrised volumes (set by job options)"};
+  /// minimum energy of the particle that triggers the model
+  Gaudi::Property<double> m_minTriggerEnergy{this, "minEnergy", 0,
+                                             "minimum energy of the particle that triggers the model"};
+  /// maximum energy of the particle that triggers the model
+  Gaudi::Property<double> m_maxTriggerEnergy{this, "maxEnergy", 10 * Gaudi::Units::TeV,
+                                             "maximum energy of the particle that triggers the model"};
+  /// Maximum number of particles of a batch (0: one batch per event)
+  Gaudi::Property<unsigned int> m_maxBatchSize{this, "maxBatchSize", 0,
+                                               "Maximum number of particles of a batch (0: one batch per event)"};
+  /// PDG codes of the particles that trigger the model (electrons, positrons and photons if empty)
+  Gaudi::Property<std::vector<int>> m_pdgCodes{
+      this, "pdgCodes", {}, "PDG codes of the particles that trigger the model (e+, e- and photons if empty)"};
+};
+
+#endif /* SIMG4FAST_SIMG4FASTSIMEMOFFLOADREGION_H */
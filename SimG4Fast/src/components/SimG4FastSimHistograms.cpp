@@ -14,51 +14,52 @@
 DECLARE_COMPONENT(SimG4FastSimHistograms)
 
 SimG4FastSimHistograms::SimG4FastSimHistograms(const std::string& aName, ISvcLocator* aSvcLoc)
-    : GaudiAlgorithm(aName, aSvcLoc) {
+    : Gaudi::Algorithm(aName, aSvcLoc) {
   declareProperty("particlesMCparticles", m_particlesMCparticles,
                   "Handle for the EDM particles and MC particles associations to be read");
 }
 SimG4FastSimHistograms::~SimG4FastSimHistograms() {}
 
 StatusCode SimG4FastSimHistograms::initialize() {
-  if (GaudiAlgorithm::initialize().isFailure()) return StatusCode::FAILURE;
+  if (Gaudi::Algorithm::initialize().isFailure()) return StatusCode::FAILURE;
   m_histSvc = service("THistSvc");
   if (!m_histSvc) {
     error() << "Unable to locate Histogram Service" << endmsg;
     return StatusCode::FAILURE;
   }
-  m_p = new TH1F("SmP", "Smeared particles momentum", 100, 0, 100);
-  if (m_histSvc->regHist("/rec/SmP", m_p).isFailure()) {
-    error() << "Couldn't register SmP histogram" << endmsg;
-  }
-  m_diffP = new TH1F("DiffP", "Smeared-MC particles momentum", 100, -0.5, 0.5);
-  if (m_histSvc->regHist("/rec/DiffP", m_diffP).isFailure()) {
-    error() << "Couldn't register DifP histogram" << endmsg;
-  }
-  m_eta = new TH1F("SmEta", "Smeared particles pseudorapidity", 100, -10, 10);
-  if (m_histSvc->regHist("/rec/SmEta", m_eta).isFailure()) {
-    error() << "Couldn't register SmEta histogram" << endmsg;
-  }
-  m_pdg = new TH1F("SmPdg", "Smeared particles PDG code", 4500, -2250, 2249);
-  if (m_histSvc->regHist("/rec/SmPdg", m_pdg).isFailure()) {
-    error() << "Couldn't register SmPdg histogram" << endmsg;
+  for (auto* histogram : {&m_p, &m_eta, &m_diffP, &m_pdg}) {
+    histogram->reset();
   }
   return StatusCode::SUCCESS;
 }
 
-StatusCode SimG4FastSimHistograms::execute() {
-  const auto associations = m_particlesMCparticles.get();
+StatusCode SimG4FastSimHistograms::execute(const EventContext&) const {
+  const edm4hep::MCRecoParticleAssociationCollection* associations = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(m_handleMutex);
+    associations = m_particlesMCparticles.get();
+  }
   for (const auto& assoc : *associations) {
     auto mom_edm = assoc.getRec().getMomentum();
     CLHEP::Hep3Vector mom(mom_edm.x, mom_edm.y, mom_edm.z);
-    m_eta->Fill(mom.eta());
-    m_p->Fill(mom.mag());
-    m_pdg->Fill(assoc.getSim().getPDG());
+    m_eta.fill(mom.eta());
+    m_p.fill(mom.mag());
+    m_pdg.fill(assoc.getSim().getPDG());
     auto mom_edm_mc = assoc.getSim().getMomentum();
     CLHEP::Hep3Vector momMC(mom_edm_mc.x, mom_edm_mc.y, mom_edm_mc.z);
-    m_diffP->Fill((momMC.mag() - mom.mag()) / momMC.mag());
+    m_diffP.fill((momMC.mag() - mom.mag()) / momMC.mag());
   }
   return StatusCode::SUCCESS;
 }
 
-StatusCode SimG4FastSimHistograms::finalize() { return GaudiAlgorithm::finalize(); }
+StatusCode SimG4FastSimHistograms::finalize() {
+  // the histograms are created from the buffers of all threads and owned by the histogram service
+  const std::vector<std::pair<std::string, const sim::HistogramAccumulator*>> histograms{
+      {"/rec/SmP", &m_p}, {"/rec/DiffP", &m_diffP}, {"/rec/SmEta", &m_eta}, {"/rec/SmPdg", &m_pdg}};
+  for (const auto& histogram : histograms) {
+    if (m_histSvc->regHist(histogram.first, histogram.second->histogram()).isFailure()) {
+      error() << "Couldn't register " << histogram.first << " histogram" << endmsg;
+    }
+  }
+  return Gaudi::Algorithm::finalize();
+}
@@ -2,30 +2,35 @@
 #define SIMG4FAST_G4FASTSIMHISTOGRAMS_H
 
 // GAUDI
-#include "GaudiAlg/GaudiAlgorithm.h"
+#include "Gaudi/Algorithm.h"
 
 // FCCSW
 #include "k4FWCore/DataHandle.h"
+#include "SimG4Fast/HistogramAccumulator.h"
 class ITHistSvc;
 
+// STL
+#include <mutex>
+
 // datamodel
 namespace edm4hep {
 class ReconstructedParticleCollection;
 class MCRecoParticleAssociationCollection;
 }
 
-class TH1F;
-
 /** @class SimG4FastSimHistograms SimG4Components/src/SimG4FastSimHistograms.h SimG4FastSimHistograms.h
  *
  *  Fast simulation histograms algorithm.
  *  Fills validation histograms.
- *  It takes ParticleCollection (\b'smearedParticles') as the input.
+ *  It takes MCRecoParticleAssociationCollection (\b'particlesMCparticles') as the input.
+ *  The algorithm is reentrant: with the Hive scheduler it runs concurrently on several events. Only the retrieval of
+ *  the input through its DataHandle is serialized, the histograms being filled in sim::HistogramAccumulator (one
+ *  buffer per thread, without locks) and registered in THistSvc at finalize.
  *
  *  @author Anna Zaborowska
  */
 
-class SimG4FastSimHistograms : public GaudiAlgorithm {
+class SimG4FastSimHistograms : public Gaudi::Algorithm {
 public:
   explicit SimG4FastSimHistograms(const std::string&, ISvcLocator*);
   virtual ~SimG4FastSimHistograms();
@@ -33,28 +38,34 @@ public:
    *   @return status code
    */
   virtual StatusCode initialize() final;
-  /**  Fills the histograms.
+  /**  Fills the histograms with the particles of the event of the given context.
+   *   @param[in] aContext context of the event
    *   @return status code
    */
-  virtual StatusCode execute() final;
+  virtual StatusCode execute(const EventContext& aContext) const final;
   /**  Finalize.
+   *   Registers the histograms.
    *   @return status code
    */
   virtual StatusCode finalize() final;
+  /// Algorithm may be executed concurrently for different events
+  virtual bool isReEntrant() const final { return true; }
 
 private:
   /// Handle for the EDM particles and MC particles associations to be read
-  DataHandle<edm4hep::MCRecoParticleAssociationCollection> m_particlesMCparticles{"ParticlesMCparticles",
-                                                                                  Gaudi::DataHandle::Reader, this};
+  mutable DataHandle<edm4hep::MCRecoParticleAssociationCollection> m_particlesMCparticles{
+      "ParticlesMCparticles", Gaudi::DataHandle::Reader, this};
+  /// Mutex serializing the retrieval of the input (the DataHandle is not reentrant)
+  mutable std::mutex m_handleMutex;
   /// Pointer to the interface of histogram service
   SmartIF<ITHistSvc> m_histSvc;
   // Histogram of the smeared particle's momentum
-  TH1F* m_p{nullptr};
+  mutable sim::HistogramAccumulator m_p{"SmP", "Smeared particles momentum", 100, 0, 100};
   // Histogram of the smeared particle's pseudorapidity
-  TH1F* m_eta{nullptr};
+  mutable sim::HistogramAccumulator m_eta{"SmEta", "Smeared particles pseudorapidity", 100, -10, 10};
   // Histogram of the difference between MC particle's and smeared particle's momentum
-  TH1F* m_diffP{nullptr};
+  mutable sim::HistogramAccumulator m_diffP{"DiffP", "Smeared-MC particles momentum", 100, -0.5, 0.5};
   // Histogram of the smeared particle's PDG code
-  TH1F* m_pdg{nullptr};
+  mutable sim::HistogramAccumulator m_pdg{"SmPdg", "Smeared particles PDG code", 4500, -2250, 2249};
 };
 #endif /* SIMG4FAST_G4FASTSIMHISTOGRAMS_H */
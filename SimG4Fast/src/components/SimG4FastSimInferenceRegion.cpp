@@ -0,0 +1,88 @@
+#include "SimG4FastSimInferenceRegion.h"
+
+// FCCSW
+#include "SimG4Fast/FastSimModelInference.h"
+
+// Geant4
+#include "G4RegionStore.hh"
+#include "G4TransportationManager.hh"
+#include "G4VFastSimulationModel.hh"
+
+DECLARE_COMPONENT(SimG4FastSimInferenceRegion)
+
+SimG4FastSimInferenceRegion::SimG4FastSimInferenceRegion(const std::string& type, const std::string& name,
+                                                         const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareInterface<ISimG4RegionTool>(this);
+  declareProperty("inference", m_inferenceTool, "Pointer to the tool running the inference of the shower model");
+}
+
+SimG4FastSimInferenceRegion::~SimG4FastSimInferenceRegion() {}
+
+StatusCode SimG4FastSimInferenceRegion::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_volumeNames.size() == 0) {
+    error() << "No detector name is specified for the parametrisation" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_minTriggerEnergy > m_maxTriggerEnergy) {
+    error() << "Energy range is not defined properly" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_numR == 0 || m_numPhi == 0 || m_numZ == 0 || m_sizeR <= 0 || m_sizeZ <= 0) {
+    error() << "Mesh of the shower is not defined properly" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_inferenceTool.retrieve()) {
+    error() << "Inference tool cannot be retieved" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_inferenceTool->inputSize() < 2) {
+    error() << "Inference tool needs to take the latent variables and the two conditions as input" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_inferenceTool->outputSize() != size_t(m_numR) * m_numPhi * m_numZ) {
+    error() << "Output of the inference tool (" << m_inferenceTool->outputSize() << ") does not match the mesh of "
+            << m_numR.value() << " x " << m_numPhi.value() << " x " << m_numZ.value() << " cells" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4FastSimInferenceRegion::finalize() { return GaudiTool::finalize(); }
+
+StatusCode SimG4FastSimInferenceRegion::create() {
+  G4LogicalVolume* world =
+      (*G4TransportationManager::GetTransportationManager()->GetWorldsIterator())->GetLogicalVolume();
+  for (const auto& calorimeterName : m_volumeNames) {
+    for (int iter_region = 0; iter_region < world->GetNoDaughters(); ++iter_region) {
+      if (world->GetDaughter(iter_region)->GetName().find(calorimeterName) != std::string::npos) {
+        /// all G4Region objects are deleted by the G4RegionStore
+        m_g4regions.emplace_back(
+            new G4Region(world->GetDaughter(iter_region)->GetLogicalVolume()->GetName() + "_fastsim"));
+        m_g4regions.back()->AddRootLogicalVolume(world->GetDaughter(iter_region)->GetLogicalVolume());
+        createModel(m_g4regions.back());
+        info() << "Attaching a Calorimeter fast simulation model (inference) to the region "
+               << m_g4regions.back()->GetName() << endmsg;
+      }
+    }
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4FastSimInferenceRegion::createForWorker() {
+  // the fast simulation managers of the regions are thread-local: the worker gets models of its own
+  for (G4Region* region : m_g4regions) {
+    createModel(region);
+  }
+  return StatusCode::SUCCESS;
+}
+
+void SimG4FastSimInferenceRegion::createModel(G4Region* aRegion) {
+  const sim::FastSimModelInference::Mesh mesh{m_numR, m_numPhi, m_numZ, m_sizeR, m_sizeZ};
+  const std::set<int> pdgCodes(m_pdgCodes.value().begin(), m_pdgCodes.value().end());
+  m_models.emplace_back(new sim::FastSimModelInference(aRegion->GetName(), aRegion, m_inferenceTool, mesh,
+                                                       m_minTriggerEnergy, m_maxTriggerEnergy, pdgCodes));
+}
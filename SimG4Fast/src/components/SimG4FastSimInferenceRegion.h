@@ -0,0 +1,88 @@
+#ifndef SIMG4FAST_SIMG4FASTSIMINFERENCEREGION_H
+#define SIMG4FAST_SIMG4FASTSIMINFERENCEREGION_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+#include "GaudiKernel/SystemOfUnits.h"
+#include "GaudiKernel/ToolHandle.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4RegionTool.h"
+#include "SimG4Interface/ISimG4ShowerInferenceTool.h"
+
+// Geant
+class G4VFastSimulationModel;
+class G4Region;
+
+/** @class SimG4FastSimInferenceRegion SimG4Fast/src/components/SimG4FastSimInferenceRegion.h
+ * SimG4FastSimInferenceRegion.h
+ *
+ *  Tool for creating regions for fast simulation, attaching the model generating the showers with a trained
+ *  generative model (sim::FastSimModelInference) to them.
+ *  Regions are created for volumes specified in the job options (\b'volumeNames').
+ *  The inference is run by the tool \b'inference', for all the particles of an event in one batch; its output is
+ *  given on the cylindrical mesh of \b'numR' x \b'numPhi' x \b'numZ' cells of size \b'sizeR' and \b'sizeZ'.
+ *  In the multi-threaded mode the models are created again on each worker thread, and the inference tool is called by
+ *  the batches of several threads.
+ *  [For more information please see](@ref md_sim_doc_geant4fastsim).
+*/
+
+class SimG4FastSimInferenceRegion : public GaudiTool, virtual public ISimG4RegionTool {
+public:
+  explicit SimG4FastSimInferenceRegion(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SimG4FastSimInferenceRegion();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /**  Create regions and fast simulation models
+   *   @return status code
+   */
+  virtual StatusCode create() final;
+  /**  Create the fast simulation models of the worker thread in the regions of create()
+   *   @return status code
+   */
+  virtual StatusCode createForWorker() final;
+  /**  Get the names of the volumes where fast simulation should be performed.
+   *   @return vector of volume names
+   */
+  inline virtual const std::vector<std::string>& volumeNames() const final { return m_volumeNames; };
+
+private:
+  /** Create the inference model of the region in the calling thread.
+   *  @param[in] aRegion region of the model
+   */
+  void createModel(G4Region* aRegion);
+  /// Pointer to the inference tool
+  ToolHandle<ISimG4ShowerInferenceTool> m_inferenceTool{"SimG4OnnxShowerInference", this, true};
+  /// Envelopes that are used in a parametric simulation
+  /// deleted by the G4RegionStore
+  std::vector<G4Region*> m_g4regions;
+  /// Fast simulation (parametrisation) models
+  std::vector<std::unique_ptr<G4VFastSimulationModel>> m_models;
+  /// Names of the parametrised volumes (set by job options)
+  Gaudi::Property<std::vector<std::string>> m_volumeNames{
+      this, "volumeNames", {}, "Names of the parametrised volumes (set by job options)"};
+  /// minimum energy of the particle that triggers the model
+  Gaudi::Property<double> m_minTriggerEnergy{this, "minEnergy", 1 * Gaudi::Units::GeV,
+                                             "minimum energy of the particle that triggers the model"};
+  /// maximum energy of the particle that triggers the model
+  Gaudi::Property<double> m_maxTriggerEnergy{this, "maxEnergy", 1 * Gaudi::Units::TeV,
+                                             "maximum energy of the particle that triggers the model"};
+  /// Number of cells of the mesh in radius, azimuthal angle and depth
+  Gaudi::Property<unsigned int> m_numR{this, "numR", 18, "Number of cells of the mesh in radius"};
+  Gaudi::Property<unsigned int> m_numPhi{this, "numPhi", 50, "Number of cells of the mesh in azimuthal angle"};
+  Gaudi::Property<unsigned int> m_numZ{this, "numZ", 45, "Number of cells of the mesh in depth"};
+  /// Size of the cells of the mesh in radius and depth
+  Gaudi::Property<double> m_sizeR{this, "sizeR", 2.325 * Gaudi::Units::mm, "Size of the cells of the mesh in radius"};
+  Gaudi::Property<double> m_sizeZ{this, "sizeZ", 3.4 * Gaudi::Units::mm, "Size of the cells of the mesh in depth"};
+  /// PDG codes of the particles that trigger the model (electrons, positrons and photons if empty)
+  Gaudi::Property<std::vector<int>> m_pdgCodes{
+      this, "pdgCodes", {}, "PDG codes of the particles that trigger the model (e+, e- and photons if empty)"};
+};
+
+#endif /* SIMG4FAST_SIMG4FASTSIMINFERENCEREGION_H */
@@ -0,0 +1,90 @@
+#include "SimG4FastSimMuonRegion.h"
+
+// FCCSW
+#include "SimG4Fast/FastSimModelMuon.h"
+
+// Geant4
+#include "G4LogicalVolume.hh"
+#include "G4MuonMinus.hh"
+#include "G4ProcessManager.hh"
+#include "G4RegionStore.hh"
+#include "G4VFastSimulationModel.hh"
+
+DECLARE_COMPONENT(SimG4FastSimMuonRegion)
+
+SimG4FastSimMuonRegion::SimG4FastSimMuonRegion(const std::string& type, const std::string& name,
+                                               const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareInterface<ISimG4RegionTool>(this);
+}
+
+SimG4FastSimMuonRegion::~SimG4FastSimMuonRegion() {}
+
+StatusCode SimG4FastSimMuonRegion::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_volumeNames.size() == 0) {
+    error() << "No detector name is specified for the muon propagation" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  const std::string matchingError = sim::VolumeIndex::configure(m_volumeMatching, m_volumeNames, m_matching);
+  if (!matchingError.empty()) {
+    error() << matchingError << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_minTriggerEnergy > m_maxTriggerEnergy) {
+    error() << "Energy range is not defined properly" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_maxStep <= 0) {
+    error() << "Maximum step of the muon propagation needs to be positive" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4FastSimMuonRegion::finalize() {
+  m_models.clear();
+  return GaudiTool::finalize();
+}
+
+StatusCode SimG4FastSimMuonRegion::create() {
+  // the model is invoked by the fast simulation process, which needs to be in the physics list
+  G4ProcessVector* processes = G4MuonMinus::Definition()->GetProcessManager()->GetProcessList();
+  bool fastSimulation = false;
+  for (size_t iProcess = 0; iProcess < processes->size(); ++iProcess) {
+    fastSimulation |= (*processes)[iProcess]->GetProcessType() == fParameterisation;
+  }
+  if (!fastSimulation) {
+    error() << "Muon propagation model needs the fast simulation physics (SimG4FastSimPhysicsList)" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  for (G4LogicalVolume* volume : sim::VolumeIndex::match(m_volumeNames, m_matching)) {
+    /// all G4Region objects are deleted by the G4RegionStore
+    m_g4regions.emplace_back(new G4Region(volume->GetName() + "_muonfastsim"));
+    m_g4regions.back()->AddRootLogicalVolume(volume);
+    createModel(m_g4regions.back());
+    info() << "Attaching a muon propagation model to the region " << m_g4regions.back()->GetName() << endmsg;
+  }
+  if (m_g4regions.empty()) {
+    warning() << "No volume matches the names of the muon propagation envelopes" << endmsg;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4FastSimMuonRegion::createForWorker() {
+  // the fast simulation managers of the regions are thread-local: the worker gets models of its own
+  for (G4Region* region : m_g4regions) {
+    createModel(region);
+  }
+  return StatusCode::SUCCESS;
+}
+
+void SimG4FastSimMuonRegion::createModel(G4Region* aRegion) {
+  std::unique_ptr<sim::FastSimModelMuon> model(new sim::FastSimModelMuon(aRegion->GetName(), aRegion,
+                                                                         m_minTriggerEnergy, m_maxTriggerEnergy,
+                                                                         m_maxStep));
+  model->setDepositEnergy(m_depositEnergy);
+  m_models.push_back(std::move(model));
+}
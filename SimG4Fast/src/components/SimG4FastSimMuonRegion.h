@@ -0,0 +1,81 @@
+#ifndef SIMG4FAST_SIMG4FASTSIMMUONREGION_H
+#define SIMG4FAST_SIMG4FASTSIMMUONREGION_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+#include "GaudiKernel/SystemOfUnits.h"
+
+// FCCSW
+#include "SimG4Common/VolumeIndex.h"
+#include "SimG4Interface/ISimG4RegionTool.h"
+
+// Geant
+class G4VFastSimulationModel;
+class G4Region;
+
+/** @class SimG4FastSimMuonRegion SimG4Fast/src/components/SimG4FastSimMuonRegion.h SimG4FastSimMuonRegion.h
+ *
+ *  Tool for creating regions for the parametrised propagation of the muons, attaching sim::FastSimModelMuon to them.
+ *  Regions are created for volumes specified in the job options (\b'volumeNames', e.g. the hadronic calorimeter and
+ *  the return yoke), matched as set by \b'volumeMatching' (sim::VolumeIndex).
+ *  The muons within the kinetic energy range (\b'minEnergy', \b'maxEnergy') are moved through the envelopes in steps of
+ *  at most \b'maxStep', with the mean energy loss, the multiple scattering and the deflection in the field of each
+ *  step. If \b'depositEnergy' is set, the mean energy loss is deposited in the sensitive volumes crossed.
+ *  The model needs the fast simulation physics (SimG4FastSimPhysicsList). In the multi-threaded mode the models are
+ *  created again on each worker thread.
+ *  [For more information please see](@ref md_sim_doc_geant4fastsim).
+*/
+
+class SimG4FastSimMuonRegion : public GaudiTool, virtual public ISimG4RegionTool {
+public:
+  explicit SimG4FastSimMuonRegion(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SimG4FastSimMuonRegion();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /**  Create regions and fast simulation models
+   *   @return status code
+   */
+  virtual StatusCode create() final;
+  /**  Create the fast simulation models of the worker thread in the regions of create()
+   *   @return status code
+   */
+  virtual StatusCode createForWorker() final;
+
+private:
+  /** Create the propagation model of the region in the calling thread.
+   *  @param[in] aRegion region of the model
+   */
+  void createModel(G4Region* aRegion);
+  /// Envelopes of the parametrised propagation, deleted by the G4RegionStore
+  std::vector<G4Region*> m_g4regions;
+  /// Fast simulation (parametrisation) models
+  std::vector<std::unique_ptr<G4VFastSimulationModel>> m_models;
+  /// Names of the parametrised volumes (set by job options)
+  Gaudi::Property<std::vector<std::string>> m_volumeNames{this, "volumeNames", {}, "Names of the parametrised volumes"};
+  /// Matching of the volume names (set by job options)
+  Gaudi::Property<std::string> m_volumeMatching{
+      this, "volumeMatching", "daughters",
+      "Matching of the volume names: daughters (of the world, containing the name), exact, prefix or regex"};
+  /// Matching of the volume names
+  sim::VolumeIndex::Matching m_matching = sim::VolumeIndex::Matching::Daughters;
+  /// minimum kinetic energy of the muon that triggers the model
+  Gaudi::Property<double> m_minTriggerEnergy{this, "minEnergy", 1 * Gaudi::Units::GeV,
+                                             "minimum kinetic energy of the muon that triggers the model"};
+  /// maximum kinetic energy of the muon that triggers the model
+  Gaudi::Property<double> m_maxTriggerEnergy{this, "maxEnergy", 10 * Gaudi::Units::TeV,
+                                             "maximum kinetic energy of the muon that triggers the model"};
+  /// Maximum length of the steps of the propagation
+  Gaudi::Property<double> m_maxStep{this, "maxStep", 10 * Gaudi::Units::cm,
+                                    "Maximum length of the steps of the propagation"};
+  /// Flag whether the mean energy loss is deposited in the sensitive volumes crossed
+  Gaudi::Property<bool> m_depositEnergy{this, "depositEnergy", false,
+                                        "Deposit the mean energy loss in the sensitive volumes crossed"};
+};
+
+#endif /* SIMG4FAST_SIMG4FASTSIMMUONREGION_H */
@@ -0,0 +1,79 @@
+#include "SimG4FastSimShowerLibraryRegion.h"
+
+// FCCSW
+#include "SimG4Fast/FastSimModelShowerLibrary.h"
+
+// Geant4
+#include "G4RegionStore.hh"
+#include "G4TransportationManager.hh"
+#include "G4VFastSimulationModel.hh"
+
+DECLARE_COMPONENT(SimG4FastSimShowerLibraryRegion)
+
+SimG4FastSimShowerLibraryRegion::SimG4FastSimShowerLibraryRegion(const std::string& type, const std::string& name,
+                                                                 const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareInterface<ISimG4RegionTool>(this);
+}
+
+SimG4FastSimShowerLibraryRegion::~SimG4FastSimShowerLibraryRegion() {}
+
+StatusCode SimG4FastSimShowerLibraryRegion::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_volumeNames.size() == 0) {
+    error() << "No detector name is specified for the parametrisation" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_minTriggerEnergy > m_maxTriggerEnergy) {
+    error() << "Energy range is not defined properly" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  std::string reason;
+  if (!m_library.open(m_libraryFile, reason)) {
+    error() << "Shower library cannot be read: " << reason << endmsg;
+    return StatusCode::FAILURE;
+  }
+  info() << "Shower library " << m_libraryFile.value() << " holds " << m_library.size() << " showers" << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4FastSimShowerLibraryRegion::finalize() {
+  m_models.clear();
+  m_library.close();
+  return GaudiTool::finalize();
+}
+
+StatusCode SimG4FastSimShowerLibraryRegion::create() {
+  G4LogicalVolume* world =
+      (*G4TransportationManager::GetTransportationManager()->GetWorldsIterator())->GetLogicalVolume();
+  for (const auto& calorimeterName : m_volumeNames) {
+    for (int iter_region = 0; iter_region < world->GetNoDaughters(); ++iter_region) {
+      if (world->GetDaughter(iter_region)->GetName().find(calorimeterName) != std::string::npos) {
+        /// all G4Region objects are deleted by the G4RegionStore
+        m_g4regions.emplace_back(
+            new G4Region(world->GetDaughter(iter_region)->GetLogicalVolume()->GetName() + "_fastsim"));
+        m_g4regions.back()->AddRootLogicalVolume(world->GetDaughter(iter_region)->GetLogicalVolume());
+        createModel(m_g4regions.back());
+        info() << "Attaching a Calorimeter fast simulation model (shower library) to the region "
+               << m_g4regions.back()->GetName() << endmsg;
+      }
+    }
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4FastSimShowerLibraryRegion::createForWorker() {
+  // the fast simulation managers of the regions are thread-local: the worker gets models of its own
+  for (G4Region* region : m_g4regions) {
+    createModel(region);
+  }
+  return StatusCode::SUCCESS;
+}
+
+void SimG4FastSimShowerLibraryRegion::createModel(G4Region* aRegion) {
+  const std::set<int> pdgCodes(m_pdgCodes.value().begin(), m_pdgCodes.value().end());
+  m_models.emplace_back(new sim::FastSimModelShowerLibrary(aRegion->GetName(), aRegion, m_library, m_minTriggerEnergy,
+                                                           m_maxTriggerEnergy, m_randomRotation, pdgCodes));
+}
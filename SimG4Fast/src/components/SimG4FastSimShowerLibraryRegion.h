@@ -0,0 +1,86 @@
+#ifndef SIMG4FAST_SIMG4FASTSIMSHOWERLIBRARYREGION_H
+#define SIMG4FAST_SIMG4FASTSIMSHOWERLIBRARYREGION_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+#include "GaudiKernel/SystemOfUnits.h"
+
+// FCCSW
+#include "SimG4Fast/ShowerLibrary.h"
+#include "SimG4Interface/ISimG4RegionTool.h"
+
+// Geant
+class G4VFastSimulationModel;
+class G4Region;
+
+/** @class SimG4FastSimShowerLibraryRegion SimG4Fast/src/components/SimG4FastSimShowerLibraryRegion.h
+ * SimG4FastSimShowerLibraryRegion.h
+ *
+ *  Tool for creating regions for fast simulation, attaching the frozen shower model (sim::FastSimModelShowerLibrary)
+ *  to them.
+ *  Regions are created for volumes specified in the job options (\b'volumeNames').
+ *  The showers are read from the library file \b'library' (written by SimG4SaveShowerLibrary), which is mapped to
+ *  memory once and shared by all the models (of all the threads, the models are created again on each worker thread
+ *  in the multi-threaded mode).
+ *  [For more information please see](@ref md_sim_doc_geant4fastsim).
+*/
+
+class SimG4FastSimShowerLibraryRegion : public GaudiTool, virtual public ISimG4RegionTool {
+public:
+  explicit SimG4FastSimShowerLibraryRegion(const std::string& type, const std::string& name,
+                                           const IInterface* parent);
+  virtual ~SimG4FastSimShowerLibraryRegion();
+  /**  Initialize.
+   *   Map the library to memory.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /**  Create regions and fast simulation models
+   *   @return status code
+   */
+  virtual StatusCode create() final;
+  /**  Create the fast simulation models of the worker thread in the regions of create()
+   *   @return status code
+   */
+  virtual StatusCode createForWorker() final;
+  /**  Get the names of the volumes where fast simulation should be performed.
+   *   @return vector of volume names
+   */
+  inline virtual const std::vector<std::string>& volumeNames() const final { return m_volumeNames; };
+
+private:
+  /** Create the shower library model of the region in the calling thread.
+   *  @param[in] aRegion region of the model
+   */
+  void createModel(G4Region* aRegion);
+  /// Envelopes that are used in a parametric simulation
+  /// deleted by the G4RegionStore
+  std::vector<G4Region*> m_g4regions;
+  /// Fast simulation (parametrisation) models
+  std::vector<std::unique_ptr<G4VFastSimulationModel>> m_models;
+  /// Library of the showers
+  sim::ShowerLibrary m_library;
+  /// Names of the parametrised volumes (set by job options)
+  Gaudi::Property<std::vector<std::string>> m_volumeNames{
+      this, "volumeNames", {}, "Names of the parametrised volumes (set by job options)"};
+  /// Name of the library file
+  Gaudi::Property<std::string> m_libraryFile{this, "library", "", "Name of the file of the shower library"};
+  /// minimum energy of the particle that triggers the model
+  Gaudi::Property<double> m_minTriggerEnergy{this, "minEnergy", 0,
+                                             "minimum energy of the particle that triggers the model"};
+  /// maximum energy of the particle that triggers the model
+  Gaudi::Property<double> m_maxTriggerEnergy{this, "maxEnergy", 10 * Gaudi::Units::TeV,
+                                             "maximum energy of the particle that triggers the model"};
+  /// Flag whether the showers are rotated by a random angle around the direction of the particle
+  Gaudi::Property<bool> m_randomRotation{this, "randomRotation", true,
+                                         "Rotate the showers by a random angle around the direction of the particle"};
+  /// PDG codes of the particles that trigger the model (electrons, positrons and photons if empty)
+  Gaudi::Property<std::vector<int>> m_pdgCodes{
+      this, "pdgCodes", {}, "PDG codes of the particles that trigger the model (e+, e- and photons if empty)"};
+};
+
+#endif /* SIMG4FAST_SIMG4FASTSIMSHOWERLIBRARYREGION_H */
@@ -1,11 +1,12 @@
 #include "SimG4FastSimTrackerRegion.h"
 
 // FCCSW
+#include "SimG4Common/VolumeIndex.h"
 #include "SimG4Fast/FastSimModelTracker.h"
 
 // Geant4
+#include "G4LogicalVolume.hh"
 #include "G4RegionStore.hh"
-#include "G4TransportationManager.hh"
 #include "G4VFastSimulationModel.hh"
 
 DECLARE_COMPONENT(SimG4FastSimTrackerRegion)
@@ -28,10 +29,19 @@ StatusCode SimG4FastSimTrackerRegion::initialize() {
     error() << "No detector name is specified for the parametrisation" << endmsg;
     return StatusCode::FAILURE;
   }
+  const std::string matchingError = sim::VolumeIndex::configure(m_volumeMatching, m_volumeNames, m_matching);
+  if (!matchingError.empty()) {
+    error() << matchingError << endmsg;
+    return StatusCode::FAILURE;
+  }
   if (m_minMomentum > m_maxMomentum) {
     error() << "Momentum range is not defined properly" << endmsg;
     return StatusCode::FAILURE;
   }
+  if (m_createHits && (m_hitResolutionRPhi < 0 || m_hitResolutionZ < 0 || m_hitMaxStep <= 0)) {
+    error() << "Resolutions of the hits need to be non-negative and the maximum step positive" << endmsg;
+    return StatusCode::FAILURE;
+  }
   if (!m_smearTool.retrieve()) {
     error() << "Smearing tool cannot be retieved" << endmsg;
     return StatusCode::FAILURE;
@@ -46,20 +56,37 @@ StatusCode SimG4FastSimTrackerRegion::initialize() {
 StatusCode SimG4FastSimTrackerRegion::finalize() { return GaudiTool::finalize(); }
 
 StatusCode SimG4FastSimTrackerRegion::create() {
-  G4LogicalVolume* world =
-      (*G4TransportationManager::GetTransportationManager()->GetWorldsIterator())->GetLogicalVolume();
-  for (const auto& trackerName : m_volumeNames) {
-    for (int iter_region = 0; iter_region < world->GetNoDaughters(); ++iter_region) {
-      if (world->GetDaughter(iter_region)->GetName().find(trackerName) != std::string::npos) {
-        /// all G4Region objects are deleted by the G4RegionStore
-        m_g4regions.emplace_back(
-            new G4Region(world->GetDaughter(iter_region)->GetLogicalVolume()->GetName() + "_fastsim"));
-        m_g4regions.back()->AddRootLogicalVolume(world->GetDaughter(iter_region)->GetLogicalVolume());
-        m_models.emplace_back(new sim::FastSimModelTracker(m_g4regions.back()->GetName(), m_g4regions.back(),
-                                                           m_smearTool, m_minMomentum, m_maxMomentum, m_maxEta));
-        info() << "Attaching a Tracker fast simulation model to the region " << m_g4regions.back()->GetName() << endmsg;
-      }
-    }
+  for (G4LogicalVolume* volume : sim::VolumeIndex::match(m_volumeNames, m_matching)) {
+    /// all G4Region objects are deleted by the G4RegionStore
+    m_g4regions.emplace_back(new G4Region(volume->GetName() + "_fastsim"));
+    m_g4regions.back()->AddRootLogicalVolume(volume);
+    createModel(m_g4regions.back(), false);
+    info() << "Attaching a Tracker fast simulation model to the region " << m_g4regions.back()->GetName() << endmsg;
   }
   return StatusCode::SUCCESS;
 }
+
+StatusCode SimG4FastSimTrackerRegion::createForWorker() {
+  if (m_g4regions.empty()) return StatusCode::SUCCESS;
+  // the smearing tool is shared by the models of all the threads
+  if (!m_smearTool->supportsConcurrentSmearing()) {
+    error() << "Smearing tool " << m_smearTool.typeAndName() << " cannot smear concurrently, "
+            << "the tracker fast simulation cannot run on several threads" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  // the fast simulation managers of the regions are thread-local: the worker gets models of its own
+  for (G4Region* region : m_g4regions) {
+    createModel(region, true);
+  }
+  return StatusCode::SUCCESS;
+}
+
+void SimG4FastSimTrackerRegion::createModel(G4Region* aRegion, bool aConcurrentSmearing) {
+  std::unique_ptr<sim::FastSimModelTracker> model(new sim::FastSimModelTracker(
+      aRegion->GetName(), aRegion, m_smearTool, m_minMomentum, m_maxMomentum, m_maxEta));
+  if (m_createHits) {
+    model->setHitParameters({m_hitResolutionRPhi, m_hitResolutionZ, m_hitEnergyPerLength, m_hitMaxStep});
+  }
+  model->setConcurrentSmearing(aConcurrentSmearing);
+  m_models.push_back(std::move(model));
+}
@@ -3,10 +3,12 @@
 
 // Gaudi
 #include "GaudiAlg/GaudiTool.h"
+#include "GaudiKernel/SystemOfUnits.h"
 #include "GaudiKernel/ToolHandle.h"
 
 // FCCSW
 #include "SimG4Interface/ISimG4ParticleSmearTool.h"
+#include "SimG4Common/VolumeIndex.h"
 #include "SimG4Interface/ISimG4RegionTool.h"
 
 // Geant
@@ -16,9 +18,14 @@ class G4Region;
 /** @class SimG4FastSimTrackerRegion SimG4Fast/src/components/SimG4FastSimTrackerRegion.h SimG4FastSimTrackerRegion.h
  *
  *  Tool for creating regions for fast simulation, attaching sim::FastSimModelTracker to them.
- *  Regions are created for volumes specified in the job options (\b'volumeNames').
+ *  Regions are created for volumes specified in the job options (\b'volumeNames'), matched as set by
+ *  \b'volumeMatching' (sim::VolumeIndex).
  *  User may define in job options the momentum range (\b'minP', \b'maxP') and the maximum pseudorapidity (\b'maxEta')
  *  for which the fast simulation is triggered (for other particles full simulation is performed).
+ *  If \b'createHits' is set, the hits are created in the sensitive volumes crossed by the trajectory, with the
+ *  position smeared by \b'hitResolutionRPhi' and \b'hitResolutionZ' (only for the trajectories computed analytically).
+ *  In the multi-threaded mode the models are created again on each worker thread, and they smear the momenta
+ *  concurrently with the random numbers of the thread (the smearing tool needs to support it).
  *  [For more information please see](@ref md_sim_doc_geant4fastsim).
  *
  *  @author Anna Zaborowska
@@ -40,6 +47,10 @@ public:
    *   @return status code
    */
   virtual StatusCode create() final;
+  /**  Create the fast simulation models of the worker thread in the regions of create()
+   *   @return status code
+   */
+  virtual StatusCode createForWorker() final;
   /**  Get the names of the volumes where fast simulation should be performed.
    *   @return vector of volume names
    */
@@ -58,6 +69,11 @@ public:
   inline virtual double maxEta() const final { return m_maxEta; };
 
 private:
+  /** Create the tracker model of the region in the calling thread.
+   *  @param[in] aRegion region of the model
+   *  @param[in] aConcurrentSmearing flag whether the momenta are smeared concurrently with the other threads
+   */
+  void createModel(G4Region* aRegion, bool aConcurrentSmearing);
   /// Pointer to a smearing tool, to retrieve tracker configuration (names of volumes)
   ToolHandle<ISimG4ParticleSmearTool> m_smearTool{"SimG4ParticleSmearSimple", this, true};
   /// Envelopes that are used in a parametric simulation
@@ -67,12 +83,34 @@ private:
   std::vector<std::unique_ptr<G4VFastSimulationModel>> m_models;
   /// Names of the parametrised volumes (set by job options)
   Gaudi::Property<std::vector<std::string>> m_volumeNames{this, "volumeNames", {}, "Names of the parametrised volumes"};
+  /// Matching of the volume names (set by job options)
+  Gaudi::Property<std::string> m_volumeMatching{
+      this, "volumeMatching", "daughters",
+      "Matching of the volume names: daughters (of the world, containing the name), exact, prefix or regex"};
+  /// Matching of the volume names
+  sim::VolumeIndex::Matching m_matching = sim::VolumeIndex::Matching::Daughters;
   /// minimum momentum that triggers the fast sim model (set by job options)
   Gaudi::Property<double> m_minMomentum{this, "minMomentum", 0, "minimum momentum that triggers the fast sim model"};
   /// maximum momentum that triggers the fast sim model (set by job options)
   Gaudi::Property<double> m_maxMomentum{this, "maxMomentum", 0, "maximum momentum that triggers the fast sim model"};
   /// maximum pseudorapidity (set by job options)
   Gaudi::Property<double> m_maxEta{this, "maxEta", 0, "maximum pseudorapidity"};
+  /// Flag whether the hits are created in the sensitive volumes crossed by the trajectory
+  Gaudi::Property<bool> m_createHits{this, "createHits", false,
+                                     "Create the hits in the sensitive volumes crossed by the trajectory"};
+  /// Resolution of the hit position in r-phi
+  Gaudi::Property<double> m_hitResolutionRPhi{this, "hitResolutionRPhi", 0.01 * Gaudi::Units::mm,
+                                              "Resolution of the hit position in r-phi"};
+  /// Resolution of the hit position in z
+  Gaudi::Property<double> m_hitResolutionZ{this, "hitResolutionZ", 0.01 * Gaudi::Units::mm,
+                                           "Resolution of the hit position in z"};
+  /// Energy deposited per path length in the sensitive volumes (most probable value in silicon by default)
+  Gaudi::Property<double> m_hitEnergyPerLength{
+      this, "hitEnergyPerLength", 0.28 * Gaudi::Units::MeV / Gaudi::Units::mm,
+      "Energy deposited per path length in the sensitive volumes"};
+  /// Maximum length of the chords of the helix used to search for the sensitive volumes
+  Gaudi::Property<double> m_hitMaxStep{this, "hitMaxStep", 10 * Gaudi::Units::mm,
+                                       "Maximum length of the chords of the helix used to search for the volumes"};
 };
 
 #endif /* SIMG4FAST_SIMG4FASTSIMTRACKERREGION_H */
@@ -4,6 +4,9 @@
 #include "G4NistManager.hh"
 #include "GFlashHomoShowerParameterisation.hh"
 
+// FCCSW
+#include "SimG4Fast/TabulatedShowerParameterisation.h"
+
 DECLARE_COMPONENT(SimG4GflashHomoCalo)
 
 SimG4GflashHomoCalo::SimG4GflashHomoCalo(const std::string& type, const std::string& name, const IInterface* parent)
@@ -29,15 +32,19 @@ StatusCode SimG4GflashHomoCalo::initialize() {
 
 StatusCode SimG4GflashHomoCalo::finalize() { return GaudiTool::finalize(); }
 
-std::unique_ptr<GVFlashShowerParameterisation> SimG4GflashHomoCalo::parametrisation() {
-  G4NistManager* nist = G4NistManager::Instance();
-  std::unique_ptr<GVFlashShowerParameterisation> parametrisation = std::unique_ptr<GFlashHomoShowerParameterisation>(
-      new GFlashHomoShowerParameterisation(nist->FindOrBuildMaterial(m_material.value())));
-
-  // TODO move to sampling tool
-  // G4NistManager* nist = G4NistManager::Instance();
-  // m_parametrisation = std::unique_ptr<GFlashSamplingShowerParameterisation>(new GFlashSamplingShowerParameterisation(
-  //     nist->FindOrBuildMaterial("G4_lAr"),  nist->FindOrBuildMaterial("G4_Pb"), 6, 2));
+std::shared_ptr<GVFlashShowerParameterisation> SimG4GflashHomoCalo::parametrisation() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_parametrisation == nullptr) {
+    m_parametrisation = createParametrisation();
+  }
+  return m_parametrisation;
+}
 
-  return std::move(parametrisation);
+std::shared_ptr<GVFlashShowerParameterisation> SimG4GflashHomoCalo::createParametrisation() {
+  G4Material* material = G4NistManager::Instance()->FindOrBuildMaterial(m_material.value());
+  if (m_tabulate) {
+    return std::make_shared<sim::TabulatedShowerParameterisation<GFlashHomoShowerParameterisation>>(
+        sim::IncompleteGammaTable::shared(), material);
+  }
+  return std::make_shared<GFlashHomoShowerParameterisation>(material);
 }
@@ -7,11 +7,17 @@
 // FCCSW
 #include "SimG4Interface/ISimG4GflashTool.h"
 
+// STL
+#include <mutex>
+
 /** @class SimG4GflashHomoCalo SimG4Fast/src/components/SimG4GflashHomoCalo.h SimG4GflashHomoCalo.h
  *
  *  Tool creating a parametrisation of a homogenous calorimeter.
  *  The original parameters from arXiv:hep-ex/0001020v1 are taken.
  *  Material of the calorimeter is set in a property '\b material'.
+ *  The parametrisation is created once and shared by the regions using the tool. If '\b tabulate' is set, the
+ *  longitudinal profiles are integrated with the table of the incomplete gamma function shared by the job
+ *  (sim::TabulatedShowerParameterisation).
  *
  *  @author Anna Zaborowska
 */
@@ -28,12 +34,23 @@ public:
    *   @return status code
    */
   virtual StatusCode finalize() final;
-  /**  Get the parametrisation
-   *   @return unique pointer to the parametrisation
+  /**  Get the parametrisation, created at the first call.
+   *   @return shared pointer to the parametrisation
+   */
+  virtual std::shared_ptr<GVFlashShowerParameterisation> parametrisation() final;
+  /**  Create a new parametrisation, not shared with the other models.
+   *   @return shared pointer to the new parametrisation
    */
-  virtual std::unique_ptr<GVFlashShowerParameterisation> parametrisation() final;
+  virtual std::shared_ptr<GVFlashShowerParameterisation> createParametrisation() final;
 
 private:
+  /// Parametrisation shared by the models (created at the first request)
+  std::shared_ptr<GVFlashShowerParameterisation> m_parametrisation;
+  /// Mutex of the creation of the parametrisation
+  std::mutex m_mutex;
+  /// Flag whether the longitudinal profiles are integrated with the table of the incomplete gamma function
+  Gaudi::Property<bool> m_tabulate{this, "tabulate", false,
+                                   "Integrate the longitudinal profiles with a shared table instead of analytically"};
   /// Material name of the homogenous calorimeter (to be searched for in Geant NIST table)
   Gaudi::Property<std::string> m_material{
       this, "material", "", "Material name of the homogenous calorimeter (to be searched for in Geant NIST table)"};
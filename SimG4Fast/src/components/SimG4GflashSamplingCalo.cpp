@@ -4,6 +4,9 @@
 #include "G4NistManager.hh"
 #include "GFlashSamplingShowerParameterisation.hh"
 
+// FCCSW
+#include "SimG4Fast/TabulatedShowerParameterisation.h"
+
 DECLARE_COMPONENT(SimG4GflashSamplingCalo)
 
 SimG4GflashSamplingCalo::SimG4GflashSamplingCalo(const std::string& type, const std::string& name,
@@ -34,11 +37,22 @@ StatusCode SimG4GflashSamplingCalo::initialize() {
 
 StatusCode SimG4GflashSamplingCalo::finalize() { return GaudiTool::finalize(); }
 
-std::unique_ptr<GVFlashShowerParameterisation> SimG4GflashSamplingCalo::parametrisation() {
+std::shared_ptr<GVFlashShowerParameterisation> SimG4GflashSamplingCalo::parametrisation() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_parametrisation == nullptr) {
+    m_parametrisation = createParametrisation();
+  }
+  return m_parametrisation;
+}
+
+std::shared_ptr<GVFlashShowerParameterisation> SimG4GflashSamplingCalo::createParametrisation() {
   G4NistManager* nist = G4NistManager::Instance();
-  std::unique_ptr<GVFlashShowerParameterisation> parametrisation =
-      std::unique_ptr<GFlashSamplingShowerParameterisation>(new GFlashSamplingShowerParameterisation(
-          nist->FindOrBuildMaterial(m_materialActive.value()), nist->FindOrBuildMaterial(m_materialPassive.value()),
-          m_thicknessActive.value(), m_thicknessPassive.value()));
-  return std::move(parametrisation);
+  G4Material* active = nist->FindOrBuildMaterial(m_materialActive.value());
+  G4Material* passive = nist->FindOrBuildMaterial(m_materialPassive.value());
+  if (m_tabulate) {
+    return std::make_shared<sim::TabulatedShowerParameterisation<GFlashSamplingShowerParameterisation>>(
+        sim::IncompleteGammaTable::shared(), active, passive, m_thicknessActive.value(), m_thicknessPassive.value());
+  }
+  return std::make_shared<GFlashSamplingShowerParameterisation>(active, passive, m_thicknessActive.value(),
+                                                                m_thicknessPassive.value());
 }
@@ -7,6 +7,9 @@
 // FCCSW
 #include "SimG4Interface/ISimG4GflashTool.h"
 
+// STL
+#include <mutex>
+
 /** @class SimG4GflashSamplingCalo SimG4Fast/src/components/SimG4GflashSamplingCalo.h SimG4GflashSamplingCalo.h
  *
  *  Tool creating a parametrisation of a sampling calorimeter.
@@ -14,6 +17,9 @@
  *  Materials of the active and passive layers of the calorimeter are set in properties '\b materialActive' and '\b
  * materialPassive'.
  *  Relative thicknessees of the layers are set in properties '\b thicknessActive' and '\b thicknessPassive'.
+ *  The parametrisation is created once and shared by the regions using the tool. If '\b tabulate' is set, the
+ *  longitudinal profiles are integrated with the table of the incomplete gamma function shared by the job
+ *  (sim::TabulatedShowerParameterisation).
  *
  *  @author Anna Zaborowska
 */
@@ -30,12 +36,23 @@ public:
    *   @return status code
    */
   virtual StatusCode finalize() final;
-  /**  Get the parametrisation
-   *   @return unique pointer to the parametrisation
+  /**  Get the parametrisation, created at the first call.
+   *   @return shared pointer to the parametrisation
+   */
+  virtual std::shared_ptr<GVFlashShowerParameterisation> parametrisation() final;
+  /**  Create a new parametrisation, not shared with the other models.
+   *   @return shared pointer to the new parametrisation
    */
-  virtual std::unique_ptr<GVFlashShowerParameterisation> parametrisation() final;
+  virtual std::shared_ptr<GVFlashShowerParameterisation> createParametrisation() final;
 
 private:
+  /// Parametrisation shared by the models (created at the first request)
+  std::shared_ptr<GVFlashShowerParameterisation> m_parametrisation;
+  /// Mutex of the creation of the parametrisation
+  std::mutex m_mutex;
+  /// Flag whether the longitudinal profiles are integrated with the table of the incomplete gamma function
+  Gaudi::Property<bool> m_tabulate{this, "tabulate", false,
+                                   "Integrate the longitudinal profiles with a shared table instead of analytically"};
   /// Material name of the active layer in the sampling calorimeter (to be searched for in Geant NIST table)
   Gaudi::Property<std::string> m_materialActive{
       this, "materialActive", "",
@@ -2,7 +2,6 @@
 
 // Gaudi
 
-#include "GaudiKernel/IRndmGen.h"
 #include "GaudiKernel/IRndmGenSvc.h"
 
 // ROOT
@@ -11,6 +10,10 @@
 // CLHEP
 #include "CLHEP/Vector/ThreeVector.h"
 
+// STL
+#include <algorithm>
+#include <cmath>
+
 DECLARE_COMPONENT(SimG4ParticleSmearFormula)
 
 SimG4ParticleSmearFormula::SimG4ParticleSmearFormula(const std::string& type, const std::string& name,
@@ -30,15 +33,65 @@ StatusCode SimG4ParticleSmearFormula::initialize() {
     error() << "Couldn't get RndmGenSvc" << endmsg;
     return StatusCode::FAILURE;
   }
+  if (m_gauss.initialize(m_randSvc, Rndm::Gauss(0, 1)).isFailure()) {
+    error() << "Couldn't initialize the Gaussian random number generator" << endmsg;
+    return StatusCode::FAILURE;
+  }
   if (!m_resolutionMomentumStr.empty()) {
     m_resolutionMomentum = TFormula("pdep", m_resolutionMomentumStr.value().c_str());
     info() << "Momentum-dependent resolutions: " << m_resolutionMomentum.GetExpFormula() << endmsg;
+    if (m_tabulationMaxMomentum > m_tabulationMinMomentum && m_resolutionMomentum.IsValid()) {
+      return tabulate();
+    }
   } else {
     info() << "No momentum-dependent resolutions defined." << endmsg;
   }
   return StatusCode::SUCCESS;
 }
 
+StatusCode SimG4ParticleSmearFormula::tabulate() {
+  // the number of intervals is doubled until the interpolation error in the middle of each interval is small enough
+  const size_t maxIntervals = 1 << 20;
+  const double range = m_tabulationMaxMomentum - m_tabulationMinMomentum;
+  for (size_t numIntervals = 64; numIntervals <= maxIntervals; numIntervals *= 2) {
+    const double step = range / numIntervals;
+    m_table.resize(numIntervals + 1);
+    for (size_t i = 0; i <= numIntervals; ++i) {
+      m_table[i] = m_resolutionMomentum.Eval(m_tabulationMinMomentum + i * step);
+    }
+    double maxError = 0;
+    for (size_t i = 0; i < numIntervals; ++i) {
+      const double middle = m_resolutionMomentum.Eval(m_tabulationMinMomentum + (i + 0.5) * step);
+      maxError = std::max(maxError, std::abs(middle - 0.5 * (m_table[i] + m_table[i + 1])));
+    }
+    if (maxError <= m_tabulationPrecision) {
+      m_tableInvStep = 1. / step;
+      info() << "Resolutions tabulated on " << m_table.size() << " points between " << m_tabulationMinMomentum
+             << " and " << m_tabulationMaxMomentum << " (maximum interpolation error " << maxError << ")" << endmsg;
+      return StatusCode::SUCCESS;
+    }
+  }
+  m_table.clear();
+  error() << "Unable to tabulate the resolutions with precision " << m_tabulationPrecision << " on less than "
+          << maxIntervals << " intervals" << endmsg;
+  return StatusCode::FAILURE;
+}
+
+double SimG4ParticleSmearFormula::resolution(double aMom) const {
+  if (!m_table.empty() && aMom >= m_tabulationMinMomentum && aMom <= m_tabulationMaxMomentum) {
+    const double position = (aMom - m_tabulationMinMomentum) * m_tableInvStep;
+    const size_t i = std::min(static_cast<size_t>(position), m_table.size() - 2);
+    const double fraction = position - i;
+    return m_table[i] + fraction * (m_table[i + 1] - m_table[i]);
+  }
+  std::unique_ptr<TFormula>& formula = m_threadFormulas.local();
+  if (formula == nullptr) {
+    std::lock_guard<std::mutex> lock(m_formulaMutex);
+    formula = std::make_unique<TFormula>(m_resolutionMomentum);
+  }
+  return formula->Eval(aMom);
+}
+
 StatusCode SimG4ParticleSmearFormula::finalize() { return GaudiTool::finalize(); }
 
 StatusCode SimG4ParticleSmearFormula::smearMomentum(CLHEP::Hep3Vector& aMom, int /*aPdg*/) {
@@ -46,8 +99,29 @@ StatusCode SimG4ParticleSmearFormula::smearMomentum(CLHEP::Hep3Vector& aMom, int
     error() << "Unable to smear particle's momentum - no resolution given!" << endmsg;
     return StatusCode::FAILURE;
   }
-  m_randSvc->generator(Rndm::Gauss(1, m_resolutionMomentum.Eval(aMom.mag())), m_gauss).ignore();
-  double tmp = m_gauss->shoot();
-  aMom *= tmp;
+  aMom *= 1 + resolution(aMom.mag()) * m_gauss.shoot();
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4ParticleSmearFormula::smearMomenta(CLHEP::Hep3Vector* aMom, const int* aPdg, size_t aSize) {
+  if (!m_resolutionMomentum.IsValid()) {
+    error() << "Unable to smear particle's momentum - no resolution given!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_gauss.shootArray(m_gaussNumbers, aSize).isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  return smearMomenta(aMom, aPdg, aSize, m_gaussNumbers.data());
+}
+
+StatusCode SimG4ParticleSmearFormula::smearMomenta(CLHEP::Hep3Vector* aMom, const int* /*aPdg*/, size_t aSize,
+                                                   const double* aGauss) const {
+  if (!m_resolutionMomentum.IsValid()) {
+    error() << "Unable to smear particle's momentum - no resolution given!" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  for (size_t i = 0; i < aSize; ++i) {
+    aMom[i] *= 1 + resolution(aMom[i].mag()) * aGauss[i];
+  }
   return StatusCode::SUCCESS;
 }
@@ -5,11 +5,18 @@
 #include "GaudiAlg/GaudiTool.h"
 #include "GaudiKernel/RndmGenerators.h"
 class IRndmGenSvc;
-class IRndmGen;
+
+// STL
+#include <memory>
+#include <mutex>
+#include <vector>
 
 // ROOT
 #include "TFormula.h"
 
+// TBB
+#include "tbb/enumerable_thread_specific.h"
+
 // FCCSW
 #include "SimG4Interface/ISimG4ParticleSmearTool.h"
 
@@ -18,6 +25,10 @@ class IRndmGen;
  *  Formula particle smearing tool.
  *  The resolution dependence can be expressed by an arbitrary formula in the configuration.
  *  Smears momentum of the particle following a Gaussian distribution, using the evaluated formula as the mean.
+ *  If the momentum range \b'tabulationMinMomentum' - \b'tabulationMaxMomentum' is given, the formula is tabulated at
+ *  initialization on equidistant points (refined until the linear interpolation differs from the formula by less than
+ *  \b'tabulationPrecision' in the middle of all the intervals), and interpolated for the particles in that range.
+ *  The formula is evaluated for the particles outside of the range, by each thread on its own copy of the formula.
  *  [For more information please see](@ref md_sim_doc_geant4fastsim).
  *
  *  @author Anna Zaborowska
@@ -44,6 +55,26 @@ public:
    */
   virtual StatusCode smearMomentum(CLHEP::Hep3Vector& aMom, int aPdg = 0) final;
 
+  /**  Smear the momenta of several particles, with the Gaussian random numbers drawn in one block
+   *   @param aMom Particle momenta to be smeared.
+   *   @param[in] aPdg PDG codes of the particles (nullptr: all 0).
+   *   @param[in] aSize Number of particles.
+   *   @return status code
+   */
+  virtual StatusCode smearMomenta(CLHEP::Hep3Vector* aMom, const int* aPdg, size_t aSize) final;
+
+  /**  Smear the momenta of several particles with the given unit Gaussian random numbers (thread-safe)
+   *   @param aMom Particle momenta to be smeared.
+   *   @param[in] aPdg PDG codes of the particles (nullptr: all 0).
+   *   @param[in] aSize Number of particles.
+   *   @param[in] aGauss Random numbers from the unit Gaussian distribution, one per particle.
+   *   @return status code
+   */
+  virtual StatusCode smearMomenta(CLHEP::Hep3Vector* aMom, const int* aPdg, size_t aSize,
+                                  const double* aGauss) const final;
+  /// The momenta may be smeared concurrently with the given random numbers
+  inline virtual bool supportsConcurrentSmearing() const final { return true; }
+
   /**  Check conditions of the smearing model, especially if the given parametrs do not exceed the parameters of the
    * model.
    *   @param[in] aMinMomentum Minimum momentum.
@@ -54,12 +85,40 @@ public:
   inline virtual StatusCode checkConditions(double, double, double) const final { return StatusCode::SUCCESS; }
 
 private:
+  /**  Tabulate the formula in the momentum range set by job options.
+   *   @return status code
+   */
+  StatusCode tabulate();
+  /**  Get the resolution for the momentum, from the table if it is in its range.
+   *   @param[in] aMom Particle's momentum
+   *   @return Resolution
+   */
+  double resolution(double aMom) const;
   /// TFormula representing resolution momentum-dependent for the smearing
   TFormula m_resolutionMomentum;
+  /// Copies of the formula, one per thread smearing with its own random numbers (TFormula::Eval is not thread-safe)
+  mutable tbb::enumerable_thread_specific<std::unique_ptr<TFormula>> m_threadFormulas;
+  /// Protects the formula while it is copied for a new thread
+  mutable std::mutex m_formulaMutex;
   /// Random Number Service
   SmartIF<IRndmGenSvc> m_randSvc;
-  /// Gaussian random number generator used for smearing with a constant resolution (m_sigma)
-  IRndmGen* m_gauss;
+  /// Unit Gaussian random number generator, scaled by the resolution
+  Rndm::Numbers m_gauss;
+  /// Random numbers of the particles smeared together (reused between calls)
+  std::vector<double> m_gaussNumbers;
+  /// Minimum momentum of the tabulated formula
+  Gaudi::Property<double> m_tabulationMinMomentum{this, "tabulationMinMomentum", 0,
+                                                  "Minimum momentum of the tabulated formula"};
+  /// Maximum momentum of the tabulated formula (formula not tabulated if not above the minimum)
+  Gaudi::Property<double> m_tabulationMaxMomentum{this, "tabulationMaxMomentum", 0,
+                                                  "Maximum momentum of the tabulated formula (0: not tabulated)"};
+  /// Maximum difference between the interpolated and the evaluated formula
+  Gaudi::Property<double> m_tabulationPrecision{this, "tabulationPrecision", 1e-6,
+                                                "Maximum difference between the interpolated and the evaluated formula"};
+  /// Values of the formula on equidistant points from the minimum to the maximum momentum of the table
+  std::vector<double> m_table;
+  /// Inverse of the distance between the points of the table
+  double m_tableInvStep = 0;
   /// string defining a TFormula representing resolution momentum-dependent for the smearing (set by job options)
   Gaudi::Property<std::string> m_resolutionMomentumStr{
       this, "resolutionMomentum", "",
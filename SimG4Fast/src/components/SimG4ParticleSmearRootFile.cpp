@@ -2,7 +2,6 @@
 
 // Gaudi
 
-#include "GaudiKernel/IRndmGen.h"
 #include "GaudiKernel/IRndmGenSvc.h"
 #include "GaudiKernel/SystemOfUnits.h"
 
@@ -15,6 +14,9 @@
 #include "CLHEP/Units/SystemOfUnits.h"
 #include "CLHEP/Vector/ThreeVector.h"
 
+// STL
+#include <algorithm>
+
 DECLARE_COMPONENT(SimG4ParticleSmearRootFile)
 
 SimG4ParticleSmearRootFile::SimG4ParticleSmearRootFile(const std::string& type, const std::string& name,
@@ -38,6 +40,10 @@ StatusCode SimG4ParticleSmearRootFile::initialize() {
     error() << "Couldn't read the input resolution file from tkLayout" << endmsg;
     return StatusCode::FAILURE;
   }
+  if (m_gauss.initialize(m_randSvc, Rndm::Gauss(0, 1)).isFailure()) {
+    error() << "Couldn't initialize the Gaussian random number generator" << endmsg;
+    return StatusCode::FAILURE;
+  }
   return StatusCode::SUCCESS;
 }
 
@@ -46,9 +52,25 @@ StatusCode SimG4ParticleSmearRootFile::finalize() { return GaudiTool::finalize()
 StatusCode SimG4ParticleSmearRootFile::smearMomentum(CLHEP::Hep3Vector& aMom, int /*aPdg*/) {
   double res = resolution(aMom.pseudoRapidity(), aMom.mag() / CLHEP::GeV);
   if (res > 0) {
-    m_randSvc->generator(Rndm::Gauss(1, res), m_gauss).ignore();
-    double tmp = m_gauss->shoot();
-    aMom *= tmp;
+    aMom *= 1 + res * m_gauss.shoot();
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4ParticleSmearRootFile::smearMomenta(CLHEP::Hep3Vector* aMom, const int* aPdg, size_t aSize) {
+  if (m_gauss.shootArray(m_gaussNumbers, aSize).isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  return smearMomenta(aMom, aPdg, aSize, m_gaussNumbers.data());
+}
+
+StatusCode SimG4ParticleSmearRootFile::smearMomenta(CLHEP::Hep3Vector* aMom, const int* /*aPdg*/, size_t aSize,
+                                                    const double* aGauss) const {
+  for (size_t i = 0; i < aSize; ++i) {
+    const double res = resolution(aMom[i].pseudoRapidity(), aMom[i].mag() / CLHEP::GeV);
+    if (res > 0) {
+      aMom[i] *= 1 + res * aGauss[i];
+    }
   }
   return StatusCode::SUCCESS;
 }
@@ -103,9 +125,21 @@ StatusCode SimG4ParticleSmearRootFile::readResolutions() {
   }
   TArrayD* readRes = nullptr;
   resolutionTree->SetBranchAddress("resolution", &readRes);
+  m_etaEdges.assign(readEta->GetArray(), readEta->GetArray() + binsEta);
+  m_momenta.assign(readP->GetArray(), readP->GetArray() + binsP);
+  if (!std::is_sorted(m_etaEdges.begin(), m_etaEdges.end()) || !std::is_sorted(m_momenta.begin(), m_momenta.end())) {
+    error() << "Resolution file " << m_resolutionFileName << " does not contain increasing eta and p values" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_resolutions.resize(binsEta * binsP);
   for (int itEta = 0; itEta < binsEta; itEta++) {
     resolutionTree->GetEntry(itEta);
-    m_momentumResolutions[readEta->At(itEta)] = TGraph(binsP, readP->GetArray(), readRes->GetArray());
+    if (readRes->GetSize() < binsP) {
+      error() << "Resolution file " << m_resolutionFileName << " does not contain a resolution for each momentum"
+              << endmsg;
+      return StatusCode::FAILURE;
+    }
+    std::copy(readRes->GetArray(), readRes->GetArray() + binsP, m_resolutions.begin() + itEta * binsP);
     if (msgLevel(MSG::DEBUG)) {
       debug() << "resolutions for eta (" << (itEta == 0 ? 0 : readEta->At(itEta - 1)) << ", " << readEta->At(itEta)
               << "): \n";
@@ -119,15 +153,21 @@ StatusCode SimG4ParticleSmearRootFile::readResolutions() {
   return StatusCode::SUCCESS;
 }
 
-double SimG4ParticleSmearRootFile::resolution(double aEta, double aMom) {
+double SimG4ParticleSmearRootFile::resolution(double aEta, double aMom) const {
   // smear particles only in the pseudorapidity region where resolutions are defined
   if (fabs(aEta) > m_maxEta) return 0;
-  for (auto& m : m_momentumResolutions) {
-    if (fabs(aEta) < m.first) {
-      return m.second.Eval(aMom);
-    }
-  }
-  return 0;
+  // first bin with the upper end above eta
+  auto etaBin = std::upper_bound(m_etaEdges.begin(), m_etaEdges.end(), fabs(aEta));
+  if (etaBin == m_etaEdges.end()) return 0;
+  const double* res = &m_resolutions[(etaBin - m_etaEdges.begin()) * m_momenta.size()];
+  if (m_momenta.size() == 1) return res[0];
+  // linear interpolation between the closest momenta (extrapolation from the first or last two outside of the range)
+  size_t iP = std::upper_bound(m_momenta.begin(), m_momenta.end(), aMom) - m_momenta.begin();
+  iP = std::min(std::max<size_t>(iP, 1), m_momenta.size() - 1);
+  const double p0 = m_momenta[iP - 1];
+  const double p1 = m_momenta[iP];
+  if (p1 == p0) return res[iP - 1];
+  return res[iP - 1] + (aMom - p0) * (res[iP] - res[iP - 1]) / (p1 - p0);
 }
 
 StatusCode SimG4ParticleSmearRootFile::checkConditions(double aMinMomentum, double aMaxMomentum, double aMaxEta) const {
@@ -5,10 +5,9 @@
 #include "GaudiAlg/GaudiTool.h"
 #include "GaudiKernel/RndmGenerators.h"
 class IRndmGenSvc;
-class IRndmGen;
 
-// ROOT
-#include "TGraph.h"
+// STL
+#include <vector>
 
 // FCCSW
 #include "SimG4Interface/ISimG4ParticleSmearTool.h"
@@ -20,8 +19,10 @@ class IRndmGen;
  *  Root file contains trees 'info' and 'resolutions'.
  *  'info' has two arrays of type TArrayD containing edges of eta bins ('eta') and momentum values ('p').
  *  'resolutions' tree has TArrayD with resolutions computed for momentum values. An array is defined for every eta bin.
+ *  The resolutions are kept in a table of eta bins and momentum values, in which the eta bin is found by a binary search
+ *  and the resolution is interpolated linearly in momentum.
  *  Momentum of the particle is smeared following a Gaussian distribution,
- *  using the evaluated resolution as the mean.
+ *  using the evaluated resolution as the standard deviation (of a unit Gaussian generator, scaled for each particle).
  *  User needs to specify the min/max momentum nad max eta for fast sim in the `SimG4FastSimTrackerRegion` tool.
  *  The defined values cannot be broader than eta and p values for which the resolutions were computed.
  *
@@ -47,16 +48,36 @@ public:
    *   @return status code
    */
   virtual StatusCode smearMomentum(CLHEP::Hep3Vector& aMom, int aPdg = 0) final;
+
+  /**  Smear the momenta of several particles, with the Gaussian random numbers drawn in one block
+   *   @param aMom Particle momenta to be smeared.
+   *   @param[in] aPdg PDG codes of the particles (nullptr: all 0).
+   *   @param[in] aSize Number of particles.
+   *   @return status code
+   */
+  virtual StatusCode smearMomenta(CLHEP::Hep3Vector* aMom, const int* aPdg, size_t aSize) final;
+
+  /**  Smear the momenta of several particles with the given unit Gaussian random numbers (thread-safe)
+   *   @param aMom Particle momenta to be smeared.
+   *   @param[in] aPdg PDG codes of the particles (nullptr: all 0).
+   *   @param[in] aSize Number of particles.
+   *   @param[in] aGauss Random numbers from the unit Gaussian distribution, one per particle.
+   *   @return status code
+   */
+  virtual StatusCode smearMomenta(CLHEP::Hep3Vector* aMom, const int* aPdg, size_t aSize,
+                                  const double* aGauss) const final;
+  /// The momenta may be smeared concurrently with the given random numbers
+  inline virtual bool supportsConcurrentSmearing() const final { return true; }
   /**  Read the file with the resolutions. File name is set by job options.
    *   @return status code
    */
   StatusCode readResolutions();
-  /**  Read the file with the resolutions. File name is set by job options.
+  /**  Get the resolution for the particle.
    *   @param[in] aEta Particle's pseudorapidity
    *   @param[in] aMom Particle's momentum
    *   @return Resolution
    */
-  double resolution(double aEta, double aMom);
+  double resolution(double aEta, double aMom) const;
 
   /**  Check conditions of the smearing model, especially if the given parametrs do not exceed the parameters of the
    * model.
@@ -70,11 +91,16 @@ public:
 private:
   /// Random Number Service
   SmartIF<IRndmGenSvc> m_randSvc;
-  /// Gaussian random number generator used for smearing with a constant resolution (m_sigma)
-  IRndmGen* m_gauss;
-  /// Map of p-dependent resolutions and the end of eta bin that it refers to
-  /// (lower end is defined by previous entry, and eta=0 for the first one)
-  std::map<double, TGraph> m_momentumResolutions;
+  /// Unit Gaussian random number generator, scaled by the resolution
+  Rndm::Numbers m_gauss;
+  /// Random numbers of the particles smeared together (reused between calls)
+  std::vector<double> m_gaussNumbers;
+  /// Upper ends of the eta bins (lower end is defined by previous entry, and eta=0 for the first one)
+  std::vector<double> m_etaEdges;
+  /// Momentum values for which the resolutions are defined
+  std::vector<double> m_momenta;
+  /// Resolutions for each eta bin (row) and momentum value (column)
+  std::vector<double> m_resolutions;
   /// File name with the resolutions obtained from root file (set by job options)
   Gaudi::Property<std::string> m_resolutionFileName{this, "filename", "",
                                                     "File name with the resolutions obtained from root file"};
@@ -37,3 +37,21 @@ StatusCode SimG4ParticleSmearSimple::smearMomentum(CLHEP::Hep3Vector& aMom, int
   aMom *= tmp;
   return StatusCode::SUCCESS;
 }
+
+StatusCode SimG4ParticleSmearSimple::smearMomenta(CLHEP::Hep3Vector* aMom, const int* /*aPdg*/, size_t aSize) {
+  if (m_gauss.shootArray(m_gaussNumbers, aSize).isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  for (size_t i = 0; i < aSize; ++i) {
+    aMom[i] *= m_gaussNumbers[i];
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4ParticleSmearSimple::smearMomenta(CLHEP::Hep3Vector* aMom, const int* /*aPdg*/, size_t aSize,
+                                                  const double* aGauss) const {
+  for (size_t i = 0; i < aSize; ++i) {
+    aMom[i] *= 1 + m_sigma * aGauss[i];
+  }
+  return StatusCode::SUCCESS;
+}
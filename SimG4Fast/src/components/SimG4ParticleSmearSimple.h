@@ -4,6 +4,9 @@
 // Gaudi
 #include "GaudiAlg/GaudiTool.h"
 #include "GaudiKernel/RndmGenerators.h"
+
+// STL
+#include <vector>
 class IRndmGenSvc;
 
 // FCCSW
@@ -40,6 +43,26 @@ public:
    */
   virtual StatusCode smearMomentum(CLHEP::Hep3Vector& aMom, int aPdg = 0) final;
 
+  /**  Smear the momenta of several particles, with the Gaussian random numbers drawn in one block
+   *   @param aMom Particle momenta to be smeared.
+   *   @param[in] aPdg PDG codes of the particles (nullptr: all 0).
+   *   @param[in] aSize Number of particles.
+   *   @return status code
+   */
+  virtual StatusCode smearMomenta(CLHEP::Hep3Vector* aMom, const int* aPdg, size_t aSize) final;
+
+  /**  Smear the momenta of several particles with the given unit Gaussian random numbers (thread-safe)
+   *   @param aMom Particle momenta to be smeared.
+   *   @param[in] aPdg PDG codes of the particles (nullptr: all 0).
+   *   @param[in] aSize Number of particles.
+   *   @param[in] aGauss Random numbers from the unit Gaussian distribution, one per particle.
+   *   @return status code
+   */
+  virtual StatusCode smearMomenta(CLHEP::Hep3Vector* aMom, const int* aPdg, size_t aSize,
+                                  const double* aGauss) const final;
+  /// The momenta may be smeared concurrently with the given random numbers
+  inline virtual bool supportsConcurrentSmearing() const final { return true; }
+
   /**  Check conditions of the smearing model, especially if the given parametrs do not exceed the parameters of the
    * model.
    *   @param[in] aMinMomentum Minimum momentum.
@@ -54,6 +77,8 @@ private:
   IRndmGenSvc* m_randSvc;
   /// Gaussian random number generator used for smearing with a constant resolution (m_sigma)
   Rndm::Numbers m_gauss;
+  /// Random numbers of the particles smeared together (reused between calls)
+  std::vector<double> m_gaussNumbers;
   /// Constant resolution for the smearing (set by job options)
   Gaudi::Property<double> m_sigma{this, "sigma", 0.01, "Constant resolution for the smearing"};
 };
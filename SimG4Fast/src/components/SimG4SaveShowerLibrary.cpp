@@ -0,0 +1,112 @@
+#include "SimG4SaveShowerLibrary.h"
+
+// FCCSW
+#include "SimG4Common/Geant4CaloHit.h"
+#include "SimG4Common/HitBuffer.h"
+
+// Geant4
+#include "G4Event.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4THitsCollection.hh"
+
+// STL
+#include <algorithm>
+#include <functional>
+
+DECLARE_COMPONENT(SimG4SaveShowerLibrary)
+
+SimG4SaveShowerLibrary::SimG4SaveShowerLibrary(const std::string& aType, const std::string& aName,
+                                               const IInterface* aParent)
+    : GaudiTool(aType, aName, aParent) {
+  declareInterface<ISimG4SaveOutputTool>(this);
+}
+
+SimG4SaveShowerLibrary::~SimG4SaveShowerLibrary() {}
+
+StatusCode SimG4SaveShowerLibrary::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_readoutNames.empty() || m_libraryFile.value().empty()) {
+    error() << "Readouts and the name of the library file need to be specified" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  for (const auto* edges : {&m_energyEdges, &m_etaEdges, &m_positionEdges}) {
+    const auto& values = edges->value();
+    if (values.size() < 2 ||
+        std::adjacent_find(values.begin(), values.end(), std::greater_equal<double>()) != values.end()) {
+      error() << "Bin edges of " << edges->name() << " need to be increasing (and at least two)" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  m_records.clear();
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4SaveShowerLibrary::finalize() {
+  std::string reason;
+  if (!sim::ShowerLibrary::write(m_libraryFile, m_energyEdges, m_etaEdges, m_positionEdges, m_records, reason)) {
+    error() << "Shower library cannot be written: " << reason << endmsg;
+    return StatusCode::FAILURE;
+  }
+  info() << m_records.size() << " showers recorded in the library " << m_libraryFile.value() << endmsg;
+  m_records.clear();
+  return GaudiTool::finalize();
+}
+
+StatusCode SimG4SaveShowerLibrary::saveOutput(const G4Event& aEvent) {
+  G4HCofThisEvent* collections = aEvent.GetHCofThisEvent();
+  const G4PrimaryVertex* vertex = aEvent.GetPrimaryVertex(0);
+  if (collections == nullptr || vertex == nullptr || vertex->GetPrimary(0) == nullptr) {
+    return StatusCode::SUCCESS;
+  }
+  const G4PrimaryParticle& particle = *vertex->GetPrimary(0);
+  const G4ThreeVector position = vertex->GetPosition();
+  const G4ThreeVector direction = particle.GetMomentumDirection();
+  // frame of the shower, the same as in the replay by sim::FastSimModelShowerLibrary (before the random rotation)
+  const G4ThreeVector uAxis = direction.orthogonal().unit();
+  const G4ThreeVector vAxis = direction.cross(uAxis);
+  sim::ShowerLibrary::Record record;
+  record.energy = particle.GetKineticEnergy();
+  record.eta = direction.eta();
+  record.position = position.perp();
+  if (!(record.energy > 0)) {
+    return StatusCode::SUCCESS;
+  }
+  const double minEnergy = m_minFraction * record.energy;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto addSpot = [&](double aEnergy, const G4ThreeVector& aPosition) {
+    if (aEnergy <= minEnergy) return;
+    const G4ThreeVector offset = aPosition - position;
+    record.spots.push_back({static_cast<float>(aEnergy / record.energy), static_cast<float>(offset.dot(uAxis)),
+                            static_cast<float>(offset.dot(vAxis)), static_cast<float>(offset.dot(direction))});
+  };
+  for (int iter_coll : m_collectionIDs.get(*collections, m_readoutNames)) {
+    G4VHitsCollection* collect = collections->GetHC(iter_coll);
+    // deposits written directly by the buffered sensitive detectors (with their positions)
+    if (auto buffer = dynamic_cast<const sim::HitBuffer*>(collect)) {
+      if (!buffer->hasPositions()) {
+        warning() << "Buffer " << buffer->GetName() << " does not store the positions of the deposits" << endmsg;
+        continue;
+      }
+      for (size_t iter_hit = 0; iter_hit < buffer->size(); iter_hit++) {
+        addSpot(buffer->energy[iter_hit], G4ThreeVector(buffer->x[iter_hit], buffer->y[iter_hit], buffer->z[iter_hit]));
+      }
+      continue;
+    }
+    auto hits = dynamic_cast<G4THitsCollection<k4::Geant4CaloHit>*>(collect);
+    if (hits == nullptr) {
+      warning() << "Collection " << collect->GetName() << " does not contain calorimeter hits" << endmsg;
+      continue;
+    }
+    size_t n_hit = hits->GetSize();
+    for (size_t iter_hit = 0; iter_hit < n_hit; iter_hit++) {
+      const k4::Geant4CaloHit* hit = (*hits)[iter_hit];
+      addSpot(hit->energyDeposit, hit->position);
+    }
+  }
+  debug() << "Shower of " << record.energy << " MeV recorded with " << record.spots.size() << " spots" << endmsg;
+  m_records.push_back(std::move(record));
+  return StatusCode::SUCCESS;
+}
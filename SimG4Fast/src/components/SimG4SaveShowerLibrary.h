@@ -0,0 +1,73 @@
+#ifndef SIMG4FAST_G4SAVESHOWERLIBRARY_H
+#define SIMG4FAST_G4SAVESHOWERLIBRARY_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "SimG4Common/HitsCollectionIDs.h"
+#include "SimG4Fast/ShowerLibrary.h"
+#include "SimG4Interface/ISimG4SaveOutputTool.h"
+
+// STL
+#include <mutex>
+#include <vector>
+
+/** @class SimG4SaveShowerLibrary SimG4Fast/src/components/SimG4SaveShowerLibrary.h SimG4SaveShowerLibrary.h
+ *
+ *  Tool recording the showers of the full simulation into a library of frozen showers (sim::ShowerLibrary), to be
+ *  replayed by SimG4FastSimShowerLibraryRegion.
+ *  Each event is meant to hold a single particle generated at the entrance of the calorimeter: the energy, direction
+ *  and position of the first primary particle give the bin of the shower and its frame, and the hits of the
+ *  collections \b'readoutNames' are stored as spots relative to it.
+ *  The bins are given by \b'energyEdges', \b'etaEdges' (absolute value of pseudorapidity) and \b'positionEdges'
+ *  (distance from the z axis); the library is written to \b'library' at finalize.
+ *  [For more information please see](@ref md_sim_doc_geant4fastsim).
+ */
+
+class SimG4SaveShowerLibrary : public GaudiTool, virtual public ISimG4SaveOutputTool {
+public:
+  explicit SimG4SaveShowerLibrary(const std::string& aType, const std::string& aName, const IInterface* aParent);
+  virtual ~SimG4SaveShowerLibrary();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize();
+  /**  Finalize.
+   *   Write the library.
+   *   @return status code
+   */
+  virtual StatusCode finalize();
+  /**  Save the data output.
+   *   Records the hits of the event as a shower of the library.
+   *   @param[in] aEvent Event with data to save.
+   *   @return status code
+   */
+  virtual StatusCode saveOutput(const G4Event& aEvent) final;
+
+private:
+  /// Names of the readouts (hits collections) of the calorimeter
+  Gaudi::Property<std::vector<std::string>> m_readoutNames{
+      this, "readoutNames", {}, "Names of the readouts (hits collections) of the calorimeter"};
+  /// Name of the library file
+  Gaudi::Property<std::string> m_libraryFile{this, "library", "", "Name of the file of the shower library"};
+  /// Edges of the energy bins
+  Gaudi::Property<std::vector<double>> m_energyEdges{this, "energyEdges", {}, "Edges of the energy bins"};
+  /// Edges of the bins of the absolute value of pseudorapidity
+  Gaudi::Property<std::vector<double>> m_etaEdges{
+      this, "etaEdges", {0, 10}, "Edges of the bins of the absolute value of pseudorapidity"};
+  /// Edges of the bins of the distance from the z axis
+  Gaudi::Property<std::vector<double>> m_positionEdges{
+      this, "positionEdges", {0, 1e6}, "Edges of the bins of the distance of the particle from the z axis"};
+  /// Minimum energy of a spot, as fraction of the particle energy (smaller hits are dropped)
+  Gaudi::Property<double> m_minFraction{this, "minFraction", 0,
+                                        "Minimum energy of a spot, as fraction of the particle energy"};
+  /// Indices of the collections in the events
+  sim::HitsCollectionIDs m_collectionIDs;
+  /// Recorded showers
+  std::vector<sim::ShowerLibrary::Record> m_records;
+  /// Events may be saved by several threads
+  std::mutex m_mutex;
+};
+
+#endif /* SIMG4FAST_G4SAVESHOWERLIBRARY_H */
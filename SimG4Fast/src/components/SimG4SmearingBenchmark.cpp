@@ -0,0 +1,161 @@
+#include "SimG4SmearingBenchmark.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4ParticleSmearTool.h"
+
+// CLHEP
+#include "CLHEP/Units/SystemOfUnits.h"
+
+// STL
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+DECLARE_COMPONENT(SimG4SmearingBenchmark)
+
+SimG4SmearingBenchmark::SimG4SmearingBenchmark(const std::string& aName, ISvcLocator* aSvcLoc)
+    : GaudiAlgorithm(aName, aSvcLoc) {}
+
+StatusCode SimG4SmearingBenchmark::initialize() {
+  if (GaudiAlgorithm::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_toolNames.value().empty()) {
+    error() << "No smearing tools to measure" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_etaMax < m_etaMin || m_momentumMin <= 0 || m_momentumMax < m_momentumMin) {
+    error() << "Range of the pseudorapidity needs to be non-empty and that of the momentum positive" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  for (auto& toolname : m_toolNames) {
+    m_tools.push_back(tool<ISimG4ParticleSmearTool>(toolname));
+    if (m_tools.back() == nullptr) {
+      error() << "Unable to retrieve the smearing tool " << toolname << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  m_times.assign(m_tools.size(), 0);
+  if (m_flat.initialize(randSvc(), Rndm::Flat(0, 1)).isFailure()) {
+    error() << "Couldn't initialize the random number generator" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  // uniform in eta and phi, and in the logarithm of the momentum (the spectra fall steeply)
+  const double logMin = std::log(m_momentumMin);
+  const double logRange = std::log(m_momentumMax) - logMin;
+  m_momenta.resize(m_numParticles);
+  for (auto& momentum : m_momenta) {
+    const double eta = m_etaMin + m_flat() * (m_etaMax - m_etaMin);
+    momentum.setRThetaPhi(std::exp(logMin + m_flat() * logRange) * CLHEP::GeV, 2 * std::atan(std::exp(-eta)),
+                          m_flat() * CLHEP::twopi);
+  }
+  m_pdgs.assign(m_numParticles, m_pdg);
+  // accuracy against the reference tools
+  for (const auto& reference : m_references.value()) {
+    auto toolIndex = std::find(m_toolNames.value().begin(), m_toolNames.value().end(), reference.first);
+    auto referenceIndex = std::find(m_toolNames.value().begin(), m_toolNames.value().end(), reference.second);
+    if (toolIndex == m_toolNames.value().end() || referenceIndex == m_toolNames.value().end()) {
+      error() << "Tool " << reference.first << " and its reference " << reference.second
+              << " need to be in the smearing tools" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    std::vector<double> toolResolutions, referenceResolutions;
+    if (resolutions(*m_tools[toolIndex - m_toolNames.value().begin()], toolResolutions).isFailure() ||
+        resolutions(*m_tools[referenceIndex - m_toolNames.value().begin()], referenceResolutions).isFailure()) {
+      error() << "Tool " << reference.first << " or its reference " << reference.second
+              << " does not smear with given random numbers, its accuracy cannot be measured" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    Accuracy accuracy{reference.second, 0, 0};
+    for (size_t i = 0; i < toolResolutions.size(); ++i) {
+      const double difference = std::abs(toolResolutions[i] - referenceResolutions[i]);
+      accuracy.maxDifference = std::max(accuracy.maxDifference, difference);
+      accuracy.rmsDifference += difference * difference;
+    }
+    accuracy.rmsDifference = std::sqrt(accuracy.rmsDifference / std::max<size_t>(toolResolutions.size(), 1));
+    m_accuracies[reference.first] = accuracy;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4SmearingBenchmark::resolutions(const ISimG4ParticleSmearTool& aTool,
+                                               std::vector<double>& aResolutions) const {
+  std::vector<CLHEP::Hep3Vector> smeared(m_momenta);
+  const std::vector<double> ones(smeared.size(), 1);
+  if (aTool.smearMomenta(smeared.data(), m_pdgs.data(), smeared.size(), ones.data()).isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  aResolutions.resize(smeared.size());
+  for (size_t i = 0; i < smeared.size(); ++i) {
+    aResolutions[i] = smeared[i].mag() / m_momenta[i].mag() - 1;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4SmearingBenchmark::execute() {
+  for (size_t iTool = 0; iTool < m_tools.size(); ++iTool) {
+    m_smeared = m_momenta;
+    const auto start = std::chrono::steady_clock::now();
+    if (m_batch) {
+      if (m_tools[iTool]->smearMomenta(m_smeared.data(), m_pdgs.data(), m_smeared.size()).isFailure()) {
+        error() << "Smearing failed in " << m_toolNames.value()[iTool] << endmsg;
+        return StatusCode::FAILURE;
+      }
+    } else {
+      for (auto& momentum : m_smeared) {
+        if (m_tools[iTool]->smearMomentum(momentum, m_pdg).isFailure()) {
+          error() << "Smearing failed in " << m_toolNames.value()[iTool] << endmsg;
+          return StatusCode::FAILURE;
+        }
+      }
+    }
+    m_times[iTool] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+  m_numSmeared += m_momenta.size();
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4SmearingBenchmark::writeJson() const {
+  std::ofstream out(m_filename.value());
+  if (!out.good()) {
+    error() << "Unable to open the output file " << m_filename.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  out << std::setprecision(9) << "{";
+  for (size_t iTool = 0; iTool < m_tools.size(); ++iTool) {
+    const std::string& name = m_toolNames.value()[iTool];
+    out << (iTool == 0 ? "" : ",") << "\n  \"" << name << "\": {\"smears\": " << m_numSmeared
+        << ", \"seconds\": " << m_times[iTool]
+        << ", \"smears_per_second\": " << (m_times[iTool] > 0 ? m_numSmeared / m_times[iTool] : 0);
+    auto accuracy = m_accuracies.find(name);
+    if (accuracy != m_accuracies.end()) {
+      out << ", \"reference\": \"" << accuracy->second.reference
+          << "\", \"max_resolution_difference\": " << accuracy->second.maxDifference
+          << ", \"rms_resolution_difference\": " << accuracy->second.rmsDifference;
+    }
+    out << "}";
+  }
+  out << "\n}\n";
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4SmearingBenchmark::finalize() {
+  info() << "Smearing throughput for " << m_numSmeared << " particles" << (m_batch ? " (in batches)" : "") << endmsg;
+  for (size_t iTool = 0; iTool < m_tools.size(); ++iTool) {
+    const std::string& name = m_toolNames.value()[iTool];
+    info() << std::setw(40) << std::left << name << std::setw(14) << std::right
+           << (m_times[iTool] > 0 ? m_numSmeared / m_times[iTool] : 0) << " smears/s" << endmsg;
+    auto accuracy = m_accuracies.find(name);
+    if (accuracy != m_accuracies.end()) {
+      info() << std::setw(40) << std::left << "" << " resolution vs " << accuracy->second.reference
+             << ": max difference " << accuracy->second.maxDifference << ", RMS " << accuracy->second.rmsDifference
+             << endmsg;
+    }
+  }
+  if (!m_filename.value().empty() && writeJson().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  return GaudiAlgorithm::finalize();
+}
@@ -0,0 +1,103 @@
+#ifndef SIMG4FAST_G4SMEARINGBENCHMARK_H
+#define SIMG4FAST_G4SMEARINGBENCHMARK_H
+
+// Gaudi
+#include "GaudiAlg/GaudiAlgorithm.h"
+#include "GaudiKernel/RndmGenerators.h"
+
+// CLHEP
+#include "CLHEP/Vector/ThreeVector.h"
+
+// STL
+#include <map>
+#include <string>
+#include <vector>
+
+class ISimG4ParticleSmearTool;
+
+/** @class SimG4SmearingBenchmark SimG4Fast/src/components/SimG4SmearingBenchmark.h SimG4SmearingBenchmark.h
+ *
+ *  Measures the throughput of the particle smearing tools (\b'smearTools'), to choose the smearing of the production
+ *  on data. At initialization \b'numParticles' momenta are drawn, uniform in pseudorapidity between \b'etaMin' and
+ *  \b'etaMax' and in azimuth, and uniform in the logarithm of the momentum between \b'momentumMin' and
+ *  \b'momentumMax' (GeV). In each event all the tools smear a copy of these momenta in one call of smearMomenta (one
+ *  call of smearMomentum per particle if \b'batch' is false), and the time spent is summed per tool.
+ *  The accuracy of the tools that approximate another one (e.g. SimG4ParticleSmearFormula with a tabulated formula,
+ *  against the same formula not tabulated) is measured on the same momenta, for the pairs of tool and reference tool
+ *  given in \b'references': the resolutions are obtained by smearing with a unit Gaussian number of 1, and the
+ *  maximum and RMS of their absolute difference are reported.
+ *  The smears per second (and the accuracy) are printed at finalize and written to the JSON file \b'filename', if set.
+ *  [For more information please see](@ref md_sim_doc_geant4fastsim).
+ */
+
+class SimG4SmearingBenchmark : public GaudiAlgorithm {
+public:
+  SimG4SmearingBenchmark(const std::string& aName, ISvcLocator* aSvcLoc);
+  /**  Initialize. Retrieves the tools, draws the momenta and compares the resolutions of the tools.
+   *   @return status code
+   */
+  StatusCode initialize();
+  /**  Smear the momenta with each tool.
+   *   @return status code
+   */
+  StatusCode execute();
+  /**  Finalize. Reports the throughput and the accuracy of the tools.
+   *   @return status code
+   */
+  StatusCode finalize();
+
+private:
+  /// Accuracy of a tool compared to its reference
+  struct Accuracy {
+    std::string reference;
+    double maxDifference;
+    double rmsDifference;
+  };
+  /** Resolutions of a tool for the momenta of the sample, smearing with a unit Gaussian number of 1.
+   *  @param[in] aTool smearing tool
+   *  @param[out] aResolutions resolutions of the momenta
+   *  @return status code (failure if the tool does not smear with given random numbers)
+   */
+  StatusCode resolutions(const ISimG4ParticleSmearTool& aTool, std::vector<double>& aResolutions) const;
+  /** Write the report to the JSON file.
+   *  @return status code
+   */
+  StatusCode writeJson() const;
+  /// Names of the smearing tools
+  Gaudi::Property<std::vector<std::string>> m_toolNames{this, "smearTools", {}, "Names of the smearing tools"};
+  /// Reference tools of the tools whose accuracy is measured
+  Gaudi::Property<std::map<std::string, std::string>> m_references{
+      this, "references", {}, "Reference tool of each tool whose accuracy is measured"};
+  /// Number of particles smeared per event by each tool
+  Gaudi::Property<unsigned int> m_numParticles{this, "numParticles", 10000, "Number of particles smeared per event"};
+  /// Range of the pseudorapidity of the particles
+  Gaudi::Property<double> m_etaMin{this, "etaMin", -2.5, "Minimum pseudorapidity of the particles"};
+  Gaudi::Property<double> m_etaMax{this, "etaMax", 2.5, "Maximum pseudorapidity of the particles"};
+  /// Range of the momentum of the particles
+  Gaudi::Property<double> m_momentumMin{this, "momentumMin", 1, "Minimum momentum of the particles [GeV]"};
+  Gaudi::Property<double> m_momentumMax{this, "momentumMax", 1000, "Maximum momentum of the particles [GeV]"};
+  /// PDG code of the particles
+  Gaudi::Property<int> m_pdg{this, "pdg", 13, "PDG code of the particles"};
+  /// Flag whether the particles are smeared in one call
+  Gaudi::Property<bool> m_batch{this, "batch", true, "Smear the particles of the event in one call of smearMomenta"};
+  /// Name of the JSON file of the report (empty: not written)
+  Gaudi::Property<std::string> m_filename{this, "filename", "", "Name of the JSON file of the report"};
+  /// Smearing tools
+  std::vector<ISimG4ParticleSmearTool*> m_tools;
+  /// Momenta of the particles
+  std::vector<CLHEP::Hep3Vector> m_momenta;
+  /// PDG codes of the particles
+  std::vector<int> m_pdgs;
+  /// Momenta smeared by the current tool (reused between the tools)
+  std::vector<CLHEP::Hep3Vector> m_smeared;
+  /// Time spent by each tool [s]
+  std::vector<double> m_times;
+  /// Number of particles smeared by each tool
+  unsigned long m_numSmeared = 0;
+  /// Accuracy of the tools with a reference
+  std::map<std::string, Accuracy> m_accuracies;
+  /// Uniform distribution
+  Rndm::Numbers m_flat;
+};
+
+#endif /* SIMG4FAST_G4SMEARINGBENCHMARK_H */
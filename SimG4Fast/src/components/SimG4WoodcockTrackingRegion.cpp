@@ -0,0 +1,106 @@
+#include "SimG4WoodcockTrackingRegion.h"
+
+// FCCSW
+#include "SimG4Fast/FastSimModelWoodcock.h"
+
+// Geant4
+#include "G4EmParameters.hh"
+#include "G4Gamma.hh"
+#include "G4ProcessManager.hh"
+#include "G4RegionStore.hh"
+#include "G4TransportationManager.hh"
+#include "G4VFastSimulationModel.hh"
+#include "G4Version.hh"
+
+DECLARE_COMPONENT(SimG4WoodcockTrackingRegion)
+
+SimG4WoodcockTrackingRegion::SimG4WoodcockTrackingRegion(const std::string& type, const std::string& name,
+                                                         const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareInterface<ISimG4RegionTool>(this);
+}
+
+SimG4WoodcockTrackingRegion::~SimG4WoodcockTrackingRegion() {}
+
+StatusCode SimG4WoodcockTrackingRegion::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_volumeNames.size() == 0) {
+    error() << "No detector name is specified for the Woodcock tracking" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_minTriggerEnergy > m_maxTriggerEnergy) {
+    error() << "Energy range is not defined properly" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4WoodcockTrackingRegion::finalize() {
+  m_workerModels.clear();
+  m_model.reset();
+  return GaudiTool::finalize();
+}
+
+StatusCode SimG4WoodcockTrackingRegion::create() {
+  G4LogicalVolume* world =
+      (*G4TransportationManager::GetTransportationManager()->GetWorldsIterator())->GetLogicalVolume();
+  const G4Region* defaultRegion = G4RegionStore::GetInstance()->GetRegion("DefaultRegionForTheWorld", false);
+  for (const auto& calorimeterName : m_volumeNames) {
+    for (int iter_region = 0; iter_region < world->GetNoDaughters(); ++iter_region) {
+      G4LogicalVolume* volume = world->GetDaughter(iter_region)->GetLogicalVolume();
+      if (world->GetDaughter(iter_region)->GetName().find(calorimeterName) == std::string::npos) continue;
+      if (volume->GetRegion() != nullptr && volume->GetRegion() != defaultRegion &&
+          volume->GetRegion() != m_g4region) {
+        error() << "Volume " << volume->GetName() << " already belongs to the region "
+                << volume->GetRegion()->GetName() << endmsg;
+        return StatusCode::FAILURE;
+      }
+      /// all G4Region objects are deleted by the G4RegionStore
+      if (m_g4region == nullptr) m_g4region = new G4Region(m_regionName.value());
+      m_g4region->AddRootLogicalVolume(volume);
+      info() << "Adding the volume " << volume->GetName() << " to the Woodcock tracking region " << m_regionName.value()
+             << endmsg;
+    }
+  }
+  if (m_g4region == nullptr) {
+    warning() << "No volume matches the names of the Woodcock tracking envelopes" << endmsg;
+    return StatusCode::SUCCESS;
+  }
+#if G4VERSION_NUMBER >= 1120
+  // Woodcock tracking of the gamma general process
+  if (m_native && G4EmParameters::Instance()->GeneralProcessActive()) {
+    G4EmParameters::Instance()->SetWoodcockActiveRegion(m_regionName.value());
+    info() << "Using the Woodcock tracking of Geant4 in the region " << m_regionName.value() << endmsg;
+    return StatusCode::SUCCESS;
+  }
+#endif
+  if (m_native) {
+    info() << "Woodcock tracking of Geant4 is not available (in this version or without the gamma general process), "
+           << "using the fast simulation model" << endmsg;
+  }
+  // the model is invoked by the fast simulation process, which needs to be in the physics list
+  G4ProcessVector* processes = G4Gamma::GammaDefinition()->GetProcessManager()->GetProcessList();
+  bool fastSimulation = false;
+  for (size_t iProcess = 0; iProcess < processes->size(); ++iProcess) {
+    fastSimulation |= (*processes)[iProcess]->GetProcessType() == fParameterisation;
+  }
+  if (!fastSimulation) {
+    error() << "Woodcock tracking model needs the fast simulation physics (SimG4FastSimPhysicsList)" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_model.reset(new sim::FastSimModelWoodcock(m_g4region->GetName(), m_g4region, m_minTriggerEnergy,
+                                              m_maxTriggerEnergy));
+  info() << "Attaching a Woodcock tracking model to the region " << m_g4region->GetName() << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4WoodcockTrackingRegion::createForWorker() {
+  // the fast simulation manager of the region is thread-local: the worker gets a model of its own
+  // (nothing is needed for the Woodcock tracking of Geant4, set in the shared EM parameters)
+  if (m_model == nullptr) return StatusCode::SUCCESS;
+  m_workerModels.emplace_back(new sim::FastSimModelWoodcock(m_g4region->GetName(), m_g4region, m_minTriggerEnergy,
+                                                            m_maxTriggerEnergy));
+  return StatusCode::SUCCESS;
+}
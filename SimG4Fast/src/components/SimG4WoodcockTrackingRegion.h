@@ -0,0 +1,71 @@
+#ifndef SIMG4FAST_SIMG4WOODCOCKTRACKINGREGION_H
+#define SIMG4FAST_SIMG4WOODCOCKTRACKINGREGION_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+#include "GaudiKernel/SystemOfUnits.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4RegionTool.h"
+
+// Geant
+class G4VFastSimulationModel;
+class G4Region;
+
+/** @class SimG4WoodcockTrackingRegion SimG4Fast/src/components/SimG4WoodcockTrackingRegion.h
+ * SimG4WoodcockTrackingRegion.h
+ *
+ *  Tool for creating a region with Woodcock (delta) tracking of photons, skipping the boundaries of the volumes of
+ *  finely segmented calorimeters.
+ *  One region (\b'regionName') is created for all the volumes specified in the job options (\b'volumeNames').
+ *  If Geant4 provides the Woodcock tracking (in the gamma general process, which needs to be switched on in the physics
+ *  list, e.g. with \b'gammaGeneralProcess' of SimG4FtfpBert) and \b'native' is set, it is used in the region.
+ *  Otherwise the model sim::FastSimModelWoodcock is attached to the region, which needs the fast simulation physics
+ *  (SimG4FastSimPhysicsList). In the multi-threaded mode the model is created again on each worker thread.
+ *  [For more information please see](@ref md_sim_doc_geant4fastsim).
+*/
+
+class SimG4WoodcockTrackingRegion : public GaudiTool, virtual public ISimG4RegionTool {
+public:
+  explicit SimG4WoodcockTrackingRegion(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SimG4WoodcockTrackingRegion();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /**  Create the region and set up the Woodcock tracking in it
+   *   @return status code
+   */
+  virtual StatusCode create() final;
+  /**  Create the Woodcock tracking model of the worker thread in the region of create()
+   *   @return status code
+   */
+  virtual StatusCode createForWorker() final;
+
+private:
+  /// Region of the envelopes, deleted by the G4RegionStore
+  G4Region* m_g4region = nullptr;
+  /// Woodcock tracking model, if not provided by Geant4
+  std::unique_ptr<G4VFastSimulationModel> m_model;
+  /// Woodcock tracking models of the worker threads
+  std::vector<std::unique_ptr<G4VFastSimulationModel>> m_workerModels;
+  /// Names of the envelopes (set by job options)
+  Gaudi::Property<std::vector<std::string>> m_volumeNames{
+      this, "volumeNames", {}, "Names of the envelopes with Woodcock tracking (set by job options)"};
+  /// Name of the region
+  Gaudi::Property<std::string> m_regionName{this, "regionName", "WoodcockTracking", "Name of the region"};
+  /// Flag whether the Woodcock tracking of Geant4 is used if available
+  Gaudi::Property<bool> m_native{this, "native", true, "Use the Woodcock tracking of Geant4 if available"};
+  /// minimum energy of the photon that triggers the model
+  Gaudi::Property<double> m_minTriggerEnergy{this, "minEnergy", 0,
+                                             "minimum energy of the photon that triggers the model"};
+  /// maximum energy of the photon that triggers the model
+  Gaudi::Property<double> m_maxTriggerEnergy{this, "maxEnergy", 10 * Gaudi::Units::TeV,
+                                             "maximum energy of the photon that triggers the model"};
+};
+
+#endif /* SIMG4FAST_SIMG4WOODCOCKTRACKINGREGION_H */
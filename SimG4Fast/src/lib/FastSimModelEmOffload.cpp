@@ -0,0 +1,103 @@
+#include "SimG4Fast/FastSimModelEmOffload.h"
+
+// Gaudi
+#include "GaudiKernel/SystemOfUnits.h"
+
+// Geant4
+#include "G4DynamicParticle.hh"
+#include "G4Electron.hh"
+#include "G4Event.hh"
+#include "G4EventManager.hh"
+#include "G4Gamma.hh"
+#include "G4Positron.hh"
+#include "G4Track.hh"
+
+namespace sim {
+
+FastSimModelEmOffload::FastSimModelEmOffload(const std::string& aModelName, G4Region* aEnvelope,
+                                             ToolHandle<ISimG4EmTransportTool>& aTransportTool, double aMinEnergy,
+                                             double aMaxEnergy, size_t aMaxBatchSize, const std::set<int>& aPdgCodes)
+    : G4VFastSimulationModel(aModelName, aEnvelope),
+      m_msgSvc("MessageSvc", "FastSimModelEmOffload"),
+      m_log(&(*m_msgSvc), "FastSimModelEmOffload"),
+      m_transportTool(aTransportTool),
+      m_minEnergy(aMinEnergy / Gaudi::Units::MeV),
+      m_maxEnergy(aMaxEnergy / Gaudi::Units::MeV),
+      m_maxBatchSize(aMaxBatchSize),
+      m_pdgCodes(aPdgCodes) {
+  if (m_pdgCodes.empty()) {
+    m_pdgCodes = {G4Electron::ElectronDefinition()->GetPDGEncoding(),
+                  G4Positron::PositronDefinition()->GetPDGEncoding(), G4Gamma::GammaDefinition()->GetPDGEncoding()};
+  }
+}
+
+FastSimModelEmOffload::~FastSimModelEmOffload() {}
+
+G4bool FastSimModelEmOffload::IsApplicable(const G4ParticleDefinition& aParticleType) {
+  return m_pdgCodes.count(aParticleType.GetPDGEncoding()) > 0;
+}
+
+G4bool FastSimModelEmOffload::ModelTrigger(const G4FastTrack& aFastTrack) {
+  const double energy = aFastTrack.GetPrimaryTrack()->GetKineticEnergy();
+  return energy >= m_minEnergy && energy <= m_maxEnergy;
+}
+
+void FastSimModelEmOffload::DoIt(const G4FastTrack& aFastTrack, G4FastStep& aFastStep) {
+  const G4Track* track = aFastTrack.GetPrimaryTrack();
+  // copy of the track, to which the deposits are attributed once the batch is transported
+  auto particle = new G4DynamicParticle(track->GetDefinition(), track->GetMomentumDirection(),
+                                        track->GetKineticEnergy());
+  std::unique_ptr<G4Track> pending(new G4Track(particle, track->GetGlobalTime(), track->GetPosition()));
+  pending->SetTrackID(track->GetTrackID());
+  pending->SetParentID(track->GetParentID());
+  m_pending.push_back(std::move(pending));
+  aFastStep.KillPrimaryTrack();
+  aFastStep.ProposePrimaryTrackPathLength(0);
+  aFastStep.ProposeTotalEnergyDeposited(track->GetKineticEnergy());
+  if (m_maxBatchSize > 0 && m_pending.size() >= m_maxBatchSize) {
+    transportBatch();
+  }
+}
+
+void FastSimModelEmOffload::Flush() { transportBatch(); }
+
+void FastSimModelEmOffload::transportBatch() {
+  if (m_pending.empty()) {
+    return;
+  }
+  m_tracks.clear();
+  for (const auto& pending : m_pending) {
+    const G4ThreeVector& position = pending->GetPosition();
+    const G4ThreeVector& direction = pending->GetMomentumDirection();
+    m_tracks.push_back({pending->GetDefinition()->GetPDGEncoding(), pending->GetKineticEnergy(), position.x(),
+                        position.y(), position.z(), direction.x(), direction.y(), direction.z(),
+                        pending->GetGlobalTime()});
+  }
+  m_deposits.clear();
+  if (m_transportTool->transport(m_tracks, m_deposits).isFailure()) {
+    m_log << MSG::ERROR << "Transport of " << m_tracks.size() << " particles by " << m_transportTool->engineName()
+          << " failed, the event is aborted" << endmsg;
+    m_pending.clear();
+    // the event misses the energy of the batch: the run manager reports it as failed (not as aborted by the watchdog)
+    G4EventManager* eventManager = G4EventManager::GetEventManager();
+    eventManager->AbortCurrentEvent();
+    eventManager->GetNonconstCurrentEvent()->SetEventAborted();
+    return;
+  }
+  double lostEnergy = 0;
+  for (const auto& deposit : m_deposits) {
+    if (deposit.track >= m_pending.size()) {
+      lostEnergy += deposit.energy;
+      continue;
+    }
+    if (!m_deposit.deposit(*m_pending[deposit.track], G4ThreeVector(deposit.x, deposit.y, deposit.z), deposit.energy,
+                           deposit.time)) {
+      lostEnergy += deposit.energy;
+    }
+  }
+  m_log << MSG::DEBUG << "Transported " << m_tracks.size() << " particles by " << m_transportTool->engineName()
+        << " in one batch: " << m_deposits.size() << " deposits, " << lostEnergy / Gaudi::Units::GeV
+        << " GeV outside of the sensitive volumes" << endmsg;
+  m_pending.clear();
+}
+}
@@ -0,0 +1,119 @@
+#include "SimG4Fast/FastSimModelInference.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4ShowerInferenceTool.h"
+
+// Gaudi
+#include "GaudiKernel/SystemOfUnits.h"
+
+// Geant4
+#include "G4DynamicParticle.hh"
+#include "G4Electron.hh"
+#include "G4Gamma.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Positron.hh"
+#include "G4Track.hh"
+#include "Randomize.hh"
+
+// STL
+#include <cmath>
+
+namespace sim {
+
+FastSimModelInference::FastSimModelInference(const std::string& aModelName, G4Region* aEnvelope,
+                                             ToolHandle<ISimG4ShowerInferenceTool>& aInferenceTool,
+                                             const Mesh& aMesh, double aMinEnergy, double aMaxEnergy,
+                                             const std::set<int>& aPdgCodes)
+    : G4VFastSimulationModel(aModelName, aEnvelope),
+      m_msgSvc("MessageSvc", "FastSimModelInference"),
+      m_log(&(*m_msgSvc), "FastSimModelInference"),
+      m_inferenceTool(aInferenceTool),
+      m_mesh(aMesh),
+      m_minEnergy(aMinEnergy / Gaudi::Units::MeV),
+      m_maxEnergy(aMaxEnergy / Gaudi::Units::MeV),
+      m_pdgCodes(aPdgCodes) {
+  if (m_pdgCodes.empty()) {
+    m_pdgCodes = {G4Electron::ElectronDefinition()->GetPDGEncoding(),
+                  G4Positron::PositronDefinition()->GetPDGEncoding(), G4Gamma::GammaDefinition()->GetPDGEncoding()};
+  }
+}
+
+FastSimModelInference::~FastSimModelInference() {}
+
+G4bool FastSimModelInference::IsApplicable(const G4ParticleDefinition& aParticleType) {
+  return m_pdgCodes.count(aParticleType.GetPDGEncoding()) > 0;
+}
+
+G4bool FastSimModelInference::ModelTrigger(const G4FastTrack& aFastTrack) {
+  const double energy = aFastTrack.GetPrimaryTrack()->GetKineticEnergy();
+  return energy >= m_minEnergy && energy <= m_maxEnergy;
+}
+
+void FastSimModelInference::DoIt(const G4FastTrack& aFastTrack, G4FastStep& aFastStep) {
+  const G4Track* track = aFastTrack.GetPrimaryTrack();
+  // copy of the track, to which the deposits are attributed at the end of the event
+  auto particle = new G4DynamicParticle(track->GetDefinition(), track->GetMomentumDirection(),
+                                        track->GetKineticEnergy());
+  std::unique_ptr<G4Track> pending(new G4Track(particle, track->GetGlobalTime(), track->GetPosition()));
+  pending->SetTrackID(track->GetTrackID());
+  pending->SetParentID(track->GetParentID());
+  m_pending.push_back(std::move(pending));
+  aFastStep.KillPrimaryTrack();
+  aFastStep.ProposePrimaryTrackPathLength(0);
+  aFastStep.ProposeTotalEnergyDeposited(track->GetKineticEnergy());
+}
+
+void FastSimModelInference::Flush() {
+  if (m_pending.empty()) {
+    return;
+  }
+  const size_t batchSize = m_pending.size();
+  const size_t inputSize = m_inferenceTool->inputSize();
+  const size_t numCells = size_t(m_mesh.numR) * m_mesh.numPhi * m_mesh.numZ;
+  if (inputSize < 2) {
+    m_log << MSG::ERROR << "Inference tool needs at least the two conditions as input" << endmsg;
+    m_pending.clear();
+    return;
+  }
+  // latent variables followed by the conditions: energy and polar angle
+  m_input.resize(batchSize * inputSize);
+  for (size_t iShower = 0; iShower < batchSize; ++iShower) {
+    float* input = m_input.data() + iShower * inputSize;
+    for (size_t iLatent = 0; iLatent + 2 < inputSize; ++iLatent) {
+      input[iLatent] = G4RandGauss::shoot(0., 1.);
+    }
+    input[inputSize - 2] = m_pending[iShower]->GetKineticEnergy() / Gaudi::Units::GeV;
+    input[inputSize - 1] = m_pending[iShower]->GetMomentumDirection().theta();
+  }
+  if (m_inferenceTool->infer(m_input, batchSize, m_output).isFailure() ||
+      m_output.size() != batchSize * numCells) {
+    m_log << MSG::ERROR << "Inference of " << batchSize << " showers failed, their energy is not deposited" << endmsg;
+    m_pending.clear();
+    return;
+  }
+  m_log << MSG::DEBUG << "Inferred " << batchSize << " showers in one batch" << endmsg;
+  const double phiSize = CLHEP::twopi / m_mesh.numPhi;
+  for (size_t iShower = 0; iShower < batchSize; ++iShower) {
+    G4Track& track = *m_pending[iShower];
+    const double energy = track.GetKineticEnergy();
+    const G4ThreeVector& position = track.GetPosition();
+    const G4ThreeVector& direction = track.GetMomentumDirection();
+    const G4ThreeVector uAxis = direction.orthogonal().unit();
+    const G4ThreeVector vAxis = direction.cross(uAxis);
+    const float* output = m_output.data() + iShower * numCells;
+    for (unsigned int iR = 0; iR < m_mesh.numR; ++iR) {
+      const double radius = (iR + 0.5) * m_mesh.sizeR;
+      for (unsigned int iPhi = 0; iPhi < m_mesh.numPhi; ++iPhi) {
+        const double phi = (iPhi + 0.5) * phiSize;
+        const G4ThreeVector transverse = radius * (std::cos(phi) * uAxis + std::sin(phi) * vAxis);
+        for (unsigned int iZ = 0; iZ < m_mesh.numZ; ++iZ, ++output) {
+          if (*output <= 0) continue;
+          m_deposit.deposit(track, position + transverse + (iZ + 0.5) * m_mesh.sizeZ * direction, *output * energy,
+                            track.GetGlobalTime());
+        }
+      }
+    }
+  }
+  m_pending.clear();
+}
+}
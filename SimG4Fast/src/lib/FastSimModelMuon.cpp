@@ -0,0 +1,233 @@
+#include "SimG4Fast/FastSimModelMuon.h"
+
+// Geant4
+#include "G4Field.hh"
+#include "G4FieldManager.hh"
+#include "G4GeometryTolerance.hh"
+#include "G4Log.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4MuonMinus.hh"
+#include "G4MuonPlus.hh"
+#include "G4Navigator.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4TouchableHistory.hh"
+#include "G4Track.hh"
+#include "G4TransportationManager.hh"
+#include "G4UnitsTable.hh"
+#include "G4VSensitiveDetector.hh"
+#include "Randomize.hh"
+
+// STL
+#include <algorithm>
+#include <cmath>
+
+namespace {
+/// Lowest kinetic energy of the tables of the stopping powers (the stopping power below is the one at this energy)
+const double kTableMinEnergy = 1 * CLHEP::MeV;
+/// Number of the bins of the tables per decade of the kinetic energy, and of the points of the tables (up to 100 TeV)
+const double kBinsPerDecade = 20;
+const size_t kTableSize = 8 * 20 + 1;
+}
+
+namespace sim {
+
+FastSimModelMuon::FastSimModelMuon(const std::string& aModelName, G4Region* aEnvelope, double aMinEnergy,
+                                   double aMaxEnergy, double aMaxStep)
+    : G4VFastSimulationModel(aModelName, aEnvelope),
+      m_msgSvc("MessageSvc", "FastSimModelMuon"),
+      m_log(&(*m_msgSvc), "FastSimModelMuon"),
+      m_minEnergy(aMinEnergy),
+      m_maxEnergy(aMaxEnergy),
+      m_maxStep(aMaxStep) {
+  m_log << MSG::INFO << "Muon propagation configuration:\n"
+        << "\tEnvelope name:\t" << aEnvelope->GetName() << "\n"
+        << "\tKinetic energy range:\t" << G4BestUnit(m_minEnergy, "Energy") << " - "
+        << G4BestUnit(m_maxEnergy, "Energy") << "\n"
+        << "\tMaximum step:\t" << G4BestUnit(m_maxStep, "Length") << "\n"
+        << endmsg;
+}
+
+FastSimModelMuon::~FastSimModelMuon() {}
+
+G4bool FastSimModelMuon::IsApplicable(const G4ParticleDefinition& aParticleType) {
+  return &aParticleType == G4MuonMinus::Definition() || &aParticleType == G4MuonPlus::Definition();
+}
+
+G4bool FastSimModelMuon::ModelTrigger(const G4FastTrack& aFastTrack) {
+  const double energy = aFastTrack.GetPrimaryTrack()->GetKineticEnergy();
+  if (energy < m_minEnergy || energy > m_maxEnergy) {
+    return false;
+  }
+  // a muon moved to the surface of the envelope leaves it with the ordinary tracking
+  return aFastTrack.GetEnvelopeSolid()->DistanceToOut(aFastTrack.GetPrimaryTrackLocalPosition(),
+                                                      aFastTrack.GetPrimaryTrackLocalDirection()) >
+         G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+}
+
+double FastSimModelMuon::stoppingPower(const G4Material* aMaterial, double aEnergy) {
+  auto table = m_stoppingPowers.find(aMaterial);
+  if (table == m_stoppingPowers.end()) {
+    // the stopping powers of both charges differ by much less than the fluctuations that are neglected
+    std::vector<double> values(kTableSize);
+    for (size_t iPoint = 0; iPoint < kTableSize; ++iPoint) {
+      values[iPoint] = m_calculator.ComputeTotalDEDX(kTableMinEnergy * std::pow(10., iPoint / kBinsPerDecade),
+                                                     G4MuonMinus::Definition(), aMaterial);
+    }
+    table = m_stoppingPowers.emplace(aMaterial, std::move(values)).first;
+  }
+  const std::vector<double>& values = table->second;
+  const double bin = std::log10(aEnergy / kTableMinEnergy) * kBinsPerDecade;
+  if (!(bin > 0)) {
+    return values.front();
+  }
+  if (bin >= kTableSize - 1) {
+    return values.back();
+  }
+  const size_t iBin = static_cast<size_t>(bin);
+  const double fraction = bin - iBin;
+  return values[iBin] * (1 - fraction) + values[iBin + 1] * fraction;
+}
+
+void FastSimModelMuon::DoIt(const G4FastTrack& aFastTrack, G4FastStep& aFastStep) {
+  const G4Track* track = aFastTrack.GetPrimaryTrack();
+  const G4AffineTransform* toLocal = aFastTrack.GetAffineTransformation();
+  const G4VSolid* envelope = aFastTrack.GetEnvelopeSolid();
+  const double tolerance = G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+  const double mass = track->GetDynamicParticle()->GetMass();
+  const double charge = track->GetDynamicParticle()->GetCharge();
+  G4ThreeVector position = track->GetPosition();
+  G4ThreeVector direction = track->GetMomentumDirection();
+  double energy = track->GetKineticEnergy();
+  double time = track->GetGlobalTime();
+  double path = 0;
+  if (!m_navigator) {
+    m_navigator.reset(new G4Navigator());
+    m_navigator->SetWorldVolume(
+        G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume());
+    m_navigator->LocateGlobalPointAndSetup(position, &direction, false, true);
+  }
+  G4VPhysicalVolume* volume = m_navigator->LocateGlobalPointAndSetup(position, &direction, false, false);
+  const G4FieldManager* globalFieldManager = G4TransportationManager::GetTransportationManager()->GetFieldManager();
+  // the number of steps is bounded in case the navigator gets stuck on a boundary
+  const size_t maxNumSteps = 100000;
+  for (size_t iStep = 0; iStep < maxNumSteps && volume != nullptr; ++iStep) {
+    const double exitDistance =
+        envelope->DistanceToOut(toLocal->TransformPoint(position), toLocal->TransformAxis(direction));
+    if (exitDistance <= tolerance) {
+      break;
+    }
+    double length = std::min(m_maxStep, exitDistance);
+    // the deposits need the steps to end at the boundaries of the volumes
+    bool limited = false;
+    if (m_depositEnergy) {
+      double safety = 0;
+      const double boundary = m_navigator->ComputeStep(position, direction, length, safety);
+      if (boundary < length) {
+        length = std::max(boundary, tolerance);
+        limited = true;
+      }
+    }
+    const G4LogicalVolume* logical = volume->GetLogicalVolume();
+    const G4Material* material = logical->GetMaterial();
+    // mean energy loss, with the stopping power at the middle of the step
+    double loss = stoppingPower(material, energy) * length;
+    if (loss < energy) {
+      loss = stoppingPower(material, energy - 0.5 * loss) * length;
+    }
+    const bool stopped = loss >= energy;
+    if (stopped) {
+      length *= energy / loss;
+      loss = energy;
+    }
+    const double momentum = std::sqrt(energy * (energy + 2 * mass));
+    const double beta = momentum / (energy + mass);
+    // multiple scattering: width of the projected angle from the Highland formula, and the correlated lateral
+    // displacement, independently in two planes containing the direction
+    const double thickness = length / material->GetRadlen();
+    double theta0 = 0;
+    if (thickness > 0) {
+      theta0 = std::max(0., 13.6 * CLHEP::MeV / (beta * momentum) * std::abs(charge) * std::sqrt(thickness) *
+                                (1 + 0.038 * G4Log(thickness * charge * charge / (beta * beta))));
+    }
+    const G4ThreeVector first = direction.orthogonal().unit();
+    const G4ThreeVector second = direction.cross(first);
+    G4ThreeVector deflection, displacement;
+    for (const G4ThreeVector* axis : {&first, &second}) {
+      const double uncorrelated = G4RandGauss::shoot();
+      const double angle = G4RandGauss::shoot();
+      deflection += theta0 * angle * *axis;
+      displacement += length * theta0 * (uncorrelated / std::sqrt(12.) + angle / 2) * *axis;
+    }
+    // bending in the field at the middle of the step: the direction turns by charge * c_light / p * direction x B
+    const G4FieldManager* fieldManager =
+        logical->GetFieldManager() != nullptr ? logical->GetFieldManager() : globalFieldManager;
+    const G4Field* field = fieldManager != nullptr ? fieldManager->GetDetectorField() : nullptr;
+    if (field != nullptr && charge != 0) {
+      const G4ThreeVector middle = position + 0.5 * length * direction;
+      const double point[4] = {middle.x(), middle.y(), middle.z(), time};
+      double value[6] = {0, 0, 0, 0, 0, 0};
+      field->GetFieldValue(point, value);
+      const G4ThreeVector bending =
+          charge * CLHEP::c_light / momentum * length * direction.cross(G4ThreeVector(value[0], value[1], value[2]));
+      deflection += bending;
+      displacement += 0.5 * length * bending;
+    }
+    G4ThreeVector nextPosition = position + length * direction + displacement;
+    // the displacement does not move the muon out of the envelope
+    if (envelope->Inside(toLocal->TransformPoint(nextPosition)) == kOutside) {
+      nextPosition = position + length * direction;
+    }
+    const double nextTime = time + length / (beta * CLHEP::c_light);
+    G4VSensitiveDetector* sensitive = m_depositEnergy ? logical->GetSensitiveDetector() : nullptr;
+    if (sensitive != nullptr && loss > 0) {
+      // a step through the volume with the mean energy loss, as seen by the sensitive detector
+      G4TouchableHandle touchable(m_navigator->CreateTouchableHistory());
+      G4Step step;
+      step.SetTrack(const_cast<G4Track*>(track));
+      G4StepPoint* preStep = step.GetPreStepPoint();
+      preStep->SetPosition(position);
+      preStep->SetMomentumDirection(direction);
+      preStep->SetKineticEnergy(energy);
+      preStep->SetGlobalTime(time);
+      preStep->SetTouchableHandle(touchable);
+      G4StepPoint* postStep = step.GetPostStepPoint();
+      postStep->SetPosition(nextPosition);
+      postStep->SetMomentumDirection(direction);
+      postStep->SetKineticEnergy(energy - loss);
+      postStep->SetGlobalTime(nextTime);
+      postStep->SetTouchableHandle(touchable);
+      step.SetStepLength(length);
+      step.SetTotalEnergyDeposit(loss);
+      sensitive->Hit(&step);
+    }
+    position = nextPosition;
+    direction = (direction + deflection).unit();
+    energy -= loss;
+    time = nextTime;
+    path += length;
+    if (stopped) {
+      energy = 0;
+      break;
+    }
+    if (limited) {
+      m_navigator->SetGeometricallyLimitedStep();
+    }
+    volume = m_navigator->LocateGlobalPointAndSetup(position, &direction, true, false);
+  }
+  // the step of the model deposits no energy: without depositEnergy the mean energy lost in the envelope is not
+  // recorded anywhere (the envelope is meant to be insensitive, e.g. the return yoke), and with it the loss is
+  // already given to the sensitive detectors of the volumes crossed, so it would be counted twice
+  aFastStep.ProposeTotalEnergyDeposited(0);
+  aFastStep.ProposePrimaryTrackFinalPosition(position, false);
+  aFastStep.ProposePrimaryTrackFinalTime(time);
+  aFastStep.ProposePrimaryTrackPathLength(path);
+  if (energy <= 0) {
+    aFastStep.KillPrimaryTrack();
+    return;
+  }
+  aFastStep.ProposePrimaryTrackFinalKineticEnergyAndDirection(energy, direction, false);
+}
+}
@@ -0,0 +1,83 @@
+#include "SimG4Fast/FastSimModelShowerLibrary.h"
+
+// Geant4
+#include "G4Electron.hh"
+#include "G4Gamma.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Positron.hh"
+#include "GFlashEnergySpot.hh"
+#include "Randomize.hh"
+
+// STL
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+FastSimModelShowerLibrary::FastSimModelShowerLibrary(const std::string& aModelName, G4Region* aEnvelope,
+                                                     const ShowerLibrary& aLibrary, double aMinEnergy,
+                                                     double aMaxEnergy, bool aRandomRotation,
+                                                     const std::set<int>& aPdgCodes)
+    : G4VFastSimulationModel(aModelName, aEnvelope),
+      m_library(aLibrary),
+      m_minEnergy(aMinEnergy),
+      m_maxEnergy(aMaxEnergy),
+      m_randomRotation(aRandomRotation),
+      m_pdgCodes(aPdgCodes),
+      m_hitMaker(new GFlashHitMaker()) {
+  if (m_pdgCodes.empty()) {
+    m_pdgCodes = {G4Electron::ElectronDefinition()->GetPDGEncoding(),
+                  G4Positron::PositronDefinition()->GetPDGEncoding(), G4Gamma::GammaDefinition()->GetPDGEncoding()};
+  }
+}
+
+FastSimModelShowerLibrary::~FastSimModelShowerLibrary() {}
+
+G4bool FastSimModelShowerLibrary::IsApplicable(const G4ParticleDefinition& aParticleType) {
+  return m_pdgCodes.count(aParticleType.GetPDGEncoding()) > 0;
+}
+
+G4bool FastSimModelShowerLibrary::ModelTrigger(const G4FastTrack& aFastTrack) {
+  const G4Track* track = aFastTrack.GetPrimaryTrack();
+  const double energy = track->GetKineticEnergy();
+  if (energy < m_minEnergy || energy > m_maxEnergy) {
+    return false;
+  }
+  // the library is binned in the global coordinates
+  return m_library.bin(energy, track->GetMomentumDirection().eta(), track->GetPosition().perp()) >= 0;
+}
+
+void FastSimModelShowerLibrary::DoIt(const G4FastTrack& aFastTrack, G4FastStep& aFastStep) {
+  const G4Track* track = aFastTrack.GetPrimaryTrack();
+  const double energy = track->GetKineticEnergy();
+  const G4ThreeVector& position = track->GetPosition();
+  const G4ThreeVector& direction = track->GetMomentumDirection();
+  const long bin = m_library.bin(energy, direction.eta(), position.perp());
+  aFastStep.KillPrimaryTrack();
+  aFastStep.ProposePrimaryTrackPathLength(0);
+  aFastStep.ProposeTotalEnergyDeposited(energy);
+  if (bin < 0) {
+    return;
+  }
+  const size_t numShowers = m_library.numShowers(bin);
+  const size_t index = std::min(static_cast<size_t>(G4UniformRand() * numShowers), numShowers - 1);
+  const ShowerLibrary::Shower& shower = m_library.shower(bin, index);
+  // frame of the shower: w along the direction, u and v transverse (the same convention as for the recording)
+  G4ThreeVector uAxis = direction.orthogonal().unit();
+  G4ThreeVector vAxis = direction.cross(uAxis);
+  if (m_randomRotation) {
+    const double angle = CLHEP::twopi * G4UniformRand();
+    const G4ThreeVector u = std::cos(angle) * uAxis + std::sin(angle) * vAxis;
+    vAxis = direction.cross(u);
+    uAxis = u;
+  }
+  const ShowerLibrary::Spot* spots = m_library.spots(shower);
+  GFlashEnergySpot spot;
+  for (std::uint64_t iSpot = 0; iSpot < shower.numSpots; ++iSpot) {
+    const ShowerLibrary::Spot& librarySpot = spots[iSpot];
+    spot.SetEnergy(librarySpot.fraction * energy);
+    spot.SetPosition(position + librarySpot.w * direction + librarySpot.u * uAxis + librarySpot.v * vAxis);
+    m_hitMaker->make(&spot, &aFastTrack);
+  }
+}
+}
@@ -1,6 +1,8 @@
 #include "SimG4Fast/FastSimModelTracker.h"
 
 // FCCSW
+#include "SimG4Common/ConstantField.h"
+#include "SimG4Common/EventInformation.h"
 #include "SimG4Common/ParticleInformation.h"
 #include "SimG4Interface/ISimG4ParticleSmearTool.h"
 
@@ -9,11 +11,112 @@
 #include "GaudiKernel/SystemOfUnits.h"
 
 // Geant4
+#include "G4EventManager.hh"
+#include "G4FieldManager.hh"
 #include "G4FieldTrackUpdator.hh"
+#include "G4GeometryTolerance.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Navigator.hh"
 #include "G4PathFinder.hh"
+#include "G4PhysicalConstants.hh"
 #include "G4PrimaryParticle.hh"
+#include "G4Step.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4TouchableHistory.hh"
+#include "G4TransportationManager.hh"
+#include "G4Tubs.hh"
+#include "G4TwoVector.hh"
 #include "G4UnitsTable.hh"
+#include "G4VSensitiveDetector.hh"
+#include "Randomize.hh"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+/// Smallest positive rotation angle (in the direction of the motion) at which the circle of the transverse motion
+/// reaches the radius aRadius; the circle is centred at aCentre, with the start point at aCentre + aOffset
+double helixAngleToRadius(const G4TwoVector& aCentre, const G4TwoVector& aOffset, double aRadius, double aMinAngle) {
+  const double centre = aCentre.mag();
+  const double radius = aOffset.mag();
+  if (centre * radius == 0) {
+    return std::numeric_limits<double>::infinity();
+  }
+  // |centre + offset rotated by -angle|^2 = radius^2 for cos(phiOffset - phiCentre - angle) = cosine
+  const double cosine = (aRadius * aRadius - centre * centre - radius * radius) / (2 * centre * radius);
+  if (std::abs(cosine) > 1) {
+    return std::numeric_limits<double>::infinity();
+  }
+  const double base = aOffset.phi() - aCentre.phi();
+  double best = std::numeric_limits<double>::infinity();
+  for (double angle : {base - std::acos(cosine), base + std::acos(cosine)}) {
+    angle = std::fmod(angle, CLHEP::twopi);
+    if (angle < 0) angle += CLHEP::twopi;
+    if (angle <= aMinAngle) angle += CLHEP::twopi;
+    best = std::min(best, angle);
+  }
+  return best;
+}
+
+/// Position and direction after the path length aPath on the helix (the transverse motion is rotated by the angle
+/// -aCurvature * aPath, a straight line for zero curvature)
+void helixPoint(const G4ThreeVector& aPosition, const G4ThreeVector& aDirection, double aCurvature, double aPath,
+                G4ThreeVector& aPoint, G4ThreeVector& aTangent) {
+  aPoint = aPosition + aDirection * aPath;
+  aTangent = aDirection;
+  if (aCurvature != 0) {
+    const double sinAngle = std::sin(aCurvature * aPath);
+    const double cosAngle = std::cos(aCurvature * aPath);
+    aPoint.setX(aPosition.x() + (aDirection.x() * sinAngle - aDirection.y() * cosAngle + aDirection.y()) / aCurvature);
+    aPoint.setY(aPosition.y() + (aDirection.y() * sinAngle + aDirection.x() * cosAngle - aDirection.x()) / aCurvature);
+    aTangent.setX(aDirection.x() * cosAngle + aDirection.y() * sinAngle);
+    aTangent.setY(aDirection.y() * cosAngle - aDirection.x() * sinAngle);
+  }
+}
+
+/// Check if two touchables describe the same placement of a volume
+bool sameVolume(const G4VTouchable& aFirst, const G4VTouchable& aSecond) {
+  if (aFirst.GetHistoryDepth() != aSecond.GetHistoryDepth()) {
+    return false;
+  }
+  for (int depth = 0; depth <= aFirst.GetHistoryDepth(); ++depth) {
+    if (aFirst.GetVolume(depth) != aSecond.GetVolume(depth) ||
+        aFirst.GetReplicaNumber(depth) != aSecond.GetReplicaNumber(depth)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Smallest positive path length (above aMinPath) at which the straight line reaches the radius aRadius
+double lineToRadius(const G4TwoVector& aPosition, const G4TwoVector& aDirection, double aRadius, double aMinPath) {
+  const double a = aDirection.mag2();
+  const double b = 2 * aPosition.dot(aDirection);
+  const double c = aPosition.mag2() - aRadius * aRadius;
+  const double discriminant = b * b - 4 * a * c;
+  if (a == 0 || discriminant < 0) {
+    return std::numeric_limits<double>::infinity();
+  }
+  const double sqrtDiscriminant = std::sqrt(discriminant);
+  for (double path : {(-b - sqrtDiscriminant) / (2 * a), (-b + sqrtDiscriminant) / (2 * a)}) {
+    if (path > aMinPath) return path;
+  }
+  return std::numeric_limits<double>::infinity();
+}
+
+/// Information of the current event, created if it does not exist yet
+sim::EventInformation* currentInformation() {
+  G4EventManager* eventManager = G4EventManager::GetEventManager();
+  auto evtinfo = static_cast<sim::EventInformation*>(eventManager->GetUserInformation());
+  if (evtinfo == nullptr) {
+    evtinfo = new sim::EventInformation();
+    eventManager->SetUserInformation(evtinfo);
+  }
+  return evtinfo;
+}
+}
 
 namespace sim {
 
@@ -29,7 +132,10 @@ FastSimModelTracker::FastSimModelTracker(const std::string& aModelName,
       m_smearTool(aSmearTool),
       m_minTriggerMomentum(aMinMomentum / Gaudi::Units::MeV),
       m_maxTriggerMomentum(aMaxMomentum / Gaudi::Units::MeV),
-      m_maxTriggerEta(aMaxEta) {
+      m_maxTriggerEta(aMaxEta),
+      m_minTriggerMomentum2(m_minTriggerMomentum * m_minTriggerMomentum),
+      m_maxTriggerMomentum2(m_maxTriggerMomentum * m_maxTriggerMomentum),
+      m_maxTriggerCosTheta2(std::tanh(aMaxEta) * std::tanh(aMaxEta)) {
   m_log << MSG::INFO << "Tracker smearing configuration:\n"
         << "\tEnvelope name:\t" << aEnvelope->GetName() << "\n"
         << "\tMomentum range:\t" << G4BestUnit(m_minTriggerMomentum, "Energy") << " - "
@@ -51,63 +157,236 @@ G4bool FastSimModelTracker::IsApplicable(const G4ParticleDefinition& aParticleTy
 }
 
 G4bool FastSimModelTracker::ModelTrigger(const G4FastTrack& aFastTrack) {
-  double momentum = aFastTrack.GetPrimaryTrackLocalMomentum().mag();
-  double eta = aFastTrack.GetPrimaryTrackLocalDirection().eta();
-  // first check pseudorapidity
-  if (m_maxTriggerEta > 0) {
-    if (eta > m_maxTriggerEta) {
-      // do not trigger if eta is larger than threshold (if defined)
+  // compare the squares, so that neither the momentum nor the pseudorapidity need to be computed
+  const G4ThreeVector momentum = aFastTrack.GetPrimaryTrackLocalMomentum();
+  const double momentum2 = momentum.mag2();
+  // check the momentum threshold (if defined for the model)
+  if (m_minTriggerMomentum != m_maxTriggerMomentum &&
+      (momentum2 < m_minTriggerMomentum2 || momentum2 > m_maxTriggerMomentum2)) {
+    return false;
+  }
+  // do not trigger if |eta| is larger than threshold (if defined): |cos(theta)| > tanh(maxEta)
+  if (m_maxTriggerEta > 0 && momentum.z() * momentum.z() > m_maxTriggerCosTheta2 * momentum2) {
+    return false;
+  }
+  return true;
+}
+
+bool FastSimModelTracker::helixExit(const G4FastTrack& aFastTrack, G4ThreeVector& aExit, double& aPath,
+                                    double& aCurvature) const {
+  // envelope: full cylinder, not rotated
+  const G4Tubs* envelope = dynamic_cast<const G4Tubs*>(aFastTrack.GetEnvelopeSolid());
+  const G4AffineTransform* toGlobal = aFastTrack.GetInverseAffineTransformation();
+  if (envelope == nullptr || envelope->GetDeltaPhiAngle() < CLHEP::twopi || toGlobal->IsRotated()) {
+    return false;
+  }
+  const double rMin = envelope->GetInnerRadius();
+  const double rMax = envelope->GetOuterRadius();
+  const double halfZ = envelope->GetZHalfLength();
+  // field: none, or constant along z over the whole envelope
+  const G4Track* track = aFastTrack.GetPrimaryTrack();
+  const G4FieldManager* fieldManager = track->GetVolume()->GetLogicalVolume()->GetFieldManager();
+  if (fieldManager == nullptr) {
+    fieldManager = G4TransportationManager::GetTransportationManager()->GetFieldManager();
+  }
+  const G4Field* field = fieldManager != nullptr ? fieldManager->GetDetectorField() : nullptr;
+  double bZ = 0;
+  if (field != nullptr) {
+    const ConstantField* constantField = dynamic_cast<const ConstantField*>(field);
+    if (constantField == nullptr || constantField->bX() != 0 || constantField->bY() != 0) {
       return false;
     }
+    const G4ThreeVector origin = toGlobal->NetTranslation();
+    if (origin.perp() + rMax > constantField->maxR() || std::abs(origin.z()) + halfZ > constantField->maxZ()) {
+      return false;
+    }
+    bZ = constantField->bZ();
+  }
+  // path length to the exit, in the local frame of the envelope
+  const G4ThreeVector position = aFastTrack.GetPrimaryTrackLocalPosition();
+  const G4ThreeVector direction = aFastTrack.GetPrimaryTrackLocalDirection();
+  const double tolerance = G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+  double path = std::numeric_limits<double>::infinity();
+  if (direction.z() > 0) {
+    path = (halfZ - position.z()) / direction.z();
+  } else if (direction.z() < 0) {
+    path = (-halfZ - position.z()) / direction.z();
+  }
+  const G4TwoVector position2D(position.x(), position.y());
+  const G4TwoVector direction2D(direction.x(), direction.y());
+  // curvature of the trajectory (rotation angle of the direction per path length, along -z for positive values)
+  const double curvature = track->GetDynamicParticle()->GetCharge() * CLHEP::c_light * bZ / track->GetMomentum().mag();
+  if (curvature == 0) {
+    path = std::min(path, lineToRadius(position2D, direction2D, rMax, tolerance));
+    if (rMin > 0) path = std::min(path, lineToRadius(position2D, direction2D, rMin, tolerance));
+  } else {
+    // transverse motion: position(angle) = centre + offset rotated by -angle, with angle = curvature * path
+    const G4TwoVector offset = G4TwoVector(-direction.y(), direction.x()) / curvature;
+    const G4TwoVector centre = position2D - offset;
+    const double sign = curvature > 0 ? 1 : -1;
+    // the angle is measured in the direction of the rotation
+    const G4TwoVector signedOffset(offset.x(), sign * offset.y());
+    const G4TwoVector signedCentre(centre.x(), sign * centre.y());
+    const double minAngle = tolerance * std::abs(curvature);
+    double angle = helixAngleToRadius(signedCentre, signedOffset, rMax, minAngle);
+    if (rMin > 0) angle = std::min(angle, helixAngleToRadius(signedCentre, signedOffset, rMin, minAngle));
+    path = std::min(path, angle / std::abs(curvature));
+  }
+  if (!std::isfinite(path)) {
+    // looping in the transverse plane without longitudinal motion
+    return false;
+  }
+  G4ThreeVector exitPoint, exitDirection;
+  helixPoint(position, direction, curvature, path, exitPoint, exitDirection);
+  aExit = toGlobal->TransformPoint(exitPoint);
+  aPath = path;
+  aCurvature = curvature;
+  return true;
+}
+
+void FastSimModelTracker::setHitParameters(const HitParameters& aParameters) {
+  m_hitParameters = aParameters;
+  m_makeHits = true;
+}
+
+void FastSimModelTracker::makeHits(const G4FastTrack& aFastTrack, double aPath, double aCurvature) {
+  // the envelope is not rotated and the field is along z, so the helix is the same in the global frame
+  const G4Track* track = aFastTrack.GetPrimaryTrack();
+  const G4ThreeVector start = track->GetPosition();
+  const G4ThreeVector startDirection = track->GetMomentumDirection();
+  const double velocity = track->GetVelocity();
+  const double tolerance = G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+  if (!m_navigator) {
+    m_navigator.reset(new G4Navigator());
+    m_navigator->SetWorldVolume(
+        G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume());
   }
-  // next check momentum
-  if (m_minTriggerMomentum == m_maxTriggerMomentum) {
-    // if no trigger threshold defined for the model
-    return true;
+  // a step from the entry to the exit of the sensitive volume, smeared as a whole, is passed to its detector
+  auto createHit = [&](G4VSensitiveDetector& aDetector, const G4TouchableHandle& aTouchable,
+                       const G4ThreeVector& aEntry, double aEntryPath, const G4ThreeVector& aExit, double aExitPath) {
+    const G4ThreeVector middle = 0.5 * (aEntry + aExit);
+    const G4ThreeVector rPhi = middle.perp() > 0 ? G4ThreeVector(-middle.y(), middle.x(), 0).unit()
+                                                 : G4ThreeVector(1, 0, 0);
+    const G4ThreeVector offset = G4RandGauss::shoot(0., m_hitParameters.resolutionRPhi) * rPhi +
+                                 G4ThreeVector(0, 0, G4RandGauss::shoot(0., m_hitParameters.resolutionZ));
+    G4Step step;
+    step.SetTrack(const_cast<G4Track*>(track));
+    G4ThreeVector point, tangent;
+    helixPoint(start, startDirection, aCurvature, aEntryPath, point, tangent);
+    G4StepPoint* preStep = step.GetPreStepPoint();
+    preStep->SetPosition(aEntry + offset);
+    preStep->SetMomentumDirection(tangent);
+    preStep->SetKineticEnergy(track->GetKineticEnergy());
+    preStep->SetGlobalTime(track->GetGlobalTime() + aEntryPath / velocity);
+    preStep->SetTouchableHandle(aTouchable);
+    helixPoint(start, startDirection, aCurvature, aExitPath, point, tangent);
+    G4StepPoint* postStep = step.GetPostStepPoint();
+    postStep->SetPosition(aExit + offset);
+    postStep->SetMomentumDirection(tangent);
+    postStep->SetKineticEnergy(track->GetKineticEnergy());
+    postStep->SetGlobalTime(track->GetGlobalTime() + aExitPath / velocity);
+    postStep->SetTouchableHandle(aTouchable);
+    step.SetStepLength(aExitPath - aEntryPath);
+    step.SetTotalEnergyDeposit(m_hitParameters.energyPerLength * (aExitPath - aEntryPath));
+    aDetector.Hit(&step);
+  };
+  G4ThreeVector point = start;
+  G4ThreeVector tangent = startDirection;
+  m_navigator->LocateGlobalPointAndSetup(point, &tangent, false, false);
+  double path = 0;
+  // sensitive volume in which the helix currently is
+  G4VSensitiveDetector* detector = nullptr;
+  G4TouchableHandle touchable;
+  G4ThreeVector entry;
+  double entryPath = 0;
+  // the number of steps is bounded in case the navigator gets stuck on a boundary
+  const size_t maxNumSteps = 100000;
+  for (size_t iStep = 0; iStep < maxNumSteps; ++iStep) {
+    G4TouchableHandle current(m_navigator->CreateTouchableHistory());
+    if (detector != nullptr && !sameVolume(*current, *touchable)) {
+      createHit(*detector, touchable, entry, entryPath, point, path);
+      detector = nullptr;
+    }
+    if (path >= aPath) {
+      break;
+    }
+    if (detector == nullptr && current->GetVolume() != nullptr) {
+      detector = current->GetVolume()->GetLogicalVolume()->GetSensitiveDetector();
+      touchable = current;
+      entry = point;
+      entryPath = path;
+    }
+    // the chords of the helix are short enough to find the boundaries of the thin layers
+    const double proposedStep = std::min(m_hitParameters.maxStep, aPath - path);
+    double safety = 0;
+    const double boundary = m_navigator->ComputeStep(point, tangent, proposedStep, safety);
+    path = std::min(aPath, path + std::max(std::min(boundary, proposedStep), tolerance));
+    helixPoint(start, startDirection, aCurvature, path, point, tangent);
+    if (boundary <= proposedStep) {
+      m_navigator->SetGeometricallyLimitedStep();
+    }
+    m_navigator->LocateGlobalPointAndSetup(point, &tangent, true, false);
   }
-  // check the threshold
-  if (momentum >= m_minTriggerMomentum && momentum <= m_maxTriggerMomentum) {
-    return true;
+  if (detector != nullptr) {
+    createHit(*detector, touchable, entry, entryPath, point, path);
   }
-  return false;
 }
 
 void FastSimModelTracker::DoIt(const G4FastTrack& aFastTrack, G4FastStep& aFastStep) {
   // Calculate the position of the particle at the end of volume
   const G4Track* track = aFastTrack.GetPrimaryTrack();
-  G4ThreeVector spin = track->GetPolarization();
-  G4FieldTrack aFieldTrack('t');
-  G4FieldTrackUpdator::Update(&aFieldTrack, track);
-  G4double retSafety = -1.0;
-  ELimited retStepLimited;
-  G4FieldTrack endTrack('a');
-  G4double currentMinimumStep = 10 * m;  // TODO change that to sth connected to particle momentum and geometry
-  G4PathFinder* fPathFinder = G4PathFinder::GetInstance();
-  fPathFinder->ComputeStep(aFieldTrack,
-                           currentMinimumStep,
-                           0,
-                           track->GetCurrentStepNumber(),
-                           retSafety,
-                           retStepLimited,
-                           endTrack,
-                           track->GetVolume());
-  aFastStep.ProposePrimaryTrackFinalPosition(endTrack.GetPosition());
+  G4ThreeVector exitPoint;
+  double exitPath = 0;
+  double curvature = 0;
+  if (helixExit(aFastTrack, exitPoint, exitPath, curvature)) {
+    aFastStep.ProposePrimaryTrackFinalPosition(exitPoint);
+    if (m_makeHits) {
+      makeHits(aFastTrack, exitPath, curvature);
+    }
+  } else {
+    G4FieldTrack aFieldTrack('t');
+    G4FieldTrackUpdator::Update(&aFieldTrack, track);
+    G4double retSafety = -1.0;
+    ELimited retStepLimited;
+    G4FieldTrack endTrack('a');
+    G4double currentMinimumStep = 10 * m;  // TODO change that to sth connected to particle momentum and geometry
+    G4PathFinder* fPathFinder = G4PathFinder::GetInstance();
+    fPathFinder->ComputeStep(aFieldTrack,
+                             currentMinimumStep,
+                             0,
+                             track->GetCurrentStepNumber(),
+                             retSafety,
+                             retStepLimited,
+                             endTrack,
+                             track->GetVolume());
+    aFastStep.ProposePrimaryTrackFinalPosition(endTrack.GetPosition());
+  }
 
   // Smear particle's momentum according to the tracker resolution
   G4ThreeVector Psm = track->GetMomentum();
-  m_smearTool->smearMomentum(Psm).ignore();
+  if (m_concurrentSmearing) {
+    const double gauss = G4RandGauss::shoot();
+    m_smearTool->smearMomenta(&Psm, nullptr, 1, &gauss).ignore();
+  } else {
+    m_smearTool->smearMomentum(Psm).ignore();
+  }
   G4ThreeVector DeltaP = track->GetMomentum() - Psm;
   G4double Ekinorg = track->GetKineticEnergy();
   aFastStep.ClearDebugFlag();  // to disable Geant checks on energy
   aFastStep.ProposePrimaryTrackFinalKineticEnergyAndDirection(Ekinorg + DeltaP.mag(), Psm.unit());
   // Keep track of smeared momentum
   if (track->GetParentID() == 0) {
-    ParticleInformation* info =
-        dynamic_cast<ParticleInformation*>(track->GetDynamicParticle()->GetPrimaryParticle()->GetUserInformation());
+    const G4PrimaryParticle* primary = track->GetDynamicParticle()->GetPrimaryParticle();
+    ParticleInformation* info = dynamic_cast<ParticleInformation*>(primary->GetUserInformation());
     info->setSmeared(true);
     info->setEndStatus(1);  // how it is defined ???? as in HepMC ?
     info->setEndMomentum(Psm);
     info->setVertexPosition(track->GetVertexPosition());
+    // recorded in the event, so that the smeared particles are saved without scanning the primaries
+    const G4ThreeVector& vertex = track->GetVertexPosition();
+    currentInformation()->addSmearedParticle({info->mcParticleID(), track->GetTrackID(), primary->GetCharge(),
+                                              primary->GetMass(), Psm.x(), Psm.y(), Psm.z(), vertex.x(), vertex.y(),
+                                              vertex.z()});
   }
 }
 }
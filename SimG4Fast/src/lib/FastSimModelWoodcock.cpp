@@ -0,0 +1,195 @@
+#include "SimG4Fast/FastSimModelWoodcock.h"
+
+// Geant4
+#include "G4Gamma.hh"
+#include "G4GeometryTolerance.hh"
+#include "G4Log.hh"
+#include "G4Material.hh"
+#include "G4MaterialCutsCouple.hh"
+#include "G4Navigator.hh"
+#include "G4ParticleChange.hh"
+#include "G4ParticleChangeForGamma.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4ProcessManager.hh"
+#include "G4Step.hh"
+#include "G4TouchableHistory.hh"
+#include "G4Track.hh"
+#include "G4TransportationManager.hh"
+#include "G4VSensitiveDetector.hh"
+#include "Randomize.hh"
+
+// STL
+#include <algorithm>
+
+namespace sim {
+
+FastSimModelWoodcock::FastSimModelWoodcock(const std::string& aModelName, G4Region* aEnvelope, double aMinEnergy,
+                                           double aMaxEnergy)
+    : G4VFastSimulationModel(aModelName, aEnvelope),
+      m_msgSvc("MessageSvc", "FastSimModelWoodcock"),
+      m_log(&(*m_msgSvc), "FastSimModelWoodcock"),
+      m_region(aEnvelope),
+      m_minEnergy(aMinEnergy),
+      m_maxEnergy(aMaxEnergy) {}
+
+FastSimModelWoodcock::~FastSimModelWoodcock() {}
+
+G4bool FastSimModelWoodcock::IsApplicable(const G4ParticleDefinition& aParticleType) {
+  return &aParticleType == G4Gamma::GammaDefinition();
+}
+
+G4bool FastSimModelWoodcock::ModelTrigger(const G4FastTrack& aFastTrack) {
+  const double energy = aFastTrack.GetPrimaryTrack()->GetKineticEnergy();
+  if (energy < m_minEnergy || energy > m_maxEnergy) {
+    return false;
+  }
+  // a photon moved to the surface of the envelope leaves it with the ordinary tracking
+  return aFastTrack.GetEnvelopeSolid()->DistanceToOut(aFastTrack.GetPrimaryTrackLocalPosition(),
+                                                      aFastTrack.GetPrimaryTrackLocalDirection()) >
+         G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+}
+
+void FastSimModelWoodcock::initialise() {
+  G4ProcessManager* processManager = G4Gamma::GammaDefinition()->GetProcessManager();
+  G4ProcessVector* processes = processManager->GetProcessList();
+  for (size_t iProcess = 0; iProcess < processes->size(); ++iProcess) {
+    G4VProcess* process = (*processes)[iProcess];
+    if ((process->GetProcessType() == fElectromagnetic || process->GetProcessType() == fHadronic) &&
+        processManager->GetProcessActivation(process)) {
+      m_processes.push_back(process);
+    }
+  }
+  auto material = m_region->GetMaterialIterator();
+  for (size_t iMaterial = 0; iMaterial < m_region->GetNumberOfMaterials(); ++iMaterial, ++material) {
+    const G4MaterialCutsCouple* couple = m_region->FindCouple(*material);
+    if (couple != nullptr) m_couples.push_back(couple);
+  }
+  m_crossSections.resize(m_processes.size());
+  m_log << MSG::DEBUG << "Woodcock tracking in region " << m_region->GetName() << " with " << m_processes.size()
+        << " processes and " << m_couples.size() << " materials" << endmsg;
+}
+
+double FastSimModelWoodcock::crossSection(double aEnergy, const G4MaterialCutsCouple* aCouple,
+                                          std::vector<double>& aCrossSections) const {
+  double total = 0;
+  for (size_t iProcess = 0; iProcess < m_processes.size(); ++iProcess) {
+    aCrossSections[iProcess] = std::max(0., m_processes[iProcess]->GetCrossSection(aEnergy, aCouple));
+    total += aCrossSections[iProcess];
+  }
+  return total;
+}
+
+void FastSimModelWoodcock::DoIt(const G4FastTrack& aFastTrack, G4FastStep& aFastStep) {
+  if (m_couples.empty()) {
+    initialise();
+  }
+  const G4Track* track = aFastTrack.GetPrimaryTrack();
+  const double energy = track->GetKineticEnergy();
+  const G4ThreeVector& position = track->GetPosition();
+  const G4ThreeVector& direction = track->GetMomentumDirection();
+  const double exitDistance = aFastTrack.GetEnvelopeSolid()->DistanceToOut(aFastTrack.GetPrimaryTrackLocalPosition(),
+                                                                           aFastTrack.GetPrimaryTrackLocalDirection());
+  double majorant = 0;
+  for (const auto couple : m_couples) {
+    majorant = std::max(majorant, crossSection(energy, couple, m_crossSections));
+  }
+  if (!m_navigator) {
+    m_navigator.reset(new G4Navigator());
+    m_navigator->SetWorldVolume(
+        G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume());
+    m_navigator->LocateGlobalPointAndSetup(position, &direction, false, true);
+  }
+  // flight with the majorant cross-section, ignoring the boundaries within the envelope
+  double distance = majorant > 0 ? -G4Log(G4UniformRand()) / majorant : exitDistance;
+  G4VProcess* interaction = nullptr;
+  G4TouchableHandle touchable(new G4TouchableHistory());
+  for (; distance < exitDistance; distance -= G4Log(G4UniformRand()) / majorant) {
+    m_navigator->LocateGlobalPointAndUpdateTouchable(position + distance * direction, direction, touchable(), true);
+    if (touchable->GetVolume() == nullptr) break;
+    const G4MaterialCutsCouple* couple = touchable->GetVolume()->GetLogicalVolume()->GetMaterialCutsCouple();
+    const double total = crossSection(energy, couple, m_crossSections);
+    if (total > majorant * (1 + 1e-9) && !m_majorantReported) {
+      m_log << MSG::WARNING << "Material " << couple->GetMaterial()->GetName() << " is not a material of the region "
+            << m_region->GetName() << ", the Woodcock tracking underestimates its interactions" << endmsg;
+      m_majorantReported = true;
+    }
+    // accept the interaction of each process with the ratio of its cross-section and the majorant
+    double threshold = G4UniformRand() * majorant;
+    for (size_t iProcess = 0; iProcess < m_processes.size() && interaction == nullptr; ++iProcess) {
+      threshold -= m_crossSections[iProcess];
+      if (threshold < 0) interaction = m_processes[iProcess];
+    }
+    if (interaction != nullptr) break;
+  }
+  distance = std::min(distance, exitDistance);
+  const G4ThreeVector finalPosition = position + distance * direction;
+  const double finalTime = track->GetGlobalTime() + distance / CLHEP::c_light;
+  aFastStep.ProposePrimaryTrackFinalPosition(finalPosition, false);
+  aFastStep.ProposePrimaryTrackFinalTime(finalTime);
+  aFastStep.ProposePrimaryTrackPathLength(distance);
+  if (interaction != nullptr) {
+    // copy of the photon at the interaction point, in the located volume
+    G4Track photon(new G4DynamicParticle(*track->GetDynamicParticle()), finalTime, finalPosition);
+    photon.SetTrackID(track->GetTrackID());
+    photon.SetParentID(track->GetParentID());
+    photon.SetTouchableHandle(touchable);
+    interact(interaction, photon, aFastStep);
+  }
+  // the numbers of interaction lengths left are sampled again, as the photon did not travel in the ordinary tracking
+  for (auto process : m_processes) {
+    process->StartTracking(const_cast<G4Track*>(track));
+  }
+}
+
+void FastSimModelWoodcock::interact(G4VProcess* aProcess, G4Track& aTrack, G4FastStep& aFastStep) {
+  G4VPhysicalVolume* volume = aTrack.GetTouchableHandle()->GetVolume();
+  const G4MaterialCutsCouple* couple = volume->GetLogicalVolume()->GetMaterialCutsCouple();
+  G4Step step;
+  step.SetTrack(&aTrack);
+  aTrack.SetStep(&step);
+  for (G4StepPoint* point : {step.GetPreStepPoint(), step.GetPostStepPoint()}) {
+    point->SetPosition(aTrack.GetPosition());
+    point->SetGlobalTime(aTrack.GetGlobalTime());
+    point->SetTouchableHandle(aTrack.GetTouchableHandle());
+    point->SetMaterial(couple->GetMaterial());
+    point->SetMaterialCutsCouple(couple);
+    point->SetKineticEnergy(aTrack.GetKineticEnergy());
+    point->SetMomentumDirection(aTrack.GetMomentumDirection());
+    point->SetPolarization(aTrack.GetPolarization());
+    point->SetSafety(0);
+  }
+  // the process selects the material (and its model) when the interaction length is computed
+  G4ForceCondition condition;
+  aProcess->PostStepGetPhysicalInteractionLength(aTrack, 0, &condition);
+  G4VParticleChange* change = aProcess->PostStepDoIt(aTrack, step);
+  aFastStep.SetNumberOfSecondaryTracks(change->GetNumberOfSecondaries());
+  for (int iSecondary = 0; iSecondary < change->GetNumberOfSecondaries(); ++iSecondary) {
+    G4Track* secondary = change->GetSecondary(iSecondary);
+    G4Track* created = aFastStep.CreateSecondaryTrack(*secondary->GetDynamicParticle(), secondary->GetPosition(),
+                                                      secondary->GetGlobalTime(), false);
+    if (created != nullptr) created->SetCreatorProcess(aProcess);
+    delete secondary;
+  }
+  const double deposit = change->GetLocalEnergyDeposit();
+  if (deposit > 0) {
+    aFastStep.ProposeTotalEnergyDeposited(deposit);
+    G4VSensitiveDetector* sensitive = volume->GetLogicalVolume()->GetSensitiveDetector();
+    if (sensitive != nullptr) {
+      step.SetTotalEnergyDeposit(deposit);
+      sensitive->Hit(&step);
+    }
+  }
+  if (change->GetTrackStatus() == fStopAndKill || change->GetTrackStatus() == fStopButAlive) {
+    aFastStep.KillPrimaryTrack();
+  } else if (auto gammaChange = dynamic_cast<G4ParticleChangeForGamma*>(change)) {
+    aFastStep.ProposePrimaryTrackFinalKineticEnergyAndDirection(gammaChange->GetProposedKineticEnergy(),
+                                                                gammaChange->GetProposedMomentumDirection(), false);
+    aFastStep.ProposePrimaryTrackFinalPolarization(gammaChange->GetProposedPolarization(), false);
+  } else if (auto generalChange = dynamic_cast<G4ParticleChange*>(change)) {
+    aFastStep.ProposePrimaryTrackFinalKineticEnergyAndDirection(generalChange->GetEnergy(),
+                                                                *generalChange->GetMomentumDirection(), false);
+  }
+  change->Clear();
+  aTrack.SetStep(nullptr);
+}
+}
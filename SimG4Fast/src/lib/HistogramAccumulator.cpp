@@ -0,0 +1,72 @@
+#include "SimG4Fast/HistogramAccumulator.h"
+
+// ROOT
+#include "TH1F.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+HistogramAccumulator::HistogramAccumulator(const std::string& aName, const std::string& aTitle,
+                                           unsigned int aNumBins, double aMin, double aMax)
+    : m_name(aName),
+      m_title(aTitle),
+      m_numBins(aNumBins),
+      m_min(aMin),
+      m_max(aMax),
+      m_scale(aNumBins / (aMax - aMin)),
+      m_buffers(Buffer(aNumBins)) {}
+
+void HistogramAccumulator::fill(double aValue, double aWeight) {
+  if (std::isnan(aValue)) {
+    return;
+  }
+  Buffer& buffer = m_buffers.local();
+  buffer.entries += 1;
+  size_t bin = 0;
+  if (aValue >= m_max) {
+    bin = m_numBins + 1;
+  } else if (aValue >= m_min) {
+    bin = 1 + std::min<size_t>(static_cast<size_t>((aValue - m_min) * m_scale), m_numBins - 1);
+    buffer.sumWInRange += aWeight;
+    buffer.sumW2InRange += aWeight * aWeight;
+    buffer.sumWX += aWeight * aValue;
+    buffer.sumWX2 += aWeight * aValue * aValue;
+  }
+  buffer.sumW[bin] += aWeight;
+  buffer.sumW2[bin] += aWeight * aWeight;
+}
+
+TH1F* HistogramAccumulator::histogram() const {
+  Buffer total(m_numBins);
+  for (const Buffer& buffer : m_buffers) {
+    for (unsigned int bin = 0; bin < m_numBins + 2; ++bin) {
+      total.sumW[bin] += buffer.sumW[bin];
+      total.sumW2[bin] += buffer.sumW2[bin];
+    }
+    total.entries += buffer.entries;
+    total.sumWInRange += buffer.sumWInRange;
+    total.sumW2InRange += buffer.sumW2InRange;
+    total.sumWX += buffer.sumWX;
+    total.sumWX2 += buffer.sumWX2;
+  }
+  TH1F* histogram = new TH1F(m_name.c_str(), m_title.c_str(), m_numBins, m_min, m_max);
+  histogram->Sumw2();
+  for (unsigned int bin = 0; bin < m_numBins + 2; ++bin) {
+    histogram->SetBinContent(bin, total.sumW[bin]);
+    histogram->SetBinError(bin, std::sqrt(total.sumW2[bin]));
+  }
+  double stats[4] = {total.sumWInRange, total.sumW2InRange, total.sumWX, total.sumWX2};
+  histogram->PutStats(stats);
+  histogram->SetEntries(total.entries);
+  return histogram;
+}
+
+void HistogramAccumulator::reset() {
+  for (Buffer& buffer : m_buffers) {
+    buffer = Buffer(m_numBins);
+  }
+}
+}
@@ -0,0 +1,48 @@
+#include "SimG4Fast/SensitiveDeposit.h"
+
+// Geant4
+#include "G4Navigator.hh"
+#include "G4Step.hh"
+#include "G4TouchableHistory.hh"
+#include "G4Track.hh"
+#include "G4TransportationManager.hh"
+#include "G4VSensitiveDetector.hh"
+
+namespace sim {
+SensitiveDeposit::SensitiveDeposit() {}
+
+SensitiveDeposit::~SensitiveDeposit() {}
+
+bool SensitiveDeposit::deposit(G4Track& aTrack, const G4ThreeVector& aPosition, double aEnergy, double aTime) {
+  if (!m_navigator) {
+    m_navigator.reset(new G4Navigator());
+    m_navigator->SetWorldVolume(
+        G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume());
+    m_navigator->LocateGlobalPointAndSetup(aPosition, nullptr, false, true);
+  }
+  G4TouchableHandle touchable(new G4TouchableHistory());
+  m_navigator->LocateGlobalPointAndUpdateTouchable(aPosition, touchable(), false);
+  G4VPhysicalVolume* volume = touchable->GetVolume();
+  if (volume == nullptr) {
+    return false;
+  }
+  G4VSensitiveDetector* sensitive = volume->GetLogicalVolume()->GetSensitiveDetector();
+  if (sensitive == nullptr) {
+    return false;
+  }
+  // a step of zero length at the position of the deposit, as seen by the sensitive detector
+  aTrack.SetTouchableHandle(touchable);
+  G4Step step;
+  step.SetTrack(&aTrack);
+  for (G4StepPoint* point : {step.GetPreStepPoint(), step.GetPostStepPoint()}) {
+    point->SetPosition(aPosition);
+    point->SetGlobalTime(aTime);
+    point->SetTouchableHandle(touchable);
+    point->SetKineticEnergy(aTrack.GetKineticEnergy());
+    point->SetMomentumDirection(aTrack.GetMomentumDirection());
+  }
+  step.SetTotalEnergyDeposit(aEnergy);
+  sensitive->Hit(&step);
+  return true;
+}
+}
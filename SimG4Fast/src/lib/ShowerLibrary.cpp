@@ -0,0 +1,186 @@
+#include "SimG4Fast/ShowerLibrary.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace {
+const char kMagic[8] = {'K', '4', 'S', 'H', 'O', 'W', 'E', 'R'};
+const std::uint32_t kVersion = 1;
+const std::uint32_t kByteOrder = 0x01020304;
+/// Header of the library file
+struct Header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byteOrder;
+  std::uint32_t numEnergy;
+  std::uint32_t numEta;
+  std::uint32_t numPosition;
+  std::uint32_t padding;
+  std::uint64_t numShowers;
+  std::uint64_t numSpots;
+};
+static_assert(sizeof(Header) % sizeof(double) == 0, "Tables following the header need to be aligned");
+static_assert(sizeof(sim::ShowerLibrary::Shower) == 24 && sizeof(sim::ShowerLibrary::Spot) == 16,
+              "Layout of the library file");
+
+bool increasing(const std::vector<double>& aEdges) {
+  if (aEdges.size() < 2) return false;
+  for (size_t i = 1; i < aEdges.size(); ++i) {
+    if (!(aEdges[i] > aEdges[i - 1])) return false;
+  }
+  return true;
+}
+}
+
+namespace sim {
+ShowerLibrary::~ShowerLibrary() { close(); }
+
+void ShowerLibrary::close() {
+  m_file.reset();
+  m_numEnergy = m_numEta = m_numPosition = 0;
+  m_numShowers = 0;
+  m_energyEdges = m_etaEdges = m_positionEdges = nullptr;
+  m_binFirstShower = nullptr;
+  m_showers = nullptr;
+  m_spots = nullptr;
+}
+
+bool ShowerLibrary::open(const std::string& aFileName, std::string& aError) {
+  close();
+  m_file = MappedFile(aFileName, sizeof(Header), "a shower library");
+  if (!m_file.isMapped()) {
+    aError = m_file.error();
+    return false;
+  }
+  const Header& header = *m_file.at<Header>(0);
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+      header.byteOrder != kByteOrder) {
+    close();
+    aError = aFileName + " is not a shower library of version " + std::to_string(kVersion) +
+             " written on a machine of the same byte order";
+    return false;
+  }
+  const std::uint64_t numBins = std::uint64_t(header.numEnergy) * header.numEta * header.numPosition;
+  const std::uint64_t expectedSize =
+      sizeof(Header) +
+      sizeof(double) * (std::uint64_t(header.numEnergy) + header.numEta + header.numPosition + 3) +
+      sizeof(std::uint64_t) * (numBins + 1) + sizeof(Shower) * header.numShowers + sizeof(Spot) * header.numSpots;
+  if (numBins == 0 || expectedSize != m_file.size()) {
+    close();
+    aError = aFileName + " is truncated or has an inconsistent header";
+    return false;
+  }
+  const char* table = m_file.at<char>(sizeof(Header));
+  m_energyEdges = reinterpret_cast<const double*>(table);
+  m_etaEdges = m_energyEdges + header.numEnergy + 1;
+  m_positionEdges = m_etaEdges + header.numEta + 1;
+  m_binFirstShower = reinterpret_cast<const std::uint64_t*>(m_positionEdges + header.numPosition + 1);
+  m_showers = reinterpret_cast<const Shower*>(m_binFirstShower + numBins + 1);
+  m_spots = reinterpret_cast<const Spot*>(m_showers + header.numShowers);
+  // check the indices once, so that the lookup during the simulation does not need to
+  bool valid = m_binFirstShower[0] == 0 && m_binFirstShower[numBins] == header.numShowers;
+  for (std::uint64_t iBin = 0; valid && iBin < numBins; ++iBin) {
+    valid = m_binFirstShower[iBin] <= m_binFirstShower[iBin + 1];
+  }
+  for (std::uint64_t iShower = 0; valid && iShower < header.numShowers; ++iShower) {
+    valid = m_showers[iShower].firstSpot <= header.numSpots &&
+            m_showers[iShower].numSpots <= header.numSpots - m_showers[iShower].firstSpot &&
+            m_showers[iShower].energy > 0;
+  }
+  if (!valid) {
+    close();
+    aError = aFileName + " has inconsistent indices of showers or spots";
+    return false;
+  }
+  m_numEnergy = header.numEnergy;
+  m_numEta = header.numEta;
+  m_numPosition = header.numPosition;
+  m_numShowers = header.numShowers;
+  return true;
+}
+
+long ShowerLibrary::findBin(const double* aEdges, std::uint32_t aNumBins, double aValue) {
+  if (!(aValue >= aEdges[0]) || aValue >= aEdges[aNumBins]) {
+    return -1;
+  }
+  return std::upper_bound(aEdges, aEdges + aNumBins + 1, aValue) - aEdges - 1;
+}
+
+long ShowerLibrary::bin(double aEnergy, double aEta, double aPosition) const {
+  if (!m_file.isMapped()) {
+    return -1;
+  }
+  const long energyBin = findBin(m_energyEdges, m_numEnergy, aEnergy);
+  const long etaBin = findBin(m_etaEdges, m_numEta, std::abs(aEta));
+  const long positionBin = findBin(m_positionEdges, m_numPosition, aPosition);
+  if (energyBin < 0 || etaBin < 0 || positionBin < 0) {
+    return -1;
+  }
+  const long index = (energyBin * m_numEta + etaBin) * m_numPosition + positionBin;
+  return numShowers(index) > 0 ? index : -1;
+}
+
+bool ShowerLibrary::write(const std::string& aFileName, const std::vector<double>& aEnergyEdges,
+                          const std::vector<double>& aEtaEdges, const std::vector<double>& aPositionEdges,
+                          const std::vector<Record>& aRecords, std::string& aError) {
+  if (!increasing(aEnergyEdges) || !increasing(aEtaEdges) || !increasing(aPositionEdges)) {
+    aError = "bin edges need to be increasing (and at least two)";
+    return false;
+  }
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.byteOrder = kByteOrder;
+  header.numEnergy = aEnergyEdges.size() - 1;
+  header.numEta = aEtaEdges.size() - 1;
+  header.numPosition = aPositionEdges.size() - 1;
+  header.padding = 0;
+  const std::uint64_t numBins = std::uint64_t(header.numEnergy) * header.numEta * header.numPosition;
+  // sort the records into the bins (keeping their order within a bin)
+  std::vector<std::vector<size_t>> binRecords(numBins);
+  for (size_t iRecord = 0; iRecord < aRecords.size(); ++iRecord) {
+    const Record& record = aRecords[iRecord];
+    const long energyBin = findBin(aEnergyEdges.data(), header.numEnergy, record.energy);
+    const long etaBin = findBin(aEtaEdges.data(), header.numEta, std::abs(record.eta));
+    const long positionBin = findBin(aPositionEdges.data(), header.numPosition, record.position);
+    if (energyBin < 0 || etaBin < 0 || positionBin < 0 || !(record.energy > 0)) continue;
+    binRecords[(energyBin * header.numEta + etaBin) * header.numPosition + positionBin].push_back(iRecord);
+  }
+  std::vector<std::uint64_t> binFirstShower(1, 0);
+  std::vector<Shower> showers;
+  for (const auto& records : binRecords) {
+    for (size_t iRecord : records) {
+      const std::uint64_t firstSpot = showers.empty() ? 0 : showers.back().firstSpot + showers.back().numSpots;
+      showers.push_back({aRecords[iRecord].energy, firstSpot, aRecords[iRecord].spots.size()});
+    }
+    binFirstShower.push_back(showers.size());
+  }
+  header.numShowers = showers.size();
+  header.numSpots = showers.empty() ? 0 : showers.back().firstSpot + showers.back().numSpots;
+  std::ofstream file(aFileName, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    aError = "cannot open " + aFileName + " for writing";
+    return false;
+  }
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const auto* edges : {&aEnergyEdges, &aEtaEdges, &aPositionEdges}) {
+    file.write(reinterpret_cast<const char*>(edges->data()), sizeof(double) * edges->size());
+  }
+  file.write(reinterpret_cast<const char*>(binFirstShower.data()), sizeof(std::uint64_t) * binFirstShower.size());
+  file.write(reinterpret_cast<const char*>(showers.data()), sizeof(Shower) * showers.size());
+  for (const auto& records : binRecords) {
+    for (size_t iRecord : records) {
+      const auto& spots = aRecords[iRecord].spots;
+      file.write(reinterpret_cast<const char*>(spots.data()), sizeof(Spot) * spots.size());
+    }
+  }
+  if (!file) {
+    aError = "cannot write " + aFileName;
+    return false;
+  }
+  return true;
+}
+}
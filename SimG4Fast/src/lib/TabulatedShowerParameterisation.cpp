@@ -0,0 +1,82 @@
+#include "SimG4Fast/TabulatedShowerParameterisation.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace sim {
+IncompleteGammaTable::IncompleteGammaTable(double aMinShape, double aMaxShape, double aShapeStep, double aMaxX,
+                                           double aXStep)
+    : m_minShape(aMinShape),
+      m_shapeStep(aShapeStep),
+      m_numShapes(static_cast<size_t>(std::ceil((aMaxShape - aMinShape) / aShapeStep)) + 1),
+      m_xStep(aXStep),
+      m_numX(static_cast<size_t>(std::ceil(aMaxX / aXStep)) + 1) {
+  m_values.resize(m_numShapes * m_numX);
+  for (size_t iShape = 0; iShape < m_numShapes; ++iShape) {
+    const double shape = m_minShape + iShape * m_shapeStep;
+    for (size_t iX = 0; iX < m_numX; ++iX) {
+      m_values[iShape * m_numX + iX] = compute(shape, iX * m_xStep);
+    }
+  }
+}
+
+std::shared_ptr<const IncompleteGammaTable> IncompleteGammaTable::shared() {
+  // filled once, at the first use (thread-safe initialisation of the static)
+  static const std::shared_ptr<const IncompleteGammaTable> table = std::make_shared<const IncompleteGammaTable>();
+  return table;
+}
+
+double IncompleteGammaTable::operator()(double aShape, double aX) const {
+  if (aX <= 0) return 0;
+  const double shapeIndex = (aShape - m_minShape) / m_shapeStep;
+  if (shapeIndex < 0 || shapeIndex > m_numShapes - 1) return compute(aShape, aX);
+  const double xIndex = aX / m_xStep;
+  if (xIndex >= m_numX - 1) return 1;
+  // the last bin is interpolated from its lower edge
+  const size_t iShape = std::min(static_cast<size_t>(shapeIndex), m_numShapes - 2);
+  const size_t iX = static_cast<size_t>(xIndex);
+  const double shapeFraction = shapeIndex - iShape;
+  const double xFraction = xIndex - iX;
+  const float* lower = &m_values[iShape * m_numX + iX];
+  const float* upper = lower + m_numX;
+  return (1 - shapeFraction) * ((1 - xFraction) * lower[0] + xFraction * lower[1]) +
+         shapeFraction * ((1 - xFraction) * upper[0] + xFraction * upper[1]);
+}
+
+double IncompleteGammaTable::compute(double aShape, double aX) {
+  if (aX <= 0) return 0;
+  const double logPrefactor = aShape * std::log(aX) - aX - std::lgamma(aShape);
+  const double epsilon = std::numeric_limits<double>::epsilon();
+  if (aX < aShape + 1) {
+    // series
+    double term = 1 / aShape;
+    double sum = term;
+    for (int n = 1; n < 1000 && std::abs(term) > std::abs(sum) * epsilon; ++n) {
+      term *= aX / (aShape + n);
+      sum += term;
+    }
+    return sum * std::exp(logPrefactor);
+  }
+  // continued fraction of Q(a, x) (modified Lentz)
+  const double tiny = std::numeric_limits<double>::min() / epsilon;
+  double b = aX + 1 - aShape;
+  double c = 1 / tiny;
+  double d = 1 / b;
+  double fraction = d;
+  for (int n = 1; n < 1000; ++n) {
+    const double an = -n * (n - aShape);
+    b += 2;
+    d = an * d + b;
+    if (std::abs(d) < tiny) d = tiny;
+    c = b + an / c;
+    if (std::abs(c) < tiny) c = tiny;
+    d = 1 / d;
+    const double delta = d * c;
+    fraction *= delta;
+    if (std::abs(delta - 1) < epsilon) break;
+  }
+  return 1 - std::exp(logPrefactor) * fraction;
+}
+}
@@ -0,0 +1,92 @@
+#include "SimG4OnnxShowerInference.h"
+
+// STL
+#include <array>
+
+DECLARE_COMPONENT(SimG4OnnxShowerInference)
+
+namespace {
+/// Number of values of one entry of the batch, 0 if the shape is not (batch, size)
+size_t entrySize(const std::vector<int64_t>& aShape) {
+  if (aShape.size() != 2 || aShape[1] <= 0) {
+    return 0;
+  }
+  return aShape[1];
+}
+}
+
+SimG4OnnxShowerInference::SimG4OnnxShowerInference(const std::string& type, const std::string& name,
+                                                   const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareInterface<ISimG4ShowerInferenceTool>(this);
+}
+
+SimG4OnnxShowerInference::~SimG4OnnxShowerInference() {}
+
+StatusCode SimG4OnnxShowerInference::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  try {
+    m_env.reset(new Ort::Env(ORT_LOGGING_LEVEL_WARNING, name().c_str()));
+    Ort::SessionOptions options;
+    if (m_numThreads > 0) {
+      options.SetIntraOpNumThreads(m_numThreads);
+    }
+    m_session.reset(new Ort::Session(*m_env, m_modelFile.value().c_str(), options));
+    if (m_session->GetInputCount() != 1 || m_session->GetOutputCount() != 1) {
+      error() << "Model " << m_modelFile.value() << " needs to have one input and one output" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    Ort::AllocatorWithDefaultOptions allocator;
+    m_inputName = m_session->GetInputNameAllocated(0, allocator).get();
+    m_outputName = m_session->GetOutputNameAllocated(0, allocator).get();
+    m_inputSize = entrySize(m_session->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape());
+    m_outputSize = entrySize(m_session->GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape());
+  } catch (const Ort::Exception& e) {
+    error() << "Model " << m_modelFile.value() << " cannot be loaded: " << e.what() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_inputSize == 0 || m_outputSize == 0) {
+    error() << "Input and output of the model need to be of shape (batch, size)" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  info() << "Shower model " << m_modelFile.value() << " with " << m_inputSize << " inputs and " << m_outputSize
+         << " outputs" << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4OnnxShowerInference::finalize() {
+  m_session.reset();
+  m_env.reset();
+  return GaudiTool::finalize();
+}
+
+StatusCode SimG4OnnxShowerInference::infer(const std::vector<float>& aInput, size_t aBatchSize,
+                                           std::vector<float>& aOutput) const {
+  if (aInput.size() != aBatchSize * m_inputSize) {
+    error() << "Input of " << aInput.size() << " values for a batch of " << aBatchSize << " showers" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  aOutput.resize(aBatchSize * m_outputSize);
+  if (aBatchSize == 0) {
+    return StatusCode::SUCCESS;
+  }
+  try {
+    auto memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    const std::array<int64_t, 2> inputShape{static_cast<int64_t>(aBatchSize), static_cast<int64_t>(m_inputSize)};
+    const std::array<int64_t, 2> outputShape{static_cast<int64_t>(aBatchSize), static_cast<int64_t>(m_outputSize)};
+    // the session reads the input and writes the output in place, Run is thread safe
+    Ort::Value input = Ort::Value::CreateTensor<float>(memoryInfo, const_cast<float*>(aInput.data()), aInput.size(),
+                                                       inputShape.data(), inputShape.size());
+    Ort::Value output = Ort::Value::CreateTensor<float>(memoryInfo, aOutput.data(), aOutput.size(),
+                                                        outputShape.data(), outputShape.size());
+    const char* inputName = m_inputName.c_str();
+    const char* outputName = m_outputName.c_str();
+    m_session->Run(Ort::RunOptions{nullptr}, &inputName, &input, 1, &outputName, &output, 1);
+  } catch (const Ort::Exception& e) {
+    error() << "Inference of " << aBatchSize << " showers failed: " << e.what() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  return StatusCode::SUCCESS;
+}
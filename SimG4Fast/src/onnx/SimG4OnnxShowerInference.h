@@ -0,0 +1,68 @@
+#ifndef SIMG4FAST_SIMG4ONNXSHOWERINFERENCE_H
+#define SIMG4FAST_SIMG4ONNXSHOWERINFERENCE_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4ShowerInferenceTool.h"
+
+// ONNX Runtime
+#include "onnxruntime_cxx_api.h"
+
+// STL
+#include <memory>
+#include <string>
+
+/** @class SimG4OnnxShowerInference SimG4Fast/src/onnx/SimG4OnnxShowerInference.h SimG4OnnxShowerInference.h
+ *
+ *  Inference of a generative model of the calorimeter showers with ONNX Runtime.
+ *  The model (\b'modelFile') needs one input and one output of floats, of shape (batch, inputSize) and
+ *  (batch, outputSize); the sizes are read from the model. The session is shared by all the threads.
+ *  Built only if ONNX Runtime is found.
+ *  [For more information please see](@ref md_sim_doc_geant4fastsim).
+ */
+
+class SimG4OnnxShowerInference : public GaudiTool, virtual public ISimG4ShowerInferenceTool {
+public:
+  explicit SimG4OnnxShowerInference(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SimG4OnnxShowerInference();
+  /**  Initialize.
+   *   Create the inference session.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /// Number of inputs of one shower
+  inline virtual size_t inputSize() const final { return m_inputSize; }
+  /// Number of outputs of one shower
+  inline virtual size_t outputSize() const final { return m_outputSize; }
+  /**  Run the inference.
+   *   @param[in] aInput inputs of the showers (aBatchSize times inputSize() values)
+   *   @param[in] aBatchSize number of showers
+   *   @param[out] aOutput outputs of the showers (aBatchSize times outputSize() values)
+   *   @return status code
+   */
+  virtual StatusCode infer(const std::vector<float>& aInput, size_t aBatchSize,
+                           std::vector<float>& aOutput) const final;
+
+private:
+  /// Name of the file of the model
+  Gaudi::Property<std::string> m_modelFile{this, "modelFile", "", "Name of the ONNX file of the model"};
+  /// Number of threads used by the inference of one batch (0 for the default of ONNX Runtime)
+  Gaudi::Property<int> m_numThreads{this, "numThreads", 1, "Number of threads used by the inference of one batch"};
+  /// Environment and session of ONNX Runtime
+  std::unique_ptr<Ort::Env> m_env;
+  std::unique_ptr<Ort::Session> m_session;
+  /// Names of the input and output of the model
+  std::string m_inputName;
+  std::string m_outputName;
+  /// Sizes of the input and output of one shower
+  size_t m_inputSize = 0;
+  size_t m_outputSize = 0;
+};
+
+#endif /* SIMG4FAST_SIMG4ONNXSHOWERINFERENCE_H */
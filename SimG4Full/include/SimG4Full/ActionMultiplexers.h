@@ -0,0 +1,94 @@
+#ifndef SIMG4FULL_ACTIONMULTIPLEXERS_H
+#define SIMG4FULL_ACTIONMULTIPLEXERS_H
+
+#include "G4UserEventAction.hh"
+#include "G4UserRunAction.hh"
+#include "G4UserStackingAction.hh"
+#include "G4UserSteppingAction.hh"
+#include "G4UserTrackingAction.hh"
+
+// STL
+#include <memory>
+#include <vector>
+
+/** Multiplexers of the user actions and the collector combining the actions of several action initializations.
+ *
+ *  Each multiplexer owns its actions and calls them in the order in which they were added.
+ *  The collector reads the actions set in the run manager (of the thread) after each action initialization is built
+ *  and installs, for each hook, nothing if no action was set, the action itself if only one was set, or the
+ *  multiplexer of all of them: hooks that are not used cost nothing, and a single action is called directly.
+ */
+namespace sim {
+class MultiRunAction : public G4UserRunAction {
+public:
+  void add(G4UserRunAction* aAction) { m_actions.emplace_back(aAction); }
+  /// Run of the first action that creates one
+  virtual G4Run* GenerateRun() final;
+  virtual void BeginOfRunAction(const G4Run* aRun) final;
+  virtual void EndOfRunAction(const G4Run* aRun) final;
+
+private:
+  std::vector<std::unique_ptr<G4UserRunAction>> m_actions;
+};
+
+class MultiEventAction : public G4UserEventAction {
+public:
+  void add(G4UserEventAction* aAction) { m_actions.emplace_back(aAction); }
+  virtual void SetEventManager(G4EventManager* aManager) final;
+  virtual void BeginOfEventAction(const G4Event* aEvent) final;
+  virtual void EndOfEventAction(const G4Event* aEvent) final;
+
+private:
+  std::vector<std::unique_ptr<G4UserEventAction>> m_actions;
+};
+
+class MultiTrackingAction : public G4UserTrackingAction {
+public:
+  void add(G4UserTrackingAction* aAction) { m_actions.emplace_back(aAction); }
+  virtual void SetTrackingManagerPointer(G4TrackingManager* aManager) final;
+  virtual void PreUserTrackingAction(const G4Track* aTrack) final;
+  virtual void PostUserTrackingAction(const G4Track* aTrack) final;
+
+private:
+  std::vector<std::unique_ptr<G4UserTrackingAction>> m_actions;
+};
+
+class MultiSteppingAction : public G4UserSteppingAction {
+public:
+  void add(G4UserSteppingAction* aAction) { m_actions.emplace_back(aAction); }
+  virtual void SetSteppingManagerPointer(G4SteppingManager* aManager) final;
+  virtual void UserSteppingAction(const G4Step* aStep) final;
+
+private:
+  std::vector<std::unique_ptr<G4UserSteppingAction>> m_actions;
+};
+
+/// The track is killed if any action kills it, otherwise it gets the first classification other than urgent
+class MultiStackingAction : public G4UserStackingAction {
+public:
+  void add(G4UserStackingAction* aAction) { m_actions.emplace_back(aAction); }
+  virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* aTrack) final;
+  virtual void NewStage() final;
+  virtual void PrepareNewEvent() final;
+
+private:
+  std::vector<std::unique_ptr<G4UserStackingAction>> m_actions;
+};
+
+class ActionCollector {
+public:
+  /// Collect the actions set in the run manager by the last built action initialization
+  void collect();
+  /// Install the collected actions in the run manager
+  void install();
+
+private:
+  std::vector<G4UserRunAction*> m_runActions;
+  std::vector<G4UserEventAction*> m_eventActions;
+  std::vector<G4UserTrackingAction*> m_trackingActions;
+  std::vector<G4UserSteppingAction*> m_steppingActions;
+  std::vector<G4UserStackingAction*> m_stackingActions;
+};
+}
+
+#endif /* SIMG4FULL_ACTIONMULTIPLEXERS_H */
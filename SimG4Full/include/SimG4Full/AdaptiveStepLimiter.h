@@ -0,0 +1,79 @@
+#ifndef SIMG4FULL_ADAPTIVESTEPLIMITER_H
+#define SIMG4FULL_ADAPTIVESTEPLIMITER_H
+
+// Geant
+#include "G4ParticleChange.hh"
+#include "G4VPhysicsConstructor.hh"
+#include "G4VProcess.hh"
+#include "G4VUserRegionInformation.hh"
+class G4Region;
+
+// STL
+#include <set>
+
+/** @class AdaptiveStepLimiter SimG4Full/SimG4Full/AdaptiveStepLimiter.h AdaptiveStepLimiter.h
+ *
+ *  Step limiter process whose maximum step depends on the particle type, momentum and velocity of the track, e.g.
+ *  fine steps for the slow tracks, whose ionisation clusters need to be resolved, and coarse steps for the fast ones.
+ *  The limits are given by the StepLimitPolicy attached to the region (as its user information), the steps in the
+ *  regions without a policy are not limited. The process is added to the charged particles by
+ *  AdaptiveStepLimiterPhysics.
+ */
+namespace sim {
+/// Step limits of a region
+class StepLimitPolicy : public G4VUserRegionInformation {
+public:
+  /// PDG codes of the particles whose steps are limited (all charged particles if empty)
+  std::set<int> pdgCodes;
+  /// Maximum step of the slow tracks: below the momentum or below the velocity (0: no limit)
+  double fineStep = 0;
+  /// Maximum momentum of the slow tracks (0: not used)
+  double fineMaxMomentum = 0;
+  /// Maximum velocity (v/c) of the slow tracks (0: not used)
+  double fineMaxBeta = 0;
+  /// Maximum step of the other tracks (0: no limit)
+  double coarseStep = 0;
+  /** Maximum step of the track.
+   *  @param[in] aTrack track
+   *  @returns maximum step (DBL_MAX if not limited)
+   */
+  double maxStep(const G4Track& aTrack) const;
+  virtual void Print() const final;
+};
+
+class AdaptiveStepLimiter : public G4VProcess {
+public:
+  explicit AdaptiveStepLimiter(const G4String& aName = "adaptiveStepLimiter");
+  virtual ~AdaptiveStepLimiter() = default;
+  /// Maximum step given by the policy of the region of the track
+  virtual G4double PostStepGetPhysicalInteractionLength(const G4Track& aTrack, G4double aPreviousStepSize,
+                                                        G4ForceCondition* aCondition) final;
+  /// Nothing is changed when the step is limited
+  virtual G4VParticleChange* PostStepDoIt(const G4Track& aTrack, const G4Step& aStep) final;
+  virtual G4double AtRestGetPhysicalInteractionLength(const G4Track&, G4ForceCondition*) final { return -1; }
+  virtual G4double AlongStepGetPhysicalInteractionLength(const G4Track&, G4double, G4double, G4double&,
+                                                         G4GPILSelection*) final {
+    return -1;
+  }
+  virtual G4VParticleChange* AtRestDoIt(const G4Track&, const G4Step&) final { return nullptr; }
+  virtual G4VParticleChange* AlongStepDoIt(const G4Track&, const G4Step&) final { return nullptr; }
+
+private:
+  /// Region of the previous step and its policy (regions rarely change between the steps)
+  const G4Region* m_region = nullptr;
+  const StepLimitPolicy* m_policy = nullptr;
+  /// Particle change (empty)
+  G4ParticleChange m_particleChange;
+};
+
+/// Physics constructor adding the AdaptiveStepLimiter to all the charged particles
+class AdaptiveStepLimiterPhysics : public G4VPhysicsConstructor {
+public:
+  explicit AdaptiveStepLimiterPhysics(const G4String& aName = "adaptiveStepLimiter");
+  virtual ~AdaptiveStepLimiterPhysics() = default;
+  virtual void ConstructParticle() final {}
+  virtual void ConstructProcess() final;
+};
+}
+
+#endif /* SIMG4FULL_ADAPTIVESTEPLIMITER_H */
@@ -0,0 +1,79 @@
+#ifndef SIMG4FULL_FIELDSTATISTICS_H
+#define SIMG4FULL_FIELDSTATISTICS_H
+
+// FCCSW
+#include "SimG4Common/FieldCounters.h"
+
+// STL
+#include <map>
+#include <mutex>
+#include <string>
+
+/** @class FieldStatistics SimG4Full/SimG4Full/FieldStatistics.h FieldStatistics.h
+ *
+ *  Cost of the propagation in the magnetic field, per region and per event: steps, field evaluations, integration
+ *  steps, trial chords, rejected integration steps (sim::FieldCounters of the field tool) and looping particles
+ *  killed by the transportation, with the kinetic energy they carried (also per particle type).
+ *  Filled at the end of the run by each thread (FieldStatisticsAction), hence merging is thread-safe.
+ */
+namespace sim {
+class FieldStatistics {
+public:
+  /// Accumulated quantities
+  struct Entry {
+    /// Number of steps
+    unsigned long steps = 0;
+    /// Field evaluations and integration of the steps
+    FieldCounters counters;
+    /// Number of looping particles killed
+    unsigned long loopers = 0;
+    /// Kinetic energy of the looping particles killed
+    double looperEnergy = 0;
+    void add(const Entry& aOther) {
+      steps += aOther.steps;
+      counters += aOther.counters;
+      loopers += aOther.loopers;
+      looperEnergy += aOther.looperEnergy;
+    }
+  };
+  /// Distribution over the events
+  struct Events {
+    /// Number of events
+    unsigned long events = 0;
+    /// Sum over the events
+    Entry sum;
+    /// Maximum in an event (of each quantity)
+    Entry max;
+    /// Add an event
+    void add(const Entry& aEvent);
+    /// Merge the events of another thread
+    void merge(const Events& aOther);
+  };
+  /// Table of the accumulated quantities, by name of the region
+  typedef std::map<std::string, Entry> Table;
+  /** Merge the statistics of one thread.
+   *  @param[in] aRegions entries per region
+   *  @param[in] aLoopers loopers killed per particle name
+   *  @param[in] aEvents distribution over the events
+   */
+  void merge(const Table& aRegions, const Table& aLoopers, const Events& aEvents);
+  /// Entries per region
+  Table regions() const;
+  /// Loopers killed per particle name
+  Table loopers() const;
+  /// Distribution over the events
+  Events events() const;
+
+private:
+  /// Entries per region
+  Table m_regions;
+  /// Loopers killed per particle name
+  Table m_loopers;
+  /// Distribution over the events
+  Events m_events;
+  /// Mutex guarding the statistics
+  mutable std::mutex m_mutex;
+};
+}
+
+#endif /* SIMG4FULL_FIELDSTATISTICS_H */
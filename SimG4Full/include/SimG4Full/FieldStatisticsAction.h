@@ -0,0 +1,114 @@
+#ifndef SIMG4FULL_FIELDSTATISTICSACTION_H
+#define SIMG4FULL_FIELDSTATISTICSACTION_H
+
+#include "G4UserEventAction.hh"
+#include "G4UserRunAction.hh"
+#include "G4UserSteppingAction.hh"
+#include "G4UserTrackingAction.hh"
+
+// FCCSW
+#include "SimG4Full/FieldStatistics.h"
+
+// STL
+#include <memory>
+#include <unordered_map>
+
+class G4ParticleDefinition;
+class G4Region;
+
+/** @class FieldStatisticsAction SimG4Full/SimG4Full/FieldStatisticsAction.h FieldStatisticsAction.h
+ *
+ *  User stepping action that attributes the field evaluations and the integration steps of the thread
+ *  (sim::FieldSetup::threadCounters, counted if CountPropagation of the field tool is set) to the region of the step,
+ *  and counts the looping particles killed by the transportation, with their kinetic energy, per region and per
+ *  particle type.
+ *  The counters of the event are closed by FieldStatisticsEventAction, the tables are merged into the shared
+ *  statistics at the end of the run by FieldStatisticsRunAction.
+ */
+namespace sim {
+class FieldStatisticsAction : public G4UserSteppingAction {
+public:
+  /** Constructor.
+   *  @param[in] aStatistics statistics to which the tables are merged at the end of the run
+   */
+  explicit FieldStatisticsAction(std::shared_ptr<FieldStatistics> aStatistics);
+  virtual ~FieldStatisticsAction() = default;
+  /// Attribute the propagation of the step to its region
+  virtual void UserSteppingAction(const G4Step* aStep) final;
+  /// Start the event
+  void beginEvent();
+  /// Add the event to the distribution over the events
+  void endEvent();
+  /// Merge the tables into the shared statistics and reset them
+  void merge();
+
+private:
+  /// Current counters of the thread (zero if not counted)
+  static FieldCounters threadCounters();
+  /// Shared statistics
+  std::shared_ptr<FieldStatistics> m_statistics;
+  /// Counters of the thread after the previous step
+  FieldCounters m_lastCounters;
+  /// Entries per region
+  std::unordered_map<const G4Region*, FieldStatistics::Entry> m_regions;
+  /// Loopers killed per particle type
+  std::unordered_map<const G4ParticleDefinition*, FieldStatistics::Entry> m_loopers;
+  /// Entry of the current event
+  FieldStatistics::Entry m_event;
+  /// Distribution over the events of the thread
+  FieldStatistics::Events m_events;
+};
+
+/** @class FieldStatisticsEventAction SimG4Full/SimG4Full/FieldStatisticsAction.h FieldStatisticsAction.h
+ *
+ *  User event action that starts and closes the event of the FieldStatisticsAction of the same thread.
+ */
+class FieldStatisticsEventAction : public G4UserEventAction {
+public:
+  /** Constructor.
+   *  @param[in] aAction stepping action of the thread (not owned)
+   */
+  FieldStatisticsEventAction(FieldStatisticsAction* aAction) : m_action(aAction) {}
+  virtual ~FieldStatisticsEventAction() = default;
+  virtual void BeginOfEventAction(const G4Event*) final { m_action->beginEvent(); }
+  virtual void EndOfEventAction(const G4Event*) final { m_action->endEvent(); }
+
+private:
+  /// Stepping action of the thread
+  FieldStatisticsAction* m_action;
+};
+
+/** @class FieldStatisticsTrackingAction SimG4Full/SimG4Full/FieldStatisticsAction.h FieldStatisticsAction.h
+ *
+ *  User tracking action that sets the thresholds of the looping particles of the field tool for the particle of each
+ *  track, if the physics list shares the transportation between particles with different thresholds
+ *  (sim::FieldSetup::startTrack).
+ */
+class FieldStatisticsTrackingAction : public G4UserTrackingAction {
+public:
+  FieldStatisticsTrackingAction() = default;
+  virtual ~FieldStatisticsTrackingAction() = default;
+  virtual void PreUserTrackingAction(const G4Track* aTrack) final;
+};
+
+/** @class FieldStatisticsRunAction SimG4Full/SimG4Full/FieldStatisticsAction.h FieldStatisticsAction.h
+ *
+ *  User run action that merges the tables of the FieldStatisticsAction of the same thread at the end of the run.
+ */
+class FieldStatisticsRunAction : public G4UserRunAction {
+public:
+  /** Constructor.
+   *  @param[in] aAction stepping action of the thread (not owned)
+   */
+  FieldStatisticsRunAction(FieldStatisticsAction* aAction) : m_action(aAction) {}
+  virtual ~FieldStatisticsRunAction() = default;
+  /// Merge the tables of the stepping action
+  virtual void EndOfRunAction(const G4Run*) final { m_action->merge(); }
+
+private:
+  /// Stepping action of the thread
+  FieldStatisticsAction* m_action;
+};
+}
+
+#endif /* SIMG4FULL_FIELDSTATISTICSACTION_H */
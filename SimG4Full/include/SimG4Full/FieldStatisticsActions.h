@@ -0,0 +1,35 @@
+#ifndef SIMG4FULL_FIELDSTATISTICSACTIONS_H
+#define SIMG4FULL_FIELDSTATISTICSACTIONS_H
+
+#include "G4VUserActionInitialization.hh"
+
+// FCCSW
+#include "SimG4Full/FieldStatistics.h"
+
+// STL
+#include <memory>
+
+/** @class FieldStatisticsActions SimG4Full/SimG4Full/FieldStatisticsActions.h FieldStatisticsActions.h
+ *
+ *  User action initialization of the statistics of the propagation in the field (FieldStatisticsAction,
+ *  FieldStatisticsEventAction, FieldStatisticsRunAction and FieldStatisticsTrackingAction, created for each thread).
+ *  Only these actions are created, they are meant to be chained to FullSimActions.
+ */
+namespace sim {
+class FieldStatisticsActions : public G4VUserActionInitialization {
+public:
+  /** Constructor.
+   *  @param[in] aStatistics statistics filled by the actions
+   */
+  explicit FieldStatisticsActions(std::shared_ptr<FieldStatistics> aStatistics);
+  virtual ~FieldStatisticsActions() = default;
+  /// Create all user actions.
+  virtual void Build() const final;
+
+private:
+  /// Statistics filled by the actions
+  std::shared_ptr<FieldStatistics> m_statistics;
+};
+}
+
+#endif /* SIMG4FULL_FIELDSTATISTICSACTIONS_H */
@@ -3,9 +3,18 @@
 
 #include "G4VUserActionInitialization.hh"
 
+// FCCSW
+#include "SimG4Full/ParticleHistoryAction.h"
+
+// STL
+#include <memory>
+#include <vector>
+
 /** @class FullSimActions SimG4Full/SimG4Full/FullSimActions.h FullSimActions.h
  *
  *  User action initialization for full simulation.
+ *  Other action initializations may be chained: their actions are combined with the full simulation actions, hook by
+ *  hook, in multiplexers (see ActionCollector).
  *
  *  @author A. Zaborowska
  *  @author J. Lingemann (adding particle history)
@@ -14,16 +23,28 @@
 namespace sim {
 class FullSimActions : public G4VUserActionInitialization {
 public:
-  FullSimActions(bool enableHistory, double aEnergyCut);
+  FullSimActions(bool enableHistory, const ParticleHistorySelection& aSelection, bool aCountSteps = false);
   virtual ~FullSimActions();
   /// Create all user actions.
   virtual void Build() const final;
+  /// Create the run actions of the chained action initializations for the master thread.
+  virtual void BuildForMaster() const final;
+  /** Chain an action initialization.
+   *  @param[in] aActions action initialization (ownership is transferred)
+   */
+  void chain(G4VUserActionInitialization* aActions) { m_chained.emplace_back(aActions); }
 
 private:
+  /// Create the full simulation actions
+  void buildFullSimActions() const;
   /// Flag whether or not to store particle history
   bool m_enableHistory;
-  /// energy threshold for secondaries to be saved
-  double m_energyCut;
+  /// selection of the particles saved in the history
+  ParticleHistorySelection m_selection;
+  /// Flag whether or not to count tracks and steps of the event
+  bool m_countSteps;
+  /// Chained action initializations
+  std::vector<std::unique_ptr<G4VUserActionInitialization>> m_chained;
 };
 }
 
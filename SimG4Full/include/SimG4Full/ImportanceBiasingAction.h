@@ -0,0 +1,69 @@
+#ifndef SIMG4FULL_IMPORTANCEBIASINGACTION_H
+#define SIMG4FULL_IMPORTANCEBIASINGACTION_H
+
+#include "G4UserSteppingAction.hh"
+
+// STL
+#include <atomic>
+#include <memory>
+#include <set>
+#include <unordered_map>
+
+class G4Region;
+
+/** @class ImportanceBiasingAction SimG4Full/SimG4Full/ImportanceBiasingAction.h ImportanceBiasingAction.h
+ *
+ *  Regional stepping action biasing the tracks by the importance of the regions (geometry importance biasing):
+ *  when a track of the selected particle types crosses into a region of higher importance it is split into copies
+ *  (as many as the ratio of the importances on average, at most the maximum), and into a region of lower importance
+ *  it plays the Russian roulette (it survives with the probability given by the ratio). The weights of the tracks
+ *  are changed so that the results stay unbiased; the sensitive detectors writing hit buffers (SimG4HitBufferSD)
+ *  record the weight of the track with each deposit, from which the save tools weight the hits. The secondaries of
+ *  a weighted track inherit its weight.
+ *  The regions without importance have the importance 1. The regional action that was set in the region before may
+ *  be chained (it is called first).
+ */
+namespace sim {
+/// Numbers of the biased tracks of the job
+struct ImportanceBiasingCounts {
+  /// Number of the splittings and of the copies created
+  std::atomic<unsigned long> splittings{0};
+  std::atomic<unsigned long> copies{0};
+  /// Number of the tracks that played the Russian roulette, and that were killed by it
+  std::atomic<unsigned long> roulettes{0};
+  std::atomic<unsigned long> killed{0};
+};
+
+class ImportanceBiasingAction : public G4UserSteppingAction {
+public:
+  /** Constructor.
+   *  @param[in] aImportances importance of the regions (1 for the others)
+   *  @param[in] aPdgCodes PDG codes of the biased particles (all if empty)
+   *  @param[in] aMaxSplit maximum number of tracks a track is split into
+   *  @param[in] aCounts numbers of the job (filled by the action)
+   *  @param[in] aChained regional action called before this one (not owned, may be null)
+   */
+  ImportanceBiasingAction(std::shared_ptr<const std::unordered_map<const G4Region*, double>> aImportances,
+                          const std::set<int>& aPdgCodes, unsigned int aMaxSplit,
+                          std::shared_ptr<ImportanceBiasingCounts> aCounts, G4UserSteppingAction* aChained = nullptr);
+  virtual ~ImportanceBiasingAction() = default;
+  /// Split the track or play the Russian roulette when it crosses into a region of another importance
+  virtual void UserSteppingAction(const G4Step* aStep) final;
+
+private:
+  /// Importance of the region
+  double importance(const G4Region* aRegion) const;
+  /// Importance of the regions
+  std::shared_ptr<const std::unordered_map<const G4Region*, double>> m_importances;
+  /// PDG codes of the biased particles
+  std::set<int> m_pdgCodes;
+  /// Maximum number of tracks a track is split into
+  unsigned int m_maxSplit;
+  /// Numbers of the job
+  std::shared_ptr<ImportanceBiasingCounts> m_counts;
+  /// Regional action called before this one
+  G4UserSteppingAction* m_chained;
+};
+}
+
+#endif /* SIMG4FULL_IMPORTANCEBIASINGACTION_H */
@@ -3,6 +3,10 @@
 
 #include "G4UserTrackingAction.hh"
 
+// STL
+#include <string>
+#include <vector>
+
 /** @class ParticleHistoryAction SimG4Full/SimG4Full/ParticleHistoryAction.h ParticleHistoryAction.h
  *
  *  User tracking action that stores particle history
@@ -14,24 +18,43 @@
  */
 
 namespace sim {
+/** Selection of the particles saved in the history.
+ *  A particle is saved if it passes all the criteria, empty lists do not restrict the selection. The regions and the
+ *  volumes are alternatives: the particle needs to be created in one of the regions or in one of the volumes.
+ *  Criteria on the creator process apply to the secondaries only.
+ */
+struct ParticleHistorySelection {
+  /// energy threshold for secondaries to be saved
+  double energyCut = 0;
+  /// PDG codes of the saved particles
+  std::vector<int> pdgCodes;
+  /// Names of the processes that created the saved particles
+  std::vector<std::string> processes;
+  /// Names of the regions in which the saved particles were created
+  std::vector<std::string> regions;
+  /// Names of the logical volumes in which the saved particles were created
+  std::vector<std::string> volumes;
+  /// Flag whether the ancestors of the saved particles should be saved too (even if not selected)
+  bool keepAncestors = false;
+};
+
 class ParticleHistoryAction : public G4UserTrackingAction {
 public:
-  ParticleHistoryAction(double energyCut);
+  ParticleHistoryAction(const ParticleHistorySelection& aSelection);
   virtual ~ParticleHistoryAction() = default;
 
-  /// empty action - particles are only saved at the end of track
+  /// particles are recorded here, before geant4 simulates the track
   void PreUserTrackingAction(const G4Track* aTrack);
-  /// particles are saved here, after geant4 is done simulating the track
+  /// the ancestors kept for the descendants (keepAncestors) are dropped once no descendant is left to be tracked
   void PostUserTrackingAction(const G4Track* aTrack);
 
-  /** Simple filter for particles to be saved, based on their energy.
+  /** Filter for particles to be saved, based on their energy, type and origin.
    * @param[in] aTrack track of the particle to be saved
-   * @param[in] aEnergyCut energy threshold above which particles are saved
    */
-  bool selectSecondary(const G4Track& aTrack, double aEnergyCut);
+  bool selectSecondary(const G4Track& aTrack) const;
 private:
-  /// energy threshold for secondaries to be saved
-  double m_energyCut;
+  /// selection of the saved particles
+  ParticleHistorySelection m_selection;
 };
 }
 
@@ -18,9 +18,13 @@ public:
 
   /// EventInformation data structure is created here
   virtual void  BeginOfEventAction ( const G4Event *anEvent);
-  /// empty action 
+  /// Number of particles of the history is kept to reserve the space in the next event
   virtual void  EndOfEventAction (const G4Event *anEvent);
 
+private:
+  /// Number of particles saved in the previous event
+  size_t m_numParticles = 0;
+
 };
 }
 
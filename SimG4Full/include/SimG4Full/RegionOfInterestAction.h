@@ -0,0 +1,97 @@
+#ifndef SIMG4FULL_REGIONOFINTERESTACTION_H
+#define SIMG4FULL_REGIONOFINTERESTACTION_H
+
+#include "G4UserStackingAction.hh"
+#include "G4UserSteppingAction.hh"
+
+// STL
+#include <atomic>
+#include <cfloat>
+#include <memory>
+#include <set>
+
+/** @class RegionOfInterestStackingAction SimG4Full/SimG4Full/RegionOfInterestAction.h RegionOfInterestAction.h
+ *
+ *  User actions that restrict the simulation to a region of interest: the cones in pseudorapidity and azimuth (seen
+ *  from the origin) around the directions of the seed primaries of the event (e.g. the signal particles).
+ *  The cones are defined when the first primary of the event is classified, and stored with the numbers of killed
+ *  tracks in the EventInformation of the event (which needs to be created by ParticleHistoryEventAction).
+ *  Tracks further from the origin than the minimum radius, and below the energy threshold, are killed:
+ *  a) the secondaries created outside of the cones, by the stacking action, before they are tracked;
+ *  b) the tracks leaving the cones, by the stepping action (RegionOfInterestSteppingAction).
+ *  Events without a seed primary are simulated entirely. The numbers are also summed in RegionOfInterestCounts,
+ *  shared by the actions of all the threads.
+ */
+namespace sim {
+/// Definition of the region of interest and of the killed tracks
+struct RegionOfInterestSelection {
+  /// PDG codes of the primaries defining the cones (all if empty)
+  std::set<int> seedPdgCodes;
+  /// minimum momentum of the primaries defining the cones
+  double minSeedMomentum = 0;
+  /// radius of the cones in the pseudorapidity-azimuth plane
+  double deltaR = 0.4;
+  /// minimum distance from the origin of the killed tracks
+  double minRadius = 0;
+  /// maximum kinetic energy of the killed tracks
+  double killMaxEnergy = DBL_MAX;
+};
+
+/// Numbers of the events, cones and killed tracks of the job
+struct RegionOfInterestCounts {
+  std::atomic<unsigned long> events{0};
+  std::atomic<unsigned long> eventsWithoutSeed{0};
+  std::atomic<unsigned long> cones{0};
+  std::atomic<unsigned long> killedAtCreation{0};
+  std::atomic<unsigned long> killedLeaving{0};
+};
+
+class RegionOfInterestStackingAction : public G4UserStackingAction {
+public:
+  /** Constructor.
+   *  @param[in] aSelection definition of the region of interest
+   *  @param[in] aCounts numbers of the job (filled)
+   */
+  RegionOfInterestStackingAction(const RegionOfInterestSelection& aSelection,
+                                 std::shared_ptr<RegionOfInterestCounts> aCounts);
+  virtual ~RegionOfInterestStackingAction() = default;
+  /// Define the cones at the first primary of the event, kill the secondaries created outside of them
+  virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* aTrack) final;
+
+private:
+  /// Definition of the region of interest
+  RegionOfInterestSelection m_selection;
+  /// Numbers of the job
+  std::shared_ptr<RegionOfInterestCounts> m_counts;
+};
+
+/** @class RegionOfInterestSteppingAction SimG4Full/SimG4Full/RegionOfInterestAction.h RegionOfInterestAction.h
+ *
+ *  User stepping action that kills the tracks leaving the region of interest of the event
+ *  (defined by RegionOfInterestStackingAction). It may also count the tracks and steps in the EventInformation, as
+ *  StepCountingAction does.
+ */
+class RegionOfInterestSteppingAction : public G4UserSteppingAction {
+public:
+  /** Constructor.
+   *  @param[in] aSelection definition of the region of interest
+   *  @param[in] aCounts numbers of the job (filled)
+   *  @param[in] aCountSteps flag whether or not to count tracks and steps of the event
+   */
+  RegionOfInterestSteppingAction(const RegionOfInterestSelection& aSelection,
+                                 std::shared_ptr<RegionOfInterestCounts> aCounts, bool aCountSteps = false);
+  virtual ~RegionOfInterestSteppingAction() = default;
+  /// Kill the track if its post-step point is outside of the cones
+  virtual void UserSteppingAction(const G4Step* aStep) final;
+
+private:
+  /// Definition of the region of interest
+  RegionOfInterestSelection m_selection;
+  /// Numbers of the job
+  std::shared_ptr<RegionOfInterestCounts> m_counts;
+  /// Flag whether or not to count tracks and steps of the event
+  bool m_countSteps;
+};
+}
+
+#endif /* SIMG4FULL_REGIONOFINTERESTACTION_H */
@@ -0,0 +1,52 @@
+#ifndef SIMG4FULL_REGIONOFINTERESTACTIONS_H
+#define SIMG4FULL_REGIONOFINTERESTACTIONS_H
+
+#include "G4VUserActionInitialization.hh"
+
+// FCCSW
+#include "SimG4Full/FullSimActions.h"
+#include "SimG4Full/RegionOfInterestAction.h"
+
+// STL
+#include <memory>
+
+/** @class RegionOfInterestActions SimG4Full/SimG4Full/RegionOfInterestActions.h RegionOfInterestActions.h
+ *
+ *  User action initialization for full simulation restricted to the region of interest
+ *  (RegionOfInterestStackingAction and RegionOfInterestSteppingAction, created for each thread),
+ *  in addition to the actions of FullSimActions. The EventInformation holding the region of interest is created by
+ *  ParticleHistoryEventAction, also if the history is not enabled. The steps are counted by the stepping action of the
+ *  region of interest, which replaces StepCountingAction.
+ */
+namespace sim {
+class RegionOfInterestActions : public G4VUserActionInitialization {
+public:
+  /** Constructor.
+   *  @param[in] aRegionSelection definition of the region of interest
+   *  @param[in] aCounts numbers of the job (filled by the actions)
+   *  @param[in] enableHistory flag whether or not to store particle history
+   *  @param[in] aSelection selection of the particles saved in the history
+   *  @param[in] aCountSteps flag whether or not to count tracks and steps of the event
+   */
+  RegionOfInterestActions(const RegionOfInterestSelection& aRegionSelection,
+                          std::shared_ptr<RegionOfInterestCounts> aCounts, bool enableHistory,
+                          const ParticleHistorySelection& aSelection, bool aCountSteps);
+  virtual ~RegionOfInterestActions() = default;
+  /// Create all user actions.
+  virtual void Build() const final;
+
+private:
+  /// Actions of the full simulation
+  FullSimActions m_fullSimActions;
+  /// Flag whether the full simulation actions store the particle history (and create the EventInformation)
+  bool m_enableHistory;
+  /// Flag whether or not to count tracks and steps of the event
+  bool m_countSteps;
+  /// Definition of the region of interest
+  RegionOfInterestSelection m_regionSelection;
+  /// Numbers of the job
+  std::shared_ptr<RegionOfInterestCounts> m_counts;
+};
+}
+
+#endif /* SIMG4FULL_REGIONOFINTERESTACTIONS_H */
@@ -0,0 +1,106 @@
+#ifndef SIMG4FULL_SCORINGACTION_H
+#define SIMG4FULL_SCORINGACTION_H
+
+#include "G4UserEventAction.hh"
+#include "G4UserRunAction.hh"
+#include "G4UserSteppingAction.hh"
+
+// FCCSW
+#include "SimG4Full/ScoringMesh.h"
+
+// STL
+#include <memory>
+#include <set>
+#include <vector>
+
+/** @class ScoringAction SimG4Full/SimG4Full/ScoringAction.h ScoringAction.h
+ *
+ *  User stepping action scoring the radiation in a mesh: the ionising dose (deposited energy over the mass of the
+ *  bin, with the density of the material of the step) and the fluence (track length over the volume of the bin),
+ *  optionally weighted by the damage function of the particle at the kinetic energy of the pre-step point.
+ *  Steps longer than the maximum segment length are split, so that each part is scored in its bin.
+ *  The event is closed by ScoringEventAction (sums and sums of squares over the events), the sums are merged into
+ *  the shared mesh at the end of the run by ScoringRunAction.
+ */
+namespace sim {
+/// Selection of the scored particles
+struct ScoringSelection {
+  /// PDG codes of the particles of the fluence (all if empty)
+  std::set<int> fluencePdgCodes;
+  /// Damage functions of the damage-weighted fluence
+  DamageFunction damage;
+  /// Maximum length of the parts of the steps
+  double maxSegment = 0;
+  /// Maximum number of parts of a step
+  unsigned int maxSegments = 1000;
+};
+
+class ScoringAction : public G4UserSteppingAction {
+public:
+  /** Constructor.
+   *  @param[in] aMesh mesh to which the sums are merged at the end of the run
+   *  @param[in] aSelection selection of the scored particles
+   */
+  ScoringAction(std::shared_ptr<ScoringMesh> aMesh, const ScoringSelection& aSelection);
+  virtual ~ScoringAction() = default;
+  /// Score the step
+  virtual void UserSteppingAction(const G4Step* aStep) final;
+  /// Add the event to the sums
+  void endEvent();
+  /// Merge the sums into the shared mesh and reset them
+  void merge();
+
+private:
+  /// Add to the quantity of the bin in the current event
+  inline void add(int aQuantity, long aBin, double aValue);
+  /// Shared mesh
+  std::shared_ptr<ScoringMesh> m_mesh;
+  /// Selection of the scored particles
+  ScoringSelection m_selection;
+  /// Quantities of the current event, by quantity and bin
+  std::vector<double> m_event;
+  /// Entries of the current event that are not zero
+  std::vector<size_t> m_touched;
+  /// Sums of the thread
+  ScoringMesh::Sums m_sums;
+};
+
+/** @class ScoringEventAction SimG4Full/SimG4Full/ScoringAction.h ScoringAction.h
+ *
+ *  User event action that closes the event of the ScoringAction of the same thread.
+ */
+class ScoringEventAction : public G4UserEventAction {
+public:
+  /** Constructor.
+   *  @param[in] aAction stepping action of the thread (not owned)
+   */
+  ScoringEventAction(ScoringAction* aAction) : m_action(aAction) {}
+  virtual ~ScoringEventAction() = default;
+  virtual void EndOfEventAction(const G4Event*) final { m_action->endEvent(); }
+
+private:
+  /// Stepping action of the thread
+  ScoringAction* m_action;
+};
+
+/** @class ScoringRunAction SimG4Full/SimG4Full/ScoringAction.h ScoringAction.h
+ *
+ *  User run action that merges the sums of the ScoringAction of the same thread at the end of the run.
+ */
+class ScoringRunAction : public G4UserRunAction {
+public:
+  /** Constructor.
+   *  @param[in] aAction stepping action of the thread (not owned)
+   */
+  ScoringRunAction(ScoringAction* aAction) : m_action(aAction) {}
+  virtual ~ScoringRunAction() = default;
+  /// Merge the sums of the stepping action
+  virtual void EndOfRunAction(const G4Run*) final { m_action->merge(); }
+
+private:
+  /// Stepping action of the thread
+  ScoringAction* m_action;
+};
+}
+
+#endif /* SIMG4FULL_SCORINGACTION_H */
@@ -0,0 +1,38 @@
+#ifndef SIMG4FULL_SCORINGACTIONS_H
+#define SIMG4FULL_SCORINGACTIONS_H
+
+#include "G4VUserActionInitialization.hh"
+
+// FCCSW
+#include "SimG4Full/ScoringAction.h"
+
+// STL
+#include <memory>
+
+/** @class ScoringActions SimG4Full/SimG4Full/ScoringActions.h ScoringActions.h
+ *
+ *  User action initialization of the scoring of the radiation in a mesh (ScoringAction, ScoringEventAction and
+ *  ScoringRunAction, created for each thread).
+ *  Only these actions are created, they are meant to be chained to FullSimActions.
+ */
+namespace sim {
+class ScoringActions : public G4VUserActionInitialization {
+public:
+  /** Constructor.
+   *  @param[in] aMesh mesh filled by the actions
+   *  @param[in] aSelection selection of the scored particles
+   */
+  ScoringActions(std::shared_ptr<ScoringMesh> aMesh, const ScoringSelection& aSelection);
+  virtual ~ScoringActions() = default;
+  /// Create all user actions.
+  virtual void Build() const final;
+
+private:
+  /// Mesh filled by the actions
+  std::shared_ptr<ScoringMesh> m_mesh;
+  /// Selection of the scored particles
+  ScoringSelection m_selection;
+};
+}
+
+#endif /* SIMG4FULL_SCORINGACTIONS_H */
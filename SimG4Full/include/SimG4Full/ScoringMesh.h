@@ -0,0 +1,115 @@
+#ifndef SIMG4FULL_SCORINGMESH_H
+#define SIMG4FULL_SCORINGMESH_H
+
+// Geant4
+#include "G4ThreeVector.hh"
+
+// STL
+#include <array>
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+
+/** @class ScoringMesh SimG4Full/SimG4Full/ScoringMesh.h ScoringMesh.h
+ *
+ *  Mesh of the scoring of the radiation: a cylindrical (r, phi, z) or Cartesian (x, y, z) grid of bins in the
+ *  global frame, in which the ionising dose, the fluence and the damage-weighted (1 MeV neutron equivalent) fluence
+ *  are accumulated. Each thread fills its own sums (ScoringAction), merged into the mesh at the end of the run,
+ *  hence merging is thread-safe.
+ */
+namespace sim {
+/// Damage functions (displacement damage relative to 1 MeV neutrons), by PDG code
+class DamageFunction {
+public:
+  /** Set the damage function of a particle type.
+   *  @param[in] aPdgCode PDG code of the particle
+   *  @param[in] aEnergies kinetic energies of the table (Geant units), in increasing order
+   *  @param[in] aFactors damage factors at these energies
+   */
+  void set(int aPdgCode, const std::vector<double>& aEnergies, const std::vector<double>& aFactors);
+  /// Damage factor of the particle at the kinetic energy (log-log interpolation, 0 for other particles)
+  double factor(int aPdgCode, double aEnergy) const;
+  /// Check if no damage function is given
+  bool empty() const { return m_tables.empty(); }
+
+private:
+  /// Logarithms of the energies and of the factors, by PDG code
+  std::map<int, std::pair<std::vector<double>, std::vector<double>>> m_tables;
+};
+
+class ScoringMesh {
+public:
+  /// Scored quantities
+  enum Quantity { kDose = 0, kFluence, kNeqFluence, kNumQuantities };
+  /// Definition of the mesh
+  struct Definition {
+    /// Flag whether the bins are in (r, phi, z), otherwise in (x, y, z)
+    bool cylinder = true;
+    /// Number of bins of each coordinate
+    std::array<unsigned int, 3> bins{{1, 1, 1}};
+    /// Lower and upper edges of each coordinate (lengths in Geant units, phi in rad)
+    std::array<double, 3> min{{0, 0, 0}};
+    std::array<double, 3> max{{0, 0, 0}};
+  };
+  /// Sums over the events
+  struct Sums {
+    /// Number of events
+    unsigned long events = 0;
+    /// Sum and sum of squares over the events, by quantity and bin
+    std::vector<double> sum;
+    std::vector<double> sum2;
+  };
+  /** Constructor.
+   *  @param[in] aDefinition bins of the mesh
+   *  @param[in] aQuantities scored quantities
+   */
+  ScoringMesh(const Definition& aDefinition, const std::set<Quantity>& aQuantities);
+  /// Definition of the mesh
+  const Definition& definition() const { return m_definition; }
+  /// Number of bins
+  size_t numBins() const { return m_numBins; }
+  /// Index of the quantity in the sums (-1 if not scored)
+  int index(Quantity aQuantity) const { return m_indices[aQuantity]; }
+  /// Number of scored quantities
+  size_t numQuantities() const { return m_numQuantities; }
+  /// Bin of the position (-1 if outside of the mesh)
+  long bin(const G4ThreeVector& aPosition) const;
+  /// Indices of the bin for each coordinate
+  std::array<unsigned int, 3> indices(size_t aBin) const;
+  /// Centre of the bin in the coordinates of the mesh
+  std::array<double, 3> centre(size_t aBin) const;
+  /// Volume of the bin
+  double volume(size_t aBin) const;
+  /// Inverse of the volume of the bin
+  double inverseVolume(size_t aBin) const { return m_inverseVolumes[aBin]; }
+  /// Smallest width of the bins in length (r or x, z or y, z)
+  double minWidth() const;
+  /** Merge the sums of one thread.
+   *  @param[in] aSums sums of the thread
+   */
+  void merge(const Sums& aSums);
+  /// Sums of all threads
+  Sums sums() const;
+
+private:
+  /// Definition of the mesh
+  Definition m_definition;
+  /// Number of bins
+  size_t m_numBins;
+  /// Width of the bins of each coordinate
+  std::array<double, 3> m_widths;
+  /// Inverse of the volume of each bin
+  std::vector<double> m_inverseVolumes;
+  /// Index of each quantity in the sums (-1 if not scored)
+  std::array<int, kNumQuantities> m_indices;
+  /// Number of scored quantities
+  size_t m_numQuantities;
+  /// Sums of all threads
+  Sums m_sums;
+  /// Mutex guarding the sums
+  mutable std::mutex m_mutex;
+};
+}
+
+#endif /* SIMG4FULL_SCORINGMESH_H */
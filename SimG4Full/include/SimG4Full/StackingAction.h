@@ -0,0 +1,68 @@
+#ifndef SIMG4FULL_STACKINGACTION_H
+#define SIMG4FULL_STACKINGACTION_H
+
+#include "G4UserStackingAction.hh"
+
+// STL
+#include <atomic>
+#include <cfloat>
+#include <memory>
+#include <set>
+
+/** @class StackingAction SimG4Full/SimG4Full/StackingAction.h StackingAction.h
+ *
+ *  User stacking action that classifies the new secondary tracks (primary tracks are always tracked):
+ *  a) tracks of the killed particle types (e.g. neutrinos) are killed at their creation;
+ *  b) tracks created outside of the region of interest (a cylinder around the z axis) are killed, if below the energy
+ *     threshold of the pruning;
+ *  c) tracks of the postponed particle types below the energy threshold (e.g. low energy neutrons) are moved to the
+ *     waiting stack, so that they are tracked once all the other tracks of the event are done.
+ *  The classified tracks are counted in StackingCounts, shared by the actions of all the threads.
+ */
+namespace sim {
+/// Classification of the secondary tracks
+struct StackingSelection {
+  /// PDG codes of the particles killed at their creation
+  std::set<int> killPdgCodes;
+  /// PDG codes of the postponed particles
+  std::set<int> postponePdgCodes;
+  /// maximum kinetic energy of the postponed particles
+  double postponeMaxEnergy = DBL_MAX;
+  /// radius and half-length of the region of interest
+  double maxRadius = DBL_MAX;
+  double maxZ = DBL_MAX;
+  /// maximum kinetic energy of the tracks killed outside of the region of interest
+  double pruneMaxEnergy = DBL_MAX;
+};
+
+/// Numbers of the classified tracks
+struct StackingCounts {
+  std::atomic<unsigned long> killed{0};
+  std::atomic<unsigned long> pruned{0};
+  std::atomic<unsigned long> postponed{0};
+};
+
+class StackingAction : public G4UserStackingAction {
+public:
+  /** Constructor.
+   *  @param[in] aSelection classification of the secondary tracks
+   *  @param[in] aCounts numbers of the classified tracks (filled)
+   */
+  StackingAction(const StackingSelection& aSelection, std::shared_ptr<StackingCounts> aCounts);
+  virtual ~StackingAction() = default;
+  /// Classify the new track
+  virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* aTrack) final;
+
+private:
+  /// Kill the track, which the particle history then does not wait for
+  G4ClassificationOfNewTrack kill(const G4Track* aTrack) const;
+  /// Classification of the secondary tracks
+  StackingSelection m_selection;
+  /// Flag whether the region of interest is set
+  bool m_prune;
+  /// Numbers of the classified tracks
+  std::shared_ptr<StackingCounts> m_counts;
+};
+}
+
+#endif /* SIMG4FULL_STACKINGACTION_H */
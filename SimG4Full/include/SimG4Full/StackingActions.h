@@ -0,0 +1,44 @@
+#ifndef SIMG4FULL_STACKINGACTIONS_H
+#define SIMG4FULL_STACKINGACTIONS_H
+
+#include "G4VUserActionInitialization.hh"
+
+// FCCSW
+#include "SimG4Full/FullSimActions.h"
+#include "SimG4Full/StackingAction.h"
+
+// STL
+#include <memory>
+
+/** @class StackingActions SimG4Full/SimG4Full/StackingActions.h StackingActions.h
+ *
+ *  User action initialization for full simulation with the StackingAction (created for each thread),
+ *  in addition to the actions of FullSimActions.
+ */
+namespace sim {
+class StackingActions : public G4VUserActionInitialization {
+public:
+  /** Constructor.
+   *  @param[in] aStackingSelection classification of the secondary tracks
+   *  @param[in] aCounts numbers of the classified tracks (filled by the actions)
+   *  @param[in] enableHistory flag whether or not to store particle history
+   *  @param[in] aSelection selection of the particles saved in the history
+   *  @param[in] aCountSteps flag whether or not to count tracks and steps of the event
+   */
+  StackingActions(const StackingSelection& aStackingSelection, std::shared_ptr<StackingCounts> aCounts,
+                  bool enableHistory, const ParticleHistorySelection& aSelection, bool aCountSteps);
+  virtual ~StackingActions() = default;
+  /// Create all user actions.
+  virtual void Build() const final;
+
+private:
+  /// Actions of the full simulation
+  FullSimActions m_fullSimActions;
+  /// Classification of the secondary tracks
+  StackingSelection m_stackingSelection;
+  /// Numbers of the classified tracks
+  std::shared_ptr<StackingCounts> m_counts;
+};
+}
+
+#endif /* SIMG4FULL_STACKINGACTIONS_H */
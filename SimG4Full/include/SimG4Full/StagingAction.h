@@ -0,0 +1,50 @@
+#ifndef SIMG4FULL_STAGINGACTION_H
+#define SIMG4FULL_STAGINGACTION_H
+
+#include "G4UserSteppingAction.hh"
+
+// STL
+#include <atomic>
+#include <memory>
+#include <unordered_set>
+
+class G4LogicalVolume;
+
+/** @class StagingAction SimG4Full/SimG4Full/StagingAction.h StagingAction.h
+ *
+ *  Regional stepping action of the first stage of a staged simulation: the tracks entering one of the envelope
+ *  volumes (e.g. the calorimeters) are stopped at the boundary, before they are tracked inside, and their state at the
+ *  boundary is recorded in the EventInformation (created if needed), from which it is saved to be simulated in the
+ *  second stage.
+ *  The regional action that was set in the region before may be chained (it is called first).
+ */
+namespace sim {
+/// Numbers of the staged tracks of the job
+struct StagingCounts {
+  std::atomic<unsigned long> tracks{0};
+};
+
+class StagingAction : public G4UserSteppingAction {
+public:
+  /** Constructor.
+   *  @param[in] aEnvelopes volumes at whose boundary the entering tracks are stopped
+   *  @param[in] aCounts numbers of the job (filled by the action)
+   *  @param[in] aChained regional action called before this one (not owned, may be null)
+   */
+  StagingAction(const std::unordered_set<const G4LogicalVolume*>& aEnvelopes, std::shared_ptr<StagingCounts> aCounts,
+                G4UserSteppingAction* aChained = nullptr);
+  virtual ~StagingAction() = default;
+  /// Stop and record the track if it enters an envelope
+  virtual void UserSteppingAction(const G4Step* aStep) final;
+
+private:
+  /// Volumes at whose boundary the entering tracks are stopped
+  std::unordered_set<const G4LogicalVolume*> m_envelopes;
+  /// Numbers of the job
+  std::shared_ptr<StagingCounts> m_counts;
+  /// Regional action called before this one
+  G4UserSteppingAction* m_chained;
+};
+}
+
+#endif /* SIMG4FULL_STAGINGACTION_H */
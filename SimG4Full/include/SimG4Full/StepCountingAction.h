@@ -0,0 +1,21 @@
+#ifndef SIMG4FULL_STEPCOUNTINGACTION_H
+#define SIMG4FULL_STEPCOUNTINGACTION_H
+
+#include "G4UserSteppingAction.hh"
+
+/** @class StepCountingAction SimG4Full/SimG4Full/StepCountingAction.h StepCountingAction.h
+ *
+ *  User stepping action that counts the tracks and steps of the event in the EventInformation
+ *  (needs to be used together with ParticleHistoryEventAction that creates it).
+ */
+namespace sim {
+class StepCountingAction : public G4UserSteppingAction {
+public:
+  StepCountingAction() = default;
+  virtual ~StepCountingAction() = default;
+  /// Count the step (and the track if it is its first step)
+  virtual void UserSteppingAction(const G4Step* aStep) final;
+};
+}
+
+#endif /* SIMG4FULL_STEPCOUNTINGACTION_H */
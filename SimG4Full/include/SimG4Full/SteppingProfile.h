@@ -0,0 +1,71 @@
+#ifndef SIMG4FULL_STEPPINGPROFILE_H
+#define SIMG4FULL_STEPPINGPROFILE_H
+
+// STL
+#include <map>
+#include <mutex>
+#include <string>
+
+/** @class SteppingProfile SimG4Full/SimG4Full/SteppingProfile.h SteppingProfile.h
+ *
+ *  Profile of the simulation: number of steps, CPU time and deposited energy,
+ *  per sub-detector (placement in the world), per logical volume, per region and per particle type, and optionally
+ *  per process limiting the step (for each particle type and region, named "particle:region:process").
+ *  Filled at the end of the run by each thread (SteppingProfileAction), hence merging is thread-safe.
+ */
+namespace sim {
+class SteppingProfile {
+public:
+  /// Accumulated quantities
+  struct Entry {
+    /// Number of steps
+    unsigned long steps = 0;
+    /// CPU time [s]
+    double time = 0;
+    /// Deposited energy (Geant units)
+    double energy = 0;
+    void add(const Entry& aOther) {
+      steps += aOther.steps;
+      time += aOther.time;
+      energy += aOther.energy;
+    }
+  };
+  /// Table of the accumulated quantities, by name
+  typedef std::map<std::string, Entry> Table;
+  /** Merge the tables of one thread.
+   *  @param[in] aDetectors entries per sub-detector
+   *  @param[in] aVolumes entries per logical volume
+   *  @param[in] aRegions entries per region
+   *  @param[in] aParticles entries per particle type
+   *  @param[in] aProcesses entries per particle type, region and process limiting the step
+   */
+  void merge(const Table& aDetectors, const Table& aVolumes, const Table& aRegions, const Table& aParticles,
+             const Table& aProcesses);
+  /// Entries per sub-detector
+  Table detectors() const;
+  /// Entries per logical volume
+  Table volumes() const;
+  /// Entries per region
+  Table regions() const;
+  /// Entries per particle type
+  Table particles() const;
+  /// Entries per particle type, region and process limiting the step
+  Table processes() const;
+
+private:
+  /// Entries per sub-detector
+  Table m_detectors;
+  /// Entries per logical volume
+  Table m_volumes;
+  /// Entries per region
+  Table m_regions;
+  /// Entries per particle type
+  Table m_particles;
+  /// Entries per particle type, region and process limiting the step
+  Table m_processes;
+  /// Mutex guarding the tables
+  mutable std::mutex m_mutex;
+};
+}
+
+#endif /* SIMG4FULL_STEPPINGPROFILE_H */
@@ -0,0 +1,114 @@
+#ifndef SIMG4FULL_STEPPINGPROFILEACTION_H
+#define SIMG4FULL_STEPPINGPROFILEACTION_H
+
+#include "G4UserRunAction.hh"
+#include "G4UserSteppingAction.hh"
+
+// FCCSW
+#include "SimG4Full/SteppingProfile.h"
+
+// STL
+#include <memory>
+#include <unordered_map>
+
+class G4Event;
+class G4LogicalVolume;
+class G4ParticleDefinition;
+class G4Region;
+class G4VPhysicalVolume;
+class G4VProcess;
+
+/** @class SteppingProfileAction SimG4Full/SimG4Full/SteppingProfileAction.h SteppingProfileAction.h
+ *
+ *  User stepping action that accumulates the number of steps, the CPU time (of the thread) and the deposited energy
+ *  per sub-detector (the placement in the world containing the step), logical volume, region and particle type.
+ *  Tables are kept by the action (one per thread) and indexed by the Geant objects (no string handling in the
+ *  stepping), names are resolved only when merged into the shared profile, at the end of the run
+ *  (see SteppingProfileRunAction).
+ *  The CPU time elapsed since the previous step of the thread (in the same event) is attributed to the current step.
+ *  If enabled, the steps are also accumulated per particle type, region and process that limited the step (the
+ *  process defined at the post-step point), the transportation of charged particles in a magnetic field being
+ *  reported separately ("Transportation (field)") as the propagation in the field is the expensive part of it.
+ */
+namespace sim {
+class SteppingProfileAction : public G4UserSteppingAction {
+public:
+  /** Constructor.
+   *  @param[in] aProfile profile to which the tables are merged at the end of the run
+   *  @param[in] aMeasureTime flag whether the CPU time should be measured
+   *  @param[in] aPerProcess flag whether the steps should be accumulated per process
+   */
+  SteppingProfileAction(std::shared_ptr<SteppingProfile> aProfile, bool aMeasureTime, bool aPerProcess);
+  virtual ~SteppingProfileAction() = default;
+  /// Accumulate the step
+  virtual void UserSteppingAction(const G4Step* aStep) final;
+  /// Merge the tables into the shared profile and reset them
+  void merge();
+
+private:
+  /// Particle type, region and process limiting the step, with a flag for the transportation in a field
+  struct ProcessKey {
+    const G4ParticleDefinition* particle;
+    const G4Region* region;
+    const G4VProcess* process;
+    bool inField;
+    bool operator==(const ProcessKey& aOther) const {
+      return particle == aOther.particle && region == aOther.region && process == aOther.process &&
+             inField == aOther.inField;
+    }
+  };
+  struct ProcessKeyHash {
+    size_t operator()(const ProcessKey& aKey) const {
+      size_t hash = std::hash<const void*>()(aKey.particle);
+      hash = hash * 31 + std::hash<const void*>()(aKey.region);
+      hash = hash * 31 + std::hash<const void*>()(aKey.process);
+      return hash * 2 + aKey.inField;
+    }
+  };
+  /// Check if the charged track is transported in a magnetic field
+  static bool inField(const G4Step* aStep, const G4LogicalVolume* aVolume);
+  /// CPU time of the thread [s]
+  static double threadTime();
+  /// Shared profile
+  std::shared_ptr<SteppingProfile> m_profile;
+  /// Flag whether the CPU time should be measured
+  bool m_measureTime;
+  /// Flag whether the steps should be accumulated per process
+  bool m_perProcess;
+  /// CPU time of the thread at the previous step
+  double m_lastTime;
+  /// Event of the previous step
+  const G4Event* m_lastEvent;
+  /// Entries per sub-detector
+  std::unordered_map<const G4VPhysicalVolume*, SteppingProfile::Entry> m_detectors;
+  /// Entries per logical volume
+  std::unordered_map<const G4LogicalVolume*, SteppingProfile::Entry> m_volumes;
+  /// Entries per region
+  std::unordered_map<const G4Region*, SteppingProfile::Entry> m_regions;
+  /// Entries per particle type
+  std::unordered_map<const G4ParticleDefinition*, SteppingProfile::Entry> m_particles;
+  /// Entries per particle type, region and process limiting the step
+  std::unordered_map<ProcessKey, SteppingProfile::Entry, ProcessKeyHash> m_processes;
+};
+
+/** @class SteppingProfileRunAction SimG4Full/SimG4Full/SteppingProfileAction.h SteppingProfileAction.h
+ *
+ *  User run action that merges the tables of the SteppingProfileAction of the same thread at the end of the run.
+ */
+class SteppingProfileRunAction : public G4UserRunAction {
+public:
+  /** Constructor.
+   *  @param[in] aAction stepping action of the thread (not owned)
+   */
+  SteppingProfileRunAction(SteppingProfileAction* aAction) : m_action(aAction) {}
+  virtual ~SteppingProfileRunAction() = default;
+  /// Merge the tables of the stepping action
+  virtual void EndOfRunAction(const G4Run* aRun) final;
+
+private:
+  /// Stepping action of the thread
+  SteppingProfileAction* m_action;
+};
+}
+
+#endif /* SIMG4FULL_STEPPINGPROFILEACTION_H */
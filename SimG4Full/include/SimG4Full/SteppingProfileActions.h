@@ -0,0 +1,47 @@
+#ifndef SIMG4FULL_STEPPINGPROFILEACTIONS_H
+#define SIMG4FULL_STEPPINGPROFILEACTIONS_H
+
+#include "G4VUserActionInitialization.hh"
+
+// FCCSW
+#include "SimG4Full/FullSimActions.h"
+#include "SimG4Full/SteppingProfile.h"
+
+// STL
+#include <memory>
+
+/** @class SteppingProfileActions SimG4Full/SimG4Full/SteppingProfileActions.h SteppingProfileActions.h
+ *
+ *  User action initialization for full simulation with the stepping profile
+ *  (SteppingProfileAction and SteppingProfileRunAction, created for each thread),
+ *  in addition to the actions of FullSimActions.
+ */
+namespace sim {
+class SteppingProfileActions : public G4VUserActionInitialization {
+public:
+  /** Constructor.
+   *  @param[in] aProfile profile filled by the actions
+   *  @param[in] aMeasureTime flag whether the CPU time should be measured
+   *  @param[in] aPerProcess flag whether the steps should be accumulated per process
+   *  @param[in] enableHistory flag whether or not to store particle history
+   *  @param[in] aSelection selection of the particles saved in the history
+   */
+  SteppingProfileActions(std::shared_ptr<SteppingProfile> aProfile, bool aMeasureTime, bool aPerProcess,
+                         bool enableHistory, const ParticleHistorySelection& aSelection);
+  virtual ~SteppingProfileActions() = default;
+  /// Create all user actions.
+  virtual void Build() const final;
+
+private:
+  /// Actions of the full simulation
+  FullSimActions m_fullSimActions;
+  /// Profile filled by the actions
+  std::shared_ptr<SteppingProfile> m_profile;
+  /// Flag whether the CPU time should be measured
+  bool m_measureTime;
+  /// Flag whether the steps should be accumulated per process
+  bool m_perProcess;
+};
+}
+
+#endif /* SIMG4FULL_STEPPINGPROFILEACTIONS_H */
@@ -0,0 +1,84 @@
+#ifndef SIMG4FULL_TRACKKILLINGACTION_H
+#define SIMG4FULL_TRACKKILLINGACTION_H
+
+#include "G4UserSteppingAction.hh"
+
+// STL
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+class G4LogicalVolume;
+class G4ParticleDefinition;
+
+/** @class TrackKillingAction SimG4Full/SimG4Full/TrackKillingAction.h TrackKillingAction.h
+ *
+ *  Regional stepping action that kills the tracks:
+ *  a) below the minimum kinetic energy of their particle type (at the end of the step);
+ *  b) above the maximum global time of their particle type;
+ *  c) entering one of the kill volumes (at the boundary, before they are tracked inside).
+ *  The thresholds are given per PDG code, the code 0 standing for all the other particles. The killed tracks and their
+ *  kinetic energy are counted per reason and particle type.
+ *  The regional action that was set in the region before may be chained (it is called first).
+ */
+namespace sim {
+class TrackKillingAction : public G4UserSteppingAction {
+public:
+  /// Reason of the killing
+  enum Reason { kEnergy, kTime, kVolume };
+  /// Killed tracks of one reason and particle type
+  struct Count {
+    std::string particle;
+    unsigned long tracks = 0;
+    double energy = 0;
+  };
+  /** Constructor.
+   *  @param[in] aMinKineticEnergy minimum kinetic energy per PDG code
+   *  @param[in] aMaxTime maximum global time per PDG code
+   *  @param[in] aKillVolumes volumes in which the entering tracks are killed
+   *  @param[in] aChained regional action called before this one (not owned, may be null)
+   */
+  TrackKillingAction(const std::map<int, double>& aMinKineticEnergy, const std::map<int, double>& aMaxTime,
+                     const std::unordered_set<const G4LogicalVolume*>& aKillVolumes,
+                     G4UserSteppingAction* aChained = nullptr);
+  virtual ~TrackKillingAction() = default;
+  /// Kill the track if it falls below the thresholds or enters a kill volume
+  virtual void UserSteppingAction(const G4Step* aStep) final;
+  /// Killed tracks per reason and PDG code
+  std::map<std::pair<Reason, int>, Count> counts() const;
+
+private:
+  /// Thresholds of a particle type
+  struct Thresholds {
+    double minKineticEnergy;
+    double maxTime;
+  };
+  /// Thresholds of the particle type (cached for the particle of the previous step)
+  const Thresholds& thresholds(const G4ParticleDefinition* aParticle);
+  /// Kill the track of the step and count it
+  void kill(const G4Step* aStep, Reason aReason);
+  /// Minimum kinetic energy per PDG code
+  std::map<int, double> m_minKineticEnergy;
+  /// Maximum time per PDG code
+  std::map<int, double> m_maxTime;
+  /// Flag whether any threshold is set
+  bool m_thresholds;
+  /// Volumes in which the entering tracks are killed
+  std::unordered_set<const G4LogicalVolume*> m_killVolumes;
+  /// Regional action called before this one
+  G4UserSteppingAction* m_chained;
+  /// Thresholds per particle type
+  std::unordered_map<const G4ParticleDefinition*, Thresholds> m_particleThresholds;
+  /// Particle type of the previous step and its thresholds
+  const G4ParticleDefinition* m_lastParticle = nullptr;
+  const Thresholds* m_lastThresholds = nullptr;
+  /// Killed tracks per reason and PDG code
+  std::map<std::pair<Reason, int>, Count> m_counts;
+  /// Mutex of the counts
+  mutable std::mutex m_mutex;
+};
+}
+
+#endif /* SIMG4FULL_TRACKKILLINGACTION_H */
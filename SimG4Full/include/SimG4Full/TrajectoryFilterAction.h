@@ -0,0 +1,62 @@
+#ifndef SIMG4FULL_TRAJECTORYFILTERACTION_H
+#define SIMG4FULL_TRAJECTORYFILTERACTION_H
+
+#include "G4UserTrackingAction.hh"
+
+// STL
+#include <atomic>
+#include <memory>
+#include <set>
+#include <string>
+
+/** @class TrajectoryFilterAction SimG4Full/SimG4Full/TrajectoryFilterAction.h TrajectoryFilterAction.h
+ *
+ *  User tracking action that turns the creation of the Geant4 trajectory on only for the selected tracks, so that
+ *  the command "/tracking/storeTrajectory" is not needed and no trajectory is built for the other tracks.
+ *  The selection is the one of SimG4SaveTrajectory: origin (primaries only), initial momentum, particle type and
+ *  region of the starting point of the track. The numbers of tracks are summed in TrajectoryFilterCounts, shared by
+ *  the actions of all the threads.
+ */
+namespace sim {
+/// Selection of the tracks whose trajectory is stored
+struct TrajectorySelection {
+  /// flag whether only the trajectories of the primary particles are stored
+  bool primaryOnly = false;
+  /// minimum initial momentum of the stored trajectories
+  double minMomentum = 0;
+  /// PDG codes of the stored trajectories (all if empty)
+  std::set<int> pdgCodes;
+  /// names of the regions in which the stored trajectories start (all if empty)
+  std::set<std::string> regions;
+  /// type of the stored trajectories (as for /tracking/storeTrajectory: 1 G4Trajectory, 2 smooth, 3 and 4 rich)
+  int trajectoryType = 1;
+};
+
+/// Numbers of the tracks and of the stored trajectories of the job
+struct TrajectoryFilterCounts {
+  std::atomic<unsigned long> tracks{0};
+  std::atomic<unsigned long> stored{0};
+};
+
+class TrajectoryFilterAction : public G4UserTrackingAction {
+public:
+  /** Constructor.
+   *  @param[in] aSelection selection of the tracks whose trajectory is stored
+   *  @param[in] aCounts numbers of the job (filled)
+   */
+  TrajectoryFilterAction(const TrajectorySelection& aSelection, std::shared_ptr<TrajectoryFilterCounts> aCounts);
+  virtual ~TrajectoryFilterAction() = default;
+  /// Turn the trajectory of the track on if it is selected, off otherwise
+  virtual void PreUserTrackingAction(const G4Track* aTrack) final;
+
+private:
+  /// Check if the trajectory of the track is stored
+  bool isSelected(const G4Track& aTrack) const;
+  /// Selection of the tracks
+  TrajectorySelection m_selection;
+  /// Numbers of the job
+  std::shared_ptr<TrajectoryFilterCounts> m_counts;
+};
+}
+
+#endif /* SIMG4FULL_TRAJECTORYFILTERACTION_H */
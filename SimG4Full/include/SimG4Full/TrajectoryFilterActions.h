@@ -0,0 +1,37 @@
+#ifndef SIMG4FULL_TRAJECTORYFILTERACTIONS_H
+#define SIMG4FULL_TRAJECTORYFILTERACTIONS_H
+
+#include "G4VUserActionInitialization.hh"
+
+// FCCSW
+#include "SimG4Full/TrajectoryFilterAction.h"
+
+// STL
+#include <memory>
+
+/** @class TrajectoryFilterActions SimG4Full/SimG4Full/TrajectoryFilterActions.h TrajectoryFilterActions.h
+ *
+ *  User action initialization of the selective storage of the trajectories (TrajectoryFilterAction, created for
+ *  each thread). Only this action is created, it is meant to be chained to FullSimActions.
+ */
+namespace sim {
+class TrajectoryFilterActions : public G4VUserActionInitialization {
+public:
+  /** Constructor.
+   *  @param[in] aSelection selection of the tracks whose trajectory is stored
+   *  @param[in] aCounts numbers of the job (filled by the actions)
+   */
+  TrajectoryFilterActions(const TrajectorySelection& aSelection, std::shared_ptr<TrajectoryFilterCounts> aCounts);
+  virtual ~TrajectoryFilterActions() = default;
+  /// Create all user actions.
+  virtual void Build() const final;
+
+private:
+  /// Selection of the tracks
+  TrajectorySelection m_selection;
+  /// Numbers of the job
+  std::shared_ptr<TrajectoryFilterCounts> m_counts;
+};
+}
+
+#endif /* SIMG4FULL_TRAJECTORYFILTERACTIONS_H */
@@ -0,0 +1,74 @@
+#ifndef SIMG4FULL_PARTICLEHISTORYPROPERTIES_H
+#define SIMG4FULL_PARTICLEHISTORYPROPERTIES_H
+
+// Gaudi
+#include "Gaudi/Property.h"
+#include "GaudiKernel/SystemOfUnits.h"
+
+// FCCSW
+#include "SimG4Full/ParticleHistoryAction.h"
+
+// STL
+#include <string>
+#include <vector>
+
+/** @class sim::ParticleHistoryProperties SimG4Full/src/components/ParticleHistoryProperties.h
+ *  ParticleHistoryProperties.h
+ *
+ *  Properties of the particle history (sim::ParticleHistorySelection), declared to the action tool that holds them,
+ *  so that all the tools loading the history actions are configured the same way.
+ */
+
+namespace sim {
+class ParticleHistoryProperties {
+public:
+  /** Declare the properties to the tool.
+   *  @param[in] aOwner tool holding the properties
+   */
+  template <class OWNER>
+  explicit ParticleHistoryProperties(OWNER* aOwner)
+      : m_enableHistory{aOwner, "enableHistory", false, "Set to true to save secondary particle info"},
+        m_energyCut{aOwner, "energyCut", 0.0 * Gaudi::Units::GeV, "minimum energy for secondaries to be saved"},
+        m_historyPdgCodes{aOwner, "historyPdgCodes", {},
+                          "PDG codes of the particles saved in the history (all if empty)"},
+        m_historyProcesses{aOwner, "historyProcesses", {},
+                           "Names of the processes creating the secondaries saved in the history (all if empty)"},
+        m_historyRegions{aOwner, "historyRegions", {},
+                         "Names of the regions in which the saved particles are created (all if empty)"},
+        m_historyVolumes{aOwner, "historyVolumes", {},
+                         "Names of the volumes in which the saved particles are created (all if empty)"},
+        m_keepAncestors{aOwner, "keepAncestors", false,
+                        "Set to true to save the ancestors of the saved particles too"} {}
+  /// Flag whether the particle history is saved
+  bool enabled() const { return m_enableHistory; }
+  /// Selection of the particles saved in the history
+  ParticleHistorySelection selection() const {
+    ParticleHistorySelection selection;
+    selection.energyCut = m_energyCut;
+    selection.pdgCodes = m_historyPdgCodes;
+    selection.processes = m_historyProcesses;
+    selection.regions = m_historyRegions;
+    selection.volumes = m_historyVolumes;
+    selection.keepAncestors = m_keepAncestors;
+    return selection;
+  }
+
+private:
+  /// Set to true to save secondary particle info
+  Gaudi::Property<bool> m_enableHistory;
+  /// Minimum energy of the particles saved in the history
+  Gaudi::Property<double> m_energyCut;
+  /// PDG codes of the particles saved in the history (all if empty)
+  Gaudi::Property<std::vector<int>> m_historyPdgCodes;
+  /// Names of the processes creating the particles saved in the history (all if empty)
+  Gaudi::Property<std::vector<std::string>> m_historyProcesses;
+  /// Names of the regions in which the particles saved in the history are created (all if empty)
+  Gaudi::Property<std::vector<std::string>> m_historyRegions;
+  /// Names of the logical volumes in which the particles saved in the history are created (all if empty)
+  Gaudi::Property<std::vector<std::string>> m_historyVolumes;
+  /// Set to true to save the ancestors of the saved particles too
+  Gaudi::Property<bool> m_keepAncestors;
+};
+}
+
+#endif /* SIMG4FULL_PARTICLEHISTORYPROPERTIES_H */
@@ -0,0 +1,78 @@
+#include "SimG4FieldStatisticsActions.h"
+
+// FCCSW
+#include "SimG4Full/FieldStatisticsActions.h"
+
+// Geant4
+#include "G4SystemOfUnits.hh"
+
+// STL
+#include <algorithm>
+#include <iomanip>
+#include <vector>
+
+DECLARE_COMPONENT(SimG4FieldStatisticsActions)
+
+SimG4FieldStatisticsActions::SimG4FieldStatisticsActions(const std::string& type, const std::string& name,
+                                                         const IInterface* parent)
+    : AlgTool(type, name, parent) {
+  declareInterface<ISimG4ActionTool>(this);
+}
+
+SimG4FieldStatisticsActions::~SimG4FieldStatisticsActions() {}
+
+StatusCode SimG4FieldStatisticsActions::initialize() {
+  if (AlgTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  m_statistics = std::make_shared<sim::FieldStatistics>();
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4FieldStatisticsActions::finalize() {
+  const sim::FieldStatistics::Table regions = m_statistics->regions();
+  const sim::FieldStatistics::Events events = m_statistics->events();
+  if (events.sum.steps > 0 && events.sum.counters.fieldCalls == 0) {
+    warning() << "No field evaluation counted, set CountPropagation of the magnetic field tool" << endmsg;
+  }
+  // sort by field evaluations (by number of steps if the field is not counted)
+  std::vector<std::pair<std::string, sim::FieldStatistics::Entry>> entries(regions.begin(), regions.end());
+  std::sort(entries.begin(), entries.end(), [](const auto& aLhs, const auto& aRhs) {
+    return aLhs.second.counters.fieldCalls != aRhs.second.counters.fieldCalls
+               ? aLhs.second.counters.fieldCalls > aRhs.second.counters.fieldCalls
+               : aLhs.second.steps > aRhs.second.steps;
+  });
+  info() << "Propagation in the field per region (" << entries.size() << " regions):" << endmsg;
+  for (size_t iEntry = 0; iEntry < entries.size() && iEntry < m_numEntries; ++iEntry) {
+    const auto& entry = entries[iEntry].second;
+    info() << std::setw(30) << std::left << entries[iEntry].first << " steps " << std::setw(12) << entry.steps
+           << " field calls " << std::setw(12) << entry.counters.fieldCalls << " ("
+           << (entry.steps > 0 ? double(entry.counters.fieldCalls) / entry.steps : 0.) << " per step), integration "
+           << entry.counters.integratorSteps << ", chord trials " << entry.counters.chordTrials << ", rejected "
+           << entry.counters.rejectedSteps << ", loopers killed " << entry.loopers << " ("
+           << entry.looperEnergy / CLHEP::MeV << " MeV)" << endmsg;
+  }
+  const sim::FieldStatistics::Table loopers = m_statistics->loopers();
+  for (const auto& entry : loopers) {
+    info() << "Loopers killed: " << std::setw(20) << std::left << entry.first << std::setw(12) << entry.second.loopers
+           << " carrying " << entry.second.looperEnergy / CLHEP::MeV << " MeV" << endmsg;
+  }
+  if (events.events > 0) {
+    const double numEvents = events.events;
+    info() << "Propagation in the field per event (" << events.events << " events), mean / max: steps "
+           << events.sum.steps / numEvents << " / " << events.max.steps << ", field calls "
+           << events.sum.counters.fieldCalls / numEvents << " / " << events.max.counters.fieldCalls
+           << ", integration " << events.sum.counters.integratorSteps / numEvents << " / "
+           << events.max.counters.integratorSteps << ", chord trials " << events.sum.counters.chordTrials / numEvents
+           << " / " << events.max.counters.chordTrials << ", rejected "
+           << events.sum.counters.rejectedSteps / numEvents << " / " << events.max.counters.rejectedSteps
+           << ", loopers killed " << events.sum.loopers / numEvents << " / " << events.max.loopers << " carrying "
+           << events.sum.looperEnergy / numEvents / CLHEP::MeV << " / " << events.max.looperEnergy / CLHEP::MeV
+           << " MeV" << endmsg;
+  }
+  return AlgTool::finalize();
+}
+
+G4VUserActionInitialization* SimG4FieldStatisticsActions::userActionInitialization() {
+  return new sim::FieldStatisticsActions(m_statistics);
+}
@@ -0,0 +1,53 @@
+#ifndef SIMG4FULL_G4FIELDSTATISTICSACTIONS_H
+#define SIMG4FULL_G4FIELDSTATISTICSACTIONS_H
+
+// Gaudi
+#include "GaudiKernel/AlgTool.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4ActionTool.h"
+namespace sim {
+class FieldStatistics;
+}
+
+// STL
+#include <memory>
+
+/** @class SimG4FieldStatisticsActions SimG4Full/src/components/SimG4FieldStatisticsActions.h
+ * SimG4FieldStatisticsActions.h
+ *
+ *  Tool for loading the statistics of the propagation in the magnetic field (sim::FieldStatisticsActions), to be
+ *  chained to SimG4FullSimActions (\b'chainedActions').
+ *  The field evaluations, integration steps, trial chords and rejected integration steps counted by the field tool
+ *  (if its property \b'CountPropagation' is set) and the looping particles killed by the transportation (with their
+ *  energy) are accumulated per region, per particle type and per event. They are printed at finalization
+ *  (\b'numEntries' most expensive regions). The per-particle thresholds of the loopers of the field tool are set for
+ *  each track, if the physics list shares the transportation between the particles.
+ */
+
+class SimG4FieldStatisticsActions : public AlgTool, virtual public ISimG4ActionTool {
+public:
+  explicit SimG4FieldStatisticsActions(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SimG4FieldStatisticsActions();
+
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize: print the statistics.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /** Get the user action initialization.
+   *  @return pointer to G4VUserActionInitialization (ownership is transferred to the caller)
+   */
+  virtual G4VUserActionInitialization* userActionInitialization() final;
+
+private:
+  /// Statistics filled by the user actions of all threads
+  std::shared_ptr<sim::FieldStatistics> m_statistics;
+  /// Number of regions printed
+  Gaudi::Property<unsigned int> m_numEntries{this, "numEntries", 20, "Number of regions printed"};
+};
+
+#endif /* SIMG4FULL_G4FIELDSTATISTICSACTIONS_H */
@@ -8,6 +8,7 @@ DECLARE_COMPONENT(SimG4FullSimActions)
 SimG4FullSimActions::SimG4FullSimActions(const std::string& type, const std::string& name, const IInterface* parent)
     : AlgTool(type, name, parent) {
   declareInterface<ISimG4ActionTool>(this);
+  declareProperty("chainedActions", m_chainedTools, "Handles to the action tools chained after the full simulation");
 }
 
 SimG4FullSimActions::~SimG4FullSimActions() {}
@@ -16,11 +17,19 @@ StatusCode SimG4FullSimActions::initialize() {
   if (AlgTool::initialize().isFailure()) {
     return StatusCode::FAILURE;
   }
+  if (!m_chainedTools.retrieve()) {
+    error() << "Unable to retrieve the chained action tools" << endmsg;
+    return StatusCode::FAILURE;
+  }
   return StatusCode::SUCCESS;
 }
 
 StatusCode SimG4FullSimActions::finalize() { return AlgTool::finalize(); }
 
 G4VUserActionInitialization* SimG4FullSimActions::userActionInitialization() {
-  return new sim::FullSimActions(m_enableHistory, m_energyCut);
+  auto actions = new sim::FullSimActions(m_history.enabled(), m_history.selection(), m_countSteps);
+  for (auto& tool : m_chainedTools) {
+    actions->chain(tool->userActionInitialization());
+  }
+  return actions;
 }
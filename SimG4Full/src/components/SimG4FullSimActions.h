@@ -4,14 +4,18 @@
 // Gaudi
 #include "GaudiKernel/AlgTool.h"
 #include "GaudiKernel/SystemOfUnits.h"
-
+#include "GaudiKernel/ToolHandle.h"
 
 // FCCSW
 #include "SimG4Interface/ISimG4ActionTool.h"
+#include "ParticleHistoryProperties.h"
 
 /** @class SimG4FullSimActions SimG4Full/src/components/SimG4FullSimActions.h SimG4FullSimActions.h
  *
  *  Tool for loading full simulation user action initialization (list of user actions)
+ *  The user actions of other action tools (\b'chainedActions', e.g. SimG4StackingActions) may be added: for each hook
+ *  (run, event, tracking, stepping and stacking action) the actions are called one after the other, in the order of
+ *  the list (the full simulation actions first). A hook that no action uses is not installed.
  *
  *  @author Anna Zaborowska
  */
@@ -35,9 +39,12 @@ public:
   virtual G4VUserActionInitialization* userActionInitialization() final;
 
 private:
-  /// Set to true to save secondary particle info
-  Gaudi::Property<bool> m_enableHistory{this, "enableHistory", false, "Set to true to save secondary particle info"};
-  Gaudi::Property<double> m_energyCut{this, "energyCut", 0.0 * Gaudi::Units::GeV, "minimum energy for secondaries to be saved"};
+  /// Handles to the action tools whose actions are chained after the full simulation actions
+  ToolHandleArray<ISimG4ActionTool> m_chainedTools{this};
+  /// Particle history and the selection of its particles
+  sim::ParticleHistoryProperties m_history{this};
+  /// Set to true to count tracks and steps of each event (e.g. for the profiling in SimG4Alg)
+  Gaudi::Property<bool> m_countSteps{this, "countSteps", false, "Set to true to count tracks and steps of each event"};
 };
 
 #endif /* SIMG4FULL_G4FULLSIMACTIONS_H */
@@ -1,30 +1,28 @@
 #include "SimG4FullSimDCHRegion.h"
 
+// Gaudi
+#include "GaudiKernel/SystemOfUnits.h"
+
 // FCCSW
-//#include "SimG4Fast/FastSimModelTracker.h"
+#include "SimG4Common/VolumeIndex.h"
 
 // Geant4
+#include "G4LogicalVolume.hh"
+#include "G4ProcessTable.hh"
+#include "G4Region.hh"
 #include "G4RegionStore.hh"
-#include "G4TransportationManager.hh"
-
-//#include "G4VFastSimulationModel.hh"
 
 DECLARE_COMPONENT(SimG4FullSimDCHRegion)
 
 SimG4FullSimDCHRegion::SimG4FullSimDCHRegion(const std::string& type, const std::string& name,
-                                                     const IInterface* parent)
+                                             const IInterface* parent)
     : GaudiTool(type, name, parent) {
   declareInterface<ISimG4RegionTool>(this);
-
 }
 
-SimG4FullSimDCHRegion::~SimG4FullSimDCHRegion() 
-{
-  delete fStepLimit;
-}
+SimG4FullSimDCHRegion::~SimG4FullSimDCHRegion() {}
 
 StatusCode SimG4FullSimDCHRegion::initialize() {
-  std::cout << "nalipourTest: SimG4FullSimDCHRegion ---> initialize" << std::endl;
   if (GaudiTool::initialize().isFailure()) {
     return StatusCode::FAILURE;
   }
@@ -32,74 +30,53 @@ StatusCode SimG4FullSimDCHRegion::initialize() {
     error() << "No detector name is specified for the parametrisation" << endmsg;
     return StatusCode::FAILURE;
   }
-
-  fStepLimit = new G4UserLimits();
-  fStepLimit->SetMaxAllowedStep(m_maxStepLength);
-
+  const std::string matchingError = sim::VolumeIndex::configure(m_volumeMatching, m_volumeNames, m_matching);
+  if (!matchingError.empty()) {
+    error() << matchingError << endmsg;
+    return StatusCode::FAILURE;
+  }
+  const bool adaptive = m_fineMaxMomentum > 0 || m_fineMaxBeta > 0;
+  if (!adaptive && (m_coarseStepLength > 0 || !m_pdgCodes.empty())) {
+    error() << "Slow tracks need to be selected (fineStepMaxMomentum or fineStepMaxBeta) for the coarse steps or the "
+            << "particle types" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!adaptive) {
+    // the same limit for all the charged tracks, as G4UserLimits
+    m_stepLimit = std::make_unique<G4UserLimits>();
+    m_stepLimit->SetMaxAllowedStep(m_maxStepLength / Gaudi::Units::mm * CLHEP::mm);
+    return StatusCode::SUCCESS;
+  }
+  m_stepLimitPolicy = std::make_unique<sim::StepLimitPolicy>();
+  m_stepLimitPolicy->pdgCodes.insert(m_pdgCodes.begin(), m_pdgCodes.end());
+  m_stepLimitPolicy->fineStep = m_maxStepLength / Gaudi::Units::mm * CLHEP::mm;
+  m_stepLimitPolicy->fineMaxMomentum = m_fineMaxMomentum / Gaudi::Units::MeV * CLHEP::MeV;
+  m_stepLimitPolicy->fineMaxBeta = m_fineMaxBeta;
+  m_stepLimitPolicy->coarseStep = m_coarseStepLength / Gaudi::Units::mm * CLHEP::mm;
+  info() << "Steps limited to " << m_maxStepLength.value() << " mm below " << m_fineMaxMomentum.value() << " MeV or "
+         << "beta " << m_fineMaxBeta.value() << ", to " << m_coarseStepLength.value()
+         << " mm otherwise (0: not used)" << endmsg;
   return StatusCode::SUCCESS;
 }
 
-StatusCode SimG4FullSimDCHRegion::finalize() 
-{
-  std::cout << "nalipourTest: SimG4FullSimDCHRegion ---> finalize" << std::endl; 
-  return GaudiTool::finalize(); 
-}
+StatusCode SimG4FullSimDCHRegion::finalize() { return GaudiTool::finalize(); }
 
 StatusCode SimG4FullSimDCHRegion::create() {
-  std::cout << "nalipourTest: SimG4FullSimDCHRegion ---> create" << std::endl;
-
-  G4LogicalVolume* world =
-      (*G4TransportationManager::GetTransportationManager()->GetWorldsIterator())->GetLogicalVolume();
-  for (const auto& trackerName : m_volumeNames) {
-    for (int iter_region = 0; iter_region < world->GetNoDaughters(); ++iter_region) {
-      if (world->GetDaughter(iter_region)->GetName().find(trackerName) != std::string::npos) {
-
-        /// all G4Region objects are deleted by the G4RegionStore
-	
-  	// std::cout << "NoDaughters=" << world->GetDaughter(iter_region)->GetLogicalVolume()->GetNoDaughters() << std::endl; // ok
-        m_g4regions.emplace_back(
-            new G4Region(world->GetDaughter(iter_region)->GetLogicalVolume()->GetName()+"_fullsim"));
-        m_g4regions.back()->AddRootLogicalVolume(world->GetDaughter(iter_region)->GetLogicalVolume());
-  	std::cout << "m_maxStepLength=" << m_maxStepLength << std::endl;
-  	//auto fStepLimit = new G4UserLimits();
-
-  	m_g4regions.back()->SetUserLimits(fStepLimit);
-        
-        info() << "Attaching a Tracker fast simulation model to the region " << m_g4regions.back()->GetName() << endmsg;
-	/*
-  	int numDaughters=world->GetDaughter(iter_region)->GetLogicalVolume()->GetNoDaughters();
-  	for (auto i = 0; i<numDaughters; ++i)
-  	  {
-  	    auto daug=world->GetDaughter(iter_region)->GetLogicalVolume()->GetDaughter(i)->GetLogicalVolume()->IsRegion();
-  	    auto namedaugRegion = world->GetDaughter(iter_region)->GetLogicalVolume()->GetDaughter(i)->GetLogicalVolume()->GetRegion()->GetName();
-  	    auto daughterName = world->GetDaughter(iter_region)->GetLogicalVolume()->GetDaughter(i)->GetName();
-  	    auto d_region= world->GetDaughter(iter_region)->GetLogicalVolume()->GetDaughter(i)->GetLogicalVolume()->GetRegion();
-  	    auto d_cut = d_region->GetUserLimits();
-  	    std::cout << i << "------------- daug=" << daug << ", regionName=" << namedaugRegion << ", daughterName=" << daughterName<< std::endl;
-  	    std::cout << "cut=" << d_cut << std::endl;
-  	  }
-	*/
-
-      }
-    }
+  if (m_stepLimitPolicy && G4ProcessTable::GetProcessTable()->FindProcess("adaptiveStepLimiter", "e-") == nullptr) {
+    error() << "Adaptive step limiter is not in the physics list (adaptiveStepLimiter of SimG4UserLimitPhysicsList)"
+            << endmsg;
+    return StatusCode::FAILURE;
   }
-
-  /*
-  for (const auto& reg : m_g4regions) 
-    {
-      std::cout << "nalipourTest: region name =" << reg->GetName() << ", rootVolumes=" <<  reg->GetNumberOfRootVolumes() << std::endl;
-
-      auto limit = reg->GetUserLimits();
-      std::cout << "limit type: " << limit->GetType() << std::endl;
-      auto it = reg->GetRootLogicalVolumeIterator();
-      
-      for (auto i=it->begin(); i != it->end(); ++i)
-	{
-	  std::cout << "------name=" << i->GetName << std::endl;
-	}
+  for (G4LogicalVolume* volume : sim::VolumeIndex::match(m_volumeNames, m_matching)) {
+    /// all G4Region objects are deleted by the G4RegionStore
+    m_g4regions.emplace_back(new G4Region(volume->GetName() + "_fullsim"));
+    m_g4regions.back()->AddRootLogicalVolume(volume);
+    if (m_stepLimitPolicy) {
+      m_g4regions.back()->SetUserInformation(m_stepLimitPolicy.get());
+    } else {
+      m_g4regions.back()->SetUserLimits(m_stepLimit.get());
     }
-  */
-
-
+    info() << "Attaching step limits to the region " << m_g4regions.back()->GetName() << endmsg;
+  }
   return StatusCode::SUCCESS;
 }
@@ -1,26 +1,31 @@
-#ifndef SIMG4FAST_SIMG4FULLSIMDCHREGION_H
-#define SIMG4FAST_SIMG4FULLSIMDCHREGION_H
+#ifndef SIMG4FULL_SIMG4FULLSIMDCHREGION_H
+#define SIMG4FULL_SIMG4FULLSIMDCHREGION_H
 
 // Gaudi
 #include "GaudiAlg/GaudiTool.h"
-#include "GaudiKernel/ToolHandle.h"
 
 // FCCSW
-#include "SimG4Interface/ISimG4ParticleSmearTool.h"
+#include "SimG4Full/AdaptiveStepLimiter.h"
+#include "SimG4Common/VolumeIndex.h"
 #include "SimG4Interface/ISimG4RegionTool.h"
-#include "G4UserLimits.hh"
 
 // Geant
-//class G4VFastSimulationModel;
+#include "G4UserLimits.hh"
 class G4Region;
 
-/** @class SimG4FullSimDCHRegion SimG4Fast/src/components/SimG4FullSimDCHRegion.h SimG4FullSimDCHRegion.h
+// STL
+#include <memory>
+
+/** @class SimG4FullSimDCHRegion SimG4Full/src/components/SimG4FullSimDCHRegion.h SimG4FullSimDCHRegion.h
  *
- *  Tool for creating regions for fast simulation, attaching sim::FastSimModelTracker to them.
- *  Regions are created for volumes specified in the job options (\b'volumeNames').
- *  User may define in job options the momentum range (\b'minP', \b'maxP') and the maximum pseudorapidity (\b'maxEta')
- *  for which the fast simulation is triggered (for other particles full simulation is performed).
- *  [For more information please see](@ref md_sim_doc_geant4fastsim).
+ *  Tool for creating the regions of the drift chamber, in which the steps are limited so that the ionisation
+ *  clusters can be counted. Regions are created for volumes specified in the job options (\b'volumeNames'),
+ *  matched as set by \b'volumeMatching' (sim::VolumeIndex).
+ *  By default all the charged tracks are limited to \b'max_step_length' (G4UserLimits, with the step limiter of
+ *  SimG4UserLimitPhysicsList). If the slow tracks are selected, with the momentum (\b'fineStepMaxMomentum') or the
+ *  velocity (\b'fineStepMaxBeta'), only these get \b'max_step_length' and the other ones \b'coarse_step_length'
+ *  (0: no limit), optionally for the particle types \b'pdgCodes' only (sim::AdaptiveStepLimiter, attached by
+ *  SimG4UserLimitPhysicsList with \b'adaptiveStepLimiter').
  *
  *  @author nalipour
 */
@@ -37,25 +42,48 @@ public:
    *   @return status code
    */
   virtual StatusCode finalize() final;
-  /**  Create regions and fast simulation models
+  /**  Create regions and set their step limits
    *   @return status code
    */
   virtual StatusCode create() final;
-  /**  Get the names of the volumes where fast simulation should be performed.
+  /**  Nothing is created on the worker threads (the regions, their user information and step limits are shared).
+   *   @return status code
+   */
+  inline virtual StatusCode createForWorker() final { return StatusCode::SUCCESS; }
+  /**  Get the names of the volumes where the steps are limited.
    *   @return vector of volume names
    */
   inline virtual const std::vector<std::string>& volumeNames() const final { return m_volumeNames; };
- 
 
 private:
-  /// Envelopes that are used in a parametric simulation
+  /// Regions of the drift chamber
   /// deleted by the G4RegionStore
   std::vector<G4Region*> m_g4regions;
-  //  std::vector<std::unique_ptr<G4UserLimits>> m_models;
-  /// Names of the parametrised volumes (set by job options)
+  /// Step limits of all the charged tracks (if the slow tracks are not selected)
+  std::unique_ptr<G4UserLimits> m_stepLimit;
+  /// Step limits depending on the momentum of the tracks (if the slow tracks are selected)
+  std::unique_ptr<sim::StepLimitPolicy> m_stepLimitPolicy;
+  /// Names of the volumes of the drift chamber (set by job options)
   Gaudi::Property<std::vector<std::string>> m_volumeNames{this, "volumeNames", {}, "Names of the parametrised volumes"};
+  /// Matching of the volume names (set by job options)
+  Gaudi::Property<std::string> m_volumeMatching{
+      this, "volumeMatching", "daughters",
+      "Matching of the volume names: daughters (of the world, containing the name), exact, prefix or regex"};
+  /// Matching of the volume names
+  sim::VolumeIndex::Matching m_matching = sim::VolumeIndex::Matching::Daughters;
   Gaudi::Property<double> m_maxStepLength{this, "max_step_length", 0, "Step length for the region."};
-  G4UserLimits*      fStepLimit;       // pointer to user step limits
+  /// Maximum momentum of the slow tracks, limited to max_step_length
+  Gaudi::Property<double> m_fineMaxMomentum{
+      this, "fineStepMaxMomentum", 0, "Momentum below which the steps are limited to max_step_length (0: not used)"};
+  /// Maximum velocity (v/c) of the slow tracks, limited to max_step_length
+  Gaudi::Property<double> m_fineMaxBeta{
+      this, "fineStepMaxBeta", 0, "Velocity (v/c) below which the steps are limited to max_step_length (0: not used)"};
+  /// Step length of the other tracks
+  Gaudi::Property<double> m_coarseStepLength{this, "coarse_step_length", 0,
+                                             "Step length of the tracks that are not slow (0: no limit)"};
+  /// Particles whose steps are limited (all charged particles if empty)
+  Gaudi::Property<std::vector<int>> m_pdgCodes{
+      this, "pdgCodes", {}, "PDG codes of the particles whose steps are limited (all charged particles if empty)"};
 };
 
-#endif /* SIMG4FAST_SIMG4FULLSIMDCHREGION_H */
+#endif /* SIMG4FULL_SIMG4FULLSIMDCHREGION_H */
@@ -0,0 +1,111 @@
+#include "SimG4ImportanceBiasingRegion.h"
+
+// FCCSW
+#include "SimG4Full/ImportanceBiasingAction.h"
+
+// Geant4
+#include "G4LogicalVolume.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4TransportationManager.hh"
+
+DECLARE_COMPONENT(SimG4ImportanceBiasingRegion)
+
+SimG4ImportanceBiasingRegion::SimG4ImportanceBiasingRegion(const std::string& type, const std::string& name,
+                                                           const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareInterface<ISimG4RegionTool>(this);
+}
+
+SimG4ImportanceBiasingRegion::~SimG4ImportanceBiasingRegion() {}
+
+StatusCode SimG4ImportanceBiasingRegion::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_importances.value().empty()) {
+    error() << "No importance is specified for the biasing" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  for (const auto& importance : m_importances.value()) {
+    if (importance.second <= 0) {
+      error() << "Importance of " << importance.first << " needs to be positive" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  if (m_maxSplit < 1) {
+    error() << "Maximum number of tracks a track is split into needs to be positive" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_counts = std::make_shared<sim::ImportanceBiasingCounts>();
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4ImportanceBiasingRegion::finalize() {
+  info() << "Importance biasing: " << m_counts->splittings << " tracks split into " << m_counts->copies
+         << " additional tracks, " << m_counts->roulettes << " Russian roulettes with " << m_counts->killed
+         << " tracks killed" << endmsg;
+  return GaudiTool::finalize();
+}
+
+StatusCode SimG4ImportanceBiasingRegion::create() {
+  G4LogicalVolume* world =
+      (*G4TransportationManager::GetTransportationManager()->GetWorldsIterator())->GetLogicalVolume();
+  m_regionImportances = std::make_shared<std::unordered_map<const G4Region*, double>>();
+  auto& importances = *m_regionImportances;
+  for (const auto& importance : m_importances.value()) {
+    // "world" gives the importance of the default region, used by all the volumes outside of other regions
+    if (importance.first == "world") {
+      G4Region* region = G4RegionStore::GetInstance()->GetRegion("DefaultRegionForTheWorld", false);
+      if (region == nullptr) {
+        error() << "Default region of the world does not exist" << endmsg;
+        return StatusCode::FAILURE;
+      }
+      importances[region] = importance.second;
+      continue;
+    }
+    bool found = false;
+    for (int iter_region = 0; iter_region < world->GetNoDaughters(); ++iter_region) {
+      if (world->GetDaughter(iter_region)->GetName().find(importance.first) != std::string::npos) {
+        G4LogicalVolume* volume = world->GetDaughter(iter_region)->GetLogicalVolume();
+        found = true;
+        // a volume is the root of one region only: the importance is given to the existing region
+        if (volume->IsRootRegion() && volume->GetRegion() != nullptr &&
+            volume->GetRegion()->GetName() != "DefaultRegionForTheWorld") {
+          importances[volume->GetRegion()] = importance.second;
+          continue;
+        }
+        /// all G4Region objects are deleted by the G4RegionStore
+        m_g4regions.emplace_back(new G4Region(volume->GetName() + "_importance"));
+        m_g4regions.back()->AddRootLogicalVolume(volume);
+        importances[m_g4regions.back()] = importance.second;
+      }
+    }
+    if (!found) {
+      error() << "Volume " << importance.first << " not found, no importance can be given to it" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  for (const auto& importance : importances) {
+    info() << "Importance of the region " << importance.first->GetName() << ": " << importance.second << endmsg;
+  }
+  // the crossings of the boundaries are checked by the actions of all the regions
+  m_pdgCodeSet = std::set<int>(m_pdgCodes.begin(), m_pdgCodes.end());
+  m_actionRegions.assign(G4RegionStore::GetInstance()->begin(), G4RegionStore::GetInstance()->end());
+  setActions();
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4ImportanceBiasingRegion::createForWorker() {
+  // the regional stepping actions are thread-local: the worker gets actions of its own in the same regions
+  setActions();
+  return StatusCode::SUCCESS;
+}
+
+void SimG4ImportanceBiasingRegion::setActions() {
+  for (G4Region* region : m_actionRegions) {
+    m_actions.push_back(std::make_unique<sim::ImportanceBiasingAction>(
+        m_regionImportances, m_pdgCodeSet, m_maxSplit, m_counts, region->GetRegionalSteppingAction()));
+    region->SetRegionalSteppingAction(m_actions.back().get());
+  }
+}
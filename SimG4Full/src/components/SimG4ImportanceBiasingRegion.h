@@ -0,0 +1,88 @@
+#ifndef SIMG4FULL_SIMG4IMPORTANCEBIASINGREGION_H
+#define SIMG4FULL_SIMG4IMPORTANCEBIASINGREGION_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4RegionTool.h"
+
+// STL
+#include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+// Geant
+class G4Region;
+namespace sim {
+class ImportanceBiasingAction;
+struct ImportanceBiasingCounts;
+}
+
+/** @class SimG4ImportanceBiasingRegion SimG4Full/src/components/SimG4ImportanceBiasingRegion.h
+ *  SimG4ImportanceBiasingRegion.h
+ *
+ *  Tool for the geometry importance biasing (e.g. of the neutrons in the cavern and the shielding): the regions of
+ *  the volumes specified in the job options (\b'importances', by volume name, "world" standing for the default
+ *  region of the world) are given an importance, 1 for all the other regions. The tracks of the particles
+ *  \b'pdgCodes' are split when they cross into a region of higher importance (into at most \b'maxSplit' tracks) and
+ *  play the Russian roulette when they cross into a region of lower importance, with their weights changed
+ *  accordingly (sim::ImportanceBiasingAction, set in all the regions, chained with the regional actions they had).
+ *  The weights are recorded with the deposits by the sensitive detectors writing hit buffers (e.g. BufferedTrackerSD,
+ *  AggregatingCalorimeterSD), the save tools (SimG4SaveCalHits, SimG4SaveTrackerHits) take them into account if their
+ *  property \b'trackWeights' is set.
+ *  The tool needs to be given after the other region tools. In the multi-threaded mode each worker thread sets its
+ *  own actions in the same regions. The splittings and the Russian roulettes are printed at the finalisation.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+ */
+
+class SimG4ImportanceBiasingRegion : public GaudiTool, virtual public ISimG4RegionTool {
+public:
+  explicit SimG4ImportanceBiasingRegion(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SimG4ImportanceBiasingRegion();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize.
+   *   Print the biased tracks.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /**  Create regions and set the biasing actions
+   *   @return status code
+   */
+  virtual StatusCode create() final;
+  /**  Set the biasing actions of the worker thread in the regions of create()
+   *   @return status code
+   */
+  virtual StatusCode createForWorker() final;
+
+private:
+  /// Set the biasing actions in all the regions, chained with the regional actions of the calling thread
+  void setActions();
+  /// Regions created for the importances
+  /// deleted by the G4RegionStore
+  std::vector<G4Region*> m_g4regions;
+  /// Biasing actions per region (owned by the tool, as the regions do not delete them)
+  std::vector<std::unique_ptr<sim::ImportanceBiasingAction>> m_actions;
+  /// Regions of the biasing actions
+  std::vector<G4Region*> m_actionRegions;
+  /// Importance of the regions, given to the actions of all the threads
+  std::shared_ptr<std::unordered_map<const G4Region*, double>> m_regionImportances;
+  /// PDG codes of the biased particles
+  std::set<int> m_pdgCodeSet;
+  /// Numbers of the biased tracks (of all the threads)
+  std::shared_ptr<sim::ImportanceBiasingCounts> m_counts;
+  /// Importance of the regions by volume name ("world" for the default region)
+  Gaudi::Property<std::map<std::string, double>> m_importances{
+      this, "importances", {}, "Importance of the regions by volume name (1 for the other regions)"};
+  /// PDG codes of the biased particles (all if empty)
+  Gaudi::Property<std::vector<int>> m_pdgCodes{this, "pdgCodes", {2112}, "PDG codes of the biased particles"};
+  /// Maximum number of tracks a track is split into
+  Gaudi::Property<unsigned int> m_maxSplit{this, "maxSplit", 10, "Maximum number of tracks a track is split into"};
+};
+
+#endif /* SIMG4FULL_SIMG4IMPORTANCEBIASINGREGION_H */
@@ -0,0 +1,104 @@
+#include "SimG4ProductionCutsRegion.h"
+
+// Geant4
+#include "G4LogicalVolume.hh"
+#include "G4ProductionCuts.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4TransportationManager.hh"
+
+#include "GaudiKernel/SystemOfUnits.h"
+
+DECLARE_COMPONENT(SimG4ProductionCutsRegion)
+
+SimG4ProductionCutsRegion::SimG4ProductionCutsRegion(const std::string& type, const std::string& name,
+                                                     const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareInterface<ISimG4RegionTool>(this);
+}
+
+SimG4ProductionCutsRegion::~SimG4ProductionCutsRegion() {}
+
+StatusCode SimG4ProductionCutsRegion::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_volumeNames.empty() && m_regionNames.empty()) {
+    error() << "No volume or region name is specified for the production cuts" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (m_cutGamma < 0 && m_cutElectron < 0 && m_cutPositron < 0 && m_cutProton < 0) {
+    warning() << "No production cut is given, the regions keep the default cuts" << endmsg;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4ProductionCutsRegion::finalize() { return GaudiTool::finalize(); }
+
+void SimG4ProductionCutsRegion::setCuts(G4Region& aRegion) const {
+  G4ProductionCuts* cuts = aRegion.GetProductionCuts();
+  if (cuts == nullptr) {
+    // new regions start from the cuts of the default region (deleted by the G4ProductionCutsTable)
+    const G4Region* world = G4RegionStore::GetInstance()->GetRegion("DefaultRegionForTheWorld", false);
+    cuts = world != nullptr && world->GetProductionCuts() != nullptr ? new G4ProductionCuts(*world->GetProductionCuts())
+                                                                       : new G4ProductionCuts();
+    aRegion.SetProductionCuts(cuts);
+  }
+  const std::vector<std::pair<const char*, double>> cutValues{
+      {"gamma", m_cutGamma}, {"e-", m_cutElectron}, {"e+", m_cutPositron}, {"proton", m_cutProton}};
+  for (const auto& cut : cutValues) {
+    if (cut.second >= 0) {
+      cuts->SetProductionCut(cut.second / Gaudi::Units::mm * CLHEP::mm, cut.first);
+    }
+  }
+  info() << "Production cuts in the region " << aRegion.GetName() << ": gamma " << cuts->GetProductionCut("gamma")
+         << " mm, e- " << cuts->GetProductionCut("e-") << " mm, e+ " << cuts->GetProductionCut("e+") << " mm, proton "
+         << cuts->GetProductionCut("proton") << " mm" << endmsg;
+}
+
+StatusCode SimG4ProductionCutsRegion::create() {
+  G4LogicalVolume* world =
+      (*G4TransportationManager::GetTransportationManager()->GetWorldsIterator())->GetLogicalVolume();
+  for (const auto& volumeName : m_volumeNames) {
+    // "world" sets the cuts of the default region, used by all the volumes outside of other regions
+    if (volumeName == "world") {
+      G4Region* region = G4RegionStore::GetInstance()->GetRegion("DefaultRegionForTheWorld", false);
+      if (region == nullptr) {
+        error() << "Default region of the world does not exist" << endmsg;
+        return StatusCode::FAILURE;
+      }
+      setCuts(*region);
+      continue;
+    }
+    bool found = false;
+    for (int iter_region = 0; iter_region < world->GetNoDaughters(); ++iter_region) {
+      if (world->GetDaughter(iter_region)->GetName().find(volumeName) != std::string::npos) {
+        G4LogicalVolume* volume = world->GetDaughter(iter_region)->GetLogicalVolume();
+        found = true;
+        // a volume is the root of one region only: the cuts of an existing region (e.g. of fast simulation) are set
+        if (volume->IsRootRegion() && volume->GetRegion() != nullptr &&
+            volume->GetRegion()->GetName() != "DefaultRegionForTheWorld") {
+          setCuts(*volume->GetRegion());
+          continue;
+        }
+        /// all G4Region objects are deleted by the G4RegionStore
+        m_g4regions.emplace_back(new G4Region(volume->GetName() + "_productionCuts"));
+        m_g4regions.back()->AddRootLogicalVolume(volume);
+        setCuts(*m_g4regions.back());
+      }
+    }
+    if (!found) {
+      error() << "Volume " << volumeName << " not found, production cuts cannot be set" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  for (const auto& regionName : m_regionNames) {
+    G4Region* region = G4RegionStore::GetInstance()->GetRegion(regionName, false);
+    if (region == nullptr) {
+      error() << "Region " << regionName << " not found, production cuts cannot be set" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    setCuts(*region);
+  }
+  return StatusCode::SUCCESS;
+}
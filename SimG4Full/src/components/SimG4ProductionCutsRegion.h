@@ -0,0 +1,66 @@
+#ifndef SIMG4FULL_SIMG4PRODUCTIONCUTSREGION_H
+#define SIMG4FULL_SIMG4PRODUCTIONCUTSREGION_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4RegionTool.h"
+
+// Geant
+class G4Region;
+
+/** @class SimG4ProductionCutsRegion SimG4Full/src/components/SimG4ProductionCutsRegion.h SimG4ProductionCutsRegion.h
+ *
+ *  Tool for setting the production cuts (range cuts of gamma, e-, e+ and proton) per region.
+ *  Regions are created for the volumes specified in the job options (\b'volumeNames'); "world" stands for the
+ *  default region of the world, so that its cuts are changed. Existing regions (e.g. created by other region tools,
+ *  or from GDML) may be given by name (\b'regionNames').
+ *  Negative cuts (default) keep the default cut of the physics list for that particle.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+*/
+
+class SimG4ProductionCutsRegion : public GaudiTool, virtual public ISimG4RegionTool {
+public:
+  explicit SimG4ProductionCutsRegion(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SimG4ProductionCutsRegion();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /**  Create regions and set their production cuts
+   *   @return status code
+   */
+  virtual StatusCode create() final;
+  /**  Nothing is created on the worker threads (the regions and their cuts are shared by the threads).
+   *   @return status code
+   */
+  inline virtual StatusCode createForWorker() final { return StatusCode::SUCCESS; }
+
+private:
+  /**  Set the production cuts of the region.
+   *   @param[in] aRegion region
+   */
+  void setCuts(G4Region& aRegion) const;
+  /// Regions created to set the cuts
+  /// deleted by the G4RegionStore
+  std::vector<G4Region*> m_g4regions;
+  /// Names of the volumes where the cuts are set ("world" for the default region) (set by job options)
+  Gaudi::Property<std::vector<std::string>> m_volumeNames{this, "volumeNames", {}, "Names of the volumes"};
+  /// Names of the existing regions where the cuts are set (set by job options)
+  Gaudi::Property<std::vector<std::string>> m_regionNames{this, "regionNames", {}, "Names of the existing regions"};
+  /// Range cut for gamma (negative to keep the default)
+  Gaudi::Property<double> m_cutGamma{this, "cutGamma", -1, "Range cut for gamma"};
+  /// Range cut for e- (negative to keep the default)
+  Gaudi::Property<double> m_cutElectron{this, "cutElectron", -1, "Range cut for e-"};
+  /// Range cut for e+ (negative to keep the default)
+  Gaudi::Property<double> m_cutPositron{this, "cutPositron", -1, "Range cut for e+"};
+  /// Range cut for proton (negative to keep the default)
+  Gaudi::Property<double> m_cutProton{this, "cutProton", -1, "Range cut for proton"};
+};
+
+#endif /* SIMG4FULL_SIMG4PRODUCTIONCUTSREGION_H */
@@ -0,0 +1,44 @@
+#include "SimG4RegionOfInterestActions.h"
+
+// FCCSW
+#include "SimG4Full/RegionOfInterestActions.h"
+
+DECLARE_COMPONENT(SimG4RegionOfInterestActions)
+
+SimG4RegionOfInterestActions::SimG4RegionOfInterestActions(const std::string& type, const std::string& name,
+                                                           const IInterface* parent)
+    : AlgTool(type, name, parent) {
+  declareInterface<ISimG4ActionTool>(this);
+}
+
+SimG4RegionOfInterestActions::~SimG4RegionOfInterestActions() {}
+
+StatusCode SimG4RegionOfInterestActions::initialize() {
+  if (AlgTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_deltaR <= 0 || m_minRadius < 0) {
+    error() << "Region of interest is not defined properly" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_counts = std::make_shared<sim::RegionOfInterestCounts>();
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4RegionOfInterestActions::finalize() {
+  info() << "Region of interest: " << m_counts->cones << " cones in " << m_counts->events << " events ("
+         << m_counts->eventsWithoutSeed << " without seed, simulated entirely), tracks killed at creation: "
+         << m_counts->killedAtCreation << ", when leaving the cones: " << m_counts->killedLeaving << endmsg;
+  return AlgTool::finalize();
+}
+
+G4VUserActionInitialization* SimG4RegionOfInterestActions::userActionInitialization() {
+  sim::RegionOfInterestSelection regionSelection;
+  regionSelection.seedPdgCodes.insert(m_seedPdgCodes.value().begin(), m_seedPdgCodes.value().end());
+  regionSelection.minSeedMomentum = m_minSeedMomentum;
+  regionSelection.deltaR = m_deltaR;
+  regionSelection.minRadius = m_minRadius;
+  regionSelection.killMaxEnergy = m_killMaxEnergy;
+  return new sim::RegionOfInterestActions(regionSelection, m_counts, m_history.enabled(), m_history.selection(),
+                                          m_countSteps);
+}
@@ -0,0 +1,71 @@
+#ifndef SIMG4FULL_G4REGIONOFINTERESTACTIONS_H
+#define SIMG4FULL_G4REGIONOFINTERESTACTIONS_H
+
+// Gaudi
+#include "GaudiKernel/AlgTool.h"
+#include "GaudiKernel/SystemOfUnits.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4ActionTool.h"
+#include "ParticleHistoryProperties.h"
+namespace sim {
+struct RegionOfInterestCounts;
+}
+
+// STL
+#include <cfloat>
+#include <memory>
+
+/** @class SimG4RegionOfInterestActions SimG4Full/src/components/SimG4RegionOfInterestActions.h
+ *  SimG4RegionOfInterestActions.h
+ *
+ *  Tool for loading full simulation user actions that restrict the simulation to a region of interest
+ *  (sim::RegionOfInterestStackingAction and sim::RegionOfInterestSteppingAction): the cones of radius \b'deltaR' in
+ *  pseudorapidity and azimuth around the primaries of the event (e.g. from SimG4PrimariesFromEdmTool) of types
+ *  \b'seedPdgCodes' with momentum above \b'minSeedMomentum'. The tracks further from the origin than
+ *  \b'minRadius' and with kinetic energy below \b'killMaxEnergy' are killed when created outside of the cones or
+ *  when leaving them. The cones and the killed tracks of each event are kept in the EventInformation (saved by
+ *  SimG4SaveRegionOfInterest), the numbers of the job are printed at finalization.
+ *  The particle history and the step counting are configured as in SimG4FullSimActions.
+ */
+
+class SimG4RegionOfInterestActions : public AlgTool, virtual public ISimG4ActionTool {
+public:
+  explicit SimG4RegionOfInterestActions(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SimG4RegionOfInterestActions();
+
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize: print the numbers of the cones and of the killed tracks.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /** Get the user action initialization.
+   *  @return pointer to G4VUserActionInitialization (ownership is transferred to the caller)
+   */
+  virtual G4VUserActionInitialization* userActionInitialization() final;
+
+private:
+  /// Numbers of the cones and of the killed tracks, filled by the actions of all threads
+  std::shared_ptr<sim::RegionOfInterestCounts> m_counts;
+  /// PDG codes of the primaries defining the cones (all if empty)
+  Gaudi::Property<std::vector<int>> m_seedPdgCodes{
+      this, "seedPdgCodes", {}, "PDG codes of the primaries defining the region of interest (all if empty)"};
+  /// Minimum momentum of the primaries defining the cones
+  Gaudi::Property<double> m_minSeedMomentum{this, "minSeedMomentum", 0,
+                                            "Minimum momentum of the primaries defining the region of interest"};
+  /// Radius of the cones in the pseudorapidity-azimuth plane
+  Gaudi::Property<double> m_deltaR{this, "deltaR", 0.4, "Radius of the cones in the pseudorapidity-azimuth plane"};
+  /// Minimum distance from the origin of the killed tracks
+  Gaudi::Property<double> m_minRadius{this, "minRadius", 0, "Minimum distance from the origin of the killed tracks"};
+  /// Maximum kinetic energy of the killed tracks
+  Gaudi::Property<double> m_killMaxEnergy{this, "killMaxEnergy", DBL_MAX, "Maximum kinetic energy of the killed tracks"};
+  /// Particle history and the selection of its particles
+  sim::ParticleHistoryProperties m_history{this};
+  /// Set to true to count tracks and steps of each event (e.g. for the profiling in SimG4Alg)
+  Gaudi::Property<bool> m_countSteps{this, "countSteps", false, "Set to true to count tracks and steps of each event"};
+};
+
+#endif /* SIMG4FULL_G4REGIONOFINTERESTACTIONS_H */
@@ -0,0 +1,157 @@
+#include "SimG4ScoringActions.h"
+
+// FCCSW
+#include "SimG4Full/ScoringActions.h"
+
+// Geant
+#include "G4SystemOfUnits.hh"
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+
+DECLARE_COMPONENT(SimG4ScoringActions)
+
+namespace {
+/// Names of the quantities, with their units in the output
+const std::array<std::pair<const char*, const char*>, sim::ScoringMesh::kNumQuantities> quantityNames{
+    {{"dose", "Gy"}, {"fluence", "cm-2"}, {"neqFluence", "cm-2"}}};
+}
+
+SimG4ScoringActions::SimG4ScoringActions(const std::string& type, const std::string& name, const IInterface* parent)
+    : AlgTool(type, name, parent) {
+  declareInterface<ISimG4ActionTool>(this);
+}
+
+SimG4ScoringActions::~SimG4ScoringActions() {}
+
+StatusCode SimG4ScoringActions::initialize() {
+  if (AlgTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  sim::ScoringMesh::Definition definition;
+  if (m_meshType != "cylinder" && m_meshType != "box") {
+    error() << "Unknown mesh type " << m_meshType.value() << ", use cylinder or box" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  definition.cylinder = m_meshType == "cylinder";
+  if (m_bins.size() != 3 || m_min.size() != 3 || m_max.size() != 3) {
+    error() << "Bins, lower and upper edges are needed for the three coordinates" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  for (size_t iCoord = 0; iCoord < 3; ++iCoord) {
+    if (m_bins[iCoord] < 1 || m_max[iCoord] <= m_min[iCoord]) {
+      error() << "Coordinate " << iCoord << " of the mesh needs a bin and an upper edge above the lower one" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    definition.bins[iCoord] = m_bins[iCoord];
+    definition.min[iCoord] = m_min[iCoord];
+    definition.max[iCoord] = m_max[iCoord];
+  }
+  if (definition.cylinder && (definition.min[0] < 0 || definition.max[1] - definition.min[1] > 2 * M_PI + 1e-9)) {
+    error() << "Radius of the mesh needs to be positive and its phi range at most 2 pi" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  std::set<sim::ScoringMesh::Quantity> quantities;
+  for (const auto& name : m_quantities) {
+    size_t iQuantity = 0;
+    while (iQuantity < quantityNames.size() && name != quantityNames[iQuantity].first) ++iQuantity;
+    if (iQuantity == quantityNames.size()) {
+      error() << "Unknown quantity " << name << ", use dose, fluence or neqFluence" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    quantities.insert(static_cast<sim::ScoringMesh::Quantity>(iQuantity));
+  }
+  for (const auto& damage : m_damageFunctions) {
+    if (damage.second.size() % 2 != 0) {
+      error() << "Damage function of " << damage.first << " needs pairs of energy and factor" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    std::vector<double> energies, factors;
+    for (size_t iPoint = 0; iPoint < damage.second.size(); iPoint += 2) {
+      if (!energies.empty() && damage.second[iPoint] * MeV <= energies.back()) {
+        error() << "Energies of the damage function of " << damage.first << " need to increase" << endmsg;
+        return StatusCode::FAILURE;
+      }
+      energies.push_back(damage.second[iPoint] * MeV);
+      factors.push_back(damage.second[iPoint + 1]);
+    }
+    m_selection.damage.set(damage.first, energies, factors);
+  }
+  if (quantities.count(sim::ScoringMesh::kNeqFluence) > 0 && m_selection.damage.empty()) {
+    error() << "The damage-weighted fluence needs the damage functions of the particles (damageFunctions)" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_selection.fluencePdgCodes = std::set<int>(m_fluencePdgCodes.begin(), m_fluencePdgCodes.end());
+  m_mesh = std::make_shared<sim::ScoringMesh>(definition, quantities);
+  m_selection.maxSegment = m_maxSegment > 0 ? m_maxSegment.value() : 0.5 * m_mesh->minWidth();
+  info() << "Scoring in a " << m_meshType.value() << " mesh of " << m_mesh->numBins() << " bins, "
+         << quantities.size() << " quantities" << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4ScoringActions::finalize() {
+  const sim::ScoringMesh::Sums sums = m_mesh->sums();
+  std::ofstream csv(m_filename.value());
+  if (!csv.good()) {
+    error() << "Unable to open the output file " << m_filename.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  const bool cylinder = m_mesh->definition().cylinder;
+  csv << (cylinder ? "ir,iphi,iz,r[mm],phi,z[mm]" : "ix,iy,iz,x[mm],y[mm],z[mm]");
+  // conversion from the Geant units and names of the scored quantities, in the order of the sums
+  std::vector<double> units(m_mesh->numQuantities());
+  std::vector<std::string> names(m_mesh->numQuantities()), unitNames(m_mesh->numQuantities());
+  for (size_t iQuantity = 0; iQuantity < quantityNames.size(); ++iQuantity) {
+    const int index = m_mesh->index(static_cast<sim::ScoringMesh::Quantity>(iQuantity));
+    if (index < 0) continue;
+    units[index] = iQuantity == sim::ScoringMesh::kDose ? 1. / gray : cm2;
+    names[index] = quantityNames[iQuantity].first;
+    unitNames[index] = quantityNames[iQuantity].second;
+  }
+  for (size_t index = 0; index < names.size(); ++index) {
+    csv << "," << names[index] << "[" << unitNames[index] << "]," << names[index] << "_error";
+  }
+  csv << "\n";
+  const double numEvents = std::max<unsigned long>(sums.events, 1);
+  const size_t numBins = m_mesh->numBins();
+  std::vector<double> maxima(names.size(), 0);
+  size_t numWritten = 0;
+  for (size_t iBin = 0; iBin < numBins; ++iBin) {
+    bool filled = false;
+    for (size_t index = 0; index < names.size(); ++index) {
+      filled |= sums.sum[index * numBins + iBin] != 0;
+    }
+    if (!filled) continue;
+    const auto indices = m_mesh->indices(iBin);
+    const auto centre = m_mesh->centre(iBin);
+    csv << indices[0] << "," << indices[1] << "," << indices[2] << "," << centre[0] << "," << centre[1] << ","
+        << centre[2];
+    for (size_t index = 0; index < names.size(); ++index) {
+      // mean per event and its statistical error, from the sums over the events
+      const double mean = sums.sum[index * numBins + iBin] / numEvents;
+      const double variance = std::max(sums.sum2[index * numBins + iBin] / numEvents - mean * mean, 0.);
+      csv << "," << mean * units[index] << "," << std::sqrt(variance / numEvents) * units[index];
+      maxima[index] = std::max(maxima[index], mean * units[index]);
+    }
+    csv << "\n";
+    ++numWritten;
+  }
+  csv.close();
+  if (!csv) {
+    error() << "Unable to write the output file " << m_filename.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  info() << "Scoring of " << sums.events << " events written to " << m_filename.value() << " (" << numWritten
+         << " of " << numBins << " bins)" << endmsg;
+  for (size_t index = 0; index < names.size(); ++index) {
+    info() << "\tmaximum " << names[index] << " per event: " << maxima[index] << " " << unitNames[index] << endmsg;
+  }
+  return AlgTool::finalize();
+}
+
+G4VUserActionInitialization* SimG4ScoringActions::userActionInitialization() {
+  return new sim::ScoringActions(m_mesh, m_selection);
+}
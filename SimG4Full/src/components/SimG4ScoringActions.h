@@ -0,0 +1,79 @@
+#ifndef SIMG4FULL_G4SCORINGACTIONS_H
+#define SIMG4FULL_G4SCORINGACTIONS_H
+
+// Gaudi
+#include "GaudiKernel/AlgTool.h"
+#include "GaudiKernel/SystemOfUnits.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4ActionTool.h"
+#include "SimG4Full/ScoringAction.h"
+
+// STL
+#include <cmath>
+#include <map>
+#include <memory>
+
+/** @class SimG4ScoringActions SimG4Full/src/components/SimG4ScoringActions.h SimG4ScoringActions.h
+ *
+ *  Tool for loading the scoring of the radiation in a mesh (sim::ScoringActions), to be chained to
+ *  SimG4FullSimActions (\b'chainedActions'); one tool per mesh.
+ *  The mesh (\b'meshType' "cylinder" with the bins in r, phi, z or "box" with the bins in x, y, z) has
+ *  \b'bins' bins between \b'min' and \b'max' for each coordinate. The \b'quantities' "dose" (ionising dose),
+ *  "fluence" (of the particles \b'fluencePdgCodes', all if empty) and "neqFluence" (weighted by the damage functions
+ *  \b'damageFunctions': by PDG code, pairs of kinetic energy [MeV] and factor) are accumulated by each thread and
+ *  merged at the end of the run. Only the maps are written, at finalization, to the CSV file \b'filename': the mean
+ *  per event and its statistical error of each quantity, for the bins with a deposit.
+ */
+
+class SimG4ScoringActions : public AlgTool, virtual public ISimG4ActionTool {
+public:
+  explicit SimG4ScoringActions(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SimG4ScoringActions();
+
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize: write the maps.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /** Get the user action initialization.
+   *  @return pointer to G4VUserActionInitialization (ownership is transferred to the caller)
+   */
+  virtual G4VUserActionInitialization* userActionInitialization() final;
+
+private:
+  /// Mesh filled by the user actions of all threads
+  std::shared_ptr<sim::ScoringMesh> m_mesh;
+  /// Selection of the scored particles
+  sim::ScoringSelection m_selection;
+  /// Type of the mesh
+  Gaudi::Property<std::string> m_meshType{this, "meshType", "cylinder",
+                                          "Type of the mesh: cylinder (r, phi, z) or box (x, y, z)"};
+  /// Number of bins of each coordinate
+  Gaudi::Property<std::vector<unsigned int>> m_bins{this, "bins", {1, 1, 1}, "Number of bins of each coordinate"};
+  /// Lower edges of the coordinates
+  Gaudi::Property<std::vector<double>> m_min{
+      this, "min", {0, -M_PI, 0}, "Lower edges of the coordinates (lengths in mm, phi in rad)"};
+  /// Upper edges of the coordinates
+  Gaudi::Property<std::vector<double>> m_max{
+      this, "max", {0, M_PI, 0}, "Upper edges of the coordinates (lengths in mm, phi in rad)"};
+  /// Scored quantities
+  Gaudi::Property<std::vector<std::string>> m_quantities{
+      this, "quantities", {"dose", "neqFluence"}, "Scored quantities: dose, fluence, neqFluence"};
+  /// PDG codes of the particles of the fluence
+  Gaudi::Property<std::vector<int>> m_fluencePdgCodes{
+      this, "fluencePdgCodes", {}, "PDG codes of the particles of the fluence (all if empty)"};
+  /// Damage functions by PDG code
+  Gaudi::Property<std::map<int, std::vector<double>>> m_damageFunctions{
+      this, "damageFunctions", {}, "Damage functions by PDG code: pairs of kinetic energy [MeV] and factor"};
+  /// Maximum length of the parts of the steps
+  Gaudi::Property<double> m_maxSegment{
+      this, "maxSegment", 0, "Maximum length of the parts of the steps [mm] (0: half of the smallest bin width)"};
+  /// Name of the CSV output file
+  Gaudi::Property<std::string> m_filename{this, "filename", "scoring.csv", "Name of the CSV output file"};
+};
+
+#endif /* SIMG4FULL_G4SCORINGACTIONS_H */
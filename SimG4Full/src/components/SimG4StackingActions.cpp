@@ -0,0 +1,43 @@
+#include "SimG4StackingActions.h"
+
+// FCCSW
+#include "SimG4Full/StackingActions.h"
+
+DECLARE_COMPONENT(SimG4StackingActions)
+
+SimG4StackingActions::SimG4StackingActions(const std::string& type, const std::string& name, const IInterface* parent)
+    : AlgTool(type, name, parent) {
+  declareInterface<ISimG4ActionTool>(this);
+}
+
+SimG4StackingActions::~SimG4StackingActions() {}
+
+StatusCode SimG4StackingActions::initialize() {
+  if (AlgTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_maxRadius <= 0 || m_maxZ <= 0) {
+    error() << "Region of interest is not defined properly" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_counts = std::make_shared<sim::StackingCounts>();
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4StackingActions::finalize() {
+  info() << "Secondary tracks killed at creation: " << m_counts->killed << ", outside of the region of interest: "
+         << m_counts->pruned << ", postponed: " << m_counts->postponed << endmsg;
+  return AlgTool::finalize();
+}
+
+G4VUserActionInitialization* SimG4StackingActions::userActionInitialization() {
+  sim::StackingSelection stackingSelection;
+  stackingSelection.killPdgCodes.insert(m_killPdgCodes.value().begin(), m_killPdgCodes.value().end());
+  stackingSelection.postponePdgCodes.insert(m_postponePdgCodes.value().begin(), m_postponePdgCodes.value().end());
+  stackingSelection.postponeMaxEnergy = m_postponeMaxEnergy;
+  stackingSelection.maxRadius = m_maxRadius;
+  stackingSelection.maxZ = m_maxZ;
+  stackingSelection.pruneMaxEnergy = m_pruneMaxEnergy;
+  return new sim::StackingActions(stackingSelection, m_counts, m_history.enabled(), m_history.selection(),
+                                  m_countSteps);
+}
@@ -0,0 +1,72 @@
+#ifndef SIMG4FULL_G4STACKINGACTIONS_H
+#define SIMG4FULL_G4STACKINGACTIONS_H
+
+// Gaudi
+#include "GaudiKernel/AlgTool.h"
+#include "GaudiKernel/SystemOfUnits.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4ActionTool.h"
+#include "ParticleHistoryProperties.h"
+namespace sim {
+struct StackingCounts;
+}
+
+// STL
+#include <cfloat>
+#include <memory>
+
+/** @class SimG4StackingActions SimG4Full/src/components/SimG4StackingActions.h SimG4StackingActions.h
+ *
+ *  Tool for loading full simulation user actions together with the stacking action (sim::StackingAction).
+ *  The secondary tracks of the particles \b'killPdgCodes' (neutrinos by default) are killed at their creation, the
+ *  tracks created outside of the region of interest (\b'maxRadius', \b'maxZ') below \b'pruneMaxEnergy' are killed,
+ *  and the tracks of the particles \b'postponePdgCodes' below \b'postponeMaxEnergy' are tracked after all the other
+ *  tracks of the event. The numbers of the classified tracks are printed at finalization.
+ *  The particle history and the step counting are configured as in SimG4FullSimActions.
+ */
+
+class SimG4StackingActions : public AlgTool, virtual public ISimG4ActionTool {
+public:
+  explicit SimG4StackingActions(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SimG4StackingActions();
+
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize: print the numbers of the classified tracks.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /** Get the user action initialization.
+   *  @return pointer to G4VUserActionInitialization (ownership is transferred to the caller)
+   */
+  virtual G4VUserActionInitialization* userActionInitialization() final;
+
+private:
+  /// Numbers of the classified tracks, filled by the actions of all threads
+  std::shared_ptr<sim::StackingCounts> m_counts;
+  /// PDG codes of the particles killed at their creation
+  Gaudi::Property<std::vector<int>> m_killPdgCodes{
+      this, "killPdgCodes", {12, -12, 14, -14, 16, -16}, "PDG codes of the particles killed at their creation"};
+  /// PDG codes of the postponed particles
+  Gaudi::Property<std::vector<int>> m_postponePdgCodes{
+      this, "postponePdgCodes", {}, "PDG codes of the particles tracked after the other tracks of the event"};
+  /// Maximum kinetic energy of the postponed particles
+  Gaudi::Property<double> m_postponeMaxEnergy{this, "postponeMaxEnergy", DBL_MAX,
+                                              "Maximum kinetic energy of the postponed particles"};
+  /// Radius of the region of interest
+  Gaudi::Property<double> m_maxRadius{this, "maxRadius", DBL_MAX, "Radius of the region of interest"};
+  /// Half-length of the region of interest
+  Gaudi::Property<double> m_maxZ{this, "maxZ", DBL_MAX, "Half-length of the region of interest"};
+  /// Maximum kinetic energy of the tracks killed outside the region of interest
+  Gaudi::Property<double> m_pruneMaxEnergy{this, "pruneMaxEnergy", DBL_MAX,
+                                           "Maximum kinetic energy of the tracks killed outside the region of interest"};
+  /// Particle history and the selection of its particles
+  sim::ParticleHistoryProperties m_history{this};
+  /// Set to true to count tracks and steps of each event (e.g. for the profiling in SimG4Alg)
+  Gaudi::Property<bool> m_countSteps{this, "countSteps", false, "Set to true to count tracks and steps of each event"};
+};
+
+#endif /* SIMG4FULL_G4STACKINGACTIONS_H */
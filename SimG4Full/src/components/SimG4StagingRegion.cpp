@@ -0,0 +1,71 @@
+#include "SimG4StagingRegion.h"
+
+// FCCSW
+#include "SimG4Full/StagingAction.h"
+
+// Geant4
+#include "G4LogicalVolume.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+
+DECLARE_COMPONENT(SimG4StagingRegion)
+
+SimG4StagingRegion::SimG4StagingRegion(const std::string& type, const std::string& name, const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareInterface<ISimG4RegionTool>(this);
+}
+
+SimG4StagingRegion::~SimG4StagingRegion() {}
+
+StatusCode SimG4StagingRegion::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_envelopeVolumes.empty()) {
+    error() << "No envelope volume is specified for the staged simulation" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_counts = std::make_shared<sim::StagingCounts>();
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4StagingRegion::finalize() {
+  info() << "Stopped " << m_counts->tracks << " tracks entering the envelopes" << endmsg;
+  return GaudiTool::finalize();
+}
+
+StatusCode SimG4StagingRegion::create() {
+  for (const auto& volumeName : m_envelopeVolumes) {
+    bool found = false;
+    for (const G4VPhysicalVolume* volume : *G4PhysicalVolumeStore::GetInstance()) {
+      if (volume->GetName().find(volumeName) != std::string::npos) {
+        m_envelopes.insert(volume->GetLogicalVolume());
+        found = true;
+      }
+    }
+    if (!found) {
+      error() << "Envelope volume " << volumeName << " not found" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  // the entry into the envelopes is checked by the actions of all the regions
+  m_actionRegions.assign(G4RegionStore::GetInstance()->begin(), G4RegionStore::GetInstance()->end());
+  setActions();
+  info() << "Stopping the tracks entering " << m_envelopes.size() << " envelope volumes" << endmsg;
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4StagingRegion::createForWorker() {
+  // the regional stepping actions are thread-local: the worker gets actions of its own in the same regions
+  setActions();
+  return StatusCode::SUCCESS;
+}
+
+void SimG4StagingRegion::setActions() {
+  for (G4Region* region : m_actionRegions) {
+    m_actions.push_back(
+        std::make_unique<sim::StagingAction>(m_envelopes, m_counts, region->GetRegionalSteppingAction()));
+    region->SetRegionalSteppingAction(m_actions.back().get());
+  }
+}
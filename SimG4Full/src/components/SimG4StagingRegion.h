@@ -0,0 +1,72 @@
+#ifndef SIMG4FULL_SIMG4STAGINGREGION_H
+#define SIMG4FULL_SIMG4STAGINGREGION_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4RegionTool.h"
+
+// STL
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+class G4LogicalVolume;
+class G4Region;
+namespace sim {
+class StagingAction;
+struct StagingCounts;
+}
+
+/** @class SimG4StagingRegion SimG4Full/src/components/SimG4StagingRegion.h SimG4StagingRegion.h
+ *
+ *  Tool for the first stage of a staged simulation: the tracks entering the envelope volumes (\b'envelopeVolumes',
+ *  e.g. the calorimeters) are stopped at their boundary by the regional stepping action sim::StagingAction, set in
+ *  all the regions (chained with the regional actions they had), and their state at the boundary is kept in the
+ *  EventInformation, to be saved by SimG4SaveStagedParticles. The second stage simulates the saved particles, read
+ *  by SimG4PrimariesFromEdmTool, e.g. with other materials, cuts or fast simulation in the envelope.
+ *  The tool needs to be given after the other region tools. In the multi-threaded mode each worker thread sets its
+ *  own actions in the same regions. The number of the staged tracks is printed at the finalisation.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+ */
+
+class SimG4StagingRegion : public GaudiTool, virtual public ISimG4RegionTool {
+public:
+  explicit SimG4StagingRegion(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SimG4StagingRegion();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize.
+   *   Print the number of the staged tracks.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /**  Set the staging actions in the regions
+   *   @return status code
+   */
+  virtual StatusCode create() final;
+  /**  Set the staging actions of the worker thread in the regions of create()
+   *   @return status code
+   */
+  virtual StatusCode createForWorker() final;
+
+private:
+  /// Set the staging actions in all the regions, chained with the regional actions of the calling thread
+  void setActions();
+  /// Staging actions per region (owned by the tool, as the regions do not delete them)
+  std::vector<std::unique_ptr<sim::StagingAction>> m_actions;
+  /// Regions of the staging actions
+  std::vector<G4Region*> m_actionRegions;
+  /// Logical volumes of the envelopes, given to the actions of all the threads
+  std::unordered_set<const G4LogicalVolume*> m_envelopes;
+  /// Numbers of the staged tracks (of all the threads)
+  std::shared_ptr<sim::StagingCounts> m_counts;
+  /// Names of the envelope volumes at whose boundary the entering tracks are stopped
+  Gaudi::Property<std::vector<std::string>> m_envelopeVolumes{
+      this, "envelopeVolumes", {}, "Names of the volumes at whose boundary the entering tracks are stopped and saved"};
+};
+
+#endif /* SIMG4FULL_SIMG4STAGINGREGION_H */
@@ -0,0 +1,79 @@
+#include "SimG4SteppingProfilerActions.h"
+
+// FCCSW
+#include "SimG4Full/SteppingProfileActions.h"
+
+// Geant
+#include "G4SystemOfUnits.hh"
+
+// STL
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+DECLARE_COMPONENT(SimG4SteppingProfilerActions)
+
+SimG4SteppingProfilerActions::SimG4SteppingProfilerActions(const std::string& type, const std::string& name,
+                                                           const IInterface* parent)
+    : AlgTool(type, name, parent) {
+  declareInterface<ISimG4ActionTool>(this);
+}
+
+SimG4SteppingProfilerActions::~SimG4SteppingProfilerActions() {}
+
+StatusCode SimG4SteppingProfilerActions::initialize() {
+  if (AlgTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  m_profile = std::make_shared<sim::SteppingProfile>();
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4SteppingProfilerActions::finalize() {
+  std::vector<std::pair<std::string, sim::SteppingProfile::Table>> tables = {
+      {"detector", m_profile->detectors()},
+      {"volume", m_profile->volumes()},
+      {"region", m_profile->regions()},
+      {"particle", m_profile->particles()}};
+  if (m_perProcess) tables.emplace_back("process", m_profile->processes());
+  std::ofstream csv;
+  if (!m_filename.value().empty()) {
+    csv.open(m_filename.value());
+    if (!csv.good()) {
+      error() << "Unable to open the output file " << m_filename.value() << endmsg;
+      return StatusCode::FAILURE;
+    }
+    csv << "type,name,steps,time[s],energy[GeV],steps/s\n";
+  }
+  for (const auto& table : tables) {
+    // sort by time (by number of steps if the time is not measured)
+    std::vector<std::pair<std::string, sim::SteppingProfile::Entry>> entries(table.second.begin(),
+                                                                             table.second.end());
+    std::sort(entries.begin(), entries.end(), [](const auto& aLhs, const auto& aRhs) {
+      return aLhs.second.time != aRhs.second.time ? aLhs.second.time > aRhs.second.time
+                                                  : aLhs.second.steps > aRhs.second.steps;
+    });
+    info() << "Stepping profile per " << table.first << " (" << entries.size() << " entries):" << endmsg;
+    for (size_t iEntry = 0; iEntry < entries.size(); ++iEntry) {
+      const auto& entry = entries[iEntry];
+      // navigation speed, the figure of merit of the geometry when the physics is switched off (geantinos)
+      const double rate = entry.second.time > 0 ? entry.second.steps / entry.second.time : 0;
+      if (iEntry < m_numEntries) {
+        info() << std::setw(table.first == "process" ? 60 : 40) << std::left << entry.first << " steps "
+               << std::setw(12) << entry.second.steps << " time " << std::setw(12) << entry.second.time << " s, energy " << entry.second.energy / GeV
+               << " GeV, " << rate << " steps/s" << endmsg;
+      }
+      if (csv.is_open()) {
+        csv << table.first << "," << entry.first << "," << entry.second.steps << "," << entry.second.time << ","
+            << entry.second.energy / GeV << "," << rate << "\n";
+      }
+    }
+  }
+  return AlgTool::finalize();
+}
+
+G4VUserActionInitialization* SimG4SteppingProfilerActions::userActionInitialization() {
+  return new sim::SteppingProfileActions(m_profile, m_measureTime, m_perProcess, m_history.enabled(),
+                                         m_history.selection());
+}
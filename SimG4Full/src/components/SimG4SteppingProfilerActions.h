@@ -0,0 +1,63 @@
+#ifndef SIMG4FULL_G4STEPPINGPROFILERACTIONS_H
+#define SIMG4FULL_G4STEPPINGPROFILERACTIONS_H
+
+// Gaudi
+#include "GaudiKernel/AlgTool.h"
+#include "GaudiKernel/SystemOfUnits.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4ActionTool.h"
+#include "ParticleHistoryProperties.h"
+namespace sim {
+class SteppingProfile;
+}
+
+// STL
+#include <memory>
+
+/** @class SimG4SteppingProfilerActions SimG4Full/src/components/SimG4SteppingProfilerActions.h
+ * SimG4SteppingProfilerActions.h
+ *
+ *  Tool for loading full simulation user actions together with the stepping profiler.
+ *  Number of steps, CPU time and deposited energy are accumulated per sub-detector (placement in the world), logical
+ *  volume, region and particle type, and the number of steps per second of CPU time is reported.
+ *  With \b'perProcess' they are also accumulated per particle type, region and process that limited the step.
+ *  The profile is printed at finalization (\b'numEntries' most expensive entries of each table), and optionally
+ *  written to a CSV file (\b'filename').
+ */
+
+class SimG4SteppingProfilerActions : public AlgTool, virtual public ISimG4ActionTool {
+public:
+  explicit SimG4SteppingProfilerActions(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SimG4SteppingProfilerActions();
+
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize: print and save the profile.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /** Get the user action initialization.
+   *  @return pointer to G4VUserActionInitialization (ownership is transferred to the caller)
+   */
+  virtual G4VUserActionInitialization* userActionInitialization() final;
+
+private:
+  /// Profile filled by the user actions of all threads
+  std::shared_ptr<sim::SteppingProfile> m_profile;
+  /// Set to true to measure the CPU time
+  Gaudi::Property<bool> m_measureTime{this, "measureTime", true, "Set to true to measure the CPU time per step"};
+  /// Set to true to accumulate the steps per particle type, region and process
+  Gaudi::Property<bool> m_perProcess{this, "perProcess", false,
+                                     "Set to true to accumulate the steps per particle type, region and process"};
+  /// Number of entries printed for each table
+  Gaudi::Property<unsigned int> m_numEntries{this, "numEntries", 20, "Number of entries printed for each table"};
+  /// Name of the CSV output file (no output if empty)
+  Gaudi::Property<std::string> m_filename{this, "filename", "", "Name of the CSV output file (no file if empty)"};
+  /// Particle history and the selection of its particles
+  sim::ParticleHistoryProperties m_history{this};
+};
+
+#endif /* SIMG4FULL_G4STEPPINGPROFILERACTIONS_H */
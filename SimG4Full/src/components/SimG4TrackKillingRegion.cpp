@@ -0,0 +1,153 @@
+#include "SimG4TrackKillingRegion.h"
+
+// FCCSW
+#include "SimG4Full/TrackKillingAction.h"
+
+// Geant4
+#include "G4LogicalVolume.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4TransportationManager.hh"
+
+#include "GaudiKernel/SystemOfUnits.h"
+
+// STL
+#include <algorithm>
+
+DECLARE_COMPONENT(SimG4TrackKillingRegion)
+
+SimG4TrackKillingRegion::SimG4TrackKillingRegion(const std::string& type, const std::string& name,
+                                                 const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareInterface<ISimG4RegionTool>(this);
+}
+
+SimG4TrackKillingRegion::~SimG4TrackKillingRegion() {}
+
+StatusCode SimG4TrackKillingRegion::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_volumeNames.empty() && m_killVolumes.empty()) {
+    error() << "No volume is specified for the track killing" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if (!m_volumeNames.empty() && m_minKineticEnergy.value().empty() && m_maxTime.value().empty()) {
+    warning() << "No threshold is given, only the tracks entering the kill volumes are killed" << endmsg;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4TrackKillingRegion::finalize() {
+  const char* reasons[] = {"below the kinetic energy", "above the time", "entering a kill volume"};
+  for (const auto& actionRegion : m_actionRegions) {
+    // sum of the actions of the threads in the region
+    std::map<std::pair<sim::TrackKillingAction::Reason, int>, sim::TrackKillingAction::Count> counts;
+    for (const auto& action : m_actions) {
+      if (action.first != actionRegion.first) continue;
+      for (const auto& count : action.second->counts()) {
+        auto& sum = counts[count.first];
+        sum.particle = count.second.particle;
+        sum.tracks += count.second.tracks;
+        sum.energy += count.second.energy;
+      }
+    }
+    for (const auto& count : counts) {
+      info() << "Region " << actionRegion.first->GetName() << ": killed " << count.second.tracks << " "
+             << count.second.particle << " " << reasons[count.first.first] << ", with "
+             << count.second.energy / CLHEP::MeV << " MeV of kinetic energy" << endmsg;
+    }
+  }
+  return GaudiTool::finalize();
+}
+
+StatusCode SimG4TrackKillingRegion::create() {
+  G4LogicalVolume* world =
+      (*G4TransportationManager::GetTransportationManager()->GetWorldsIterator())->GetLogicalVolume();
+  // regions of the thresholds
+  std::vector<G4Region*> thresholdRegions;
+  for (const auto& volumeName : m_volumeNames) {
+    // "world" applies the thresholds in the default region, used by all the volumes outside of other regions
+    if (volumeName == "world") {
+      G4Region* region = G4RegionStore::GetInstance()->GetRegion("DefaultRegionForTheWorld", false);
+      if (region == nullptr) {
+        error() << "Default region of the world does not exist" << endmsg;
+        return StatusCode::FAILURE;
+      }
+      thresholdRegions.push_back(region);
+      continue;
+    }
+    bool found = false;
+    for (int iter_region = 0; iter_region < world->GetNoDaughters(); ++iter_region) {
+      if (world->GetDaughter(iter_region)->GetName().find(volumeName) != std::string::npos) {
+        G4LogicalVolume* volume = world->GetDaughter(iter_region)->GetLogicalVolume();
+        found = true;
+        // a volume is the root of one region only: the thresholds are applied in the existing region
+        if (volume->IsRootRegion() && volume->GetRegion() != nullptr &&
+            volume->GetRegion()->GetName() != "DefaultRegionForTheWorld") {
+          thresholdRegions.push_back(volume->GetRegion());
+          continue;
+        }
+        /// all G4Region objects are deleted by the G4RegionStore
+        m_g4regions.emplace_back(new G4Region(volume->GetName() + "_trackKilling"));
+        m_g4regions.back()->AddRootLogicalVolume(volume);
+        thresholdRegions.push_back(m_g4regions.back());
+      }
+    }
+    if (!found) {
+      error() << "Volume " << volumeName << " not found, tracks cannot be killed there" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  for (const auto& volumeName : m_killVolumes) {
+    bool found = false;
+    for (const G4VPhysicalVolume* volume : *G4PhysicalVolumeStore::GetInstance()) {
+      if (volume->GetName().find(volumeName) != std::string::npos) {
+        m_g4KillVolumes.insert(volume->GetLogicalVolume());
+        found = true;
+      }
+    }
+    if (!found) {
+      error() << "Kill volume " << volumeName << " not found" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  for (const auto& threshold : m_minKineticEnergy) {
+    m_g4MinKineticEnergy[threshold.first] = threshold.second / Gaudi::Units::MeV * CLHEP::MeV;
+  }
+  for (const auto& threshold : m_maxTime) {
+    m_g4MaxTime[threshold.first] = threshold.second / Gaudi::Units::ns * CLHEP::ns;
+  }
+  // the entry into the kill volumes is checked by the actions of all the regions
+  for (G4Region* region : *G4RegionStore::GetInstance()) {
+    const bool thresholds =
+        std::find(thresholdRegions.begin(), thresholdRegions.end(), region) != thresholdRegions.end();
+    if (!thresholds && m_g4KillVolumes.empty()) continue;
+    m_actionRegions.emplace_back(region, thresholds);
+    setAction(region, thresholds);
+    if (thresholds) {
+      info() << "Killing the tracks below the thresholds in the region " << region->GetName() << endmsg;
+    }
+  }
+  if (!m_g4KillVolumes.empty()) {
+    info() << "Killing the tracks entering " << m_g4KillVolumes.size() << " volumes" << endmsg;
+  }
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4TrackKillingRegion::createForWorker() {
+  // the regional stepping actions are thread-local: the worker gets actions of its own in the same regions
+  for (const auto& actionRegion : m_actionRegions) {
+    setAction(actionRegion.first, actionRegion.second);
+  }
+  return StatusCode::SUCCESS;
+}
+
+void SimG4TrackKillingRegion::setAction(G4Region* aRegion, bool aThresholds) {
+  m_actions.emplace_back(aRegion, std::make_unique<sim::TrackKillingAction>(
+                                      aThresholds ? m_g4MinKineticEnergy : std::map<int, double>(),
+                                      aThresholds ? m_g4MaxTime : std::map<int, double>(), m_g4KillVolumes,
+                                      aRegion->GetRegionalSteppingAction()));
+  aRegion->SetRegionalSteppingAction(m_actions.back().second.get());
+}
@@ -0,0 +1,90 @@
+#ifndef SIMG4FULL_SIMG4TRACKKILLINGREGION_H
+#define SIMG4FULL_SIMG4TRACKKILLINGREGION_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4RegionTool.h"
+
+// STL
+#include <map>
+#include <memory>
+#include <unordered_set>
+
+// Geant
+class G4LogicalVolume;
+class G4Region;
+namespace sim {
+class TrackKillingAction;
+}
+
+/** @class SimG4TrackKillingRegion SimG4Full/src/components/SimG4TrackKillingRegion.h SimG4TrackKillingRegion.h
+ *
+ *  Tool for killing the tracks per particle type below a kinetic energy (\b'minKineticEnergy') or above a global time
+ *  (\b'maxTime'), in the regions of the volumes specified in the job options (\b'volumeNames', "world" standing for
+ *  the default region of the world), and the tracks entering the kill volumes (\b'killVolumes').
+ *  Contrary to SimG4UserLimitRegion it does not need any process in the physics list: the tracks are killed by the
+ *  regional stepping action sim::TrackKillingAction, set in the regions (chained with the regional action they had).
+ *  The entry into the kill volumes is checked in all the regions existing when the tool is called, so the tool needs
+ *  to be given after the other region tools. In the multi-threaded mode each worker thread sets its own actions in the
+ *  same regions. The killed tracks are counted per region, reason and particle type (summed over the threads), and
+ *  printed at the finalisation.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+*/
+
+class SimG4TrackKillingRegion : public GaudiTool, virtual public ISimG4RegionTool {
+public:
+  explicit SimG4TrackKillingRegion(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SimG4TrackKillingRegion();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize.
+   *   Print the killed tracks.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /**  Create regions and set the killing actions
+   *   @return status code
+   */
+  virtual StatusCode create() final;
+  /**  Set the killing actions of the worker thread in the regions of create()
+   *   @return status code
+   */
+  virtual StatusCode createForWorker() final;
+
+private:
+  /** Set a killing action in the region, chained with the regional action of the region in the calling thread.
+   *  @param[in] aRegion region
+   *  @param[in] aThresholds flag whether the thresholds are applied in the region
+   */
+  void setAction(G4Region* aRegion, bool aThresholds);
+  /// Regions created for the thresholds
+  /// deleted by the G4RegionStore
+  std::vector<G4Region*> m_g4regions;
+  /// Killing actions per region (owned by the tool, as the regions do not delete them)
+  std::vector<std::pair<const G4Region*, std::unique_ptr<sim::TrackKillingAction>>> m_actions;
+  /// Regions of the killing actions, with the flag whether the thresholds are applied
+  std::vector<std::pair<G4Region*, bool>> m_actionRegions;
+  /// Thresholds in Geant4 units, given to the actions of all the threads
+  std::map<int, double> m_g4MinKineticEnergy;
+  std::map<int, double> m_g4MaxTime;
+  /// Logical volumes in which the entering tracks are killed
+  std::unordered_set<const G4LogicalVolume*> m_g4KillVolumes;
+  /// Names of the volumes where the thresholds are applied ("world" for the default region) (set by job options)
+  Gaudi::Property<std::vector<std::string>> m_volumeNames{
+      this, "volumeNames", {}, "Names of the volumes where the thresholds are applied"};
+  /// Minimum kinetic energy per PDG code (0 for all the other particles)
+  Gaudi::Property<std::map<int, double>> m_minKineticEnergy{
+      this, "minKineticEnergy", {}, "Minimum kinetic energy per PDG code (0 for all the other particles)"};
+  /// Maximum global time per PDG code (0 for all the other particles)
+  Gaudi::Property<std::map<int, double>> m_maxTime{
+      this, "maxTime", {}, "Maximum global time per PDG code (0 for all the other particles)"};
+  /// Names of the volumes in which the entering tracks are killed
+  Gaudi::Property<std::vector<std::string>> m_killVolumes{
+      this, "killVolumes", {}, "Names of the volumes in which the entering tracks are killed"};
+};
+
+#endif /* SIMG4FULL_SIMG4TRACKKILLINGREGION_H */
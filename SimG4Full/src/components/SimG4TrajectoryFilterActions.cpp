@@ -0,0 +1,41 @@
+#include "SimG4TrajectoryFilterActions.h"
+
+// FCCSW
+#include "SimG4Full/TrajectoryFilterActions.h"
+
+DECLARE_COMPONENT(SimG4TrajectoryFilterActions)
+
+SimG4TrajectoryFilterActions::SimG4TrajectoryFilterActions(const std::string& type, const std::string& name,
+                                                           const IInterface* parent)
+    : AlgTool(type, name, parent) {
+  declareInterface<ISimG4ActionTool>(this);
+}
+
+SimG4TrajectoryFilterActions::~SimG4TrajectoryFilterActions() {}
+
+StatusCode SimG4TrajectoryFilterActions::initialize() {
+  if (AlgTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_trajectoryType < 1 || m_trajectoryType > 4) {
+    error() << "Type of the trajectories needs to be between 1 and 4" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  m_counts = std::make_shared<sim::TrajectoryFilterCounts>();
+  return StatusCode::SUCCESS;
+}
+
+StatusCode SimG4TrajectoryFilterActions::finalize() {
+  info() << "Trajectories stored for " << m_counts->stored << " of " << m_counts->tracks << " tracks" << endmsg;
+  return AlgTool::finalize();
+}
+
+G4VUserActionInitialization* SimG4TrajectoryFilterActions::userActionInitialization() {
+  sim::TrajectorySelection selection;
+  selection.primaryOnly = m_primaryOnly;
+  selection.minMomentum = m_minMomentum;
+  selection.pdgCodes.insert(m_pdgCodes.value().begin(), m_pdgCodes.value().end());
+  selection.regions.insert(m_regions.value().begin(), m_regions.value().end());
+  selection.trajectoryType = m_trajectoryType;
+  return new sim::TrajectoryFilterActions(selection, m_counts);
+}
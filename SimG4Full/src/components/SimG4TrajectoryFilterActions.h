@@ -0,0 +1,63 @@
+#ifndef SIMG4FULL_G4TRAJECTORYFILTERACTIONS_H
+#define SIMG4FULL_G4TRAJECTORYFILTERACTIONS_H
+
+// Gaudi
+#include "GaudiKernel/AlgTool.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4ActionTool.h"
+namespace sim {
+struct TrajectoryFilterCounts;
+}
+
+// STL
+#include <memory>
+
+/** @class SimG4TrajectoryFilterActions SimG4Full/src/components/SimG4TrajectoryFilterActions.h
+ * SimG4TrajectoryFilterActions.h
+ *
+ *  Tool for loading the selective storage of the trajectories (sim::TrajectoryFilterActions), to be chained to
+ *  SimG4FullSimActions (\b'chainedActions'). The trajectory is created only for the tracks selected as in
+ *  SimG4SaveTrajectory (\b'primaryOnly', \b'minMomentum', \b'pdgCodes', \b'regions'), so that the command
+ *  "/tracking/storeTrajectory 1" is not needed. The type of the trajectories is \b'trajectoryType' (as the argument
+ *  of the command). The numbers of tracks and of stored trajectories are printed at finalization.
+ */
+
+class SimG4TrajectoryFilterActions : public AlgTool, virtual public ISimG4ActionTool {
+public:
+  explicit SimG4TrajectoryFilterActions(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SimG4TrajectoryFilterActions();
+
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Finalize: print the numbers of stored trajectories.
+   *   @return status code
+   */
+  virtual StatusCode finalize() final;
+  /** Get the user action initialization.
+   *  @return pointer to G4VUserActionInitialization (ownership is transferred to the caller)
+   */
+  virtual G4VUserActionInitialization* userActionInitialization() final;
+
+private:
+  /// Numbers filled by the user actions of all threads
+  std::shared_ptr<sim::TrajectoryFilterCounts> m_counts;
+  /// Flag whether only the trajectories of the primary particles are stored
+  Gaudi::Property<bool> m_primaryOnly{this, "primaryOnly", false, "Store only the trajectories of primary particles"};
+  /// Minimal initial momentum of the stored trajectories
+  Gaudi::Property<double> m_minMomentum{this, "minMomentum", 0, "Minimal initial momentum of the stored trajectories"};
+  /// PDG codes of the stored trajectories (all if empty)
+  Gaudi::Property<std::vector<int>> m_pdgCodes{
+      this, "pdgCodes", {}, "PDG codes of the stored trajectories (all if empty)"};
+  /// Regions in which the stored trajectories start (all if empty)
+  Gaudi::Property<std::vector<std::string>> m_regions{
+      this, "regions", {}, "Names of the regions in which the stored trajectories start (all if empty)"};
+  /// Type of the stored trajectories
+  Gaudi::Property<int> m_trajectoryType{
+      this, "trajectoryType", 1,
+      "Type of the trajectories as for /tracking/storeTrajectory (1: G4Trajectory, 2: smooth, 3-4: rich)"};
+};
+
+#endif /* SIMG4FULL_G4TRAJECTORYFILTERACTIONS_H */
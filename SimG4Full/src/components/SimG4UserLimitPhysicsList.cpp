@@ -1,6 +1,7 @@
 #include "SimG4UserLimitPhysicsList.h"
 
 // FCCSW
+#include "SimG4Full/AdaptiveStepLimiter.h"
 #include "SimG4Interface/ISimG4PhysicsList.h"
 
 // Geant4
@@ -33,5 +34,8 @@ G4VModularPhysicsList* SimG4UserLimitPhysicsList::physicsList() {
   G4VModularPhysicsList* physicsList = m_physicsListTool->physicsList();
   // Attach step limiter process
   physicsList->RegisterPhysics(new G4StepLimiterPhysics());
+  if (m_adaptiveStepLimiter) {
+    physicsList->RegisterPhysics(new sim::AdaptiveStepLimiterPhysics());
+  }
   return physicsList;
 }
@@ -12,6 +12,8 @@
  *
  *  User limits physics list tool.
  *  Attaches G4StepLimiterPhysics process to the full simulation physics list.
+ *  If \b'adaptiveStepLimiter' is set, also attaches sim::AdaptiveStepLimiterPhysics (step limits depending on the
+ *  momentum of the track, e.g. set by SimG4FullSimDCHRegion).
  *
  *  @author Anna Zaborowska
  */
@@ -37,6 +39,9 @@ public:
 private:
   /// Handle for the full physics list tool
   ToolHandle<ISimG4PhysicsList> m_physicsListTool{"SimG4FtfpBert", this, true};
+  /// Flag whether the adaptive step limiter process should be attached
+  Gaudi::Property<bool> m_adaptiveStepLimiter{this, "adaptiveStepLimiter", false,
+                                              "Attach the step limiter depending on the momentum of the track"};
 };
 
 #endif /* SIMG4FAST_G4USERLIMITPHYSICSLIST_H */
@@ -1,5 +1,8 @@
 #include "SimG4UserLimitRegion.h"
 
+// FCCSW
+#include "SimG4Common/VolumeIndex.h"
+
 // Geant4
 #include "G4LogicalVolume.hh"
 #include "G4RegionStore.hh"
@@ -25,6 +28,11 @@ StatusCode SimG4UserLimitRegion::initialize() {
     error() << "No detector name is specified for the parametrisation" << endmsg;
     return StatusCode::FAILURE;
   }
+  const std::string matchingError = sim::VolumeIndex::configure(m_volumeMatching, m_volumeNames, m_matching);
+  if (!matchingError.empty()) {
+    error() << matchingError << endmsg;
+    return StatusCode::FAILURE;
+  }
   return StatusCode::SUCCESS;
 }
 
@@ -45,27 +53,25 @@ StatusCode SimG4UserLimitRegion::create() {
           info() << "Creating user limits for world" << endmsg;
   // (b) if individiual volumenames are specified, try to find them and set limits for them.
   } else {
-  for (const auto& volumeName : m_volumeNames) {
-      for (int iter_region = 0; iter_region < world->GetNoDaughters(); ++iter_region) {
-        if (world->GetDaughter(iter_region)->GetName().find(volumeName) != std::string::npos) {
-          /// all G4Region objects are deleted by the G4RegionStore
-          m_g4regions.emplace_back(
-              new G4Region(world->GetDaughter(iter_region)->GetLogicalVolume()->GetName() + "_userLimits"));
-          m_g4regions.back()->AddRootLogicalVolume(world->GetDaughter(iter_region)->GetLogicalVolume());
-          m_userLimits.emplace_back(new G4UserLimits(m_maxStep / Gaudi::Units::mm * CLHEP::mm,
-                                                     m_maxTrack / Gaudi::Units::mm * CLHEP::mm,
-                                                     m_maxTime / Gaudi::Units::s * CLHEP::s,
-                                                     m_minKineticEnergy / Gaudi::Units::MeV * CLHEP::MeV,
-                                                     m_minRange / Gaudi::Units::mm * CLHEP::mm));
-          m_g4regions.back()->SetUserLimits(m_userLimits.back().get());
-          info() << "Creating user limits in the region " << m_g4regions.back()->GetName() << endmsg;
-        }
-      }
+    std::vector<std::string> unmatched;
+    const std::vector<G4LogicalVolume*> volumes = sim::VolumeIndex::match(m_volumeNames, m_matching, &unmatched);
+    if (!unmatched.empty()) {
+      error() << "No volume matches " << unmatched.front() << ", regions were not created for all the volumes"
+              << endmsg;
+      return StatusCode::FAILURE;
+    }
+    for (G4LogicalVolume* volume : volumes) {
+      /// all G4Region objects are deleted by the G4RegionStore
+      m_g4regions.emplace_back(new G4Region(volume->GetName() + "_userLimits"));
+      m_g4regions.back()->AddRootLogicalVolume(volume);
+      m_userLimits.emplace_back(new G4UserLimits(m_maxStep / Gaudi::Units::mm * CLHEP::mm,
+                                                 m_maxTrack / Gaudi::Units::mm * CLHEP::mm,
+                                                 m_maxTime / Gaudi::Units::s * CLHEP::s,
+                                                 m_minKineticEnergy / Gaudi::Units::MeV * CLHEP::MeV,
+                                                 m_minRange / Gaudi::Units::mm * CLHEP::mm));
+      m_g4regions.back()->SetUserLimits(m_userLimits.back().get());
+      info() << "Creating user limits in the region " << m_g4regions.back()->GetName() << endmsg;
     }
-  if (m_g4regions.size() != m_volumeNames.size()) {
-    error() << "Regions  were not created for all the volumes" << endmsg;
-    return StatusCode::FAILURE;
-  }
   }
   return StatusCode::SUCCESS;
 }
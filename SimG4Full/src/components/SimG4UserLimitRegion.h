@@ -9,6 +9,7 @@
 
 // FCCSW
 #include "SimG4Interface/ISimG4ParticleSmearTool.h"
+#include "SimG4Common/VolumeIndex.h"
 #include "SimG4Interface/ISimG4RegionTool.h"
 
 // Geant
@@ -19,6 +20,8 @@ class G4Region;
  *
  *  Tool for creating regions with user limits.
  *  It requires SimG4UserLimitPhysics to be used.
+ *  Regions are created for the volumes \b'volumeNames' ("world" sets the limits of the world volume), matched as set by
+ *  \b'volumeMatching' (sim::VolumeIndex); each name needs to match at least one volume.
  *
  *  @author Anna Zaborowska
 */
@@ -39,6 +42,10 @@ public:
    *   @return status code
    */
   virtual StatusCode create() final;
+  /**  Nothing is created on the worker threads (the regions and their user limits are shared by the threads).
+   *   @return status code
+   */
+  inline virtual StatusCode createForWorker() final { return StatusCode::SUCCESS; }
 
 private:
   /// Regions used to set user limits
@@ -48,6 +55,12 @@ private:
   std::vector<std::unique_ptr<G4UserLimits>> m_userLimits;
   /// Names of the volumes where user limits should be attached (set by job options)
   Gaudi::Property<std::vector<std::string>> m_volumeNames{this, "volumeNames", {}, "Names of the volumes"};
+  /// Matching of the volume names (set by job options)
+  Gaudi::Property<std::string> m_volumeMatching{
+      this, "volumeMatching", "daughters",
+      "Matching of the volume names: daughters (of the world, containing the name), exact, prefix or regex"};
+  /// Matching of the volume names
+  sim::VolumeIndex::Matching m_matching = sim::VolumeIndex::Matching::Daughters;
   /// max allowed Step size in this volume  (set by job options)
   Gaudi::Property<double> m_maxStep{this, "maxStep", DBL_MAX, "maximum step"};
   /// max total track length (set by job options)
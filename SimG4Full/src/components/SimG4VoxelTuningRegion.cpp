@@ -0,0 +1,131 @@
+#include "SimG4VoxelTuningRegion.h"
+
+// Geant4
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4SmartVoxelHeader.hh"
+#include "G4SmartVoxelNode.hh"
+#include "G4SmartVoxelProxy.hh"
+
+// STL
+#include <memory>
+#include <unordered_set>
+
+DECLARE_COMPONENT(SimG4VoxelTuningRegion)
+
+namespace {
+/// Count the memory of the voxels below the header, the proxies shared by several slices are counted once
+void countVoxels(const G4SmartVoxelHeader& aHeader, std::unordered_set<const G4SmartVoxelProxy*>& aProxies,
+                 size_t& aMemory, unsigned long& aHeaders, unsigned long& aNodes) {
+  ++aHeaders;
+  aMemory += sizeof(G4SmartVoxelHeader) + aHeader.GetNoSlices() * sizeof(G4SmartVoxelProxy*);
+  for (size_t iSlice = 0; iSlice < aHeader.GetNoSlices(); ++iSlice) {
+    const G4SmartVoxelProxy* proxy = aHeader.GetSlice(iSlice);
+    if (!aProxies.insert(proxy).second) continue;
+    aMemory += sizeof(G4SmartVoxelProxy);
+    if (proxy->IsHeader()) {
+      countVoxels(*proxy->GetHeader(), aProxies, aMemory, aHeaders, aNodes);
+    } else {
+      ++aNodes;
+      aMemory += sizeof(G4SmartVoxelNode) + proxy->GetNode()->GetNoContained() * sizeof(G4int);
+    }
+  }
+}
+}
+
+SimG4VoxelTuningRegion::SimG4VoxelTuningRegion(const std::string& type, const std::string& name,
+                                               const IInterface* parent)
+    : GaudiTool(type, name, parent) {
+  declareInterface<ISimG4RegionTool>(this);
+}
+
+SimG4VoxelTuningRegion::~SimG4VoxelTuningRegion() {}
+
+StatusCode SimG4VoxelTuningRegion::initialize() {
+  if (GaudiTool::initialize().isFailure()) {
+    return StatusCode::FAILURE;
+  }
+  if (m_smartless.empty() && m_unoptimisedVolumes.empty()) {
+    error() << "No volume is specified for the tuning of the voxels" << endmsg;
+    return StatusCode::FAILURE;
+  }
+  for (const auto& entry : m_smartless) {
+    if (entry.second <= 0) {
+      error() << "Smartless parameter of " << entry.first << " needs to be positive" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  return StatusCode::SUCCESS;
+}
+
+SimG4VoxelTuningRegion::VoxelSize SimG4VoxelTuningRegion::voxelSize(G4LogicalVolume& aVolume) {
+  VoxelSize size;
+  // as in G4GeometryManager: the volumes to optimise with enough daughters, and the replicas
+  const bool replica = aVolume.GetNoDaughters() == 1 && aVolume.GetDaughter(0)->IsReplicated();
+  if (!replica && (!aVolume.IsToOptimise() || aVolume.GetNoDaughters() < kMinVoxelVolumesLevel1)) {
+    return size;
+  }
+  std::unique_ptr<G4SmartVoxelHeader> header(new G4SmartVoxelHeader(&aVolume));
+  std::unordered_set<const G4SmartVoxelProxy*> proxies;
+  countVoxels(*header, proxies, size.memory, size.headers, size.nodes);
+  return size;
+}
+
+StatusCode SimG4VoxelTuningRegion::create() {
+  // the changes of each volume: smartless (0: unchanged) and whether it is voxelised
+  std::map<G4LogicalVolume*, std::pair<double, bool>> changes;
+  for (const auto& entry : m_smartless) {
+    bool found = false;
+    for (G4LogicalVolume* volume : *G4LogicalVolumeStore::GetInstance()) {
+      if (volume->GetName().find(entry.first) != std::string::npos) {
+        changes.emplace(volume, std::make_pair(0., true)).first->second.first = entry.second;
+        found = true;
+      }
+    }
+    if (!found) {
+      error() << "Volume " << entry.first << " not found, its voxels cannot be tuned" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  for (const auto& name : m_unoptimisedVolumes) {
+    bool found = false;
+    for (G4LogicalVolume* volume : *G4LogicalVolumeStore::GetInstance()) {
+      if (volume->GetName().find(name) != std::string::npos) {
+        changes.emplace(volume, std::make_pair(0., true)).first->second.second = false;
+        found = true;
+      }
+    }
+    if (!found) {
+      error() << "Volume " << name << " not found, its voxels cannot be tuned" << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  size_t memoryBefore = 0;
+  size_t memoryAfter = 0;
+  for (const auto& change : changes) {
+    G4LogicalVolume* volume = change.first;
+    VoxelSize before;
+    if (m_reportMemory) before = voxelSize(*volume);
+    const double smartlessBefore = volume->GetSmartless();
+    if (change.second.first > 0) volume->SetSmartless(change.second.first);
+    if (!change.second.second) volume->SetOptimisation(false);
+    if (!m_reportMemory) {
+      debug() << "Voxels of " << volume->GetName() << ": smartless " << volume->GetSmartless()
+              << (volume->IsToOptimise() ? "" : ", not voxelised") << endmsg;
+      continue;
+    }
+    const VoxelSize after = voxelSize(*volume);
+    memoryBefore += before.memory;
+    memoryAfter += after.memory;
+    info() << "Voxels of " << volume->GetName() << " (" << volume->GetNoDaughters() << " daughters): smartless "
+           << smartlessBefore << " -> " << volume->GetSmartless() << (volume->IsToOptimise() ? "" : ", not voxelised")
+           << ", memory " << before.memory / 1024. << " -> " << after.memory / 1024. << " kB, headers "
+           << before.headers << " -> " << after.headers << ", nodes " << before.nodes << " -> " << after.nodes
+           << endmsg;
+  }
+  if (m_reportMemory) {
+    info() << "Voxels of the " << changes.size() << " tuned volumes: " << memoryBefore / 1024. / 1024. << " -> "
+           << memoryAfter / 1024. / 1024. << " MB" << endmsg;
+  }
+  return StatusCode::SUCCESS;
+}
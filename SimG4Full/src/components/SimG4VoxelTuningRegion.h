@@ -0,0 +1,70 @@
+#ifndef SIMG4FULL_SIMG4VOXELTUNINGREGION_H
+#define SIMG4FULL_SIMG4VOXELTUNINGREGION_H
+
+// Gaudi
+#include "GaudiAlg/GaudiTool.h"
+
+// FCCSW
+#include "SimG4Interface/ISimG4RegionTool.h"
+
+// Geant
+class G4LogicalVolume;
+
+// STL
+#include <map>
+#include <string>
+#include <vector>
+
+/** @class SimG4VoxelTuningRegion SimG4Full/src/components/SimG4VoxelTuningRegion.h SimG4VoxelTuningRegion.h
+ *
+ *  Tool for tuning the navigation voxels of mother volumes with many daughters (e.g. the modules of a calorimeter or
+ *  the wires of a drift chamber), attached to SimG4Svc as the region tools.
+ *  The logical volumes whose names contain a key of \b'smartless' get that smartless parameter (the average number of
+ *  slices per contained volume of their voxels: larger values give faster navigation for more memory, Geant4 uses 2),
+ *  those whose names contain one of \b'unoptimisedVolumes' are not voxelised (linear search of the daughters).
+ *  If \b'reportMemory' is set, the voxels of these volumes are built before and after the change, and their memory is
+ *  printed. The voxels of the job are built when the run starts, with the tuned parameters.
+ *  [For more information please see](@ref md_sim_doc_geant4fullsim).
+*/
+
+class SimG4VoxelTuningRegion : public GaudiTool, virtual public ISimG4RegionTool {
+public:
+  explicit SimG4VoxelTuningRegion(const std::string& type, const std::string& name, const IInterface* parent);
+  virtual ~SimG4VoxelTuningRegion();
+  /**  Initialize.
+   *   @return status code
+   */
+  virtual StatusCode initialize() final;
+  /**  Set the voxel parameters of the volumes.
+   *   @return status code
+   */
+  virtual StatusCode create() final;
+  /**  Nothing is created on the worker threads (the voxelisation of the volumes is shared by the threads).
+   *   @return status code
+   */
+  inline virtual StatusCode createForWorker() final { return StatusCode::SUCCESS; }
+
+private:
+  /// Memory and size of the voxels of a volume
+  struct VoxelSize {
+    size_t memory = 0;
+    unsigned long headers = 0;
+    unsigned long nodes = 0;
+  };
+  /**  Build the voxels of the volume with its current parameters, without keeping them.
+   *   @param[in] aVolume mother volume
+   *   @return memory and size of the voxels (zero if the volume is not voxelised)
+   */
+  static VoxelSize voxelSize(G4LogicalVolume& aVolume);
+  /// Smartless parameters by (part of the) name of the logical volumes
+  Gaudi::Property<std::map<std::string, double>> m_smartless{
+      this, "smartless", {}, "Smartless parameter of the logical volumes (by part of their name)"};
+  /// Names of the logical volumes without voxels
+  Gaudi::Property<std::vector<std::string>> m_unoptimisedVolumes{
+      this, "unoptimisedVolumes", {}, "Logical volumes (part of their name) whose daughters are not voxelised"};
+  /// Flag whether the memory of the voxels is reported
+  Gaudi::Property<bool> m_reportMemory{this, "reportMemory", true,
+                                       "Print the memory of the voxels of the volumes before and after the change"};
+};
+
+#endif /* SIMG4FULL_SIMG4VOXELTUNINGREGION_H */
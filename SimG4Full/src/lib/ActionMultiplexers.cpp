@@ -0,0 +1,118 @@
+#include "SimG4Full/ActionMultiplexers.h"
+
+#include "G4RunManager.hh"
+
+// STL
+#include <algorithm>
+
+namespace {
+template <typename Action>
+void collectAction(const Action* aAction, std::vector<Action*>& aActions) {
+  // an action initialization that does not set this hook leaves the action of the previous one in the run manager
+  Action* action = const_cast<Action*>(aAction);
+  if (action != nullptr && std::find(aActions.begin(), aActions.end(), action) == aActions.end()) {
+    aActions.push_back(action);
+  }
+}
+
+template <typename Multiplexer, typename Action>
+void installAction(const std::vector<Action*>& aActions) {
+  // no action or a single action is already in the run manager
+  if (aActions.size() < 2) return;
+  auto multiplexer = new Multiplexer();
+  for (auto action : aActions) {
+    multiplexer->add(action);
+  }
+  // the multiplexer (and the actions it owns) is deleted by the run manager
+  G4RunManager::GetRunManager()->SetUserAction(multiplexer);
+}
+}
+
+namespace sim {
+G4Run* MultiRunAction::GenerateRun() {
+  for (auto& action : m_actions) {
+    if (G4Run* run = action->GenerateRun()) return run;
+  }
+  return nullptr;
+}
+
+void MultiRunAction::BeginOfRunAction(const G4Run* aRun) {
+  for (auto& action : m_actions) action->BeginOfRunAction(aRun);
+}
+
+void MultiRunAction::EndOfRunAction(const G4Run* aRun) {
+  for (auto& action : m_actions) action->EndOfRunAction(aRun);
+}
+
+void MultiEventAction::SetEventManager(G4EventManager* aManager) {
+  G4UserEventAction::SetEventManager(aManager);
+  for (auto& action : m_actions) action->SetEventManager(aManager);
+}
+
+void MultiEventAction::BeginOfEventAction(const G4Event* aEvent) {
+  for (auto& action : m_actions) action->BeginOfEventAction(aEvent);
+}
+
+void MultiEventAction::EndOfEventAction(const G4Event* aEvent) {
+  for (auto& action : m_actions) action->EndOfEventAction(aEvent);
+}
+
+void MultiTrackingAction::SetTrackingManagerPointer(G4TrackingManager* aManager) {
+  G4UserTrackingAction::SetTrackingManagerPointer(aManager);
+  for (auto& action : m_actions) action->SetTrackingManagerPointer(aManager);
+}
+
+void MultiTrackingAction::PreUserTrackingAction(const G4Track* aTrack) {
+  for (auto& action : m_actions) action->PreUserTrackingAction(aTrack);
+}
+
+void MultiTrackingAction::PostUserTrackingAction(const G4Track* aTrack) {
+  for (auto& action : m_actions) action->PostUserTrackingAction(aTrack);
+}
+
+void MultiSteppingAction::SetSteppingManagerPointer(G4SteppingManager* aManager) {
+  G4UserSteppingAction::SetSteppingManagerPointer(aManager);
+  for (auto& action : m_actions) action->SetSteppingManagerPointer(aManager);
+}
+
+void MultiSteppingAction::UserSteppingAction(const G4Step* aStep) {
+  for (auto& action : m_actions) action->UserSteppingAction(aStep);
+}
+
+G4ClassificationOfNewTrack MultiStackingAction::ClassifyNewTrack(const G4Track* aTrack) {
+  G4ClassificationOfNewTrack classification = fUrgent;
+  for (auto& action : m_actions) {
+    const G4ClassificationOfNewTrack actionClassification = action->ClassifyNewTrack(aTrack);
+    if (actionClassification == fKill) return fKill;
+    if (classification == fUrgent) classification = actionClassification;
+  }
+  return classification;
+}
+
+void MultiStackingAction::NewStage() {
+  for (auto& action : m_actions) action->NewStage();
+}
+
+void MultiStackingAction::PrepareNewEvent() {
+  // the stack manager is given to the multiplexer only
+  for (auto& action : m_actions) action->SetStackManager(stackManager);
+  for (auto& action : m_actions) action->PrepareNewEvent();
+}
+
+void ActionCollector::collect() {
+  const G4RunManager* runManager = G4RunManager::GetRunManager();
+  collectAction(runManager->GetUserRunAction(), m_runActions);
+  collectAction(runManager->GetUserEventAction(), m_eventActions);
+  collectAction(runManager->GetUserTrackingAction(), m_trackingActions);
+  collectAction(runManager->GetUserSteppingAction(), m_steppingActions);
+  collectAction(runManager->GetUserStackingAction(), m_stackingActions);
+}
+
+void ActionCollector::install() {
+  installAction<MultiRunAction>(m_runActions);
+  installAction<MultiEventAction>(m_eventActions);
+  installAction<MultiTrackingAction>(m_trackingActions);
+  installAction<MultiSteppingAction>(m_steppingActions);
+  installAction<MultiStackingAction>(m_stackingActions);
+}
+}
@@ -0,0 +1,71 @@
+#include "SimG4Full/AdaptiveStepLimiter.h"
+
+// Geant
+#include "G4DynamicParticle.hh"
+#include "G4LogicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ProcessManager.hh"
+#include "G4Region.hh"
+#include "G4Track.hh"
+#include "G4TransportationProcessType.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4ios.hh"
+
+// STL
+#include <cfloat>
+
+namespace sim {
+double StepLimitPolicy::maxStep(const G4Track& aTrack) const {
+  const G4DynamicParticle* particle = aTrack.GetDynamicParticle();
+  if (!pdgCodes.empty() && pdgCodes.count(particle->GetPDGcode()) == 0) {
+    return DBL_MAX;
+  }
+  // beta = p / E
+  const double momentum = particle->GetTotalMomentum();
+  const bool slow = (fineMaxMomentum > 0 && momentum < fineMaxMomentum) ||
+                    (fineMaxBeta > 0 && momentum < fineMaxBeta * particle->GetTotalEnergy());
+  const double step = slow ? fineStep : coarseStep;
+  return step > 0 ? step : DBL_MAX;
+}
+
+void StepLimitPolicy::Print() const {
+  G4cout << "Step limits: " << fineStep << " mm below " << fineMaxMomentum << " MeV or beta " << fineMaxBeta << ", "
+         << coarseStep << " mm otherwise (0: no limit)" << G4endl;
+}
+
+AdaptiveStepLimiter::AdaptiveStepLimiter(const G4String& aName) : G4VProcess(aName, fGeneral) {
+  SetProcessSubType(static_cast<int>(STEP_LIMITER));
+  pParticleChange = &m_particleChange;
+}
+
+G4double AdaptiveStepLimiter::PostStepGetPhysicalInteractionLength(const G4Track& aTrack, G4double,
+                                                                   G4ForceCondition* aCondition) {
+  *aCondition = NotForced;
+  const G4Region* region = aTrack.GetVolume()->GetLogicalVolume()->GetRegion();
+  if (region != m_region) {
+    m_region = region;
+    m_policy = dynamic_cast<const StepLimitPolicy*>(region->GetUserInformation());
+  }
+  return m_policy != nullptr ? m_policy->maxStep(aTrack) : DBL_MAX;
+}
+
+G4VParticleChange* AdaptiveStepLimiter::PostStepDoIt(const G4Track& aTrack, const G4Step&) {
+  m_particleChange.Initialize(aTrack);
+  return &m_particleChange;
+}
+
+AdaptiveStepLimiterPhysics::AdaptiveStepLimiterPhysics(const G4String& aName) : G4VPhysicsConstructor(aName) {}
+
+void AdaptiveStepLimiterPhysics::ConstructProcess() {
+  // one process per thread, shared by the particles (as G4StepLimiterPhysics)
+  auto limiter = new AdaptiveStepLimiter();
+  auto particleIterator = GetParticleIterator();
+  particleIterator->reset();
+  while ((*particleIterator)()) {
+    G4ParticleDefinition* particle = particleIterator->value();
+    if (particle->GetPDGCharge() != 0 && !particle->IsShortLived() && particle->GetProcessManager() != nullptr) {
+      particle->GetProcessManager()->AddDiscreteProcess(limiter);
+    }
+  }
+}
+}
@@ -0,0 +1,56 @@
+#include "SimG4Full/FieldStatistics.h"
+
+// STL
+#include <algorithm>
+
+namespace sim {
+namespace {
+void setMax(FieldStatistics::Entry& aMax, const FieldStatistics::Entry& aEntry) {
+  aMax.steps = std::max(aMax.steps, aEntry.steps);
+  aMax.counters.fieldCalls = std::max(aMax.counters.fieldCalls, aEntry.counters.fieldCalls);
+  aMax.counters.integratorSteps = std::max(aMax.counters.integratorSteps, aEntry.counters.integratorSteps);
+  aMax.counters.chordTrials = std::max(aMax.counters.chordTrials, aEntry.counters.chordTrials);
+  aMax.counters.rejectedSteps = std::max(aMax.counters.rejectedSteps, aEntry.counters.rejectedSteps);
+  aMax.loopers = std::max(aMax.loopers, aEntry.loopers);
+  aMax.looperEnergy = std::max(aMax.looperEnergy, aEntry.looperEnergy);
+}
+}
+
+void FieldStatistics::Events::add(const Entry& aEvent) {
+  ++events;
+  sum.add(aEvent);
+  setMax(max, aEvent);
+}
+
+void FieldStatistics::Events::merge(const Events& aOther) {
+  events += aOther.events;
+  sum.add(aOther.sum);
+  setMax(max, aOther.max);
+}
+
+void FieldStatistics::merge(const Table& aRegions, const Table& aLoopers, const Events& aEvents) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (const auto& entry : aRegions) {
+    m_regions[entry.first].add(entry.second);
+  }
+  for (const auto& entry : aLoopers) {
+    m_loopers[entry.first].add(entry.second);
+  }
+  m_events.merge(aEvents);
+}
+
+FieldStatistics::Table FieldStatistics::regions() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_regions;
+}
+
+FieldStatistics::Table FieldStatistics::loopers() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_loopers;
+}
+
+FieldStatistics::Events FieldStatistics::events() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_events;
+}
+}
@@ -0,0 +1,72 @@
+#include "SimG4Full/FieldStatisticsAction.h"
+
+// FCCSW
+#include "SimG4Common/FieldSetup.h"
+
+#include "G4LogicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Region.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+
+namespace sim {
+FieldStatisticsAction::FieldStatisticsAction(std::shared_ptr<FieldStatistics> aStatistics)
+    : m_statistics(aStatistics) {}
+
+FieldCounters FieldStatisticsAction::threadCounters() {
+  const FieldCounters* counters = FieldSetup::threadCounters();
+  return counters != nullptr ? *counters : FieldCounters();
+}
+
+void FieldStatisticsAction::UserSteppingAction(const G4Step* aStep) {
+  FieldStatistics::Entry step;
+  step.steps = 1;
+  // the field is evaluated while the transportation limits the step, before this action
+  const FieldCounters counters = threadCounters();
+  step.counters = counters - m_lastCounters;
+  m_lastCounters = counters;
+  // looping particles are killed by the transportation away from the world boundary
+  const G4StepPoint* postStep = aStep->GetPostStepPoint();
+  const G4VProcess* process = postStep->GetProcessDefinedStep();
+  if (aStep->GetTrack()->GetTrackStatus() == fStopAndKill && process != nullptr &&
+      process->GetProcessType() == fTransportation && postStep->GetStepStatus() != fWorldBoundary) {
+    step.loopers = 1;
+    // the energy is not deposited by the transportation, it is lost from the event
+    step.looperEnergy = aStep->GetPreStepPoint()->GetKineticEnergy();
+    FieldStatistics::Entry& looper = m_loopers[aStep->GetTrack()->GetDefinition()];
+    ++looper.loopers;
+    looper.looperEnergy += step.looperEnergy;
+  }
+  const G4VPhysicalVolume* volume = aStep->GetPreStepPoint()->GetPhysicalVolume();
+  m_regions[volume != nullptr ? volume->GetLogicalVolume()->GetRegion() : nullptr].add(step);
+  m_event.add(step);
+}
+
+void FieldStatisticsAction::beginEvent() {
+  m_lastCounters = threadCounters();
+  m_event = FieldStatistics::Entry();
+}
+
+void FieldStatisticsAction::endEvent() { m_events.add(m_event); }
+
+void FieldStatisticsAction::merge() {
+  FieldStatistics::Table regions;
+  for (const auto& entry : m_regions) {
+    regions[entry.first != nullptr ? std::string(entry.first->GetName()) : "none"].add(entry.second);
+  }
+  FieldStatistics::Table loopers;
+  for (const auto& entry : m_loopers) {
+    loopers[entry.first->GetParticleName()].add(entry.second);
+  }
+  m_statistics->merge(regions, loopers, m_events);
+  m_regions.clear();
+  m_loopers.clear();
+  m_events = FieldStatistics::Events();
+}
+
+void FieldStatisticsTrackingAction::PreUserTrackingAction(const G4Track* aTrack) {
+  FieldSetup::startTrack(*aTrack->GetDefinition());
+}
+}
@@ -0,0 +1,16 @@
+#include "SimG4Full/FieldStatisticsActions.h"
+
+#include "SimG4Full/FieldStatisticsAction.h"
+
+namespace sim {
+FieldStatisticsActions::FieldStatisticsActions(std::shared_ptr<FieldStatistics> aStatistics)
+    : G4VUserActionInitialization(), m_statistics(aStatistics) {}
+
+void FieldStatisticsActions::Build() const {
+  auto steppingAction = new FieldStatisticsAction(m_statistics);
+  SetUserAction(steppingAction);
+  SetUserAction(new FieldStatisticsEventAction(steppingAction));
+  SetUserAction(new FieldStatisticsRunAction(steppingAction));
+  SetUserAction(new FieldStatisticsTrackingAction());
+}
+}
@@ -1,18 +1,55 @@
 #include "SimG4Full/FullSimActions.h"
+#include "SimG4Full/ActionMultiplexers.h"
 #include "SimG4Full/ParticleHistoryAction.h"
 #include "SimG4Full/ParticleHistoryEventAction.h"
+#include "SimG4Full/StepCountingAction.h"
 #include <iostream>
 
 namespace sim {
-FullSimActions::FullSimActions(bool enableHistory, double aEnergyCut)
-    : G4VUserActionInitialization(), m_enableHistory(enableHistory), m_energyCut(aEnergyCut) {}
+FullSimActions::FullSimActions(bool enableHistory, const ParticleHistorySelection& aSelection, bool aCountSteps)
+    : G4VUserActionInitialization(),
+      m_enableHistory(enableHistory),
+      m_selection(aSelection),
+      m_countSteps(aCountSteps) {}
 
 FullSimActions::~FullSimActions() {}
 
 void FullSimActions::Build() const {
-  if (m_enableHistory) {
+  if (m_chained.empty()) {
+    buildFullSimActions();
+    return;
+  }
+  ActionCollector collector;
+  buildFullSimActions();
+  collector.collect();
+  for (const auto& actions : m_chained) {
+    actions->Build();
+    collector.collect();
+  }
+  collector.install();
+}
+
+void FullSimActions::BuildForMaster() const {
+  if (m_chained.empty()) {
+    return;
+  }
+  ActionCollector collector;
+  for (const auto& actions : m_chained) {
+    actions->BuildForMaster();
+    collector.collect();
+  }
+  collector.install();
+}
+
+void FullSimActions::buildFullSimActions() const {
+  if (m_enableHistory || m_countSteps) {
     SetUserAction(new ParticleHistoryEventAction());
-    SetUserAction(new ParticleHistoryAction(m_energyCut));
+  }
+  if (m_enableHistory) {
+    SetUserAction(new ParticleHistoryAction(m_selection));
+  }
+  if (m_countSteps) {
+    SetUserAction(new StepCountingAction());
   }
 }
 }
@@ -0,0 +1,85 @@
+#include "SimG4Full/ImportanceBiasingAction.h"
+
+#include "G4DynamicParticle.hh"
+#include "G4LogicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "Randomize.hh"
+
+// STL
+#include <cmath>
+
+namespace sim {
+ImportanceBiasingAction::ImportanceBiasingAction(
+    std::shared_ptr<const std::unordered_map<const G4Region*, double>> aImportances, const std::set<int>& aPdgCodes,
+    unsigned int aMaxSplit, std::shared_ptr<ImportanceBiasingCounts> aCounts, G4UserSteppingAction* aChained)
+    : m_importances(aImportances),
+      m_pdgCodes(aPdgCodes),
+      m_maxSplit(aMaxSplit),
+      m_counts(aCounts),
+      m_chained(aChained) {}
+
+double ImportanceBiasingAction::importance(const G4Region* aRegion) const {
+  auto found = m_importances->find(aRegion);
+  return found != m_importances->end() ? found->second : 1;
+}
+
+void ImportanceBiasingAction::UserSteppingAction(const G4Step* aStep) {
+  if (m_chained != nullptr) {
+    m_chained->UserSteppingAction(aStep);
+  }
+  G4Track* track = aStep->GetTrack();
+  if (track->GetTrackStatus() != fAlive) {
+    return;
+  }
+  const G4StepPoint* postStep = aStep->GetPostStepPoint();
+  if (postStep->GetStepStatus() != fGeomBoundary || postStep->GetPhysicalVolume() == nullptr) {
+    return;
+  }
+  if (!m_pdgCodes.empty() && m_pdgCodes.count(track->GetDefinition()->GetPDGEncoding()) == 0) {
+    return;
+  }
+  const double ratio = importance(postStep->GetPhysicalVolume()->GetLogicalVolume()->GetRegion()) /
+                       importance(aStep->GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume()->GetRegion());
+  if (ratio == 1) {
+    return;
+  }
+  double weight = track->GetWeight();
+  unsigned int numTracks = 1;
+  if (ratio < 1) {
+    ++m_counts->roulettes;
+    if (G4UniformRand() >= ratio) {
+      ++m_counts->killed;
+      track->SetTrackStatus(fStopAndKill);
+      return;
+    }
+    weight /= ratio;
+  } else if (ratio > m_maxSplit) {
+    numTracks = m_maxSplit;
+    weight /= m_maxSplit;
+  } else {
+    // as many tracks as the ratio on average
+    numTracks = static_cast<unsigned int>(ratio);
+    if (G4UniformRand() < ratio - numTracks) ++numTracks;
+    weight /= ratio;
+  }
+  track->SetWeight(weight);
+  if (numTracks < 2) {
+    return;
+  }
+  ++m_counts->splittings;
+  m_counts->copies += numTracks - 1;
+  // the copies start at the boundary, they are tracked as secondaries of the track
+  G4TrackVector* secondaries = const_cast<G4Step*>(aStep)->GetfSecondary();
+  for (unsigned int iCopy = 1; iCopy < numTracks; ++iCopy) {
+    auto copy = new G4Track(new G4DynamicParticle(*track->GetDynamicParticle()), postStep->GetGlobalTime(),
+                            postStep->GetPosition());
+    copy->SetWeight(weight);
+    copy->SetParentID(track->GetTrackID());
+    copy->SetTouchableHandle(postStep->GetTouchableHandle());
+    secondaries->push_back(copy);
+  }
+}
+}
@@ -3,29 +3,72 @@
 #include "SimG4Common/EventInformation.h"
 
 #include "G4EventManager.hh"
-#include "G4LorentzVector.hh"
+#include "G4TrackingManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Region.hh"
+#include "G4VProcess.hh"
+
+#include <algorithm>
 
 namespace sim {
 
-ParticleHistoryAction::ParticleHistoryAction(double aEnergyCut): m_energyCut(aEnergyCut) {}
+namespace {
+template <typename T, typename U>
+bool isListed(const std::vector<T>& aList, const U& aValue) {
+  return aList.empty() || std::find(aList.begin(), aList.end(), aValue) != aList.end();
+}
+}
+
+ParticleHistoryAction::ParticleHistoryAction(const ParticleHistorySelection& aSelection): m_selection(aSelection) {}
 
 void ParticleHistoryAction::PreUserTrackingAction(const G4Track* aTrack) {
   auto g4EvtMgr = G4EventManager::GetEventManager();
   auto evtinfo = dynamic_cast<sim::EventInformation*>(g4EvtMgr->GetUserInformation());
-  G4LorentzVector prodPos(aTrack->GetGlobalTime() - aTrack->GetLocalTime(), aTrack->GetVertexPosition());
-  G4LorentzVector endPos(aTrack->GetGlobalTime(), aTrack->GetPosition());
-  if (selectSecondary(*aTrack, m_energyCut)) {
-    evtinfo->addParticle(aTrack);
+  // particles are only recorded here, they are converted to EDM when the history is saved
+  if (selectSecondary(*aTrack)) {
+    evtinfo->addParticle(aTrack, m_selection.keepAncestors);
+  } else if (m_selection.keepAncestors) {
+    evtinfo->addCandidate(aTrack);
   }
 }
 
-void ParticleHistoryAction::PostUserTrackingAction(const G4Track* /*aTrack*/) {}
+void ParticleHistoryAction::PostUserTrackingAction(const G4Track* aTrack) {
+  if (!m_selection.keepAncestors) {
+    return;
+  }
+  auto evtinfo = dynamic_cast<sim::EventInformation*>(G4EventManager::GetEventManager()->GetUserInformation());
+  // secondaries of a track killed with them are deleted without being tracked
+  const G4TrackStatus status = aTrack->GetTrackStatus();
+  const size_t numSecondaries = (status == fKillTrackAndSecondaries || fpTrackingManager->GimmeSecondaries() == nullptr)
+                                    ? 0
+                                    : fpTrackingManager->GimmeSecondaries()->size();
+  evtinfo->endTrack(aTrack, numSecondaries, status != fSuspend);
+}
 
-bool ParticleHistoryAction::selectSecondary(const G4Track& aTrack, double aEnergyCut) {
-  G4LorentzVector p4(aTrack.GetMomentum(), aTrack.GetTotalEnergy());
-  if (p4.e() < aEnergyCut) { 
+bool ParticleHistoryAction::selectSecondary(const G4Track& aTrack) const {
+  if (aTrack.GetTotalEnergy() < m_selection.energyCut) {
     return false;
   }
+  if (!isListed(m_selection.pdgCodes, aTrack.GetParticleDefinition()->GetPDGEncoding())) {
+    return false;
+  }
+  const G4VProcess* creator = aTrack.GetCreatorProcess();
+  if (creator != nullptr && !isListed(m_selection.processes, creator->GetProcessName())) {
+    return false;
+  }
+  if (!m_selection.regions.empty() || !m_selection.volumes.empty()) {
+    // created in one of the volumes or in one of the regions
+    const G4LogicalVolume* volume = aTrack.GetLogicalVolumeAtVertex();
+    if (volume == nullptr) {
+      return false;
+    }
+    const bool inVolume = !m_selection.volumes.empty() && isListed(m_selection.volumes, volume->GetName());
+    const bool inRegion = !m_selection.regions.empty() && volume->GetRegion() != nullptr &&
+                          isListed(m_selection.regions, volume->GetRegion()->GetName());
+    if (!inVolume && !inRegion) {
+      return false;
+    }
+  }
   return true;
 }
 }
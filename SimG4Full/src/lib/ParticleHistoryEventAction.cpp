@@ -11,11 +11,19 @@ namespace sim {
 ParticleHistoryEventAction::ParticleHistoryEventAction() {}
 
 void  ParticleHistoryEventAction::BeginOfEventAction (const G4Event * /*anEvent*/) {
-
-  auto eventInfo = new sim::EventInformation();
+  // another action initialization (e.g. chained) may have created it already
+  if (G4EventManager::GetEventManager()->GetUserInformation() != nullptr) {
+    return;
+  }
+  auto eventInfo = new sim::EventInformation(m_numParticles);
   G4EventManager::GetEventManager()->SetUserInformation(eventInfo);
 }
   
-void  ParticleHistoryEventAction::EndOfEventAction (const G4Event * /*anEvent*/) {}
+void  ParticleHistoryEventAction::EndOfEventAction (const G4Event * anEvent) {
+  auto eventInfo = dynamic_cast<const sim::EventInformation*>(anEvent->GetUserInformation());
+  if (eventInfo != nullptr) {
+    m_numParticles = eventInfo->numParticles();
+  }
+}
 
 }
@@ -0,0 +1,98 @@
+#include "SimG4Full/RegionOfInterestAction.h"
+
+// FCCSW
+#include "SimG4Common/EventInformation.h"
+
+// Geant4
+#include "G4Event.hh"
+#include "G4EventManager.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+
+namespace {
+/// Information of the current event (created by ParticleHistoryEventAction)
+sim::EventInformation* currentInformation() {
+  return static_cast<sim::EventInformation*>(G4EventManager::GetEventManager()->GetUserInformation());
+}
+
+/// Define the cones around the seed primaries of the current event
+void defineRegion(sim::RegionOfInterest& aRegion, const sim::RegionOfInterestSelection& aSelection,
+                  sim::RegionOfInterestCounts& aCounts) {
+  aRegion.defined = true;
+  const G4Event* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+  for (int iVertex = 0; iVertex < event->GetNumberOfPrimaryVertex(); ++iVertex) {
+    for (const G4PrimaryParticle* particle = event->GetPrimaryVertex(iVertex)->GetPrimary(); particle != nullptr;
+         particle = particle->GetNext()) {
+      const G4ThreeVector& momentum = particle->GetMomentum();
+      if (momentum.mag() < aSelection.minSeedMomentum || momentum.perp2() == 0) continue;
+      if (!aSelection.seedPdgCodes.empty() && aSelection.seedPdgCodes.count(particle->GetPDGcode()) == 0) continue;
+      aRegion.cones.push_back({momentum.pseudoRapidity(), momentum.phi(), aSelection.deltaR});
+    }
+  }
+  ++aCounts.events;
+  aCounts.cones += aRegion.cones.size();
+  if (aRegion.cones.empty()) ++aCounts.eventsWithoutSeed;
+}
+
+/// Check if the track at the position is killed
+bool outside(const sim::RegionOfInterest& aRegion, const sim::RegionOfInterestSelection& aSelection,
+             const G4ThreeVector& aPosition, double aEnergy) {
+  return !aRegion.cones.empty() && aEnergy < aSelection.killMaxEnergy &&
+         aPosition.mag2() > aSelection.minRadius * aSelection.minRadius && aPosition.perp2() > 0 &&
+         !aRegion.contains(aPosition.pseudoRapidity(), aPosition.phi());
+}
+}
+
+namespace sim {
+RegionOfInterestStackingAction::RegionOfInterestStackingAction(const RegionOfInterestSelection& aSelection,
+                                                               std::shared_ptr<RegionOfInterestCounts> aCounts)
+    : G4UserStackingAction(), m_selection(aSelection), m_counts(aCounts) {}
+
+G4ClassificationOfNewTrack RegionOfInterestStackingAction::ClassifyNewTrack(const G4Track* aTrack) {
+  EventInformation* evtinfo = currentInformation();
+  if (evtinfo == nullptr) {
+    return fUrgent;
+  }
+  RegionOfInterest* region = &evtinfo->regionOfInterest();
+  if (!region->defined) {
+    defineRegion(*region, m_selection, *m_counts);
+  }
+  // primaries are killed only when they leave the cones
+  if (aTrack->GetParentID() == 0 || !outside(*region, m_selection, aTrack->GetPosition(), aTrack->GetKineticEnergy())) {
+    return fUrgent;
+  }
+  ++region->killedAtCreation;
+  region->killedEnergy += aTrack->GetKineticEnergy();
+  ++m_counts->killedAtCreation;
+  // the particle history does not wait for the killed track
+  evtinfo->discardTrack(aTrack);
+  return fKill;
+}
+
+RegionOfInterestSteppingAction::RegionOfInterestSteppingAction(const RegionOfInterestSelection& aSelection,
+                                                               std::shared_ptr<RegionOfInterestCounts> aCounts,
+                                                               bool aCountSteps)
+    : G4UserSteppingAction(), m_selection(aSelection), m_counts(aCounts), m_countSteps(aCountSteps) {}
+
+void RegionOfInterestSteppingAction::UserSteppingAction(const G4Step* aStep) {
+  EventInformation* evtinfo = currentInformation();
+  if (evtinfo == nullptr) {
+    return;
+  }
+  G4Track* track = aStep->GetTrack();
+  if (m_countSteps) {
+    evtinfo->countStep(track->GetCurrentStepNumber() == 1);
+  }
+  RegionOfInterest& region = evtinfo->regionOfInterest();
+  if (track->GetTrackStatus() != fAlive ||
+      !outside(region, m_selection, aStep->GetPostStepPoint()->GetPosition(), track->GetKineticEnergy())) {
+    return;
+  }
+  track->SetTrackStatus(fStopAndKill);
+  ++region.killedLeaving;
+  region.killedEnergy += track->GetKineticEnergy();
+  ++m_counts->killedLeaving;
+}
+}
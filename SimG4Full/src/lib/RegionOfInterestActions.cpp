@@ -0,0 +1,24 @@
+#include "SimG4Full/RegionOfInterestActions.h"
+
+#include "SimG4Full/ParticleHistoryEventAction.h"
+
+namespace sim {
+RegionOfInterestActions::RegionOfInterestActions(const RegionOfInterestSelection& aRegionSelection,
+                                                 std::shared_ptr<RegionOfInterestCounts> aCounts, bool enableHistory,
+                                                 const ParticleHistorySelection& aSelection, bool aCountSteps)
+    : G4VUserActionInitialization(),
+      m_fullSimActions(enableHistory, aSelection),
+      m_enableHistory(enableHistory),
+      m_countSteps(aCountSteps),
+      m_regionSelection(aRegionSelection),
+      m_counts(aCounts) {}
+
+void RegionOfInterestActions::Build() const {
+  m_fullSimActions.Build();
+  if (!m_enableHistory) {
+    SetUserAction(new ParticleHistoryEventAction());
+  }
+  SetUserAction(new RegionOfInterestStackingAction(m_regionSelection, m_counts));
+  SetUserAction(new RegionOfInterestSteppingAction(m_regionSelection, m_counts, m_countSteps));
+}
+}
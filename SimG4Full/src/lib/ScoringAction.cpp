@@ -0,0 +1,78 @@
+#include "SimG4Full/ScoringAction.h"
+
+#include "G4Material.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+
+// STL
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+ScoringAction::ScoringAction(std::shared_ptr<ScoringMesh> aMesh, const ScoringSelection& aSelection)
+    : m_mesh(aMesh), m_selection(aSelection) {
+  const size_t size = m_mesh->numQuantities() * m_mesh->numBins();
+  m_event.assign(size, 0);
+  m_sums.sum.assign(size, 0);
+  m_sums.sum2.assign(size, 0);
+}
+
+void ScoringAction::add(int aQuantity, long aBin, double aValue) {
+  const size_t entry = aQuantity * m_mesh->numBins() + aBin;
+  if (m_event[entry] == 0) m_touched.push_back(entry);
+  m_event[entry] += aValue;
+}
+
+void ScoringAction::UserSteppingAction(const G4Step* aStep) {
+  const G4StepPoint* preStep = aStep->GetPreStepPoint();
+  const G4Track* track = aStep->GetTrack();
+  const int pdg = track->GetDefinition()->GetPDGEncoding();
+  const double length = aStep->GetStepLength();
+  // values per part of the step, divided by the volume of its bin
+  const int dose = m_mesh->index(ScoringMesh::kDose);
+  const int fluence = m_mesh->index(ScoringMesh::kFluence);
+  const int neqFluence = m_mesh->index(ScoringMesh::kNeqFluence);
+  const G4Material* material = preStep->GetMaterial();
+  double doseValue = dose >= 0 && material != nullptr ? aStep->GetTotalEnergyDeposit() / material->GetDensity() : 0;
+  double fluenceValue =
+      fluence >= 0 && (m_selection.fluencePdgCodes.empty() || m_selection.fluencePdgCodes.count(pdg) > 0) ? length : 0;
+  double neqValue = neqFluence >= 0 ? length * m_selection.damage.factor(pdg, preStep->GetKineticEnergy()) : 0;
+  if (doseValue == 0 && fluenceValue == 0 && neqValue == 0) return;
+  const G4ThreeVector& start = preStep->GetPosition();
+  const G4ThreeVector direction = aStep->GetPostStepPoint()->GetPosition() - start;
+  unsigned int numSegments = 1;
+  if (m_selection.maxSegment > 0 && length > m_selection.maxSegment) {
+    numSegments = std::min<double>(std::ceil(length / m_selection.maxSegment), m_selection.maxSegments);
+    doseValue /= numSegments;
+    fluenceValue /= numSegments;
+    neqValue /= numSegments;
+  }
+  for (unsigned int iSegment = 0; iSegment < numSegments; ++iSegment) {
+    const long bin = m_mesh->bin(start + ((iSegment + 0.5) / numSegments) * direction);
+    if (bin < 0) continue;
+    const double inverseVolume = m_mesh->inverseVolume(bin);
+    if (doseValue != 0) add(dose, bin, doseValue * inverseVolume);
+    if (fluenceValue != 0) add(fluence, bin, fluenceValue * inverseVolume);
+    if (neqValue != 0) add(neqFluence, bin, neqValue * inverseVolume);
+  }
+}
+
+void ScoringAction::endEvent() {
+  for (size_t entry : m_touched) {
+    const double value = m_event[entry];
+    m_sums.sum[entry] += value;
+    m_sums.sum2[entry] += value * value;
+    m_event[entry] = 0;
+  }
+  m_touched.clear();
+  ++m_sums.events;
+}
+
+void ScoringAction::merge() {
+  m_mesh->merge(m_sums);
+  m_sums.events = 0;
+  std::fill(m_sums.sum.begin(), m_sums.sum.end(), 0);
+  std::fill(m_sums.sum2.begin(), m_sums.sum2.end(), 0);
+}
+}
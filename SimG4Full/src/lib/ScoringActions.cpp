@@ -0,0 +1,13 @@
+#include "SimG4Full/ScoringActions.h"
+
+namespace sim {
+ScoringActions::ScoringActions(std::shared_ptr<ScoringMesh> aMesh, const ScoringSelection& aSelection)
+    : G4VUserActionInitialization(), m_mesh(aMesh), m_selection(aSelection) {}
+
+void ScoringActions::Build() const {
+  auto steppingAction = new ScoringAction(m_mesh, m_selection);
+  SetUserAction(steppingAction);
+  SetUserAction(new ScoringEventAction(steppingAction));
+  SetUserAction(new ScoringRunAction(steppingAction));
+}
+}
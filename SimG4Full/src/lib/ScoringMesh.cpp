@@ -0,0 +1,115 @@
+#include "SimG4Full/ScoringMesh.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+void DamageFunction::set(int aPdgCode, const std::vector<double>& aEnergies, const std::vector<double>& aFactors) {
+  auto& table = m_tables[aPdgCode];
+  table.first.clear();
+  table.second.clear();
+  for (size_t iPoint = 0; iPoint < aEnergies.size() && iPoint < aFactors.size(); ++iPoint) {
+    // factors are positive, a zero factor is the smallest representable one
+    table.first.push_back(std::log(aEnergies[iPoint]));
+    table.second.push_back(std::log(std::max(aFactors[iPoint], 1e-300)));
+  }
+}
+
+double DamageFunction::factor(int aPdgCode, double aEnergy) const {
+  auto table = m_tables.find(aPdgCode);
+  if (table == m_tables.end() || table->second.first.empty() || aEnergy <= 0) return 0;
+  const std::vector<double>& energies = table->second.first;
+  const std::vector<double>& factors = table->second.second;
+  // constant beyond the ends of the table
+  const double logEnergy = std::log(aEnergy);
+  if (logEnergy <= energies.front()) return std::exp(factors.front());
+  if (logEnergy >= energies.back()) return std::exp(factors.back());
+  const size_t upper = std::upper_bound(energies.begin(), energies.end(), logEnergy) - energies.begin();
+  const double fraction = (logEnergy - energies[upper - 1]) / (energies[upper] - energies[upper - 1]);
+  return std::exp(factors[upper - 1] + fraction * (factors[upper] - factors[upper - 1]));
+}
+
+ScoringMesh::ScoringMesh(const Definition& aDefinition, const std::set<Quantity>& aQuantities)
+    : m_definition(aDefinition), m_numQuantities(0) {
+  m_numBins = 1;
+  for (size_t iCoord = 0; iCoord < 3; ++iCoord) {
+    m_numBins *= m_definition.bins[iCoord];
+    m_widths[iCoord] = (m_definition.max[iCoord] - m_definition.min[iCoord]) / m_definition.bins[iCoord];
+  }
+  m_indices.fill(-1);
+  for (Quantity quantity : aQuantities) {
+    m_indices[quantity] = m_numQuantities++;
+  }
+  m_inverseVolumes.resize(m_numBins);
+  for (size_t iBin = 0; iBin < m_numBins; ++iBin) {
+    m_inverseVolumes[iBin] = 1. / volume(iBin);
+  }
+  m_sums.sum.assign(m_numQuantities * m_numBins, 0);
+  m_sums.sum2.assign(m_numQuantities * m_numBins, 0);
+}
+
+long ScoringMesh::bin(const G4ThreeVector& aPosition) const {
+  std::array<double, 3> coords;
+  if (m_definition.cylinder) {
+    coords = {aPosition.perp(), aPosition.phi(), aPosition.z()};
+    // phi ranges beyond [-pi, pi] (e.g. [0, 2pi])
+    if (coords[1] < m_definition.min[1]) coords[1] += 2 * M_PI;
+  } else {
+    coords = {aPosition.x(), aPosition.y(), aPosition.z()};
+  }
+  long bin = 0;
+  for (size_t iCoord = 0; iCoord < 3; ++iCoord) {
+    const double offset = (coords[iCoord] - m_definition.min[iCoord]) / m_widths[iCoord];
+    if (offset < 0 || offset >= m_definition.bins[iCoord]) return -1;
+    bin = bin * m_definition.bins[iCoord] + static_cast<long>(offset);
+  }
+  return bin;
+}
+
+std::array<unsigned int, 3> ScoringMesh::indices(size_t aBin) const {
+  std::array<unsigned int, 3> indices;
+  for (int iCoord = 2; iCoord >= 0; --iCoord) {
+    indices[iCoord] = aBin % m_definition.bins[iCoord];
+    aBin /= m_definition.bins[iCoord];
+  }
+  return indices;
+}
+
+std::array<double, 3> ScoringMesh::centre(size_t aBin) const {
+  const std::array<unsigned int, 3> binIndices = indices(aBin);
+  std::array<double, 3> centre;
+  for (size_t iCoord = 0; iCoord < 3; ++iCoord) {
+    centre[iCoord] = m_definition.min[iCoord] + (binIndices[iCoord] + 0.5) * m_widths[iCoord];
+  }
+  return centre;
+}
+
+double ScoringMesh::volume(size_t aBin) const {
+  if (!m_definition.cylinder) {
+    return m_widths[0] * m_widths[1] * m_widths[2];
+  }
+  const double rMin = m_definition.min[0] + indices(aBin)[0] * m_widths[0];
+  const double rMax = rMin + m_widths[0];
+  return 0.5 * (rMax * rMax - rMin * rMin) * m_widths[1] * m_widths[2];
+}
+
+double ScoringMesh::minWidth() const {
+  return m_definition.cylinder ? std::min(m_widths[0], m_widths[2])
+                               : std::min({m_widths[0], m_widths[1], m_widths[2]});
+}
+
+void ScoringMesh::merge(const Sums& aSums) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_sums.events += aSums.events;
+  for (size_t iEntry = 0; iEntry < aSums.sum.size() && iEntry < m_sums.sum.size(); ++iEntry) {
+    m_sums.sum[iEntry] += aSums.sum[iEntry];
+    m_sums.sum2[iEntry] += aSums.sum2[iEntry];
+  }
+}
+
+ScoringMesh::Sums ScoringMesh::sums() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_sums;
+}
+}
@@ -0,0 +1,50 @@
+#include "SimG4Full/StackingAction.h"
+
+// FCCSW
+#include "SimG4Common/EventInformation.h"
+
+#include "G4EventManager.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Track.hh"
+
+// STL
+#include <cmath>
+
+namespace sim {
+StackingAction::StackingAction(const StackingSelection& aSelection, std::shared_ptr<StackingCounts> aCounts)
+    : G4UserStackingAction(),
+      m_selection(aSelection),
+      m_prune(aSelection.maxRadius < DBL_MAX || aSelection.maxZ < DBL_MAX),
+      m_counts(aCounts) {}
+
+G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track* aTrack) {
+  if (aTrack->GetParentID() == 0) {
+    return fUrgent;
+  }
+  const int pdgCode = aTrack->GetParticleDefinition()->GetPDGEncoding();
+  if (m_selection.killPdgCodes.count(pdgCode) > 0) {
+    ++m_counts->killed;
+    return kill(aTrack);
+  }
+  const double energy = aTrack->GetKineticEnergy();
+  if (m_prune && energy < m_selection.pruneMaxEnergy) {
+    const G4ThreeVector& position = aTrack->GetPosition();
+    if (position.perp2() > m_selection.maxRadius * m_selection.maxRadius || std::abs(position.z()) > m_selection.maxZ) {
+      ++m_counts->pruned;
+      return kill(aTrack);
+    }
+  }
+  if (energy < m_selection.postponeMaxEnergy && m_selection.postponePdgCodes.count(pdgCode) > 0) {
+    ++m_counts->postponed;
+    return fWaiting;
+  }
+  return fUrgent;
+}
+
+G4ClassificationOfNewTrack StackingAction::kill(const G4Track* aTrack) const {
+  // the particle history does not wait for the killed track
+  auto evtinfo = dynamic_cast<EventInformation*>(G4EventManager::GetEventManager()->GetUserInformation());
+  if (evtinfo != nullptr) evtinfo->discardTrack(aTrack);
+  return fKill;
+}
+}
@@ -0,0 +1,15 @@
+#include "SimG4Full/StackingActions.h"
+
+namespace sim {
+StackingActions::StackingActions(const StackingSelection& aStackingSelection, std::shared_ptr<StackingCounts> aCounts,
+                                 bool enableHistory, const ParticleHistorySelection& aSelection, bool aCountSteps)
+    : G4VUserActionInitialization(),
+      m_fullSimActions(enableHistory, aSelection, aCountSteps),
+      m_stackingSelection(aStackingSelection),
+      m_counts(aCounts) {}
+
+void StackingActions::Build() const {
+  m_fullSimActions.Build();
+  SetUserAction(new StackingAction(m_stackingSelection, m_counts));
+}
+}
@@ -0,0 +1,51 @@
+#include "SimG4Full/StagingAction.h"
+
+// FCCSW
+#include "SimG4Common/EventInformation.h"
+
+#include "G4EventManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+
+namespace {
+/// Information of the current event, created if it does not exist yet
+sim::EventInformation* currentInformation() {
+  G4EventManager* eventManager = G4EventManager::GetEventManager();
+  auto evtinfo = static_cast<sim::EventInformation*>(eventManager->GetUserInformation());
+  if (evtinfo == nullptr) {
+    evtinfo = new sim::EventInformation();
+    eventManager->SetUserInformation(evtinfo);
+  }
+  return evtinfo;
+}
+}
+
+namespace sim {
+StagingAction::StagingAction(const std::unordered_set<const G4LogicalVolume*>& aEnvelopes,
+                             std::shared_ptr<StagingCounts> aCounts, G4UserSteppingAction* aChained)
+    : m_envelopes(aEnvelopes), m_counts(aCounts), m_chained(aChained) {}
+
+void StagingAction::UserSteppingAction(const G4Step* aStep) {
+  if (m_chained != nullptr) {
+    m_chained->UserSteppingAction(aStep);
+  }
+  G4Track* track = aStep->GetTrack();
+  const G4StepPoint* postStep = aStep->GetPostStepPoint();
+  if (track->GetTrackStatus() != fAlive || postStep->GetStepStatus() != fGeomBoundary ||
+      postStep->GetPhysicalVolume() == nullptr ||
+      m_envelopes.count(postStep->GetPhysicalVolume()->GetLogicalVolume()) == 0) {
+    return;
+  }
+  track->SetTrackStatus(fStopAndKill);
+  const G4ParticleDefinition* particle = track->GetParticleDefinition();
+  const G4ThreeVector& momentum = postStep->GetMomentum();
+  const G4ThreeVector& position = postStep->GetPosition();
+  currentInformation()->addStagedTrack({track->GetTrackID(), particle->GetPDGEncoding(), particle->GetPDGMass(),
+                                        particle->GetPDGCharge(), momentum.x(), momentum.y(), momentum.z(),
+                                        position.x(), position.y(), position.z(), postStep->GetGlobalTime()});
+  ++m_counts->tracks;
+}
+}
@@ -0,0 +1,16 @@
+#include "SimG4Full/StepCountingAction.h"
+
+#include "SimG4Common/EventInformation.h"
+
+#include "G4EventManager.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+
+namespace sim {
+void StepCountingAction::UserSteppingAction(const G4Step* aStep) {
+  auto evtinfo = static_cast<sim::EventInformation*>(G4EventManager::GetEventManager()->GetUserInformation());
+  if (evtinfo != nullptr) {
+    evtinfo->countStep(aStep->GetTrack()->GetCurrentStepNumber() == 1);
+  }
+}
+}
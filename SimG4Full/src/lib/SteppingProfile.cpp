@@ -0,0 +1,48 @@
+#include "SimG4Full/SteppingProfile.h"
+
+namespace sim {
+void SteppingProfile::merge(const Table& aDetectors, const Table& aVolumes, const Table& aRegions,
+                            const Table& aParticles, const Table& aProcesses) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (const auto& entry : aDetectors) {
+    m_detectors[entry.first].add(entry.second);
+  }
+  for (const auto& entry : aVolumes) {
+    m_volumes[entry.first].add(entry.second);
+  }
+  for (const auto& entry : aRegions) {
+    m_regions[entry.first].add(entry.second);
+  }
+  for (const auto& entry : aParticles) {
+    m_particles[entry.first].add(entry.second);
+  }
+  for (const auto& entry : aProcesses) {
+    m_processes[entry.first].add(entry.second);
+  }
+}
+
+SteppingProfile::Table SteppingProfile::detectors() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_detectors;
+}
+
+SteppingProfile::Table SteppingProfile::volumes() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_volumes;
+}
+
+SteppingProfile::Table SteppingProfile::regions() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_regions;
+}
+
+SteppingProfile::Table SteppingProfile::particles() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_particles;
+}
+
+SteppingProfile::Table SteppingProfile::processes() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_processes;
+}
+}
@@ -0,0 +1,107 @@
+#include "SimG4Full/SteppingProfileAction.h"
+
+#include "G4EventManager.hh"
+#include "G4FieldManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Region.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4TransportationManager.hh"
+#include "G4VTouchable.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+
+// STL
+#include <ctime>
+
+namespace sim {
+SteppingProfileAction::SteppingProfileAction(std::shared_ptr<SteppingProfile> aProfile, bool aMeasureTime,
+                                             bool aPerProcess)
+    : m_profile(aProfile), m_measureTime(aMeasureTime), m_perProcess(aPerProcess), m_lastTime(0),
+      m_lastEvent(nullptr) {}
+
+double SteppingProfileAction::threadTime() {
+  timespec now;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  return now.tv_sec + 1e-9 * now.tv_nsec;
+}
+
+bool SteppingProfileAction::inField(const G4Step* aStep, const G4LogicalVolume* aVolume) {
+  if (aStep->GetTrack()->GetDynamicParticle()->GetCharge() == 0) return false;
+  const G4FieldManager* fieldManager = aVolume != nullptr ? aVolume->GetFieldManager() : nullptr;
+  if (fieldManager == nullptr) {
+    fieldManager = G4TransportationManager::GetTransportationManager()->GetFieldManager();
+  }
+  return fieldManager != nullptr && fieldManager->DoesFieldExist();
+}
+
+void SteppingProfileAction::UserSteppingAction(const G4Step* aStep) {
+  double time = 0;
+  if (m_measureTime) {
+    double now = threadTime();
+    // time spent outside of the simulation (between events) is not attributed
+    const G4Event* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+    if (event == m_lastEvent) time = now - m_lastTime;
+    m_lastTime = now;
+    m_lastEvent = event;
+  }
+  double energy = aStep->GetTotalEnergyDeposit();
+  auto add = [time, energy](SteppingProfile::Entry& aEntry) {
+    ++aEntry.steps;
+    aEntry.time += time;
+    aEntry.energy += energy;
+  };
+  const G4VPhysicalVolume* volume = aStep->GetPreStepPoint()->GetPhysicalVolume();
+  const G4LogicalVolume* logical = volume != nullptr ? volume->GetLogicalVolume() : nullptr;
+  if (logical != nullptr) {
+    add(m_volumes[logical]);
+    add(m_regions[logical->GetRegion()]);
+    // the sub-detector is the placement in the world containing the step (the world itself if outside of all)
+    const G4VTouchable* touchable = aStep->GetPreStepPoint()->GetTouchable();
+    const int depth = touchable->GetHistoryDepth();
+    add(m_detectors[touchable->GetVolume(depth > 0 ? depth - 1 : 0)]);
+  }
+  add(m_particles[aStep->GetTrack()->GetDefinition()]);
+  if (m_perProcess) {
+    const G4VProcess* process = aStep->GetPostStepPoint()->GetProcessDefinedStep();
+    // the field is looked up only for the transportation steps
+    const bool transportation = process != nullptr && process->GetProcessType() == fTransportation;
+    add(m_processes[{aStep->GetTrack()->GetDefinition(), logical != nullptr ? logical->GetRegion() : nullptr, process,
+                     transportation && inField(aStep, logical)}]);
+  }
+}
+
+void SteppingProfileAction::merge() {
+  SteppingProfile::Table detectors, volumes, regions, particles, processes;
+  for (const auto& entry : m_detectors) {
+    detectors[entry.first->GetName()].add(entry.second);
+  }
+  for (const auto& entry : m_volumes) {
+    volumes[entry.first->GetName()].add(entry.second);
+  }
+  for (const auto& entry : m_regions) {
+    regions[entry.first != nullptr ? std::string(entry.first->GetName()) : "none"].add(entry.second);
+  }
+  for (const auto& entry : m_particles) {
+    particles[entry.first->GetParticleName()].add(entry.second);
+  }
+  for (const auto& entry : m_processes) {
+    std::string name = entry.first.particle->GetParticleName() + ":";
+    name += entry.first.region != nullptr ? std::string(entry.first.region->GetName()) : "none";
+    name += ":";
+    name += entry.first.process != nullptr ? std::string(entry.first.process->GetProcessName()) : "none";
+    if (entry.first.inField) name += " (field)";
+    processes[name].add(entry.second);
+  }
+  m_profile->merge(detectors, volumes, regions, particles, processes);
+  m_detectors.clear();
+  m_volumes.clear();
+  m_regions.clear();
+  m_particles.clear();
+  m_processes.clear();
+  m_lastEvent = nullptr;
+}
+
+void SteppingProfileRunAction::EndOfRunAction(const G4Run*) { m_action->merge(); }
+}
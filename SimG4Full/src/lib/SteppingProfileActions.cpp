@@ -0,0 +1,21 @@
+#include "SimG4Full/SteppingProfileActions.h"
+
+#include "SimG4Full/SteppingProfileAction.h"
+
+namespace sim {
+SteppingProfileActions::SteppingProfileActions(std::shared_ptr<SteppingProfile> aProfile, bool aMeasureTime,
+                                               bool aPerProcess, bool enableHistory,
+                                               const ParticleHistorySelection& aSelection)
+    : G4VUserActionInitialization(),
+      m_fullSimActions(enableHistory, aSelection),
+      m_profile(aProfile),
+      m_measureTime(aMeasureTime),
+      m_perProcess(aPerProcess) {}
+
+void SteppingProfileActions::Build() const {
+  m_fullSimActions.Build();
+  auto steppingAction = new SteppingProfileAction(m_profile, m_measureTime, m_perProcess);
+  SetUserAction(steppingAction);
+  SetUserAction(new SteppingProfileRunAction(steppingAction));
+}
+}
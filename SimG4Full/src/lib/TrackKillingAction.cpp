@@ -0,0 +1,83 @@
+#include "SimG4Full/TrackKillingAction.h"
+
+#include "G4LogicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+
+// STL
+#include <cfloat>
+
+namespace sim {
+TrackKillingAction::TrackKillingAction(const std::map<int, double>& aMinKineticEnergy,
+                                       const std::map<int, double>& aMaxTime,
+                                       const std::unordered_set<const G4LogicalVolume*>& aKillVolumes,
+                                       G4UserSteppingAction* aChained)
+    : m_minKineticEnergy(aMinKineticEnergy),
+      m_maxTime(aMaxTime),
+      m_thresholds(!aMinKineticEnergy.empty() || !aMaxTime.empty()),
+      m_killVolumes(aKillVolumes),
+      m_chained(aChained) {}
+
+const TrackKillingAction::Thresholds& TrackKillingAction::thresholds(const G4ParticleDefinition* aParticle) {
+  if (aParticle != m_lastParticle) {
+    auto found = m_particleThresholds.find(aParticle);
+    if (found == m_particleThresholds.end()) {
+      // thresholds of the particle type, or of all the other particles (code 0), if any
+      auto value = [aParticle](const std::map<int, double>& aMap, double aDefault) {
+        auto entry = aMap.find(aParticle->GetPDGEncoding());
+        if (entry == aMap.end()) entry = aMap.find(0);
+        return entry == aMap.end() ? aDefault : entry->second;
+      };
+      const Thresholds particleThresholds{value(m_minKineticEnergy, 0), value(m_maxTime, DBL_MAX)};
+      found = m_particleThresholds.emplace(aParticle, particleThresholds).first;
+    }
+    m_lastParticle = aParticle;
+    m_lastThresholds = &found->second;
+  }
+  return *m_lastThresholds;
+}
+
+void TrackKillingAction::UserSteppingAction(const G4Step* aStep) {
+  if (m_chained != nullptr) {
+    m_chained->UserSteppingAction(aStep);
+  }
+  const G4Track* track = aStep->GetTrack();
+  if (track->GetTrackStatus() != fAlive) {
+    return;
+  }
+  const G4StepPoint* postStep = aStep->GetPostStepPoint();
+  if (!m_killVolumes.empty() && postStep->GetStepStatus() == fGeomBoundary &&
+      postStep->GetPhysicalVolume() != nullptr &&
+      m_killVolumes.count(postStep->GetPhysicalVolume()->GetLogicalVolume()) > 0) {
+    kill(aStep, kVolume);
+    return;
+  }
+  if (!m_thresholds) {
+    return;
+  }
+  const Thresholds& particleThresholds = thresholds(track->GetParticleDefinition());
+  if (postStep->GetKineticEnergy() < particleThresholds.minKineticEnergy) {
+    kill(aStep, kEnergy);
+  } else if (postStep->GetGlobalTime() > particleThresholds.maxTime) {
+    kill(aStep, kTime);
+  }
+}
+
+void TrackKillingAction::kill(const G4Step* aStep, Reason aReason) {
+  G4Track* track = aStep->GetTrack();
+  track->SetTrackStatus(fStopAndKill);
+  const G4ParticleDefinition* particle = track->GetParticleDefinition();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Count& count = m_counts[{aReason, particle->GetPDGEncoding()}];
+  if (count.tracks == 0) count.particle = particle->GetParticleName();
+  ++count.tracks;
+  count.energy += aStep->GetPostStepPoint()->GetKineticEnergy();
+}
+
+std::map<std::pair<TrackKillingAction::Reason, int>, TrackKillingAction::Count> TrackKillingAction::counts() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_counts;
+}
+}
@@ -0,0 +1,41 @@
+#include "SimG4Full/TrajectoryFilterAction.h"
+
+// Geant4
+#include "G4LogicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Region.hh"
+#include "G4Track.hh"
+#include "G4TrackingManager.hh"
+#include "G4VPhysicalVolume.hh"
+
+namespace sim {
+TrajectoryFilterAction::TrajectoryFilterAction(const TrajectorySelection& aSelection,
+                                               std::shared_ptr<TrajectoryFilterCounts> aCounts)
+    : G4UserTrackingAction(), m_selection(aSelection), m_counts(aCounts) {}
+
+void TrajectoryFilterAction::PreUserTrackingAction(const G4Track* aTrack) {
+  // called before the tracking manager creates the trajectory of the track
+  const bool selected = isSelected(*aTrack);
+  fpTrackingManager->SetStoreTrajectory(selected ? m_selection.trajectoryType : 0);
+  ++m_counts->tracks;
+  if (selected) ++m_counts->stored;
+}
+
+bool TrajectoryFilterAction::isSelected(const G4Track& aTrack) const {
+  if (m_selection.primaryOnly && aTrack.GetParentID() != 0) return false;
+  if (aTrack.GetMomentum().mag() < m_selection.minMomentum) return false;
+  if (!m_selection.pdgCodes.empty() &&
+      m_selection.pdgCodes.count(aTrack.GetDefinition()->GetPDGEncoding()) == 0) {
+    return false;
+  }
+  if (!m_selection.regions.empty()) {
+    // the track is already located at its starting point
+    const G4VPhysicalVolume* volume = aTrack.GetVolume();
+    const G4Region* region = volume ? volume->GetLogicalVolume()->GetRegion() : nullptr;
+    if (region == nullptr || m_selection.regions.count(region->GetName()) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+}
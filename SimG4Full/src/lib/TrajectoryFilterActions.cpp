@@ -0,0 +1,9 @@
+#include "SimG4Full/TrajectoryFilterActions.h"
+
+namespace sim {
+TrajectoryFilterActions::TrajectoryFilterActions(const TrajectorySelection& aSelection,
+                                                 std::shared_ptr<TrajectoryFilterCounts> aCounts)
+    : G4VUserActionInitialization(), m_selection(aSelection), m_counts(aCounts) {}
+
+void TrajectoryFilterActions::Build() const { SetUserAction(new TrajectoryFilterAction(m_selection, m_counts)); }
+}
@@ -0,0 +1,27 @@
+#ifndef SIMG4INTERFACE_ICELLNEIGHBOURSSVC_H
+#define SIMG4INTERFACE_ICELLNEIGHBOURSSVC_H
+
+// Gaudi
+#include "GaudiKernel/IService.h"
+
+// STL
+#include <cstddef>
+#include <cstdint>
+
+/** @class ICellNeighboursSvc SimG4Interface/SimG4Interface/ICellNeighboursSvc.h ICellNeighboursSvc.h
+ *
+ *  Interface to the service giving the neighbours of the cells of a readout, from a map built once for the geometry.
+ *  The lookups need to be thread-safe.
+ */
+
+class ICellNeighboursSvc : virtual public IService {
+public:
+  DeclareInterfaceID(ICellNeighboursSvc, 1, 0);
+  /**  Get the neighbours of a cell.
+   *   @param[in] aCellID cellID of the cell
+   *   @param[out] aNeighbours first of the cellIDs of the neighbours, sorted (valid as long as the service)
+   *   @return number of neighbours (0 if the cell is not in the map)
+   */
+  virtual size_t neighbours(uint64_t aCellID, const uint64_t*& aNeighbours) const = 0;
+};
+#endif /* SIMG4INTERFACE_ICELLNEIGHBOURSSVC_H */
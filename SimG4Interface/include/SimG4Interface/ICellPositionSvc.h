@@ -0,0 +1,41 @@
+#ifndef SIMG4INTERFACE_ICELLPOSITIONSVC_H
+#define SIMG4INTERFACE_ICELLPOSITIONSVC_H
+
+// Gaudi
+#include "GaudiKernel/IService.h"
+
+// STL
+#include <cstdint>
+#include <string>
+
+/** @class ICellPositionSvc SimG4Interface/SimG4Interface/ICellPositionSvc.h ICellPositionSvc.h
+ *
+ *  Interface to the service giving the positions of the centres of the cells of the readouts, from a table of the
+ *  cellIDs per readout instead of the segmentation and the volume manager.
+ *  The tables are shared by all the threads, their lookups need to be thread-safe.
+ */
+
+class ICellPositionSvc : virtual public IService {
+public:
+  DeclareInterfaceID(ICellPositionSvc, 1, 0);
+  /// Position of the centre of a cell [mm]
+  struct Position {
+    float x, y, z;
+  };
+  /// Table of the positions of the cells of a readout
+  class Table {
+  public:
+    virtual ~Table() = default;
+    /**  Get the position of a cell.
+     *   @param[in] aCellID cellID of the cell (of the readout of the table)
+     *   @return position of the centre of the cell [mm]
+     */
+    virtual Position position(uint64_t aCellID) const = 0;
+  };
+  /**  Get the table of a readout (created at the first call for this readout).
+   *   @param[in] aReadoutName name of the readout
+   *   @return table of the positions (owned by the service), nullptr if the readout does not exist
+   */
+  virtual const Table* table(const std::string& aReadoutName) = 0;
+};
+#endif /* SIMG4INTERFACE_ICELLPOSITIONSVC_H */
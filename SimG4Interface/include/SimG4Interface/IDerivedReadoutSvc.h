@@ -0,0 +1,56 @@
+#ifndef SIMG4INTERFACE_IDERIVEDREADOUTSVC_H
+#define SIMG4INTERFACE_IDERIVEDREADOUTSVC_H
+
+// Gaudi
+#include "GaudiKernel/IService.h"
+
+// STL
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// DD4hep
+namespace dd4hep {
+namespace DDSegmentation {
+class BitFieldCoder;
+}
+}
+
+// datamodel
+namespace edm4hep {
+class CalorimeterHitCollection;
+class SimCalorimeterHitCollection;
+}
+
+/** @class IDerivedReadoutSvc SimG4Interface/SimG4Interface/IDerivedReadoutSvc.h IDerivedReadoutSvc.h
+ *
+ *  Interface to the service giving the cellIDs of the hits of a fine (master) readout in coarser readouts derived
+ *  from it, computed at the first request for the hits in the event instead of copying the hits for each readout.
+ *  The requests need to be thread-safe.
+ */
+
+class IDerivedReadoutSvc : virtual public IService {
+public:
+  DeclareInterfaceID(IDerivedReadoutSvc, 1, 0);
+  /**  Get the cellIDs of the hits in a derived readout.
+   *   @param[in] aReadoutName name of the derived readout
+   *   @param[in] aHits hits of the master readout
+   *   @return cellIDs, one per hit in the order of the hits (nullptr if the readout is not derived)
+   */
+  virtual std::shared_ptr<const std::vector<uint64_t>> cellIDs(const std::string& aReadoutName,
+                                                               const edm4hep::CalorimeterHitCollection& aHits) = 0;
+  /**  Get the cellIDs of the simulated hits in a derived readout.
+   *   @param[in] aReadoutName name of the derived readout
+   *   @param[in] aHits hits of the master readout
+   *   @return cellIDs, one per hit in the order of the hits (nullptr if the readout is not derived)
+   */
+  virtual std::shared_ptr<const std::vector<uint64_t>> cellIDs(const std::string& aReadoutName,
+                                                               const edm4hep::SimCalorimeterHitCollection& aHits) = 0;
+  /**  Get the bitfield of a derived readout.
+   *   @param[in] aReadoutName name of the derived readout
+   *   @return bitfield decoding the derived cellIDs (nullptr if the readout is not derived)
+   */
+  virtual const dd4hep::DDSegmentation::BitFieldCoder* decoder(const std::string& aReadoutName) const = 0;
+};
+#endif /* SIMG4INTERFACE_IDERIVEDREADOUTSVC_H */
@@ -0,0 +1,50 @@
+#ifndef SIMG4INTERFACE_ISIMG4EMTRANSPORTTOOL_H
+#define SIMG4INTERFACE_ISIMG4EMTRANSPORTTOOL_H
+
+// Gaudi
+#include "GaudiKernel/IAlgTool.h"
+
+// STL
+#include <string>
+#include <vector>
+
+/** @class ISimG4EmTransportTool SimG4Interface/SimG4Interface/ISimG4EmTransportTool.h ISimG4EmTransportTool.h
+ *
+ *  Interface to the engines transporting the electromagnetic showers outside of Geant (e.g. on a GPU).
+ *  The engine takes a batch of electrons, positrons and photons (collected over the event by
+ *  sim::FastSimModelEmOffload) and returns the energy deposits of their showers; each deposit is attributed to the
+ *  track of the batch that started the shower. Units are those of Geant (mm, MeV, ns).
+ *  An engine may be called from several threads, each with the batch of its own event.
+ */
+
+class ISimG4EmTransportTool : virtual public IAlgTool {
+public:
+  DeclareInterfaceID(ISimG4EmTransportTool, 1, 0);
+
+  /// Particle given to the engine
+  struct Track {
+    int pdg;
+    double energy;
+    double x, y, z;
+    double dx, dy, dz;
+    double time;
+  };
+  /// Energy deposit returned by the engine
+  struct Deposit {
+    /// index of the track in the batch
+    unsigned int track;
+    double x, y, z;
+    double energy;
+    double time;
+  };
+
+  /// Name of the engine (e.g. of the device it runs on), for the messages
+  virtual std::string engineName() const = 0;
+  /**  Transport the particles of the batch.
+   *   @param[in] aTracks particles of the batch
+   *   @param[out] aDeposits energy deposits of the batch (appended)
+   *   @return status code
+   */
+  virtual StatusCode transport(const std::vector<Track>& aTracks, std::vector<Deposit>& aDeposits) const = 0;
+};
+#endif /* SIMG4INTERFACE_ISIMG4EMTRANSPORTTOOL_H */
@@ -0,0 +1,27 @@
+#ifndef SIMG4INTERFACE_ISIMG4EVENTFILTERTOOL_H
+#define SIMG4INTERFACE_ISIMG4EVENTFILTERTOOL_H
+
+// Gaudi
+#include "GaudiKernel/IAlgTool.h"
+
+// Geant
+class G4Event;
+
+/** @class ISimG4EventFilterTool SimG4Interface/SimG4Interface/ISimG4EventFilterTool.h ISimG4EventFilterTool.h
+ *
+ *  Interface to the tools selecting the generated events before their simulation (e.g. cuts on the primaries).
+ *  The tools keep the numbers of the seen and accepted events, so that the cross-sections may be corrected.
+ *  They may be called from several threads.
+ */
+
+class ISimG4EventFilterTool : virtual public IAlgTool {
+public:
+  DeclareInterfaceID(ISimG4EventFilterTool, 1, 0);
+
+  /**  Select the event.
+   *   @param[in] aEvent Generated event, with its primaries.
+   *   @return true if the event is simulated
+   */
+  virtual bool accept(const G4Event& aEvent) = 0;
+};
+#endif /* SIMG4INTERFACE_ISIMG4EVENTFILTERTOOL_H */
@@ -7,21 +7,32 @@
 // Geant
 #include "GVFlashShowerParameterisation.hh"
 
+// STL
+#include <memory>
+
 /** @class ISimG4GflashTool SimG4Interface/SimG4Interface/ISimG4GflashTool.h ISimG4GflashTool.h
  *
  *  Interface to the Gflash parametrisation tool.
  *  It returns the parametriation that should be attached to the GFlashShowerModel.
+ *  The parametrisation is created once by the tool and shared by the models of the regions using the tool.
+ *  The parametrisation holds the state of the shower being simulated, so the models of each worker thread get a
+ *  parametrisation of their own (createParametrisation).
  *
  *  @author Anna Zaborowska
  */
 
 class ISimG4GflashTool : virtual public IAlgTool {
 public:
-  DeclareInterfaceID(ISimG4GflashTool, 1, 0);
+  DeclareInterfaceID(ISimG4GflashTool, 1, 1);
 
   /**  Get the parametrisation
-   *   @return unique pointer to the parametrisation
+   *   @return shared pointer to the parametrisation
+   */
+  virtual std::shared_ptr<GVFlashShowerParameterisation> parametrisation() = 0;
+
+  /**  Create a new parametrisation (e.g. for the models of a worker thread), not shared with the other models
+   *   @return shared pointer to the new parametrisation
    */
-  virtual std::unique_ptr<GVFlashShowerParameterisation> parametrisation() = 0;
+  virtual std::shared_ptr<GVFlashShowerParameterisation> createParametrisation() = 0;
 };
 #endif /* SIMG4INTERFACE_ISIMG4GFLASHTOOL_H */
@@ -19,12 +19,18 @@
 
 class ISimG4MagneticFieldTool : virtual public IAlgTool {
 public:
-  DeclareInterfaceID(ISimG4MagneticFieldTool, 1, 0);
+  DeclareInterfaceID(ISimG4MagneticFieldTool, 1, 1);
 
   /** get initialization hook for the magnetic field
    *  @return pointer to G4MagneticField
    */
   virtual const G4MagneticField* field() const = 0;
+
+  /** attach the field to the field manager of the calling thread
+   *  (field managers are thread-local in the multi-threaded mode of Geant4)
+   *  @return status code
+   */
+  virtual StatusCode attachToThread() const = 0;
 };
 
 #endif /* SIMG4INTERFACE_ISIM4MAGNETICFIELDTOOL_H */
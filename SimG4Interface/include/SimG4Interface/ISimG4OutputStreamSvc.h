@@ -0,0 +1,51 @@
+#ifndef SIMG4INTERFACE_ISIMG4OUTPUTSTREAMSVC_H
+#define SIMG4INTERFACE_ISIMG4OUTPUTSTREAMSVC_H
+
+// Gaudi
+#include "GaudiKernel/IService.h"
+
+// STL
+#include <map>
+#include <string>
+#include <vector>
+
+/** @class ISimG4OutputStreamSvc SimG4Interface/SimG4Interface/ISimG4OutputStreamSvc.h ISimG4OutputStreamSvc.h
+ *
+ *  Interface to the service writing the collections of the saving tools to output streams of their own (e.g. one
+ *  file per sub-detector), outside of the event store. A collection is passed as a block of columns, each column
+ *  holding one value per object (or per relation); the columns of a block may have different lengths.
+ *  Implementations need to be thread-safe.
+ */
+
+class ISimG4OutputStreamSvc : virtual public IService {
+public:
+  DeclareInterfaceID(ISimG4OutputStreamSvc, 1, 0);
+
+  /// Columns of one collection of one event
+  struct Block {
+    /// Name of the collection
+    std::string collection;
+    /// Number of the event
+    unsigned long long event = 0;
+    /// Columns of identifiers (e.g. cellID)
+    std::map<std::string, std::vector<unsigned long long>> ids;
+    /// Columns of integers (e.g. PDG codes, indices of the related objects)
+    std::map<std::string, std::vector<int>> ints;
+    /// Columns of floating point values
+    std::map<std::string, std::vector<float>> floats;
+  };
+
+  /**  Check if the stream is configured.
+   *   @param[in] aStream Name of the stream.
+   *   @return true if the blocks of the stream can be written
+   */
+  virtual bool hasStream(const std::string& aStream) const = 0;
+  /**  Queue the block for writing to the stream (the call returns before it is written, it waits only if the queue of
+   *   the stream is full).
+   *   @param[in] aStream Name of the stream.
+   *   @param[in] aBlock Block, taken over by the service.
+   *   @return status code
+   */
+  virtual StatusCode write(const std::string& aStream, Block&& aBlock) = 0;
+};
+#endif /* SIMG4INTERFACE_ISIMG4OUTPUTSTREAMSVC_H */
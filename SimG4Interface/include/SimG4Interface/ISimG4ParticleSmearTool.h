@@ -4,6 +4,9 @@
 // Gaudi
 #include "GaudiKernel/IAlgTool.h"
 
+// STL
+#include <cstddef>
+
 // CLHEP
 namespace CLHEP {
 class Hep3Vector;
@@ -19,7 +22,7 @@ class Hep3Vector;
 
 class ISimG4ParticleSmearTool : virtual public IAlgTool {
 public:
-  DeclareInterfaceID(ISimG4ParticleSmearTool, 1, 0);
+  DeclareInterfaceID(ISimG4ParticleSmearTool, 1, 3);
 
   /**  Smear the momentum of the particle
    *   @param aMom Particle momentum to be smeared.
@@ -28,6 +31,41 @@ public:
    */
   virtual StatusCode smearMomentum(CLHEP::Hep3Vector& aMom, int aPdg = 0) = 0;
 
+  /**  Smear the momenta of several particles in one call.
+   *   The default implementation smears them one by one, tools may draw the random numbers in blocks.
+   *   @param aMom Particle momenta to be smeared.
+   *   @param[in] aPdg PDG codes of the particles (nullptr: all 0).
+   *   @param[in] aSize Number of particles.
+   *   @return status code
+   */
+  virtual StatusCode smearMomenta(CLHEP::Hep3Vector* aMom, const int* aPdg, size_t aSize) {
+    for (size_t i = 0; i < aSize; ++i) {
+      if (smearMomentum(aMom[i], aPdg != nullptr ? aPdg[i] : 0).isFailure()) {
+        return StatusCode::FAILURE;
+      }
+    }
+    return StatusCode::SUCCESS;
+  }
+
+  /**  Check if the tool can smear with the given random numbers, concurrently from several threads.
+   *   @return true if smearMomenta with the random numbers is implemented and thread-safe
+   */
+  virtual bool supportsConcurrentSmearing() const { return false; }
+
+  /**  Smear the momenta of several particles with the given random numbers.
+   *   Each momentum is multiplied by (1 + resolution * aGauss[i]). It may be called concurrently by several threads
+   *   with their own random number streams, if supportsConcurrentSmearing() is true. Other tools fail.
+   *   @param aMom Particle momenta to be smeared.
+   *   @param[in] aPdg PDG codes of the particles (nullptr: all 0).
+   *   @param[in] aSize Number of particles.
+   *   @param[in] aGauss Random numbers from the unit Gaussian distribution, one per particle.
+   *   @return status code
+   */
+  virtual StatusCode smearMomenta(CLHEP::Hep3Vector* /*aMom*/, const int* /*aPdg*/, size_t /*aSize*/,
+                                  const double* /*aGauss*/) const {
+    return StatusCode::FAILURE;
+  }
+
   /**  Check conditions of the smearing model, especially if the given parametrs do not exceed the parameters of the
    * model.
    *   @param[in] aMinMomentum Minimum momentum.
@@ -0,0 +1,32 @@
+#ifndef SIMG4INTERFACE_ISIMG4PROFILINGSVC_H
+#define SIMG4INTERFACE_ISIMG4PROFILINGSVC_H
+
+// Gaudi
+#include "GaudiKernel/IService.h"
+
+/** @class ISimG4ProfilingSvc SimG4Interface/SimG4Interface/ISimG4ProfilingSvc.h ISimG4ProfilingSvc.h
+ *
+ *  Interface to the service collecting the timing of the phases of the simulation loop
+ *  (event creation, simulation, saving of the output, termination) and the per-event counters
+ *  (e.g. numbers of primaries, tracks, steps, hits).
+ *  Implementations need to be thread-safe.
+ */
+
+class ISimG4ProfilingSvc : virtual public IService {
+public:
+  DeclareInterfaceID(ISimG4ProfilingSvc, 1, 0);
+  /**  Record the duration of a phase of the simulation loop.
+   *   @param[in] aPhase Name of the phase.
+   *   @param[in] aSeconds Wall-clock time spent in the phase [s].
+   */
+  virtual void addTime(const std::string& aPhase, double aSeconds) = 0;
+  /**  Record the value of a per-event counter.
+   *   @param[in] aCounter Name of the counter.
+   *   @param[in] aValue Value of the counter in the current event.
+   */
+  virtual void addCount(const std::string& aCounter, double aValue) = 0;
+  /**  Mark the end of the event.
+   */
+  virtual void endOfEvent() = 0;
+};
+#endif /* SIMG4INTERFACE_ISIMG4PROFILINGSVC_H */
@@ -7,17 +7,26 @@
 /** @class ISimG4RegionTool SimG4Interface/SimG4Interface/ISimG4RegionTool.h ISimG4RegionTool.h
  *
  *  Interface to the tool creating region.
+ *  The regions are shared by all the threads, but the fast simulation models and the regional stepping actions
+ *  attached to them are thread-local in Geant4: in the multi-threaded mode they are created again on each worker
+ *  thread (createForWorker).
  *
  *  @author Anna Zaborowska
  */
 
 class ISimG4RegionTool : virtual public IAlgTool {
 public:
-  DeclareInterfaceID(ISimG4RegionTool, 1, 0);
+  DeclareInterfaceID(ISimG4RegionTool, 1, 1);
 
   /**  Create region.
    *   @return status code
    */
   virtual StatusCode create() = 0;
+
+  /**  Create the thread-local part of the regions (the fast simulation models and the regional stepping actions),
+   *   called on each worker thread after create() was called on the master thread.
+   *   @return status code (failure by default: the tool does not support the multi-threaded mode)
+   */
+  virtual StatusCode createForWorker() { return StatusCode::FAILURE; }
 };
 #endif /* SIMG4INTERFACE_ISIMG4REGIONTOOL_H */
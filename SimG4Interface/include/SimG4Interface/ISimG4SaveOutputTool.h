@@ -16,12 +16,27 @@ class G4Event;
 
 class ISimG4SaveOutputTool : virtual public IAlgTool {
 public:
-  DeclareInterfaceID(ISimG4SaveOutputTool, 1, 0);
+  DeclareInterfaceID(ISimG4SaveOutputTool, 1, 1);
 
   /**  Save the data output.
    *   @param[in] aEvent Event with data to save.
    *   @return status code
    */
   virtual StatusCode saveOutput(const G4Event& aEvent) = 0;
+  /**  Whether the output may be saved in two phases: fillOutput(), which does not access the event store (nor any
+   *   other shared state) and may run concurrently with the other tools, then putOutput() on the thread of the
+   *   algorithm.
+   *   @return true if fillOutput() and putOutput() are implemented
+   */
+  virtual bool fillsConcurrently() const { return false; }
+  /**  Fill the data output in collections held by the tool, without accessing the event store.
+   *   @param[in] aEvent Event with data to save.
+   *   @return status code
+   */
+  virtual StatusCode fillOutput(const G4Event&) { return StatusCode::FAILURE; }
+  /**  Put the collections filled by fillOutput() in the event store (or in their output stream).
+   *   @return status code
+   */
+  virtual StatusCode putOutput() { return StatusCode::FAILURE; }
 };
 #endif /* SIMG4INTERFACE_ISIMG4SAVEOUTPUTTOOL_H */
@@ -0,0 +1,40 @@
+#ifndef SIMG4INTERFACE_ISIMG4SERVERSVC_H
+#define SIMG4INTERFACE_ISIMG4SERVERSVC_H
+
+// Gaudi
+#include "GaudiKernel/IService.h"
+
+// STL
+#include <string>
+#include <vector>
+
+/** @class ISimG4ServerSvc SimG4Interface/SimG4Interface/ISimG4ServerSvc.h ISimG4ServerSvc.h
+ *
+ *  Interface to the service of the server mode, in which a job with an initialised simulation stays alive and
+ *  simulates the events requested by its clients: the event provider takes the primaries of the next requested event
+ *  from it, and the saving tools send the output of the event back to the client that requested it.
+ */
+
+class ISimG4ServerSvc : virtual public IService {
+public:
+  DeclareInterfaceID(ISimG4ServerSvc, 1, 0);
+
+  /// Primary particle of a requested event (EDM units: GeV, mm, ns)
+  struct Primary {
+    int pdg;
+    double x, y, z, time;
+    double px, py, pz;
+  };
+
+  /**  Wait for the next requested event.
+   *   @param[out] aPrimaries primary particles of the event
+   *   @return false if the server was stopped (no more events)
+   */
+  virtual bool nextEvent(std::vector<Primary>& aPrimaries) = 0;
+  /**  Send a reply to the client that requested the current event.
+   *   @param[in] aText text of the reply (lines ended with a new line)
+   *   @return status code
+   */
+  virtual StatusCode reply(const std::string& aText) = 0;
+};
+#endif /* SIMG4INTERFACE_ISIMG4SERVERSVC_H */
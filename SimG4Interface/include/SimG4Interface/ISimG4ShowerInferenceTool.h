@@ -0,0 +1,35 @@
+#ifndef SIMG4INTERFACE_ISIMG4SHOWERINFERENCETOOL_H
+#define SIMG4INTERFACE_ISIMG4SHOWERINFERENCETOOL_H
+
+// Gaudi
+#include "GaudiKernel/IAlgTool.h"
+
+// STL
+#include <vector>
+
+/** @class ISimG4ShowerInferenceTool SimG4Interface/SimG4Interface/ISimG4ShowerInferenceTool.h
+ * ISimG4ShowerInferenceTool.h
+ *
+ *  Interface to the tools running the inference of a generative model of the calorimeter showers.
+ *  The model takes for each shower a vector of inputSize() values (latent variables followed by the conditions) and
+ *  returns outputSize() energies in the cells of the mesh of the shower.
+ *  The inference is run on batches of showers and may be called from several threads.
+ */
+
+class ISimG4ShowerInferenceTool : virtual public IAlgTool {
+public:
+  DeclareInterfaceID(ISimG4ShowerInferenceTool, 1, 0);
+
+  /// Number of inputs of one shower
+  virtual size_t inputSize() const = 0;
+  /// Number of outputs of one shower
+  virtual size_t outputSize() const = 0;
+  /**  Run the inference.
+   *   @param[in] aInput inputs of the showers (aBatchSize times inputSize() values)
+   *   @param[in] aBatchSize number of showers
+   *   @param[out] aOutput outputs of the showers (aBatchSize times outputSize() values)
+   *   @return status code
+   */
+  virtual StatusCode infer(const std::vector<float>& aInput, size_t aBatchSize, std::vector<float>& aOutput) const = 0;
+};
+#endif /* SIMG4INTERFACE_ISIMG4SHOWERINFERENCETOOL_H */
@@ -4,6 +4,9 @@
 // Gaudi
 #include "GaudiKernel/IService.h"
 
+// STL
+#include <vector>
+
 // Geant
 class G4Event;
 
@@ -16,12 +19,18 @@ class G4Event;
 
 class ISimG4Svc : virtual public IService {
 public:
-  DeclareInterfaceID(ISimG4Svc, 1, 0);
+  DeclareInterfaceID(ISimG4Svc, 1, 1);
   /**  Simulate the event with Geant.
-   *   @param[in] aEvent An event to be processed.
+   *   @param[in] aEvent An event to be processed, owned by the service (deleted if the processing fails).
    *   @return status code
    */
   virtual StatusCode processEvent(G4Event& aEvent) = 0;
+  /**  Simulate a batch of events with Geant, and merge them into one event (hits and particle history are
+   *   concatenated, with track IDs shifted to stay unique), retrieved and terminated as a single event.
+   *   @param[in] aEvents Events to be processed, owned by the service (the vector is emptied).
+   *   @return status code
+   */
+  virtual StatusCode processEventBatch(std::vector<G4Event*>& aEvents) = 0;
   /**  Retrieve the processed event.
    *   @param[out] aEvent The processed event.
    *   @return status code
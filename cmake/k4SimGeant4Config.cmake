@@ -2,6 +2,7 @@
 include(CMakeFindDependencyMacro)
 find_dependency(Geant4 REQUIRED)
 find_dependency(k4FWCore REQUIRED)
+find_dependency(TBB REQUIRED)
 
 # - Include the targets file to create the imported targets that a client can
 # link to (libraries) or execute (programs)